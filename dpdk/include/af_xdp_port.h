@@ -0,0 +1,110 @@
+#ifndef AF_XDP_PORT_H
+#define AF_XDP_PORT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "config.h"
+
+// ==========================================
+// AF_XDP (XSK) BACKEND FOR RAW SOCKET PORTS
+// ==========================================
+// DPDK'ya bağlanamayan NIC'ler için AF_PACKET yerine AF_XDP:
+//   - Tek UMEM, aynı XSK üzerinden RX ve TX (yarısı fill/RX, yarısı TX)
+//   - need_wakeup modu: kernel sadece istediğinde syscall yapılır
+//   - Sürücü destekliyorsa zero-copy, değilse copy modu
+//   - Generic (SKB) XDP: veth dahil her Linux arayüzünde çalışır
+//
+// XDP programı libbpf olmadan bpf() syscall ile yüklenir: paketi
+// rx_queue_index'e göre XSKMAP'e yönlendirir, soket yoksa XDP_PASS.
+// Program bpf_link ile bağlanır (kernel >= 5.9), link kapanınca kalkar.
+//
+// ENABLE_AF_XDP=0 iken tüm fonksiyonlar -1/no-op döner.
+
+#define XSK_FRAME_SIZE      2048
+#define XSK_NUM_FRAMES      4096                    // 8MB UMEM
+#define XSK_RX_FRAMES       (XSK_NUM_FRAMES / 2)    // [0, RX) fill/RX, [RX, NUM) TX
+#define XSK_TX_FRAMES       (XSK_NUM_FRAMES - XSK_RX_FRAMES)
+#define XSK_RING_SIZE       2048                    // Tüm ring'ler (2'nin kuvveti)
+
+// Tek üretici/tek tüketici mmap ring (fill, completion, rx, tx)
+struct xsk_ring {
+    uint32_t *producer;
+    uint32_t *consumer;
+    uint32_t *flags;
+    void *desc;                 // uint64_t addr[] (fill/comp) veya struct xdp_desc[] (rx/tx)
+    uint32_t mask;
+    uint32_t cached_prod;
+    uint32_t cached_cons;
+    void *map;
+    size_t map_size;
+};
+
+// Arayüz başına XDP programı + XSKMAP
+struct xsk_prog {
+    int prog_fd;
+    int map_fd;
+    int link_fd;
+    bool generic;               // XDP_FLAGS_SKB_MODE ile bağlandı
+};
+
+// Kuyruk başına XSK soketi (UMEM sahibi)
+struct xsk_port {
+    int fd;
+    int ifindex;
+    uint32_t queue_id;
+    uint8_t *umem;
+    size_t umem_size;
+    struct xsk_ring fill;
+    struct xsk_ring comp;
+    struct xsk_ring rx;
+    struct xsk_ring tx;
+    uint64_t tx_free[XSK_TX_FRAMES];
+    uint32_t tx_free_count;
+    bool zero_copy;
+    bool need_wakeup;
+};
+
+/**
+ * Load the redirect program and attach it to an interface
+ * @param queues  XSKMAP size (NIC RX queue count to cover)
+ * @param generic true: SKB mode (veth, any NIC), false: try native, fall back to SKB
+ * @return 0 on success, -1 on error (reason printed)
+ */
+int xsk_prog_attach(struct xsk_prog *prog, int ifindex, uint32_t queues, bool generic);
+
+/** Detach program and close map/prog fds */
+void xsk_prog_detach(struct xsk_prog *prog);
+
+/**
+ * Create UMEM + XSK on (ifindex, queue_id) and register it in prog's XSKMAP.
+ * Zero-copy is tried first in native mode, then copy mode.
+ * @return 0 on success, -1 on error (x is left closed)
+ */
+int xsk_port_open(struct xsk_port *x, struct xsk_prog *prog, int ifindex, uint32_t queue_id);
+
+/** Unmap rings/UMEM and close the socket */
+void xsk_port_close(struct xsk_port *x);
+
+/** Cumulative kernel drops (XDP_STATISTICS rx_dropped + rx_ring_full) */
+uint64_t xsk_port_kernel_drops(const struct xsk_port *x);
+
+/** Reserve a free TX frame, NULL if all frames are in flight */
+uint8_t *xsk_tx_reserve(struct xsk_port *x, uint64_t *addr);
+
+/** Queue a reserved frame for TX (visible to the kernel on xsk_tx_kick) */
+void xsk_tx_submit(struct xsk_port *x, uint64_t addr, uint32_t len);
+
+/** Publish queued TX descriptors and wake the kernel if it asked for it */
+int xsk_tx_kick(struct xsk_port *x);
+
+/**
+ * Peek up to max received frames (stay owned until xsk_rx_release)
+ * @return Number of frames, 0 if RX ring is empty
+ */
+uint32_t xsk_rx_burst(struct xsk_port *x, uint8_t **data, uint32_t *len, uint32_t max);
+
+/** Return the oldest n peeked frames to the fill ring */
+void xsk_rx_release(struct xsk_port *x, uint32_t n);
+
+#endif /* AF_XDP_PORT_H */
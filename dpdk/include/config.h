@@ -9,7 +9,12 @@
 // LATENCY TEST CONFIGURATION
 // ==========================================
 // Etkinleştirildiğinde:
-// - Her VLAN'dan 1 paket gönderilir (ilk VL-ID kullanılır)
+// - Her VLAN'dan 1 paket gönderilir (VLAN'ın ilk VL-ID'si ile)
+// - Probe RX kuyruğu (latency_probe.h, LATENCY_PROBE_FLOW_ENABLED) kurulursa
+//   veya latency-under-load / latency monitor açıksa her VLAN aralığının son
+//   VL-ID'si probe'lara ayrılır: normal trafik aralık başına
+//   VL_RANGE_SIZE_PER_QUEUE - 1 VL-ID gönderir. Hiçbir portta kural
+//   kurulamazsa ayrılmaz, tam aralık kapsanır.
 // - TX timestamp payload'a yazılır
 // - RX'te latency hesaplanır ve gösterilir
 // - 5 saniye timeout
@@ -84,19 +89,45 @@
 // Port 13 (100M bakır): 1 hedefe gönderim (80 Mbps)
 //   - Hedef 0: Port 12'e 80 Mbps, VL-ID 6275-6306 (32)
 
-#define MAX_RAW_SOCKET_PORTS 2
+// Raw port sayısı RAW_SOCKET_PORTS_CONFIG_INIT girdi sayısıdır (sabit tavan yok)
 #define RAW_SOCKET_PORT_ID_START 12
 #define MAX_RAW_TARGETS 8   // Maksimum hedef sayısı per port
 
+// Raw port backend: AF_PACKET (PACKET_MMAP) veya AF_XDP (XSK, af_xdp_port.h)
+// AF_XDP için build: make ENABLE_AF_XDP=1. Kurulum başarısız olursa port
+// AF_PACKET'e geri düşer. XDP_GENERIC=true: SKB modu (veth/test makinesi),
+// false: önce native (zero-copy denenir), olmazsa generic.
+// veth ile deneme: make veth-setup, sonra IFACE'leri veth12a/veth13a yapın.
+#ifndef ENABLE_AF_XDP
+#define ENABLE_AF_XDP 0
+#endif
+
+enum raw_port_backend {
+    RAW_BACKEND_AF_PACKET = 0,
+    RAW_BACKEND_AF_XDP,
+};
+
 // Port 12 configuration (1G copper)
 #define RAW_SOCKET_PORT_12_PCI "01:00.0"
+#ifndef RAW_SOCKET_PORT_12_IFACE
 #define RAW_SOCKET_PORT_12_IFACE "eno12399"
+#endif
 #define RAW_SOCKET_PORT_12_IS_1G true
+#ifndef RAW_SOCKET_PORT_12_BACKEND
+#define RAW_SOCKET_PORT_12_BACKEND RAW_BACKEND_AF_PACKET
+#endif
+#define RAW_SOCKET_PORT_12_XDP_GENERIC false
 
 // Port 13 configuration (100M copper)
 #define RAW_SOCKET_PORT_13_PCI "01:00.1"
+#ifndef RAW_SOCKET_PORT_13_IFACE
 #define RAW_SOCKET_PORT_13_IFACE "eno12409"
+#endif
 #define RAW_SOCKET_PORT_13_IS_1G false
+#ifndef RAW_SOCKET_PORT_13_BACKEND
+#define RAW_SOCKET_PORT_13_BACKEND RAW_BACKEND_AF_PACKET
+#endif
+#define RAW_SOCKET_PORT_13_XDP_GENERIC false
 
 // ==========================================
 // MULTI-TARGET CONFIGURATION
@@ -153,6 +184,10 @@ struct raw_socket_port_config {
     const char *pci_addr;           // PCI address (for identification)
     const char *interface_name;     // Kernel interface name
     bool is_1g_port;                // true for 1G, false for 100M
+    enum raw_port_backend backend;  // AF_PACKET veya AF_XDP
+    bool xdp_generic;               // AF_XDP: SKB modunu zorla
+    int rx_queue_count;             // Hedef RX queue (fanout/XSK) sayısı
+    int tx_lane_count;              // İstenen TX lane sayısı (raw_port_tx_lane_count sınırlar)
 
     // TX targets
     uint16_t tx_target_count;
@@ -176,6 +211,10 @@ struct raw_socket_port_config {
       .pci_addr = RAW_SOCKET_PORT_12_PCI, \
       .interface_name = RAW_SOCKET_PORT_12_IFACE, \
       .is_1g_port = RAW_SOCKET_PORT_12_IS_1G, \
+      .backend = RAW_SOCKET_PORT_12_BACKEND, \
+      .xdp_generic = RAW_SOCKET_PORT_12_XDP_GENERIC, \
+      .rx_queue_count = PORT_12_RX_QUEUE_COUNT, \
+      .tx_lane_count = PORT_12_TX_LANE_COUNT, \
       .tx_target_count = PORT_12_TX_TARGET_COUNT, \
       .tx_targets = INIT_TX_TARGETS_12, \
       .rx_source_count = PORT_12_RX_SOURCE_COUNT, \
@@ -185,6 +224,10 @@ struct raw_socket_port_config {
       .pci_addr = RAW_SOCKET_PORT_13_PCI, \
       .interface_name = RAW_SOCKET_PORT_13_IFACE, \
       .is_1g_port = RAW_SOCKET_PORT_13_IS_1G, \
+      .backend = RAW_SOCKET_PORT_13_BACKEND, \
+      .xdp_generic = RAW_SOCKET_PORT_13_XDP_GENERIC, \
+      .rx_queue_count = PORT_13_RX_QUEUE_COUNT, \
+      .tx_lane_count = PORT_13_TX_LANE_COUNT, \
       .tx_target_count = PORT_13_TX_TARGET_COUNT, \
       .tx_targets = INIT_TX_TARGETS_13, \
       .rx_source_count = PORT_13_RX_SOURCE_COUNT, \
@@ -249,7 +292,6 @@ static const vlid_range_t g_vlid_ranges[VLID_RANGE_COUNT] = {
 // ==========================================
 #define MAX_TX_VLANS_PER_PORT 32
 #define MAX_RX_VLANS_PER_PORT 32
-#define MAX_PORTS_CONFIG 16
 
 struct port_vlan_config {
     uint16_t tx_vlans[MAX_TX_VLANS_PER_PORT];      // VLAN header tags
@@ -341,6 +383,33 @@ struct port_vlan_config {
 #define NUM_RX_CORES 4
 #endif
 
+// ==========================================
+// LCORE PLACEMENT PLANNER
+// ==========================================
+// CPU topolojisini (sysfs) okuyup TX/RX/ext TX worker'larını ve raw socket
+// RX thread'lerini yerleştirir. Main lcore hiçbir worker'a verilmez.
+// Plan karşılanamazsa uygulama başlamaz. 0 = eski lcorePortAssign().
+#ifndef LCORE_PLANNER_ENABLED
+#define LCORE_PLANNER_ENABLED 1
+#endif
+
+// Hedef hızı bu değerin (Gbps) üstündeki portlar "busy" sayılır: worker'ları
+// fiziksel core'u (SMT kardeşi) başka bir worker ile paylaşmaz
+#ifndef LCORE_PLAN_BUSY_PORT_GBPS
+#define LCORE_PLAN_BUSY_PORT_GBPS 1.0
+#endif
+
+// 0: SMT kardeşleri bağımsız lcore gibi kullanılır (sadece NUMA kuralları)
+#ifndef LCORE_PLAN_SMT_EXCLUSIVE
+#define LCORE_PLAN_SMT_EXCLUSIVE 1
+#endif
+
+// 1: Port'un NUMA node'unda yer kalmazsa diğer node'a taşar (uyarı ile)
+// 0: Taşma gerekirse plan başarısız olur
+#ifndef LCORE_PLAN_ALLOW_NUMA_SPILL
+#define LCORE_PLAN_ALLOW_NUMA_SPILL 1
+#endif
+
 // ==========================================
 // PORT-BASED RATE LIMITING
 // ==========================================
@@ -381,6 +450,67 @@ struct port_vlan_config {
 #define RATE_LIMITER_ENABLED 1
 #endif
 
+// ==========================================
+// TRAFFIC SHAPE CONFIGURATION (tx_worker pacing)
+// ==========================================
+// tx_worker paket arası süreyi önceden hesaplanmış bir gap tablosundan alır.
+// Her shape için tablo, ortalama rate GET_PORT_TARGET_GBPS ile birebir aynı
+// kalacak şekilde normalize edilir (sadece varış süreci değişir).
+//
+//   CONSTANT     : Sabit aralık (varsayılan, eski davranış)
+//   POISSON      : Üstel dağılımlı aralıklar (Poisson varış)
+//   ONOFF        : MMPP on/off - ON'da burst_len ort. paket peak rate ile,
+//                  OFF'ta sessizlik. Peak = ortalama * 100 / on_pct
+//   RAMP_LINEAR  : ramp_period_ms içinde start_pct -> end_pct doğrusal rampa
+//   RAMP_STEP    : Aynı rampa ramp_steps adet düz basamak ile
+//   TOKEN_BUCKET : struct rate_limiter ile greedy gönderim, bucket_depth
+//                  byte'a kadar catch-up burst'üne izin verir
+//
+// Seçim port/queue bazlı: TX_SHAPE_CONFIG_INIT içinde eşleşen ilk kayıt
+// kullanılır, eşleşme yoksa TX_SHAPE_DEFAULT.
+
+enum tx_shape_type {
+    TX_SHAPE_CONSTANT = 0,
+    TX_SHAPE_POISSON,
+    TX_SHAPE_ONOFF,
+    TX_SHAPE_RAMP_LINEAR,
+    TX_SHAPE_RAMP_STEP,
+    TX_SHAPE_TOKEN_BUCKET,
+};
+
+struct tx_shape_config {
+    enum tx_shape_type type;
+    uint32_t burst_len;         // ONOFF: ortalama burst uzunluğu (paket)
+    uint32_t on_pct;            // ONOFF: ON süresinin oranı (%1-100)
+    uint32_t start_pct;         // RAMP: başlangıç rate'i (ortalamaya göre bağıl)
+    uint32_t end_pct;           // RAMP: bitiş rate'i
+    uint32_t ramp_period_ms;    // RAMP: bir rampa periyodu
+    uint32_t ramp_steps;        // RAMP_STEP: basamak sayısı
+    uint32_t bucket_depth;      // TOKEN_BUCKET: bucket derinliği (byte)
+};
+
+// Port/queue -> shape eşlemesi (queue_id = TX_SHAPE_ALL_QUEUES: portun tüm queue'ları)
+struct tx_shape_port_config {
+    uint16_t port_id;
+    uint16_t queue_id;
+    struct tx_shape_config shape;
+};
+
+#define TX_SHAPE_ALL_QUEUES 0xFFFF
+#define TX_SHAPE_TABLE_SIZE 4096        // Gap tablosu girdi sayısı (POISSON/ONOFF)
+#define TX_SHAPE_RAMP_LINEAR_STEPS 256  // RAMP_LINEAR çözünürlüğü
+
+#define TX_SHAPE_DEFAULT { .type = TX_SHAPE_CONSTANT }
+
+// Örnek:
+//   { .port_id = 2, .queue_id = TX_SHAPE_ALL_QUEUES,
+//     .shape = { .type = TX_SHAPE_ONOFF, .burst_len = 32, .on_pct = 25 } },
+//   { .port_id = 3, .queue_id = 0,
+//     .shape = { .type = TX_SHAPE_RAMP_STEP, .start_pct = 50, .end_pct = 150,
+//                .ramp_period_ms = 10000, .ramp_steps = 5 } },
+#define TX_SHAPE_CONFIG_INIT { \
+}
+
 // Kuyruk sayıları core sayılarına eşittir
 #define NUM_TX_QUEUES_PER_PORT NUM_TX_CORES
 #define NUM_RX_QUEUES_PER_PORT NUM_RX_CORES
@@ -425,13 +555,23 @@ struct port_vlan_config {
 #define DPDK_EXT_TX_PORT_COUNT 6  // Port 2,3,4,5 → Port 12 | Port 0,6 → Port 13
 #define DPDK_EXT_TX_QUEUES_PER_PORT 4
 
+// Inline mod: ext trafiği ana tx_worker'lar ikinci trafik sınıfı olarak taşır.
+// Hedef queue_id'si o queue'nun tx_worker'ına atanır, kendi pacing'i ve
+// sequence alanı vardır. Dedicated ext lcore ve TX queue 4 kullanılmaz.
+// 0 = eski mod (port başına dedicated lcore, queue 4, varsayılan); inline
+// opt-in'dir: -DDPDK_EXT_TX_INLINE=1. Hedef queue_id'si NUM_TX_CORES'tan
+// büyük olan portlar inline derlense de eski moda düşer.
+#ifndef DPDK_EXT_TX_INLINE
+#define DPDK_EXT_TX_INLINE 0
+#endif
+
 // External TX target configuration
 struct dpdk_ext_tx_target {
     uint16_t queue_id;      // Queue index (0-3)
     uint16_t vlan_id;       // VLAN tag
     uint16_t vl_id_start;   // VL-ID başlangıç
     uint16_t vl_id_count;   // VL-ID sayısı (32)
-    uint32_t rate_mbps;     // Hedef hız (Mbps)
+    uint32_t rate_kbps;     // Bu hedefin planlanan hızı (kbps) - DRR ağırlığı
 };
 
 // External TX port configuration
@@ -442,59 +582,64 @@ struct dpdk_ext_tx_port_config {
     struct dpdk_ext_tx_target targets[DPDK_EXT_TX_QUEUES_PER_PORT];
 };
 
+// Hedef rate'leri hedef başınadır; port toplamı = Σ rate_kbps.
+// Inline modda her hedef kendi queue'sunda rate_kbps ile ayrı pace edilir.
+// Dedicated modda dpdk_ext_tx_worker hedefler arasında byte bazlı deficit
+// round-robin yapar, her hedef kendi rate'i oranında bant genişliği alır.
+
 // Port 2: VLAN 97-100, VL-ID 4291-4322
 // NOTE: Total external TX must not exceed Port 12's 1G capacity
-// 4 ports × 220 Mbps = 880 Mbps total (within 1G limit)
+// 4 ports × 4 targets × 60 Mbps = 960 Mbps total (within 1G limit)
 #define DPDK_EXT_TX_PORT_2_TARGETS { \
-    { .queue_id = 0, .vlan_id = 97,  .vl_id_start = 4291, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 1, .vlan_id = 98,  .vl_id_start = 4299, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 2, .vlan_id = 99,  .vl_id_start = 4307, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 3, .vlan_id = 100, .vl_id_start = 4315, .vl_id_count = 8, .rate_mbps = 240 }, \
+    { .queue_id = 0, .vlan_id = 97,  .vl_id_start = 4291, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 1, .vlan_id = 98,  .vl_id_start = 4299, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 2, .vlan_id = 99,  .vl_id_start = 4307, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 3, .vlan_id = 100, .vl_id_start = 4315, .vl_id_count = 8, .rate_kbps = 60000 }, \
 }
 
 // Port 3: VLAN 101-104, VL-ID 4323-4354 (8 per queue, no overlap)
 #define DPDK_EXT_TX_PORT_3_TARGETS { \
-    { .queue_id = 0, .vlan_id = 101, .vl_id_start = 4323, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 1, .vlan_id = 102, .vl_id_start = 4331, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 2, .vlan_id = 103, .vl_id_start = 4339, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 3, .vlan_id = 104, .vl_id_start = 4347, .vl_id_count = 8, .rate_mbps = 240 }, \
+    { .queue_id = 0, .vlan_id = 101, .vl_id_start = 4323, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 1, .vlan_id = 102, .vl_id_start = 4331, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 2, .vlan_id = 103, .vl_id_start = 4339, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 3, .vlan_id = 104, .vl_id_start = 4347, .vl_id_count = 8, .rate_kbps = 60000 }, \
 }
 
 // Port 0: VLAN 105-108, VL-ID 4355-4386
 #define DPDK_EXT_TX_PORT_4_TARGETS { \
-    { .queue_id = 0, .vlan_id = 113, .vl_id_start = 4355, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 1, .vlan_id = 114, .vl_id_start = 4363, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 2, .vlan_id = 115, .vl_id_start = 4371, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 3, .vlan_id = 116, .vl_id_start = 4379, .vl_id_count = 8, .rate_mbps = 240 }, \
+    { .queue_id = 0, .vlan_id = 113, .vl_id_start = 4355, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 1, .vlan_id = 114, .vl_id_start = 4363, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 2, .vlan_id = 115, .vl_id_start = 4371, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 3, .vlan_id = 116, .vl_id_start = 4379, .vl_id_count = 8, .rate_kbps = 60000 }, \
 }
 
 // Port 5: VLAN 117-120, VL-ID 4387-4418 → Port 12
 #define DPDK_EXT_TX_PORT_5_TARGETS { \
-    { .queue_id = 0, .vlan_id = 117, .vl_id_start = 4387, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 1, .vlan_id = 118, .vl_id_start = 4395, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 2, .vlan_id = 119, .vl_id_start = 4403, .vl_id_count = 8, .rate_mbps = 240 }, \
-    { .queue_id = 3, .vlan_id = 120, .vl_id_start = 4411, .vl_id_count = 8, .rate_mbps = 240 }, \
+    { .queue_id = 0, .vlan_id = 117, .vl_id_start = 4387, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 1, .vlan_id = 118, .vl_id_start = 4395, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 2, .vlan_id = 119, .vl_id_start = 4403, .vl_id_count = 8, .rate_kbps = 60000 }, \
+    { .queue_id = 3, .vlan_id = 120, .vl_id_start = 4411, .vl_id_count = 8, .rate_kbps = 60000 }, \
 }
 
 // ==========================================
 // PORT 0 ve PORT 6 → PORT 13 (100M bakır)
 // ==========================================
-// Port 0: 45 Mbps, Port 6: 45 Mbps = Toplam 90 Mbps
+// Port 0: 4 x 11.25 = 45 Mbps, Port 6: 45 Mbps = Toplam 90 Mbps
 
 // Port 0: VLAN 105-108, VL-ID 4099-4114 → Port 13 (toplam 45 Mbps)
 #define DPDK_EXT_TX_PORT_0_TARGETS { \
-    { .queue_id = 0, .vlan_id = 105, .vl_id_start = 4099, .vl_id_count = 4, .rate_mbps = 45 }, \
-    { .queue_id = 1, .vlan_id = 106, .vl_id_start = 4103, .vl_id_count = 4, .rate_mbps = 45 }, \
-    { .queue_id = 2, .vlan_id = 107, .vl_id_start = 4107, .vl_id_count = 4, .rate_mbps = 45 }, \
-    { .queue_id = 3, .vlan_id = 108, .vl_id_start = 4111, .vl_id_count = 4, .rate_mbps = 45 }, \
+    { .queue_id = 0, .vlan_id = 105, .vl_id_start = 4099, .vl_id_count = 4, .rate_kbps = 11250 }, \
+    { .queue_id = 1, .vlan_id = 106, .vl_id_start = 4103, .vl_id_count = 4, .rate_kbps = 11250 }, \
+    { .queue_id = 2, .vlan_id = 107, .vl_id_start = 4107, .vl_id_count = 4, .rate_kbps = 11250 }, \
+    { .queue_id = 3, .vlan_id = 108, .vl_id_start = 4111, .vl_id_count = 4, .rate_kbps = 11250 }, \
 }
 
 // Port 6: VLAN 121-124, VL-ID 4115-4130 → Port 13 (toplam 45 Mbps)
 #define DPDK_EXT_TX_PORT_6_TARGETS { \
-    { .queue_id = 0, .vlan_id = 121, .vl_id_start = 4115, .vl_id_count = 4, .rate_mbps = 45 }, \
-    { .queue_id = 1, .vlan_id = 122, .vl_id_start = 4119, .vl_id_count = 4, .rate_mbps = 45 }, \
-    { .queue_id = 2, .vlan_id = 123, .vl_id_start = 4123, .vl_id_count = 4, .rate_mbps = 45 }, \
-    { .queue_id = 3, .vlan_id = 124, .vl_id_start = 4127, .vl_id_count = 4, .rate_mbps = 45 }, \
+    { .queue_id = 0, .vlan_id = 121, .vl_id_start = 4115, .vl_id_count = 4, .rate_kbps = 11250 }, \
+    { .queue_id = 1, .vlan_id = 122, .vl_id_start = 4119, .vl_id_count = 4, .rate_kbps = 11250 }, \
+    { .queue_id = 2, .vlan_id = 123, .vl_id_start = 4123, .vl_id_count = 4, .rate_kbps = 11250 }, \
+    { .queue_id = 3, .vlan_id = 124, .vl_id_start = 4127, .vl_id_count = 4, .rate_kbps = 11250 }, \
 }
 
 // All external TX port configurations
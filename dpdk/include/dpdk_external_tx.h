@@ -26,15 +26,22 @@ struct dpdk_ext_tx_worker_params {
     uint16_t vlan_id;           // VLAN tag
     uint16_t vl_id_start;       // VL-ID başlangıç
     uint16_t vl_id_count;       // VL-ID sayısı
-    uint32_t rate_mbps;         // Hedef hız
+    uint32_t rate_kbps;         // Port toplam hızı (Σ hedef rate_kbps)
     struct rte_mempool *mbuf_pool;
     volatile bool *stop_flag;
 };
 
+// Per-target external TX statistics (DRR doğrulaması için)
+struct dpdk_ext_tx_target_stats {
+    rte_atomic64_t tx_pkts;
+    rte_atomic64_t tx_bytes;
+};
+
 // Per-port external TX statistics
 struct dpdk_ext_tx_stats {
     rte_atomic64_t tx_pkts;     // Gönderilen paket sayısı
     rte_atomic64_t tx_bytes;    // Gönderilen byte sayısı
+    struct dpdk_ext_tx_target_stats targets[DPDK_EXT_TX_QUEUES_PER_PORT];
 };
 
 // Global external TX statistics
@@ -94,6 +101,52 @@ void dpdk_ext_tx_get_stats(uint16_t port_id, uint64_t *tx_pkts, uint64_t *tx_byt
  */
 void dpdk_ext_tx_print_stats(void);
 
+/**
+ * Print per-target planned vs achieved rate (DRR accuracy, last interval)
+ */
+void dpdk_ext_tx_print_target_stats(void);
+
+/**
+ * Build an external TX frame (VLAN + IPv4 + UDP + [SEQ][PRBS]) at pkt.
+ * Backend-neutral: dpdk_ext_tx_worker writes into a pkt_io frame.
+ * @param pkt_size  Frame size (IMIX size or PACKET_SIZE_VLAN)
+ * @return Frame length (pkt_size)
+ */
+uint16_t dpdk_ext_tx_build_frame(uint8_t *pkt, uint16_t port_id, uint16_t vlan_id,
+                                 uint16_t vl_id, uint64_t seq, uint16_t pkt_size,
+                                 const uint8_t *prbs_cache);
+
+/**
+ * Is external TX for this port carried inline by the main tx_worker queues?
+ * (DPDK_EXT_TX_INLINE and every target queue_id < NUM_TX_CORES)
+ * Inline ports need neither used_ext_tx_core nor TX queue 4.
+ */
+bool dpdk_ext_tx_port_inline(uint16_t port_id);
+
+/**
+ * Ext target carried by a main TX queue in inline mode
+ * @param port_idx   Output: index into ext config / stats tables
+ * @param target_idx Output: target index within the port
+ * @return Target or NULL if this queue carries no external class
+ */
+const struct dpdk_ext_tx_target *dpdk_ext_tx_inline_target(uint16_t port_id, uint16_t queue_id,
+                                                           uint16_t *port_idx, uint16_t *target_idx);
+
+/**
+ * Inline ext class may start (set by dpdk_ext_tx_start_workers after raw RX is up)
+ */
+bool dpdk_ext_tx_inline_armed(void);
+
+/**
+ * Next external sequence number for a VL-ID (separate from main TX space)
+ */
+uint64_t dpdk_ext_tx_next_sequence(uint16_t port_idx, uint16_t vl_id);
+
+/**
+ * Add locally counted inline packets to port and target statistics
+ */
+void dpdk_ext_tx_account(uint16_t port_idx, uint16_t target_idx, uint64_t pkts, uint64_t bytes);
+
 /**
  * Check if a VL-ID belongs to external TX range
  * @param vl_id VL-ID to check
@@ -26,10 +26,9 @@ static void signal_handler(int signum)
 }
 
 // Warm-up sırasında HW istatistikleri ve yerel sayaçları sıfırlar
-void helper_reset_stats(const struct ports_config *ports_config,
-                        uint64_t prev_tx_bytes[], uint64_t prev_rx_bytes[]);
+void helper_reset_stats(const struct ports_config *ports_config);
 
-// Her saniye çağır: büyük tablo + kuyruk dağılımları yazdırır
-void helper_print_stats(const struct ports_config *ports_config,
-                        const uint64_t prev_tx_bytes[], const uint64_t prev_rx_bytes[],
+struct stats_snapshot;
+// Her saniye çağır: stats servisinin son görüntüsünden büyük tabloyu yazdırır
+void helper_print_stats(const struct stats_snapshot *snap,
                         bool warmup_complete, unsigned loop_count, unsigned test_time);
@@ -0,0 +1,58 @@
+#ifndef LATENCY_HIST_H
+#define LATENCY_HIST_H
+
+#include <stdint.h>
+
+// ==========================================
+// LOG-LINEAR LATENCY HISTOGRAM (ns)
+// ==========================================
+// [0, 8) ns birebir, üstünde her 2'nin kuvveti 8 alt bucket'a bölünür
+// (%12.5 çözünürlük); 64 bit aralığın tamamı 496 bucket'a sığar.
+// latency_load (seviye başına) ve latency_monitor (VLAN başına) kullanır.
+
+#define LAT_HIST_SUB_BITS   3
+#define LAT_HIST_SUB        (1 << LAT_HIST_SUB_BITS)
+#define LAT_HIST_BUCKETS    ((64 - LAT_HIST_SUB_BITS + 1) * LAT_HIST_SUB)
+
+static inline int lat_hist_bucket(uint64_t v)
+{
+    if (v < LAT_HIST_SUB)
+        return (int)v;
+    int e = 63 - __builtin_clzll(v);
+    int sub = (int)((v >> (e - LAT_HIST_SUB_BITS)) & (LAT_HIST_SUB - 1));
+    return (e - LAT_HIST_SUB_BITS + 1) * LAT_HIST_SUB + sub;
+}
+
+/** Bucket'ın üst sınırı (ns) */
+static inline uint64_t lat_hist_upper(int b)
+{
+    if (b < LAT_HIST_SUB)
+        return (uint64_t)b;
+    int e = b / LAT_HIST_SUB + LAT_HIST_SUB_BITS - 1;
+    int sub = b % LAT_HIST_SUB;
+    return ((uint64_t)(LAT_HIST_SUB + sub + 1) << (e - LAT_HIST_SUB_BITS)) - 1;
+}
+
+/**
+ * Yüzdelik dilim: bucket üst sınırı, gerçek max_ns ile kırpılır
+ * @param total  Histogramdaki örnek sayısı (> 0)
+ */
+static inline uint64_t lat_hist_percentile(const uint32_t *hist, uint64_t total,
+                                           double q, uint64_t max_ns)
+{
+    uint64_t target = (uint64_t)((double)total * q);
+    if (target >= total)
+        target = total - 1;
+
+    uint64_t seen = 0;
+    for (int b = 0; b < LAT_HIST_BUCKETS; b++) {
+        seen += hist[b];
+        if (seen > target) {
+            uint64_t upper = lat_hist_upper(b);
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+#endif /* LATENCY_HIST_H */
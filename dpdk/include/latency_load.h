@@ -0,0 +1,147 @@
+#ifndef LATENCY_LOAD_H
+#define LATENCY_LOAD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <rte_ethdev.h>
+#include "config.h"
+#include "tx_rx_manager.h"
+#include "latency_hist.h"
+
+// ==========================================
+// LATENCY UNDER LOAD
+// ==========================================
+// Normal TX worker'lar çalışırken arka plan trafiği LATENCY_LOAD_LEVELS
+// yük seviyelerinde (GET_PORT_TARGET_GBPS'in yüzdesi) sırayla sürülür;
+// her seviyede probe'lar trafikle aynı queue'dan gönderilir ve çift başına
+// gecikme histogramı toplanır. Sonuç: port çifti başına latency-yük eğrisi.
+//
+//   Yük    : tx_worker gap'leri (smooth pacing) veya paket başına harcanan
+//            token'lar (token bucket) gap_scale_q16 ile çarpılır; trafik
+//            şekli korunur, sadece ortalama rate düşer. External TX sınıfı
+//            (DPDK_EXT_TX) kendi rate'inde kalır.
+//   Probe  : Queue 0 worker'ı LATENCY_LOAD_PROBE_US'de bir, ilk VLAN'ın
+//            önceden kurulmuş probe mbuf'ını (latency_probe.h) ayrılmış VL-ID
+//            ile gönderir; RX'te flow kuralı varsa probe kuyruğundan, yoksa
+//            RSS kuyruğunda VL-ID ile ayrılarak kaydedilir.
+//   Zaman  : TX = payload'a yazılan TSC (tx_burst öncesi; HW TX timestamp'i
+//            beklemek worker'ın pacing'ini bozar), RX = nic_clock (HW varsa)
+//   Seviye : seq'in üst 32 biti seviye etiketi; önceki seviyeden geç gelen
+//            probe sayılmaz
+//
+// Akış (ana döngüden saniyede bir latency_load_tick()):
+//   SETTLE (LATENCY_LOAD_SETTLE_SEC) -> MEASURE (LATENCY_LOAD_DWELL_SEC)
+//   -> DRAIN (1 s) -> sonraki seviye ... -> yük %100'e döner, eğri basılır
+
+#ifndef LATENCY_LOAD_TEST_ENABLED
+#define LATENCY_LOAD_TEST_ENABLED 0
+#endif
+
+#if LATENCY_LOAD_TEST_ENABLED && !LATENCY_TEST_ENABLED
+#error "LATENCY_LOAD_TEST_ENABLED requires LATENCY_TEST_ENABLED (probe packet format)"
+#endif
+
+#define LATENCY_LOAD_LEVELS             { 50, 80, 95 }  // % GET_PORT_TARGET_GBPS
+#define LATENCY_LOAD_MAX_LEVELS         8
+#define LATENCY_LOAD_MIN_PCT            10      // Daha düşük seviyeler buna yükseltilir
+#define LATENCY_LOAD_SETTLE_SEC         2       // Yük değişiminden sonra kuyrukların oturması
+#define LATENCY_LOAD_DWELL_SEC          10      // Seviye başına ölçüm süresi
+#define LATENCY_LOAD_PROBE_US           1000    // Port başına probe aralığı
+
+// Log-linear histogram (latency_hist.h, %12.5 çözünürlük)
+#define LATENCY_LOAD_BUCKETS            LAT_HIST_BUCKETS
+
+#define LATENCY_LOAD_SCALE_ONE          (1U << 16)
+
+/** Bir yük seviyesinde çiftin sonucu */
+struct latency_load_point {
+    uint8_t  load_pct;
+    double   achieved_gbps;     // Ölçüm penceresinde TX portun gerçek rate'i
+    uint32_t tx_count;
+    uint32_t rx_count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t avg_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    bool     rx_hw;             // RX zamanı NIC saatinden
+};
+
+/** TX port başına durum (çift = TX port -> RX port) */
+struct latency_load_port {
+    // Worker'lar tarafından okunur (ana thread yazar)
+    volatile uint32_t gap_scale_q16;    // 65536 = %100 yük
+    volatile bool     probing;
+    volatile uint32_t level_tag;
+    uint16_t          probe_vl_id;      // 0 = bu port çift değil
+    uint16_t          probe_vlan;
+
+    // Queue 0 TX worker'ına özel
+    uint64_t next_probe_tsc;
+    uint32_t probe_seq;
+    volatile uint32_t tx_count;
+
+    // RX worker'lar (atomic)
+    uint32_t rx_count;
+    uint32_t rx_hw_count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint32_t hist[LATENCY_LOAD_BUCKETS];
+
+    // Ana thread
+    uint16_t rx_port;
+    uint64_t obytes_start;
+    uint64_t measure_start_tsc;
+    uint16_t point_count;
+    struct latency_load_point points[LATENCY_LOAD_MAX_LEVELS];
+} __rte_cache_aligned;
+
+#if LATENCY_LOAD_TEST_ENABLED
+
+extern struct latency_load_port latency_load_ports[RTE_MAX_ETHPORTS];
+
+/**
+ * Çiftleri (TX VLAN'ı olan portlar) ve probe VL-ID'lerini hazırla, seviye
+ * taramasını başlat. TX/RX worker'lar başlamadan önce çağrılır.
+ */
+int latency_load_init(struct ports_config *ports_config);
+
+/** Ana döngüden saniyede bir: faz geçişleri, seviye sonuçları */
+void latency_load_tick(void);
+
+/** Tarama tamamlandı mı (veya hiç başlamadı) */
+bool latency_load_done(void);
+
+/** Çift başına latency-yük eğrisi (tamamlanan seviyeler) */
+void latency_load_print(void);
+
+/** Queue 0 TX worker'ından: zamanı geldiyse bir probe gönder */
+void latency_load_send_probe(struct tx_worker_params *params, uint64_t now);
+
+/** RX worker'ından: probe paketinin gecikmesini kaydet */
+void latency_load_rx_probe(uint16_t port_id, uint16_t src_port_id,
+                           const struct rte_mbuf *m, uint32_t payload_off);
+
+/** Traffic gap'ini / token maliyetini portun yük seviyesine ölçekle */
+static inline uint64_t latency_load_scale(uint16_t port_id, uint64_t v)
+{
+    return (v * latency_load_ports[port_id].gap_scale_q16) >> 16;
+}
+
+static inline bool latency_load_probe_due(uint16_t port_id, uint64_t now)
+{
+    const struct latency_load_port *lp = &latency_load_ports[port_id];
+    return lp->probing && now >= lp->next_probe_tsc;
+}
+
+static inline bool latency_load_is_probe(uint16_t src_port_id, uint16_t vl_id)
+{
+    return src_port_id < RTE_MAX_ETHPORTS &&
+           vl_id == latency_load_ports[src_port_id].probe_vl_id && vl_id != 0;
+}
+
+#endif /* LATENCY_LOAD_TEST_ENABLED */
+
+#endif /* LATENCY_LOAD_H */
@@ -0,0 +1,172 @@
+#ifndef LATENCY_MONITOR_H
+#define LATENCY_MONITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <rte_ethdev.h>
+#include "config.h"
+#include "tx_rx_manager.h"
+#include "latency_hist.h"
+
+// ==========================================
+// CONTINUOUS LATENCY MONITOR (normal mod)
+// ==========================================
+// Normal trafik akarken her TX VLAN'ı için sürekli probe gönderilir ve
+// VLAN başına interval'lik p50/p99/max/kayıp zaman serisi tutulur
+// (latency_test monitor modunun DPDK karşılığı).
+//
+//   Probe  : Queue 0 TX worker'ı LATENCY_MONITOR_PROBE_US'de bir, portun
+//            VLAN'larını sırayla dolaşarak önceden kurulmuş probe mbuf'ını
+//            (latency_probe.h) ayrılmış VL-ID ile gönderir. RX'te flow kuralı
+//            varsa probe kuyruğundan, yoksa RSS kuyruğunda VL-ID ile ayrılır.
+//   Zaman  : TX = payload'a yazılan TSC, RX = nic_clock (HW varsa)
+//   Interval: Stats servis thread'i her LATENCY_MONITOR_INTERVAL_SEC'de
+//            kümülatif histogramın farkından p50/p99'u ve interval max'ını
+//            hesaplar. Kayıp TX-RX sayaçlarından: iki ardışık sınırda da
+//            cevapsız kalan probe kayıptır (sınırda uçuşta olan sayılmaz, gerçek
+//            kayıp bir interval gecikmeli görünür). Ayrı lcore yok: iş saniyede
+//            bir yapılan snapshot build'inin içinde, datapath'e dokunmadan.
+//   Alarm  : Warm-up sonrası ilk LATENCY_MONITOR_BASELINE_INTERVALS dolu
+//            interval'in p50 medyanı baseline olur. p50, baseline'ın
+//            %LATENCY_MONITOR_DRIFT_PCT üstünde LATENCY_MONITOR_DRIFT_HOLD
+//            interval kalırsa drift; p99 önceki interval'in %STEP_PCT (ve en
+//            az STEP_MIN_NS) üstüne çıkarsa step alarmı.
+//   Kayıt  : Son interval sonucu stats recorder'a VLAN başına kolon olarak
+//            yazılır (portX.vlanY.lat_p50_ns, ...); tools/stats_rec_tool okur.
+//
+// latency-under-load ile birlikte kullanılamaz (ikisi de ilk VLAN'ın probe
+// VL-ID'sini kullanır).
+
+#ifndef LATENCY_MONITOR_ENABLED
+#define LATENCY_MONITOR_ENABLED 0
+#endif
+
+#if LATENCY_MONITOR_ENABLED && !LATENCY_TEST_ENABLED
+#error "LATENCY_MONITOR_ENABLED requires LATENCY_TEST_ENABLED (probe packet format)"
+#endif
+
+#if LATENCY_MONITOR_ENABLED && LATENCY_LOAD_TEST_ENABLED
+#error "LATENCY_MONITOR_ENABLED and LATENCY_LOAD_TEST_ENABLED share the probe VL-ID"
+#endif
+
+#define LATENCY_MONITOR_PROBE_US            200     // Port başına probe aralığı (VLAN'lar sırayla)
+#define LATENCY_MONITOR_INTERVAL_SEC        10      // Rapor interval'i
+#define LATENCY_MONITOR_DRIFT_PCT           20      // p50 baseline'dan bu kadar yukarı -> drift
+#define LATENCY_MONITOR_STEP_PCT            50      // p99 önceki interval'den bu kadar yukarı -> step
+#define LATENCY_MONITOR_BASELINE_INTERVALS  6       // Baseline = ilk N dolu interval'in p50 medyanı
+#define LATENCY_MONITOR_DRIFT_HOLD          3       // Drift alarmı için ardışık interval
+#define LATENCY_MONITOR_STEP_MIN_NS         1000    // Step alarmı için minimum mutlak artış
+#define LATENCY_MONITOR_MAX_VLANS           128     // Tüm portlardaki izlenen VLAN
+
+#define LATENCY_MONITOR_FLAG_DRIFT      0x0001  // p50 baseline'dan kaydı (alarm aktif)
+#define LATENCY_MONITOR_FLAG_STEP       0x0002  // p99 önceki interval'e göre sıçradı
+#define LATENCY_MONITOR_FLAG_LOSS       0x0004  // Interval'de kayıp probe var
+#define LATENCY_MONITOR_FLAG_NO_DATA    0x0008  // Hiç örnek yok (p50/p99/max = 0)
+#define LATENCY_MONITOR_FLAG_BASELINE   0x0010  // Baseline hâlâ toplanıyor (veya warm-up)
+
+/** Son tamamlanan interval (servis thread'i yazar ve okur) */
+struct latency_monitor_point {
+    uint64_t samples_total;     // Kümülatif geçerli örnek
+    uint64_t lost_total;        // Kümülatif kayıp probe
+    uint32_t p50_ns;
+    uint32_t p99_ns;
+    uint32_t max_ns;
+    uint32_t samples;           // Interval örnek sayısı
+    uint32_t lost;              // Interval kayıp (bir interval gecikmeli)
+    uint32_t flags;             // LATENCY_MONITOR_FLAG_*
+    uint32_t alarms;            // Kümülatif alarm (drift + step)
+};
+
+/** İzlenen bir VLAN (TX port -> RX port) */
+struct latency_monitor_vlan {
+    uint16_t tx_port;
+    uint16_t rx_port;
+    uint16_t vlan_id;
+    uint16_t vl_id;             // Probe VL-ID
+    uint16_t vlan_idx;          // TX port VLAN sırası (latency_probe_take)
+
+    // RX worker'lar (atomic, kümülatif)
+    uint32_t rx_count;          // Gelen probe (kayıp hesabı)
+    uint64_t max_ns;            // Interval max (servis thread'i sıfırlar)
+    uint32_t hist[LAT_HIST_BUCKETS];
+
+    // Queue 0 TX worker'ı (tek yazar)
+    volatile uint32_t tx_count __rte_cache_aligned;
+
+    // Servis thread'i
+    uint32_t prev_hist[LAT_HIST_BUCKETS] __rte_cache_aligned;
+    uint32_t prev_rx;
+    uint32_t prev_tx;
+    int64_t  pending;           // Önceki sınırda cevapsız probe
+    uint32_t base_p50[LATENCY_MONITOR_BASELINE_INTERVALS];
+    uint32_t base_count;
+    uint32_t baseline_ns;       // 0 = henüz yok
+    uint32_t prev_p99;
+    int      drift_run;         // Eşik üstü ardışık interval
+    bool     drift_alarm;
+    struct latency_monitor_point point;
+} __rte_cache_aligned;
+
+/** TX port başına durum */
+struct latency_monitor_port {
+    uint16_t first;             // latency_monitor_vlans içindeki ilk VLAN
+    uint16_t vlan_count;        // 0 = bu port izlenmiyor
+
+    // Queue 0 TX worker'ına özel
+    uint64_t next_probe_tsc;
+    uint16_t next_vlan;
+    uint32_t seq;
+
+    // RX: probe VL-ID -> VLAN sırası + 1 (0 = probe değil)
+    uint8_t  vl_to_vlan[MAX_VL_ID + 1];
+} __rte_cache_aligned;
+
+#if LATENCY_MONITOR_ENABLED
+
+extern struct latency_monitor_port latency_monitor_ports[RTE_MAX_ETHPORTS];
+extern struct latency_monitor_vlan *latency_monitor_vlans;
+extern uint16_t latency_monitor_nb_vlans;
+
+/**
+ * İzlenecek VLAN'ları (TX VLAN'ı olan portlar) kur. latency_probe_init'ten
+ * sonra, TX/RX worker'lar ve stats servisi başlamadan önce çağrılır.
+ */
+int latency_monitor_init(struct ports_config *ports_config);
+
+/** VLAN tablosunu bırak (worker'lar ve stats servisi durduktan sonra) */
+void latency_monitor_cleanup(void);
+
+/**
+ * Stats servis thread'inden (her snapshot build'inde): interval dolduysa
+ * sonuçları hesapla, alarmları değerlendir. Warm-up bitmeden baseline
+ * toplanmaz, alarm verilmez.
+ */
+void latency_monitor_tick(bool warmup_complete);
+
+/** Ana döngüden: yeni bir interval tamamlandıysa VLAN tablosunu bas */
+void latency_monitor_print_stats(void);
+
+/** Queue 0 TX worker'ından: sıradaki VLAN'ın probe'unu gönder */
+void latency_monitor_send_probe(struct tx_worker_params *params, uint64_t now);
+
+/** RX worker'ından: probe paketinin gecikmesini kaydet */
+void latency_monitor_rx_probe(uint16_t port_id, uint16_t src_port_id, uint16_t vlan_idx,
+                              const struct rte_mbuf *m, uint32_t payload_off);
+
+static inline bool latency_monitor_probe_due(uint16_t port_id, uint64_t now)
+{
+    const struct latency_monitor_port *mp = &latency_monitor_ports[port_id];
+    return mp->vlan_count != 0 && now >= mp->next_probe_tsc;
+}
+
+/** Kaynak portun probe VL-ID'si ise VLAN sırası, değilse -1 */
+static inline int latency_monitor_probe_vlan(uint16_t src_port_id, uint16_t vl_id)
+{
+    if (src_port_id >= RTE_MAX_ETHPORTS || vl_id > MAX_VL_ID)
+        return -1;
+    return (int)latency_monitor_ports[src_port_id].vl_to_vlan[vl_id] - 1;
+}
+
+#endif /* LATENCY_MONITOR_ENABLED */
+
+#endif /* LATENCY_MONITOR_H */
@@ -0,0 +1,128 @@
+#ifndef LATENCY_PROBE_H
+#define LATENCY_PROBE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <rte_ethdev.h>
+#include <rte_flow.h>
+#include <rte_mbuf.h>
+#include "config.h"
+#include "packet.h"
+#include "tx_rx_manager.h"
+
+// ==========================================
+// LATENCY PROBE PATH (prebuilt mbuf + dedicated RX queue)
+// ==========================================
+// Probe paketleri (latency testi, latency-under-load, monitor) iki yoldan ayrılır:
+//
+//   TX : Port başına, her TX VLAN için LATENCY_PROBE_DEPTH adet önceden
+//        kurulmuş mbuf. Gönderimde sadece [SEQ][TX TSC] alanları yazılır ve
+//        refcnt +1 yapılır; PMD TX tamamlayınca refcnt 1'e döner, mbuf
+//        havuza geri dönmez. refcnt 1 değilse mbuf hâlâ TX ring'inde
+//        (uçuşta), sıradaki denenir. PRBS alanı kurulumda (seq 0) yazılır,
+//        latency RX PRBS doğrulamadığı için değişmez.
+//   RX : LATENCY_PROBE_FLOW_ENABLED ile her VLAN aralığının son VL-ID'si
+//        probe'lara ayrılır; RX portunda bu VL-ID'lerin DST MAC'leri için
+//        rte_flow kuralı ile probe'lar LATENCY_PROBE_RX_QUEUE'ya yönlenir,
+//        PRBS doğrulayan RSS kuyrukları probe görmez. Kural kurulamayan port
+//        eski yola döner (queue 0, test süresince RETA -> 0).
+//
+// VL-ID ayırma çalışma anında verilir (latency_probe_vl_reserved): en az bir
+// portta flow kuralı kurulduysa veya latency-under-load / monitor açıksa
+// (probe'u VL-ID ile ayırır). Aksi halde probe'lar VLAN'ın ilk VL-ID'sini kullanır ve
+// normal trafik aralığın tamamını gönderir. Ek RX kuyruğu port
+// yapılandırılırken (kurallardan önce) açılmak zorunda olduğundan sadece
+// LATENCY_PROBE_FLOW_ENABLED ile derlenince eklenir (varsayılan); kurallar
+// reddedilirse RETA dışında boş kalır ve VL-ID ayrılmaz, yani flow desteği
+// olmayan NIC'te davranış eski yolla aynıdır.
+
+#ifndef LATENCY_PROBE_FLOW_ENABLED
+#define LATENCY_PROBE_FLOW_ENABLED 1    // 0: probe'lar queue 0'da (RSS ile paylaşılır)
+#endif
+
+// Port başına ek RX kuyruğu (RSS dağılımı dışında, en sondaki indeks)
+#define LATENCY_PROBE_RX_QUEUES     ((LATENCY_TEST_ENABLED && LATENCY_PROBE_FLOW_ENABLED) ? 1 : 0)
+#define LATENCY_PROBE_RX_QUEUE      NUM_RX_CORES
+
+#define LATENCY_PROBE_VL_OFFSET     (VL_RANGE_SIZE_PER_QUEUE - 1)   // Ayrıldığında VLAN aralığındaki VL-ID
+#define LATENCY_PROBE_DEPTH         4       // VLAN başına önceden kurulmuş mbuf
+#define LATENCY_PROBE_MAX_FLOWS     64      // RX port başına flow kuralı
+#define LATENCY_PROBE_RX_BURST      8
+
+#if LATENCY_TEST_ENABLED
+
+struct latency_probe_port {
+    // TX (port TX VLAN'ları)
+    struct rte_mempool *pool;
+    struct rte_mbuf *mbufs[MAX_TX_VLANS_PER_PORT][LATENCY_PROBE_DEPTH];
+    uint8_t  next[MAX_TX_VLANS_PER_PORT];   // Sıradaki denenecek mbuf
+    uint16_t vlan_count;
+    uint64_t busy;                          // Tüm kopyalar uçuştayken atlanan probe
+
+    // RX
+    struct rte_flow *flows[LATENCY_PROBE_MAX_FLOWS];
+    uint16_t nb_flows;
+    bool     flow_active;                   // Probe'lar LATENCY_PROBE_RX_QUEUE'da
+};
+
+extern struct latency_probe_port latency_probe_ports[RTE_MAX_ETHPORTS];
+extern bool latency_probe_vl_reserved;  // Aralığın son VL-ID'si probe'lara ayrıldı
+
+/** VLAN'ın probe VL-ID'si (ayrılmışsa aralığın sonu, değilse ilk VL-ID) */
+static inline uint16_t latency_probe_vl_id(uint16_t port_id, uint16_t vlan_idx)
+{
+    return port_vlans[port_id].tx_vl_ids[vlan_idx] +
+           (latency_probe_vl_reserved ? LATENCY_PROBE_VL_OFFSET : 0);
+}
+
+/** Normal trafiğin VLAN aralığında kullanabildiği VL-ID sayısı */
+static inline uint16_t latency_probe_tx_vl_wrap(uint16_t vl_range_size)
+{
+    return latency_probe_vl_reserved ? (uint16_t)(vl_range_size - 1) : vl_range_size;
+}
+
+/**
+ * RX portlarına flow kurallarını yükle, VL-ID ayırmaya karar ver, probe
+ * mbuf'larını kur. Portlar başladıktan sonra, latency testinden ve TX
+ * worker'larından önce bir kez çağrılır.
+ */
+int latency_probe_init(struct ports_config *ports_config);
+
+/** Flow kurallarını kaldır (portlar kapanmadan önce) */
+void latency_probe_flow_cleanup(struct ports_config *ports_config);
+
+/**
+ * Probe mbuf'larını ve havuzları bırak. cleanup_ports'tan sonra çağrılır:
+ * TX ring'inde kalan kopyalar (refcnt 2) port durdurulurken havuza döner,
+ * havuz ondan önce silinirse serbest bırakılmış belleğe yazılır.
+ */
+void latency_probe_release(void);
+
+/**
+ * VLAN'ın serbest bir probe mbuf'ına seq/TSC yaz ve gönderime hazırla
+ * (refcnt +1). Gönderilemezse çağıran rte_pktmbuf_free() ile referansı bırakır.
+ * @return NULL: VLAN yok veya tüm kopyalar hâlâ TX ring'inde
+ */
+struct rte_mbuf *latency_probe_take(uint16_t port_id, uint16_t queue_id, uint16_t vlan_idx,
+                                    uint64_t seq, uint64_t tx_tsc);
+
+/** Probe'ların geldiği RX kuyruğu (flow yoksa queue 0) */
+static inline uint16_t latency_probe_rx_queue(uint16_t port_id)
+{
+    return latency_probe_ports[port_id].flow_active ? LATENCY_PROBE_RX_QUEUE : 0;
+}
+
+static inline bool latency_probe_flow_active(uint16_t port_id)
+{
+    return latency_probe_ports[port_id].flow_active;
+}
+
+/**
+ * Normal mod: probe kuyruğunu boşalt (queue 0 RX worker'ından çağrılır),
+ * latency-under-load / monitor probe'larını kaydet, gerisini bırak
+ */
+void latency_probe_rx_poll(uint16_t port_id, uint16_t src_port_id);
+
+#endif /* LATENCY_TEST_ENABLED */
+
+#endif /* LATENCY_PROBE_H */
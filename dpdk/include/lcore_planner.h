@@ -0,0 +1,64 @@
+#ifndef LCORE_PLANNER_H
+#define LCORE_PLANNER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "port.h"
+#include "config.h"
+
+// ==========================================
+// LCORE PLACEMENT PLANNER
+// ==========================================
+// lcorePortAssign() yerine geçer. Kurallar:
+//   - Main lcore (stats döngüsü) hiçbir worker'a verilmez
+//   - Busy port worker'ları (LCORE_PLAN_BUSY_PORT_GBPS) tüm fiziksel core'u
+//     alır; SMT kardeşi boş bırakılır (LCORE_PLAN_SMT_EXCLUSIVE)
+//   - Worker'lar port'un NUMA node'unda tutulur; mempool ve PRBS cache
+//     worker'ların node'una (port.worker_numa_node) yerleştirilir
+//   - Raw socket RX thread'leri ve (birden fazla lane varsa) TX lane'leri
+//     için lcore'lar plan sırasında ayrılır (get_unused_cores() yerine
+//     lcore_plan_take_raw_cores() / lcore_plan_take_raw_tx_cores())
+//   - Herhangi bir worker yerleştirilemezse plan başarısız olur
+//
+// Plan sonucu ports_config (used_tx_cores, used_rx_cores, used_ext_tx_core,
+// worker_numa_node) ve unused_socket_to_lcore'a yazılır.
+
+enum lcore_plan_role {
+    LCORE_ROLE_FREE = 0,
+    LCORE_ROLE_MAIN,        // EAL main lcore (stats döngüsü)
+    LCORE_ROLE_SMT_IDLE,    // Busy worker'ın SMT kardeşi, bilerek boş
+    LCORE_ROLE_TX,
+    LCORE_ROLE_RX,
+    LCORE_ROLE_EXT_TX,      // Dedicated ext TX worker (inline olmayan portlar)
+    LCORE_ROLE_RAW_RX,      // Raw socket RX thread'i (pthread, EAL dışı)
+    LCORE_ROLE_RAW_TX,      // Raw socket TX lane thread'i (pthread, EAL dışı)
+};
+
+/**
+ * Build the placement plan from sysfs CPU topology and apply it to config.
+ * Must run after portNumaNodesMatch() and socketToLcore().
+ * @return 0 on success, -1 if any worker could not be placed (reason printed)
+ */
+int lcore_plan_build(struct ports_config *config);
+
+/**
+ * Print the placement map (lcore, cpu, node, physical core, role, expected load)
+ */
+void lcore_plan_print(void);
+
+/**
+ * Hand out the CPUs reserved for a raw socket port's RX queues
+ * @param port_id Raw socket port ID (12, 13)
+ * @param cores   Output: OS CPU numbers (for pthread affinity)
+ * @return Number of cores written (may be < count if plan reserved fewer)
+ */
+int lcore_plan_take_raw_cores(uint16_t port_id, int count, uint16_t *cores);
+
+/**
+ * Hand out the CPUs reserved for a raw socket port's TX lanes
+ * (only planned when the port has more than one lane)
+ * @return Number of cores written
+ */
+int lcore_plan_take_raw_tx_cores(uint16_t port_id, int count, uint16_t *cores);
+
+#endif /* LCORE_PLANNER_H */
@@ -0,0 +1,146 @@
+#ifndef NIC_CLOCK_H
+#define NIC_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+#include <rte_mbuf_dyn.h>
+#include "config.h"
+
+// ==========================================
+// NIC CLOCK (latency probe timestamp sources)
+// ==========================================
+// DPDK latency testi için port başına en iyi zaman kaynağı seçilir, tüm
+// zamanlar TSC cycle tabanına çevrilir (mevcut tsc_hz hesapları aynen kalır):
+//
+//   RX  HW : RTE_ETH_RX_OFFLOAD_TIMESTAMP dynfield (NIC saati, rte_eth_read_clock
+//            tabanı) -> kalibrasyonla TSC
+//       SW : rte_rx_burst() dönüşündeki rte_rdtsc()
+//   TX  HW : rte_eth_timesync_*: RTE_MBUF_F_TX_IEEE1588_TMST ile işaretli
+//            paketin NIC TX zamanı (PHC tabanı) -> kalibrasyonla TSC
+//       SW : rte_eth_tx_burst() döndükten sonraki rte_rdtsc() (descriptor
+//            NIC'e verildi; PMD paket hazırlama süresi hariç, DMA + kuyruk dahil)
+//
+// Kalibrasyon: her saat için NIC_CLOCK_CALIB_SAMPLES kez (tsc0, dev, tsc1)
+// okunur, en dar pencere seçilir; NIC_CLOCK_CALIB_MS arayla iki nokta oran
+// (tsc/birim) verir. Hata sınırı iki terimdir:
+//   - referans noktası: iki noktanın yarım pencereleri toplamı (okuma belirsizliği)
+//   - eğim: göreli eğim hatası (iki okuma belirsizliği + cihaz çözünürlüğü,
+//     taban uzunluğuna bölünmüş) x (t - tsc_ref)
+// 20 ms tabanda eğim hatası ~5e-5 mertebesindedir, yani referanstan saniyeler
+// sonraki zamanlar onlarca us kayabilir; bu yüzden taban 100 ms ve rapor
+// edilen sınır raporun yazıldığı ana (test sonu) göre hesaplanır. Test başında
+// yeniden kalibre edilir. SW taraflar ("sw") TSC'dir: TSC aynı yöntemle
+// CLOCK_MONOTONIC_RAW'a karşı kalibre edilir, sınırı okuma penceresi +
+// (eğim hatası + nominal tsc_hz'in ölçülen orandan sapması) x uzaklıktır.
+// Poll döngüsü / doorbell gecikmesi saat hatası değildir, sınıra girmez.
+//
+// Gönderim zamanı (NIC TX / tx_burst sonrası) sadece tek örnekli sonuçlara
+// (rx_count == tx_count == 1, varsayılan PACKETS_PER_VLAN) uygulanır; paket
+// başına gönderim zamanı tutulmadığından çok örnekli sonuçlar payload'daki
+// (tx_burst öncesi) TSC'ye göre kalır.
+
+#ifndef LATENCY_NIC_TIMESTAMP
+#define LATENCY_NIC_TIMESTAMP 1         // 0: sadece TSC (eski davranış)
+#endif
+
+// HW saatler sadece latency testi derlendiğinde açılır (RX offload maliyeti)
+#define NIC_CLOCK_ACTIVE (LATENCY_TEST_ENABLED && LATENCY_NIC_TIMESTAMP)
+
+#define NIC_CLOCK_CALIB_SAMPLES  32     // Kalibrasyon noktası başına okuma
+#define NIC_CLOCK_CALIB_MS       100    // İki kalibrasyon noktası arası (eğim tabanı)
+#define NIC_CLOCK_TX_POLL_US     50     // HW TX timestamp bekleme süresi
+
+/** Cihaz saati (tick veya ns) -> TSC eşlemesi */
+struct nic_clock_map {
+    bool     valid;
+    uint64_t dev_ref;           // Referans noktasındaki cihaz saati
+    uint64_t tsc_ref;           // Referans noktasındaki TSC
+    double   tsc_per_unit;      // Cihaz birimi başına TSC cycle
+    uint64_t err_cycles;        // Referans noktası hata sınırı (TSC cycles)
+    double   slope_err;         // Göreli eğim hatası (tsc_ref'ten uzaklıkla çarpılır)
+};
+
+struct nic_clock_port {
+    bool rx_hw;                 // RX timestamp offload açık
+    bool tx_hw;                 // timesync TX timestamp çalışıyor
+    struct nic_clock_map rx_map;    // rte_eth_read_clock tabanı
+    struct nic_clock_map tx_map;    // rte_eth_timesync_read_time tabanı (ns)
+};
+
+extern struct nic_clock_port nic_clock_ports[RTE_MAX_ETHPORTS];
+extern struct nic_clock_map nic_clock_tsc_map;   // TSC -> CLOCK_MONOTONIC_RAW (ns)
+extern int nic_clock_ts_offset;        // RX timestamp dynfield offset, -1 = yok
+extern uint64_t nic_clock_ts_flag;     // RX timestamp dynflag
+
+/**
+ * rte_eth_dev_configure() öncesi: destekleniyorsa RX timestamp offload'u ekle
+ */
+void nic_clock_port_conf(uint16_t port_id, const struct rte_eth_dev_info *dev_info,
+                         struct rte_eth_conf *port_conf);
+
+/**
+ * rte_eth_dev_start() sonrası: dynfield'ı bul, timesync'i dene, kalibre et
+ */
+void nic_clock_port_start(uint16_t port_id);
+
+/**
+ * TSC'yi CLOCK_MONOTONIC_RAW'a karşı kalibre et (SW tarafların hata sınırı)
+ * @return 0: başarılı, -1: sınır bilinmiyor
+ */
+int nic_clock_calibrate_tsc(void);
+
+/**
+ * Port saatlerini yeniden kalibre et (latency testi başında)
+ * @return 0: en az bir HW saat geçerli, -1: sadece TSC
+ */
+int nic_clock_calibrate(uint16_t port_id);
+
+static inline uint64_t nic_clock_map_tsc(const struct nic_clock_map *m, uint64_t dev)
+{
+    int64_t d = (int64_t)(dev - m->dev_ref);
+    return m->tsc_ref + (uint64_t)(int64_t)((double)d * m->tsc_per_unit);
+}
+
+/**
+ * Paketin RX zamanı (TSC cycles). HW timestamp yoksa fallback_tsc döner.
+ */
+static inline uint64_t nic_clock_rx_tsc(uint16_t port_id, const struct rte_mbuf *m,
+                                        uint64_t fallback_tsc, bool *hw)
+{
+    const struct nic_clock_port *p = &nic_clock_ports[port_id];
+
+    if (p->rx_hw && p->rx_map.valid && (m->ol_flags & nic_clock_ts_flag)) {
+        *hw = true;
+        return nic_clock_map_tsc(&p->rx_map,
+            *RTE_MBUF_DYNFIELD(m, nic_clock_ts_offset, rte_mbuf_timestamp_t *));
+    }
+    *hw = false;
+    return fallback_tsc;
+}
+
+/** HW TX timestamp isteği için mbuf'ı işaretle */
+static inline void nic_clock_tx_mark(uint16_t port_id, struct rte_mbuf *m)
+{
+    if (nic_clock_ports[port_id].tx_hw)
+        m->ol_flags |= RTE_MBUF_F_TX_IEEE1588_TMST;
+}
+
+/**
+ * İşaretli son paketin HW TX zamanını oku (NIC_CLOCK_TX_POLL_US'e kadar bekler)
+ * @return true: *tsc HW kaynaklı
+ */
+bool nic_clock_tx_tsc(uint16_t port_id, uint64_t *tsc);
+
+/**
+ * Portun RX/TX saat hata sınırı (ns), at_tsc anındaki bir dönüşüm için:
+ * err_cycles + slope_err * |at_tsc - tsc_ref|. SW taraf için nic_clock_tsc_map
+ * kullanılır; TSC kalibre edilemediyse UINT64_MAX (bilinmiyor)
+ */
+uint64_t nic_clock_err_ns(uint16_t port_id, bool tx, uint64_t at_tsc);
+
+/** Port başına zaman kaynağı ve hata sınırı tablosu (sınır şu anki TSC için) */
+void nic_clock_print(const uint16_t *port_ids, uint16_t nb_ports);
+
+#endif /* NIC_CLOCK_H */
@@ -114,7 +114,6 @@
 
 #define ETHER_TYPE_IPv4 0x0800
 #define ETHER_TYPE_VLAN 0x8100
-#define MAX_PRBS_CACHE_PORTS 12
 
 struct ports_config; 
 
@@ -182,8 +181,10 @@ struct prbs_cache {
     int       socket_id;
 };
 
-// global PRBS cache
-extern struct prbs_cache port_prbs_cache[MAX_PRBS_CACHE_PORTS];
+// global PRBS cache: port_id ile indekslenir, port_prbs_cache_count girdi
+// (init_prbs_cache_for_all_ports keşfedilen port_id aralığı kadar ayırır)
+extern struct prbs_cache *port_prbs_cache;
+extern uint16_t port_prbs_cache_count;
 
 // ==========================================
 // FUNCTION PROTOTYPES
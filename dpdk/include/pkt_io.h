@@ -0,0 +1,193 @@
+#ifndef PKT_IO_H
+#define PKT_IO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "af_xdp_port.h"
+
+// ==========================================
+// BURST PACKET I/O (DPDK / PACKET_MMAP / AF_XDP)
+// ==========================================
+// Port tipinden bağımsız burst arayüzü. Worker'lar frame'i nereden
+// aldığını bilmez:
+//   rx_burst -> işle -> rx_free        (frame'ler arada backend'de kalır)
+//   tx_alloc -> yaz  -> tx_burst (+ tx_free artanlar) -> tx_flush
+//
+// Backend'ler:
+//   PKT_IO_DPDK         rte_eth_rx/tx_burst + mbuf (mempool)
+//   PKT_IO_PACKET_MMAP  PACKET_RX_RING (TPACKET_V2 frame / V3 block) ve
+//                       PACKET_TX_RING (TPACKET_V2), send() kick
+//   PKT_IO_AF_XDP       XSK RX/fill ve TX/completion ring'leri
+//
+// Çağrı başına bir burst: dispatch maliyeti paket başına değil burst
+// başına ödenir. Aynı pkt_io_port'u tek thread kullanır.
+
+#define PKT_IO_BURST        32          // Önerilen/azami burst boyutu
+
+struct rte_mbuf;
+struct rte_mempool;
+
+enum pkt_io_backend {
+    PKT_IO_NONE = 0,
+    PKT_IO_DPDK,
+    PKT_IO_PACKET_MMAP,
+    PKT_IO_AF_XDP,
+};
+
+// Burst elemanı: data/len kullanıcıya, handle backend'e ait
+struct pkt_io_buf {
+    uint8_t *data;
+    uint32_t len;                       // RX: alınan uzunluk, TX: gönderilecek uzunluk
+    uintptr_t handle;                   // mbuf*, tpacket2_hdr* veya UMEM adresi
+};
+
+struct pkt_io_port {
+    enum pkt_io_backend backend;
+    int fd;                             // pkt_io_wait() için (DPDK: -1)
+
+    // PACKET_MMAP RX: V2'de slot = frame, V3'te slot = block
+    uint8_t *rx_ring;
+    uint32_t rx_slot_size;
+    uint32_t rx_slot_nr;
+    uint32_t rx_index;                  // Sıradaki slot
+    uint32_t rx_pkts_left;              // V3: açık block'ta kalan paket
+    uint8_t *rx_pkt;                    // V3: açık block'ta sıradaki paket
+    bool rx_v3;
+
+    // PACKET_MMAP TX (TPACKET_V2)
+    uint8_t *tx_ring;
+    uint32_t tx_frame_size;
+    uint32_t tx_frame_nr;
+    uint32_t tx_offset;                 // Sıradaki boş frame
+    uint32_t tx_reclaim;                // Kernel'in henüz bırakmadığı en eski frame
+
+    struct xsk_port *xsk;               // AF_XDP
+
+    // DPDK
+    uint16_t dpdk_port;
+    uint16_t dpdk_queue;
+    struct rte_mempool *mp;             // tx_alloc kaynağı
+};
+
+// ==========================================
+// SETUP
+// ==========================================
+
+/**
+ * PACKET_MMAP port. rx_ring/tx_ring NULL olabilir (tek yönlü soket).
+ * @param rx_slot_size V2: frame boyutu, V3: block boyutu
+ * @param rx_slot_nr   V2: frame sayısı, V3: block sayısı
+ */
+void pkt_io_init_mmap(struct pkt_io_port *p, int fd,
+                      void *rx_ring, uint32_t rx_slot_size, uint32_t rx_slot_nr, bool rx_v3,
+                      void *tx_ring, uint32_t tx_frame_size, uint32_t tx_frame_nr);
+
+/** AF_XDP port (RX ve TX aynı XSK üzerinden) */
+void pkt_io_init_xsk(struct pkt_io_port *p, struct xsk_port *x);
+
+/** DPDK port/queue. mp NULL ise sadece RX */
+void pkt_io_init_dpdk(struct pkt_io_port *p, uint16_t port_id, uint16_t queue_id,
+                      struct rte_mempool *mp);
+
+// ==========================================
+// DATAPATH
+// ==========================================
+
+/**
+ * En fazla n (<= PKT_IO_BURST) paket al. Frame'ler pkt_io_rx_free'ye kadar
+ * geçerlidir; sonraki rx_burst'ten önce bırakılmalıdır.
+ * @return Alınan paket sayısı (0: kuyruk boş)
+ */
+uint16_t pkt_io_rx_burst(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n);
+
+/** Son rx_burst'te alınan n paketi backend'e geri ver */
+void pkt_io_rx_free(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n);
+
+/**
+ * En fazla n (<= PKT_IO_BURST) yazılabilir TX frame'i ayır.
+ * @return Ayrılan frame sayısı (0: ring/UMEM/mempool dolu)
+ */
+uint16_t pkt_io_tx_alloc(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n);
+
+/**
+ * Ayrılan frame'lerin ilk n'ini (ayrılma sırasıyla) gönderime ver.
+ * PACKET_MMAP/AF_XDP'de kernel pkt_io_tx_flush ile görür; DPDK'da hemen
+ * gönderilir, NIC'in almadıkları serbest bırakılır.
+ * @return Gönderime verilen frame sayısı
+ */
+uint16_t pkt_io_tx_burst(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n);
+
+/** Ayrılıp gönderilmeyen frame'leri geri ver */
+void pkt_io_tx_free(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n);
+
+/** Bekleyen TX frame'lerini kernel'e teslim et (DPDK: no-op) */
+int pkt_io_tx_flush(struct pkt_io_port *p);
+
+/** Kernel'e verilmiş ama henüz gönderilmemiş frame sayısı */
+uint32_t pkt_io_tx_in_flight(struct pkt_io_port *p);
+
+/** fd'de olay bekle (DPDK: bekleme yok, poll mode) */
+void pkt_io_wait(struct pkt_io_port *p, short events, int timeout_ms);
+
+/**
+ * Alınan paketin kernel RX zamanı (PACKET_MMAP: tpacket header tp_sec/tp_nsec).
+ * rx_free'den önce çağrılmalıdır.
+ * @param hw  NULL değilse: zaman NIC donanımından mı (TP_STATUS_TS_RAW_HARDWARE)
+ * @return CLOCK_REALTIME ns, 0: backend zaman vermiyor (DPDK/AF_XDP)
+ */
+uint64_t pkt_io_rx_timestamp(const struct pkt_io_port *p, const struct pkt_io_buf *b, bool *hw);
+
+// ==========================================
+// PAYLOAD ENGINE (seq + PRBS)
+// ==========================================
+// Tüm port tipleri aynı payload'u kullanır: 8 byte sequence + PRBS-31.
+// PRBS verisi üreticinin cache'inden seq * stride ofsetinden alınır.
+// stride üreticinin azami PRBS boyutudur (IMIX'te kısa paketler aynı
+// ofsetin başını taşır): DPDK portları MAX_PRBS_BYTES, raw portlar
+// RAW_PKT_PRBS_BYTES. Cache'ler stride kadar wraparound uzantılıdır.
+
+#define PKT_SEQ_BYTES           8
+#define PKT_PRBS_CACHE_SIZE     268435456ULL    // 2^28 byte, PRBS-31 periyodu / 8
+
+static inline const uint8_t *pkt_prbs_at(const uint8_t *cache_ext, uint64_t seq, uint16_t stride)
+{
+    return cache_ext + (seq * (uint64_t)stride) % PKT_PRBS_CACHE_SIZE;
+}
+
+/** payload = seq (8 byte) + prbs_len byte PRBS */
+static inline void pkt_payload_fill(uint8_t *payload, uint64_t seq, const uint8_t *cache_ext,
+                                    uint16_t stride, uint16_t prbs_len)
+{
+    memcpy(payload, &seq, PKT_SEQ_BYTES);
+    memcpy(payload + PKT_SEQ_BYTES, pkt_prbs_at(cache_ext, seq, stride), prbs_len);
+}
+
+/**
+ * Alınan PRBS'i üreticinin cache'iyle karşılaştır (en fazla stride byte)
+ * @return Bit hata sayısı (0: paket sağlam)
+ */
+static inline uint64_t pkt_payload_verify(const uint8_t *prbs, uint32_t prbs_len, uint64_t seq,
+                                          const uint8_t *cache_ext, uint16_t stride)
+{
+    if (prbs_len > stride)
+        prbs_len = stride;
+
+    const uint8_t *expected = pkt_prbs_at(cache_ext, seq, stride);
+    if (memcmp(prbs, expected, prbs_len) == 0)
+        return 0;
+
+    uint64_t bits = 0;
+    uint32_t i = 0;
+    for (; i + 8 <= prbs_len; i += 8) {
+        uint64_t a, b;
+        memcpy(&a, prbs + i, 8);
+        memcpy(&b, expected + i, 8);
+        bits += __builtin_popcountll(a ^ b);
+    }
+    for (; i < prbs_len; i++)
+        bits += __builtin_popcount(prbs[i] ^ expected[i]);
+    return bits;
+}
+
+#endif /* PKT_IO_H */
@@ -1,7 +1,6 @@
 #pragma once
 #include <rte_ethdev.h>
 
-#define MAX_PORTS 8
 #define MAX_LCORE 32
 #define PCI_ADDR_LEN 32
 
@@ -20,6 +19,7 @@
 struct port {
     uint16_t port_id;
     uint16_t numa_node;                  /* NUMA socket ID */
+    uint16_t worker_numa_node;           /* NUMA node of its workers (mempool + PRBS cache) */
     char pci_addr[PCI_ADDR_LEN];         /* PCI address (e.g. 0000:01:00.0) */
     char driver_name[32];                /* Driver name */
     bool is_valid;                       /* Port is valid and usable */
@@ -34,5 +34,6 @@ struct port {
  */
 struct ports_config {
     uint16_t nb_ports;                   /* Number of available ports */
-    struct port ports[MAX_PORTS];        /* Array of port information */
+    uint16_t port_table_size;            /* Highest port_id + 1 (per-port table size) */
+    struct port *ports;                  /* nb_ports entries, rte_zmalloc'd at discovery */
 };
@@ -0,0 +1,131 @@
+#ifndef RAW_LATENCY_H
+#define RAW_LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// ==========================================
+// RAW PORT ONE-WAY LATENCY (SO_TIMESTAMPING)
+// ==========================================
+// Tam trafik altında DPDK <-> raw port akışlarının tek yön gecikmesi.
+// Ayrı test paketi yok: normal trafiğin her VL-ID'sinde seq'i
+// 2^RAW_LAT_SAMPLE_SHIFT'in katı olan paketler örneklenir.
+//
+//   TX tarafı  raw lane : SO_TIMESTAMPING + OPT_ID, errqueue'dan kernel
+//                         TX zamanı (HW varsa NIC, yoksa SW)
+//              DPDK ext : rte_eth_tx_burst() sonrası host zamanı
+//   RX tarafı  raw RX   : tpacket header tp_sec/tp_nsec (PACKET_TIMESTAMP)
+//              DPDK RX  : paket worker'a geldiği anki host zamanı
+//
+// Eşleşme: TX örneği (vl, seq) anahtarıyla akışın slot tablosuna yazılır,
+// RX aynı anahtarı bulursa fark akışın histogramına eklenir. Tüm zamanlar
+// CLOCK_REALTIME ns; HW modunda NIC PHC'nin sistem saatine senkron
+// olduğu (phc2sys) varsayılır.
+//
+// Akış = bir TX target'ın VL-ID aralığı ("P12->P5", "P2->P12" ...).
+
+#ifndef RAW_SOCKET_TIMESTAMPING
+#define RAW_SOCKET_TIMESTAMPING 0       // 0: kapalı, 1: software, 2: hardware (+SW fallback)
+#endif
+
+#define RAW_LAT_SAMPLE_SHIFT     6      // Her VL-ID'de 64 paketten biri
+#define RAW_LAT_MAX_FLOWS        32
+#define RAW_LAT_SLOTS            4096   // Akış başına uçuştaki örnek (2'nin kuvveti)
+#define RAW_LAT_HIST_BUCKETS     20     // [0]: <256ns, [i]: [256<<(i-1), 256<<i) ns, [19]: >=67ms
+#define RAW_LAT_HIST_BASE_SHIFT  8      // 256 ns
+#define RAW_LAT_TX_PENDING       4096   // Lane başına OPT_ID penceresi (>= TX ring frame sayısı, 2'nin kuvveti)
+#define RAW_LAT_DRAIN_FRAMES     128    // Errqueue bu kadar frame'de bir boşaltılır
+#define RAW_LAT_LABEL_LEN        24
+
+// Uzun süreli izleme alarmları (raw_lat_print_stats her interval'de):
+//   drift: interval ortalaması, ilk RAW_LAT_BASELINE_INTERVALS interval'in
+//          medyan ortalamasını RAW_LAT_DRIFT_PCT aşarak RAW_LAT_DRIFT_HOLD
+//          interval sürerse (histogram 2x çözünürlüklü, ortalama kesin)
+//   step : p99 bucket'ı önceki interval'e göre RAW_LAT_STEP_BUCKETS (x2) sıçrarsa
+#define RAW_LAT_BASELINE_INTERVALS  6
+#define RAW_LAT_DRIFT_PCT           20
+#define RAW_LAT_DRIFT_HOLD          3
+#define RAW_LAT_STEP_BUCKETS        2
+#define RAW_LAT_ALARM_MIN_SAMPLES   32  // Bundan az örnekli interval alarm/baseline'a girmez
+
+/** Raw TX lane'in OPT_ID -> (vl, seq) eşlemesi (lane thread'ine özel) */
+struct raw_lat_tx_track {
+    uint32_t next_id;                   // Kernel'in sıradaki frame'e vereceği OPT_ID
+    uint32_t drain_mark;                // Son errqueue boşaltmasındaki next_id
+    struct {
+        uint32_t id;
+        uint16_t vl_id;
+        uint64_t seq;
+    } pending[RAW_LAT_TX_PENDING];
+};
+
+/** Örneklenen paket mi (TX ve RX aynı kararı verir) */
+static inline bool raw_lat_sampled(uint64_t seq)
+{
+    return (seq & ((1ULL << RAW_LAT_SAMPLE_SHIFT) - 1)) == 0;
+}
+
+/** Ölçüm saati: CLOCK_REALTIME ns (kernel timestamp'leriyle aynı taban) */
+uint64_t raw_lat_now_ns(void);
+
+/**
+ * VL-ID aralığını bir akış olarak kaydet. Init sırasında çağrılır.
+ * @return Akış indeksi, -1: tablo dolu veya aralık başka akışta
+ */
+int raw_lat_register_flow(const char *label, uint16_t vl_id_start, uint16_t vl_id_count);
+
+/** TX zamanını yayınla (kayıtsız VL-ID'ler yok sayılır) */
+void raw_lat_tx_sample(uint16_t vl_id, uint64_t seq, uint64_t tx_ns);
+
+/** RX zamanıyla eşleştir, bulunursa histograma ekle */
+void raw_lat_rx_sample(uint16_t vl_id, uint64_t seq, uint64_t rx_ns);
+
+// ==========================================
+// SOCKET SETUP
+// ==========================================
+
+/**
+ * HW modunda arayüzde TX/RX donanım timestamp'ini aç (SIOCSHWTSTAMP)
+ * @return true: donanım timestamp'i kullanılabilir
+ */
+bool raw_lat_enable_nic(const char *ifname);
+
+/** PACKET_TX_RING soketine TX timestamp + OPT_ID iste (hw: NIC zamanı) */
+int raw_lat_enable_tx_socket(int fd, bool hw);
+
+/** PACKET_RX_RING soketinde tpacket header'ına yazılacak timestamp'i seç */
+int raw_lat_enable_rx_socket(int fd, bool hw);
+
+// ==========================================
+// RAW TX LANE
+// ==========================================
+
+/** Ring'e verilen her frame için çağrılır (kernel OPT_ID sayacıyla senkron) */
+static inline void raw_lat_tx_frame(struct raw_lat_tx_track *t, uint16_t vl_id, uint64_t seq)
+{
+    uint32_t id = t->next_id++;
+    if (raw_lat_sampled(seq)) {
+        uint32_t idx = id & (RAW_LAT_TX_PENDING - 1);
+        t->pending[idx].id = id;
+        t->pending[idx].vl_id = vl_id;
+        t->pending[idx].seq = seq;
+    }
+}
+
+/** Errqueue'daki TX timestamp'lerini oku, örneklenenleri yayınla (bloklamaz) */
+void raw_lat_tx_drain(int fd, struct raw_lat_tx_track *t);
+
+/** Son boşaltmadan beri yeterince frame verildiyse errqueue'yu boşalt */
+static inline void raw_lat_tx_poll(int fd, struct raw_lat_tx_track *t)
+{
+    if (t->next_id - t->drain_mark >= RAW_LAT_DRAIN_FRAMES) {
+        t->drain_mark = t->next_id;
+        raw_lat_tx_drain(fd, t);
+    }
+}
+
+/** Akış başına gecikme histogramını yazdır (son interval), drift/step alarmları */
+void raw_lat_print_stats(void);
+
+#endif /* RAW_LATENCY_H */
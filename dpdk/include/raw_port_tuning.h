@@ -0,0 +1,66 @@
+#ifndef RAW_PORT_TUNING_H
+#define RAW_PORT_TUNING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// ==========================================
+// BUSY-POLL & IRQ/RPS/XPS AFFINITY FOR RAW SOCKET PORTS
+// ==========================================
+// Raw RX thread'leri pinli ama NIC IRQ'ları ve NAPI başka core'larda
+// çalışıyordu; worker'lar boşta 1ms poll() uykusuna düşüyordu. Bu modül:
+//   - Her RX soketine SO_BUSY_POLL / SO_PREFER_BUSY_POLL / SO_BUSY_POLL_BUDGET
+//   - net.core.busy_poll: poll() uyumadan önce NAPI'yi thread'in kendi
+//     context'inde busy-poll eder (soket ayarı tek başına poll()'a yetmez)
+//   - NIC IRQ'ları (/proc/irq/N/smp_affinity_list) RX core'larına dağıtılır
+//   - RPS (rx-*/rps_cpus) RX core'larına, XPS (tx-*/xps_cpus) TX lane
+//     core'larına hizalanır
+// Tüm sysfs/procfs yazımlarının eski değeri saklanır ve raw_tune_restore()
+// ile (cleanup_raw_socket_ports) ters sırada geri yazılır. Yazma hataları
+// (root değil, sürücü desteklemiyor) sadece uyarıdır.
+//
+// Host ayarlarını değiştirdiği ve sadece temiz kapanışta geri alındığı için
+// ikisi de varsayılan KAPALI; isteğe bağlı açılır:
+//   make EXTRA_CFLAGS='-DRAW_SOCKET_BUSY_POLL_US=50 -DRAW_SOCKET_IRQ_AFFINITY=1'
+
+#ifndef RAW_SOCKET_BUSY_POLL_US
+#define RAW_SOCKET_BUSY_POLL_US       0       // 0: busy-poll kapalı (önerilen: 50)
+#endif
+#ifndef RAW_SOCKET_BUSY_POLL_BUDGET
+#define RAW_SOCKET_BUSY_POLL_BUDGET   64      // NAPI poll başına paket
+#endif
+#ifndef RAW_SOCKET_PREFER_BUSY_POLL
+#define RAW_SOCKET_PREFER_BUSY_POLL   1       // Softirq yerine busy-poll tercih
+#endif
+#ifndef RAW_SOCKET_IRQ_AFFINITY
+#define RAW_SOCKET_IRQ_AFFINITY       0       // 1: IRQ + RPS/XPS hizalama
+#endif
+
+#define RAW_TUNE_MAX_SAVED            256     // Geri yüklenecek dosya sayısı
+
+/**
+ * Apply SO_BUSY_POLL / SO_PREFER_BUSY_POLL / SO_BUSY_POLL_BUDGET to a socket
+ * and print the effective values read back from the kernel.
+ * @return 0 if busy-poll is active on the socket, -1 otherwise (disabled or refused)
+ */
+int raw_tune_busy_poll(int fd, const char *tag);
+
+/**
+ * Raise net.core.busy_poll to RAW_SOCKET_BUSY_POLL_US (never lowers it).
+ * Called once; the old value is restored by raw_tune_restore().
+ */
+void raw_tune_busy_poll_sysctl(void);
+
+/**
+ * Align NIC IRQs and RPS with the RX thread CPUs, XPS with the TX lane CPUs.
+ * IRQ k -> rx_cpus[k % n_rx], every rx-* queue's rps_cpus = all rx_cpus,
+ * tx-* queue q -> tx_cpus[q % n_tx] (skipped when n_tx == 0).
+ * @return Number of IRQs re-pinned
+ */
+int raw_tune_irq_affinity(const char *ifname, const uint16_t *rx_cpus, int n_rx,
+                          const uint16_t *tx_cpus, int n_tx);
+
+/** Write back every saved sysfs/procfs value (reverse order) */
+void raw_tune_restore(void);
+
+#endif /* RAW_PORT_TUNING_H */
@@ -6,6 +6,10 @@
 #include <pthread.h>
 #include <linux/if_packet.h>
 #include "config.h"
+#include "tx_pacing_stats.h"
+#include "af_xdp_port.h"
+#include "pkt_io.h"
+#include "raw_latency.h"
 
 // ==========================================
 // RAW SOCKET PORT - MULTI-TARGET TX/RX
@@ -30,6 +34,51 @@
 #define RAW_SOCKET_RING_FRAME_SIZE  2048         // Max frame size
 #define RAW_SOCKET_RING_FRAME_NR    ((RAW_SOCKET_RING_BLOCK_SIZE / RAW_SOCKET_RING_FRAME_SIZE) * RAW_SOCKET_RING_BLOCK_NR)
 
+// TX ring: PACKET_QDISC_BYPASS (qdisc katmanı atlanır, NIC kuyruğuna direkt)
+// ve ring doluluğuna göre send() kick eşiği: az dolu ring -> küçük batch
+// (düşük gecikme), dolu ring -> büyük batch (syscall başına daha çok frame).
+// Eşiğe ulaşmayan batch worker boşta kalınca veya RAW_TX_KICK_MAX_WAIT_NS
+// dolunca gönderilir
+#ifndef RAW_SOCKET_TX_QDISC_BYPASS
+#define RAW_SOCKET_TX_QDISC_BYPASS  1
+#endif
+#define RAW_TX_KICK_MIN             16           // En küçük batch (frame)
+#define RAW_TX_KICK_MAX             256          // En büyük batch (frame)
+#define RAW_TX_KICK_MAX_WAIT_NS     20000        // Eşik altı batch'in en uzun bekleyişi
+#define RAW_TX_ALLOC_BURST          8            // Due paket başına ayrılan frame (pkt_io_tx_alloc)
+
+// TX lane'leri: her lane kendi thread'i ve kendi PACKET_TX_RING soketiyle
+// bir target grubunu sürer (target t -> lane t % lane sayısı). Yavaş bir
+// ring veya uyuyan bir thread sadece kendi lane'inin target'larını etkiler.
+// Lane sayısı port'un target sayısıyla sınırlanır; 1 lane = eski tek TX
+// thread'i (pinlenmez, varsayılan). Birden fazla lane opt-in'dir (örn.
+// -DPORT_12_TX_LANE_COUNT=4), her lane ayrı core'a pinlenir.
+// AF_XDP'de TX, Q0'ın XSK'sını kullandığı için her zaman tek lane'dir.
+#define RAW_SOCKET_TX_LANE_MAX      4            // Max TX lanes (array sizing)
+#ifndef PORT_12_TX_LANE_COUNT
+#define PORT_12_TX_LANE_COUNT       1            // Port 12: 4 target; 4 = lane başına 1 target
+#endif
+#ifndef PORT_13_TX_LANE_COUNT
+#define PORT_13_TX_LANE_COUNT       1            // Port 13: 2 target, 100M -> tek thread yeterli
+#endif
+
+// ==========================================
+// TPACKET_V3 RX RING
+// ==========================================
+// RX ring'i TPACKET_V3 ile kurulur: kernel paketleri değişken uzunlukta
+// block'lara paketler, block dolunca veya retire timeout dolunca kullanıcıya
+// verir. Worker'lar frame frame değil block block ilerler:
+//   - Küçük IMIX frame'leri 2048 byte slot harcamaz (ring kullanımı artar)
+//   - Wakeup/poll frame başına değil block başına olur
+// Aynı bellek (8MB) korunur: 128KB x 64 block.
+// 0 yapılırsa eski TPACKET_V2 sabit frame yolu kullanılır.
+#ifndef RAW_SOCKET_RX_TPACKET_V3
+#define RAW_SOCKET_RX_TPACKET_V3    1
+#endif
+#define RAW_SOCKET_V3_BLOCK_SIZE    (1 << 17)    // 128KB per block
+#define RAW_SOCKET_V3_BLOCK_NR      64           // 64 blocks = 8MB total
+#define RAW_SOCKET_V3_RETIRE_TMO_MS 1            // Kısmi dolu block en geç 1ms'de teslim
+
 // ==========================================
 // MULTI-QUEUE RX CONFIGURATION
 // ==========================================
@@ -40,17 +89,30 @@
 #define PORT_13_RX_QUEUE_COUNT      2            // Port 13: 2 queues for 100M
 #define RAW_SOCKET_FANOUT_GROUP_ID  0xCAFE       // Unique fanout group ID
 
+// VL-ID'ye göre fanout (PACKET_FANOUT_CBPF): fanout grubuna bağlı küçük
+// bir cBPF programı dst MAC'in son iki byte'ını (VL-ID) döndürür, kernel
+// sonucu kuyruk sayısına göre mod alır. Her VL-ID tek bir kuyruğa düşer;
+// kuyruk kendi VL kümesini atomic olmayan özel tracker'larla izler ve
+// kayıp hesabı kuyruklar arası CAS olmadan kesin olur.
+// Kernel CBPF fanout desteklemezse (veya 0 yapılırsa) PACKET_FANOUT_HASH
+// ve global _Atomic tracker'lar kullanılır. AF_XDP'de dağıtımı NIC RSS
+// yapar, bu mod uygulanmaz.
+#ifndef RAW_SOCKET_FANOUT_VL_STEER
+#define RAW_SOCKET_FANOUT_VL_STEER  1
+#endif
+
 // Packet sizes (no VLAN header)
 #define RAW_PKT_ETH_HDR_SIZE   14
 #define RAW_PKT_IP_HDR_SIZE    20
 #define RAW_PKT_UDP_HDR_SIZE   8
+#define RAW_PKT_HDR_SIZE       (RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE + RAW_PKT_UDP_HDR_SIZE)
 #define RAW_PKT_PAYLOAD_SIZE   1467   // 8 seq + 1459 prbs (max size)
 #define RAW_PKT_TOTAL_SIZE     (RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE + \
                                 RAW_PKT_UDP_HDR_SIZE + RAW_PKT_PAYLOAD_SIZE)
 
-// PRBS data size in payload
+// PRBS data size in payload (azami boyut; IMIX'te de PRBS ofset stride'ı)
 #define RAW_PKT_SEQ_BYTES      8
-#define RAW_PKT_PRBS_BYTES     (RAW_PKT_PAYLOAD_SIZE - RAW_PKT_SEQ_BYTES)
+#define RAW_PKT_PRBS_BYTES     (RAW_PKT_PAYLOAD_SIZE - RAW_PKT_SEQ_BYTES)   // 1459
 
 // ==========================================
 // RAW SOCKET IMIX SUPPORT
@@ -68,9 +130,6 @@
 
 #define RAW_IMIX_AVG_PACKET_SIZE 960  // Yaklaşık ortalama
 
-// PRBS offset hesabı için maksimum boyut (VLAN'lı DPDK ile uyumlu)
-#define RAW_MAX_PRBS_BYTES RAW_PKT_PRBS_BYTES  // 1459
-
 // Raw IMIX pattern (VLAN'sız boyutlar)
 #define RAW_IMIX_PATTERN_INIT { \
     RAW_IMIX_SIZE_1, RAW_IMIX_SIZE_2, RAW_IMIX_SIZE_3, RAW_IMIX_SIZE_4, \
@@ -95,11 +154,24 @@ struct raw_rate_limiter {
     uint64_t delay_ns;           // Inter-packet delay in nanoseconds
     uint64_t next_send_time_ns;  // Next packet send time
     bool smooth_pacing_enabled;  // Use smooth pacing instead of token bucket
+
+    // Pacing telemetry (raw_check_smooth_pacing yazar, TX worker okur)
+    uint64_t last_slot_ns;       // Son onaylanan slot'un planlanan zamanı
+    uint64_t resync_slots;       // >2ms geride kalınca atılan slot'lar (flush edilmemiş)
 };
 
 // ==========================================
 // PER-TARGET STATISTICS
 // ==========================================
+// Kilitsiz, tek yazarlı sayaç bloğu. Her blok tek bir worker thread'e
+// aittir (TX: port'un TX thread'i, RX: legacy RX thread'i veya bir RX
+// kuyruğu); yazar raw_stat_add() ile relaxed load+store yapar (RMW/lock
+// yok), okuyucu raw_stat_read() ile relaxed load yapar. Blok cache-line
+// hizalı: farklı thread'lerin blokları aynı satırı paylaşmaz.
+//
+// Okuyucu (print_raw_socket_stats) bir kaynağın tüm bloklarını toplar.
+// Reset worker sayaçlarına yazmaz; o anki toplamı *_base'e alır ve
+// raporlarda bu taban çıkarılır.
 
 struct raw_target_stats {
     uint64_t tx_packets;
@@ -113,19 +185,49 @@ struct raw_target_stats {
     uint64_t lost_pkts;
     uint64_t out_of_order_pkts;
     uint64_t duplicate_pkts;
-    pthread_spinlock_t lock;
-};
+} __attribute__((aligned(64)));
+
+// Yazar tarafı: sadece bloğun sahibi thread çağırır
+static inline void raw_stat_add(uint64_t *ctr, uint64_t n)
+{
+    __atomic_store_n(ctr, __atomic_load_n(ctr, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+// Okuyucu tarafı: herhangi bir thread
+static inline uint64_t raw_stat_read(const uint64_t *ctr)
+{
+    return __atomic_load_n(ctr, __ATOMIC_RELAXED);
+}
 
 // ==========================================
 // VL-ID SEQUENCE TRACKER
 // ==========================================
+// Kilit yok: tx_sequence'ı sadece target'ın TX thread'i, rx_* alanlarını
+// sadece VL-ID'nin düştüğü RX thread'i yazar. Multi-queue RX'te VL-ID
+// steering (RAW_SOCKET_FANOUT_VL_STEER) bir VL-ID'yi hep aynı kuyruğa
+// gönderir; hash fallback'inde de akış (dst IP = VL-ID) sabit kuyruğa düşer.
 
 struct raw_vl_sequence {
     uint64_t tx_sequence;       // TX sequence counter
     uint64_t rx_expected_seq;   // Expected RX sequence
     bool rx_initialized;        // RX tracker initialized?
-    pthread_spinlock_t tx_lock;
-    pthread_spinlock_t rx_lock;
+};
+
+// Kuyruğa özel VL-ID tracker'ı (VL-ID steering açıkken). Sahibi kuyruğun
+// RX thread'i yazar; okuyucu raw_stat_read() ile okur. rx_count == 0: boş.
+struct raw_vl_track {
+    uint64_t min_seq;           // İlk/en küçük sequence
+    uint64_t max_seq;           // En yüksek sequence
+    uint64_t rx_count;          // Alınan paket sayısı
+};
+
+// ==========================================
+// TX HEADER TEMPLATE (per VL-ID)
+// ==========================================
+
+struct raw_tx_hdr_template {
+    uint8_t hdr[RAW_PKT_HDR_SIZE];           // ETH+IP+UDP, uzunluk/checksum alanları 0
+    uint32_t ip_csum_partial;                // total_length hariç IP header toplamı
 };
 
 // ==========================================
@@ -136,8 +238,12 @@ struct raw_tx_target_state {
     struct raw_tx_target_config config;      // Target configuration
     struct raw_rate_limiter limiter;         // Rate limiter for this target
     struct raw_vl_sequence *vl_sequences;    // VL-ID sequence trackers
+    struct raw_tx_hdr_template *hdr_templates;  // VL-ID başına hazır header
     uint16_t current_vl_offset;              // Round-robin offset
-    struct raw_target_stats stats;           // Per-target statistics
+    struct raw_target_stats stats;           // Per-target statistics (TX thread yazar)
+    struct raw_target_stats stats_base;      // Reset tabanı (sadece okuyucu)
+    struct tx_pacing_stats *pacing;          // Inter-departure telemetry (TX thread)
+    uint64_t prev_tx_bytes;                  // Son istatistik baskısındaki TX byte (okuyucu)
 };
 
 // ==========================================
@@ -147,18 +253,23 @@ struct raw_tx_target_state {
 struct raw_rx_source_state {
     struct raw_rx_source_config config;      // Source configuration
     struct raw_vl_sequence *vl_sequences;    // VL-ID sequence trackers
-    struct raw_target_stats stats;           // Per-source statistics
+    struct raw_target_stats stats;           // Legacy RX thread'inin bloğu
+    struct raw_target_stats stats_base;      // Reset tabanı (sadece okuyucu)
 };
 
 // ==========================================
 // MULTI-QUEUE RX STATE (per queue)
 // ==========================================
 
+struct raw_socket_port;
+
 struct raw_rx_queue {
+    struct raw_socket_port *port;           // Sahip port (thread argümanı kuyruk)
     int socket_fd;                          // Socket file descriptor
     void *ring;                             // PACKET_MMAP ring buffer
     size_t ring_size;                       // Ring buffer size
-    uint32_t ring_offset;                   // Current ring offset
+    struct pkt_io_port io;                  // Burst RX (PACKET_MMAP ring veya XSK)
+    struct xsk_port *xsk;                   // AF_XDP socket (NULL: AF_PACKET)
     pthread_t thread;                       // RX thread
     uint16_t queue_id;                      // Queue index (0-3)
     uint16_t cpu_core;                      // Pinned CPU core
@@ -172,7 +283,16 @@ struct raw_rx_queue {
     uint64_t bad_pkts;
     uint64_t bit_errors;
     uint64_t lost_pkts;
-    uint64_t kernel_drops;                  // Kernel-reported packet drops
+    uint64_t kernel_drops;                  // Kernel-reported drops (PACKET_STATISTICS, cumulative)
+
+    // Bu kuyruğun thread'ine ait sayaç blokları (okuyucu port genelinde toplar)
+    struct raw_target_stats dpdk_ext_stats;
+    struct raw_target_stats source_stats[MAX_RAW_TARGETS];
+
+    // VL-ID steering açıkken kuyruğun özel tracker'ları
+    // (VL-ID = port->vl_track_base + i), NULL: global tracking
+    struct raw_vl_track *vl_track;
+    uint32_t vl_track_gen;                  // Uygulanan son reset nesli
 
     // VL-ID tracking for debugging hash distribution
     uint16_t vl_id_min;                     // Minimum VL-ID seen
@@ -180,29 +300,51 @@ struct raw_rx_queue {
     uint32_t unique_vl_ids;                 // Count of unique VL-IDs
 };
 
+// ==========================================
+// TX LANE (per TX thread)
+// ==========================================
+
+struct raw_tx_lane {
+    struct raw_socket_port *port;           // Sahip port
+    uint16_t lane_id;
+    uint16_t cpu_core;                      // Pinned CPU core (0: pinlenmez)
+    pthread_t thread;
+    bool running;
+
+    // PACKET_TX_RING (lane'e özel soket)
+    int socket_fd;
+    void *ring;
+    size_t ring_size;
+
+    struct xsk_port *xsk;                   // AF_XDP: Q0 soketi (UMEM RX ile paylaşımlı)
+    struct pkt_io_port io;                  // Burst TX (ring veya XSK)
+
+#if RAW_SOCKET_TIMESTAMPING
+    struct raw_lat_tx_track lat;            // OPT_ID -> örneklenen (vl, seq)
+#endif
+};
+
 // ==========================================
 // RAW SOCKET PORT (main structure)
 // ==========================================
 
 struct raw_socket_port {
-    int raw_index;                          // Raw port array index (0 or 1)
+    int raw_index;                          // raw_ports[] index
     uint16_t port_id;                       // Global port ID (12 or 13)
-    int tx_socket;                          // TX socket fd
     int rx_socket;                          // Legacy single RX socket fd (for Port 13)
     int if_index;                           // Interface index
 
     // Configuration
     struct raw_socket_port_config config;
 
-    // Zero-copy ring buffers (TX)
-    void *tx_ring;
-    size_t tx_ring_size;
-    uint32_t tx_ring_offset;
+    // TX lane'leri (lane başına thread + zero-copy TX ring)
+    int tx_lane_count;
+    struct raw_tx_lane tx_lanes[RAW_SOCKET_TX_LANE_MAX];
 
     // Legacy single RX ring (for Port 13)
     void *rx_ring;
     size_t rx_ring_size;
-    uint32_t rx_ring_offset;
+    struct pkt_io_port rx_io;
 
     // Multi-queue RX (for Port 12 with PACKET_FANOUT)
     bool use_multi_queue_rx;                // Enable multi-queue RX
@@ -210,6 +352,18 @@ struct raw_socket_port {
     struct raw_rx_queue rx_queues[RAW_SOCKET_RX_QUEUE_COUNT];
     uint16_t rx_cpu_cores[RAW_SOCKET_RX_QUEUE_COUNT];  // Allocated CPU cores
 
+    // VL-ID steering (PACKET_FANOUT_CBPF) aktifse kuyruk tracker aralığı
+    bool vl_steered;
+    uint16_t vl_track_base;                 // İlk izlenen VL-ID
+    uint16_t vl_track_count;                // İzlenen VL-ID sayısı
+    uint32_t vl_track_gen;                  // Reset nesli (kuyruklar tracker'ını ve VL-ID sayaçlarını sıfırlar)
+
+    // AF_XDP backend (config.backend == RAW_BACKEND_AF_XDP ve kurulum başarılı)
+    bool use_xdp;
+    struct xsk_prog xdp_prog;               // Arayüze bağlı redirect programı
+
+    bool lat_hw;                            // Latency ölçümü NIC timestamp'i kullanıyor
+
     // Multi-target TX state
     uint16_t tx_target_count;
     struct raw_tx_target_state tx_targets[MAX_RAW_TARGETS];
@@ -218,8 +372,15 @@ struct raw_socket_port {
     uint16_t rx_source_count;
     struct raw_rx_source_state rx_sources[MAX_RAW_TARGETS];
 
-    // DPDK External TX packets received (aggregated from all queues)
+    // DPDK External TX packets received: legacy RX thread'inin bloğu
+    // (kuyruklarınki raw_rx_queue.dpdk_ext_stats'ta)
     struct raw_target_stats dpdk_ext_rx_stats;
+    struct raw_target_stats dpdk_ext_rx_base;   // Reset tabanı (sadece okuyucu)
+
+    // Backend throughput (sadece okuyucu): port toplamının son baskıdaki hali
+    // ve ortalamanın başlangıcı (0 = ilk baskıda başlar)
+    struct raw_target_stats backend_prev;
+    uint64_t backend_start_ns;
 
     // PRBS cache
     uint8_t *prbs_cache;
@@ -227,19 +388,22 @@ struct raw_socket_port {
     bool prbs_initialized;
 
     // Thread control
-    pthread_t tx_thread;
     pthread_t rx_thread;                    // Legacy single RX thread (Port 13)
     volatile bool stop_flag;
-    bool tx_running;
     bool rx_running;
 
     // Hardware MAC address
     uint8_t mac_addr[6];
 };
 
-// Global raw socket ports array
-extern struct raw_socket_port raw_ports[MAX_RAW_SOCKET_PORTS];
-extern struct raw_socket_port_config raw_port_configs[MAX_RAW_SOCKET_PORTS];
+// Raw port konfigürasyonu (boyut RAW_SOCKET_PORTS_CONFIG_INIT'ten)
+extern struct raw_socket_port_config raw_port_configs[];
+extern const uint16_t raw_port_config_count;
+
+// Raw port tablosu: init_raw_socket_ports raw_port_config_count port ayırır
+// (her biri arayüzün NUMA node'unda); ayrılana kadar raw_port_count = 0
+extern struct raw_socket_port **raw_ports;
+extern uint16_t raw_port_count;
 
 // ==========================================
 // INITIALIZATION FUNCTIONS
@@ -251,6 +415,18 @@ int setup_raw_tx_ring(struct raw_socket_port *port);
 int setup_raw_rx_ring(struct raw_socket_port *port);
 int init_raw_prbs_cache(struct raw_socket_port *port);
 
+/** Port'un TX lane sayısı: config ayarı, target sayısı ve RAW_SOCKET_TX_LANE_MAX ile sınırlı */
+int raw_port_tx_lane_count(const struct raw_socket_port_config *config);
+
+/** Port'un hedef RX queue sayısı (1..RAW_SOCKET_RX_QUEUE_COUNT) */
+static inline int raw_port_rx_queue_count(const struct raw_socket_port_config *config)
+{
+    int queues = config->rx_queue_count;
+    if (queues > RAW_SOCKET_RX_QUEUE_COUNT)
+        queues = RAW_SOCKET_RX_QUEUE_COUNT;
+    return queues < 1 ? 1 : queues;
+}
+
 // ==========================================
 // MULTI-QUEUE RX FUNCTIONS
 // ==========================================
@@ -275,6 +451,7 @@ void stop_raw_socket_workers(void);
 
 int build_raw_packet(uint8_t *buffer, const uint8_t *src_mac,
                      uint16_t vl_id, uint64_t sequence, const uint8_t *prbs_data);
+void raw_tx_hdr_template_init(struct raw_tx_hdr_template *t, uint16_t vl_id);
 
 // ==========================================
 // RATE LIMITER FUNCTIONS
@@ -291,6 +468,13 @@ bool raw_check_smooth_pacing(struct raw_rate_limiter *limiter);
 // ==========================================
 
 void print_raw_socket_stats(void);
+
+struct stats_raw_snapshot;
+/**
+ * TX hedef sayaçlarını (karşı portun RX kaynağıyla eşlenmiş) stats servisine kopyala
+ * @return Yazılan hedef sayısı (en fazla max)
+ */
+int raw_socket_stats_snapshot(struct stats_raw_snapshot *out, int max);
 void reset_raw_socket_stats(void);
 void cleanup_raw_socket_ports(void);
 uint64_t get_time_ns(void);
@@ -0,0 +1,59 @@
+#ifndef STATS_RECORDER_H
+#define STATS_RECORDER_H
+
+#include <stdint.h>
+#include "stats_service.h"
+#include "stats_recorder_format.h"
+
+// ==========================================
+// STATS RECORDER (mmap, fixed-size binary records)
+// ==========================================
+// Stats servisinin her görüntüsü STATS_RECORDER_PATH dosyasına bir kayıt
+// olarak eklenir (format: stats_recorder_format.h). Kayıt servis thread'inde
+// yazılır; datapath lcore'ları dosyaya ya da kilide hiç dokunmaz.
+//
+//   Port   : HW sayaçları, PRBS sayaçları, ext TX, hızlar/BER (gauge)
+//   Kuyruk : Yapılandırılmış RX/TX kuyrukları için rte_eth_stats q_* sayaçları
+//   VL     : RX VL aralıklarındaki her VL-ID için interval paket sayısı (u32 delta)
+//   Raw    : Raw socket TX hedefleri (karşı RX kaynağıyla eşlenmiş)
+//   Monitor: LATENCY_MONITOR_ENABLED ile VLAN başına son interval p50/p99/max
+//            (gauge), örnek/kayıp/alarm sayaçları, alarm bayrakları (flags:
+//            downsample'da OR'lanır, pencere içinde kalkan bayrak kaybolmaz)
+//            (latency_monitor.h)
+//
+// Dosya STATS_RECORDER_GROW_RECORDS kayıtlık parçalarla büyütülür (seyrek,
+// ftruncate + yeniden mmap); kapanışta kayıt sonuna kırpılır. Okuma, kesme,
+// downsample ve CSV/JSON dışa aktarma: tools/stats_rec_tool (make stats_rec_tool).
+//
+// Boyut: port başına ~21 + kuyruk başına 3-5 kolon x 8 byte; VL kolonları
+// (4 aralık x 128 VL-ID x 4 byte = 2 KB/port) baskındır. Sadece port/kuyruk
+// sayaçları yeterliyse STATS_RECORDER_PER_VL=0.
+
+#ifndef STATS_RECORDER_ENABLED
+#define STATS_RECORDER_ENABLED 1
+#endif
+
+#ifndef STATS_RECORDER_PATH
+#define STATS_RECORDER_PATH         "/tmp/dpdk_app_stats.rec"
+#endif
+
+#ifndef STATS_RECORDER_PER_VL
+#define STATS_RECORDER_PER_VL       1       // 0: VL kolonları yok
+#endif
+
+#define STATS_RECORDER_GROW_RECORDS 3600    // Dosya büyütme adımı (1 sn aralıkla ~1 saat)
+
+/**
+ * Şemayı ilk görüntüden kur (port/kuyruk/raw hedef listesi), dosyayı aç ve başlığı yaz.
+ * Stats servis thread'i başlamadan önce çağrılır.
+ * @return 0 = başarılı, -1 = kayıt yapılmayacak
+ */
+int stats_recorder_open(const struct stats_snapshot *first);
+
+/** Görüntüyü bir kayıt olarak ekle (dosya açık değilse hiçbir şey yapmaz) */
+void stats_recorder_append(const struct stats_snapshot *s);
+
+/** Dosyayı kayıt sonuna kırp, senkronla ve kapat */
+void stats_recorder_close(void);
+
+#endif /* STATS_RECORDER_H */
@@ -0,0 +1,81 @@
+#ifndef STATS_RECORDER_FORMAT_H
+#define STATS_RECORDER_FORMAT_H
+
+#include <stdint.h>
+
+// ==========================================
+// STATS RECORDING FILE FORMAT
+// ==========================================
+// DPDK'siz okunabilsin diye ayrı başlık (tools/stats_rec_tool.c de kullanır).
+//
+//   [0, header_size)            : stats_rec_file_header + nb_columns adet stats_rec_column
+//                                 (sayfa hizalı)
+//   [header_size + i*record_size): i. kayıt, sabit boy. Kolonlar offset'lerinde,
+//                                 önce 8 byte'lık kolonlar sonra 4 byte'lıklar.
+//
+// İlk kolonlar GLOBAL: t_ns (ofset 0, CLOCK_REALTIME), generation, interval_sec,
+// warmup_complete, test_time. Ardından port / kuyruk / raw / VL kolonları.
+//
+// Şema kayıttan önce bir kez yazılır (kolon adı, tip, tür, ofset); kayıtlar
+// sadece sayı içerir. Okuyucu nb_records'a kadar okur: dosya sonunda
+// ön-ayrılmış (henüz yazılmamış) alan olabilir, çökme sonrası da geçerlidir.
+// Tüm alanlar host byte order (x86: little endian).
+
+#define STATS_REC_MAGIC         "DPDKSREC"
+#define STATS_REC_VERSION       1
+#define STATS_REC_NAME_LEN      48
+#define STATS_REC_HEADER_ALIGN  4096
+
+/** Kolon değer tipi */
+enum stats_rec_type {
+    STATS_REC_U64 = 0,
+    STATS_REC_F64 = 1,
+    STATS_REC_U32 = 2,
+};
+
+/** Kolon anlamı (downsample bunu kullanır) */
+enum stats_rec_kind {
+    STATS_REC_COUNTER = 0,      // Kümülatif: pencere sonundaki değer
+    STATS_REC_GAUGE   = 1,      // Anlık: pencere ortalaması
+    STATS_REC_DELTA   = 2,      // Interval farkı: pencere toplamı
+    STATS_REC_FLAGS   = 3,      // Bit maskesi: pencere içindeki değerlerin OR'u
+};
+
+/** Kolonun ait olduğu nesne */
+enum stats_rec_scope {
+    STATS_REC_SCOPE_GLOBAL = 0,
+    STATS_REC_SCOPE_PORT   = 1,
+    STATS_REC_SCOPE_QUEUE  = 2,     // index = kuyruk
+    STATS_REC_SCOPE_VL     = 3,     // index = VL-ID
+    STATS_REC_SCOPE_RAW    = 4,     // port = kaynak raw port, index = hedef port
+};
+
+struct stats_rec_column {
+    char     name[STATS_REC_NAME_LEN];  // "port2.q1.rx_bytes", "port0.vl131.rx_pkts", ...
+    uint8_t  type;                      // enum stats_rec_type
+    uint8_t  kind;                      // enum stats_rec_kind
+    uint8_t  scope;                     // enum stats_rec_scope
+    uint8_t  reserved;
+    uint16_t port;
+    uint16_t index;
+    uint32_t offset;                    // Kayıt içi byte ofseti
+    uint32_t reserved2;
+};
+
+struct stats_rec_file_header {
+    char     magic[8];                  // STATS_REC_MAGIC
+    uint32_t version;
+    uint32_t header_size;               // İlk kaydın dosya ofseti
+    uint32_t record_size;
+    uint32_t nb_columns;
+    uint32_t interval_ms;               // Nominal kayıt aralığı
+    uint32_t reserved;
+    uint64_t start_ns;                  // Dosya açılış zamanı (CLOCK_REALTIME)
+    uint64_t nb_records;                // Tamamlanmış kayıt (kayıt yazıldıktan sonra artar)
+    uint8_t  pad[64 - 48];
+};
+
+_Static_assert(sizeof(struct stats_rec_file_header) == 64, "stats_rec_file_header layout");
+_Static_assert(sizeof(struct stats_rec_column) == 64, "stats_rec_column layout");
+
+#endif /* STATS_RECORDER_FORMAT_H */
@@ -0,0 +1,146 @@
+#ifndef STATS_SERVICE_H
+#define STATS_SERVICE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <rte_ethdev.h>
+#include "config.h"
+#include "port.h"
+
+// ==========================================
+// STATS SERVICE (snapshot + local telemetry endpoint)
+// ==========================================
+// Ayrı bir thread her STATS_SERVICE_INTERVAL_MS'de tutarlı bir anlık görüntü
+// kurar: port başına tek rte_eth_stats_get(), rx_stats_per_port (PRBS),
+// external TX ve raw socket hedef sayaçları. Hızlar iki görüntü arasındaki
+// gerçek süreyle hesaplanır (HW reset sonrası sayaç geriye giderse 0).
+//
+//   Yayın   : Çift tampon. Yazar pasif tamponu doldurur, aktif indeksi
+//             çevirip generation'ı release ile artırır; okuyucu aktif
+//             tamponu kopyalar, kopya boyunca generation hiç değişmediyse
+//             kabul eder (değiştiyse tekrar dener). Yazar hiç beklemez,
+//             okuyucu kilit almaz.
+//   Render  : Konsol tablosu (helper_print_stats), JSON ve Prometheus text
+//             aynı görüntüden üretilir.
+//   Endpoint: STATS_SERVICE_SOCK_PATH Unix stream socket'i. İstemci bir satır
+//             gönderir ("json" veya "prom"/"metrics"), cevap yazılıp bağlantı
+//             kapanır:  echo json | socat - UNIX-CONNECT:/tmp/dpdk_app_stats.sock
+//   rte_telemetry: /dpdk_app/stats (özet), /dpdk_app/port,<id> (port detayı)
+
+#ifndef STATS_SERVICE_ENDPOINT_ENABLED
+#define STATS_SERVICE_ENDPOINT_ENABLED 1    // 0: sadece görüntü + konsol (socket/telemetry yok)
+#endif
+
+#ifndef STATS_SERVICE_SOCK_PATH
+#define STATS_SERVICE_SOCK_PATH     "/tmp/dpdk_app_stats.sock"
+#endif
+
+#define STATS_SERVICE_INTERVAL_MS   1000
+#define STATS_SERVICE_MAX_RAW       32      // Raw socket TX hedefi (tüm raw portlar)
+#define STATS_SERVICE_MAX_QUEUES    RTE_ETHDEV_QUEUE_STAT_CNTRS     // rte_eth_stats q_* dizileri
+#define STATS_SERVICE_RENDER_SIZE   (64 * 1024)
+
+/** DPDK port görüntüsü */
+struct stats_port_snapshot {
+    uint16_t port_id;
+    bool     hw_valid;              // rte_eth_stats_get başarılı
+
+    // HW sayaçları (kümülatif)
+    uint64_t tx_pkts;
+    uint64_t tx_bytes;
+    uint64_t rx_pkts;
+    uint64_t rx_bytes;
+    uint64_t rx_missed;
+    uint64_t rx_errors;
+    uint64_t tx_errors;
+    uint64_t rx_nombuf;
+
+    // Kuyruk başına HW sayaçları (aynı rte_eth_stats_get okumasından)
+    uint64_t q_rx_pkts[STATS_SERVICE_MAX_QUEUES];
+    uint64_t q_rx_bytes[STATS_SERVICE_MAX_QUEUES];
+    uint64_t q_tx_pkts[STATS_SERVICE_MAX_QUEUES];
+    uint64_t q_tx_bytes[STATS_SERVICE_MAX_QUEUES];
+    uint64_t q_rx_errors[STATS_SERVICE_MAX_QUEUES];
+
+    // Son interval hızları
+    double   tx_gbps;
+    double   rx_gbps;
+
+    // PRBS doğrulama (rx_stats_per_port)
+    uint64_t good_pkts;
+    uint64_t bad_pkts;
+    uint64_t lost_pkts;
+    uint64_t bit_errors;
+    uint64_t out_of_order_pkts;
+    uint64_t duplicate_pkts;
+    uint64_t short_pkts;
+    uint64_t external_pkts;
+    double   ber;
+
+    // External TX (port ext TX yapmıyorsa 0)
+    uint64_t ext_tx_pkts;
+    uint64_t ext_tx_bytes;
+};
+
+/** Raw socket TX hedefi görüntüsü (hedefin RX kaynağıyla eşlenmiş) */
+struct stats_raw_snapshot {
+    uint16_t src_port;
+    uint16_t dst_port;
+    uint32_t rate_mbps;
+    uint64_t tx_pkts;
+    uint64_t tx_bytes;
+    double   tx_mbps;
+    uint64_t rx_pkts;
+    uint64_t good_pkts;
+    uint64_t bad_pkts;
+    uint64_t lost_pkts;
+    uint64_t bit_errors;
+};
+
+struct stats_snapshot {
+    uint64_t generation;            // Yayın sırası (1'den başlar, 0 = henüz yok)
+    uint64_t t_ns;                  // Görüntü zamanı (CLOCK_REALTIME)
+    double   interval_sec;          // Önceki görüntüden bu yana geçen süre
+
+    // Test fazı (ana döngü bildirir)
+    bool     warmup_complete;
+    uint32_t loop_count;
+    uint32_t test_time;
+
+    uint16_t nb_ports;
+    struct stats_port_snapshot ports[RTE_MAX_ETHPORTS];
+
+    uint16_t nb_raw;
+    struct stats_raw_snapshot raw[STATS_SERVICE_MAX_RAW];
+};
+
+/**
+ * Servis thread'ini başlat, endpoint'i aç, telemetry komutlarını kaydet.
+ * İlk görüntü dönmeden önce yayınlanır.
+ */
+int stats_service_start(const struct ports_config *ports_config);
+
+/** Thread'i durdur, socket'i kapat ve sil */
+void stats_service_stop(void);
+
+/**
+ * Son görüntünün tutarlı kopyası
+ * @return 0 = başarılı, -1 = henüz görüntü yok / servis kapalı
+ */
+int stats_service_read(struct stats_snapshot *out);
+
+/** Ana döngüden: warm-up / test süresi (sonraki görüntülere yazılır) */
+void stats_service_set_phase(bool warmup_complete, uint32_t loop_count, uint32_t test_time);
+
+/** Hemen yeni bir görüntü kur ve yayınla (reset sonrası tabloyu tazelemek için) */
+void stats_service_refresh(void);
+
+/**
+ * Görüntüyü metin olarak yaz
+ * @return Yazılan byte (sondaki NUL hariç); buf taşarsa kırpılır
+ */
+size_t stats_render_json(const struct stats_snapshot *s, char *buf, size_t len);
+size_t stats_render_prometheus(const struct stats_snapshot *s, char *buf, size_t len);
+
+#endif /* STATS_SERVICE_H */
@@ -0,0 +1,85 @@
+#ifndef TRAFFIC_SHAPE_H
+#define TRAFFIC_SHAPE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// ==========================================
+// TRAFFIC SHAPE ENGINE
+// ==========================================
+// tx_worker pacing döngüsü sabit delay_cycles yerine bu tablodan gap okur.
+// Tablo run-length kodludur: her girdi "repeat adet paket, her biri arasında
+// gap cycle" anlamına gelir. Tablo sonunda başa sarılır.
+//
+// Tüm tablolar normalize edilir: Σ(gap * repeat) / Σ(repeat) == mean_gap,
+// yani shape ne olursa olsun ortalama rate değişmez.
+
+struct tx_shape_entry {
+    uint64_t gap;       // Paket arası süre (TSC cycles)
+    uint32_t repeat;    // Bu gap kaç paket için geçerli
+};
+
+struct tx_shape_table {
+    struct tx_shape_config config;
+    uint64_t mean_gap;      // Hedef ortalama gap (cycles)
+    uint64_t resync_gap;    // No-catch-up eşiği: tablodaki en büyük gap (>= mean)
+    uint64_t total_cycles;  // Σ(gap * repeat)
+    uint64_t total_pkts;    // Σ(repeat)
+    uint32_t count;         // Girdi sayısı
+    struct tx_shape_entry entries[];
+};
+
+// Worker-özel okuma imleci
+struct tx_shape_cursor {
+    const struct tx_shape_table *table;
+    uint32_t idx;
+    uint32_t rep;
+};
+
+/**
+ * Find shape config for a port/queue (TX_SHAPE_CONFIG_INIT, else TX_SHAPE_DEFAULT)
+ */
+const struct tx_shape_config *tx_shape_lookup(uint16_t port_id, uint16_t queue_id);
+
+/**
+ * Build a normalized gap table on the given NUMA socket
+ * @param mean_gap  Mean inter-packet gap in TSC cycles (rate is preserved)
+ * @param seed      PRNG seed (POISSON/ONOFF), per port/queue for reproducibility
+ * @return Table or NULL on allocation failure
+ */
+struct tx_shape_table *tx_shape_build(const struct tx_shape_config *cfg,
+                                      uint64_t mean_gap, uint64_t tsc_hz,
+                                      uint64_t seed, int socket_id);
+
+/** Free a table built by tx_shape_build */
+void tx_shape_free(struct tx_shape_table *table);
+
+/** Shape adı (log için) */
+const char *tx_shape_name(enum tx_shape_type type);
+
+/** Print shape parameters and achieved mean rate */
+void tx_shape_print(const struct tx_shape_table *table, uint64_t tsc_hz);
+
+static inline void tx_shape_cursor_init(struct tx_shape_cursor *c,
+                                        const struct tx_shape_table *table)
+{
+    c->table = table;
+    c->idx = 0;
+    c->rep = 0;
+}
+
+/** Sıradaki paket için gap (cycles) */
+static inline uint64_t tx_shape_next_gap(struct tx_shape_cursor *c)
+{
+    const struct tx_shape_entry *e = &c->table->entries[c->idx];
+
+    if (++c->rep >= e->repeat) {
+        c->rep = 0;
+        if (++c->idx >= c->table->count)
+            c->idx = 0;
+    }
+    return e->gap;
+}
+
+#endif /* TRAFFIC_SHAPE_H */
@@ -0,0 +1,147 @@
+#ifndef TX_PACING_STATS_H
+#define TX_PACING_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// ==========================================
+// TX PACING TELEMETRY (Inter-departure time)
+// ==========================================
+// Her TX worker (DPDK tx_worker, dpdk_ext_tx_worker, raw_tx_worker) kendi
+// bloğuna yazar: gerçek paket arası süre ile planlanan süre (ardışık iki
+// slot zamanı arasındaki fark) arasındaki sapma log2 histogram olarak
+// tutulur. Sabit olmayan traffic shape'lerde de doğru çalışır. Ek olarak:
+//   - late_sends    : Planlanan slot'tan TX_PACING_LATE_NS'den fazla geç gönderim
+//   - skipped_slots : Slot geldi ama paket yok (mempool boş -> continue)
+//   - resync_slots  : Geride kalınca (no catch-up) atılan slot sayısı
+//   - tx_drops      : rte_eth_tx_burst() == 0 (paket free edildi)
+//
+// Tek yazar (worker), tek okuyucu (main loop). Yazar kilit veya atomic RMW
+// kullanmaz; sayaçlar relaxed store ile yayınlanır. Okuyucu kümülatif
+// değerlerden interval farkını kendisi hesaplar, reset gerekmez.
+
+#ifndef TX_PACING_STATS_ENABLED
+#define TX_PACING_STATS_ENABLED 1
+#endif
+
+#define TX_PACING_MAX_BLOCKS     96     // 8 port x 5 queue + ext + raw target'lar
+#define TX_PACING_HIST_BUCKETS   16     // [0]: <64ns, [i]: [64<<(i-1), 64<<i) ns, [15]: >=1ms
+#define TX_PACING_HIST_BASE_SHIFT 6     // 64 ns
+#define TX_PACING_LATE_NS        1000   // 1 us'den geç gönderim "late" sayılır
+#define TX_PACING_LABEL_LEN      24
+
+struct tx_pacing_stats {
+    // Sabit (register sırasında yazılır)
+    char     label[TX_PACING_LABEL_LEN];
+    uint64_t tick_hz;           // Zaman birimi (TSC hz veya 1e9 ns)
+    uint64_t ns_mult;           // ns = (ticks * ns_mult) >> 32
+    uint64_t late_ticks;        // TX_PACING_LATE_NS karşılığı
+
+    // Yazar-özel
+    uint64_t last_depart;       // Son gönderim zamanı (ticks), 0 = henüz yok
+    uint64_t last_slot;         // Son gönderimin planlanan slot zamanı
+
+    // Yayınlanan sayaçlar (kümülatif)
+    uint64_t packets;
+    uint64_t gap_sum_ns;
+    uint64_t sched_sum_ns;
+    uint64_t late_sends;
+    uint64_t skipped_slots;
+    uint64_t resync_slots;
+    uint64_t tx_drops;
+    uint64_t hist[TX_PACING_HIST_BUCKETS];
+
+    volatile int ready;
+} __attribute__((aligned(64)));
+
+// Tek yazar artırımı: RMW yok, sadece relaxed store (x86'da düz mov)
+#define TX_PACING_ADD(field, n) \
+    __atomic_store_n(&(field), (field) + (n), __ATOMIC_RELAXED)
+
+/**
+ * Register a pacing telemetry block for the calling TX worker.
+ * Thread-safe; never returns NULL (table full -> per-worker heap block,
+ * reported after the table).
+ * @param tick_hz  Time unit of all timestamps (rte_get_tsc_hz() or 1e9)
+ */
+struct tx_pacing_stats *tx_pacing_register(const char *label, uint64_t tick_hz);
+
+/** Print per-block pacing histogram and counters for the last interval */
+void tx_pacing_print_stats(void);
+
+#if TX_PACING_STATS_ENABLED
+
+/**
+ * Record a departure.
+ * @param slot_tick    Scheduled send time of this packet
+ * @param depart_tick  Time the packet was handed to the NIC/ring
+ */
+static inline void tx_pacing_record_departure(struct tx_pacing_stats *s,
+                                              uint64_t slot_tick,
+                                              uint64_t depart_tick)
+{
+    if (depart_tick > slot_tick + s->late_ticks)
+        TX_PACING_ADD(s->late_sends, 1);
+
+    uint64_t last = s->last_depart;
+    uint64_t last_slot = s->last_slot;
+    s->last_depart = depart_tick;
+    s->last_slot = slot_tick;
+    if (last == 0 || depart_tick < last || slot_tick < last_slot)
+        return;
+
+    uint64_t gap = depart_tick - last;
+    uint64_t sched = slot_tick - last_slot;
+    uint64_t dev = (gap > sched) ? gap - sched : sched - gap;
+
+    // 1 saniyeden büyük değerler çarpımda taşmasın diye son bucket'a kırp
+    uint64_t gap_ns = (gap < s->tick_hz) ? (gap * s->ns_mult) >> 32 : 1000000000ULL;
+    uint64_t sched_ns = (sched < s->tick_hz) ? (sched * s->ns_mult) >> 32 : 1000000000ULL;
+    uint64_t dev_ns = (dev < s->tick_hz) ? (dev * s->ns_mult) >> 32 : 1000000000ULL;
+
+    unsigned b = 0;
+    if (dev_ns >> TX_PACING_HIST_BASE_SHIFT) {
+        b = 64 - __builtin_clzll(dev_ns) - TX_PACING_HIST_BASE_SHIFT;
+        if (b >= TX_PACING_HIST_BUCKETS)
+            b = TX_PACING_HIST_BUCKETS - 1;
+    }
+
+    TX_PACING_ADD(s->hist[b], 1);
+    TX_PACING_ADD(s->gap_sum_ns, gap_ns);
+    TX_PACING_ADD(s->sched_sum_ns, sched_ns);
+    TX_PACING_ADD(s->packets, 1);
+}
+
+/** Slot geldi ama paket üretilemedi (mempool boş) */
+static inline void tx_pacing_record_skip(struct tx_pacing_stats *s)
+{
+    TX_PACING_ADD(s->skipped_slots, 1);
+}
+
+/** Geride kalındı, catch-up yapılmadan atlanan slot sayısı */
+static inline void tx_pacing_record_resync(struct tx_pacing_stats *s, uint64_t slots)
+{
+    TX_PACING_ADD(s->resync_slots, slots);
+}
+
+/** rte_eth_tx_burst() paketi kabul etmedi */
+static inline void tx_pacing_record_drop(struct tx_pacing_stats *s)
+{
+    TX_PACING_ADD(s->tx_drops, 1);
+}
+
+#else
+
+static inline void tx_pacing_record_departure(struct tx_pacing_stats *s,
+                                              uint64_t slot_tick,
+                                              uint64_t depart_tick)
+{ (void)s; (void)slot_tick; (void)depart_tick; }
+static inline void tx_pacing_record_skip(struct tx_pacing_stats *s) { (void)s; }
+static inline void tx_pacing_record_resync(struct tx_pacing_stats *s, uint64_t slots)
+{ (void)s; (void)slots; }
+static inline void tx_pacing_record_drop(struct tx_pacing_stats *s) { (void)s; }
+
+#endif /* TX_PACING_STATS_ENABLED */
+
+#endif /* TX_PACING_STATS_H */
@@ -28,8 +28,9 @@
 #define MIN_VL_ID 3
 #define VL_RANGE_SIZE_PER_QUEUE 128  // Her queue için 128 VL-ID
 
-// Global VLAN configuration for all ports
-extern struct port_vlan_config port_vlans[MAX_PORTS_CONFIG];
+// Global VLAN configuration for all ports (boyut PORT_VLAN_CONFIG_INIT'ten)
+extern struct port_vlan_config port_vlans[];
+extern const uint16_t port_vlans_count;
 
 /**
  * Token bucket for rate limiting
@@ -60,7 +61,15 @@ struct rx_stats
     rte_atomic64_t raw_socket_rx_bytes; // Raw socket'ten gelen byte sayısı
 };
 
-extern struct rx_stats rx_stats_per_port[MAX_PORTS];
+// ==========================================
+// PER-PORT TABLES (runtime sized)
+// ==========================================
+// Boyut keşfedilen en büyük port_id + 1 (ports_config.port_table_size);
+// her portun girdisi portun worker NUMA node'unda ayrı ayrılır.
+// Keşfedilmeyen port_id'lerin girdisi NULL'dır.
+
+extern uint16_t port_table_size;
+extern struct rx_stats **rx_stats_per_port;
 
 /**
  * VL-ID based sequence tracking (lock-free, watermark-based)
@@ -83,7 +92,7 @@ struct port_vl_tracker {
     // No lock needed - using lock-free atomic operations per VL-ID
 };
 
-extern struct port_vl_tracker port_vl_trackers[MAX_PORTS];
+extern struct port_vl_tracker **port_vl_trackers;
 
 /**
  * TX/RX configuration for a port
@@ -118,7 +127,9 @@ struct tx_worker_params
     uint16_t ext_vlan_id;       // External TX VLAN tag
     uint16_t ext_vl_id_start;   // External TX VL-ID start
     uint16_t ext_vl_id_count;   // External TX VL-ID count
-    struct rate_limiter ext_limiter;  // Separate rate limiter for external TX
+    uint16_t ext_port_idx;      // dpdk_ext_tx config/stats index (sequence + stats)
+    uint16_t ext_target_idx;    // Target index within the ext port
+    struct rate_limiter ext_limiter;  // Separate rate (tokens_per_sec) for external TX
 };
 
 /**
@@ -206,6 +217,17 @@ int start_txrx_workers(struct ports_config *ports_config, volatile bool *stop_fl
  */
 void print_port_stats(struct ports_config *ports_config);
 
+/**
+ * Allocate the per-port tables (RX stats, VL-ID trackers, TX VL-ID sequences)
+ * for the discovered ports, each entry on the port's worker NUMA node.
+ * Must run after lcore/NUMA assignment and before init_rx_stats().
+ * @return 0 on success, -1 on allocation failure
+ */
+int init_port_tables(const struct ports_config *ports_config);
+
+/** Free the per-port tables (after all workers have stopped) */
+void cleanup_port_tables(void);
+
 /**
  * Initialize RX statistics and VL-ID trackers
  */
@@ -223,8 +245,9 @@ struct latency_result {
     uint16_t rx_port;           // Alan port
     uint16_t vlan_id;           // VLAN ID
     uint16_t vl_id;             // VL-ID
-    uint64_t tx_timestamp;      // Son TX zamanı (TSC cycles)
-    uint64_t rx_timestamp;      // Son RX zamanı (TSC cycles)
+    uint64_t tx_timestamp;      // Son gönderim zamanı (TSC cycles; NIC TX veya tx_burst sonrası)
+    uint64_t tx_payload_tsc;    // Payload'a yazılan TX zamanı (tx_burst öncesi TSC)
+    uint64_t rx_timestamp;      // Son RX zamanı (TSC cycles; NIC RX varsa ondan çevrilmiş)
     uint64_t latency_cycles;    // Son gecikme (cycles)
     double   latency_us;        // Ortalama gecikme (mikrosaniye)
     double   min_latency_us;    // Minimum gecikme
@@ -234,6 +257,8 @@ struct latency_result {
     uint32_t rx_count;          // Alınan paket sayısı
     bool     received;          // En az 1 paket alındı mı?
     bool     prbs_ok;           // PRBS doğrulama başarılı mı?
+    bool     tx_hw;             // tx_timestamp NIC saatinden mi
+    bool     rx_hw;             // rx_timestamp NIC saatinden mi
 };
 
 // Port başına latency test durumu
@@ -253,7 +278,8 @@ struct latency_test_state {
     volatile bool test_complete;            // Test tamamlandı mı?
     uint64_t tsc_hz;                        // TSC frekansı (cycles/sec)
     uint64_t test_start_time;               // Test başlangıç zamanı
-    struct port_latency_test ports[MAX_PORTS];
+    uint16_t nb_ports;                      // ports[] boyutu (port_table_size)
+    struct port_latency_test *ports;        // port_id ile indekslenir
 };
 
 extern struct latency_test_state g_latency_test;
@@ -274,6 +300,13 @@ void print_latency_results(void);
  */
 void reset_latency_test(void);
 
+/**
+ * Latency test paketi oluştur (probe mbuf'ları kurulurken bir kez)
+ * Format: [ETH][VLAN][IP][UDP][SEQ 8B][TX_TIMESTAMP 8B][PRBS]
+ */
+int build_latency_test_packet(struct rte_mbuf *mbuf, uint16_t port_id, uint16_t vlan_id,
+                              uint16_t vl_id, uint64_t sequence, uint64_t tx_timestamp);
+
 #endif /* LATENCY_TEST_ENABLED */
 
 #endif /* TX_RX_MANAGER_H */
\ No newline at end of file
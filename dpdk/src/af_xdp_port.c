@@ -0,0 +1,485 @@
+#include "af_xdp_port.h"
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+
+#if ENABLE_AF_XDP
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+
+#ifndef AF_XDP
+#define AF_XDP 44
+#endif
+#ifndef SOL_XDP
+#define SOL_XDP 283
+#endif
+
+// ==========================================
+// BPF SYSCALL HELPERS (libbpf yok)
+// ==========================================
+
+static int sys_bpf(int cmd, union bpf_attr *attr)
+{
+    return (int)syscall(__NR_bpf, cmd, attr, sizeof(*attr));
+}
+
+static int xsk_map_create(uint32_t entries)
+{
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint32_t);
+    attr.max_entries = entries;
+    return sys_bpf(BPF_MAP_CREATE, &attr);
+}
+
+/*
+ * r2 = ctx->rx_queue_index
+ * r1 = xsks_map
+ * r3 = XDP_PASS            (soket yoksa fallback aksiyon, kernel >= 5.3)
+ * return bpf_redirect_map(r1, r2, r3)
+ */
+static int xsk_prog_load(int map_fd)
+{
+    struct bpf_insn insns[] = {
+        { .code = BPF_LDX | BPF_MEM | BPF_W, .dst_reg = BPF_REG_2, .src_reg = BPF_REG_1,
+          .off = offsetof(struct xdp_md, rx_queue_index) },
+        { .code = BPF_LD | BPF_DW | BPF_IMM, .dst_reg = BPF_REG_1, .src_reg = BPF_PSEUDO_MAP_FD,
+          .imm = map_fd },
+        { .code = 0 },
+        { .code = BPF_ALU64 | BPF_MOV | BPF_K, .dst_reg = BPF_REG_3, .imm = XDP_PASS },
+        { .code = BPF_JMP | BPF_CALL, .imm = BPF_FUNC_redirect_map },
+        { .code = BPF_JMP | BPF_EXIT },
+    };
+    static char log_buf[4096];
+    union bpf_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.insns = (uint64_t)(uintptr_t)insns;
+    attr.insn_cnt = sizeof(insns) / sizeof(insns[0]);
+    attr.license = (uint64_t)(uintptr_t)"GPL";
+    attr.log_buf = (uint64_t)(uintptr_t)log_buf;
+    attr.log_size = sizeof(log_buf);
+    attr.log_level = 1;
+
+    int fd = sys_bpf(BPF_PROG_LOAD, &attr);
+    if (fd < 0 && log_buf[0])
+        fprintf(stderr, "[AF_XDP] Verifier log:\n%s\n", log_buf);
+    return fd;
+}
+
+static int xsk_link_create(int prog_fd, int ifindex, uint32_t flags)
+{
+    union bpf_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.link_create.prog_fd = prog_fd;
+    attr.link_create.target_ifindex = ifindex;
+    attr.link_create.attach_type = BPF_XDP;
+    attr.link_create.flags = flags;
+    return sys_bpf(BPF_LINK_CREATE, &attr);
+}
+
+static int xsk_map_set(int map_fd, uint32_t key, int xsk_fd)
+{
+    union bpf_attr attr;
+    uint32_t value = (uint32_t)xsk_fd;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.map_fd = map_fd;
+    attr.key = (uint64_t)(uintptr_t)&key;
+    attr.value = (uint64_t)(uintptr_t)&value;
+    attr.flags = BPF_ANY;
+    return sys_bpf(BPF_MAP_UPDATE_ELEM, &attr);
+}
+
+// ==========================================
+// XDP PROGRAM
+// ==========================================
+
+int xsk_prog_attach(struct xsk_prog *prog, int ifindex, uint32_t queues, bool generic)
+{
+    prog->prog_fd = -1;
+    prog->link_fd = -1;
+    prog->generic = generic;
+
+    prog->map_fd = xsk_map_create(queues > 0 ? queues : 1);
+    if (prog->map_fd < 0) {
+        fprintf(stderr, "[AF_XDP] XSKMAP create failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    prog->prog_fd = xsk_prog_load(prog->map_fd);
+    if (prog->prog_fd < 0) {
+        fprintf(stderr, "[AF_XDP] XDP program load failed: %s\n", strerror(errno));
+        xsk_prog_detach(prog);
+        return -1;
+    }
+
+    if (!generic) {
+        prog->link_fd = xsk_link_create(prog->prog_fd, ifindex, XDP_FLAGS_DRV_MODE);
+        if (prog->link_fd < 0)
+            printf("[AF_XDP] ifindex %d: native XDP not available (%s), using generic\n",
+                   ifindex, strerror(errno));
+    }
+    if (prog->link_fd < 0) {
+        prog->generic = true;
+        prog->link_fd = xsk_link_create(prog->prog_fd, ifindex, XDP_FLAGS_SKB_MODE);
+    }
+    if (prog->link_fd < 0) {
+        fprintf(stderr, "[AF_XDP] ifindex %d: XDP attach failed: %s\n", ifindex, strerror(errno));
+        xsk_prog_detach(prog);
+        return -1;
+    }
+    return 0;
+}
+
+void xsk_prog_detach(struct xsk_prog *prog)
+{
+    if (prog->link_fd >= 0)
+        close(prog->link_fd);
+    if (prog->prog_fd >= 0)
+        close(prog->prog_fd);
+    if (prog->map_fd >= 0)
+        close(prog->map_fd);
+    prog->link_fd = -1;
+    prog->prog_fd = -1;
+    prog->map_fd = -1;
+}
+
+// ==========================================
+// XSK SOCKET + UMEM
+// ==========================================
+
+static int xsk_ring_map(int fd, struct xsk_ring *r, const struct xdp_ring_offset *off,
+                        size_t desc_size, off_t pgoff)
+{
+    r->map_size = off->desc + XSK_RING_SIZE * desc_size;
+    r->map = mmap(NULL, r->map_size, PROT_READ | PROT_WRITE,
+                  MAP_SHARED | MAP_POPULATE, fd, pgoff);
+    if (r->map == MAP_FAILED) {
+        r->map = NULL;
+        return -1;
+    }
+    r->producer = (uint32_t *)((uint8_t *)r->map + off->producer);
+    r->consumer = (uint32_t *)((uint8_t *)r->map + off->consumer);
+    r->flags = (uint32_t *)((uint8_t *)r->map + off->flags);
+    r->desc = (uint8_t *)r->map + off->desc;
+    r->mask = XSK_RING_SIZE - 1;
+    r->cached_prod = __atomic_load_n(r->producer, __ATOMIC_ACQUIRE);
+    r->cached_cons = __atomic_load_n(r->consumer, __ATOMIC_ACQUIRE);
+    return 0;
+}
+
+static void xsk_ring_unmap(struct xsk_ring *r)
+{
+    if (r->map)
+        munmap(r->map, r->map_size);
+    r->map = NULL;
+}
+
+static int xsk_bind(struct xsk_port *x, uint16_t mode_flag)
+{
+    struct sockaddr_xdp sxdp;
+    memset(&sxdp, 0, sizeof(sxdp));
+    sxdp.sxdp_family = AF_XDP;
+    sxdp.sxdp_ifindex = (uint32_t)x->ifindex;
+    sxdp.sxdp_queue_id = x->queue_id;
+    sxdp.sxdp_flags = mode_flag | XDP_USE_NEED_WAKEUP;
+    return bind(x->fd, (struct sockaddr *)&sxdp, sizeof(sxdp));
+}
+
+int xsk_port_open(struct xsk_port *x, struct xsk_prog *prog, int ifindex, uint32_t queue_id)
+{
+    memset(x, 0, sizeof(*x));
+    x->ifindex = ifindex;
+    x->queue_id = queue_id;
+
+    x->fd = socket(AF_XDP, SOCK_RAW, 0);
+    if (x->fd < 0) {
+        fprintf(stderr, "[AF_XDP] ifindex %d Q%u: socket failed: %s\n",
+                ifindex, queue_id, strerror(errno));
+        return -1;
+    }
+
+    // UMEM: sayfa hizalı, önceden dokunulmuş
+    x->umem_size = (size_t)XSK_NUM_FRAMES * XSK_FRAME_SIZE;
+    x->umem = mmap(NULL, x->umem_size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (x->umem == MAP_FAILED) {
+        x->umem = NULL;
+        fprintf(stderr, "[AF_XDP] UMEM alloc failed: %s\n", strerror(errno));
+        goto fail;
+    }
+
+    struct xdp_umem_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.addr = (uint64_t)(uintptr_t)x->umem;
+    reg.len = x->umem_size;
+    reg.chunk_size = XSK_FRAME_SIZE;
+    reg.headroom = 0;
+    if (setsockopt(x->fd, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) < 0) {
+        fprintf(stderr, "[AF_XDP] XDP_UMEM_REG failed: %s\n", strerror(errno));
+        goto fail;
+    }
+
+    int ring_size = XSK_RING_SIZE;
+    if (setsockopt(x->fd, SOL_XDP, XDP_UMEM_FILL_RING, &ring_size, sizeof(ring_size)) < 0 ||
+        setsockopt(x->fd, SOL_XDP, XDP_UMEM_COMPLETION_RING, &ring_size, sizeof(ring_size)) < 0 ||
+        setsockopt(x->fd, SOL_XDP, XDP_RX_RING, &ring_size, sizeof(ring_size)) < 0 ||
+        setsockopt(x->fd, SOL_XDP, XDP_TX_RING, &ring_size, sizeof(ring_size)) < 0) {
+        fprintf(stderr, "[AF_XDP] ring size setup failed: %s\n", strerror(errno));
+        goto fail;
+    }
+
+    struct xdp_mmap_offsets off;
+    socklen_t optlen = sizeof(off);
+    if (getsockopt(x->fd, SOL_XDP, XDP_MMAP_OFFSETS, &off, &optlen) < 0) {
+        fprintf(stderr, "[AF_XDP] XDP_MMAP_OFFSETS failed: %s\n", strerror(errno));
+        goto fail;
+    }
+
+    if (xsk_ring_map(x->fd, &x->fill, &off.fr, sizeof(uint64_t), XDP_UMEM_PGOFF_FILL_RING) < 0 ||
+        xsk_ring_map(x->fd, &x->comp, &off.cr, sizeof(uint64_t), XDP_UMEM_PGOFF_COMPLETION_RING) < 0 ||
+        xsk_ring_map(x->fd, &x->rx, &off.rx, sizeof(struct xdp_desc), XDP_PGOFF_RX_RING) < 0 ||
+        xsk_ring_map(x->fd, &x->tx, &off.tx, sizeof(struct xdp_desc), XDP_PGOFF_TX_RING) < 0) {
+        fprintf(stderr, "[AF_XDP] ring mmap failed: %s\n", strerror(errno));
+        goto fail;
+    }
+
+    // Fill ring: RX yarısının tamamı kernel'e
+    uint64_t *fill_addr = (uint64_t *)x->fill.desc;
+    for (uint32_t i = 0; i < XSK_RX_FRAMES; i++)
+        fill_addr[(x->fill.cached_prod + i) & x->fill.mask] = (uint64_t)i * XSK_FRAME_SIZE;
+    x->fill.cached_prod += XSK_RX_FRAMES;
+    __atomic_store_n(x->fill.producer, x->fill.cached_prod, __ATOMIC_RELEASE);
+
+    // TX frame havuzu
+    for (uint32_t i = 0; i < XSK_TX_FRAMES; i++)
+        x->tx_free[i] = (uint64_t)(XSK_RX_FRAMES + i) * XSK_FRAME_SIZE;
+    x->tx_free_count = XSK_TX_FRAMES;
+
+    // Önce zero-copy (sadece native modda anlamlı), olmazsa copy
+    int ret = -1;
+    if (!prog->generic) {
+        ret = xsk_bind(x, XDP_ZEROCOPY);
+        x->zero_copy = (ret == 0);
+    }
+    if (ret < 0)
+        ret = xsk_bind(x, XDP_COPY);
+    if (ret < 0) {
+        fprintf(stderr, "[AF_XDP] ifindex %d Q%u: bind failed: %s\n",
+                ifindex, queue_id, strerror(errno));
+        goto fail;
+    }
+    x->need_wakeup = true;
+
+    if (xsk_map_set(prog->map_fd, queue_id, x->fd) < 0) {
+        fprintf(stderr, "[AF_XDP] ifindex %d Q%u: XSKMAP update failed: %s\n",
+                ifindex, queue_id, strerror(errno));
+        goto fail;
+    }
+    return 0;
+
+fail:
+    xsk_port_close(x);
+    return -1;
+}
+
+void xsk_port_close(struct xsk_port *x)
+{
+    xsk_ring_unmap(&x->fill);
+    xsk_ring_unmap(&x->comp);
+    xsk_ring_unmap(&x->rx);
+    xsk_ring_unmap(&x->tx);
+    if (x->fd >= 0)
+        close(x->fd);
+    if (x->umem)
+        munmap(x->umem, x->umem_size);
+    x->fd = -1;
+    x->umem = NULL;
+}
+
+uint64_t xsk_port_kernel_drops(const struct xsk_port *x)
+{
+    struct xdp_statistics st;
+    socklen_t optlen = sizeof(st);
+
+    memset(&st, 0, sizeof(st));
+    if (getsockopt(x->fd, SOL_XDP, XDP_STATISTICS, &st, &optlen) < 0)
+        return 0;
+    return st.rx_dropped + st.rx_ring_full;
+}
+
+// ==========================================
+// DATA PATH
+// ==========================================
+
+static void xsk_tx_reap(struct xsk_port *x)
+{
+    uint32_t prod = __atomic_load_n(x->comp.producer, __ATOMIC_ACQUIRE);
+    const uint64_t *addr = (const uint64_t *)x->comp.desc;
+
+    while (x->comp.cached_cons != prod) {
+        x->tx_free[x->tx_free_count++] = addr[x->comp.cached_cons & x->comp.mask];
+        x->comp.cached_cons++;
+    }
+    __atomic_store_n(x->comp.consumer, x->comp.cached_cons, __ATOMIC_RELEASE);
+}
+
+uint8_t *xsk_tx_reserve(struct xsk_port *x, uint64_t *addr)
+{
+    if (x->tx_free_count == 0) {
+        xsk_tx_reap(x);
+        if (x->tx_free_count == 0)
+            return NULL;
+    }
+    *addr = x->tx_free[--x->tx_free_count];
+    return x->umem + *addr;
+}
+
+void xsk_tx_submit(struct xsk_port *x, uint64_t addr, uint32_t len)
+{
+    // TX frame sayısı == ring boyutu, ayrılmış frame'in her zaman slot'u var
+    struct xdp_desc *d = &((struct xdp_desc *)x->tx.desc)[x->tx.cached_prod & x->tx.mask];
+    d->addr = addr;
+    d->len = len;
+    d->options = 0;
+    x->tx.cached_prod++;
+}
+
+int xsk_tx_kick(struct xsk_port *x)
+{
+    __atomic_store_n(x->tx.producer, x->tx.cached_prod, __ATOMIC_RELEASE);
+
+    if (!x->need_wakeup || (__atomic_load_n(x->tx.flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP)) {
+        if (sendto(x->fd, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0 &&
+            errno != EAGAIN && errno != EBUSY && errno != ENOBUFS && errno != ENETDOWN)
+            return -1;
+    }
+    xsk_tx_reap(x);
+    return 0;
+}
+
+uint32_t xsk_rx_burst(struct xsk_port *x, uint8_t **data, uint32_t *len, uint32_t max)
+{
+    uint32_t avail = x->rx.cached_prod - x->rx.cached_cons;
+    if (avail < max) {
+        x->rx.cached_prod = __atomic_load_n(x->rx.producer, __ATOMIC_ACQUIRE);
+        avail = x->rx.cached_prod - x->rx.cached_cons;
+        if (avail == 0) {
+            // Fill ring'i kernel'in görmesi için uyandır (need_wakeup)
+            if (__atomic_load_n(x->fill.flags, __ATOMIC_ACQUIRE) & XDP_RING_NEED_WAKEUP)
+                recvfrom(x->fd, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+            return 0;
+        }
+    }
+    if (avail > max)
+        avail = max;
+
+    const struct xdp_desc *descs = (const struct xdp_desc *)x->rx.desc;
+    for (uint32_t i = 0; i < avail; i++) {
+        const struct xdp_desc *d = &descs[(x->rx.cached_cons + i) & x->rx.mask];
+        data[i] = x->umem + d->addr;
+        len[i] = d->len;
+    }
+    return avail;
+}
+
+void xsk_rx_release(struct xsk_port *x, uint32_t n)
+{
+    // Descriptor'lar consumer ilerleyene kadar geçerli; adresler oradan okunur.
+    // Aligned modda desc adresi headroom ofseti içerebilir, frame başı verilir
+    const struct xdp_desc *descs = (const struct xdp_desc *)x->rx.desc;
+    uint64_t *fill_addr = (uint64_t *)x->fill.desc;
+    for (uint32_t i = 0; i < n; i++) {
+        uint64_t addr = descs[(x->rx.cached_cons + i) & x->rx.mask].addr;
+        fill_addr[x->fill.cached_prod & x->fill.mask] = addr & ~((uint64_t)XSK_FRAME_SIZE - 1);
+        x->fill.cached_prod++;
+    }
+    x->rx.cached_cons += n;
+
+    __atomic_store_n(x->rx.consumer, x->rx.cached_cons, __ATOMIC_RELEASE);
+    __atomic_store_n(x->fill.producer, x->fill.cached_prod, __ATOMIC_RELEASE);
+}
+
+#else /* !ENABLE_AF_XDP */
+
+int xsk_prog_attach(struct xsk_prog *prog, int ifindex, uint32_t queues, bool generic)
+{
+    (void)ifindex;
+    (void)queues;
+    prog->prog_fd = prog->map_fd = prog->link_fd = -1;
+    prog->generic = generic;
+    fprintf(stderr, "[AF_XDP] Not compiled in (build with ENABLE_AF_XDP=1)\n");
+    return -1;
+}
+
+void xsk_prog_detach(struct xsk_prog *prog)
+{
+    (void)prog;
+}
+
+int xsk_port_open(struct xsk_port *x, struct xsk_prog *prog, int ifindex, uint32_t queue_id)
+{
+    (void)prog;
+    (void)ifindex;
+    (void)queue_id;
+    x->fd = -1;
+    return -1;
+}
+
+void xsk_port_close(struct xsk_port *x)
+{
+    (void)x;
+}
+
+uint64_t xsk_port_kernel_drops(const struct xsk_port *x)
+{
+    (void)x;
+    return 0;
+}
+
+uint8_t *xsk_tx_reserve(struct xsk_port *x, uint64_t *addr)
+{
+    (void)x;
+    (void)addr;
+    return NULL;
+}
+
+void xsk_tx_submit(struct xsk_port *x, uint64_t addr, uint32_t len)
+{
+    (void)x;
+    (void)addr;
+    (void)len;
+}
+
+int xsk_tx_kick(struct xsk_port *x)
+{
+    (void)x;
+    return -1;
+}
+
+uint32_t xsk_rx_burst(struct xsk_port *x, uint8_t **data, uint32_t *len, uint32_t max)
+{
+    (void)x;
+    (void)data;
+    (void)len;
+    (void)max;
+    return 0;
+}
+
+void xsk_rx_release(struct xsk_port *x, uint32_t n)
+{
+    (void)x;
+    (void)n;
+}
+
+#endif /* ENABLE_AF_XDP */
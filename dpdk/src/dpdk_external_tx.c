@@ -19,6 +19,9 @@
 #include "dpdk_external_tx.h"
 #include "packet.h"
 #include "tx_rx_manager.h"
+#include "tx_pacing_stats.h"
+#include "pkt_io.h"
+#include "raw_latency.h"
 
 #if DPDK_EXT_TX_ENABLED
 
@@ -41,6 +44,10 @@ static struct dpdk_ext_tx_worker_params ext_worker_params[DPDK_EXT_TX_PORT_COUNT
 // Configuration
 static struct dpdk_ext_tx_port_config ext_tx_configs[] = DPDK_EXT_TX_PORTS_CONFIG_INIT;
 
+// Inline mod: tx_worker'lar ext sınıfını bu bayrak set edilene kadar göndermez
+// (raw socket RX hazır olmadan paket kaybını önler)
+static volatile int ext_inline_armed = 0;
+
 // ==========================================
 // RATE LIMITER (Token Bucket)
 // ==========================================
@@ -105,6 +112,154 @@ static inline uint64_t get_ext_tx_sequence(uint16_t port_idx, uint16_t vl_id)
     return ext_tx_sequences[port_idx][vl_id]++;
 }
 
+uint16_t dpdk_ext_tx_build_frame(uint8_t *pkt, uint16_t port_id, uint16_t vlan_id,
+                                 uint16_t vl_id, uint64_t seq, uint16_t pkt_size,
+                                 const uint8_t *prbs_cache)
+{
+    const uint16_t l2_len = sizeof(struct rte_ether_hdr) + 4; // +4 for VLAN tag
+
+    // ==========================================
+    // BUILD ETHERNET HEADER
+    // ==========================================
+    struct rte_ether_hdr *eth = (struct rte_ether_hdr *)pkt;
+
+    // Source MAC: 02:00:00:00:00:PP (PP = port)
+    eth->src_addr.addr_bytes[0] = 0x02;
+    eth->src_addr.addr_bytes[1] = 0x00;
+    eth->src_addr.addr_bytes[2] = 0x00;
+    eth->src_addr.addr_bytes[3] = 0x00;
+    eth->src_addr.addr_bytes[4] = 0x00;
+    eth->src_addr.addr_bytes[5] = (uint8_t)port_id;
+
+    // Destination MAC: 03:00:00:00:VV:VV (VV = VL-ID)
+    eth->dst_addr.addr_bytes[0] = 0x03;
+    eth->dst_addr.addr_bytes[1] = 0x00;
+    eth->dst_addr.addr_bytes[2] = 0x00;
+    eth->dst_addr.addr_bytes[3] = 0x00;
+    eth->dst_addr.addr_bytes[4] = (uint8_t)(vl_id >> 8);
+    eth->dst_addr.addr_bytes[5] = (uint8_t)(vl_id & 0xFF);
+
+    // VLAN tag (802.1Q) - use target's VLAN ID
+    eth->ether_type = rte_cpu_to_be_16(0x8100);
+    uint8_t *vlan_tag = pkt + sizeof(struct rte_ether_hdr);
+    *(uint16_t *)vlan_tag = rte_cpu_to_be_16(vlan_id);
+    *(uint16_t *)(vlan_tag + 2) = rte_cpu_to_be_16(0x0800); // IPv4
+
+#if IMIX_ENABLED
+    // IMIX: Paket boyutu çağıran tarafından seçilir
+    uint16_t prbs_len = calc_prbs_size(pkt_size);
+    uint16_t payload_size = pkt_size - l2_len - sizeof(struct rte_ipv4_hdr) - sizeof(struct rte_udp_hdr);
+#else
+    const uint16_t prbs_len = NUM_PRBS_BYTES;
+    const uint16_t payload_size = PAYLOAD_SIZE_VLAN;
+#endif
+
+    // ==========================================
+    // BUILD IP HEADER (dinamik total_length)
+    // ==========================================
+    struct rte_ipv4_hdr *ip = (struct rte_ipv4_hdr *)(pkt + l2_len);
+    ip->version_ihl = 0x45;
+    ip->type_of_service = 0;
+    ip->total_length = rte_cpu_to_be_16(pkt_size - l2_len);
+    ip->packet_id = 0;
+    ip->fragment_offset = 0;
+    ip->time_to_live = 1;
+    ip->next_proto_id = IPPROTO_UDP;
+    ip->src_addr = rte_cpu_to_be_32(0x0A000000); // 10.0.0.0
+    // Destination IP: 224.224.VV.VV
+    ip->dst_addr = rte_cpu_to_be_32((224U << 24) | (224U << 16) |
+                                    ((vl_id >> 8) << 8) | (vl_id & 0xFF));
+    ip->hdr_checksum = 0;
+    ip->hdr_checksum = rte_ipv4_cksum(ip);
+
+    // ==========================================
+    // BUILD UDP HEADER (dinamik dgram_len)
+    // ==========================================
+    struct rte_udp_hdr *udp = (struct rte_udp_hdr *)(pkt + l2_len + sizeof(struct rte_ipv4_hdr));
+    udp->src_port = rte_cpu_to_be_16(100);
+    udp->dst_port = rte_cpu_to_be_16(100);
+    udp->dgram_len = rte_cpu_to_be_16(sizeof(struct rte_udp_hdr) + payload_size);
+    udp->dgram_cksum = 0;
+
+    // ==========================================
+    // BUILD PAYLOAD (Sequence + PRBS)
+    // ==========================================
+    uint8_t *payload = pkt + l2_len + sizeof(struct rte_ipv4_hdr) + sizeof(struct rte_udp_hdr);
+
+    // Sequence + PRBS (IMIX: offset hep MAX ile hesaplanır, boyut dinamik)
+    pkt_payload_fill(payload, seq, prbs_cache, MAX_PRBS_BYTES, prbs_len);
+
+    return pkt_size;
+}
+
+// ==========================================
+// INLINE MODE (ext sınıfı ana tx_worker içinde)
+// ==========================================
+
+bool dpdk_ext_tx_port_inline(uint16_t port_id)
+{
+#if DPDK_EXT_TX_INLINE
+    for (int i = 0; i < DPDK_EXT_TX_PORT_COUNT; i++) {
+        if (ext_tx_configs[i].port_id != port_id)
+            continue;
+        // Her hedef kendi queue_id'sinde taşınır; queue yoksa dedicated moda düş
+        for (int t = 0; t < ext_tx_configs[i].target_count; t++) {
+            if (ext_tx_configs[i].targets[t].queue_id >= NUM_TX_CORES)
+                return false;
+        }
+        return true;
+    }
+#else
+    (void)port_id;
+#endif
+    return false;
+}
+
+const struct dpdk_ext_tx_target *dpdk_ext_tx_inline_target(uint16_t port_id, uint16_t queue_id,
+                                                           uint16_t *port_idx, uint16_t *target_idx)
+{
+    if (!dpdk_ext_tx_port_inline(port_id))
+        return NULL;
+
+    for (uint16_t i = 0; i < DPDK_EXT_TX_PORT_COUNT; i++) {
+        if (ext_tx_configs[i].port_id != port_id)
+            continue;
+        if (!dpdk_ext_tx_ports[i].initialized)
+            return NULL;
+        for (uint16_t t = 0; t < ext_tx_configs[i].target_count; t++) {
+            if (ext_tx_configs[i].targets[t].queue_id == queue_id) {
+                *port_idx = i;
+                *target_idx = t;
+                return &ext_tx_configs[i].targets[t];
+            }
+        }
+        return NULL;
+    }
+    return NULL;
+}
+
+bool dpdk_ext_tx_inline_armed(void)
+{
+    return __atomic_load_n(&ext_inline_armed, __ATOMIC_ACQUIRE) != 0;
+}
+
+uint64_t dpdk_ext_tx_next_sequence(uint16_t port_idx, uint16_t vl_id)
+{
+    return get_ext_tx_sequence(port_idx, vl_id);
+}
+
+void dpdk_ext_tx_account(uint16_t port_idx, uint16_t target_idx, uint64_t pkts, uint64_t bytes)
+{
+    if (port_idx >= DPDK_EXT_TX_PORT_COUNT || target_idx >= DPDK_EXT_TX_QUEUES_PER_PORT)
+        return;
+
+    struct dpdk_ext_tx_stats *st = &dpdk_ext_tx_stats_per_port[port_idx];
+    rte_atomic64_add(&st->tx_pkts, pkts);
+    rte_atomic64_add(&st->tx_bytes, bytes);
+    rte_atomic64_add(&st->targets[target_idx].tx_pkts, pkts);
+    rte_atomic64_add(&st->targets[target_idx].tx_bytes, bytes);
+}
+
 int dpdk_ext_tx_get_source_port(uint16_t vl_id)
 {
     // VL-ID ranges must match config.h DPDK_EXT_TX_PORT_*_TARGETS
@@ -145,6 +300,10 @@ int dpdk_ext_tx_init(struct rte_mempool *mbuf_pools[])
     for (int i = 0; i < DPDK_EXT_TX_PORT_COUNT; i++) {
         rte_atomic64_init(&dpdk_ext_tx_stats_per_port[i].tx_pkts);
         rte_atomic64_init(&dpdk_ext_tx_stats_per_port[i].tx_bytes);
+        for (int t = 0; t < DPDK_EXT_TX_QUEUES_PER_PORT; t++) {
+            rte_atomic64_init(&dpdk_ext_tx_stats_per_port[i].targets[t].tx_pkts);
+            rte_atomic64_init(&dpdk_ext_tx_stats_per_port[i].targets[t].tx_bytes);
+        }
     }
 
     // Initialize sequence counters
@@ -171,10 +330,17 @@ int dpdk_ext_tx_init(struct rte_mempool *mbuf_pools[])
 
         for (int t = 0; t < port->config.target_count; t++) {
             struct dpdk_ext_tx_target *target = &port->config.targets[t];
-            printf("    Target %d: VLAN %u, VL-ID %u-%u, Rate %u Mbps\n",
+            printf("    Target %d: VLAN %u, VL-ID %u-%u, Rate %.2f Mbps\n",
                    t, target->vlan_id, target->vl_id_start,
                    target->vl_id_start + target->vl_id_count - 1,
-                   target->rate_mbps);
+                   target->rate_kbps / 1000.0);
+
+#if RAW_SOCKET_TIMESTAMPING
+            char lat_label[RAW_LAT_LABEL_LEN];
+            snprintf(lat_label, sizeof(lat_label), "P%u->P%u T%d",
+                     port->port_id, port->config.dest_port, t);
+            raw_lat_register_flow(lat_label, target->vl_id_start, target->vl_id_count);
+#endif
         }
     }
 
@@ -182,6 +348,65 @@ int dpdk_ext_tx_init(struct rte_mempool *mbuf_pools[])
     return 0;
 }
 
+// ==========================================
+// DEFICIT ROUND-ROBIN (hedef bazlı planlama)
+// ==========================================
+// Her hedef rate_kbps ile orantılı bir quantum (byte) alır; en yavaş hedefin
+// quantum'u IMIX_MAX_PACKET_SIZE'dır, böylece her round'da her hedef en az
+// bir paket gönderir. Sıradaki paket deficit'e sığmıyorsa bir sonraki hedefe
+// geçilir ve onun deficit'ine quantum eklenir. Paket boyutları (IMIX) farklı
+// olsa bile hedefler arası byte oranı rate oranına eşit kalır. Hedefler her
+// zaman dolu (backlogged) olduğundan deficit sıfırlanmaz.
+
+struct ext_drr_target {
+    uint64_t quantum;       // Round başına byte hakkı (0 = hedef devre dışı)
+    uint64_t deficit;       // Kullanılmamış byte hakkı
+    uint16_t next_size;     // Bu hedefin sıradaki paket boyutu
+    uint16_t vl_offset;     // Hedef içi VL-ID round-robin
+#if IMIX_ENABLED
+    uint8_t  imix_offset;
+    uint64_t imix_counter;
+#endif
+    uint64_t local_pkts;    // Henüz flush edilmemiş sayaçlar
+    uint64_t local_bytes;
+};
+
+static inline uint16_t ext_drr_peek_size(const struct ext_drr_target *t)
+{
+#if IMIX_ENABLED
+    return get_imix_packet_size(t->imix_counter, t->imix_offset);
+#else
+    (void)t;
+    return PACKET_SIZE_VLAN;
+#endif
+}
+
+/**
+ * Pick the target for the next packet. Caller guarantees at least one
+ * target has a non-zero quantum.
+ */
+static inline uint16_t ext_drr_select(struct ext_drr_target *drr, uint16_t count, uint16_t cur)
+{
+    while (drr[cur].deficit < drr[cur].next_size) {
+        cur = (cur + 1) % count;
+        drr[cur].deficit += drr[cur].quantum;
+    }
+    return cur;
+}
+
+static void ext_drr_flush(struct dpdk_ext_tx_stats *stats, struct ext_drr_target *drr,
+                          uint16_t count)
+{
+    for (uint16_t t = 0; t < count; t++) {
+        if (drr[t].local_pkts == 0)
+            continue;
+        rte_atomic64_add(&stats->targets[t].tx_pkts, drr[t].local_pkts);
+        rte_atomic64_add(&stats->targets[t].tx_bytes, drr[t].local_bytes);
+        drr[t].local_pkts = 0;
+        drr[t].local_bytes = 0;
+    }
+}
+
 // ==========================================
 // TX WORKER
 // ==========================================
@@ -189,18 +414,9 @@ int dpdk_ext_tx_init(struct rte_mempool *mbuf_pools[])
 int dpdk_ext_tx_worker(void *arg)
 {
     struct dpdk_ext_tx_worker_params *params = (struct dpdk_ext_tx_worker_params *)arg;
-    struct rte_mbuf *pkts[1];  // Single packet mode for smooth pacing
+    struct pkt_io_buf buf[1];  // Single packet mode for smooth pacing
     bool first_burst = false;
 
-    // VLAN header length
-    const uint16_t l2_len = sizeof(struct rte_ether_hdr) + 4; // +4 for VLAN tag
-
-#if IMIX_ENABLED
-    // IMIX: Worker-specific offset for pattern rotation
-    const uint8_t imix_offset = (uint8_t)((params->port_id * 4 + params->queue_id) % IMIX_PATTERN_SIZE);
-    uint64_t imix_counter = 0;
-#endif
-
     // Find port index and config for multi-target handling
     int port_idx = -1;
     struct dpdk_ext_tx_port_config *port_config = NULL;
@@ -242,39 +458,77 @@ int dpdk_ext_tx_worker(void *arg)
         return -1;
     }
 
-    // Multi-target state: round-robin through all targets
+    struct pkt_io_port io;
+    pkt_io_init_dpdk(&io, params->port_id, params->queue_id, params->mbuf_pool);
+
+    // Multi-target state: deficit round-robin, hedef rate'leri oranında
     uint16_t target_count = port_config->target_count;
     uint16_t current_target = 0;
-    uint16_t *vl_offsets = calloc(target_count, sizeof(uint16_t));  // Per-target VL offset
-    if (!vl_offsets) {
-        printf("Error: Failed to allocate VL offset array\n");
+    struct ext_drr_target *drr = calloc(target_count, sizeof(*drr));
+    if (!drr) {
+        printf("Error: Failed to allocate DRR state\n");
+        return -1;
+    }
+
+    uint32_t min_rate_kbps = UINT32_MAX;
+    for (uint16_t t = 0; t < target_count; t++) {
+        uint32_t r = port_config->targets[t].rate_kbps;
+        if (r > 0 && r < min_rate_kbps)
+            min_rate_kbps = r;
+    }
+    if (min_rate_kbps == UINT32_MAX) {
+        printf("Error: Port %u has no target with non-zero rate\n", params->port_id);
+        free(drr);
         return -1;
     }
 
+    for (uint16_t t = 0; t < target_count; t++) {
+        struct ext_drr_target *d = &drr[t];
+        d->quantum = (uint64_t)IMIX_MAX_PACKET_SIZE * port_config->targets[t].rate_kbps / min_rate_kbps;
+#if IMIX_ENABLED
+        // IMIX: Hedef başına farklı offset (pattern rotation)
+        d->imix_offset = (uint8_t)((params->port_id * 4 + t) % IMIX_PATTERN_SIZE);
+#endif
+        d->next_size = ext_drr_peek_size(d);
+    }
+    // İlk round: ilk aktif hedef quantum'unu alarak başlar
+    while (drr[current_target].quantum == 0)
+        current_target++;
+    drr[current_target].deficit = drr[current_target].quantum;
+
 #if IMIX_ENABLED
     const uint64_t avg_pkt_size = IMIX_AVG_PACKET_SIZE;
+    const uint64_t max_pkt_size = IMIX_MAX_PACKET_SIZE;
 #else
     const uint64_t avg_pkt_size = PACKET_SIZE_VLAN;
+    const uint64_t max_pkt_size = PACKET_SIZE_VLAN;
 #endif
 
     // ==========================================
-    // PURE TIMESTAMP-BASED PACING (1 saniyeye yayılmış smooth trafik)
+    // BYTE-ACCURATE PACING (1 saniyeye yayılmış smooth trafik)
     // ==========================================
     //
-    // Hedef: 200 Mbit/s = 25 MB/s = ~16,480 paket/s
-    // Her paket arası = 1,000,000 µs / 16,480 ≈ 60.7 µs
-    //
-    // Bu sayede trafik 1 saniyeye eşit olarak yayılır, burst OLMAZ.
+    // Bir sonraki slot, GÖNDERİLEN paketin boyutuyla ilerler:
+    //   gap = pkt_size * cycles_per_byte
+    // Böylece kısa IMIX paketleri arasında kısa, uzun olanlar arasında uzun
+    // boşluk kalır ve port rate'i paket karışımından bağımsız olarak tutar.
+    // cycles_per_byte Q16 fixed-point tutulur (alt-cycle hassasiyet).
     // ==========================================
     uint64_t tsc_hz = rte_get_tsc_hz();
 
-    // Hassas hesaplama: rate_mbps -> bytes/sec -> packets/sec -> cycles/packet
-    // IMIX: Ortalama paket boyutu kullan
-    uint64_t bytes_per_sec = (uint64_t)params->rate_mbps * 125000ULL;  // Mbit/s -> bytes/s
+    uint64_t bytes_per_sec = (uint64_t)params->rate_kbps * 125ULL;  // kbit/s -> bytes/s
+    if (bytes_per_sec == 0)
+        bytes_per_sec = 1;
+    const uint64_t cycles_per_byte_q16 = (tsc_hz << 16) / bytes_per_sec;
+#define EXT_BYTES_TO_CYCLES(b) (((uint64_t)(b) * cycles_per_byte_q16) >> 16)
+
+    // Ortalama gap: mempool boşken atlanan slot ve resync sayımı için
+    const uint64_t delay_cycles = EXT_BYTES_TO_CYCLES(avg_pkt_size);
+    // No-catch-up eşiği: en uzun paketin gap'i
+    const uint64_t max_gap_cycles = EXT_BYTES_TO_CYCLES(max_pkt_size);
     uint64_t packets_per_sec = bytes_per_sec / avg_pkt_size;
-    uint64_t delay_cycles = (packets_per_sec > 0) ? (tsc_hz / packets_per_sec) : tsc_hz;
 
-    // Mikrosaniye cinsinden paket arası süre (debug için)
+    // Mikrosaniye cinsinden ortalama paket arası süre (debug için)
     double inter_packet_us = (double)delay_cycles * 1000000.0 / (double)tsc_hz;
 
     // Stagger: Her port farklı zamanda başlar (switch buffer koruma)
@@ -282,24 +536,28 @@ int dpdk_ext_tx_worker(void *arg)
     uint64_t stagger_offset = port_idx * (tsc_hz / 20);  // 50ms per port
     uint64_t next_send_time = rte_get_tsc_cycles() + stagger_offset;
 
-    printf("ExtTX Worker started: Port %u Q%u, %u targets, Rate %u Mbps\n",
-           params->port_id, params->queue_id, target_count, params->rate_mbps);
+    printf("ExtTX Worker started: Port %u Q%u, %u targets, Rate %.2f Mbps (DRR)\n",
+           params->port_id, params->queue_id, target_count, params->rate_kbps / 1000.0);
 #if IMIX_ENABLED
     printf("  *** IMIX MODE + SMOOTH PACING ***\n");
     printf("  -> IMIX pattern: 100, 200, 400, 800, 1200x3, 1518x3 (avg=%lu bytes)\n", avg_pkt_size);
-    printf("  -> Worker offset: %u (hybrid shuffle)\n", imix_offset);
 #else
     printf("  *** SMOOTH PACING - 1 saniyeye yayılmış trafik ***\n");
 #endif
     for (int t = 0; t < target_count; t++) {
         struct dpdk_ext_tx_target *target = &port_config->targets[t];
-        printf("  Target %d: VLAN %u, VL-ID [%u..%u)\n",
+        printf("  Target %d: VLAN %u, VL-ID [%u..%u), Rate %.2f Mbps, quantum %lu bytes\n",
                t, target->vlan_id, target->vl_id_start,
-               target->vl_id_start + target->vl_id_count);
+               target->vl_id_start + target->vl_id_count,
+               target->rate_kbps / 1000.0, drr[t].quantum);
     }
     printf("  -> Pacing: %.1f us/paket (%.0f paket/s), stagger=%lums\n",
            inter_packet_us, (double)packets_per_sec, stagger_offset * 1000 / tsc_hz);
 
+    char pacing_label[TX_PACING_LABEL_LEN];
+    snprintf(pacing_label, sizeof(pacing_label), "ExtTX P%u Q%u", params->port_id, params->queue_id);
+    struct tx_pacing_stats *pacing = tx_pacing_register(pacing_label, tsc_hz);
+
     uint64_t local_tx_pkts = 0;
     uint64_t local_tx_bytes = 0;
     const uint32_t STATS_FLUSH = 1024;
@@ -320,124 +578,48 @@ int dpdk_ext_tx_worker(void *arg)
 
         // ÖNEMLİ: Geride kalırsak CATCH-UP YAPMA (burst önleme)
         // Sadece bir sonraki slot'a geç, kayıp paketleri telafi etme
-        if (next_send_time + delay_cycles < now) {
+        if (next_send_time + max_gap_cycles < now) {
             // Çok geride kaldık, şimdiden başla (paket kaybı kabul)
+            tx_pacing_record_resync(pacing, (now - next_send_time) / delay_cycles);
             next_send_time = now;
         }
-        next_send_time += delay_cycles;
+        const uint64_t slot_time = next_send_time;
 
         // Paket tahsisi - BAŞARISIZ OLURSA BİLE TIMING KORUNUR
-        pkts[0] = rte_pktmbuf_alloc(params->mbuf_pool);
-        if (unlikely(pkts[0] == NULL)) {
+        if (unlikely(pkt_io_tx_alloc(&io, buf, 1) == 0)) {
+            next_send_time += delay_cycles;
+            tx_pacing_record_skip(pacing);
             continue;
         }
 
-        struct rte_mbuf *m = pkts[0];
-        uint8_t *pkt = rte_pktmbuf_mtod(m, uint8_t *);
-
-        // Get current target (round-robin between all targets)
+        // DRR: Bu paketin hedefi
+        current_target = ext_drr_select(drr, target_count, current_target);
+        struct ext_drr_target *dt = &drr[current_target];
         struct dpdk_ext_tx_target *target = &port_config->targets[current_target];
 
-        // Current VL-ID (round-robin within target's range)
-        uint16_t curr_vl = target->vl_id_start + vl_offsets[current_target];
-        vl_offsets[current_target] = (vl_offsets[current_target] + 1) % target->vl_id_count;
-
-        // Move to next target for next packet
-        current_target = (current_target + 1) % target_count;
-
-        // Get sequence number
-        uint64_t seq = get_ext_tx_sequence(port_idx, curr_vl);
-
-        // ==========================================
-        // BUILD ETHERNET HEADER
-        // ==========================================
-        struct rte_ether_hdr *eth = (struct rte_ether_hdr *)pkt;
-
-        // Source MAC: 02:00:00:00:00:PP (PP = port)
-        eth->src_addr.addr_bytes[0] = 0x02;
-        eth->src_addr.addr_bytes[1] = 0x00;
-        eth->src_addr.addr_bytes[2] = 0x00;
-        eth->src_addr.addr_bytes[3] = 0x00;
-        eth->src_addr.addr_bytes[4] = 0x00;
-        eth->src_addr.addr_bytes[5] = (uint8_t)params->port_id;
-
-        // Destination MAC: 03:00:00:00:VV:VV (VV = VL-ID)
-        eth->dst_addr.addr_bytes[0] = 0x03;
-        eth->dst_addr.addr_bytes[1] = 0x00;
-        eth->dst_addr.addr_bytes[2] = 0x00;
-        eth->dst_addr.addr_bytes[3] = 0x00;
-        eth->dst_addr.addr_bytes[4] = (uint8_t)(curr_vl >> 8);
-        eth->dst_addr.addr_bytes[5] = (uint8_t)(curr_vl & 0xFF);
-
-        // VLAN tag (802.1Q) - use target's VLAN ID
-        eth->ether_type = rte_cpu_to_be_16(0x8100);
-        uint8_t *vlan_tag = pkt + sizeof(struct rte_ether_hdr);
-        uint16_t vlan_tci = target->vlan_id;
-        *(uint16_t *)vlan_tag = rte_cpu_to_be_16(vlan_tci);
-        *(uint16_t *)(vlan_tag + 2) = rte_cpu_to_be_16(0x0800); // IPv4
-
+        const uint16_t pkt_size = dt->next_size;
+        dt->deficit -= pkt_size;
 #if IMIX_ENABLED
-        // IMIX: Paket boyutunu pattern'den al
-        uint16_t pkt_size = get_imix_packet_size(imix_counter, imix_offset);
-        uint16_t prbs_len = calc_prbs_size(pkt_size);
-        uint16_t payload_size = pkt_size - l2_len - sizeof(struct rte_ipv4_hdr) - sizeof(struct rte_udp_hdr);
-        imix_counter++;
-#else
-        const uint16_t pkt_size = PACKET_SIZE_VLAN;
-        const uint16_t prbs_len = NUM_PRBS_BYTES;
-        const uint16_t payload_size = PAYLOAD_SIZE_VLAN;
+        dt->imix_counter++;
 #endif
+        dt->next_size = ext_drr_peek_size(dt);
 
-        // ==========================================
-        // BUILD IP HEADER (dinamik total_length)
-        // ==========================================
-        struct rte_ipv4_hdr *ip = (struct rte_ipv4_hdr *)(pkt + l2_len);
-        ip->version_ihl = 0x45;
-        ip->type_of_service = 0;
-        ip->total_length = rte_cpu_to_be_16(pkt_size - l2_len);
-        ip->packet_id = 0;
-        ip->fragment_offset = 0;
-        ip->time_to_live = 1;
-        ip->next_proto_id = IPPROTO_UDP;
-        ip->src_addr = rte_cpu_to_be_32(0x0A000000); // 10.0.0.0
-        // Destination IP: 224.224.VV.VV
-        ip->dst_addr = rte_cpu_to_be_32((224U << 24) | (224U << 16) |
-                                        ((curr_vl >> 8) << 8) | (curr_vl & 0xFF));
-        ip->hdr_checksum = 0;
-        ip->hdr_checksum = rte_ipv4_cksum(ip);
+        // Sonraki slot bu paketin tel üzerindeki süresi kadar ileride
+        next_send_time += EXT_BYTES_TO_CYCLES(pkt_size);
 
-        // ==========================================
-        // BUILD UDP HEADER (dinamik dgram_len)
-        // ==========================================
-        struct rte_udp_hdr *udp = (struct rte_udp_hdr *)(pkt + l2_len + sizeof(struct rte_ipv4_hdr));
-        udp->src_port = rte_cpu_to_be_16(100);
-        udp->dst_port = rte_cpu_to_be_16(100);
-        udp->dgram_len = rte_cpu_to_be_16(sizeof(struct rte_udp_hdr) + payload_size);
-        udp->dgram_cksum = 0;
-
-        // ==========================================
-        // BUILD PAYLOAD (Sequence + PRBS)
-        // ==========================================
-        uint8_t *payload = pkt + l2_len + sizeof(struct rte_ipv4_hdr) + sizeof(struct rte_udp_hdr);
-
-        // Sequence number (8 bytes)
-        *(uint64_t *)payload = seq;
+        // Current VL-ID (round-robin within target's range)
+        uint16_t curr_vl = target->vl_id_start + dt->vl_offset;
+        dt->vl_offset = (dt->vl_offset + 1) % target->vl_id_count;
 
-        // PRBS data (IMIX: offset hep MAX ile hesaplanır, boyut dinamik)
-#if IMIX_ENABLED
-        uint64_t prbs_offset = (seq * (uint64_t)MAX_PRBS_BYTES) % PRBS_CACHE_SIZE;
-        memcpy(payload + 8, prbs_cache_ext + prbs_offset, prbs_len);
-#else
-        uint64_t prbs_offset = (seq * (uint64_t)NUM_PRBS_BYTES) % PRBS_CACHE_SIZE;
-        memcpy(payload + 8, prbs_cache_ext + prbs_offset, NUM_PRBS_BYTES);
-#endif
+        // Get sequence number
+        uint64_t seq = get_ext_tx_sequence(port_idx, curr_vl);
 
-        // Set packet length (dinamik)
-        m->data_len = pkt_size;
-        m->pkt_len = pkt_size;
+        buf[0].len = dpdk_ext_tx_build_frame(buf[0].data, params->port_id, target->vlan_id,
+                                             curr_vl, seq, pkt_size, prbs_cache_ext);
 
-        // Send single packet
-        uint16_t nb_tx = rte_eth_tx_burst(params->port_id, params->queue_id, pkts, 1);
+        // Send single packet (NIC almazsa mbuf pkt_io'da serbest bırakılır)
+        const uint64_t depart_time = rte_get_tsc_cycles();
+        uint16_t nb_tx = pkt_io_tx_burst(&io, buf, 1);
 
         if (!first_burst && nb_tx > 0) {
             printf("ExtTX: First packet on Port %u Q%u\n", params->port_id, params->queue_id);
@@ -447,14 +629,23 @@ int dpdk_ext_tx_worker(void *arg)
         if (nb_tx > 0) {
             local_tx_pkts++;
             local_tx_bytes += pkt_size;  // Dinamik boyut kullan
+            dt->local_pkts++;
+            dt->local_bytes += pkt_size;
+            tx_pacing_record_departure(pacing, slot_time, depart_time);
+#if RAW_SOCKET_TIMESTAMPING
+            // DPDK -> raw: TX zamanı NIC'e teslim anı (host saati)
+            if (raw_lat_sampled(seq))
+                raw_lat_tx_sample(curr_vl, seq, raw_lat_now_ns());
+#endif
         } else {
-            rte_pktmbuf_free(pkts[0]);
+            tx_pacing_record_drop(pacing);
         }
 
         // Flush stats periodically
         if (local_tx_pkts >= STATS_FLUSH) {
             rte_atomic64_add(&dpdk_ext_tx_stats_per_port[port_idx].tx_pkts, local_tx_pkts);
             rte_atomic64_add(&dpdk_ext_tx_stats_per_port[port_idx].tx_bytes, local_tx_bytes);
+            ext_drr_flush(&dpdk_ext_tx_stats_per_port[port_idx], drr, target_count);
             local_tx_pkts = 0;
             local_tx_bytes = 0;
         }
@@ -464,9 +655,11 @@ int dpdk_ext_tx_worker(void *arg)
     if (local_tx_pkts > 0) {
         rte_atomic64_add(&dpdk_ext_tx_stats_per_port[port_idx].tx_pkts, local_tx_pkts);
         rte_atomic64_add(&dpdk_ext_tx_stats_per_port[port_idx].tx_bytes, local_tx_bytes);
+        ext_drr_flush(&dpdk_ext_tx_stats_per_port[port_idx], drr, target_count);
     }
+#undef EXT_BYTES_TO_CYCLES
 
-    free(vl_offsets);
+    free(drr);
     printf("ExtTX Worker stopped: Port %u Q%u\n", params->port_id, params->queue_id);
     return 0;
 }
@@ -481,9 +674,14 @@ int dpdk_ext_tx_worker(void *arg)
 int dpdk_ext_tx_start_workers(struct ports_config *ports_config, volatile bool *stop_flag)
 {
     printf("\n=== Starting DPDK External TX Workers ===\n");
+#if DPDK_EXT_TX_INLINE
+    printf("Mode: INLINE (tx_worker queue'ları, ayrı pacing) + DEDICATED fallback\n");
+#else
     printf("Mode: DEDICATED LCORES (queue 4 for external TX)\n");
+#endif
 
     int worker_idx = 0;
+    int inline_ports = 0;
 
     for (int p = 0; p < DPDK_EXT_TX_PORT_COUNT; p++)
     {
@@ -496,6 +694,14 @@ int dpdk_ext_tx_start_workers(struct ports_config *ports_config, volatile bool *
             continue;
         }
 
+        // Inline portlarda ext trafiği ana tx_worker'lar taşır
+        if (dpdk_ext_tx_port_inline(port_id)) {
+            printf("  Port %u: Inline in TX queues 0-%d (no dedicated lcore)\n",
+                   port_id, NUM_TX_CORES - 1);
+            inline_ports++;
+            continue;
+        }
+
         // Get dedicated external TX lcore from port config
         uint16_t ext_lcore = ports_config->ports[port_id].used_ext_tx_core;
         if (ext_lcore == 0)
@@ -513,10 +719,11 @@ int dpdk_ext_tx_start_workers(struct ports_config *ports_config, volatile bool *
         params->mbuf_pool = ext_port->mbuf_pool;
         params->stop_flag = stop_flag;
 
-        // For the worker, use SINGLE target's rate (all targets share the same port bandwidth)
-        // Config has 220 Mbps per target, but since we round-robin through all targets
-        // on the same port, the total rate should be 220 Mbps (not sum of all targets)
-        params->rate_mbps = ext_port->config.targets[0].rate_mbps;
+        // Port toplam hızı = hedef rate'lerinin toplamı; hedefler arası
+        // paylaşım worker içinde DRR ile yapılır
+        params->rate_kbps = 0;
+        for (int t = 0; t < ext_port->config.target_count; t++)
+            params->rate_kbps += ext_port->config.targets[t].rate_kbps;
 
         // VL-ID range covers all targets
         params->vl_id_start = ext_port->config.targets[0].vl_id_start;
@@ -526,8 +733,8 @@ int dpdk_ext_tx_start_workers(struct ports_config *ports_config, volatile bool *
         params->vl_id_count = vl_end - params->vl_id_start;
         params->vlan_id = ext_port->config.targets[0].vlan_id;  // Will cycle through all VLANs
 
-        printf("  Port %u: Lcore %u, Queue 4, Rate %u Mbps, VL-ID [%u..%u)\n",
-               port_id, ext_lcore, params->rate_mbps,
+        printf("  Port %u: Lcore %u, Queue 4, Rate %.2f Mbps, VL-ID [%u..%u)\n",
+               port_id, ext_lcore, params->rate_kbps / 1000.0,
                params->vl_id_start, params->vl_id_start + params->vl_id_count);
 
         int ret = rte_eal_remote_launch(dpdk_ext_tx_worker, params, ext_lcore);
@@ -540,7 +747,11 @@ int dpdk_ext_tx_start_workers(struct ports_config *ports_config, volatile bool *
         worker_idx++;
     }
 
-    printf("=== %d External TX Workers Started ===\n\n", worker_idx);
+    // Inline ext sınıfını serbest bırak (raw socket RX artık hazır)
+    __atomic_store_n(&ext_inline_armed, 1, __ATOMIC_RELEASE);
+
+    printf("=== %d External TX Workers Started, %d inline ports ===\n\n",
+           worker_idx, inline_ports);
     return 0;
 }
 
@@ -561,12 +772,20 @@ void dpdk_ext_tx_get_stats(uint16_t port_id, uint64_t *tx_pkts, uint64_t *tx_byt
     *tx_bytes = 0;
 }
 
+// TSC -> ns; cycles * 1e9 GHz TSC'de birkaç saniyelik uptime'da uint64 taşar
+static inline uint64_t ext_tsc_now_ns(void)
+{
+    uint64_t cycles = rte_get_tsc_cycles();
+    uint64_t hz = rte_get_tsc_hz();
+    return (cycles / hz) * 1000000000ULL + (cycles % hz) * 1000000000ULL / hz;
+}
+
 void dpdk_ext_tx_print_stats(void)
 {
     static uint64_t prev_bytes[DPDK_EXT_TX_PORT_COUNT] = {0};
     static uint64_t last_time_ns = 0;
 
-    uint64_t now_ns = rte_get_tsc_cycles() * 1000000000ULL / rte_get_tsc_hz();
+    uint64_t now_ns = ext_tsc_now_ns();
     double elapsed_sec = 1.0;
     if (last_time_ns > 0) {
         elapsed_sec = (double)(now_ns - last_time_ns) / 1000000000.0;
@@ -621,4 +840,40 @@ void dpdk_ext_tx_print_stats(void)
     printf("╚══════════════════╩══════════════╩═══════════════╩═══════════╩═════════════════════╝\n");
 }
 
+void dpdk_ext_tx_print_target_stats(void)
+{
+    static uint64_t last_time_ns = 0;
+
+    uint64_t now_ns = ext_tsc_now_ns();
+    double elapsed_sec = 1.0;
+    if (last_time_ns > 0) {
+        elapsed_sec = (double)(now_ns - last_time_ns) / 1000000000.0;
+        if (elapsed_sec < 0.1) elapsed_sec = 1.0;
+    }
+    last_time_ns = now_ns;
+
+    // Hedef bazlı: DRR planlanan vs gerçekleşen hız
+    static uint64_t prev_target_bytes[DPDK_EXT_TX_PORT_COUNT][DPDK_EXT_TX_QUEUES_PER_PORT] = {{0}};
+
+    printf("\n=== DPDK External TX per-target (DRR planned vs achieved) ===\n");
+    printf("%-10s %-6s %-13s %10s %10s %8s\n", "Target",
+           "VLAN", "VL-ID", "Plan Mbps", "TX Mbps", "Err %");
+    for (int i = 0; i < DPDK_EXT_TX_PORT_COUNT; i++) {
+        for (int t = 0; t < ext_tx_configs[i].target_count; t++) {
+            const struct dpdk_ext_tx_target *target = &ext_tx_configs[i].targets[t];
+            uint64_t bytes = rte_atomic64_read(&dpdk_ext_tx_stats_per_port[i].targets[t].tx_bytes);
+            double mbps = ((bytes - prev_target_bytes[i][t]) * 8.0) / (elapsed_sec * 1000000.0);
+            prev_target_bytes[i][t] = bytes;
+
+            double plan_mbps = target->rate_kbps / 1000.0;
+            double err_pct = plan_mbps > 0 ? (mbps - plan_mbps) * 100.0 / plan_mbps : 0.0;
+
+            printf("P%-3u T%-4d %-6u %5u-%-7u %10.2f %10.2f %+7.2f%%\n",
+                   ext_tx_configs[i].port_id, t, target->vlan_id,
+                   target->vl_id_start, target->vl_id_start + target->vl_id_count - 1,
+                   plan_mbps, mbps, err_pct);
+        }
+    }
+}
+
 #endif /* DPDK_EXT_TX_ENABLED */
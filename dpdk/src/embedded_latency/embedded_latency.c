@@ -6,8 +6,14 @@
  * latency ölçümü yapar.
  *
  * DPDK EAL başlamadan önce çalıştırılmalı!
+ *
+ * Soketler interface başına bir kez açılır (socket pool) ve loopback/unit
+ * fazları arasında paylaşılır. Tüm port çiftleri aynı anda sürülür;
+ * TX timestamp'leri error queue'dan OPT_ID ile async toplanır.
  */
 
+#define _GNU_SOURCE  // ppoll
+
 #include "embedded_latency.h"
 
 #include <stdio.h>
@@ -23,6 +29,7 @@
 #include <sys/ioctl.h>
 #include <linux/if_packet.h>
 #include <linux/if_ether.h>
+#include <linux/errqueue.h>
 #include <linux/net_tstamp.h>
 #include <linux/sockios.h>
 #include <linux/ethtool.h>
@@ -85,8 +92,8 @@ static const struct {
 };
 #define NUM_PORTS (sizeof(PORT_INFO) / sizeof(PORT_INFO[0]))
 
-// LOOPBACK TEST: Port pairs - TX -> RX mapping (through Mellanox switch)
-static const struct {
+// Port pair: TX -> RX, VLAN/VL-ID listesi
+struct emb_pair_cfg {
     uint16_t tx_port;
     const char *tx_iface;
     uint16_t rx_port;
@@ -94,7 +101,10 @@ static const struct {
     uint16_t vlans[4];
     uint16_t vl_ids[4];
     int vlan_count;
-} LOOPBACK_PAIRS[] = {
+};
+
+// LOOPBACK TEST: Port pairs - TX -> RX mapping (through Mellanox switch)
+static const struct emb_pair_cfg LOOPBACK_PAIRS[] = {
     {0, "ens2f0np0", 7, "ens5f1np1", {105, 106, 107, 108}, {1027, 1155, 1283, 1411}, 4},
     {1, "ens2f1np1", 6, "ens5f0np0", {109, 110, 111, 112}, {1539, 1667, 1795, 1923}, 4},
     {2, "ens1f0np0", 5, "ens3f1np1", {97,  98,  99,  100}, {3,    131,  259,  387 }, 4},
@@ -107,15 +117,7 @@ static const struct {
 #define NUM_LOOPBACK_PAIRS (sizeof(LOOPBACK_PAIRS) / sizeof(LOOPBACK_PAIRS[0]))
 
 // UNIT TEST: Port pairs - neighboring ports (0↔1, 2↔3, 4↔5, 6↔7)
-static const struct {
-    uint16_t tx_port;
-    const char *tx_iface;
-    uint16_t rx_port;
-    const char *rx_iface;
-    uint16_t vlans[4];
-    uint16_t vl_ids[4];
-    int vlan_count;
-} UNIT_TEST_PAIRS[] = {
+static const struct emb_pair_cfg UNIT_TEST_PAIRS[] = {
     // Port 0 -> Port 1
     {0, "ens2f0np0", 1, "ens2f1np1", {105, 106, 107, 108}, {1027, 1155, 1283, 1411}, 4},
     // Port 1 -> Port 0
@@ -163,16 +165,83 @@ static double ns_to_us(uint64_t ns) {
     return (double)ns / 1000.0;
 }
 
+static const char *emb_ts_tier_name(emb_ts_tier_t tier) {
+    static const char *names[] = {"hw", "sw", "user"};
+    return tier <= EMB_TS_TIER_USER ? names[tier] : "?";
+}
+
 // ============================================
 // HW TIMESTAMP SOCKET
 // ============================================
 
 typedef enum {
     EMB_SOCK_TX,
-    EMB_SOCK_RX
+    EMB_SOCK_RX,
+    EMB_SOCK_TXRX       // Socket pool: aynı soketten gönder + al
 } emb_sock_type_t;
 
-static int create_raw_socket(const char *ifname, int *if_index, emb_sock_type_t type) {
+/**
+ * ETHTOOL_GET_TS_INFO so_timestamping bayrakları
+ * @return Bayraklar, -1 = sorgulanamadı
+ */
+static int query_ts_caps(const char *ifname) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        return -1;
+    }
+
+    struct ethtool_ts_info ts_info = {0};
+    ts_info.cmd = ETHTOOL_GET_TS_INFO;
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    ifr.ifr_data = (void *)&ts_info;
+
+    int ret = ioctl(sock, SIOCETHTOOL, &ifr);
+    close(sock);
+    return ret < 0 ? -1 : (int)ts_info.so_timestamping;
+}
+
+/**
+ * Soketi istenen tier'a (kuramazsa daha kötüsüne) ayarla
+ * @return Kurulan tier
+ */
+static emb_ts_tier_t set_socket_tier(int fd, emb_sock_type_t type, emb_ts_tier_t tier) {
+    bool tx = (type != EMB_SOCK_RX);
+    bool rx = (type != EMB_SOCK_TX);
+
+    for (; tier < EMB_TS_TIER_USER; tier++) {
+        int flags;
+        if (tier == EMB_TS_TIER_HW) {
+            flags = SOF_TIMESTAMPING_RAW_HARDWARE;
+            if (tx) flags |= SOF_TIMESTAMPING_TX_HARDWARE;
+            if (rx) flags |= SOF_TIMESTAMPING_RX_HARDWARE;
+        } else {
+            flags = SOF_TIMESTAMPING_SOFTWARE;
+            if (tx) flags |= SOF_TIMESTAMPING_TX_SOFTWARE;
+            if (rx) flags |= SOF_TIMESTAMPING_RX_SOFTWARE;
+        }
+        if (type == EMB_SOCK_TXRX) {
+            // OPT_ID: errqueue'daki TX timestamp hangi gönderime ait (ee_data)
+            // OPT_TSONLY: paketin kopyası errqueue'ya dönmesin
+            flags |= SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+        }
+
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+            return tier;
+        }
+        perror("SO_TIMESTAMPING");
+    }
+
+    // User-space: kernel timestamp kapalı, errqueue'ya mesaj gelmez
+    int off = 0;
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &off, sizeof(off));
+    return EMB_TS_TIER_USER;
+}
+
+static int create_raw_socket(const char *ifname, int *if_index, emb_sock_type_t type,
+                             emb_ts_tier_t *tier) {
     int fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
     if (fd < 0) {
         perror("socket");
@@ -204,7 +273,7 @@ static int create_raw_socket(const char *ifname, int *if_index, emb_sock_type_t
     }
 
     // Enable promiscuous mode for RX socket (needed for multicast packets)
-    if (type == EMB_SOCK_RX) {
+    if (type != EMB_SOCK_TX) {
         struct packet_mreq mreq;
         memset(&mreq, 0, sizeof(mreq));
         mreq.mr_ifindex = *if_index;
@@ -212,33 +281,157 @@ static int create_raw_socket(const char *ifname, int *if_index, emb_sock_type_t
         setsockopt(fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
     }
 
-    // Enable HW timestamping on NIC
-    struct hwtstamp_config hwconfig = {0};
-    hwconfig.tx_type = (type == EMB_SOCK_TX) ? HWTSTAMP_TX_ON : HWTSTAMP_TX_OFF;
-    hwconfig.rx_filter = (type == EMB_SOCK_RX) ? HWTSTAMP_FILTER_ALL : HWTSTAMP_FILTER_NONE;
-
-    memset(&ifr, 0, sizeof(ifr));
-    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
-    ifr.ifr_data = (void *)&hwconfig;
-    ioctl(fd, SIOCSHWTSTAMP, &ifr);  // May fail on some NICs, continue anyway
+    // Interface'in en iyi tier'ı (latency_test/hw_timestamp.c ile aynı kural):
+    // HW sadece ethtool HW TX/RX + raw bildirirse; sorgulanamazsa SW denenir
+    bool need_tx = (type != EMB_SOCK_RX);
+    bool need_rx = (type != EMB_SOCK_TX);
+    int caps = query_ts_caps(ifname);
+    bool hw_ok = caps >= 0 && (caps & SOF_TIMESTAMPING_RAW_HARDWARE) &&
+                 (!need_tx || (caps & SOF_TIMESTAMPING_TX_HARDWARE)) &&
+                 (!need_rx || (caps & SOF_TIMESTAMPING_RX_HARDWARE));
+    bool sw_ok = caps < 0 || !need_tx || (caps & SOF_TIMESTAMPING_TX_SOFTWARE);
+
+    if (hw_ok) {
+        // Enable HW timestamping on NIC
+        struct hwtstamp_config hwconfig = {0};
+        hwconfig.tx_type = need_tx ? HWTSTAMP_TX_ON : HWTSTAMP_TX_OFF;
+        hwconfig.rx_filter = need_rx ? HWTSTAMP_FILTER_ALL : HWTSTAMP_FILTER_NONE;
+
+        memset(&ifr, 0, sizeof(ifr));
+        strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+        ifr.ifr_data = (void *)&hwconfig;
+        ioctl(fd, SIOCSHWTSTAMP, &ifr);  // May fail on some NICs, continue anyway
+    }
 
     // Request timestamps via socket option
-    int flags = SOF_TIMESTAMPING_RAW_HARDWARE;
-    if (type == EMB_SOCK_TX) {
-        flags |= SOF_TIMESTAMPING_TX_HARDWARE;
-    } else {
-        flags |= SOF_TIMESTAMPING_RX_HARDWARE;
+    *tier = set_socket_tier(fd, type, hw_ok ? EMB_TS_TIER_HW : sw_ok ? EMB_TS_TIER_SW : EMB_TS_TIER_USER);
+    if (*tier != EMB_TS_TIER_HW) {
+        printf("%s: no HW timestamping, using %s timestamps\n", ifname, emb_ts_tier_name(*tier));
     }
 
-    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
-        perror("SO_TIMESTAMPING");
-        close(fd);
-        return -1;
+#ifdef PACKET_IGNORE_OUTGOING
+    // Kendi gönderdiğimiz paketler RX kuyruğuna düşmesin
+    if (type == EMB_SOCK_TXRX) {
+        int one = 1;
+        setsockopt(fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
     }
+#endif
 
     return fd;
 }
 
+// ============================================
+// SOCKET POOL
+// ============================================
+// Port başına tek TXRX soket. SIOCSHWTSTAMP interface geneli olduğundan
+// bir port hem bir çiftin TX'i hem diğerinin RX'i olabilir.
+
+struct emb_pool_sock {
+    int      fd;                // -1 = kapalı
+    int      ifindex;
+    uint32_t next_tskey;        // Kernel'in sıradaki gönderime vereceği OPT_ID
+    emb_ts_tier_t tier;
+};
+
+static struct emb_pool_sock g_sock_pool[EMB_LAT_MAX_PORTS];
+static bool g_sock_pool_open = false;
+static emb_ts_tier_t g_pool_tier = EMB_TS_TIER_HW;     // Tüm soketlerin ortak tier'ı
+
+/**
+ * Pool'u aç (zaten açıksa no-op)
+ * @return true: bu çağrı açtı (kapatmak da çağırana düşer)
+ */
+static bool emb_sock_pool_acquire(void) {
+    if (g_sock_pool_open) {
+        return false;
+    }
+
+    for (size_t i = 0; i < EMB_LAT_MAX_PORTS; i++) {
+        g_sock_pool[i].fd = -1;
+    }
+
+    for (size_t i = 0; i < NUM_PORTS; i++) {
+        struct emb_pool_sock *ps = &g_sock_pool[PORT_INFO[i].port_id];
+        ps->fd = create_raw_socket(PORT_INFO[i].iface, &ps->ifindex, EMB_SOCK_TXRX, &ps->tier);
+        ps->next_tskey = 0;
+        if (ps->fd < 0) {
+            fprintf(stderr, "ERROR: Cannot create socket for %s\n", PORT_INFO[i].iface);
+        }
+    }
+    g_sock_pool_open = true;
+
+    // Çiftler farklı interface'leri karıştırır: hepsi en kötü tier'a iner.
+    // Bir soket o tier'ı kuramazsa daha da aşağı: sabitlenene kadar tekrar.
+    g_pool_tier = EMB_TS_TIER_HW;
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (size_t i = 0; i < EMB_LAT_MAX_PORTS; i++) {
+            if (g_sock_pool[i].fd >= 0 && g_sock_pool[i].tier > g_pool_tier) {
+                g_pool_tier = g_sock_pool[i].tier;
+            }
+        }
+        for (size_t i = 0; i < EMB_LAT_MAX_PORTS; i++) {
+            struct emb_pool_sock *ps = &g_sock_pool[i];
+            if (ps->fd >= 0 && ps->tier != g_pool_tier) {
+                ps->tier = set_socket_tier(ps->fd, EMB_SOCK_TXRX, g_pool_tier);
+                changed |= (ps->tier != g_pool_tier);
+            }
+        }
+    }
+    if (g_pool_tier != EMB_TS_TIER_HW) {
+        printf("Latency timestamps: %s tier (not comparable with HW results)\n",
+               emb_ts_tier_name(g_pool_tier));
+    }
+
+    // Wait for sockets to fully initialize (critical for first packet!)
+    usleep(10000);  // 10ms
+
+    return true;
+}
+
+void emb_latency_close_sockets(void) {
+    if (!g_sock_pool_open) {
+        return;
+    }
+    for (size_t i = 0; i < EMB_LAT_MAX_PORTS; i++) {
+        if (g_sock_pool[i].fd >= 0) {
+            close(g_sock_pool[i].fd);
+            g_sock_pool[i].fd = -1;
+        }
+    }
+    g_sock_pool_open = false;
+}
+
+static int emb_pool_fd(uint16_t port_id) {
+    return port_id < EMB_LAT_MAX_PORTS ? g_sock_pool[port_id].fd : -1;
+}
+
+/** Önceki fazdan kalan paket/timestamp'leri at */
+static void emb_sock_pool_flush(void) {
+    uint8_t buf[2048];
+    char ctrl[512];
+
+    for (size_t i = 0; i < EMB_LAT_MAX_PORTS; i++) {
+        int fd = g_sock_pool[i].fd;
+        if (fd < 0) {
+            continue;
+        }
+        while (recv(fd, buf, sizeof(buf), MSG_DONTWAIT) >= 0) {
+        }
+        for (;;) {
+            struct iovec iov = {buf, sizeof(buf)};
+            struct msghdr msg = {0};
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = ctrl;
+            msg.msg_controllen = sizeof(ctrl);
+            if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                break;
+            }
+        }
+    }
+}
+
 // ============================================
 // PACKET BUILDING
 // ============================================
@@ -376,22 +569,24 @@ static bool is_our_test_packet(const uint8_t *pkt, size_t len, uint16_t expected
 #define SCM_TIMESTAMPING SO_TIMESTAMPING
 #endif
 
+/**
+ * Pool tier'ına ait timestamp'i çıkar. HW ve SW saatleri farklı tabanlarda,
+ * paket başına diğerine düşmek TX/RX farkını anlamsız yapar.
+ */
 static bool extract_timestamp(struct msghdr *msg, uint64_t *ts_ns) {
     struct cmsghdr *cmsg;
 
+    // ts[0] = software, ts[1] = deprecated, ts[2] = hardware (raw)
+    int idx = (g_pool_tier == EMB_TS_TIER_HW) ? 2 : (g_pool_tier == EMB_TS_TIER_SW) ? 0 : -1;
+    if (idx < 0) {
+        return false;
+    }
+
     for (cmsg = CMSG_FIRSTHDR(msg); cmsg; cmsg = CMSG_NXTHDR(msg, cmsg)) {
         if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
             struct timespec *ts = (struct timespec *)CMSG_DATA(cmsg);
-            // ts[0] = software, ts[1] = deprecated, ts[2] = hardware (raw)
-
-            // Hardware timestamp preferred
-            if (ts[2].tv_sec != 0 || ts[2].tv_nsec != 0) {
-                *ts_ns = (uint64_t)ts[2].tv_sec * 1000000000ULL + ts[2].tv_nsec;
-                return true;
-            }
-            // Software timestamp fallback
-            if (ts[0].tv_sec != 0 || ts[0].tv_nsec != 0) {
-                *ts_ns = (uint64_t)ts[0].tv_sec * 1000000000ULL + ts[0].tv_nsec;
+            if (ts[idx].tv_sec != 0 || ts[idx].tv_nsec != 0) {
+                *ts_ns = (uint64_t)ts[idx].tv_sec * 1000000000ULL + ts[idx].tv_nsec;
                 return true;
             }
         }
@@ -400,121 +595,481 @@ static bool extract_timestamp(struct msghdr *msg, uint64_t *ts_ns) {
 }
 
 // ============================================
-// SINGLE TEST
+// PARALLEL PROBE SCHEDULER
 // ============================================
+// Tüm çiftler aynı anda: her çift kendi VLAN/paket sırasını 32us arayla
+// gönderir, aynı anda en fazla EMB_LAT_MAX_INFLIGHT cevap bekler.
+// Bekleme tek ppoll() üzerinden; TX ts (errqueue) ve RX hangi sırayla
+// gelirse gelsin probe'a yazılır. Sonuç düzeni eski seri döngüyle aynı.
+
+#define EMB_TX_TS_TIMEOUT_MS    100     // Eski poll(POLLERR, 100) ile aynı
+#define EMB_TSKEY_RING          64      // >= EMB_LAT_MAX_INFLIGHT, 2'nin kuvveti
+
+struct emb_probe {
+    int      result_idx;
+    int      pair_idx;
+    uint64_t sent_ns;           // 0 = henüz gönderilmedi
+    uint32_t tskey;
+    uint64_t tx_ts;
+    uint64_t rx_ts;
+    bool     tx_done;
+    bool     rx_done;
+    bool     finished;
+};
+
+struct emb_pair_state {
+    int      tx_fd;
+    int      rx_fd;
+    int      first_probe;       // Probe aralığı [first_probe, end_probe)
+    int      end_probe;
+    int      next_probe;        // Sıradaki gönderim
+    int      done_probe;        // Bundan öncekilerin hepsi kapandı
+    int      inflight;
+    uint64_t next_send_ns;
+};
+
+struct emb_sched {
+    const struct emb_pair_cfg *pairs;
+    struct emb_pair_state     *ps;
+    struct emb_probe          *probes;
+    struct emb_latency_result *results;
+    uint64_t *total_latency;    // Sonuç başına toplam (avg için)
+    int      *open_probes;      // Sonuç başına kapanmamış probe
+    int16_t  *vl_result;        // VL-ID -> sonuç indeksi
+    int      *result_pair;      // Sonuç -> çift
+    int       key_probe[EMB_LAT_MAX_PORTS][EMB_TSKEY_RING];
+    int       packet_count;
+    int       timeout_ms;
+    uint64_t  max_latency_ns;
+    int       remaining;
+};
+
+static void emb_finalize_result(struct emb_sched *sc, int r) {
+    struct emb_latency_result *result = &sc->results[r];
+
+    if (result->rx_count > 0) {
+        result->valid = true;
+        result->avg_latency_ns = sc->total_latency[r] / result->rx_count;
+        result->passed = (result->max_latency_ns <= sc->max_latency_ns);
+        if (result->min_latency_ns == UINT64_MAX)
+            result->min_latency_ns = 0;
+    } else {
+        result->valid = false;
+        result->passed = false;
+        if (result->error_msg[0] == '\0')
+            snprintf(result->error_msg, sizeof(result->error_msg), "No packets received");
+    }
+}
+
+static void emb_probe_finish(struct emb_sched *sc, struct emb_probe *pr) {
+    int r = pr->result_idx;
+    struct emb_latency_result *result = &sc->results[r];
+
+    pr->finished = true;
+    sc->remaining--;
+    sc->ps[pr->pair_idx].inflight--;
 
-static int run_single_test(int tx_fd, int rx_fd, int tx_ifindex,
-                           uint16_t tx_port, uint16_t rx_port,
-                           uint16_t vlan_id, uint16_t vl_id,
-                           int packet_count, int timeout_ms,
-                           uint64_t max_latency_ns,
-                           struct emb_latency_result *result) {
+    if (pr->rx_done && pr->rx_ts > 0 && pr->tx_ts > 0 && pr->rx_ts > pr->tx_ts) {
+        uint64_t latency = pr->rx_ts - pr->tx_ts;
+        sc->total_latency[r] += latency;
 
-    memset(result, 0, sizeof(*result));
-    result->tx_port = tx_port;
-    result->rx_port = rx_port;
-    result->vlan_id = vlan_id;
-    result->vl_id = vl_id;
-    result->min_latency_ns = UINT64_MAX;
+        if (latency < result->min_latency_ns)
+            result->min_latency_ns = latency;
+        if (latency > result->max_latency_ns)
+            result->max_latency_ns = latency;
+
+        result->rx_count++;
+    }
 
+    if (--sc->open_probes[r] == 0) {
+        emb_finalize_result(sc, r);
+    }
+}
+
+static void emb_send_due(struct emb_sched *sc, int p, uint64_t now) {
+    struct emb_pair_state *ps = &sc->ps[p];
+    const struct emb_pair_cfg *pair = &sc->pairs[p];
+    struct emb_pool_sock *tx = &g_sock_pool[pair->tx_port];
     uint8_t tx_buf[2048];
-    uint8_t rx_buf[2048];
-    char ctrl_buf[1024];
 
-    uint64_t total_latency = 0;
+    while (ps->next_probe < ps->end_probe &&
+           ps->inflight < EMB_LAT_MAX_INFLIGHT &&
+           now >= ps->next_send_ns) {
+        // tskey halkasındaki slot hâlâ TX timestamp bekleyen bir probe'da ise dur
+        int *slot = &sc->key_probe[pair->tx_port][tx->next_tskey & (EMB_TSKEY_RING - 1)];
+        if (*slot >= 0 && !sc->probes[*slot].finished) {
+            break;
+        }
 
-    for (int pkt = 0; pkt < packet_count; pkt++) {
-        uint64_t seq = ((uint64_t)vlan_id << 32) | pkt;
+        int pi = ps->next_probe;
+        struct emb_probe *pr = &sc->probes[pi];
+        struct emb_latency_result *result = &sc->results[pr->result_idx];
+        int pkt = (pi - ps->first_probe) % sc->packet_count;
+        uint64_t seq = ((uint64_t)result->vlan_id << 32) | pkt;
 
-        // Build packet
-        int pkt_len = build_packet(tx_buf, vlan_id, vl_id, seq);
+        int pkt_len = build_packet(tx_buf, result->vlan_id, result->vl_id, seq);
 
-        // Send
         struct sockaddr_ll sll = {0};
         sll.sll_family = AF_PACKET;
-        sll.sll_ifindex = tx_ifindex;
+        sll.sll_ifindex = tx->ifindex;
         sll.sll_halen = 6;
         memcpy(sll.sll_addr, tx_buf, 6);
 
-        ssize_t sent = sendto(tx_fd, tx_buf, pkt_len, 0,
+        uint64_t user_ts = get_time_ns();
+        ssize_t sent = sendto(ps->tx_fd, tx_buf, pkt_len, MSG_DONTWAIT,
                               (struct sockaddr *)&sll, sizeof(sll));
+        if (sent < 0 && (errno == EAGAIN || errno == ENOBUFS)) {
+            break;  // Socket buffer dolu, sonraki turda tekrar
+        }
+
+        ps->next_probe++;
+        ps->inflight++;
+        ps->next_send_ns = now + 32000;  // Inter-probe delay (32us)
+        pr->sent_ns = now;
+
         if (sent < 0) {
             snprintf(result->error_msg, sizeof(result->error_msg), "send failed: %s", strerror(errno));
+            pr->tx_done = true;
+            emb_probe_finish(sc, pr);
             continue;
         }
         result->tx_count++;
 
-        // Get TX timestamp from error queue
-        uint64_t tx_ts = 0;
-        struct pollfd pfd = {tx_fd, POLLERR, 0};
-        if (poll(&pfd, 1, 100) > 0) {
-            struct msghdr msg = {0};
-            struct iovec iov = {rx_buf, sizeof(rx_buf)};
-            msg.msg_iov = &iov;
-            msg.msg_iovlen = 1;
-            msg.msg_control = ctrl_buf;
-            msg.msg_controllen = sizeof(ctrl_buf);
+        if (g_pool_tier == EMB_TS_TIER_USER) {
+            // Errqueue'ya timestamp gelmez, OPT_ID de ilerlemez
+            pr->tx_ts = user_ts;
+            pr->tx_done = true;
+            continue;
+        }
 
-            recvmsg(tx_fd, &msg, MSG_ERRQUEUE);
-            extract_timestamp(&msg, &tx_ts);
+        pr->tskey = tx->next_tskey++;
+        *slot = pi;
+    }
+}
+
+static void emb_drain_errqueue(struct emb_sched *sc, uint16_t port_id) {
+    int fd = g_sock_pool[port_id].fd;
+    uint8_t buf[256];
+    char ctrl_buf[1024];
+
+    for (;;) {
+        struct msghdr msg = {0};
+        struct iovec iov = {buf, sizeof(buf)};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = ctrl_buf;
+        msg.msg_controllen = sizeof(ctrl_buf);
+
+        if (recvmsg(fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return;
         }
 
-        // Wait for RX
-        struct pollfd rx_pfd = {rx_fd, POLLIN, 0};
-        int remaining = timeout_ms;
-        bool received = false;
-
-        while (remaining > 0 && !received) {
-            int ret = poll(&rx_pfd, 1, remaining < 100 ? remaining : 100);
-            if (ret > 0) {
-                struct msghdr msg = {0};
-                struct iovec iov = {rx_buf, sizeof(rx_buf)};
-                msg.msg_iov = &iov;
-                msg.msg_iovlen = 1;
-                msg.msg_control = ctrl_buf;
-                msg.msg_controllen = sizeof(ctrl_buf);
-
-                ssize_t len = recvmsg(rx_fd, &msg, 0);
-                if (len > 0) {
-                    // Check if this is our test packet (handles VLAN stripped case)
-                    if (is_our_test_packet(rx_buf, len, vlan_id, vl_id)) {
-                        uint64_t rx_ts = 0;
-                        extract_timestamp(&msg, &rx_ts);
-
-                        if (rx_ts > 0 && tx_ts > 0 && rx_ts > tx_ts) {
-                            uint64_t latency = rx_ts - tx_ts;
-                            total_latency += latency;
-
-                            if (latency < result->min_latency_ns)
-                                result->min_latency_ns = latency;
-                            if (latency > result->max_latency_ns)
-                                result->max_latency_ns = latency;
-
-                            result->rx_count++;
-                            received = true;
-                        }
-                    }
+        uint64_t tx_ts = 0;
+        bool have_key = false;
+        uint32_t key = 0;
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_PACKET && cmsg->cmsg_type == PACKET_TX_TIMESTAMP) {
+                struct sock_extended_err *serr = (struct sock_extended_err *)CMSG_DATA(cmsg);
+                if (serr->ee_errno == ENOMSG && serr->ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+                    key = serr->ee_data;
+                    have_key = true;
                 }
             }
-            remaining -= 100;
+        }
+        if (!have_key || !extract_timestamp(&msg, &tx_ts)) {
+            continue;
+        }
+
+        int pi = sc->key_probe[port_id][key & (EMB_TSKEY_RING - 1)];
+        if (pi < 0) {
+            continue;
+        }
+        struct emb_probe *pr = &sc->probes[pi];
+        if (pr->tskey != key || pr->finished || pr->tx_done) {
+            continue;
+        }
+
+        pr->tx_ts = tx_ts;
+        pr->tx_done = true;
+        if (pr->rx_done) {
+            emb_probe_finish(sc, pr);
         }
     }
+}
 
-    // Finalize
-    if (result->rx_count > 0) {
-        result->valid = true;
-        result->avg_latency_ns = total_latency / result->rx_count;
-        result->passed = (result->max_latency_ns <= max_latency_ns);
-        if (result->min_latency_ns == UINT64_MAX)
-            result->min_latency_ns = 0;
-    } else {
-        result->valid = false;
-        result->passed = false;
-        if (result->error_msg[0] == '\0')
-            snprintf(result->error_msg, sizeof(result->error_msg), "No packets received");
+static void emb_drain_rx(struct emb_sched *sc, uint16_t port_id) {
+    int fd = g_sock_pool[port_id].fd;
+    uint8_t rx_buf[2048];
+    char ctrl_buf[1024];
+
+    for (;;) {
+        struct msghdr msg = {0};
+        struct iovec iov = {rx_buf, sizeof(rx_buf)};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = ctrl_buf;
+        msg.msg_controllen = sizeof(ctrl_buf);
+
+        ssize_t len = recvmsg(fd, &msg, MSG_DONTWAIT);
+        if (len < 0) {
+            return;
+        }
+        uint64_t user_ts = get_time_ns();
+        if (len < 14) {
+            continue;
+        }
+
+        uint16_t vl_id = ((uint16_t)rx_buf[4] << 8) | rx_buf[5];
+        int r = sc->vl_result[vl_id];
+        if (r < 0 || sc->pairs[sc->result_pair[r]].rx_port != port_id) {
+            continue;
+        }
+
+        struct emb_latency_result *result = &sc->results[r];
+        if (!is_our_test_packet(rx_buf, len, result->vlan_id, result->vl_id)) {
+            continue;
+        }
+
+        // Seq: UDP header'dan sonra (VLAN switch'te soyulmuş olabilir)
+        uint16_t ether_type = ((uint16_t)rx_buf[12] << 8) | rx_buf[13];
+        size_t seq_off = (ether_type == ETH_P_8021Q) ? 14 + 4 + 20 + 8 : 14 + 20 + 8;
+        if ((size_t)len < seq_off + 8) {
+            continue;
+        }
+        uint64_t seq = 0;
+        for (int i = 0; i < 8; i++) {
+            seq = (seq << 8) | rx_buf[seq_off + i];
+        }
+        uint32_t pkt = (uint32_t)seq;
+        if ((seq >> 32) != result->vlan_id || pkt >= (uint32_t)sc->packet_count) {
+            continue;
+        }
+
+        const struct emb_pair_state *ps = &sc->ps[sc->result_pair[r]];
+        int vlan_pos = -1;
+        const struct emb_pair_cfg *pair = &sc->pairs[sc->result_pair[r]];
+        for (int v = 0; v < pair->vlan_count; v++) {
+            if (pair->vl_ids[v] == vl_id) {
+                vlan_pos = v;
+                break;
+            }
+        }
+        if (vlan_pos < 0) {
+            continue;
+        }
+
+        struct emb_probe *pr = &sc->probes[ps->first_probe + vlan_pos * sc->packet_count + (int)pkt];
+        if (pr->sent_ns == 0 || pr->rx_done || pr->finished) {
+            continue;  // Geç gelen / tekrar eden paket
+        }
+
+        if (g_pool_tier == EMB_TS_TIER_USER) {
+            pr->rx_ts = user_ts;
+        } else {
+            extract_timestamp(&msg, &pr->rx_ts);
+        }
+        pr->rx_done = true;
+        if (pr->tx_done) {
+            emb_probe_finish(sc, pr);
+        }
+    }
+}
+
+/**
+ * Timeout kontrolü; probe açık kalırsa sonraki ilgili anı *next'e yaz
+ */
+static void emb_probe_check(struct emb_sched *sc, struct emb_probe *pr,
+                            uint64_t now, uint64_t *next) {
+    if (pr->finished || pr->sent_ns == 0) {
+        return;
     }
 
-    return result->passed ? 0 : 1;
+    uint64_t rx_deadline = pr->sent_ns + (uint64_t)sc->timeout_ms * 1000000ULL;
+    uint64_t tx_deadline = pr->sent_ns + (uint64_t)EMB_TX_TS_TIMEOUT_MS * 1000000ULL;
+
+    if (!pr->tx_done && now >= tx_deadline) {
+        pr->tx_done = true;  // TX timestamp yok, latency hesaplanamaz
+    }
+
+    if ((pr->rx_done && pr->tx_done) || (!pr->rx_done && now >= rx_deadline)) {
+        emb_probe_finish(sc, pr);
+        return;
+    }
+
+    uint64_t deadline = pr->rx_done ? tx_deadline : rx_deadline;
+    if (deadline < *next) {
+        *next = deadline;
+    }
+}
+
+/**
+ * Çiftleri paralel test et
+ *
+ * Soket açılamayan çift eski davranıştaki gibi atlanır (sonuç üretmez).
+ *
+ * @return Yazılan sonuç sayısı
+ */
+static int run_parallel_test(const struct emb_pair_cfg *pairs, size_t pair_count,
+                             int packet_count, int timeout_ms,
+                             uint64_t max_latency_ns,
+                             struct emb_latency_result *results) {
+    struct emb_sched *sc = calloc(1, sizeof(*sc));
+    struct emb_pair_state ps[EMB_LAT_MAX_PORT_PAIRS];
+    int result_pair[EMB_LAT_MAX_RESULTS];
+    int open_probes[EMB_LAT_MAX_RESULTS];
+    uint64_t total_latency[EMB_LAT_MAX_RESULTS];
+
+    if (sc == NULL) {
+        fprintf(stderr, "ERROR: Cannot allocate latency scheduler\n");
+        return 0;
+    }
+    if (pair_count > EMB_LAT_MAX_PORT_PAIRS) {
+        pair_count = EMB_LAT_MAX_PORT_PAIRS;
+    }
+    if (packet_count < 1) {
+        packet_count = 1;
+    }
+
+    sc->pairs = pairs;
+    sc->ps = ps;
+    sc->results = results;
+    sc->result_pair = result_pair;
+    sc->open_probes = open_probes;
+    sc->total_latency = total_latency;
+    sc->packet_count = packet_count;
+    sc->timeout_ms = timeout_ms;
+    sc->max_latency_ns = max_latency_ns;
+    memset(sc->key_probe, 0xff, sizeof(sc->key_probe));
+
+    sc->vl_result = malloc(65536 * sizeof(int16_t));
+    sc->probes = calloc((size_t)EMB_LAT_MAX_RESULTS * packet_count, sizeof(struct emb_probe));
+    if (sc->vl_result == NULL || sc->probes == NULL) {
+        fprintf(stderr, "ERROR: Cannot allocate latency scheduler\n");
+        free(sc->vl_result);
+        free(sc->probes);
+        free(sc);
+        return 0;
+    }
+    memset(sc->vl_result, 0xff, 65536 * sizeof(int16_t));
+
+    // Sonuç ve probe düzeni: çift sırası, VLAN sırası, paket sırası
+    int result_idx = 0;
+    int probe_count = 0;
+
+    for (size_t p = 0; p < pair_count; p++) {
+        const struct emb_pair_cfg *pair = &pairs[p];
+        struct emb_pair_state *st = &ps[p];
+
+        memset(st, 0, sizeof(*st));
+        st->tx_fd = emb_pool_fd(pair->tx_port);
+        st->rx_fd = emb_pool_fd(pair->rx_port);
+        st->first_probe = st->end_probe = st->next_probe = st->done_probe = probe_count;
+
+        printf("Testing port pair: Port %d (%s) -> Port %d (%s)\n",
+               pair->tx_port, pair->tx_iface, pair->rx_port, pair->rx_iface);
+
+        if (st->tx_fd < 0 || st->rx_fd < 0) {
+            fprintf(stderr, "ERROR: Cannot create sockets for %s/%s\n",
+                    pair->tx_iface, pair->rx_iface);
+            continue;
+        }
+
+        for (int v = 0; v < pair->vlan_count && result_idx < EMB_LAT_MAX_RESULTS; v++) {
+            struct emb_latency_result *result = &results[result_idx];
+
+            memset(result, 0, sizeof(*result));
+            result->tx_port = pair->tx_port;
+            result->rx_port = pair->rx_port;
+            result->vlan_id = pair->vlans[v];
+            result->vl_id = pair->vl_ids[v];
+            result->min_latency_ns = UINT64_MAX;
+            result->ts_tier = (uint8_t)g_pool_tier;
+
+            sc->vl_result[pair->vl_ids[v]] = (int16_t)result_idx;
+            result_pair[result_idx] = (int)p;
+            open_probes[result_idx] = packet_count;
+            total_latency[result_idx] = 0;
+
+            for (int k = 0; k < packet_count; k++) {
+                sc->probes[probe_count].result_idx = result_idx;
+                sc->probes[probe_count].pair_idx = (int)p;
+                probe_count++;
+            }
+            result_idx++;
+        }
+        st->end_probe = probe_count;
+    }
+    sc->remaining = probe_count;
+
+    emb_sock_pool_flush();
+
+    // Pool soketleri (port başına bir pollfd)
+    struct pollfd pfds[EMB_LAT_MAX_PORTS];
+    uint16_t pfd_port[EMB_LAT_MAX_PORTS];
+    int nfds = 0;
+    for (uint16_t port = 0; port < EMB_LAT_MAX_PORTS; port++) {
+        if (g_sock_pool[port].fd >= 0) {
+            pfds[nfds].fd = g_sock_pool[port].fd;
+            pfds[nfds].events = POLLIN;
+            pfd_port[nfds] = port;
+            nfds++;
+        }
+    }
+
+    while (sc->remaining > 0) {
+        uint64_t now = get_time_ns();
+        uint64_t next = UINT64_MAX;
+
+        for (size_t p = 0; p < pair_count; p++) {
+            struct emb_pair_state *st = &ps[p];
+
+            emb_send_due(sc, (int)p, now);
+
+            for (int q = st->done_probe; q < st->next_probe; q++) {
+                emb_probe_check(sc, &sc->probes[q], now, &next);
+            }
+            while (st->done_probe < st->next_probe && sc->probes[st->done_probe].finished) {
+                st->done_probe++;
+            }
+
+            if (st->next_probe < st->end_probe && st->inflight < EMB_LAT_MAX_INFLIGHT &&
+                st->next_send_ns < next) {
+                next = st->next_send_ns;
+            }
+        }
+
+        if (sc->remaining == 0) {
+            break;
+        }
+
+        // next yoksa sadece tskey halkası bekleniyor: 1ms sonra tekrar bak
+        uint64_t wait_ns = (next == UINT64_MAX) ? 1000000ULL : (next > now ? next - now : 0);
+        struct timespec ts = {
+            .tv_sec = (time_t)(wait_ns / 1000000000ULL),
+            .tv_nsec = (long)(wait_ns % 1000000000ULL)
+        };
+
+        int n = ppoll(pfds, nfds, &ts, NULL);
+        if (n <= 0) {
+            continue;  // Timeout veya EINTR
+        }
+
+        for (int i = 0; i < nfds; i++) {
+            if (pfds[i].revents & POLLERR) {
+                emb_drain_errqueue(sc, pfd_port[i]);
+            }
+            if (pfds[i].revents & POLLIN) {
+                emb_drain_rx(sc, pfd_port[i]);
+            }
+        }
+    }
+
+    free(sc->vl_result);
+    free(sc->probes);
+    free(sc);
+
+    return result_idx;
 }
 
 // ============================================
@@ -535,52 +1090,23 @@ int emb_latency_run(int packet_count, int timeout_ms, int max_latency_us) {
 
     uint64_t max_latency_ns = (uint64_t)max_latency_us * 1000;
     uint64_t start_time = get_time_ns();
-    int result_idx = 0;
 
-    // Test each port pair
-    for (size_t p = 0; p < NUM_PORT_PAIRS; p++) {
-        printf("Testing port pair: Port %d (%s) -> Port %d (%s)\n",
-               PORT_PAIRS[p].tx_port, PORT_PAIRS[p].tx_iface,
-               PORT_PAIRS[p].rx_port, PORT_PAIRS[p].rx_iface);
+    bool own_pool = emb_sock_pool_acquire();
 
-        // Create sockets (TX and RX separately)
-        int tx_ifindex, rx_ifindex;
-        int tx_fd = create_raw_socket(PORT_PAIRS[p].tx_iface, &tx_ifindex, EMB_SOCK_TX);
-        int rx_fd = create_raw_socket(PORT_PAIRS[p].rx_iface, &rx_ifindex, EMB_SOCK_RX);
+    // Test all port pairs concurrently
+    int result_idx = run_parallel_test(PORT_PAIRS, NUM_PORT_PAIRS, packet_count, timeout_ms,
+                                       max_latency_ns, g_emb_latency.results);
 
-        if (tx_fd < 0 || rx_fd < 0) {
-            fprintf(stderr, "ERROR: Cannot create sockets for %s/%s\n",
-                    PORT_PAIRS[p].tx_iface, PORT_PAIRS[p].rx_iface);
-            if (tx_fd >= 0) close(tx_fd);
-            if (rx_fd >= 0) close(rx_fd);
-            continue;
-        }
-
-        // Wait for sockets to fully initialize (critical for first packet!)
-        usleep(10000);  // 10ms
-
-        // Test each VLAN
-        for (int v = 0; v < PORT_PAIRS[p].vlan_count; v++) {
-            struct emb_latency_result *r = &g_emb_latency.results[result_idx];
-
-            run_single_test(tx_fd, rx_fd, tx_ifindex,
-                           PORT_PAIRS[p].tx_port, PORT_PAIRS[p].rx_port,
-                           PORT_PAIRS[p].vlans[v], PORT_PAIRS[p].vl_ids[v],
-                           packet_count, timeout_ms, max_latency_ns, r);
-
-            if (r->passed) {
-                g_emb_latency.passed_count++;
-            } else {
-                g_emb_latency.failed_count++;
-            }
-            result_idx++;
+    if (own_pool) {
+        emb_latency_close_sockets();
+    }
 
-            // Inter-VLAN delay
-            usleep(32);
+    for (int i = 0; i < result_idx; i++) {
+        if (g_emb_latency.results[i].passed) {
+            g_emb_latency.passed_count++;
+        } else {
+            g_emb_latency.failed_count++;
         }
-
-        close(tx_fd);
-        close(rx_fd);
     }
 
     // Finalize
@@ -666,49 +1192,25 @@ int emb_latency_run_loopback(int packet_count, int timeout_ms, int max_latency_u
 
     uint64_t max_latency_ns = (uint64_t)max_latency_us * 1000;
     uint64_t start_time = get_time_ns();
-    int result_idx = 0;
     int failed_count = 0;
     int passed_count = 0;
 
-    // Test each loopback port pair
-    for (size_t p = 0; p < NUM_LOOPBACK_PAIRS; p++) {
-        printf("Testing port pair: Port %d (%s) -> Port %d (%s)\n",
-               LOOPBACK_PAIRS[p].tx_port, LOOPBACK_PAIRS[p].tx_iface,
-               LOOPBACK_PAIRS[p].rx_port, LOOPBACK_PAIRS[p].rx_iface);
-
-        int tx_ifindex, rx_ifindex;
-        int tx_fd = create_raw_socket(LOOPBACK_PAIRS[p].tx_iface, &tx_ifindex, EMB_SOCK_TX);
-        int rx_fd = create_raw_socket(LOOPBACK_PAIRS[p].rx_iface, &rx_ifindex, EMB_SOCK_RX);
+    bool own_pool = emb_sock_pool_acquire();
 
-        if (tx_fd < 0 || rx_fd < 0) {
-            fprintf(stderr, "ERROR: Cannot create sockets\n");
-            if (tx_fd >= 0) close(tx_fd);
-            if (rx_fd >= 0) close(rx_fd);
-            continue;
-        }
+    // Test all loopback port pairs concurrently
+    int result_idx = run_parallel_test(LOOPBACK_PAIRS, NUM_LOOPBACK_PAIRS, packet_count, timeout_ms,
+                                       max_latency_ns, g_emb_latency.loopback_results);
 
-        // Wait for sockets to fully initialize
-        usleep(10000);  // 10ms
-
-        for (int v = 0; v < LOOPBACK_PAIRS[p].vlan_count; v++) {
-            struct emb_latency_result *r = &g_emb_latency.loopback_results[result_idx];
-
-            run_single_test(tx_fd, rx_fd, tx_ifindex,
-                           LOOPBACK_PAIRS[p].tx_port, LOOPBACK_PAIRS[p].rx_port,
-                           LOOPBACK_PAIRS[p].vlans[v], LOOPBACK_PAIRS[p].vl_ids[v],
-                           packet_count, timeout_ms, max_latency_ns, r);
+    if (own_pool) {
+        emb_latency_close_sockets();
+    }
 
-            if (r->passed) {
-                passed_count++;
-            } else {
-                failed_count++;
-            }
-            result_idx++;
-            usleep(32);
+    for (int i = 0; i < result_idx; i++) {
+        if (g_emb_latency.loopback_results[i].passed) {
+            passed_count++;
+        } else {
+            failed_count++;
         }
-
-        close(tx_fd);
-        close(rx_fd);
     }
 
     // Update loopback state
@@ -720,7 +1222,8 @@ int emb_latency_run_loopback(int packet_count, int timeout_ms, int max_latency_u
     // Print results table
     emb_latency_print_loopback();
 
-    printf("Loopback test complete: %d/%d passed\n\n", passed_count, result_idx);
+    printf("Loopback test complete: %d/%d passed (%.1f ms)\n\n", passed_count, result_idx,
+           (double)(get_time_ns() - start_time) / 1e6);
 
     return failed_count;
 }
@@ -741,49 +1244,25 @@ int emb_latency_run_unit_test(int packet_count, int timeout_ms, int max_latency_
 
     uint64_t max_latency_ns = (uint64_t)max_latency_us * 1000;
     uint64_t start_time = get_time_ns();
-    int result_idx = 0;
     int failed_count = 0;
     int passed_count = 0;
 
-    // Test each unit test port pair
-    for (size_t p = 0; p < NUM_UNIT_TEST_PAIRS; p++) {
-        printf("Testing port pair: Port %d (%s) -> Port %d (%s)\n",
-               UNIT_TEST_PAIRS[p].tx_port, UNIT_TEST_PAIRS[p].tx_iface,
-               UNIT_TEST_PAIRS[p].rx_port, UNIT_TEST_PAIRS[p].rx_iface);
-
-        int tx_ifindex, rx_ifindex;
-        int tx_fd = create_raw_socket(UNIT_TEST_PAIRS[p].tx_iface, &tx_ifindex, EMB_SOCK_TX);
-        int rx_fd = create_raw_socket(UNIT_TEST_PAIRS[p].rx_iface, &rx_ifindex, EMB_SOCK_RX);
+    bool own_pool = emb_sock_pool_acquire();
 
-        if (tx_fd < 0 || rx_fd < 0) {
-            fprintf(stderr, "ERROR: Cannot create sockets\n");
-            if (tx_fd >= 0) close(tx_fd);
-            if (rx_fd >= 0) close(rx_fd);
-            continue;
-        }
+    // Test all unit test port pairs concurrently
+    int result_idx = run_parallel_test(UNIT_TEST_PAIRS, NUM_UNIT_TEST_PAIRS, packet_count, timeout_ms,
+                                       max_latency_ns, g_emb_latency.unit_results);
 
-        // Wait for sockets to fully initialize
-        usleep(10000);  // 10ms
-
-        for (int v = 0; v < UNIT_TEST_PAIRS[p].vlan_count; v++) {
-            struct emb_latency_result *r = &g_emb_latency.unit_results[result_idx];
-
-            run_single_test(tx_fd, rx_fd, tx_ifindex,
-                           UNIT_TEST_PAIRS[p].tx_port, UNIT_TEST_PAIRS[p].rx_port,
-                           UNIT_TEST_PAIRS[p].vlans[v], UNIT_TEST_PAIRS[p].vl_ids[v],
-                           packet_count, timeout_ms, max_latency_ns, r);
+    if (own_pool) {
+        emb_latency_close_sockets();
+    }
 
-            if (r->passed) {
-                passed_count++;
-            } else {
-                failed_count++;
-            }
-            result_idx++;
-            usleep(32);
+    for (int i = 0; i < result_idx; i++) {
+        if (g_emb_latency.unit_results[i].passed) {
+            passed_count++;
+        } else {
+            failed_count++;
         }
-
-        close(tx_fd);
-        close(rx_fd);
     }
 
     // Update unit test state
@@ -794,7 +1273,8 @@ int emb_latency_run_unit_test(int packet_count, int timeout_ms, int max_latency_
     // Print results table
     emb_latency_print_unit();
 
-    printf("Unit test complete: %d/%d passed\n\n", passed_count, result_idx);
+    printf("Unit test complete: %d/%d passed (%.1f ms)\n\n", passed_count, result_idx,
+           (double)(get_time_ns() - start_time) / 1e6);
 
     return failed_count;
 }
@@ -898,6 +1378,9 @@ int emb_latency_full_sequence(void) {
     // Reset state
     memset(&g_emb_latency, 0, sizeof(g_emb_latency));
 
+    // Sockets are opened once and shared by the loopback and unit phases
+    bool own_pool = emb_sock_pool_acquire();
+
     // ==========================================
     // STEP 1: Loopback Test (OPTIONAL)
     // ==========================================
@@ -942,6 +1425,10 @@ int emb_latency_full_sequence(void) {
     int unit_fails = emb_latency_run_unit_test(1, 100, 100);  // 1 packet, 100ms timeout, 100us max
     total_fails += unit_fails;
 
+    if (own_pool) {
+        emb_latency_close_sockets();
+    }
+
     // ==========================================
     // STEP 3: Calculate Combined Results
     // ==========================================
@@ -1151,7 +1638,14 @@ static void print_results_table(const char *title, struct emb_latency_result *re
 }
 
 void emb_latency_print(void) {
-    print_results_table("LATENCY TEST RESULTS (Timestamp: HARDWARE NIC)",
+    static const char *titles[] = {
+        "LATENCY TEST RESULTS (Timestamp: HARDWARE NIC)",
+        "LATENCY TEST RESULTS (Timestamp: KERNEL SOFTWARE)",
+        "LATENCY TEST RESULTS (Timestamp: USER SPACE)"
+    };
+    emb_ts_tier_t tier = g_emb_latency.result_count > 0 ?
+                         (emb_ts_tier_t)g_emb_latency.results[0].ts_tier : EMB_TS_TIER_HW;
+    print_results_table(titles[tier <= EMB_TS_TIER_USER ? tier : EMB_TS_TIER_HW],
                         g_emb_latency.results, g_emb_latency.result_count);
 }
 
@@ -23,6 +23,8 @@ extern "C" {
 // ============================================
 #define EMB_LAT_MAX_RESULTS     64      // Maximum VLAN results
 #define EMB_LAT_MAX_PORT_PAIRS  8       // Maximum port pairs
+#define EMB_LAT_MAX_PORTS       8       // Socket pool size (port ID = index)
+#define EMB_LAT_MAX_INFLIGHT    4       // Per-pair probes awaiting RX at once
 #define EMB_LAT_DEFAULT_SWITCH_US 14.0  // Default Mellanox switch latency (microseconds)
 
 // ============================================
@@ -33,6 +35,18 @@ typedef enum {
     EMB_TEST_UNIT           // Unit test (total latency through device)
 } emb_test_type_t;
 
+// ============================================
+// TIMESTAMP TIERS
+// ============================================
+// PTP'siz NIC'lerde HW -> kernel SW -> user-space saat sırasıyla düşülür.
+// Pool'daki tüm soketler aynı (en kötü) tier'da çalışır; tier'lar arası
+// sonuçlar karşılaştırılamaz.
+typedef enum {
+    EMB_TS_TIER_HW = 0,     // NIC hardware timestamp
+    EMB_TS_TIER_SW,         // Kernel software timestamp (sürücü/stack)
+    EMB_TS_TIER_USER        // sendto/recvmsg çevresinde CLOCK_MONOTONIC
+} emb_ts_tier_t;
+
 // ============================================
 // RESULT STRUCTURE (per VLAN)
 // ============================================
@@ -52,6 +66,7 @@ struct emb_latency_result {
     bool     valid;             // Valid result?
     bool     passed;            // Latency threshold passed?
     char     error_msg[64];     // Error message
+    uint8_t  ts_tier;           // emb_ts_tier_t
 };
 
 // ============================================
@@ -188,6 +203,13 @@ void emb_latency_calculate_combined(void);
  */
 int emb_latency_full_sequence(void);
 
+/**
+ * Close the shared socket pool
+ * Test functions open the pool on demand and close it when they opened it
+ * themselves; call this only after keeping it open across several runs.
+ */
+void emb_latency_close_sockets(void);
+
 /**
  * Check if test completed
  */
@@ -10,6 +10,7 @@
 #include "tx_rx_manager.h"  // rx_stats_per_port için
 #include "dpdk_external_tx.h" // External TX stats için
 #include "raw_socket_port.h"  // reset_raw_socket_stats için
+#include "stats_service.h"
 
 // Daemon mode flag - when true, ANSI escape codes are disabled
 bool g_daemon_mode = false;
@@ -18,20 +19,11 @@ void helper_set_daemon_mode(bool enabled) {
     g_daemon_mode = enabled;
 }
 
-// Yardımcı fonksiyonlar
-static inline double to_gbps(uint64_t bytes) {
-    return (bytes * 8.0) / 1e9;
-}
-
-void helper_reset_stats(const struct ports_config *ports_config,
-                        uint64_t prev_tx_bytes[], uint64_t prev_rx_bytes[])
+void helper_reset_stats(const struct ports_config *ports_config)
 {
-    // HW istatistiklerini resetle ve prev_* sayaçlarını sıfırla
+    // HW istatistiklerini resetle (stats servisi sonraki görüntüde hızı 0 kabul eder)
     for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
-        uint16_t port_id = ports_config->ports[i].port_id;
-        rte_eth_stats_reset(port_id);
-        prev_tx_bytes[port_id] = 0;
-        prev_rx_bytes[port_id] = 0;
+        rte_eth_stats_reset(ports_config->ports[i].port_id);
     }
 
     // RX doğrulama istatistikleri (PRBS) sıfırla
@@ -41,8 +33,7 @@ void helper_reset_stats(const struct ports_config *ports_config,
     reset_raw_socket_stats();
 }
 
-void helper_print_stats(const struct ports_config *ports_config,
-                        const uint64_t prev_tx_bytes[], const uint64_t prev_rx_bytes[],
+void helper_print_stats(const struct stats_snapshot *snap,
                         bool warmup_complete, unsigned loop_count, unsigned test_time)
 {
     // Ekranı temizle (sadece interaktif modda, daemon modda log dosyası için devre dışı)
@@ -71,83 +62,53 @@ void helper_print_stats(const struct ports_config *ports_config,
     printf("│      │       Packets       │        Bytes        │          Gbps           │       Packets       │        Bytes        │          Gbps           │        Good         │         Bad         │        Lost         │      Bit Error      │     BER     │\n");
     printf("├──────┼─────────────────────┼─────────────────────┼─────────────────────────┼─────────────────────┼─────────────────────┼─────────────────────────┼─────────────────────┼─────────────────────┼─────────────────────┼─────────────────────┼─────────────┤\n");
 
-    struct rte_eth_stats st;
-
-    for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
-        uint16_t port_id = ports_config->ports[i].port_id;
+    for (uint16_t i = 0; i < snap->nb_ports; i++) {
+        const struct stats_port_snapshot *p = &snap->ports[i];
 
-        if (rte_eth_stats_get(port_id, &st) != 0) {
-            printf("│  %2u  │         N/A         │         N/A         │           N/A           │         N/A         │         N/A         │           N/A           │         N/A         │         N/A         │         N/A         │         N/A         │     N/A     │\n", port_id);
+        if (!p->hw_valid) {
+            printf("│  %2u  │         N/A         │         N/A         │           N/A           │         N/A         │         N/A         │           N/A           │         N/A         │         N/A         │         N/A         │         N/A         │     N/A     │\n", p->port_id);
             continue;
         }
 
-        // HW istatistikleri
-        uint64_t tx_pkts = st.opackets;
-        uint64_t tx_bytes = st.obytes;
-        uint64_t rx_pkts = st.ipackets;
-        uint64_t rx_bytes = st.ibytes;
-
-        // Per-second rate hesaplama
-        uint64_t tx_bytes_delta = tx_bytes - prev_tx_bytes[port_id];
-        uint64_t rx_bytes_delta = rx_bytes - prev_rx_bytes[port_id];
-        double tx_gbps = to_gbps(tx_bytes_delta);
-        double rx_gbps = to_gbps(rx_bytes_delta);
-
-        // PRBS doğrulama istatistikleri
-        uint64_t good = rte_atomic64_read(&rx_stats_per_port[port_id].good_pkts);
-        uint64_t bad = rte_atomic64_read(&rx_stats_per_port[port_id].bad_pkts);
-        uint64_t lost = rte_atomic64_read(&rx_stats_per_port[port_id].lost_pkts);
-        uint64_t bit_errors = rte_atomic64_read(&rx_stats_per_port[port_id].bit_errors);
-
-        // Bit Error Rate (BER) hesaplama
-        double ber = 0.0;
-        uint64_t total_bits = rx_bytes * 8;
-        if (total_bits > 0) {
-            ber = (double)bit_errors / (double)total_bits;
-        }
-
         // Tabloyu yazdır
         printf("│  %2u  │ %19lu │ %19lu │ %23.2f │ %19lu │ %19lu │ %23.2f │ %19lu │ %19lu │ %19lu │ %19lu │ %11.2e │\n",
-               port_id,
-               tx_pkts, tx_bytes, tx_gbps,
-               rx_pkts, rx_bytes, rx_gbps,
-               good, bad, lost, bit_errors, ber);
+               p->port_id,
+               p->tx_pkts, p->tx_bytes, p->tx_gbps,
+               p->rx_pkts, p->rx_bytes, p->rx_gbps,
+               p->good_pkts, p->bad_pkts, p->lost_pkts, p->bit_errors, p->ber);
     }
 
     printf("└──────┴─────────────────────┴─────────────────────┴─────────────────────────┴─────────────────────┴─────────────────────┴─────────────────────────┴─────────────────────┴─────────────────────┴─────────────────────┴─────────────────────┴─────────────┘\n");
 
     // Uyarılar
     bool has_warning = false;
-    for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
-        uint16_t port_id = ports_config->ports[i].port_id;
-
-        uint64_t bad_pkts = rte_atomic64_read(&rx_stats_per_port[port_id].bad_pkts);
-        uint64_t bit_errors = rte_atomic64_read(&rx_stats_per_port[port_id].bit_errors);
-        uint64_t lost_pkts = rte_atomic64_read(&rx_stats_per_port[port_id].lost_pkts);
+    for (uint16_t i = 0; i < snap->nb_ports; i++) {
+        const struct stats_port_snapshot *p = &snap->ports[i];
+        uint16_t port_id = p->port_id;
 
-        if (bad_pkts > 0 || bit_errors > 0 || lost_pkts > 0) {
+        if (p->bad_pkts > 0 || p->bit_errors > 0 || p->lost_pkts > 0) {
             if (!has_warning) {
                 printf("\n  UYARILAR:\n");
                 has_warning = true;
             }
-            if (bad_pkts > 0) {
-                printf("      Port %u: %lu bad paket tespit edildi!\n", port_id, bad_pkts);
+            if (p->bad_pkts > 0) {
+                printf("      Port %u: %lu bad paket tespit edildi!\n", port_id, p->bad_pkts);
             }
-            if (bit_errors > 0) {
-                printf("      Port %u: %lu bit hatası tespit edildi!\n", port_id, bit_errors);
+            if (p->bit_errors > 0) {
+                printf("      Port %u: %lu bit hatası tespit edildi!\n", port_id, p->bit_errors);
             }
-            if (lost_pkts > 0) {
-                printf("      Port %u: %lu kayıp paket tespit edildi!\n", port_id, lost_pkts);
+            if (p->lost_pkts > 0) {
+                printf("      Port %u: %lu kayıp paket tespit edildi!\n", port_id, p->lost_pkts);
             }
         }
 
         // HW missed packets kontrolü
-        if (rte_eth_stats_get(port_id, &st) == 0 && st.imissed > 0) {
+        if (p->hw_valid && p->rx_missed > 0) {
             if (!has_warning) {
                 printf("\n  UYARILAR:\n");
                 has_warning = true;
             }
-            printf("      Port %u: %lu paket donanım tarafından kaçırıldı (imissed)!\n", port_id, st.imissed);
+            printf("      Port %u: %lu paket donanım tarafından kaçırıldı (imissed)!\n", port_id, p->rx_missed);
         }
     }
 
@@ -0,0 +1,323 @@
+#include "latency_load.h"
+#include "latency_probe.h"
+#include "nic_clock.h"
+#include "packet.h"
+#include <stdio.h>
+#include <string.h>
+#include <rte_cycles.h>
+#include <rte_mbuf.h>
+
+#if LATENCY_LOAD_TEST_ENABLED
+
+struct latency_load_port latency_load_ports[RTE_MAX_ETHPORTS];
+
+enum latency_load_phase {
+    LL_IDLE,                    // init yapılmadı
+    LL_START,                   // İlk tick'te ilk seviyeye geçilir
+    LL_SETTLE,
+    LL_MEASURE,
+    LL_DRAIN,
+    LL_DONE
+};
+
+static const uint8_t load_levels[] = LATENCY_LOAD_LEVELS;
+#define LOAD_LEVEL_COUNT  RTE_MIN(RTE_DIM(load_levels), (size_t)LATENCY_LOAD_MAX_LEVELS)
+
+static enum latency_load_phase ll_phase = LL_IDLE;
+static uint32_t ll_level;
+static uint32_t ll_left;            // Fazın kalan tick sayısı
+static uint16_t ll_ports[RTE_MAX_ETHPORTS];
+static uint16_t ll_nb_ports;
+
+// ==========================================
+// INIT
+// ==========================================
+
+int latency_load_init(struct ports_config *ports_config)
+{
+    memset(latency_load_ports, 0, sizeof(latency_load_ports));
+    ll_nb_ports = 0;
+
+    printf("\n=== Latency Under Load: levels");
+    for (size_t i = 0; i < LOAD_LEVEL_COUNT; i++)
+        printf(" %u%%", load_levels[i]);
+    printf(" (settle %us, dwell %us, probe every %uus) ===\n",
+           LATENCY_LOAD_SETTLE_SEC, LATENCY_LOAD_DWELL_SEC, LATENCY_LOAD_PROBE_US);
+
+    for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
+        uint16_t port_id = ports_config->ports[i].port_id;
+        struct latency_load_port *lp = &latency_load_ports[port_id];
+
+        lp->gap_scale_q16 = LATENCY_LOAD_SCALE_ONE;
+
+        if (!ports_config->ports[i].is_valid || port_id >= port_vlans_count ||
+            port_vlans[port_id].tx_vlan_count == 0)
+            continue;
+
+        // start_txrx_workers ile aynı eşleme
+        lp->rx_port = (port_id % 2 == 0) ? (uint16_t)(port_id + 1) : (uint16_t)(port_id - 1);
+        lp->probe_vl_id = latency_probe_vl_id(port_id, 0);
+        lp->probe_vlan = port_vlans[port_id].tx_vlans[0];
+        ll_ports[ll_nb_ports++] = port_id;
+
+        printf("  Port %u -> Port %u: probe VLAN %u, VL-ID %u (reserved)\n",
+               port_id, lp->rx_port, lp->probe_vlan, lp->probe_vl_id);
+    }
+
+    if (ll_nb_ports == 0 || LOAD_LEVEL_COUNT == 0) {
+        printf("  No port pairs / load levels, latency under load disabled\n");
+        ll_phase = LL_DONE;
+        return -1;
+    }
+
+    ll_phase = LL_START;
+    return 0;
+}
+
+// ==========================================
+// PHASES (main lcore)
+// ==========================================
+
+static void ll_start_level(uint32_t level)
+{
+    uint8_t pct = RTE_MIN(RTE_MAX(load_levels[level], LATENCY_LOAD_MIN_PCT), 100);
+    uint32_t scale = (uint32_t)(((uint64_t)LATENCY_LOAD_SCALE_ONE * 100) / pct);
+
+    for (uint16_t i = 0; i < ll_nb_ports; i++) {
+        struct latency_load_port *lp = &latency_load_ports[ll_ports[i]];
+        __atomic_store_n(&lp->level_tag, level + 1, __ATOMIC_RELEASE);
+        lp->gap_scale_q16 = scale;
+    }
+
+    printf("\n[LOAD] Level %u/%zu: %u%% of target rate, settling %us\n",
+           level + 1, LOAD_LEVEL_COUNT, pct, LATENCY_LOAD_SETTLE_SEC);
+    ll_level = level;
+    ll_phase = LL_SETTLE;
+    ll_left = LATENCY_LOAD_SETTLE_SEC;
+}
+
+static void ll_begin_measure(void)
+{
+    for (uint16_t i = 0; i < ll_nb_ports; i++) {
+        uint16_t port_id = ll_ports[i];
+        struct latency_load_port *lp = &latency_load_ports[port_id];
+
+        // Probe'lar kapalıyken sıfırla, yayın probing ile
+        lp->tx_count = 0;
+        lp->rx_count = 0;
+        lp->rx_hw_count = 0;
+        lp->sum_ns = 0;
+        lp->min_ns = UINT64_MAX;
+        lp->max_ns = 0;
+        memset(lp->hist, 0, sizeof(lp->hist));
+
+        struct rte_eth_stats st;
+        lp->obytes_start = (rte_eth_stats_get(port_id, &st) == 0) ? st.obytes : 0;
+        lp->measure_start_tsc = rte_rdtsc();
+
+        __atomic_store_n(&lp->probing, true, __ATOMIC_RELEASE);
+    }
+
+    ll_phase = LL_MEASURE;
+    ll_left = LATENCY_LOAD_DWELL_SEC;
+}
+
+static void ll_end_measure(void)
+{
+    uint64_t hz = rte_get_tsc_hz();
+
+    for (uint16_t i = 0; i < ll_nb_ports; i++) {
+        uint16_t port_id = ll_ports[i];
+        struct latency_load_port *lp = &latency_load_ports[port_id];
+        struct latency_load_point *pt = &lp->points[lp->point_count];
+
+        __atomic_store_n(&lp->probing, false, __ATOMIC_RELEASE);
+
+        // Rate ölçüm penceresi probe'larla aynı (drain hariç)
+        struct rte_eth_stats st;
+        uint64_t elapsed = rte_rdtsc() - lp->measure_start_tsc;
+        memset(pt, 0, sizeof(*pt));
+        if (rte_eth_stats_get(port_id, &st) == 0 && elapsed > 0)
+            pt->achieved_gbps = (double)(st.obytes - lp->obytes_start) * 8.0 *
+                                (double)hz / (double)elapsed / 1e9;
+    }
+
+    ll_phase = LL_DRAIN;
+    ll_left = 1;
+}
+
+static void ll_finish_level(void)
+{
+    for (uint16_t i = 0; i < ll_nb_ports; i++) {
+        struct latency_load_port *lp = &latency_load_ports[ll_ports[i]];
+        struct latency_load_point *pt = &lp->points[lp->point_count];
+
+        uint32_t rx = __atomic_load_n(&lp->rx_count, __ATOMIC_ACQUIRE);
+        pt->load_pct = RTE_MIN(RTE_MAX(load_levels[ll_level], LATENCY_LOAD_MIN_PCT), 100);
+        pt->tx_count = lp->tx_count;
+        pt->rx_count = rx;
+        pt->rx_hw = rx > 0 && lp->rx_hw_count == rx;
+        if (rx > 0) {
+            pt->min_ns = lp->min_ns;
+            pt->max_ns = lp->max_ns;
+            pt->avg_ns = lp->sum_ns / rx;
+            pt->p50_ns = lat_hist_percentile(lp->hist, rx, 0.50, lp->max_ns);
+            pt->p99_ns = lat_hist_percentile(lp->hist, rx, 0.99, lp->max_ns);
+            pt->p999_ns = lat_hist_percentile(lp->hist, rx, 0.999, lp->max_ns);
+        }
+        lp->point_count++;
+
+        printf("[LOAD] %u%%: Port %u -> %u  %.2f Gbps  RX/TX %u/%u  p50 %.2f us  p99 %.2f us\n",
+               pt->load_pct, ll_ports[i], lp->rx_port, pt->achieved_gbps,
+               pt->rx_count, pt->tx_count, pt->p50_ns / 1000.0, pt->p99_ns / 1000.0);
+    }
+}
+
+void latency_load_tick(void)
+{
+    switch (ll_phase) {
+    case LL_START:
+        ll_start_level(0);
+        break;
+
+    case LL_SETTLE:
+        if (--ll_left == 0)
+            ll_begin_measure();
+        break;
+
+    case LL_MEASURE:
+        if (--ll_left == 0)
+            ll_end_measure();
+        break;
+
+    case LL_DRAIN:
+        if (--ll_left > 0)
+            break;
+        ll_finish_level();
+        if (ll_level + 1 < LOAD_LEVEL_COUNT) {
+            ll_start_level(ll_level + 1);
+        } else {
+            for (uint16_t i = 0; i < ll_nb_ports; i++)
+                latency_load_ports[ll_ports[i]].gap_scale_q16 = LATENCY_LOAD_SCALE_ONE;
+            ll_phase = LL_DONE;
+            printf("\n[LOAD] Sweep complete, traffic back to 100%% of target rate\n");
+            latency_load_print();
+        }
+        break;
+
+    case LL_IDLE:
+    case LL_DONE:
+        break;
+    }
+}
+
+bool latency_load_done(void)
+{
+    return ll_phase == LL_IDLE || ll_phase == LL_DONE;
+}
+
+// ==========================================
+// WORKER HOOKS
+// ==========================================
+
+void latency_load_send_probe(struct tx_worker_params *params, uint64_t now)
+{
+    uint16_t port_id = params->port_id;
+    struct latency_load_port *lp = &latency_load_ports[port_id];
+
+    lp->next_probe_tsc = now + rte_get_tsc_hz() / 1000000 * LATENCY_LOAD_PROBE_US;
+
+    uint32_t tag = __atomic_load_n(&lp->level_tag, __ATOMIC_ACQUIRE);
+    uint64_t seq = ((uint64_t)tag << 32) | lp->probe_seq;
+    struct rte_mbuf *m = latency_probe_take(port_id, params->queue_id, 0, seq, rte_rdtsc());
+    if (unlikely(m == NULL))
+        return;
+    lp->probe_seq++;
+
+    if (rte_eth_tx_burst(port_id, params->queue_id, &m, 1) == 0) {
+        rte_pktmbuf_free(m);
+        return;
+    }
+    lp->tx_count++;
+}
+
+void latency_load_rx_probe(uint16_t port_id, uint16_t src_port_id,
+                           const struct rte_mbuf *m, uint32_t payload_off)
+{
+    struct latency_load_port *lp = &latency_load_ports[src_port_id];
+
+    bool rx_hw;
+    uint64_t rx_tsc = nic_clock_rx_tsc(port_id, m, rte_rdtsc(), &rx_hw);
+
+    if (m->pkt_len < payload_off + LATENCY_PAYLOAD_OFFSET)
+        return;
+
+    const uint8_t *payload = rte_pktmbuf_mtod(m, const uint8_t *) + payload_off;
+    uint64_t seq = *(const uint64_t *)payload;
+    uint64_t tx_tsc = *(const uint64_t *)(payload + SEQ_BYTES);
+
+    // Önceki seviyeden geç kalan probe
+    if ((uint32_t)(seq >> 32) != __atomic_load_n(&lp->level_tag, __ATOMIC_ACQUIRE) ||
+        rx_tsc <= tx_tsc)
+        return;
+
+    uint64_t ns = (rx_tsc - tx_tsc) * 1000000000ULL / rte_get_tsc_hz();
+
+    __atomic_fetch_add(&lp->hist[lat_hist_bucket(ns)], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&lp->sum_ns, ns, __ATOMIC_RELAXED);
+    if (rx_hw)
+        __atomic_fetch_add(&lp->rx_hw_count, 1, __ATOMIC_RELAXED);
+
+    uint64_t cur = __atomic_load_n(&lp->min_ns, __ATOMIC_RELAXED);
+    while (ns < cur && !__atomic_compare_exchange_n(&lp->min_ns, &cur, ns, false,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+    cur = __atomic_load_n(&lp->max_ns, __ATOMIC_RELAXED);
+    while (ns > cur && !__atomic_compare_exchange_n(&lp->max_ns, &cur, ns, false,
+                                                    __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+        ;
+
+    // Sayaç en son: ana thread rx_count'u görünce histogram tamam
+    __atomic_fetch_add(&lp->rx_count, 1, __ATOMIC_RELEASE);
+}
+
+// ==========================================
+// REPORT
+// ==========================================
+
+void latency_load_print(void)
+{
+    printf("\n=== LATENCY UNDER LOAD (probe latency vs background load) ===\n");
+
+    for (uint16_t i = 0; i < ll_nb_ports; i++) {
+        uint16_t port_id = ll_ports[i];
+        const struct latency_load_port *lp = &latency_load_ports[port_id];
+        if (lp->point_count == 0)
+            continue;
+
+        printf("\nPort %u -> Port %u (VL-ID %u, target %.2f Gbps)\n",
+               port_id, lp->rx_port, lp->probe_vl_id, GET_PORT_TARGET_GBPS(port_id));
+        printf("%6s %9s %11s %9s %9s %9s %9s %9s %9s %4s\n",
+               "Load", "Gbps", "RX/TX", "Min(us)", "Avg", "p50", "p99", "p99.9", "Max", "RX");
+
+        for (uint16_t l = 0; l < lp->point_count; l++) {
+            const struct latency_load_point *pt = &lp->points[l];
+            char rxtx[24];
+            snprintf(rxtx, sizeof(rxtx), "%u/%u", pt->rx_count, pt->tx_count);
+
+            if (pt->rx_count == 0) {
+                printf("%5u%% %9.2f %11s %9s %9s %9s %9s %9s %9s %4s\n",
+                       pt->load_pct, pt->achieved_gbps, rxtx, "-", "-", "-", "-", "-", "-", "-");
+                continue;
+            }
+            printf("%5u%% %9.2f %11s %9.2f %9.2f %9.2f %9.2f %9.2f %9.2f %4s\n",
+                   pt->load_pct, pt->achieved_gbps, rxtx,
+                   pt->min_ns / 1000.0, pt->avg_ns / 1000.0, pt->p50_ns / 1000.0,
+                   pt->p99_ns / 1000.0, pt->p999_ns / 1000.0, pt->max_ns / 1000.0,
+                   pt->rx_hw ? "hw" : "sw");
+        }
+    }
+    printf("\n");
+}
+
+#endif /* LATENCY_LOAD_TEST_ENABLED */
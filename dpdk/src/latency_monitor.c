@@ -0,0 +1,329 @@
+#include "latency_monitor.h"
+#include "latency_probe.h"
+#include "nic_clock.h"
+#include "packet.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <rte_cycles.h>
+#include <rte_malloc.h>
+#include <rte_mbuf.h>
+
+#if LATENCY_MONITOR_ENABLED
+
+struct latency_monitor_port latency_monitor_ports[RTE_MAX_ETHPORTS];
+struct latency_monitor_vlan *latency_monitor_vlans;
+uint16_t latency_monitor_nb_vlans;
+
+static uint64_t mon_interval_start_tsc;     // 0 = ilk tick'te başlar
+static uint32_t mon_interval_seq;           // Tamamlanan interval (servis thread'i yazar)
+static uint32_t mon_printed_seq;            // Ana döngünün son bastığı
+
+// ==========================================
+// INIT
+// ==========================================
+
+int latency_monitor_init(struct ports_config *ports_config)
+{
+    memset(latency_monitor_ports, 0, sizeof(latency_monitor_ports));
+    latency_monitor_nb_vlans = 0;
+    mon_interval_start_tsc = 0;
+    mon_interval_seq = mon_printed_seq = 0;
+
+    printf("\n=== Latency Monitor: probe every %uus per port, interval %us, drift %u%%, step %u%% ===\n",
+           LATENCY_MONITOR_PROBE_US, LATENCY_MONITOR_INTERVAL_SEC,
+           LATENCY_MONITOR_DRIFT_PCT, LATENCY_MONITOR_STEP_PCT);
+
+    if (!latency_probe_vl_reserved) {
+        // Probe VL-ID'si normal trafikle aynı olur, ayrılamaz
+        printf("  Probe VL-IDs not reserved, latency monitor disabled\n");
+        return -1;
+    }
+
+    latency_monitor_vlans = rte_zmalloc("latency_monitor",
+                                        LATENCY_MONITOR_MAX_VLANS * sizeof(*latency_monitor_vlans),
+                                        RTE_CACHE_LINE_SIZE);
+    if (latency_monitor_vlans == NULL) {
+        printf("  Cannot allocate VLAN table, latency monitor disabled\n");
+        return -1;
+    }
+
+    for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
+        uint16_t port_id = ports_config->ports[i].port_id;
+        struct latency_monitor_port *mp = &latency_monitor_ports[port_id];
+
+        if (!ports_config->ports[i].is_valid || port_id >= port_vlans_count ||
+            port_vlans[port_id].tx_vlan_count == 0)
+            continue;
+
+        // start_txrx_workers ile aynı eşleme
+        uint16_t rx_port = (port_id % 2 == 0) ? (uint16_t)(port_id + 1) : (uint16_t)(port_id - 1);
+        uint16_t count = RTE_MIN(port_vlans[port_id].tx_vlan_count, latency_probe_ports[port_id].vlan_count);
+        if (count > LATENCY_MONITOR_MAX_VLANS - latency_monitor_nb_vlans) {
+            printf("  Port %u: VLAN table full (%u), not monitored\n", port_id, LATENCY_MONITOR_MAX_VLANS);
+            continue;
+        }
+
+        mp->first = latency_monitor_nb_vlans;
+        for (uint16_t v = 0; v < count; v++) {
+            struct latency_monitor_vlan *mv = &latency_monitor_vlans[latency_monitor_nb_vlans++];
+            mv->tx_port = port_id;
+            mv->rx_port = rx_port;
+            mv->vlan_id = port_vlans[port_id].tx_vlans[v];
+            mv->vl_id = latency_probe_vl_id(port_id, v);
+            mv->vlan_idx = v;
+            if (mv->vl_id <= MAX_VL_ID)
+                mp->vl_to_vlan[mv->vl_id] = (uint8_t)(v + 1);
+        }
+        mp->vlan_count = count;
+
+        printf("  Port %u -> Port %u: %u VLANs, one probe per VLAN every %uus\n",
+               port_id, rx_port, count, LATENCY_MONITOR_PROBE_US * count);
+    }
+
+    if (latency_monitor_nb_vlans == 0) {
+        printf("  No TX VLANs, latency monitor disabled\n");
+        rte_free(latency_monitor_vlans);
+        latency_monitor_vlans = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void latency_monitor_cleanup(void)
+{
+    memset(latency_monitor_ports, 0, sizeof(latency_monitor_ports));
+    latency_monitor_nb_vlans = 0;
+    rte_free(latency_monitor_vlans);
+    latency_monitor_vlans = NULL;
+}
+
+// ==========================================
+// WORKER HOOKS
+// ==========================================
+
+void latency_monitor_send_probe(struct tx_worker_params *params, uint64_t now)
+{
+    uint16_t port_id = params->port_id;
+    struct latency_monitor_port *mp = &latency_monitor_ports[port_id];
+
+    mp->next_probe_tsc = now + rte_get_tsc_hz() / 1000000 * LATENCY_MONITOR_PROBE_US;
+
+    uint16_t v = mp->next_vlan;
+    mp->next_vlan = (uint16_t)(v + 1 == mp->vlan_count ? 0 : v + 1);
+
+    struct latency_monitor_vlan *mv = &latency_monitor_vlans[mp->first + v];
+    struct rte_mbuf *m = latency_probe_take(port_id, params->queue_id, mv->vlan_idx,
+                                            mp->seq, rte_rdtsc());
+    if (unlikely(m == NULL))
+        return;
+    mp->seq++;
+
+    if (rte_eth_tx_burst(port_id, params->queue_id, &m, 1) == 0) {
+        rte_pktmbuf_free(m);
+        return;
+    }
+    __atomic_store_n(&mv->tx_count, mv->tx_count + 1, __ATOMIC_RELAXED);
+}
+
+void latency_monitor_rx_probe(uint16_t port_id, uint16_t src_port_id, uint16_t vlan_idx,
+                              const struct rte_mbuf *m, uint32_t payload_off)
+{
+    const struct latency_monitor_port *mp = &latency_monitor_ports[src_port_id];
+    struct latency_monitor_vlan *mv = &latency_monitor_vlans[mp->first + vlan_idx];
+
+    bool rx_hw;
+    uint64_t rx_tsc = nic_clock_rx_tsc(port_id, m, rte_rdtsc(), &rx_hw);
+
+    if (m->pkt_len >= payload_off + LATENCY_PAYLOAD_OFFSET) {
+        const uint8_t *payload = rte_pktmbuf_mtod(m, const uint8_t *) + payload_off;
+        uint64_t tx_tsc = *(const uint64_t *)(payload + SEQ_BYTES);
+
+        if (rx_tsc > tx_tsc) {
+            uint64_t ns = (rx_tsc - tx_tsc) * 1000000000ULL / rte_get_tsc_hz();
+
+            __atomic_fetch_add(&mv->hist[lat_hist_bucket(ns)], 1, __ATOMIC_RELAXED);
+            uint64_t cur = __atomic_load_n(&mv->max_ns, __ATOMIC_RELAXED);
+            while (ns > cur && !__atomic_compare_exchange_n(&mv->max_ns, &cur, ns, false,
+                                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                ;
+        }
+    }
+
+    // Geçersiz zaman damgası da gelmiş sayılır (kayıp değil)
+    __atomic_fetch_add(&mv->rx_count, 1, __ATOMIC_RELEASE);
+}
+
+// ==========================================
+// INTERVAL (stats service thread)
+// ==========================================
+
+static int cmp_u32(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void mon_close_vlan(struct latency_monitor_vlan *mv, bool warmup_complete)
+{
+    struct latency_monitor_point *pt = &mv->point;
+
+    // TX önce: arada gönderilip gelen probe kayıp görünmesin. Histogram
+    // artışları rx_count'tan önce görünür
+    uint32_t tx = __atomic_load_n(&mv->tx_count, __ATOMIC_RELAXED);
+    uint32_t rx = __atomic_load_n(&mv->rx_count, __ATOMIC_ACQUIRE);
+
+    uint32_t delta[LAT_HIST_BUCKETS];
+    uint64_t samples = 0;
+    for (int b = 0; b < LAT_HIST_BUCKETS; b++) {
+        uint32_t cur = __atomic_load_n(&mv->hist[b], __ATOMIC_RELAXED);
+        delta[b] = cur - mv->prev_hist[b];
+        mv->prev_hist[b] = cur;
+        samples += delta[b];
+    }
+
+    // Max histogramdan sonra: okunan her örneği kapsar (yüzdelikler bununla kırpılır)
+    uint64_t max_ns = __atomic_exchange_n(&mv->max_ns, 0, __ATOMIC_RELAXED);
+
+    // Cevapsız probe'lar: iki sınırda da bekleyen kısım kayıp (gecikme
+    // interval'den çok kısa), sınırda uçuşta olanlar sonraki interval'de gelir
+    int64_t pending = mv->pending + (int64_t)(uint32_t)(tx - mv->prev_tx) -
+                      (int64_t)(uint32_t)(rx - mv->prev_rx);
+    int64_t lost = RTE_MAX(RTE_MIN(pending, mv->pending), (int64_t)0);
+    mv->pending = pending - lost;
+    mv->prev_rx = rx;
+    mv->prev_tx = tx;
+
+    pt->samples = (uint32_t)samples;
+    pt->lost = (uint32_t)lost;
+    pt->samples_total += samples;
+    pt->lost_total += pt->lost;
+    pt->p50_ns = pt->p99_ns = pt->max_ns = 0;
+    pt->flags = pt->lost > 0 ? LATENCY_MONITOR_FLAG_LOSS : 0;
+
+    if (samples == 0) {
+        pt->flags |= LATENCY_MONITOR_FLAG_NO_DATA;
+        return;
+    }
+
+    max_ns = RTE_MIN(max_ns, (uint64_t)UINT32_MAX);
+    pt->p50_ns = (uint32_t)lat_hist_percentile(delta, samples, 0.50, max_ns);
+    pt->p99_ns = (uint32_t)lat_hist_percentile(delta, samples, 0.99, max_ns);
+    pt->max_ns = (uint32_t)max_ns;
+
+    if (!warmup_complete) {
+        pt->flags |= LATENCY_MONITOR_FLAG_BASELINE;
+        return;
+    }
+
+    if (mv->baseline_ns == 0) {
+        pt->flags |= LATENCY_MONITOR_FLAG_BASELINE;
+        mv->base_p50[mv->base_count++] = pt->p50_ns;
+        if (mv->base_count == LATENCY_MONITOR_BASELINE_INTERVALS) {
+            uint32_t sorted[LATENCY_MONITOR_BASELINE_INTERVALS];
+            memcpy(sorted, mv->base_p50, sizeof(sorted));
+            qsort(sorted, LATENCY_MONITOR_BASELINE_INTERVALS, sizeof(sorted[0]), cmp_u32);
+            mv->baseline_ns = RTE_MAX(sorted[LATENCY_MONITOR_BASELINE_INTERVALS / 2], 1U);
+            printf("[MON] Port %u VLAN %u: baseline p50 = %.2f us\n",
+                   mv->tx_port, mv->vlan_id, mv->baseline_ns / 1000.0);
+        }
+    } else {
+        uint64_t limit = (uint64_t)mv->baseline_ns * (100 + LATENCY_MONITOR_DRIFT_PCT) / 100;
+        if (pt->p50_ns > limit) {
+            mv->drift_run++;
+        } else {
+            mv->drift_run = 0;
+            if (mv->drift_alarm)
+                printf("[MON] Port %u VLAN %u: drift cleared (p50 %.2f us)\n",
+                       mv->tx_port, mv->vlan_id, pt->p50_ns / 1000.0);
+            mv->drift_alarm = false;
+        }
+
+        if (mv->drift_run >= LATENCY_MONITOR_DRIFT_HOLD) {
+            pt->flags |= LATENCY_MONITOR_FLAG_DRIFT;
+            if (!mv->drift_alarm) {
+                printf("[MON] ALARM Port %u -> %u VLAN %u: p50 drift %.2f us -> %.2f us (+%.0f%%)\n",
+                       mv->tx_port, mv->rx_port, mv->vlan_id,
+                       mv->baseline_ns / 1000.0, pt->p50_ns / 1000.0,
+                       ((double)pt->p50_ns / mv->baseline_ns - 1.0) * 100.0);
+                pt->alarms++;
+            }
+            mv->drift_alarm = true;
+        }
+    }
+
+    if (mv->prev_p99 > 0 &&
+        pt->p99_ns > (uint64_t)mv->prev_p99 * (100 + LATENCY_MONITOR_STEP_PCT) / 100 &&
+        pt->p99_ns - mv->prev_p99 >= LATENCY_MONITOR_STEP_MIN_NS) {
+        pt->flags |= LATENCY_MONITOR_FLAG_STEP;
+        printf("[MON] ALARM Port %u -> %u VLAN %u: p99 step %.2f us -> %.2f us\n",
+               mv->tx_port, mv->rx_port, mv->vlan_id,
+               mv->prev_p99 / 1000.0, pt->p99_ns / 1000.0);
+        pt->alarms++;
+    }
+    mv->prev_p99 = pt->p99_ns;
+}
+
+void latency_monitor_tick(bool warmup_complete)
+{
+    if (latency_monitor_nb_vlans == 0)
+        return;
+
+    uint64_t now = rte_rdtsc();
+    if (mon_interval_start_tsc == 0) {
+        mon_interval_start_tsc = now;
+        return;
+    }
+    if (now - mon_interval_start_tsc < rte_get_tsc_hz() * LATENCY_MONITOR_INTERVAL_SEC)
+        return;
+    mon_interval_start_tsc = now;
+
+    for (uint16_t i = 0; i < latency_monitor_nb_vlans; i++)
+        mon_close_vlan(&latency_monitor_vlans[i], warmup_complete);
+
+    __atomic_store_n(&mon_interval_seq, mon_interval_seq + 1, __ATOMIC_RELEASE);
+}
+
+// ==========================================
+// REPORT
+// ==========================================
+
+void latency_monitor_print_stats(void)
+{
+    uint32_t seq = __atomic_load_n(&mon_interval_seq, __ATOMIC_ACQUIRE);
+    if (seq == mon_printed_seq)
+        return;
+    mon_printed_seq = seq;
+
+    printf("\n=== LATENCY MONITOR (last %us interval) ===\n", LATENCY_MONITOR_INTERVAL_SEC);
+    printf("%-12s %5s %6s %9s %7s %9s %9s %9s %6s %s\n",
+           "Path", "VLAN", "VL-ID", "Samples", "Lost", "p50(us)", "p99", "Max", "Alarm", "Flags");
+
+    for (uint16_t i = 0; i < latency_monitor_nb_vlans; i++) {
+        const struct latency_monitor_vlan *mv = &latency_monitor_vlans[i];
+        const struct latency_monitor_point *pt = &mv->point;
+        char path[16];
+        snprintf(path, sizeof(path), "P%u->P%u", mv->tx_port, mv->rx_port);
+
+        char flags[32];
+        snprintf(flags, sizeof(flags), "%s%s%s%s%s",
+                 (pt->flags & LATENCY_MONITOR_FLAG_DRIFT) ? "DRIFT " : "",
+                 (pt->flags & LATENCY_MONITOR_FLAG_STEP) ? "STEP " : "",
+                 (pt->flags & LATENCY_MONITOR_FLAG_LOSS) ? "LOSS " : "",
+                 (pt->flags & LATENCY_MONITOR_FLAG_NO_DATA) ? "NODATA " : "",
+                 (pt->flags & LATENCY_MONITOR_FLAG_BASELINE) ? "BASE" : "");
+
+        if (pt->samples == 0) {
+            printf("%-12s %5u %6u %9u %7u %9s %9s %9s %6u %s\n",
+                   path, mv->vlan_id, mv->vl_id, pt->samples, pt->lost,
+                   "-", "-", "-", pt->alarms, flags);
+            continue;
+        }
+        printf("%-12s %5u %6u %9u %7u %9.2f %9.2f %9.2f %6u %s\n",
+               path, mv->vlan_id, mv->vl_id, pt->samples, pt->lost,
+               pt->p50_ns / 1000.0, pt->p99_ns / 1000.0, pt->max_ns / 1000.0,
+               pt->alarms, flags);
+    }
+}
+
+#endif /* LATENCY_MONITOR_ENABLED */
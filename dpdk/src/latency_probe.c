@@ -0,0 +1,305 @@
+#include "latency_probe.h"
+#include "latency_load.h"
+#include "latency_monitor.h"
+#include <stdio.h>
+#include <string.h>
+#include <rte_cycles.h>
+#include <rte_ip.h>
+#include <rte_udp.h>
+
+#if LATENCY_TEST_ENABLED
+
+struct latency_probe_port latency_probe_ports[RTE_MAX_ETHPORTS];
+bool latency_probe_vl_reserved = false;
+
+#if VLAN_ENABLED
+#define PROBE_L2_LEN  (sizeof(struct rte_ether_hdr) + sizeof(struct vlan_hdr))
+#else
+#define PROBE_L2_LEN  sizeof(struct rte_ether_hdr)
+#endif
+#define PROBE_PAYLOAD_OFF  (PROBE_L2_LEN + sizeof(struct rte_ipv4_hdr) + sizeof(struct rte_udp_hdr))
+
+// ==========================================
+// TX: PREBUILT PROBE MBUFS
+// ==========================================
+
+static int probe_pool_init(uint16_t port_id)
+{
+    struct latency_probe_port *pp = &latency_probe_ports[port_id];
+    uint16_t vlan_count = RTE_MIN(port_vlans[port_id].tx_vlan_count, MAX_TX_VLANS_PER_PORT);
+    if (vlan_count == 0)
+        return 0;
+
+    int socket_id = rte_eth_dev_socket_id(port_id);
+    if (socket_id < 0)
+        socket_id = 0;
+
+    char pool_name[32];
+    snprintf(pool_name, sizeof(pool_name), "lat_probe_%u", port_id);
+    pp->pool = rte_pktmbuf_pool_create(pool_name, vlan_count * LATENCY_PROBE_DEPTH, 0, 0,
+                                       RTE_MBUF_DEFAULT_BUF_SIZE, socket_id);
+    if (!pp->pool) {
+        printf("  Port %u: Cannot create probe mbuf pool\n", port_id);
+        return -1;
+    }
+
+    for (uint16_t v = 0; v < vlan_count; v++) {
+        uint16_t vl_id = latency_probe_vl_id(port_id, v);
+        for (uint16_t d = 0; d < LATENCY_PROBE_DEPTH; d++) {
+            struct rte_mbuf *m = rte_pktmbuf_alloc(pp->pool);
+            if (!m) {
+                printf("  Port %u: Probe mbuf allocation failed\n", port_id);
+                return -1;
+            }
+            build_latency_test_packet(m, port_id, port_vlans[port_id].tx_vlans[v], vl_id, 0, 0);
+            pp->mbufs[v][d] = m;
+        }
+    }
+    pp->vlan_count = vlan_count;
+    return 0;
+}
+
+struct rte_mbuf *latency_probe_take(uint16_t port_id, uint16_t queue_id, uint16_t vlan_idx,
+                                    uint64_t seq, uint64_t tx_tsc)
+{
+    struct latency_probe_port *pp = &latency_probe_ports[port_id];
+    if (unlikely(vlan_idx >= pp->vlan_count))
+        return NULL;
+
+    struct rte_mbuf *m = NULL;
+    for (int attempt = 0; attempt < 2 && m == NULL; attempt++) {
+        for (uint16_t d = 0; d < LATENCY_PROBE_DEPTH; d++) {
+            uint8_t idx = (uint8_t)((pp->next[vlan_idx] + d) % LATENCY_PROBE_DEPTH);
+            struct rte_mbuf *c = pp->mbufs[vlan_idx][idx];
+            // refcnt 1: sadece bizim referansımız, PMD işini bitirmiş
+            if (rte_mbuf_refcnt_read(c) == 1) {
+                m = c;
+                pp->next[vlan_idx] = (uint8_t)((idx + 1) % LATENCY_PROBE_DEPTH);
+                break;
+            }
+        }
+        // Hepsi uçuşta: TX ring'deki tamamlanmış descriptor'ları geri al, bir kez daha dene
+        if (m == NULL && attempt == 0)
+            rte_eth_tx_done_cleanup(port_id, queue_id, 0);
+    }
+    if (unlikely(m == NULL)) {
+        pp->busy++;
+        return NULL;
+    }
+
+    uint8_t *payload = rte_pktmbuf_mtod_offset(m, uint8_t *, PROBE_PAYLOAD_OFF);
+    *(uint64_t *)payload = seq;
+    *(uint64_t *)(payload + SEQ_BYTES) = tx_tsc;
+    m->ol_flags = 0;
+    rte_mbuf_refcnt_update(m, 1);
+    return m;
+}
+
+// ==========================================
+// RX: FLOW RULES
+// ==========================================
+
+static void probe_flow_destroy(uint16_t port_id)
+{
+    struct latency_probe_port *pp = &latency_probe_ports[port_id];
+    struct rte_flow_error err;
+
+    for (uint16_t i = 0; i < pp->nb_flows; i++)
+        rte_flow_destroy(port_id, pp->flows[i], &err);
+    pp->nb_flows = 0;
+    pp->flow_active = false;
+}
+
+#if LATENCY_PROBE_FLOW_ENABLED
+static int probe_flow_add(uint16_t port_id, uint16_t vl_id)
+{
+    struct latency_probe_port *pp = &latency_probe_ports[port_id];
+    if (pp->nb_flows >= LATENCY_PROBE_MAX_FLOWS) {
+        printf("  Port %u: More than %u probe VL-IDs, flow table full\n",
+               port_id, LATENCY_PROBE_MAX_FLOWS);
+        return -1;
+    }
+
+    // DST MAC 03:00:00:00:VV:VV (VV = VL-ID), VLAN/IP alanlarına bakılmaz
+    struct rte_flow_attr attr = { .ingress = 1 };
+    struct rte_flow_item_eth eth_spec, eth_mask;
+    memset(&eth_spec, 0, sizeof(eth_spec));
+    memset(&eth_mask, 0, sizeof(eth_mask));
+    eth_spec.dst.addr_bytes[0] = 0x03;
+    eth_spec.dst.addr_bytes[4] = (uint8_t)(vl_id >> 8);
+    eth_spec.dst.addr_bytes[5] = (uint8_t)(vl_id & 0xFF);
+    memset(eth_mask.dst.addr_bytes, 0xFF, RTE_ETHER_ADDR_LEN);
+
+    struct rte_flow_item pattern[] = {
+        { .type = RTE_FLOW_ITEM_TYPE_ETH, .spec = &eth_spec, .mask = &eth_mask },
+        { .type = RTE_FLOW_ITEM_TYPE_END },
+    };
+    struct rte_flow_action_queue queue = { .index = LATENCY_PROBE_RX_QUEUE };
+    struct rte_flow_action actions[] = {
+        { .type = RTE_FLOW_ACTION_TYPE_QUEUE, .conf = &queue },
+        { .type = RTE_FLOW_ACTION_TYPE_END },
+    };
+
+    struct rte_flow_error err;
+    memset(&err, 0, sizeof(err));
+    struct rte_flow *flow = NULL;
+    if (rte_flow_validate(port_id, &attr, pattern, actions, &err) == 0)
+        flow = rte_flow_create(port_id, &attr, pattern, actions, &err);
+    if (!flow) {
+        printf("  Port %u: probe flow for VL-ID %u rejected (%s)\n",
+               port_id, vl_id, err.message ? err.message : "unknown");
+        return -1;
+    }
+
+    pp->flows[pp->nb_flows++] = flow;
+    return 0;
+}
+
+/**
+ * RX portunda tüm portların probe VL-ID'leri için kural kur (latency testi
+ * ve normal mod farklı port eşlemeleri kullanır; kaynak porta bakılmaz)
+ */
+static void probe_flow_init(struct ports_config *ports_config, uint16_t port_id)
+{
+    uint16_t added[LATENCY_PROBE_MAX_FLOWS];
+    uint16_t nb_added = 0;
+
+    for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
+        uint16_t src = ports_config->ports[i].port_id;
+        if (!ports_config->ports[i].is_valid || src >= port_vlans_count)
+            continue;
+
+        for (uint16_t v = 0; v < port_vlans[src].tx_vlan_count; v++) {
+            // Karar henüz verilmedi: kurallar ayrılacak VL-ID için kurulur
+            uint16_t vl_id = port_vlans[src].tx_vl_ids[v] + LATENCY_PROBE_VL_OFFSET;
+
+            // Aynı VL-ID'yi kullanan portlar için tek kural
+            bool dup = false;
+            for (uint16_t k = 0; k < nb_added && !dup; k++)
+                dup = (added[k] == vl_id);
+            if (dup)
+                continue;
+
+            if (probe_flow_add(port_id, vl_id) == 0) {
+                added[nb_added++] = vl_id;
+            } else {
+                probe_flow_destroy(port_id);
+                printf("  Port %u: probes stay on RSS queue 0\n", port_id);
+                return;
+            }
+        }
+    }
+
+    latency_probe_ports[port_id].flow_active = latency_probe_ports[port_id].nb_flows > 0;
+    if (latency_probe_ports[port_id].flow_active)
+        printf("  Port %u: %u probe VL-IDs -> RX queue %u (rte_flow)\n",
+               port_id, latency_probe_ports[port_id].nb_flows, LATENCY_PROBE_RX_QUEUE);
+}
+#endif /* LATENCY_PROBE_FLOW_ENABLED */
+
+// ==========================================
+// INIT / CLEANUP
+// ==========================================
+
+int latency_probe_init(struct ports_config *ports_config)
+{
+    int ret = 0;
+    bool any_flow = false;
+
+    printf("\n=== Latency Probe Path (%u prebuilt mbufs per VLAN) ===\n", LATENCY_PROBE_DEPTH);
+
+#if LATENCY_PROBE_FLOW_ENABLED
+    for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
+        uint16_t port_id = ports_config->ports[i].port_id;
+        if (!ports_config->ports[i].is_valid || port_id >= port_vlans_count)
+            continue;
+
+        probe_flow_init(ports_config, port_id);
+        any_flow |= latency_probe_ports[port_id].flow_active;
+    }
+#endif
+
+    // Kural yoksa VL-ID'yi sadece latency-under-load / monitor ayırt etsin diye ayır
+    latency_probe_vl_reserved = any_flow || LATENCY_LOAD_TEST_ENABLED || LATENCY_MONITOR_ENABLED;
+    if (latency_probe_vl_reserved)
+        printf("  Probe VL-ID: range offset %u (reserved, normal traffic uses %u VL-IDs per range)\n",
+               LATENCY_PROBE_VL_OFFSET, LATENCY_PROBE_VL_OFFSET);
+    else
+        printf("  Probe VL-ID: first of each range (not reserved, full range for normal traffic)\n");
+
+    // Mbuf'lar karara göre seçilen VL-ID ile kurulur
+    for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
+        uint16_t port_id = ports_config->ports[i].port_id;
+        if (!ports_config->ports[i].is_valid || port_id >= port_vlans_count)
+            continue;
+
+        if (probe_pool_init(port_id) < 0)
+            ret = -1;
+    }
+    printf("\n");
+    return ret;
+}
+
+void latency_probe_flow_cleanup(struct ports_config *ports_config)
+{
+    for (uint16_t i = 0; i < ports_config->nb_ports; i++)
+        probe_flow_destroy(ports_config->ports[i].port_id);
+}
+
+void latency_probe_release(void)
+{
+    // ports_config cleanup_ports'ta sıfırlanır; havuzu olan her portu gez
+    for (uint16_t port_id = 0; port_id < RTE_MAX_ETHPORTS; port_id++) {
+        struct latency_probe_port *pp = &latency_probe_ports[port_id];
+
+        for (uint16_t v = 0; v < pp->vlan_count; v++) {
+            for (uint16_t d = 0; d < LATENCY_PROBE_DEPTH; d++) {
+                if (pp->mbufs[v][d])
+                    rte_pktmbuf_free(pp->mbufs[v][d]);
+                pp->mbufs[v][d] = NULL;
+            }
+        }
+        pp->vlan_count = 0;
+
+        if (pp->pool) {
+            if (pp->busy > 0)
+                printf("Port %u: %lu probes skipped (all prebuilt mbufs in flight)\n",
+                       port_id, pp->busy);
+            rte_mempool_free(pp->pool);
+            pp->pool = NULL;
+        }
+    }
+}
+
+// ==========================================
+// RX: NORMAL MODE PROBE QUEUE
+// ==========================================
+
+void latency_probe_rx_poll(uint16_t port_id, uint16_t src_port_id)
+{
+    struct rte_mbuf *pkts[LATENCY_PROBE_RX_BURST];
+    uint16_t nb_rx = rte_eth_rx_burst(port_id, LATENCY_PROBE_RX_QUEUE, pkts, LATENCY_PROBE_RX_BURST);
+    if (likely(nb_rx == 0))
+        return;
+
+#if LATENCY_LOAD_TEST_ENABLED || LATENCY_MONITOR_ENABLED
+    for (uint16_t i = 0; i < nb_rx; i++) {
+        const uint8_t *pkt = rte_pktmbuf_mtod(pkts[i], const uint8_t *);
+        uint16_t vl_id = ((uint16_t)pkt[4] << 8) | pkt[5];
+#if LATENCY_LOAD_TEST_ENABLED
+        if (latency_load_is_probe(src_port_id, vl_id))
+            latency_load_rx_probe(port_id, src_port_id, pkts[i], PROBE_PAYLOAD_OFF);
+#else
+        int vlan_idx = latency_monitor_probe_vlan(src_port_id, vl_id);
+        if (vlan_idx >= 0)
+            latency_monitor_rx_probe(port_id, src_port_id, (uint16_t)vlan_idx, pkts[i], PROBE_PAYLOAD_OFF);
+#endif
+    }
+#else
+    RTE_SET_USED(src_port_id);
+#endif
+
+    rte_pktmbuf_free_bulk(pkts, nb_rx);
+}
+
+#endif /* LATENCY_TEST_ENABLED */
@@ -0,0 +1,488 @@
+#include "lcore_planner.h"
+#include "common.h"
+#include <stdio.h>
+#include <string.h>
+#include <rte_lcore.h>
+#include "dpdk_external_tx.h"
+#if ENABLE_RAW_SOCKET_PORTS
+#include "raw_socket_port.h"
+#endif
+
+// ==========================================
+// TOPOLOGY + PLAN STATE
+// ==========================================
+
+#define PLAN_NODE_ANY -1
+
+struct lcore_plan_entry {
+    uint16_t lcore_id;
+    int cpu;                // OS CPU numarası
+    int node;               // NUMA node (EAL)
+    int package;            // physical_package_id
+    int core_id;            // Paket içi fiziksel core
+    int phys;               // Plan içi fiziksel core indeksi (SMT kardeşleri aynı)
+    enum lcore_plan_role role;
+    uint16_t port_id;
+    uint16_t queue_id;
+    double load_mbps;       // Beklenen trafik
+};
+
+enum plan_phys_state {
+    PHYS_FREE = 0,
+    PHYS_SHARED,            // Hafif worker'lar veya main lcore var
+    PHYS_EXCLUSIVE,         // Busy worker sahibi, kardeşler boş kalır
+};
+
+static struct lcore_plan_entry plan[RTE_MAX_LCORE];
+static enum plan_phys_state phys_state[RTE_MAX_LCORE];
+static int plan_count = 0;
+static int phys_count = 0;
+static bool plan_smt_known = true;
+
+#if DPDK_EXT_TX_ENABLED
+static const struct dpdk_ext_tx_port_config plan_ext_configs[] = DPDK_EXT_TX_PORTS_CONFIG_INIT;
+#endif
+
+static int read_sysfs_int(const char *path, int fallback)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return fallback;
+
+    int v;
+    if (fscanf(f, "%d", &v) != 1)
+        v = fallback;
+    fclose(f);
+    return v;
+}
+
+static int iface_numa_node(const char *ifname)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/class/net/%s/device/numa_node", ifname);
+    int node = read_sysfs_int(path, PLAN_NODE_ANY);
+    return (node >= 0 && node < MAX_SOCKET) ? node : PLAN_NODE_ANY;
+}
+
+static const char *role_name(enum lcore_plan_role role)
+{
+    switch (role) {
+    case LCORE_ROLE_FREE:     return "free";
+    case LCORE_ROLE_MAIN:     return "MAIN (stats)";
+    case LCORE_ROLE_SMT_IDLE: return "(smt idle)";
+    case LCORE_ROLE_TX:       return "TX";
+    case LCORE_ROLE_RX:       return "RX";
+    case LCORE_ROLE_EXT_TX:   return "EXT TX";
+    case LCORE_ROLE_RAW_RX:   return "RAW RX";
+    case LCORE_ROLE_RAW_TX:   return "RAW TX";
+    }
+    return "?";
+}
+
+static void plan_read_topology(void)
+{
+    unsigned lcore_id;
+
+    plan_count = 0;
+    phys_count = 0;
+    plan_smt_known = true;
+    memset(plan, 0, sizeof(plan));
+    memset(phys_state, 0, sizeof(phys_state));
+
+    RTE_LCORE_FOREACH(lcore_id)
+    {
+        if (plan_count >= RTE_MAX_LCORE)
+            break;
+
+        struct lcore_plan_entry *e = &plan[plan_count++];
+        char path[128];
+
+        e->lcore_id = (uint16_t)lcore_id;
+        e->cpu = rte_lcore_to_cpu_id((int)lcore_id);
+        e->node = (int)rte_lcore_to_socket_id(lcore_id);
+        if (e->cpu < 0)
+            e->cpu = (int)lcore_id;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/physical_package_id", e->cpu);
+        e->package = read_sysfs_int(path, e->node);
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/topology/core_id", e->cpu);
+        e->core_id = read_sysfs_int(path, -1);
+        if (e->core_id < 0) {
+            // Topoloji okunamadı: her lcore ayrı fiziksel core sayılır
+            e->core_id = e->cpu;
+            plan_smt_known = false;
+        }
+
+        // Aynı (package, core_id) = aynı fiziksel core
+        e->phys = -1;
+        for (int i = 0; i < plan_count - 1; i++) {
+            if (plan[i].package == e->package && plan[i].core_id == e->core_id) {
+                e->phys = plan[i].phys;
+                break;
+            }
+        }
+        if (e->phys < 0)
+            e->phys = phys_count++;
+
+        if (lcore_id == rte_get_main_lcore()) {
+            e->role = LCORE_ROLE_MAIN;
+            phys_state[e->phys] = PHYS_SHARED;
+        }
+    }
+
+    if (!plan_smt_known)
+        printf("Warning: CPU topology not readable from sysfs, SMT siblings unknown\n");
+}
+
+static bool phys_all_free(int phys)
+{
+    for (int i = 0; i < plan_count; i++) {
+        if (plan[i].phys == phys && plan[i].role != LCORE_ROLE_FREE)
+            return false;
+    }
+    return true;
+}
+
+static bool node_match(const struct lcore_plan_entry *e, int node)
+{
+    return node == PLAN_NODE_ANY || e->node == node;
+}
+
+/**
+ * Pick an lcore. High lcore ids first (legacy order leaves low cores to the OS).
+ * Exclusive: whole physical core must be free, siblings become SMT_IDLE.
+ * Shared: first free sibling of a shared core, then a free physical core.
+ */
+static int plan_pick_on_node(int node, bool exclusive)
+{
+    if (exclusive && LCORE_PLAN_SMT_EXCLUSIVE) {
+        for (int i = plan_count - 1; i >= 0; i--) {
+            if (node_match(&plan[i], node) && phys_state[plan[i].phys] == PHYS_FREE &&
+                phys_all_free(plan[i].phys))
+                return i;
+        }
+        return -1;
+    }
+
+    if (!exclusive) {
+        for (int i = plan_count - 1; i >= 0; i--) {
+            if (plan[i].role == LCORE_ROLE_FREE && node_match(&plan[i], node) &&
+                phys_state[plan[i].phys] == PHYS_SHARED)
+                return i;
+        }
+    }
+    for (int i = plan_count - 1; i >= 0; i--) {
+        if (plan[i].role == LCORE_ROLE_FREE && node_match(&plan[i], node) &&
+            phys_state[plan[i].phys] != PHYS_EXCLUSIVE)
+            return i;
+    }
+    return -1;
+}
+
+static int plan_assign(enum lcore_plan_role role, uint16_t port_id, uint16_t queue_id,
+                       int node, bool exclusive, double load_mbps)
+{
+    int idx = plan_pick_on_node(node, exclusive);
+
+    if (idx < 0 && node != PLAN_NODE_ANY) {
+#if LCORE_PLAN_ALLOW_NUMA_SPILL
+        idx = plan_pick_on_node(PLAN_NODE_ANY, exclusive);
+        if (idx >= 0)
+            printf("Warning: %s P%u Q%u spilled from node %d to node %d (lcore %u)\n",
+                   role_name(role), port_id, queue_id, node, plan[idx].node, plan[idx].lcore_id);
+#endif
+    }
+    if (idx < 0) {
+        printf("ERROR: lcore plan: no %s lcore for %s P%u Q%u (node %d)\n",
+               exclusive ? "exclusive physical" : "free", role_name(role),
+               port_id, queue_id, node);
+        return -1;
+    }
+
+    struct lcore_plan_entry *e = &plan[idx];
+    e->role = role;
+    e->port_id = port_id;
+    e->queue_id = queue_id;
+    e->load_mbps = load_mbps;
+
+    if (exclusive && LCORE_PLAN_SMT_EXCLUSIVE) {
+        phys_state[e->phys] = PHYS_EXCLUSIVE;
+        for (int i = 0; i < plan_count; i++) {
+            if (i != idx && plan[i].phys == e->phys)
+                plan[i].role = LCORE_ROLE_SMT_IDLE;
+        }
+    } else if (phys_state[e->phys] == PHYS_FREE) {
+        phys_state[e->phys] = PHYS_SHARED;
+    }
+    return idx;
+}
+
+// ==========================================
+// DEMANDS
+// ==========================================
+
+static int port_node(const struct port *port)
+{
+    return (port->numa_node < MAX_SOCKET) ? (int)port->numa_node : PLAN_NODE_ANY;
+}
+
+static bool port_is_busy(uint16_t port_id)
+{
+    return GET_PORT_TARGET_GBPS(port_id) >= LCORE_PLAN_BUSY_PORT_GBPS;
+}
+
+static double inline_ext_load_mbps(uint16_t port_id, uint16_t queue_id)
+{
+#if DPDK_EXT_TX_ENABLED
+    if (!dpdk_ext_tx_port_inline(port_id))
+        return 0.0;
+    for (size_t i = 0; i < sizeof(plan_ext_configs) / sizeof(plan_ext_configs[0]); i++) {
+        if (plan_ext_configs[i].port_id != port_id)
+            continue;
+        double mbps = 0.0;
+        for (int t = 0; t < plan_ext_configs[i].target_count; t++) {
+            if (plan_ext_configs[i].targets[t].queue_id == queue_id)
+                mbps += plan_ext_configs[i].targets[t].rate_kbps / 1000.0;
+        }
+        return mbps;
+    }
+#else
+    (void)port_id;
+    (void)queue_id;
+#endif
+    return 0.0;
+}
+
+static int plan_port_workers(struct ports_config *config, bool busy_pass)
+{
+    for (uint16_t p = 0; p < config->nb_ports; p++) {
+        struct port *port = &config->ports[p];
+        uint16_t port_id = port->port_id;
+        bool busy = port_is_busy(port_id);
+        if (busy != busy_pass)
+            continue;
+
+        int node = port_node(port);
+        uint16_t paired = (port_id % 2 == 0) ? (uint16_t)(port_id + 1) : (uint16_t)(port_id - 1);
+        double tx_mbps = GET_PORT_TARGET_GBPS(port_id) * 1000.0 / NUM_TX_CORES;
+        double rx_mbps = GET_PORT_TARGET_GBPS(paired) * 1000.0 / NUM_RX_CORES;
+
+        for (uint16_t q = 0; q < NUM_TX_CORES; q++) {
+            int idx = plan_assign(LCORE_ROLE_TX, port_id, q, node, busy,
+                                  tx_mbps + inline_ext_load_mbps(port_id, q));
+            if (idx < 0)
+                return -1;
+            port->used_tx_cores[q] = plan[idx].lcore_id;
+        }
+        for (uint16_t q = 0; q < NUM_RX_CORES; q++) {
+            int idx = plan_assign(LCORE_ROLE_RX, port_id, q, node, busy, rx_mbps);
+            if (idx < 0)
+                return -1;
+            port->used_rx_cores[q] = plan[idx].lcore_id;
+        }
+    }
+    return 0;
+}
+
+static int plan_ext_tx_workers(struct ports_config *config)
+{
+#if DPDK_EXT_TX_ENABLED
+    for (uint16_t p = 0; p < config->nb_ports; p++) {
+        config->ports[p].used_ext_tx_core = 0;
+    }
+
+    for (size_t i = 0; i < sizeof(plan_ext_configs) / sizeof(plan_ext_configs[0]); i++) {
+        uint16_t port_id = plan_ext_configs[i].port_id;
+        if (port_id >= config->nb_ports || dpdk_ext_tx_port_inline(port_id))
+            continue;
+
+        double mbps = 0.0;
+        for (int t = 0; t < plan_ext_configs[i].target_count; t++)
+            mbps += plan_ext_configs[i].targets[t].rate_kbps / 1000.0;
+
+        int idx = plan_assign(LCORE_ROLE_EXT_TX, port_id, 4, port_node(&config->ports[port_id]),
+                              false, mbps);
+        if (idx < 0)
+            return -1;
+        config->ports[port_id].used_ext_tx_core = plan[idx].lcore_id;
+    }
+#else
+    (void)config;
+#endif
+    return 0;
+}
+
+static int plan_raw_rx_threads(void)
+{
+#if ENABLE_RAW_SOCKET_PORTS
+    // Raw port tablosu (RAW_SOCKET_PORTS_CONFIG_INIT) ile aynı sayılar
+    for (uint16_t r = 0; r < raw_port_config_count; r++) {
+        const struct raw_socket_port_config *cfg = &raw_port_configs[r];
+        int node = iface_numa_node(cfg->interface_name);
+        int queues = raw_port_rx_queue_count(cfg);
+        int tx_lanes = raw_port_tx_lane_count(cfg);
+        double capacity_mbps = cfg->is_1g_port ? 1000.0 : 100.0;
+
+        for (int q = 0; q < queues; q++) {
+            if (plan_assign(LCORE_ROLE_RAW_RX, cfg->port_id, (uint16_t)q, node, false,
+                            capacity_mbps / queues) < 0)
+                return -1;
+        }
+        // Tek TX lane pinlenmez, plana girmez
+        for (int l = 0; tx_lanes > 1 && l < tx_lanes; l++) {
+            if (plan_assign(LCORE_ROLE_RAW_TX, cfg->port_id, (uint16_t)l, node, false,
+                            capacity_mbps / tx_lanes) < 0)
+                return -1;
+        }
+    }
+#endif
+    return 0;
+}
+
+// Port'un mempool/PRBS cache'i worker'larının çoğunun bulunduğu node'a
+static void plan_worker_nodes(struct ports_config *config)
+{
+    for (uint16_t p = 0; p < config->nb_ports; p++) {
+        struct port *port = &config->ports[p];
+        int votes[MAX_SOCKET] = {0};
+
+        for (int i = 0; i < plan_count; i++) {
+            if ((plan[i].role == LCORE_ROLE_TX || plan[i].role == LCORE_ROLE_RX) &&
+                plan[i].port_id == port->port_id && plan[i].node >= 0 && plan[i].node < MAX_SOCKET)
+                votes[plan[i].node]++;
+        }
+
+        int best = port_node(port);
+        int best_votes = (best >= 0) ? votes[best] : -1;
+        for (int n = 0; n < MAX_SOCKET; n++) {
+            if (votes[n] > best_votes) {
+                best = n;
+                best_votes = votes[n];
+            }
+        }
+        port->worker_numa_node = (best >= 0) ? (uint16_t)best : 0;
+
+        if (port->worker_numa_node != port->numa_node)
+            printf("Warning: Port %u NIC on node %u, workers/mempool/PRBS on node %u\n",
+                   port->port_id, port->numa_node, port->worker_numa_node);
+    }
+}
+
+// Plan dışındaki thread'ler (get_unused_cores) sadece boş lcore'ları görsün
+static void plan_publish_unused(void)
+{
+    for (int s = 0; s < MAX_SOCKET; s++) {
+        for (int i = 0; i < MAX_LCORE_PER_SOCKET; i++) {
+            uint16_t lcore = unused_socket_to_lcore[s][i];
+            if (lcore == 0)
+                continue;
+            for (int k = 0; k < plan_count; k++) {
+                if (plan[k].lcore_id == lcore && plan[k].role != LCORE_ROLE_FREE) {
+                    unused_socket_to_lcore[s][i] = 0;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// ==========================================
+// PUBLIC API
+// ==========================================
+
+int lcore_plan_build(struct ports_config *config)
+{
+    printf("\n=== Building lcore placement plan ===\n");
+    plan_read_topology();
+
+    int main_count = 0;
+    for (int i = 0; i < plan_count; i++) {
+        if (plan[i].role == LCORE_ROLE_MAIN)
+            main_count++;
+    }
+    int workers = plan_count - main_count;
+    printf("  %d EAL lcores (%d worker), %d physical cores, SMT %s, busy port >= %.1f Gbps\n",
+           plan_count, workers, phys_count, plan_smt_known ? "known" : "unknown",
+           (double)LCORE_PLAN_BUSY_PORT_GBPS);
+
+    // Sıra: busy port worker'ları (tam core) -> hafif portlar -> ext TX -> raw RX/TX
+    if (plan_port_workers(config, true) < 0 ||
+        plan_port_workers(config, false) < 0 ||
+        plan_ext_tx_workers(config) < 0 ||
+        plan_raw_rx_threads() < 0) {
+        lcore_plan_print();
+        printf("ERROR: lcore placement plan cannot be satisfied.\n");
+        printf("       Give EAL more lcores (-l), lower NUM_TX_CORES/NUM_RX_CORES,\n");
+        printf("       or set LCORE_PLAN_SMT_EXCLUSIVE=0 / LCORE_PLAN_ALLOW_NUMA_SPILL=1.\n");
+        return -1;
+    }
+
+    plan_worker_nodes(config);
+    plan_publish_unused();
+    lcore_plan_print();
+    return 0;
+}
+
+void lcore_plan_print(void)
+{
+    double node_load[MAX_SOCKET] = {0};
+    int node_workers[MAX_SOCKET] = {0};
+
+    printf("\n=== LCORE PLACEMENT MAP ===\n");
+    printf("%6s %5s %5s %9s  %-13s %-8s %14s\n",
+           "Lcore", "CPU", "Node", "Phys", "Role", "Port/Q", "Expected load");
+
+    for (int i = 0; i < plan_count; i++) {
+        const struct lcore_plan_entry *e = &plan[i];
+        char where[16] = "-";
+        char load[24] = "-";
+
+        switch (e->role) {
+        case LCORE_ROLE_TX:
+        case LCORE_ROLE_RX:
+        case LCORE_ROLE_EXT_TX:
+        case LCORE_ROLE_RAW_RX:
+        case LCORE_ROLE_RAW_TX:
+            snprintf(where, sizeof(where), "P%u Q%u", e->port_id, e->queue_id);
+            // DPDK worker'ları busy-poll: CPU %100, trafik bilgi amaçlı
+            snprintf(load, sizeof(load), "%.0f Mbps", e->load_mbps);
+            if (e->node >= 0 && e->node < MAX_SOCKET) {
+                node_load[e->node] += e->load_mbps;
+                node_workers[e->node]++;
+            }
+            break;
+        default:
+            break;
+        }
+
+        printf("%6u %5d %5d %4d/%-4d  %-13s %-8s %14s\n",
+               e->lcore_id, e->cpu, e->node, e->package, e->core_id,
+               role_name(e->role), where, load);
+    }
+
+    for (int n = 0; n < MAX_SOCKET; n++) {
+        if (node_workers[n] > 0)
+            printf("  Node %d: %d busy-poll threads, %.2f Gbps expected\n",
+                   n, node_workers[n], node_load[n] / 1000.0);
+    }
+}
+
+static int plan_take_cores(enum lcore_plan_role role, uint16_t port_id, int count, uint16_t *cores)
+{
+    int found = 0;
+    for (int i = 0; i < plan_count && found < count; i++) {
+        if (plan[i].role == role && plan[i].port_id == port_id)
+            cores[found++] = (uint16_t)plan[i].cpu;   // pthread affinity CPU numarası ister
+    }
+    return found;
+}
+
+int lcore_plan_take_raw_cores(uint16_t port_id, int count, uint16_t *cores)
+{
+    return plan_take_cores(LCORE_ROLE_RAW_RX, port_id, count, cores);
+}
+
+int lcore_plan_take_raw_tx_cores(uint16_t port_id, int count, uint16_t *cores)
+{
+    return plan_take_cores(LCORE_ROLE_RAW_TX, port_id, count, cores);
+}
@@ -17,7 +17,14 @@
 #include "tx_rx_manager.h"
 #include "raw_socket_port.h"  // Raw socket port support (non-DPDK NICs)
 #include "dpdk_external_tx.h" // DPDK External TX (independent system)
+#include "tx_pacing_stats.h"  // TX inter-departure time telemetry
+#include "raw_latency.h"      // Raw port one-way latency (SO_TIMESTAMPING)
+#include "lcore_planner.h"    // NUMA/SMT-aware lcore placement
 #include "embedded_latency/embedded_latency.h"  // Embedded HW timestamp latency test
+#include "latency_load.h"     // Latency-under-load sweep
+#include "latency_probe.h"    // Prebuilt probe mbufs + rte_flow probe RX queue
+#include "latency_monitor.h"  // Continuous per-VLAN latency monitor
+#include "stats_service.h"    // Snapshot thread + JSON/Prometheus/telemetry endpoint
 
 // Enable/disable raw socket ports
 #ifndef ENABLE_RAW_SOCKET_PORTS
@@ -83,7 +90,7 @@ int main(int argc, char const *argv[])
     printf("WARM-UP: First 60 seconds (stats will reset at 60s)\n");
     printf("Sequence Validation: Enabled (Lost/Out-of-Order/Duplicate detection)\n");
 #if ENABLE_RAW_SOCKET_PORTS
-    printf("Raw Socket Ports: Enabled (%d ports, multi-target)\n", MAX_RAW_SOCKET_PORTS);
+    printf("Raw Socket Ports: Enabled (%u ports, multi-target)\n", raw_port_config_count);
     printf("  - Port 12 (1G): 5 targets (960 Mbps total)\n");
     printf("      -> P13: 80 Mbps, P5/P4/P7/P6: 220 Mbps each\n");
     printf("  - Port 13 (100M): 1 target\n");
@@ -214,12 +221,31 @@ int main(int argc, char const *argv[])
     socketToLcore();
 
     // Assign lcores to ports
+#if LCORE_PLANNER_ENABLED
+    if (lcore_plan_build(&ports_config) != 0)
+    {
+        printf("Error: lcore placement failed, refusing to start\n");
+        cleanup_ports(&ports_config);
+        cleanup_eal();
+        return -1;
+    }
+#else
     lcorePortAssign(&ports_config);
+#endif
 
     // Initialize VLAN configuration + print
     init_vlan_config();
     print_vlan_config();
 
+    // Per-port tablolar: keşfedilen port sayısı kadar, portların NUMA node'unda
+    if (init_port_tables(&ports_config) != 0)
+    {
+        printf("Error: Failed to allocate per-port tables\n");
+        cleanup_ports(&ports_config);
+        cleanup_eal();
+        return -1;
+    }
+
     // Initialize RX verification stats (PRBS good/bad/bit_errors + sequence stats)
     init_rx_stats();
 
@@ -234,12 +260,12 @@ int main(int argc, char const *argv[])
 
     // Configure TX/RX for each port
     printf("\n=== Configuring Ports ===\n");
-    struct txrx_config txrx_configs[MAX_PORTS];
+    struct txrx_config txrx_configs[RTE_MAX(nb_ports, 1)];
 
     for (uint16_t i = 0; i < (uint16_t)nb_ports; i++)
     {
         uint16_t port_id = ports_config.ports[i].port_id;
-        uint16_t socket_id = ports_config.ports[i].numa_node;
+        uint16_t socket_id = ports_config.ports[i].worker_numa_node;
 
         // Create mbuf pool
         struct rte_mempool *mbuf_pool = create_mbuf_pool(socket_id, port_id);
@@ -255,11 +281,12 @@ int main(int argc, char const *argv[])
         // Setup TX/RX configuration
         txrx_configs[i].port_id = port_id;
 #if DPDK_EXT_TX_ENABLED
-        // External TX ports need an extra queue (queue 4) for external TX
+        // External TX ports need an extra queue (queue 4) for external TX,
+        // unless ext traffic is carried inline by the main TX queues
         // Port 2,3,4,5 → Port 12 | Port 0,6 → Port 13
         bool is_ext_tx_port = (port_id == 0 || port_id == 2 || port_id == 3 ||
                                port_id == 4 || port_id == 5 || port_id == 6);
-        if (is_ext_tx_port) {
+        if (is_ext_tx_port && !dpdk_ext_tx_port_inline(port_id)) {
             txrx_configs[i].nb_tx_queues = NUM_TX_CORES + 1;  // Extra queue for external TX
         } else {
             txrx_configs[i].nb_tx_queues = NUM_TX_CORES;
@@ -267,7 +294,7 @@ int main(int argc, char const *argv[])
 #else
         txrx_configs[i].nb_tx_queues = NUM_TX_CORES;
 #endif
-        txrx_configs[i].nb_rx_queues = NUM_RX_CORES;
+        txrx_configs[i].nb_rx_queues = NUM_RX_CORES + LATENCY_PROBE_RX_QUEUES;  // + probe queue (LATENCY_PROBE_FLOW_ENABLED)
         txrx_configs[i].mbuf_pool = mbuf_pool;
 
         // Initialize port TX/RX
@@ -359,6 +386,9 @@ int main(int argc, char const *argv[])
     printf("╚══════════════════════════════════════════════════════════════════╝\n");
     printf("\n");
 
+    // Probe mbuf'ları ve flow kuralları (normal modda da kalır)
+    latency_probe_init(&ports_config);
+
     int latency_ret = start_latency_test(&ports_config, &force_quit);
     if (latency_ret < 0) {
         printf("Warning: Latency test failed, continuing with normal mode\n");
@@ -367,8 +397,10 @@ int main(int argc, char const *argv[])
     // Check if user pressed Ctrl+C during latency test
     if (force_quit) {
         printf("User interrupted during latency test, exiting...\n");
+        latency_probe_flow_cleanup(&ports_config);
         cleanup_prbs_cache();
         cleanup_ports(&ports_config);
+        latency_probe_release();
         cleanup_eal();
         return 0;
     }
@@ -376,12 +408,28 @@ int main(int argc, char const *argv[])
     printf("\n=== Latency test complete, starting normal TX/RX workers ===\n\n");
 #endif
 
+#if LATENCY_LOAD_TEST_ENABLED
+    // Probe VL-ID'leri TX worker'lar başlamadan ayrılmalı
+    latency_load_init(&ports_config);
+#endif
+
+#if LATENCY_MONITOR_ENABLED
+    // Probe VL-ID'leri hazır olmalı; kayıt şeması stats servisi başlarken kurulur
+    latency_monitor_init(&ports_config);
+#endif
+
     int start_ret = start_txrx_workers(&ports_config, &force_quit);
     if (start_ret < 0)
     {
         printf("Failed to start TX/RX workers\n");
+#if LATENCY_TEST_ENABLED
+        latency_probe_flow_cleanup(&ports_config);
+#endif
         cleanup_prbs_cache();
         cleanup_ports(&ports_config);
+#if LATENCY_TEST_ENABLED
+        latency_probe_release();
+#endif
         cleanup_eal();
         return -1;
     }
@@ -421,9 +469,13 @@ int main(int argc, char const *argv[])
     printf("\n=== Running (Press Ctrl+C to stop) ===\n");
     printf("⚙️  WARM-UP PHASE: First 60 seconds (stats will reset)\n\n");
 
-    // Previous TX/RX bytes for per-second rate calculation
-    static uint64_t prev_tx_bytes[MAX_PORTS] = {0};
-    static uint64_t prev_rx_bytes[MAX_PORTS] = {0};
+    // İstatistik görüntüleri ayrı thread'de (konsol, socket ve telemetry aynı görüntüyü okur)
+    if (stats_service_start(&ports_config) != 0)
+    {
+        printf("Error: Cannot start stats service\n");
+        force_quit = true;
+    }
+    static struct stats_snapshot snap;
 
     // Main loop - print stats table every second
     uint32_t loop_count = 0;
@@ -444,10 +496,12 @@ int main(int argc, char const *argv[])
             printf("═══════════════════════════════════════════════════════════════\n");
             printf("\n");
 
-            helper_reset_stats(&ports_config, prev_tx_bytes, prev_rx_bytes);
+            helper_reset_stats(&ports_config);
 
             warmup_complete = true;
             test_time = 0;
+            stats_service_set_phase(warmup_complete, loop_count, test_time);
+            stats_service_refresh();
 
             // Görünürlük için kısa bekleme
             sleep(2);
@@ -460,9 +514,13 @@ int main(int argc, char const *argv[])
             test_time++;
         }
 
-        // Büyük tablo + kuyruk dağılımları (includes DPDK External TX stats)
-        helper_print_stats(&ports_config, prev_tx_bytes, prev_rx_bytes,
-                           warmup_complete, loop_count, test_time);
+        stats_service_set_phase(warmup_complete, loop_count, test_time);
+
+        // Büyük tablo: stats servisinin son görüntüsü
+        if (stats_service_read(&snap) == 0)
+        {
+            helper_print_stats(&snap, warmup_complete, loop_count, test_time);
+        }
 
 #if ENABLE_RAW_SOCKET_PORTS
         // Print raw socket port stats (only if initialized)
@@ -472,22 +530,39 @@ int main(int argc, char const *argv[])
         }
 #endif
 
-        // Bir SONRAKİ saniye için prev_* güncelle: (kümülatif HW byte sayaçları)
-        // helper_print_stats per-second hızları prev_* farkına göre hesaplıyor.
-        for (uint16_t i = 0; i < (uint16_t)nb_ports; i++)
-        {
-            uint16_t port_id = ports_config.ports[i].port_id;
-            struct rte_eth_stats st;
-            if (rte_eth_stats_get(port_id, &st) == 0)
-            {
-                prev_tx_bytes[port_id] = st.obytes;
-                prev_rx_bytes[port_id] = st.ibytes;
-            }
-        }
+#if DPDK_EXT_TX_ENABLED
+        // External TX hedef bazlı rate doğruluğu (DRR)
+        dpdk_ext_tx_print_target_stats();
+#endif
+
+        // TX pacing doğruluğu (queue/target başına, son interval)
+        tx_pacing_print_stats();
+
+        // DPDK <-> raw port tek yön gecikme (akış başına, son interval)
+        raw_lat_print_stats();
+
+#if LATENCY_LOAD_TEST_ENABLED
+        // Yük seviyesi taraması (settle/measure/drain geçişleri)
+        latency_load_tick();
+#endif
+
+#if LATENCY_MONITOR_ENABLED
+        // Sürekli gecikme izleme (interval'i servis thread'i kapatır)
+        latency_monitor_print_stats();
+#endif
     }
 
     printf("\n=== Shutting down ===\n");
 
+    // Görüntü thread'i raw port / ext TX sayaçlarını okur: kaynaklar bırakılmadan önce dur
+    stats_service_stop();
+
+#if LATENCY_LOAD_TEST_ENABLED
+    // Tarama yarıda kaldıysa tamamlanan seviyeleri bas
+    if (!latency_load_done())
+        latency_load_print();
+#endif
+
 #if ENABLE_RAW_SOCKET_PORTS
     // Stop raw socket workers first (only if initialized)
     if (raw_ports_initialized)
@@ -510,9 +585,20 @@ int main(int argc, char const *argv[])
     {
         cleanup_raw_socket_ports();
     }
+#endif
+#if LATENCY_MONITOR_ENABLED
+    latency_monitor_cleanup();
+#endif
+#if LATENCY_TEST_ENABLED
+    latency_probe_flow_cleanup(&ports_config);
 #endif
     cleanup_prbs_cache();
+    cleanup_port_tables();
     cleanup_ports(&ports_config);
+#if LATENCY_TEST_ENABLED
+    // Port durduktan sonra: ring'de kalan probe mbuf'ları havuza dönmüş olur
+    latency_probe_release();
+#endif
     cleanup_eal();
 
     printf("Application exited cleanly\n");
@@ -0,0 +1,268 @@
+#include "nic_clock.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <rte_cycles.h>
+#include <rte_pause.h>
+
+struct nic_clock_port nic_clock_ports[RTE_MAX_ETHPORTS];
+struct nic_clock_map nic_clock_tsc_map;
+int nic_clock_ts_offset = -1;
+uint64_t nic_clock_ts_flag = 0;
+
+// ==========================================
+// DEVICE CLOCK READERS
+// ==========================================
+
+typedef int (*nic_clock_read_fn)(uint16_t port_id, uint64_t *dev);
+
+static int read_rx_clock(uint16_t port_id, uint64_t *dev)
+{
+    return rte_eth_read_clock(port_id, dev);
+}
+
+static int read_timesync_clock(uint16_t port_id, uint64_t *dev)
+{
+    struct timespec ts;
+    int ret = rte_eth_timesync_read_time(port_id, &ts);
+    if (ret == 0)
+        *dev = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return ret;
+}
+
+// SW taraf: TSC'nin referans saati (port_id kullanılmaz)
+static int read_sys_clock(uint16_t port_id, uint64_t *dev)
+{
+    struct timespec ts;
+    (void)port_id;
+    if (clock_gettime(CLOCK_MONOTONIC_RAW, &ts) != 0)
+        return -1;
+    *dev = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+    return 0;
+}
+
+// ==========================================
+// CALIBRATION
+// ==========================================
+
+/**
+ * En dar (tsc0, dev, tsc1) penceresini bul
+ * @return 0: başarılı, *tsc = pencere ortası, *half = yarım pencere
+ */
+static int calib_point(uint16_t port_id, nic_clock_read_fn read_fn,
+                       uint64_t *tsc, uint64_t *dev, uint64_t *half)
+{
+    uint64_t best = UINT64_MAX;
+
+    for (int i = 0; i < NIC_CLOCK_CALIB_SAMPLES; i++) {
+        uint64_t d;
+        uint64_t t0 = rte_rdtsc_precise();
+        if (read_fn(port_id, &d) != 0)
+            return -1;
+        uint64_t t1 = rte_rdtsc_precise();
+
+        if (t1 - t0 < best) {
+            best = t1 - t0;
+            *tsc = t0 + (t1 - t0) / 2;
+            *dev = d;
+        }
+    }
+
+    *half = best / 2 + 1;
+    return 0;
+}
+
+static int calib_map(uint16_t port_id, nic_clock_read_fn read_fn, struct nic_clock_map *m)
+{
+    uint64_t tsc_a, dev_a, half_a;
+    uint64_t tsc_b, dev_b, half_b;
+
+    m->valid = false;
+
+    if (calib_point(port_id, read_fn, &tsc_a, &dev_a, &half_a) != 0)
+        return -1;
+    rte_delay_ms(NIC_CLOCK_CALIB_MS);
+    if (calib_point(port_id, read_fn, &tsc_b, &dev_b, &half_b) != 0)
+        return -1;
+
+    if (dev_b <= dev_a || tsc_b <= tsc_a)
+        return -1;  // Saat ilerlemiyor (PMD sabit değer dönüyor)
+
+    m->dev_ref = dev_b;
+    m->tsc_ref = tsc_b;
+    m->tsc_per_unit = (double)(tsc_b - tsc_a) / (double)(dev_b - dev_a);
+    m->err_cycles = half_a + half_b;
+    // Her iki uçta okuma belirsizliği + cihaz saatinin 1 birimlik çözünürlüğü
+    m->slope_err = (double)(half_a + half_b) / (double)(tsc_b - tsc_a) +
+                   2.0 / (double)(dev_b - dev_a);
+    m->valid = true;
+    return 0;
+}
+
+int nic_clock_calibrate_tsc(void)
+{
+    struct nic_clock_map *m = &nic_clock_tsc_map;
+
+    if (calib_map(0, read_sys_clock, m) != 0) {
+        printf("  CLOCK_MONOTONIC_RAW unusable, TSC error bound unknown\n");
+        return -1;
+    }
+
+    // Dönüşümler nominal rte_get_tsc_hz() ile yapılır: ölçülen orandan sapması
+    // eğim hatasına eklenir
+    double measured_hz = m->tsc_per_unit * 1e9;
+    m->slope_err += fabs(measured_hz / (double)rte_get_tsc_hz() - 1.0);
+    return 0;
+}
+
+int nic_clock_calibrate(uint16_t port_id)
+{
+    struct nic_clock_port *p = &nic_clock_ports[port_id];
+    int ok = 0;
+
+    if (p->rx_hw) {
+        if (calib_map(port_id, read_rx_clock, &p->rx_map) == 0)
+            ok++;
+        else
+            printf("  Port %u: rte_eth_read_clock unusable, RX falls back to TSC\n", port_id);
+    }
+    if (p->tx_hw) {
+        if (calib_map(port_id, read_timesync_clock, &p->tx_map) == 0) {
+            ok++;
+        } else {
+            printf("  Port %u: timesync clock unusable, TX falls back to TSC\n", port_id);
+            p->tx_hw = false;
+        }
+    }
+
+    return ok > 0 ? 0 : -1;
+}
+
+// ==========================================
+// PORT SETUP
+// ==========================================
+
+void nic_clock_port_conf(uint16_t port_id, const struct rte_eth_dev_info *dev_info,
+                         struct rte_eth_conf *port_conf)
+{
+    struct nic_clock_port *p = &nic_clock_ports[port_id];
+    memset(p, 0, sizeof(*p));
+
+#if NIC_CLOCK_ACTIVE
+    if (dev_info->rx_offload_capa & RTE_ETH_RX_OFFLOAD_TIMESTAMP) {
+        port_conf->rxmode.offloads |= RTE_ETH_RX_OFFLOAD_TIMESTAMP;
+        p->rx_hw = true;
+    }
+#else
+    (void)dev_info;
+    (void)port_conf;
+#endif
+}
+
+void nic_clock_port_start(uint16_t port_id)
+{
+#if NIC_CLOCK_ACTIVE
+    struct nic_clock_port *p = &nic_clock_ports[port_id];
+
+    // PMD offload'u açınca dynfield'ı kaydeder; burada sadece yerini öğreniyoruz
+    if (p->rx_hw && nic_clock_ts_offset < 0) {
+        if (rte_mbuf_dyn_rx_timestamp_register(&nic_clock_ts_offset, &nic_clock_ts_flag) != 0) {
+            printf("  Port %u: RX timestamp dynfield not available\n", port_id);
+            nic_clock_ts_offset = -1;
+        }
+    }
+    if (nic_clock_ts_offset < 0)
+        p->rx_hw = false;
+
+    p->tx_hw = (rte_eth_timesync_enable(port_id) == 0);
+
+    // TSC host başına tek: ilk port kalibre eder
+    if (!nic_clock_tsc_map.valid)
+        nic_clock_calibrate_tsc();
+    nic_clock_calibrate(port_id);
+
+    printf("  Port %u: latency clock RX=%s TX=%s\n", port_id,
+           p->rx_map.valid ? "nic" : "tsc",
+           p->tx_hw ? "nic" : "tsc");
+#else
+    (void)port_id;
+#endif
+}
+
+// ==========================================
+// TX TIMESTAMP / REPORTING
+// ==========================================
+
+bool nic_clock_tx_tsc(uint16_t port_id, uint64_t *tsc)
+{
+    struct nic_clock_port *p = &nic_clock_ports[port_id];
+    if (!p->tx_hw || !p->tx_map.valid)
+        return false;
+
+    // timesync API'si port başına tek bekleyen TX timestamp tutar
+    uint64_t deadline = rte_rdtsc() + rte_get_tsc_hz() / 1000000 * NIC_CLOCK_TX_POLL_US;
+    struct timespec ts;
+    do {
+        if (rte_eth_timesync_read_tx_timestamp(port_id, &ts) == 0) {
+            uint64_t ns = (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+            *tsc = nic_clock_map_tsc(&p->tx_map, ns);
+            return true;
+        }
+        rte_pause();
+    } while (rte_rdtsc() < deadline);
+
+    // Geç gelen timestamp sonraki paketinkiyle karışmasın: bu port TSC'ye düşer
+    printf("  Port %u: no HW TX timestamp within %u us, TX falls back to TSC\n",
+           port_id, NIC_CLOCK_TX_POLL_US);
+    p->tx_hw = false;
+    return false;
+}
+
+uint64_t nic_clock_err_ns(uint16_t port_id, bool tx, uint64_t at_tsc)
+{
+    const struct nic_clock_port *p = &nic_clock_ports[port_id];
+    const struct nic_clock_map *m = tx ? &p->tx_map : &p->rx_map;
+    bool hw = tx ? p->tx_hw : p->rx_hw;
+
+    // HW saat yoksa TSC: okuma penceresi + nominal frekans sapması
+    if (!hw || !m->valid)
+        m = &nic_clock_tsc_map;
+    if (!m->valid)
+        return UINT64_MAX;
+
+    uint64_t dist = at_tsc > m->tsc_ref ? at_tsc - m->tsc_ref : m->tsc_ref - at_tsc;
+    double err = (double)m->err_cycles + m->slope_err * (double)dist;
+    return (uint64_t)(err * 1e9 / (double)rte_get_tsc_hz());
+}
+
+void nic_clock_print(const uint16_t *port_ids, uint16_t nb_ports)
+{
+    // Test sırasındaki tüm dönüşümler kalibrasyon ile şimdi arasında: en kötü durum
+    uint64_t now = rte_rdtsc();
+
+    printf("\n=== Latency Clock Sources ===\n");
+    printf("  Port |  RX  | RX err (ns) |  TX  | TX err (ns)\n");
+    for (uint16_t i = 0; i < nb_ports; i++) {
+        uint16_t port_id = port_ids[i];
+        const struct nic_clock_port *p = &nic_clock_ports[port_id];
+        bool rx = p->rx_hw && p->rx_map.valid;
+        bool tx = p->tx_hw && p->tx_map.valid;
+
+        uint64_t rx_err = nic_clock_err_ns(port_id, false, now);
+        uint64_t tx_err = nic_clock_err_ns(port_id, true, now);
+
+        printf("  %4u | %-4s | ", port_id, rx ? "nic" : "sw");
+        if (rx_err == UINT64_MAX)
+            printf("%11s | ", "unknown");
+        else
+            printf("%11lu | ", (unsigned long)rx_err);
+        printf("%-4s | ", tx ? "nic" : "sw");
+        if (tx_err == UINT64_MAX)
+            printf("%11s\n", "unknown");
+        else
+            printf("%11lu\n", (unsigned long)tx_err);
+    }
+    printf("  err: referans okuma belirsizliği + eğim hatası x kalibrasyondan beri geçen süre\n");
+    printf("  sw: TSC, CLOCK_MONOTONIC_RAW'a karşı kalibre (RX poll / TX doorbell gecikmesi hariç)\n\n");
+}
@@ -1,5 +1,6 @@
 #include "packet.h"
 #include "port.h"
+#include "pkt_io.h"
 #include <string.h>
 #include <arpa/inet.h>
 #include <stdio.h>
@@ -7,8 +8,11 @@
 #include <rte_malloc.h>
 #include <rte_memcpy.h>
 
-// Global PRBS cache for all ports
-struct prbs_cache port_prbs_cache[MAX_PRBS_CACHE_PORTS];
+// Global PRBS cache for all ports (port_id ile indekslenir)
+struct prbs_cache *port_prbs_cache = NULL;
+uint16_t port_prbs_cache_count = 0;
+
+_Static_assert(PRBS_CACHE_SIZE == PKT_PRBS_CACHE_SIZE, "pkt_io PRBS ofset hesabı cache boyutuyla uyuşmalı");
 
 /**
  * PRBS-31 next bit generator
@@ -65,13 +69,24 @@ void init_prbs_cache_for_all_ports(uint16_t nb_ports, const struct ports_config
     printf("Cache size per port: %u MB\n", (unsigned)(PRBS_CACHE_SIZE / (1024 * 1024)));
     printf("Extended cache: +%u bytes for wraparound\n", NUM_PRBS_BYTES);
     
-    for (uint16_t port = 0; port < nb_ports && port < MAX_PRBS_CACHE_PORTS; port++) {
+    // Tablo keşfedilen port_id aralığı kadar; cache'ler portun node'unda
+    uint16_t table_size = ports ? ports->port_table_size : nb_ports;
+    port_prbs_cache = rte_zmalloc("prbs_cache_tbl",
+                                  RTE_MAX(table_size, 1) * sizeof(struct prbs_cache), 0);
+    if (!port_prbs_cache) {
+        printf("Error: Failed to allocate PRBS cache table (%u ports)\n", table_size);
+        return;
+    }
+    port_prbs_cache_count = table_size;
+
+    for (uint16_t i = 0; i < nb_ports; i++) {
+        uint16_t port = ports ? ports->ports[i].port_id : i;
         printf("\nPort %u:\n", port);
         
         // Get NUMA socket for this port
         int socket_id = 0;
         if (ports) {
-            socket_id = ports->ports[port].numa_node;
+            socket_id = ports->ports[i].worker_numa_node;
         }
         
         port_prbs_cache[port].socket_id = socket_id;
@@ -137,7 +152,7 @@ void init_prbs_cache_for_all_ports(uint16_t nb_ports, const struct ports_config
 
 uint8_t* get_prbs_cache_for_port(uint16_t port_id)
 {
-    if (port_id >= MAX_PRBS_CACHE_PORTS) {
+    if (port_id >= port_prbs_cache_count) {
         printf("Error: Invalid port_id %u for PRBS cache\n", port_id);
         return NULL;
     }
@@ -152,7 +167,7 @@ uint8_t* get_prbs_cache_for_port(uint16_t port_id)
 
 uint8_t* get_prbs_cache_ext_for_port(uint16_t port_id)
 {
-    if (port_id >= MAX_PRBS_CACHE_PORTS) {
+    if (port_id >= port_prbs_cache_count) {
         printf("Error: Invalid port_id %u for PRBS cache\n", port_id);
         return NULL;
     }
@@ -175,7 +190,7 @@ void fill_payload_with_prbs31_dynamic(struct rte_mbuf *mbuf, uint16_t port_id,
         return;
     }
 
-    if (unlikely(port_id >= MAX_PRBS_CACHE_PORTS)) {
+    if (unlikely(port_id >= port_prbs_cache_count)) {
         printf("Error: Invalid port_id %u in fill_payload_with_prbs31_dynamic\n", port_id);
         return;
     }
@@ -199,28 +214,17 @@ void fill_payload_with_prbs31_dynamic(struct rte_mbuf *mbuf, uint16_t port_id,
         return;
     }
 
-    // Write sequence number (first 8 bytes of payload)
-    uint64_t *seq_ptr = rte_pktmbuf_mtod_offset(mbuf, uint64_t *, payload_offset);
-    *seq_ptr = sequence_number;
-
-    // PRBS data starts after sequence number
-    uint8_t *prbs_ptr = rte_pktmbuf_mtod_offset(mbuf, uint8_t *, payload_offset + SEQ_BYTES);
-
-    // IMIX: PRBS offset hesabı HEP MAX_PRBS_BYTES ile yapılır
-    // Bu sayede RX tarafı sequence'dan offset'i hesaplayabilir
-    const uint64_t start_offset = (sequence_number * (uint64_t)MAX_PRBS_BYTES) % (uint64_t)PRBS_CACHE_SIZE;
-
-    // Use extended cache - sadece prbs_len kadar kopyala
-    rte_memcpy(prbs_ptr,
-               &port_prbs_cache[port_id].cache_ext[start_offset],
-               prbs_len);
+    // Sequence + PRBS (IMIX: offset hep MAX_PRBS_BYTES ile, RX seq'den hesaplar)
+    uint8_t *payload = rte_pktmbuf_mtod_offset(mbuf, uint8_t *, payload_offset);
+    pkt_payload_fill(payload, sequence_number, port_prbs_cache[port_id].cache_ext,
+                     MAX_PRBS_BYTES, prbs_len);
 }
 
 void cleanup_prbs_cache(void)
 {
     printf("Cleaning up PRBS cache...\n");
     
-    for (uint16_t port = 0; port < MAX_PRBS_CACHE_PORTS; port++) {
+    for (uint16_t port = 0; port < port_prbs_cache_count; port++) {
         if (port_prbs_cache[port].initialized) {
             if (port_prbs_cache[port].cache) {
                 rte_free(port_prbs_cache[port].cache);
@@ -235,6 +239,10 @@ void cleanup_prbs_cache(void)
             port_prbs_cache[port].initialized = false;
         }
     }
+
+    rte_free(port_prbs_cache);
+    port_prbs_cache = NULL;
+    port_prbs_cache_count = 0;
     
     printf("PRBS cache cleanup complete\n");
 }
@@ -0,0 +1,432 @@
+#include "pkt_io.h"
+#include <stdio.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <linux/if_packet.h>
+#include <rte_ethdev.h>
+#include <rte_mbuf.h>
+
+// ==========================================
+// SETUP
+// ==========================================
+
+void pkt_io_init_mmap(struct pkt_io_port *p, int fd,
+                      void *rx_ring, uint32_t rx_slot_size, uint32_t rx_slot_nr, bool rx_v3,
+                      void *tx_ring, uint32_t tx_frame_size, uint32_t tx_frame_nr)
+{
+    memset(p, 0, sizeof(*p));
+    p->backend = PKT_IO_PACKET_MMAP;
+    p->fd = fd;
+    p->rx_ring = (uint8_t *)rx_ring;
+    p->rx_slot_size = rx_slot_size;
+    p->rx_slot_nr = rx_slot_nr;
+    p->rx_v3 = rx_v3;
+    p->tx_ring = (uint8_t *)tx_ring;
+    p->tx_frame_size = tx_frame_size;
+    p->tx_frame_nr = tx_frame_nr;
+}
+
+void pkt_io_init_xsk(struct pkt_io_port *p, struct xsk_port *x)
+{
+    memset(p, 0, sizeof(*p));
+    p->backend = PKT_IO_AF_XDP;
+    p->fd = x->fd;
+    p->xsk = x;
+}
+
+void pkt_io_init_dpdk(struct pkt_io_port *p, uint16_t port_id, uint16_t queue_id,
+                      struct rte_mempool *mp)
+{
+    memset(p, 0, sizeof(*p));
+    p->backend = PKT_IO_DPDK;
+    p->fd = -1;
+    p->dpdk_port = port_id;
+    p->dpdk_queue = queue_id;
+    p->mp = mp;
+}
+
+// ==========================================
+// PACKET_MMAP
+// ==========================================
+
+static inline struct tpacket2_hdr *mmap_rx_frame(struct pkt_io_port *p, uint32_t idx)
+{
+    return (struct tpacket2_hdr *)(p->rx_ring + (size_t)idx * p->rx_slot_size);
+}
+
+static inline struct tpacket2_hdr *mmap_tx_frame(struct pkt_io_port *p, uint32_t idx)
+{
+    return (struct tpacket2_hdr *)(p->tx_ring + (size_t)idx * p->tx_frame_size);
+}
+
+// V3: paketler kullanıcıya verilmiş block içinde sıkışık, burst block sınırında biter
+static uint16_t mmap_rx_burst_v3(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    struct tpacket_block_desc *bd =
+        (struct tpacket_block_desc *)(p->rx_ring + (size_t)p->rx_index * p->rx_slot_size);
+
+    if (p->rx_pkts_left == 0) {
+        if (!(__atomic_load_n(&bd->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER))
+            return 0;
+
+        p->rx_pkts_left = bd->hdr.bh1.num_pkts;
+        if (p->rx_pkts_left == 0) {
+            // Boş retire edilmiş block: hemen kernel'e geri ver
+            __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            p->rx_index = (p->rx_index + 1) % p->rx_slot_nr;
+            return 0;
+        }
+        p->rx_pkt = (uint8_t *)bd + bd->hdr.bh1.offset_to_first_pkt;
+    }
+
+    if (n > p->rx_pkts_left)
+        n = (uint16_t)p->rx_pkts_left;
+
+    uint8_t *pkt = p->rx_pkt;
+    for (uint16_t i = 0; i < n; i++) {
+        struct tpacket3_hdr *h = (struct tpacket3_hdr *)pkt;
+        bufs[i].data = pkt + h->tp_mac;
+        bufs[i].len = h->tp_len;
+        bufs[i].handle = (uintptr_t)h;
+        pkt += h->tp_next_offset;
+    }
+    return n;
+}
+
+static void mmap_rx_free_v3(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    p->rx_pkts_left -= n;
+    if (p->rx_pkts_left > 0) {
+        struct tpacket3_hdr *last = (struct tpacket3_hdr *)bufs[n - 1].handle;
+        p->rx_pkt = (uint8_t *)last + last->tp_next_offset;
+        return;
+    }
+
+    struct tpacket_block_desc *bd =
+        (struct tpacket_block_desc *)(p->rx_ring + (size_t)p->rx_index * p->rx_slot_size);
+    __atomic_store_n(&bd->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    p->rx_index = (p->rx_index + 1) % p->rx_slot_nr;
+}
+
+static uint16_t mmap_rx_burst_v2(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    uint16_t count = 0;
+    uint32_t idx = p->rx_index;
+
+    while (count < n) {
+        struct tpacket2_hdr *h = mmap_rx_frame(p, idx);
+        if (!(__atomic_load_n(&h->tp_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER))
+            break;
+        bufs[count].data = (uint8_t *)h + h->tp_mac;
+        bufs[count].len = h->tp_len;
+        bufs[count].handle = (uintptr_t)h;
+        count++;
+        idx = (idx + 1) % p->rx_slot_nr;
+    }
+    return count;
+}
+
+static void mmap_rx_free_v2(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        struct tpacket2_hdr *h = (struct tpacket2_hdr *)bufs[i].handle;
+        __atomic_store_n(&h->tp_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    }
+    p->rx_index = (p->rx_index + n) % p->rx_slot_nr;
+}
+
+static uint16_t mmap_tx_alloc(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    uint16_t count = 0;
+    uint32_t idx = p->tx_offset;
+
+    // Ayırma ring durumunu değiştirmez; tx_burst'e kadar frame'ler boşta görünür
+    while (count < n) {
+        struct tpacket2_hdr *h = mmap_tx_frame(p, idx);
+        if (__atomic_load_n(&h->tp_status, __ATOMIC_ACQUIRE) != TP_STATUS_AVAILABLE)
+            break;
+        bufs[count].data = (uint8_t *)h + TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
+        bufs[count].len = 0;
+        bufs[count].handle = (uintptr_t)h;
+        count++;
+        idx = (idx + 1) % p->tx_frame_nr;
+    }
+    return count;
+}
+
+static uint16_t mmap_tx_burst(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        struct tpacket2_hdr *h = (struct tpacket2_hdr *)bufs[i].handle;
+        h->tp_len = bufs[i].len;
+        __atomic_store_n(&h->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+    }
+    p->tx_offset = (p->tx_offset + n) % p->tx_frame_nr;
+    return n;
+}
+
+static uint32_t mmap_tx_in_flight(struct pkt_io_port *p)
+{
+    while (p->tx_reclaim != p->tx_offset) {
+        struct tpacket2_hdr *h = mmap_tx_frame(p, p->tx_reclaim);
+        if (__atomic_load_n(&h->tp_status, __ATOMIC_ACQUIRE) &
+            (TP_STATUS_SEND_REQUEST | TP_STATUS_SENDING))
+            break;
+        p->tx_reclaim = (p->tx_reclaim + 1) % p->tx_frame_nr;
+    }
+    return (p->tx_offset + p->tx_frame_nr - p->tx_reclaim) % p->tx_frame_nr;
+}
+
+// ==========================================
+// AF_XDP
+// ==========================================
+
+static uint16_t xsk_io_rx_burst(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    uint8_t *data[PKT_IO_BURST];
+    uint32_t len[PKT_IO_BURST];
+
+    uint16_t count = (uint16_t)xsk_rx_burst(p->xsk, data, len, n);
+    for (uint16_t i = 0; i < count; i++) {
+        bufs[i].data = data[i];
+        bufs[i].len = len[i];
+        bufs[i].handle = 0;
+    }
+    return count;
+}
+
+static uint16_t xsk_io_tx_alloc(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    uint16_t count = 0;
+    while (count < n) {
+        uint64_t addr;
+        uint8_t *data = xsk_tx_reserve(p->xsk, &addr);
+        if (!data)
+            break;
+        bufs[count].data = data;
+        bufs[count].len = 0;
+        bufs[count].handle = (uintptr_t)addr;
+        count++;
+    }
+    return count;
+}
+
+static void xsk_io_tx_free(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    // Ayrılma sırasının tersiyle serbest listeye dön
+    for (int i = n - 1; i >= 0; i--)
+        p->xsk->tx_free[p->xsk->tx_free_count++] = (uint64_t)bufs[i].handle;
+}
+
+// ==========================================
+// DPDK
+// ==========================================
+
+static uint16_t dpdk_io_rx_burst(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    struct rte_mbuf *mbufs[PKT_IO_BURST];
+
+    uint16_t count = rte_eth_rx_burst(p->dpdk_port, p->dpdk_queue, mbufs, n);
+    for (uint16_t i = 0; i < count; i++) {
+        bufs[i].data = rte_pktmbuf_mtod(mbufs[i], uint8_t *);
+        bufs[i].len = rte_pktmbuf_data_len(mbufs[i]);
+        bufs[i].handle = (uintptr_t)mbufs[i];
+    }
+    return count;
+}
+
+static void dpdk_io_free(struct pkt_io_buf *bufs, uint16_t n)
+{
+    struct rte_mbuf *mbufs[PKT_IO_BURST];
+    for (uint16_t i = 0; i < n; i++)
+        mbufs[i] = (struct rte_mbuf *)bufs[i].handle;
+    rte_pktmbuf_free_bulk(mbufs, n);
+}
+
+static uint16_t dpdk_io_tx_alloc(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    struct rte_mbuf *mbufs[PKT_IO_BURST];
+
+    if (!p->mp || rte_pktmbuf_alloc_bulk(p->mp, mbufs, n) != 0)
+        return 0;
+    for (uint16_t i = 0; i < n; i++) {
+        bufs[i].data = rte_pktmbuf_mtod(mbufs[i], uint8_t *);
+        bufs[i].len = 0;
+        bufs[i].handle = (uintptr_t)mbufs[i];
+    }
+    return n;
+}
+
+static uint16_t dpdk_io_tx_burst(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    struct rte_mbuf *mbufs[PKT_IO_BURST];
+
+    for (uint16_t i = 0; i < n; i++) {
+        struct rte_mbuf *m = (struct rte_mbuf *)bufs[i].handle;
+        m->data_len = (uint16_t)bufs[i].len;
+        m->pkt_len = bufs[i].len;
+        mbufs[i] = m;
+    }
+
+    uint16_t sent = rte_eth_tx_burst(p->dpdk_port, p->dpdk_queue, mbufs, n);
+    if (sent < n)
+        rte_pktmbuf_free_bulk(&mbufs[sent], n - sent);
+    return sent;
+}
+
+// ==========================================
+// DATAPATH (backend dispatch, burst başına bir kez)
+// ==========================================
+
+uint16_t pkt_io_rx_burst(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    if (n > PKT_IO_BURST)
+        n = PKT_IO_BURST;
+
+    switch (p->backend) {
+    case PKT_IO_PACKET_MMAP:
+        return p->rx_v3 ? mmap_rx_burst_v3(p, bufs, n) : mmap_rx_burst_v2(p, bufs, n);
+    case PKT_IO_AF_XDP:
+        return xsk_io_rx_burst(p, bufs, n);
+    case PKT_IO_DPDK:
+        return dpdk_io_rx_burst(p, bufs, n);
+    default:
+        return 0;
+    }
+}
+
+void pkt_io_rx_free(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    if (n == 0)
+        return;
+
+    switch (p->backend) {
+    case PKT_IO_PACKET_MMAP:
+        if (p->rx_v3)
+            mmap_rx_free_v3(p, bufs, n);
+        else
+            mmap_rx_free_v2(p, bufs, n);
+        break;
+    case PKT_IO_AF_XDP:
+        xsk_rx_release(p->xsk, n);
+        break;
+    case PKT_IO_DPDK:
+        dpdk_io_free(bufs, n);
+        break;
+    default:
+        break;
+    }
+}
+
+uint16_t pkt_io_tx_alloc(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    if (n > PKT_IO_BURST)
+        n = PKT_IO_BURST;
+
+    switch (p->backend) {
+    case PKT_IO_PACKET_MMAP:
+        return mmap_tx_alloc(p, bufs, n);
+    case PKT_IO_AF_XDP:
+        return xsk_io_tx_alloc(p, bufs, n);
+    case PKT_IO_DPDK:
+        return dpdk_io_tx_alloc(p, bufs, n);
+    default:
+        return 0;
+    }
+}
+
+uint16_t pkt_io_tx_burst(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    if (n == 0)
+        return 0;
+
+    switch (p->backend) {
+    case PKT_IO_PACKET_MMAP:
+        return mmap_tx_burst(p, bufs, n);
+    case PKT_IO_AF_XDP:
+        for (uint16_t i = 0; i < n; i++)
+            xsk_tx_submit(p->xsk, (uint64_t)bufs[i].handle, bufs[i].len);
+        return n;
+    case PKT_IO_DPDK:
+        return dpdk_io_tx_burst(p, bufs, n);
+    default:
+        return 0;
+    }
+}
+
+void pkt_io_tx_free(struct pkt_io_port *p, struct pkt_io_buf *bufs, uint16_t n)
+{
+    if (n == 0)
+        return;
+
+    switch (p->backend) {
+    case PKT_IO_AF_XDP:
+        xsk_io_tx_free(p, bufs, n);
+        break;
+    case PKT_IO_DPDK:
+        dpdk_io_free(bufs, n);
+        break;
+    default:
+        // PACKET_MMAP: ayırma ring'e yazılmadı, yapılacak bir şey yok
+        break;
+    }
+}
+
+int pkt_io_tx_flush(struct pkt_io_port *p)
+{
+    switch (p->backend) {
+    case PKT_IO_PACKET_MMAP:
+        return (int)send(p->fd, NULL, 0, 0);
+    case PKT_IO_AF_XDP:
+        // Kick completion'ları da toplar
+        return xsk_tx_kick(p->xsk);
+    default:
+        return 0;
+    }
+}
+
+uint32_t pkt_io_tx_in_flight(struct pkt_io_port *p)
+{
+    switch (p->backend) {
+    case PKT_IO_PACKET_MMAP:
+        return mmap_tx_in_flight(p);
+    case PKT_IO_AF_XDP:
+        return XSK_TX_FRAMES - p->xsk->tx_free_count;
+    default:
+        return 0;
+    }
+}
+
+void pkt_io_wait(struct pkt_io_port *p, short events, int timeout_ms)
+{
+    if (p->fd < 0)
+        return;
+    struct pollfd pfd = {p->fd, events, 0};
+    poll(&pfd, 1, timeout_ms);
+}
+
+uint64_t pkt_io_rx_timestamp(const struct pkt_io_port *p, const struct pkt_io_buf *b, bool *hw)
+{
+    if (p->backend != PKT_IO_PACKET_MMAP) {
+        if (hw)
+            *hw = false;
+        return 0;
+    }
+
+    uint32_t sec, nsec, status;
+    if (p->rx_v3) {
+        const struct tpacket3_hdr *h = (const struct tpacket3_hdr *)b->handle;
+        sec = h->tp_sec;
+        nsec = h->tp_nsec;
+        status = h->tp_status;
+    } else {
+        const struct tpacket2_hdr *h = (const struct tpacket2_hdr *)b->handle;
+        sec = h->tp_sec;
+        nsec = h->tp_nsec;
+        status = h->tp_status;
+    }
+
+    if (hw)
+        *hw = (status & TP_STATUS_TS_RAW_HARDWARE) != 0;
+    return (uint64_t)sec * 1000000000ULL + nsec;
+}
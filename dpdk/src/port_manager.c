@@ -1,8 +1,10 @@
 #include "port_manager.h"
 #include "common.h"
 #include <string.h>
+#include <rte_malloc.h>
 #include "port.h"
 #include "config.h"
+#include "dpdk_external_tx.h"
 
 int initialize_ports(struct ports_config *config)
 {
@@ -20,14 +22,26 @@ int initialize_ports(struct ports_config *config)
 
     printf("Scanning for DPDK ports...\n");
 
+    // Port tablosu keşfedilen port sayısı kadar (derleme zamanı tavanı yok)
+    uint16_t nb_avail = rte_eth_dev_count_avail();
+    if (nb_avail == 0)
+    {
+        printf("Found 0 DPDK ports\n");
+        return 0;
+    }
+
+    config->ports = rte_zmalloc("ports_config", nb_avail * sizeof(struct port), RTE_CACHE_LINE_SIZE);
+    if (!config->ports)
+    {
+        printf("Error: Cannot allocate port table for %u ports\n", nb_avail);
+        return -1;
+    }
+
     // Iterate through all available ports
     RTE_ETH_FOREACH_DEV(port_id)
     {
-        if (port_count >= MAX_PORTS)
-        {
-            printf("Warning: Maximum ports limit (%d) reached\n", MAX_PORTS);
+        if (port_count >= nb_avail)
             break;
-        }
 
         struct port *port = &config->ports[port_count];
         struct rte_eth_dev_info dev_info;
@@ -68,6 +82,9 @@ int initialize_ports(struct ports_config *config)
 
         printf("Discovered port %u: %s\n", port_id, port->driver_name);
         port_count++;
+
+        if (port_id >= config->port_table_size)
+            config->port_table_size = port_id + 1;
     }
 
     config->nb_ports = port_count;
@@ -238,7 +255,8 @@ void portNumaNodesMatch(struct ports_config *config)
 {
     for (uint16_t port = 0; port < config->nb_ports; port++)
     {
-        config->ports[port].numa_node = rte_eth_dev_socket_id(port);
+        config->ports[port].numa_node = rte_eth_dev_socket_id(config->ports[port].port_id);
+        config->ports[port].worker_numa_node = config->ports[port].numa_node;
     }
 }
 
@@ -302,8 +320,10 @@ void lcorePortAssign(struct ports_config *config)
         config->ports[port].used_ext_tx_core = 0; // Default: not assigned
 
         // Check if this port is an external TX port
+        // Inline portlarda ext trafiği tx_worker'lar taşır, lcore gerekmez
         bool is_ext_tx_port = (port == 0 || port == 2 || port == 3 ||
-                               port == 4 || port == 5 || port == 6);
+                               port == 4 || port == 5 || port == 6) &&
+                              !dpdk_ext_tx_port_inline(port);
 
         if (is_ext_tx_port)
         {
@@ -327,6 +347,10 @@ void lcorePortAssign(struct ports_config *config)
                     config->ports[port].used_ext_tx_core = lcore;
                     cores--;
                 }
+                else
+                {
+                    printf("Warning: No free lcore for external TX on port %u, ext TX disabled\n", port);
+                }
             }
         }
 #endif
@@ -351,6 +375,7 @@ void cleanup_ports(struct ports_config *config)
         }
     }
 
+    rte_free(config->ports);
     memset(config, 0, sizeof(struct ports_config));
     printf("Ports cleanup completed\n");
 }
\ No newline at end of file
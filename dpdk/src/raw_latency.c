@@ -0,0 +1,462 @@
+#define _GNU_SOURCE  // recvmmsg
+#include "raw_latency.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <net/if.h>
+#include <linux/if_packet.h>
+#include <linux/net_tstamp.h>
+#include <linux/errqueue.h>
+#include <linux/sockios.h>
+
+// ==========================================
+// FLOW REGISTRY
+// ==========================================
+
+// TX örneği: key = 0 yazım sürüyor / boş
+struct raw_lat_slot {
+    uint64_t key;
+    uint64_t tx_ns;
+};
+
+struct raw_lat_flow {
+    char label[RAW_LAT_LABEL_LEN];
+    uint16_t vl_id_start;
+    uint16_t vl_id_count;
+
+    struct raw_lat_slot slots[RAW_LAT_SLOTS];
+
+    // Yayınlanan sayaçlar (kümülatif, birden çok RX thread'i -> atomic add)
+    uint64_t samples;
+    uint64_t unmatched;                 // TX örneği bulunamadı (ezildi/kayıp TX timestamp)
+    uint64_t negative;                  // rx < tx (saat senkron değil)
+    uint64_t sum_ns;
+    uint64_t hist[RAW_LAT_HIST_BUCKETS];
+};
+
+static struct raw_lat_flow lat_flows[RAW_LAT_MAX_FLOWS];
+static uint32_t lat_flow_count = 0;
+
+// VL-ID -> akış indeksi + 1 (0: kayıtsız)
+static uint8_t lat_flow_by_vl[65536];
+
+// Okuyucu-özel: önceki interval'in kümülatif değerleri
+struct raw_lat_snapshot {
+    uint64_t samples;
+    uint64_t unmatched;
+    uint64_t negative;
+    uint64_t sum_ns;
+    uint64_t hist[RAW_LAT_HIST_BUCKETS];
+};
+
+static struct raw_lat_snapshot lat_prev[RAW_LAT_MAX_FLOWS];
+
+// Okuyucu-özel: drift/step alarm durumu
+struct raw_lat_trend {
+    double base_avg[RAW_LAT_BASELINE_INTERVALS];
+    int    base_count;
+    double baseline_avg;                // 0: baseline toplanıyor
+    int    prev_p99;                    // Önceki interval'in p99 bucket'ı, -1: yok
+    int    drift_run;
+    bool   drift_alarm;
+};
+
+static struct raw_lat_trend lat_trend[RAW_LAT_MAX_FLOWS];
+static uint64_t lat_alarm_count = 0;
+
+uint64_t raw_lat_now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+int raw_lat_register_flow(const char *label, uint16_t vl_id_start, uint16_t vl_id_count)
+{
+    if (lat_flow_count >= RAW_LAT_MAX_FLOWS) {
+        printf("Warning: Raw latency flow table full, '%s' not tracked\n", label);
+        return -1;
+    }
+    for (uint32_t v = vl_id_start; v < (uint32_t)vl_id_start + vl_id_count; v++) {
+        if (lat_flow_by_vl[v & 0xFFFF] != 0) {
+            printf("Warning: Raw latency flow '%s' overlaps VL-ID %u, not tracked\n", label, v);
+            return -1;
+        }
+    }
+
+    uint32_t idx = lat_flow_count++;
+    struct raw_lat_flow *f = &lat_flows[idx];
+    memset(f, 0, sizeof(*f));
+    memset(&lat_trend[idx], 0, sizeof(lat_trend[idx]));
+    lat_trend[idx].prev_p99 = -1;
+    snprintf(f->label, sizeof(f->label), "%s", label);
+    f->vl_id_start = vl_id_start;
+    f->vl_id_count = vl_id_count;
+    memset(&lat_prev[idx], 0, sizeof(lat_prev[idx]));
+
+    for (uint32_t v = vl_id_start; v < (uint32_t)vl_id_start + vl_id_count; v++)
+        lat_flow_by_vl[v & 0xFFFF] = (uint8_t)(idx + 1);
+
+    return (int)idx;
+}
+
+static inline struct raw_lat_flow *raw_lat_flow_of(uint16_t vl_id)
+{
+    uint8_t f = lat_flow_by_vl[vl_id];
+    return f ? &lat_flows[f - 1] : NULL;
+}
+
+// Anahtar hiçbir zaman 0 olmaz (48 bit seq yeterli)
+static inline uint64_t raw_lat_key(uint16_t vl_id, uint64_t seq)
+{
+    return (((uint64_t)vl_id << 48) | (seq & 0x0000FFFFFFFFFFFFULL)) + 1;
+}
+
+// Akışın son RAW_LAT_SLOTS örneği için halka: (örnek no, VL ofseti)
+static inline struct raw_lat_slot *raw_lat_slot_of(struct raw_lat_flow *f, uint16_t vl_id, uint64_t seq)
+{
+    uint64_t n = (seq >> RAW_LAT_SAMPLE_SHIFT) * f->vl_id_count + (uint16_t)(vl_id - f->vl_id_start);
+    return &f->slots[n & (RAW_LAT_SLOTS - 1)];
+}
+
+void raw_lat_tx_sample(uint16_t vl_id, uint64_t seq, uint64_t tx_ns)
+{
+    struct raw_lat_flow *f = raw_lat_flow_of(vl_id);
+    if (!f)
+        return;
+
+    // Seqlock benzeri: key=0 -> tx_ns -> key; okuyucu key'i iki kez kontrol eder
+    struct raw_lat_slot *s = raw_lat_slot_of(f, vl_id, seq);
+    __atomic_store_n(&s->key, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&s->tx_ns, tx_ns, __ATOMIC_RELAXED);
+    __atomic_store_n(&s->key, raw_lat_key(vl_id, seq), __ATOMIC_RELEASE);
+}
+
+void raw_lat_rx_sample(uint16_t vl_id, uint64_t seq, uint64_t rx_ns)
+{
+    struct raw_lat_flow *f = raw_lat_flow_of(vl_id);
+    if (!f)
+        return;
+
+    const uint64_t key = raw_lat_key(vl_id, seq);
+    struct raw_lat_slot *s = raw_lat_slot_of(f, vl_id, seq);
+    if (__atomic_load_n(&s->key, __ATOMIC_ACQUIRE) != key) {
+        __atomic_fetch_add(&f->unmatched, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    uint64_t tx_ns = __atomic_load_n(&s->tx_ns, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&s->key, __ATOMIC_RELAXED) != key) {
+        __atomic_fetch_add(&f->unmatched, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    if (rx_ns < tx_ns) {
+        __atomic_fetch_add(&f->negative, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    uint64_t lat_ns = rx_ns - tx_ns;
+    unsigned b = 0;
+    if (lat_ns >> RAW_LAT_HIST_BASE_SHIFT) {
+        b = 64 - __builtin_clzll(lat_ns) - RAW_LAT_HIST_BASE_SHIFT;
+        if (b >= RAW_LAT_HIST_BUCKETS)
+            b = RAW_LAT_HIST_BUCKETS - 1;
+    }
+
+    __atomic_fetch_add(&f->hist[b], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&f->sum_ns, lat_ns, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&f->samples, 1, __ATOMIC_RELAXED);
+}
+
+// ==========================================
+// SOCKET SETUP
+// ==========================================
+
+bool raw_lat_enable_nic(const char *ifname)
+{
+#if RAW_SOCKET_TIMESTAMPING >= 2
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+        return false;
+
+    struct hwtstamp_config hwconfig = {0};
+    hwconfig.tx_type = HWTSTAMP_TX_ON;
+    hwconfig.rx_filter = HWTSTAMP_FILTER_ALL;
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifname, IFNAMSIZ - 1);
+    ifr.ifr_data = (void *)&hwconfig;
+
+    bool ok = ioctl(fd, SIOCSHWTSTAMP, &ifr) == 0;
+    close(fd);
+
+    if (ok)
+        printf("  Timestamping: hardware (tx_type=%d, rx_filter=%d)\n",
+               hwconfig.tx_type, hwconfig.rx_filter);
+    else
+        printf("  Timestamping: SIOCSHWTSTAMP failed on %s (%s), using software\n",
+               ifname, strerror(errno));
+    return ok;
+#else
+    (void)ifname;
+#if RAW_SOCKET_TIMESTAMPING
+    printf("  Timestamping: software\n");
+#endif
+    return false;
+#endif
+}
+
+int raw_lat_enable_tx_socket(int fd, bool hw)
+{
+    // Her frame errqueue'ya tek mesaj üretir: HW varsa sadece HW TX
+    int flags = SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+    if (hw)
+        flags |= SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+    else
+        flags |= SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
+        fprintf(stderr, "Warning: SO_TIMESTAMPING (TX) failed: %s\n", strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+int raw_lat_enable_rx_socket(int fd, bool hw)
+{
+    // skb RX zamanı (yoksa kernel ring'e kopyalama anını yazar)
+    int flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    if (hw)
+        flags |= SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
+        fprintf(stderr, "Warning: SO_TIMESTAMPING (RX) failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    // tpacket header'ına hangi zamanın yazılacağı (HW yoksa SW'ye düşer)
+    int ts_src = hw ? SOF_TIMESTAMPING_RAW_HARDWARE : SOF_TIMESTAMPING_SOFTWARE;
+    if (setsockopt(fd, SOL_PACKET, PACKET_TIMESTAMP, &ts_src, sizeof(ts_src)) < 0) {
+        fprintf(stderr, "Warning: PACKET_TIMESTAMP failed: %s\n", strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+// ==========================================
+// TX ERRQUEUE
+// ==========================================
+
+#define RAW_LAT_ERRQ_BATCH      32
+#define RAW_LAT_ERRQ_MAX_ROUNDS 8       // Çağrı başına üst sınır (TX döngüsünü bekletmesin)
+#define RAW_LAT_CTRL_LEN        256
+
+void raw_lat_tx_drain(int fd, struct raw_lat_tx_track *t)
+{
+    struct mmsghdr msgs[RAW_LAT_ERRQ_BATCH];
+    char ctrl[RAW_LAT_ERRQ_BATCH][RAW_LAT_CTRL_LEN] __attribute__((aligned(8)));
+
+    for (int round = 0; round < RAW_LAT_ERRQ_MAX_ROUNDS; round++) {
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = 0; i < RAW_LAT_ERRQ_BATCH; i++) {
+            msgs[i].msg_hdr.msg_control = ctrl[i];
+            msgs[i].msg_hdr.msg_controllen = RAW_LAT_CTRL_LEN;
+        }
+
+        int n = recvmmsg(fd, msgs, RAW_LAT_ERRQ_BATCH, MSG_ERRQUEUE | MSG_DONTWAIT, NULL);
+        if (n <= 0)
+            return;
+
+        for (int i = 0; i < n; i++) {
+            const struct scm_timestamping *tss = NULL;
+            const struct sock_extended_err *ee = NULL;
+
+            for (struct cmsghdr *cm = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cm;
+                 cm = CMSG_NXTHDR(&msgs[i].msg_hdr, cm)) {
+                if (cm->cmsg_level == SOL_SOCKET && cm->cmsg_type == SCM_TIMESTAMPING)
+                    tss = (const struct scm_timestamping *)CMSG_DATA(cm);
+                else if (cm->cmsg_level == SOL_PACKET && cm->cmsg_type == PACKET_TX_TIMESTAMP)
+                    ee = (const struct sock_extended_err *)CMSG_DATA(cm);
+            }
+            if (!tss || !ee || ee->ee_errno != ENOMSG ||
+                ee->ee_origin != SO_EE_ORIGIN_TIMESTAMPING)
+                continue;
+
+            uint32_t id = ee->ee_data;
+            uint32_t idx = id & (RAW_LAT_TX_PENDING - 1);
+            if (t->pending[idx].id != id || t->pending[idx].seq == UINT64_MAX)
+                continue;
+
+            // ts[2]: raw hardware, ts[0]: software
+            const struct timespec *ts = (tss->ts[2].tv_sec || tss->ts[2].tv_nsec) ?
+                                        &tss->ts[2] : &tss->ts[0];
+            raw_lat_tx_sample(t->pending[idx].vl_id, t->pending[idx].seq,
+                              (uint64_t)ts->tv_sec * 1000000000ULL + (uint64_t)ts->tv_nsec);
+            t->pending[idx].seq = UINT64_MAX;   // Tek kullanım
+        }
+
+        if (n < RAW_LAT_ERRQ_BATCH)
+            return;
+    }
+}
+
+// ==========================================
+// REPORTING
+// ==========================================
+
+static void format_bucket(char *buf, size_t len, int b)
+{
+    if (b < 0) {
+        snprintf(buf, len, "-");
+        return;
+    }
+    if (b >= RAW_LAT_HIST_BUCKETS - 1) {
+        snprintf(buf, len, ">=%lums",
+                 (unsigned long)((1ULL << (RAW_LAT_HIST_BASE_SHIFT + RAW_LAT_HIST_BUCKETS - 2)) / 1000000ULL));
+        return;
+    }
+
+    uint64_t upper_ns = 1ULL << (RAW_LAT_HIST_BASE_SHIFT + b);
+    if (upper_ns < 1000)
+        snprintf(buf, len, "<%luns", upper_ns);
+    else if (upper_ns < 1000000)
+        snprintf(buf, len, "<%.1fus", (double)upper_ns / 1000.0);
+    else
+        snprintf(buf, len, "<%.1fms", (double)upper_ns / 1000000.0);
+}
+
+// Histogramdan yüzdelik dilimin bucket'ını bul (üst sınır raporlanır)
+static int hist_percentile(const uint64_t *hist, uint64_t total, double pct)
+{
+    if (total == 0)
+        return -1;
+
+    uint64_t target = (uint64_t)((double)total * pct);
+    if (target == 0)
+        target = 1;
+
+    uint64_t acc = 0;
+    for (int b = 0; b < RAW_LAT_HIST_BUCKETS; b++) {
+        acc += hist[b];
+        if (acc >= target)
+            return b;
+    }
+    return RAW_LAT_HIST_BUCKETS - 1;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/** Interval sonucunu baseline ile karşılaştır, alarm varsa yazdır */
+static void raw_lat_check_trend(struct raw_lat_trend *t, const char *label,
+                                uint64_t samples, double avg_us, int p99)
+{
+    if (samples < RAW_LAT_ALARM_MIN_SAMPLES)
+        return;
+
+    if (t->baseline_avg == 0.0) {
+        t->base_avg[t->base_count++] = avg_us;
+        if (t->base_count == RAW_LAT_BASELINE_INTERVALS) {
+            double sorted[RAW_LAT_BASELINE_INTERVALS];
+            memcpy(sorted, t->base_avg, sizeof(sorted));
+            qsort(sorted, RAW_LAT_BASELINE_INTERVALS, sizeof(sorted[0]), cmp_double);
+            t->baseline_avg = sorted[RAW_LAT_BASELINE_INTERVALS / 2];
+            if (t->baseline_avg <= 0.0)
+                t->baseline_avg = 0.001;
+        }
+    } else if (avg_us > t->baseline_avg * (100 + RAW_LAT_DRIFT_PCT) / 100.0) {
+        if (++t->drift_run >= RAW_LAT_DRIFT_HOLD && !t->drift_alarm) {
+            t->drift_alarm = true;
+            lat_alarm_count++;
+            printf("  ALARM %s: avg drift %.2f us -> %.2f us (+%.0f%%, %d intervals)\n",
+                   label, t->baseline_avg, avg_us,
+                   (avg_us / t->baseline_avg - 1.0) * 100.0, t->drift_run);
+        }
+    } else {
+        if (t->drift_alarm)
+            printf("  %s: drift cleared (avg %.2f us)\n", label, avg_us);
+        t->drift_run = 0;
+        t->drift_alarm = false;
+    }
+
+    if (t->prev_p99 >= 0 && p99 - t->prev_p99 >= RAW_LAT_STEP_BUCKETS) {
+        char from[16], to[16];
+        format_bucket(from, sizeof(from), t->prev_p99);
+        format_bucket(to, sizeof(to), p99);
+        lat_alarm_count++;
+        printf("  ALARM %s: p99 step %s -> %s\n", label, from, to);
+    }
+    t->prev_p99 = p99;
+}
+
+void raw_lat_print_stats(void)
+{
+#if RAW_SOCKET_TIMESTAMPING
+    uint32_t count = lat_flow_count;
+    if (count == 0)
+        return;
+
+    printf("\n=== RAW PORT ONE-WAY LATENCY (1/%u sampled, last interval) ===\n",
+           1U << RAW_LAT_SAMPLE_SHIFT);
+    printf("%-20s %10s %10s %9s %9s %9s %9s %9s\n",
+           "Flow", "Samples", "Unmatched", "Avg(us)", "p50", "p99", "p99.9", "Max");
+
+    for (uint32_t i = 0; i < count; i++) {
+        struct raw_lat_flow *f = &lat_flows[i];
+        struct raw_lat_snapshot cur;
+        cur.samples = __atomic_load_n(&f->samples, __ATOMIC_RELAXED);
+        cur.unmatched = __atomic_load_n(&f->unmatched, __ATOMIC_RELAXED);
+        cur.negative = __atomic_load_n(&f->negative, __ATOMIC_RELAXED);
+        cur.sum_ns = __atomic_load_n(&f->sum_ns, __ATOMIC_RELAXED);
+
+        uint64_t hist[RAW_LAT_HIST_BUCKETS];
+        uint64_t hist_total = 0;
+        int max_bucket = -1;
+        for (int b = 0; b < RAW_LAT_HIST_BUCKETS; b++) {
+            cur.hist[b] = __atomic_load_n(&f->hist[b], __ATOMIC_RELAXED);
+            hist[b] = cur.hist[b] - lat_prev[i].hist[b];
+            hist_total += hist[b];
+            if (hist[b] > 0)
+                max_bucket = b;
+        }
+
+        struct raw_lat_snapshot *prev = &lat_prev[i];
+        uint64_t samples = cur.samples - prev->samples;
+        uint64_t unmatched = cur.unmatched - prev->unmatched;
+        uint64_t negative = cur.negative - prev->negative;
+        uint64_t sum = cur.sum_ns - prev->sum_ns;
+        *prev = cur;
+
+        double avg_us = samples ? (double)sum / (double)samples / 1000.0 : 0.0;
+
+        char p50[16], p99[16], p999[16], pmax[16];
+        int p99_bucket = hist_percentile(hist, hist_total, 0.99);
+        format_bucket(p50, sizeof(p50), hist_percentile(hist, hist_total, 0.50));
+        format_bucket(p99, sizeof(p99), p99_bucket);
+        format_bucket(p999, sizeof(p999), hist_percentile(hist, hist_total, 0.999));
+        format_bucket(pmax, sizeof(pmax), max_bucket);
+
+        printf("%-20s %10lu %10lu %9.2f %9s %9s %9s %9s",
+               f->label, samples, unmatched, avg_us, p50, p99, p999, pmax);
+        if (negative)
+            printf("  (rx<tx: %lu, clock sync?)", negative);
+        printf("\n");
+
+        raw_lat_check_trend(&lat_trend[i], f->label, hist_total, avg_us, p99_bucket);
+    }
+
+    if (lat_alarm_count)
+        printf("Latency alarms so far: %lu\n", lat_alarm_count);
+#endif
+}
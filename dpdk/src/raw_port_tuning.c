@@ -0,0 +1,320 @@
+#include "raw_port_tuning.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <dirent.h>
+#include <sys/socket.h>
+
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+#ifndef SO_PREFER_BUSY_POLL
+#define SO_PREFER_BUSY_POLL 69
+#endif
+#ifndef SO_BUSY_POLL_BUDGET
+#define SO_BUSY_POLL_BUDGET 70
+#endif
+
+#define RAW_TUNE_MASK_WORDS 32      // 1024 CPU'ya kadar maske
+
+// ==========================================
+// SAVE / RESTORE
+// ==========================================
+
+struct raw_tune_saved {
+    char path[128];
+    char value[256];
+};
+
+static struct raw_tune_saved saved[RAW_TUNE_MAX_SAVED];
+static int saved_count = 0;
+
+static int read_file(const char *path, char *buf, size_t len)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+
+    size_t n = fread(buf, 1, len - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+    while (n > 0 && (buf[n - 1] == '\n' || buf[n - 1] == ' '))
+        buf[--n] = '\0';
+    return 0;
+}
+
+static int write_file(const char *path, const char *value)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return -1;
+
+    int ok = fprintf(f, "%s\n", value) > 0;
+    // Kernel değeri reddederse hata fclose'da döner
+    if (fclose(f) != 0)
+        ok = 0;
+    return ok ? 0 : -1;
+}
+
+// Eski değeri sakla, yenisini yaz (aynıysa dokunma)
+static int tune_write(const char *path, const char *value)
+{
+    char old[sizeof(saved[0].value)];
+    if (read_file(path, old, sizeof(old)) < 0)
+        return -1;
+    if (strcmp(old, value) == 0)
+        return 0;
+
+    if (saved_count >= RAW_TUNE_MAX_SAVED) {
+        fprintf(stderr, "  Warning: tuning restore table full, skipping %s\n", path);
+        return -1;
+    }
+    if (write_file(path, value) < 0) {
+        fprintf(stderr, "  Warning: cannot write %s: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    struct raw_tune_saved *s = &saved[saved_count++];
+    snprintf(s->path, sizeof(s->path), "%s", path);
+    snprintf(s->value, sizeof(s->value), "%s", old);
+    return 0;
+}
+
+void raw_tune_restore(void)
+{
+    if (saved_count == 0)
+        return;
+
+    printf("Restoring %d IRQ/RPS/XPS/busy-poll settings\n", saved_count);
+    for (int i = saved_count - 1; i >= 0; i--) {
+        // Boş okunan değer geri yazılamaz
+        if (saved[i].value[0] == '\0')
+            continue;
+        if (write_file(saved[i].path, saved[i].value) < 0)
+            fprintf(stderr, "  Warning: cannot restore %s\n", saved[i].path);
+    }
+    saved_count = 0;
+}
+
+// ==========================================
+// BUSY POLL
+// ==========================================
+
+int raw_tune_busy_poll(int fd, const char *tag)
+{
+#if RAW_SOCKET_BUSY_POLL_US > 0
+    int usecs = RAW_SOCKET_BUSY_POLL_US;
+    int prefer = RAW_SOCKET_PREFER_BUSY_POLL;
+    int budget = RAW_SOCKET_BUSY_POLL_BUDGET;
+
+    // sysctl net.core.busy_read üstü değerler CAP_NET_ADMIN ister
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &usecs, sizeof(usecs)) < 0) {
+        fprintf(stderr, "%s Warning: SO_BUSY_POLL=%d failed: %s\n", tag, usecs, strerror(errno));
+        return -1;
+    }
+    if (prefer && setsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &prefer, sizeof(prefer)) < 0) {
+        fprintf(stderr, "%s Warning: SO_PREFER_BUSY_POLL failed: %s\n", tag, strerror(errno));
+    }
+    if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &budget, sizeof(budget)) < 0) {
+        fprintf(stderr, "%s Warning: SO_BUSY_POLL_BUDGET=%d failed: %s\n", tag, budget, strerror(errno));
+    }
+
+    // Kernel'in uyguladığı değerler
+    int eff_usecs = 0, eff_prefer = 0, eff_budget = 0;
+    socklen_t len = sizeof(int);
+    getsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &eff_usecs, &len);
+    len = sizeof(int);
+    getsockopt(fd, SOL_SOCKET, SO_PREFER_BUSY_POLL, &eff_prefer, &len);
+    len = sizeof(int);
+    getsockopt(fd, SOL_SOCKET, SO_BUSY_POLL_BUDGET, &eff_budget, &len);
+    printf("%s busy-poll: %d us, prefer=%d, budget=%d\n", tag, eff_usecs, eff_prefer, eff_budget);
+    return eff_usecs > 0 ? 0 : -1;
+#else
+    (void)fd;
+    (void)tag;
+    return -1;
+#endif
+}
+
+void raw_tune_busy_poll_sysctl(void)
+{
+#if RAW_SOCKET_BUSY_POLL_US > 0
+    static bool done = false;
+    if (done)
+        return;
+    done = true;
+
+    const char *path = "/proc/sys/net/core/busy_poll";
+    char cur[32];
+    if (read_file(path, cur, sizeof(cur)) < 0)
+        return;
+    if (atoi(cur) >= RAW_SOCKET_BUSY_POLL_US) {
+        printf("net.core.busy_poll = %s us (kept)\n", cur);
+        return;
+    }
+
+    char val[32];
+    snprintf(val, sizeof(val), "%d", RAW_SOCKET_BUSY_POLL_US);
+    if (tune_write(path, val) == 0)
+        printf("net.core.busy_poll = %s us (was %s)\n", val, cur);
+#endif
+}
+
+// ==========================================
+// IRQ / RPS / XPS
+// ==========================================
+
+static void cpu_mask_str(const uint16_t *cpus, int n, char *out, size_t len)
+{
+    uint32_t words[RAW_TUNE_MASK_WORDS] = {0};
+    int top = 0;
+
+    for (int i = 0; i < n; i++) {
+        int w = cpus[i] / 32;
+        if (w >= RAW_TUNE_MASK_WORDS)
+            continue;
+        words[w] |= 1u << (cpus[i] % 32);
+        if (w > top)
+            top = w;
+    }
+
+    size_t pos = 0;
+    out[0] = '\0';
+    for (int w = top; w >= 0 && pos < len; w--)
+        pos += snprintf(out + pos, len - pos, "%s%08x", w == top ? "" : ",", words[w]);
+}
+
+// /proc/interrupts satırında arayüz adı tam kelime olarak geçiyor mu
+// (eno1 eno12399'a eşleşmesin): "eno12399-TxRx-0", "i40e-eno12399-TxRx-0"
+static bool irq_line_matches(const char *line, const char *ifname)
+{
+    size_t n = strlen(ifname);
+    for (const char *p = strstr(line, ifname); p; p = strstr(p + 1, ifname)) {
+        char before = (p == line) ? ' ' : p[-1];
+        char after = p[n];
+        if ((before == ' ' || before == '-') &&
+            (after == '-' || after == '\n' || after == '\0' || after == ' ' || after == '@'))
+            return true;
+    }
+    return false;
+}
+
+static int find_iface_irqs(const char *ifname, int *irqs, int max)
+{
+    int count = 0;
+
+    // Satır başına CPU başına bir sütun: çok çekirdekli hostlarda satırlar
+    // sabit bir tampondan uzun olur, getline tüm satırı okur
+    FILE *f = fopen("/proc/interrupts", "r");
+    if (f) {
+        char *line = NULL;
+        size_t cap = 0;
+        while (count < max && getline(&line, &cap, f) > 0) {
+            char *end;
+            long irq = strtol(line, &end, 10);
+            if (end == line || *end != ':')
+                continue;
+            if (irq_line_matches(end, ifname))
+                irqs[count++] = (int)irq;
+        }
+        free(line);
+        fclose(f);
+    }
+    if (count > 0)
+        return count;
+
+    // Vektörleri arayüz adıyla isimlendirmeyen sürücüler: MSI listesi
+    char path[256];
+    snprintf(path, sizeof(path), "/sys/class/net/%s/device/msi_irqs", ifname);
+    DIR *d = opendir(path);
+    if (!d)
+        return 0;
+    struct dirent *e;
+    while (count < max && (e = readdir(d)) != NULL) {
+        if (isdigit((unsigned char)e->d_name[0]))
+            irqs[count++] = atoi(e->d_name);
+    }
+    closedir(d);
+    return count;
+}
+
+// queues/rx-* (rps_cpus) veya queues/tx-* (xps_cpus)
+static int tune_queue_masks(const char *ifname, const char *prefix, const char *file,
+                            const uint16_t *cpus, int n, bool per_queue)
+{
+    char dir_path[256];
+    snprintf(dir_path, sizeof(dir_path), "/sys/class/net/%s/queues", ifname);
+    DIR *d = opendir(dir_path);
+    if (!d)
+        return 0;
+
+    int done = 0;
+    size_t plen = strlen(prefix);
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        if (strncmp(e->d_name, prefix, plen) != 0)
+            continue;
+        int q = atoi(e->d_name + plen);
+
+        char mask[RAW_TUNE_MASK_WORDS * 9 + 1];
+        if (per_queue)
+            cpu_mask_str(&cpus[q % n], 1, mask, sizeof(mask));
+        else
+            cpu_mask_str(cpus, n, mask, sizeof(mask));
+
+        char path[sizeof(dir_path) + sizeof(e->d_name) + 16];
+        snprintf(path, sizeof(path), "%s/%s/%s", dir_path, e->d_name, file);
+        if (tune_write(path, mask) == 0) {
+            printf("  %s %s = %s\n", e->d_name, file, mask);
+            done++;
+        }
+    }
+    closedir(d);
+    return done;
+}
+
+int raw_tune_irq_affinity(const char *ifname, const uint16_t *rx_cpus, int n_rx,
+                          const uint16_t *tx_cpus, int n_tx)
+{
+#if RAW_SOCKET_IRQ_AFFINITY
+    if (!ifname || n_rx <= 0)
+        return 0;
+
+    printf("\n=== IRQ/RPS/XPS affinity for %s ===\n", ifname);
+
+    int irqs[64];
+    int irq_count = find_iface_irqs(ifname, irqs, 64);
+    int pinned = 0;
+
+    for (int k = 0; k < irq_count; k++) {
+        char path[64], val[16], eff[64] = "?";
+        snprintf(path, sizeof(path), "/proc/irq/%d/smp_affinity_list", irqs[k]);
+        snprintf(val, sizeof(val), "%u", rx_cpus[k % n_rx]);
+        if (tune_write(path, val) < 0)
+            continue;
+        pinned++;
+
+        snprintf(path, sizeof(path), "/proc/irq/%d/effective_affinity_list", irqs[k]);
+        read_file(path, eff, sizeof(eff));
+        printf("  IRQ %d -> CPU %s (effective %s)\n", irqs[k], val, eff);
+    }
+    if (irq_count == 0)
+        printf("  No IRQs found for %s (virtual interface?)\n", ifname);
+
+    tune_queue_masks(ifname, "rx-", "rps_cpus", rx_cpus, n_rx, false);
+    if (n_tx > 0)
+        tune_queue_masks(ifname, "tx-", "xps_cpus", tx_cpus, n_tx, true);
+
+    printf("  %d/%d IRQs pinned to RX cores\n", pinned, irq_count);
+    return pinned;
+#else
+    (void)ifname;
+    (void)rx_cpus;
+    (void)n_rx;
+    (void)tx_cpus;
+    (void)n_tx;
+    return 0;
+#endif
+}
@@ -3,6 +3,10 @@
 #include "packet.h"
 #include "dpdk_external_tx.h"
 #include "socket.h"  // for get_unused_cores()
+#include "lcore_planner.h"  // for lcore_plan_take_raw_cores()
+#include "raw_port_tuning.h"  // busy-poll, IRQ/RPS/XPS affinity
+#include "raw_latency.h"  // SO_TIMESTAMPING one-way latency
+#include "stats_service.h"  // raw_socket_stats_snapshot()
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,6 +21,7 @@
 #include <netinet/ip.h>
 #include <netinet/udp.h>
 #include <linux/if_packet.h>
+#include <linux/filter.h>   // cBPF fanout programı
 #include <arpa/inet.h>
 #include <poll.h>
 #include <sched.h>
@@ -27,8 +32,12 @@
 // GLOBAL VARIABLES
 // ==========================================
 
-struct raw_socket_port raw_ports[MAX_RAW_SOCKET_PORTS];
-struct raw_socket_port_config raw_port_configs[MAX_RAW_SOCKET_PORTS] = RAW_SOCKET_PORTS_CONFIG_INIT;
+struct raw_socket_port_config raw_port_configs[] = RAW_SOCKET_PORTS_CONFIG_INIT;
+const uint16_t raw_port_config_count = sizeof(raw_port_configs) / sizeof(raw_port_configs[0]);
+
+// init_raw_socket_ports ayırır; o zamana kadar raw_port_count = 0
+struct raw_socket_port **raw_ports = NULL;
+uint16_t raw_port_count = 0;
 
 static volatile bool *g_stop_flag = NULL;
 
@@ -64,9 +73,48 @@ static struct global_vl_seq_state g_vl_seq_p13[GLOBAL_SEQ_VL_ID_COUNT_P13];
 #define g_vl_seq g_vl_seq_p12
 static _Atomic bool g_seq_tracking_reset = false;
 
+static struct raw_socket_port *raw_port_by_id(uint16_t port_id)
+{
+    for (int i = 0; i < raw_port_count; i++) {
+        if (raw_ports[i]->port_id == port_id)
+            return raw_ports[i];
+    }
+    return NULL;
+}
+
+// VL-ID steering: her VL-ID tek kuyrukta, kayıp kuyruk tracker'larından
+static uint64_t raw_vl_track_lost(const struct raw_socket_port *port, uint64_t *worst_lost,
+                                  uint16_t *worst_vl_id, int *vl_with_loss)
+{
+    uint64_t total_lost = 0;
+    for (int q = 0; q < port->rx_queue_count; q++) {
+        const struct raw_vl_track *vt = port->rx_queues[q].vl_track;
+        if (!vt) continue;
+        for (uint16_t i = 0; i < port->vl_track_count; i++) {
+            uint64_t rx_cnt = raw_stat_read(&vt[i].rx_count);
+            if (rx_cnt == 0) continue;
+            uint64_t expected = raw_stat_read(&vt[i].max_seq) - raw_stat_read(&vt[i].min_seq) + 1;
+            if (expected <= rx_cnt) continue;
+            uint64_t lost = expected - rx_cnt;
+            total_lost += lost;
+            if (vl_with_loss) (*vl_with_loss)++;
+            if (worst_lost && lost > *worst_lost) {
+                *worst_lost = lost;
+                *worst_vl_id = port->vl_track_base + i;
+            }
+        }
+    }
+    return total_lost;
+}
+
 // Reset global sequence tracking (call before starting a new test)
 void reset_global_sequence_tracking(void)
 {
+    // VL-ID steering: tracker'lar kuyruk thread'lerine ait, sıfırlamayı
+    // thread'in kendisi yapar (raw_vl_track_sync)
+    for (int i = 0; i < raw_port_count; i++)
+        __atomic_add_fetch(&raw_ports[i]->vl_track_gen, 1, __ATOMIC_RELEASE);
+
     // Reset Port 12 tracking
     for (int i = 0; i < GLOBAL_SEQ_VL_ID_COUNT_P12; i++) {
         atomic_store(&g_vl_seq_p12[i].min_seq, UINT64_MAX);
@@ -87,6 +135,10 @@ void reset_global_sequence_tracking(void)
 // Get global sequence tracking lost count for Port 12
 uint64_t get_global_sequence_lost(void)
 {
+    struct raw_socket_port *port = raw_port_by_id(12);
+    if (port && port->vl_steered)
+        return raw_vl_track_lost(port, NULL, NULL, NULL);
+
     uint64_t total_lost = 0;
     for (int i = 0; i < GLOBAL_SEQ_VL_ID_COUNT_P12; i++) {
         if (atomic_load(&g_vl_seq_p12[i].initialized)) {
@@ -105,6 +157,10 @@ uint64_t get_global_sequence_lost(void)
 // Get global sequence tracking lost count for Port 13
 uint64_t get_global_sequence_lost_p13(void)
 {
+    struct raw_socket_port *port = raw_port_by_id(13);
+    if (port && port->vl_steered)
+        return raw_vl_track_lost(port, NULL, NULL, NULL);
+
     uint64_t total_lost = 0;
     for (int i = 0; i < GLOBAL_SEQ_VL_ID_COUNT_P13; i++) {
         if (atomic_load(&g_vl_seq_p13[i].initialized)) {
@@ -123,6 +179,20 @@ uint64_t get_global_sequence_lost_p13(void)
 // Debug: Print per-VL-ID sequence statistics
 void print_global_sequence_debug(void)
 {
+    struct raw_socket_port *port = raw_port_by_id(12);
+    if (port && port->vl_steered) {
+        uint64_t worst_lost = 0;
+        uint16_t worst_vl_id = 0;
+        int vl_with_loss = 0;
+        uint64_t lost = raw_vl_track_lost(port, &worst_lost, &worst_vl_id, &vl_with_loss);
+        printf("  VL-ID Steered Sequence (per-queue trackers): lost=%lu\n", lost);
+        if (vl_with_loss > 0) {
+            printf("    ⚠️  %d VL-IDs have loss, worst: VL-ID %u with %lu lost\n",
+                   vl_with_loss, worst_vl_id, worst_lost);
+        }
+        return;
+    }
+
     printf("  Global Sequence Debug (first 5 active VL-IDs):\n");
     int printed = 0;
     int total_with_loss = 0;
@@ -213,6 +283,8 @@ void init_raw_rate_limiter(struct raw_rate_limiter *limiter, uint32_t rate_mbps)
     limiter->smooth_pacing_enabled = false;
     limiter->delay_ns = 0;
     limiter->next_send_time_ns = 0;
+    limiter->last_slot_ns = 0;
+    limiter->resync_slots = 0;
 }
 
 // Initialize rate limiter with smooth pacing (timestamp-based like DPDK)
@@ -246,6 +318,8 @@ void init_raw_rate_limiter_smooth(struct raw_rate_limiter *limiter, uint32_t rat
     uint64_t stagger_interval_ns = 50000000ULL;  // 50ms per target
     uint64_t stagger_offset = (uint64_t)target_id * stagger_interval_ns;
     limiter->next_send_time_ns = get_time_ns() + stagger_offset;
+    limiter->last_slot_ns = 0;
+    limiter->resync_slots = 0;
 
     limiter->smooth_pacing_enabled = true;
 
@@ -272,10 +346,12 @@ bool raw_check_smooth_pacing(struct raw_rate_limiter *limiter)
 
     // If we're too far behind (>2ms), reset to now (prevents large burst)
     if (limiter->next_send_time_ns + 2000000ULL < now) {
+        limiter->resync_slots += (now - limiter->next_send_time_ns) / limiter->delay_ns;
         limiter->next_send_time_ns = now;
     }
 
     // Schedule next packet
+    limiter->last_slot_ns = limiter->next_send_time_ns;
     limiter->next_send_time_ns += limiter->delay_ns;
 
     return true;
@@ -320,7 +396,7 @@ bool raw_consume_tokens(struct raw_rate_limiter *limiter, uint64_t bytes)
 
 #define PRBS31_TAP1 31
 #define PRBS31_TAP2 28
-#define RAW_PRBS_CACHE_SIZE (268435456)
+#define RAW_PRBS_CACHE_SIZE PKT_PRBS_CACHE_SIZE
 
 static uint32_t prbs31_next(uint32_t state)
 {
@@ -438,78 +514,82 @@ int build_raw_packet(uint8_t *buffer, const uint8_t *src_mac,
     return RAW_PKT_TOTAL_SIZE;
 }
 
-#if IMIX_ENABLED
-// IMIX: Dinamik boyutlu paket oluştur
-int build_raw_packet_dynamic(uint8_t *buffer, const uint8_t *src_mac,
-                              uint16_t vl_id, uint64_t sequence,
-                              const uint8_t *prbs_data, uint16_t prbs_len,
-                              uint16_t pkt_size)
+// ==========================================
+// IN-RING FRAME BUILD (per-VL header templates)
+// ==========================================
+// ETH+IP+UDP header her VL-ID için bir kez damgalanır. Gönderimde header
+// şablondan, seq ve PRBS doğrudan ring frame'ine yazılır: PRBS tek kopya.
+// Sadece uzunluk alanları ve IP checksum paket boyutuna göre tamamlanır.
+
+void raw_tx_hdr_template_init(struct raw_tx_hdr_template *t, uint16_t vl_id)
 {
     static const uint8_t fixed_src_mac[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x20};
-    (void)src_mac;
+    uint8_t *h = t->hdr;
 
-    // Ethernet Header
-    buffer[0] = 0x03;
-    buffer[1] = 0x00;
-    buffer[2] = 0x00;
-    buffer[3] = 0x00;
-    buffer[4] = (vl_id >> 8) & 0xFF;
-    buffer[5] = vl_id & 0xFF;
-    memcpy(buffer + 6, fixed_src_mac, 6);
-    buffer[12] = 0x08;
-    buffer[13] = 0x00;
-
-    // IPv4 Header (dinamik total_length)
-    uint8_t *ip = buffer + RAW_PKT_ETH_HDR_SIZE;
-    uint16_t payload_size = pkt_size - RAW_PKT_ETH_HDR_SIZE - RAW_PKT_IP_HDR_SIZE - RAW_PKT_UDP_HDR_SIZE;
-    uint16_t ip_total_len = RAW_PKT_IP_HDR_SIZE + RAW_PKT_UDP_HDR_SIZE + payload_size;
+    memset(h, 0, sizeof(t->hdr));
 
+    // Ethernet Header
+    h[0] = 0x03;
+    h[4] = (vl_id >> 8) & 0xFF;
+    h[5] = vl_id & 0xFF;
+    memcpy(h + 6, fixed_src_mac, 6);
+    h[12] = 0x08;
+    h[13] = 0x00;
+
+    // IPv4 Header (total_length ve checksum gönderimde)
+    uint8_t *ip = h + RAW_PKT_ETH_HDR_SIZE;
     ip[0] = 0x45;
-    ip[1] = 0x00;
-    ip[2] = (ip_total_len >> 8) & 0xFF;
-    ip[3] = ip_total_len & 0xFF;
-    ip[4] = 0x00;
-    ip[5] = 0x00;
     ip[6] = 0x40;
-    ip[7] = 0x00;
     ip[8] = 0x01;
     ip[9] = 0x11;
-    ip[10] = 0x00;
-    ip[11] = 0x00;
     ip[12] = 0x0A;
-    ip[13] = 0x00;
-    ip[14] = 0x00;
-    ip[15] = 0x00;
     ip[16] = 0xE0;
     ip[17] = 0xE0;
     ip[18] = (vl_id >> 8) & 0xFF;
     ip[19] = vl_id & 0xFF;
 
-    // IP Checksum
-    uint16_t ip_checksum = calculate_ip_checksum_raw(ip);
-    ip[10] = (ip_checksum >> 8) & 0xFF;
-    ip[11] = ip_checksum & 0xFF;
-
-    // UDP Header (dinamik dgram_len)
+    // UDP Header (dgram_len gönderimde)
     uint8_t *udp = ip + RAW_PKT_IP_HDR_SIZE;
-    udp[0] = 0x00;
     udp[1] = 0x64;
-    udp[2] = 0x00;
     udp[3] = 0x64;
-    uint16_t udp_len = RAW_PKT_UDP_HDR_SIZE + payload_size;
+
+    // total_length=0, checksum=0 iken kısmi toplam
+    uint32_t sum = 0;
+    for (int i = 0; i < RAW_PKT_IP_HDR_SIZE; i += 2)
+        sum += ((uint32_t)ip[i] << 8) | ip[i + 1];
+    t->ip_csum_partial = sum;
+}
+
+static inline uint16_t raw_tx_build_frame(uint8_t *frame, const struct raw_tx_hdr_template *t,
+                                          uint16_t pkt_size, uint64_t sequence,
+                                          const uint8_t *prbs_cache_ext, uint16_t prbs_len)
+{
+    memcpy(frame, t->hdr, RAW_PKT_HDR_SIZE);
+
+    uint8_t *ip = frame + RAW_PKT_ETH_HDR_SIZE;
+    uint16_t ip_total_len = pkt_size - RAW_PKT_ETH_HDR_SIZE;
+    uint32_t sum = t->ip_csum_partial + ip_total_len;
+    while (sum >> 16)
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    uint16_t csum = (uint16_t)~sum;
+
+    ip[2] = (ip_total_len >> 8) & 0xFF;
+    ip[3] = ip_total_len & 0xFF;
+    ip[10] = (csum >> 8) & 0xFF;
+    ip[11] = csum & 0xFF;
+
+    uint8_t *udp = ip + RAW_PKT_IP_HDR_SIZE;
+    uint16_t udp_len = ip_total_len - RAW_PKT_IP_HDR_SIZE;
     udp[4] = (udp_len >> 8) & 0xFF;
     udp[5] = udp_len & 0xFF;
-    udp[6] = 0x00;
-    udp[7] = 0x00;
 
-    // Payload (dinamik PRBS boyutu)
-    uint8_t *payload = udp + RAW_PKT_UDP_HDR_SIZE;
-    memcpy(payload, &sequence, RAW_PKT_SEQ_BYTES);
-    memcpy(payload + RAW_PKT_SEQ_BYTES, prbs_data, prbs_len);
+    pkt_payload_fill(udp + RAW_PKT_UDP_HDR_SIZE, sequence, prbs_cache_ext,
+                     RAW_PKT_PRBS_BYTES, prbs_len);
 
     return pkt_size;
 }
 
+#if IMIX_ENABLED
 // IMIX paket boyutu al (raw socket için - VLAN'sız)
 static inline uint16_t get_raw_imix_packet_size(uint64_t pkt_counter, uint8_t worker_offset)
 {
@@ -565,46 +645,71 @@ static int get_interface_mac(const char *if_name, uint8_t *mac)
     return 0;
 }
 
-int setup_raw_tx_ring(struct raw_socket_port *port)
+#if RAW_SOCKET_TIMESTAMPING
+_Static_assert(RAW_LAT_TX_PENDING >= RAW_SOCKET_RING_FRAME_NR,
+               "OPT_ID penceresi TX ring'deki tüm frame'leri kapsamalı");
+#endif
+
+// Lane'e özel PACKET_TX_RING soketi
+static int raw_tx_lane_open(struct raw_socket_port *port, struct raw_tx_lane *lane)
 {
-    port->tx_socket = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
-    if (port->tx_socket < 0) {
-        fprintf(stderr, "[Raw Port %d] Failed to create TX socket: %s\n",
-                port->port_id, strerror(errno));
+    lane->socket_fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+    if (lane->socket_fd < 0) {
+        fprintf(stderr, "[Raw Port %d L%u] Failed to create TX socket: %s\n",
+                port->port_id, lane->lane_id, strerror(errno));
         return -1;
     }
 
     int version = TPACKET_V2;
-    if (setsockopt(port->tx_socket, SOL_PACKET, PACKET_VERSION,
+    if (setsockopt(lane->socket_fd, SOL_PACKET, PACKET_VERSION,
                    &version, sizeof(version)) < 0) {
-        fprintf(stderr, "[Raw Port %d] Failed to set TPACKET_V2: %s\n",
-                port->port_id, strerror(errno));
-        close(port->tx_socket);
+        fprintf(stderr, "[Raw Port %d L%u] Failed to set TPACKET_V2: %s\n",
+                port->port_id, lane->lane_id, strerror(errno));
+        close(lane->socket_fd);
+        lane->socket_fd = -1;
         return -1;
     }
 
+#if RAW_SOCKET_TIMESTAMPING
+    // OPT_ID sayacı soketle başlar: lane tracker'ı da sıfırdan
+    memset(&lane->lat, 0, sizeof(lane->lat));
+    raw_lat_enable_tx_socket(lane->socket_fd, port->lat_hw);
+#endif
+
+#if RAW_SOCKET_TX_QDISC_BYPASS
+    int bypass = 1;
+    if (setsockopt(lane->socket_fd, SOL_PACKET, PACKET_QDISC_BYPASS,
+                   &bypass, sizeof(bypass)) < 0) {
+        fprintf(stderr, "[Raw Port %d L%u] Warning: PACKET_QDISC_BYPASS failed: %s\n",
+                port->port_id, lane->lane_id, strerror(errno));
+    }
+#endif
+
     struct tpacket_req req = {0};
     req.tp_block_size = RAW_SOCKET_RING_BLOCK_SIZE;
     req.tp_block_nr = RAW_SOCKET_RING_BLOCK_NR;
     req.tp_frame_size = RAW_SOCKET_RING_FRAME_SIZE;
     req.tp_frame_nr = RAW_SOCKET_RING_FRAME_NR;
 
-    if (setsockopt(port->tx_socket, SOL_PACKET, PACKET_TX_RING,
+    if (setsockopt(lane->socket_fd, SOL_PACKET, PACKET_TX_RING,
                    &req, sizeof(req)) < 0) {
-        fprintf(stderr, "[Raw Port %d] Failed to setup TX ring: %s\n",
-                port->port_id, strerror(errno));
-        close(port->tx_socket);
+        fprintf(stderr, "[Raw Port %d L%u] Failed to setup TX ring: %s\n",
+                port->port_id, lane->lane_id, strerror(errno));
+        close(lane->socket_fd);
+        lane->socket_fd = -1;
         return -1;
     }
 
-    port->tx_ring_size = req.tp_block_size * req.tp_block_nr;
-    port->tx_ring = mmap(NULL, port->tx_ring_size,
-                         PROT_READ | PROT_WRITE, MAP_SHARED,
-                         port->tx_socket, 0);
-    if (port->tx_ring == MAP_FAILED) {
-        fprintf(stderr, "[Raw Port %d] Failed to mmap TX ring: %s\n",
-                port->port_id, strerror(errno));
-        close(port->tx_socket);
+    lane->ring_size = req.tp_block_size * req.tp_block_nr;
+    lane->ring = mmap(NULL, lane->ring_size,
+                      PROT_READ | PROT_WRITE, MAP_SHARED,
+                      lane->socket_fd, 0);
+    if (lane->ring == MAP_FAILED) {
+        fprintf(stderr, "[Raw Port %d L%u] Failed to mmap TX ring: %s\n",
+                port->port_id, lane->lane_id, strerror(errno));
+        lane->ring = NULL;
+        close(lane->socket_fd);
+        lane->socket_fd = -1;
         return -1;
     }
 
@@ -613,52 +718,356 @@ int setup_raw_tx_ring(struct raw_socket_port *port)
     sll.sll_ifindex = port->if_index;
     sll.sll_protocol = htons(ETH_P_ALL);
 
-    if (bind(port->tx_socket, (struct sockaddr *)&sll, sizeof(sll)) < 0) {
-        fprintf(stderr, "[Raw Port %d] Failed to bind TX socket: %s\n",
-                port->port_id, strerror(errno));
-        munmap(port->tx_ring, port->tx_ring_size);
-        close(port->tx_socket);
+    if (bind(lane->socket_fd, (struct sockaddr *)&sll, sizeof(sll)) < 0) {
+        fprintf(stderr, "[Raw Port %d L%u] Failed to bind TX socket: %s\n",
+                port->port_id, lane->lane_id, strerror(errno));
+        munmap(lane->ring, lane->ring_size);
+        lane->ring = NULL;
+        close(lane->socket_fd);
+        lane->socket_fd = -1;
         return -1;
     }
 
-    port->tx_ring_offset = 0;
-    printf("[Raw Port %d] TX ring ready (%zu KB)\n", port->port_id, port->tx_ring_size / 1024);
+    pkt_io_init_mmap(&lane->io, lane->socket_fd, NULL, 0, 0, false,
+                     lane->ring, RAW_SOCKET_RING_FRAME_SIZE, RAW_SOCKET_RING_FRAME_NR);
     return 0;
 }
 
-int setup_raw_rx_ring(struct raw_socket_port *port)
+// Tüm lane'lerin TX soket/ring'lerini kapat (AF_XDP soketi RX tarafına ait)
+static void raw_tx_lanes_close(struct raw_socket_port *port)
 {
-    port->rx_socket = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
-    if (port->rx_socket < 0) {
-        fprintf(stderr, "[Raw Port %d] Failed to create RX socket: %s\n",
-                port->port_id, strerror(errno));
-        return -1;
+    for (int l = 0; l < port->tx_lane_count; l++) {
+        struct raw_tx_lane *lane = &port->tx_lanes[l];
+        if (lane->ring && lane->ring != MAP_FAILED)
+            munmap(lane->ring, lane->ring_size);
+        lane->ring = NULL;
+        if (lane->socket_fd >= 0)
+            close(lane->socket_fd);
+        lane->socket_fd = -1;
+        lane->xsk = NULL;
+        memset(&lane->io, 0, sizeof(lane->io));
     }
+}
+
+int raw_port_tx_lane_count(const struct raw_socket_port_config *config)
+{
+    int lanes = config->tx_lane_count;
+    if (lanes > config->tx_target_count)
+        lanes = config->tx_target_count;
+    if (lanes > RAW_SOCKET_TX_LANE_MAX)
+        lanes = RAW_SOCKET_TX_LANE_MAX;
+    if (lanes < 1)
+        lanes = 1;
+    return lanes;
+}
+
+// Lane sayısı: port ayarı, target sayısı ve backend ile sınırlı
+static void raw_tx_lanes_init(struct raw_socket_port *port)
+{
+    port->tx_lane_count = port->use_xdp ? 1 : raw_port_tx_lane_count(&port->config);
+    for (int l = 0; l < RAW_SOCKET_TX_LANE_MAX; l++) {
+        struct raw_tx_lane *lane = &port->tx_lanes[l];
+        lane->port = port;
+        lane->lane_id = (uint16_t)l;
+        lane->socket_fd = -1;
+    }
+}
+
+int setup_raw_tx_ring(struct raw_socket_port *port)
+{
+    for (int l = 0; l < port->tx_lane_count; l++) {
+        if (raw_tx_lane_open(port, &port->tx_lanes[l]) < 0) {
+            raw_tx_lanes_close(port);
+            return -1;
+        }
+    }
+
+    printf("[Raw Port %d] TX ring ready (%d lane x %zu KB%s)\n", port->port_id,
+           port->tx_lane_count, port->tx_lanes[0].ring_size / 1024,
+           RAW_SOCKET_TX_QDISC_BYPASS ? ", qdisc bypass" : "");
+    return 0;
+}
+
+// Lane thread'leri için core (tek lane eskisi gibi pinlenmez)
+static void raw_tx_take_cores(struct raw_socket_port *port)
+{
+    if (port->tx_lane_count < 2)
+        return;
+
+    uint16_t cores[RAW_SOCKET_TX_LANE_MAX] = {0};
+#if LCORE_PLANNER_ENABLED
+    int found = lcore_plan_take_raw_tx_cores(port->port_id, port->tx_lane_count, cores);
+#else
+    int found = get_unused_cores(port->tx_lane_count, cores);
+#endif
+    if (found < port->tx_lane_count) {
+        fprintf(stderr, "[Port %u] Warning: Only %d cores available for %d TX lanes\n",
+                port->port_id, found, port->tx_lane_count);
+    }
+    for (int l = 0; l < port->tx_lane_count; l++)
+        port->tx_lanes[l].cpu_core = (l < found) ? cores[l] : 0;
+}
+
+// ==========================================
+// RX RING (TPACKET_V2 / TPACKET_V3)
+// ==========================================
+
+#if RAW_SOCKET_RX_TPACKET_V3
+#define RAW_RX_TPACKET_NAME "TPACKET_V3"
+// Block kernel tarafından dolunca/timeout'ta teslim edilir, spin yerine poll
+#define RAW_RX_BUSY_POLL_COUNT 1
+#define RAW_RX_SLOT_SIZE RAW_SOCKET_V3_BLOCK_SIZE
+#define RAW_RX_SLOT_NR   RAW_SOCKET_V3_BLOCK_NR
+#else
+#define RAW_RX_TPACKET_NAME "TPACKET_V2"
+#define RAW_RX_BUSY_POLL_COUNT 64
+#define RAW_RX_SLOT_SIZE RAW_SOCKET_RING_FRAME_SIZE
+#define RAW_RX_SLOT_NR   RAW_SOCKET_RING_FRAME_NR
+#endif
+
+// PACKET_MMAP RX ring'i burst arayüzüne bağla
+static inline void raw_rx_io_init(struct pkt_io_port *io, int fd, void *ring)
+{
+    pkt_io_init_mmap(io, fd, ring, RAW_RX_SLOT_SIZE, RAW_RX_SLOT_NR,
+                     RAW_SOCKET_RX_TPACKET_V3, NULL, 0, 0);
+}
 
+#if RAW_SOCKET_TIMESTAMPING
+// DPDK -> raw örneği: RX zamanı tpacket header'ından (AF_XDP: şimdi)
+static inline void raw_lat_rx_frame(const struct pkt_io_port *io, const struct pkt_io_buf *b,
+                                    uint16_t vl_id, uint64_t seq)
+{
+    if (!raw_lat_sampled(seq))
+        return;
+    uint64_t rx_ns = pkt_io_rx_timestamp(io, b, NULL);
+    raw_lat_rx_sample(vl_id, seq, rx_ns ? rx_ns : raw_lat_now_ns());
+}
+#endif
+
+#if DPDK_EXT_TX_ENABLED
+// ==========================================
+// DPDK EXTERNAL TX RX (legacy + multi-queue worker ortak)
+// ==========================================
+// Switch VLAN'ı soyar, paketler IPv4 (0x0800) gelir:
+//   Port 12: VL-ID 4291-4418, Port 2,3,4,5'ten
+//   Port 13: VL-ID 4099-4130, Port 0,6'dan
+// Sequence takibi worker'a özgü kalır (legacy: worker-yerel, multi-queue:
+// global / VL-ID steering tracker'ı).
+
+// Kaynak DPDK portlarının PRBS cache'leri (worker başında bir kez)
+struct raw_ext_rx_caches {
+    uint8_t *p12[4];    // Port 12 <- Port 2,3,4,5
+    uint8_t *p13[2];    // Port 13 <- Port 0,6
+};
+
+static void raw_ext_rx_caches_init(struct raw_ext_rx_caches *c)
+{
+    for (int i = 0; i < 4; i++)
+        c->p12[i] = get_prbs_cache_ext_for_port((uint16_t)(2 + i));
+    c->p13[0] = get_prbs_cache_ext_for_port(0);
+    c->p13[1] = get_prbs_cache_ext_for_port(6);
+}
+
+static inline const uint8_t *raw_ext_rx_cache(const struct raw_ext_rx_caches *c,
+                                              uint16_t raw_port_id, int dpdk_src_port)
+{
+    if (raw_port_id == 12 && dpdk_src_port >= 2 && dpdk_src_port <= 5)
+        return c->p12[dpdk_src_port - 2];
+    if (raw_port_id == 13 && (dpdk_src_port == 0 || dpdk_src_port == 6))
+        return c->p13[dpdk_src_port == 0 ? 0 : 1];
+    return NULL;
+}
+
+static void raw_ext_rx_debug(const uint8_t *pkt_data, uint32_t pkt_len, uint16_t vl_id,
+                             int dpdk_src_port, uint64_t seq, const uint8_t *cache)
+{
+    static int debug_count = 0;
+    if (debug_count >= 5)
+        return;
+    debug_count++;
+
+    const uint8_t *recv_prbs = pkt_data + RAW_PKT_HDR_SIZE + PKT_SEQ_BYTES;
+    const uint8_t *expected_prbs = pkt_prbs_at(cache, seq, NUM_PRBS_BYTES);
+    uint8_t ip_ver_ihl = pkt_data[14];
+
+    printf("[DPDK-EXT RX DEBUG] PRBS Error #%d: VL-ID=%u, src_port=%d, seq=%lu, pkt_len=%u, prbs_len=%u\n",
+           debug_count, vl_id, dpdk_src_port, seq, pkt_len,
+           (unsigned)(pkt_len - RAW_PKT_HDR_SIZE - PKT_SEQ_BYTES));
+    printf("  IP: ver_ihl=0x%02x (IHL=%u bytes), EtherType=0x%02x%02x\n",
+           ip_ver_ihl, (ip_ver_ihl & 0x0F) * 4, pkt_data[12], pkt_data[13]);
+    printf("  prbs_offset=%lu, NUM_PRBS_BYTES=%u, PRBS_CACHE_SIZE=%lu\n",
+           (unsigned long)(expected_prbs - cache), NUM_PRBS_BYTES, (unsigned long)PRBS_CACHE_SIZE);
+    printf("  recv[0..7]: %02x %02x %02x %02x %02x %02x %02x %02x\n",
+           recv_prbs[0], recv_prbs[1], recv_prbs[2], recv_prbs[3],
+           recv_prbs[4], recv_prbs[5], recv_prbs[6], recv_prbs[7]);
+    printf("  exp[0..7]:  %02x %02x %02x %02x %02x %02x %02x %02x\n",
+           expected_prbs[0], expected_prbs[1], expected_prbs[2], expected_prbs[3],
+           expected_prbs[4], expected_prbs[5], expected_prbs[6], expected_prbs[7]);
+}
+
+/**
+ * DPDK external paketi: seq'i oku, raw_lat RX zamanını kaydet, PRBS'i kaynak
+ * portun cache'iyle doğrula (DPDK TX stride'ı NUM_PRBS_BYTES)
+ * @return Bit hata sayısı, -1: kaynak portun cache'i yok (doğrulanmadı)
+ */
+static inline int64_t raw_ext_rx_frame(const struct raw_ext_rx_caches *c, uint16_t raw_port_id,
+                                       const struct pkt_io_port *io, const struct pkt_io_buf *b,
+                                       uint16_t vl_id, int dpdk_src_port, uint64_t *seq)
+{
+    const uint8_t *payload = b->data + RAW_PKT_HDR_SIZE;
+    memcpy(seq, payload, sizeof(*seq));
+#if RAW_SOCKET_TIMESTAMPING
+    raw_lat_rx_frame(io, b, vl_id, *seq);
+#else
+    RTE_SET_USED(io);
+#endif
+
+    const uint8_t *cache = raw_ext_rx_cache(c, raw_port_id, dpdk_src_port);
+    if (cache == NULL)
+        return -1;
+
+    uint64_t bit_err = pkt_payload_verify(payload + PKT_SEQ_BYTES,
+                                          b->len - RAW_PKT_HDR_SIZE - PKT_SEQ_BYTES, *seq,
+                                          cache, NUM_PRBS_BYTES);
+    if (unlikely(bit_err != 0))
+        raw_ext_rx_debug(b->data, b->len, vl_id, dpdk_src_port, *seq, cache);
+    return (int64_t)bit_err;
+}
+#endif /* DPDK_EXT_TX_ENABLED */
+
+// PACKET_VERSION + PACKET_RX_RING, ring boyutunu döner
+static int raw_rx_ring_configure(int fd, const char *tag, size_t *ring_size)
+{
+#if RAW_SOCKET_RX_TPACKET_V3
+    int version = TPACKET_V3;
+#else
     int version = TPACKET_V2;
-    if (setsockopt(port->rx_socket, SOL_PACKET, PACKET_VERSION,
-                   &version, sizeof(version)) < 0) {
-        fprintf(stderr, "[Raw Port %d] Failed to set TPACKET_V2 for RX: %s\n",
-                port->port_id, strerror(errno));
-        close(port->rx_socket);
+#endif
+    if (setsockopt(fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+        fprintf(stderr, "%s Failed to set %s for RX: %s\n", tag, RAW_RX_TPACKET_NAME, strerror(errno));
         return -1;
     }
 
+#if RAW_SOCKET_RX_TPACKET_V3
+    struct tpacket_req3 req = {0};
+    req.tp_block_size = RAW_SOCKET_V3_BLOCK_SIZE;
+    req.tp_block_nr = RAW_SOCKET_V3_BLOCK_NR;
+    // V3'te frame_size sadece doğrulama için, paketler block içinde sıkışık
+    req.tp_frame_size = RAW_SOCKET_RING_FRAME_SIZE;
+    req.tp_frame_nr = (RAW_SOCKET_V3_BLOCK_SIZE / RAW_SOCKET_RING_FRAME_SIZE) * RAW_SOCKET_V3_BLOCK_NR;
+    req.tp_retire_blk_tov = RAW_SOCKET_V3_RETIRE_TMO_MS;
+    req.tp_feature_req_word = 0;
+#else
     struct tpacket_req req = {0};
     req.tp_block_size = RAW_SOCKET_RING_BLOCK_SIZE;
     req.tp_block_nr = RAW_SOCKET_RING_BLOCK_NR;
     req.tp_frame_size = RAW_SOCKET_RING_FRAME_SIZE;
     req.tp_frame_nr = RAW_SOCKET_RING_FRAME_NR;
+#endif
 
-    if (setsockopt(port->rx_socket, SOL_PACKET, PACKET_RX_RING,
-                   &req, sizeof(req)) < 0) {
-        fprintf(stderr, "[Raw Port %d] Failed to setup RX ring: %s\n",
+    if (setsockopt(fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+        fprintf(stderr, "%s Failed to setup RX ring: %s\n", tag, strerror(errno));
+        return -1;
+    }
+
+    *ring_size = (size_t)req.tp_block_size * req.tp_block_nr;
+    return 0;
+}
+
+// PACKET_STATISTICS okununca kernel sayaçları sıfırlar, delta toplanır.
+// XDP_STATISTICS ise kümülatiftir.
+static void raw_rx_collect_kernel_drops(struct raw_rx_queue *queue)
+{
+    if (queue->xsk) {
+        queue->kernel_drops = xsk_port_kernel_drops(queue->xsk);
+        return;
+    }
+
+#if RAW_SOCKET_RX_TPACKET_V3
+    struct tpacket_stats_v3 kstats;
+#else
+    struct tpacket_stats kstats;
+#endif
+    socklen_t kstats_len = sizeof(kstats);
+    if (getsockopt(queue->socket_fd, SOL_PACKET, PACKET_STATISTICS, &kstats, &kstats_len) == 0)
+        queue->kernel_drops += kstats.tp_drops;
+}
+
+// Worker'ın yerel RX sayaçlarını kendi bloğuna yayınla (tek yazar, kilitsiz)
+static inline void raw_stats_flush_rx(struct raw_target_stats *blk, uint64_t pkts, uint64_t bytes,
+                                      uint64_t good, uint64_t bad, uint64_t bit_errors,
+                                      uint64_t lost)
+{
+    raw_stat_add(&blk->rx_packets, pkts);
+    raw_stat_add(&blk->rx_bytes, bytes);
+    raw_stat_add(&blk->good_pkts, good);
+    raw_stat_add(&blk->bad_pkts, bad);
+    raw_stat_add(&blk->bit_errors, bit_errors);
+    if (lost)
+        raw_stat_add(&blk->lost_pkts, lost);
+}
+
+// VL-ID steering tracker'ı (sahibi kuyruk thread'i). İlk pakette true döner.
+static inline bool raw_vl_track_update(struct raw_vl_track *t, uint64_t seq)
+{
+    uint64_t rx_cnt = t->rx_count;
+    if (seq < t->min_seq)
+        __atomic_store_n(&t->min_seq, seq, __ATOMIC_RELAXED);
+    if (seq > t->max_seq)
+        __atomic_store_n(&t->max_seq, seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&t->rx_count, rx_cnt + 1, __ATOMIC_RELAXED);
+    return rx_cnt == 0;
+}
+
+static void raw_vl_track_clear(struct raw_vl_track *vt, uint16_t count)
+{
+    for (uint16_t i = 0; i < count; i++) {
+        __atomic_store_n(&vt[i].rx_count, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&vt[i].min_seq, UINT64_MAX, __ATOMIC_RELAXED);
+        __atomic_store_n(&vt[i].max_seq, 0, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * reset_global_sequence_tracking() neslini kuyruğun kendi thread'inde uygula:
+ * tracker'lar (VL-ID steering) ve kuyruğun VL-ID sayaçları birlikte sıfırlanır
+ * (global tracker'lı hash fanout yolunda da).
+ * @return true: yeni nesil uygulandı, çağıran yerel VL-ID durumunu da sıfırlar
+ */
+static inline bool raw_vl_track_sync(struct raw_socket_port *port, struct raw_rx_queue *queue)
+{
+    uint32_t gen = __atomic_load_n(&port->vl_track_gen, __ATOMIC_ACQUIRE);
+    if (gen == queue->vl_track_gen)
+        return false;
+    if (queue->vl_track)
+        raw_vl_track_clear(queue->vl_track, port->vl_track_count);
+    queue->unique_vl_ids = 0;
+    queue->vl_id_min = 0xFFFF;
+    queue->vl_id_max = 0;
+    queue->vl_track_gen = gen;
+    return true;
+}
+
+int setup_raw_rx_ring(struct raw_socket_port *port)
+{
+    port->rx_socket = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
+    if (port->rx_socket < 0) {
+        fprintf(stderr, "[Raw Port %d] Failed to create RX socket: %s\n",
                 port->port_id, strerror(errno));
+        return -1;
+    }
+
+    char tag[32];
+    snprintf(tag, sizeof(tag), "[Raw Port %d]", port->port_id);
+    if (raw_rx_ring_configure(port->rx_socket, tag, &port->rx_ring_size) < 0) {
         close(port->rx_socket);
         return -1;
     }
+#if RAW_SOCKET_TIMESTAMPING
+    raw_lat_enable_rx_socket(port->rx_socket, port->lat_hw);
+#endif
+    raw_tune_busy_poll(port->rx_socket, tag);
 
-    port->rx_ring_size = req.tp_block_size * req.tp_block_nr;
     port->rx_ring = mmap(NULL, port->rx_ring_size,
                          PROT_READ | PROT_WRITE, MAP_SHARED,
                          port->rx_socket, 0);
@@ -687,8 +1096,9 @@ int setup_raw_rx_ring(struct raw_socket_port *port)
     mreq.mr_type = PACKET_MR_PROMISC;
     setsockopt(port->rx_socket, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
 
-    port->rx_ring_offset = 0;
-    printf("[Raw Port %d] RX ring ready (%zu KB)\n", port->port_id, port->rx_ring_size / 1024);
+    raw_rx_io_init(&port->rx_io, port->rx_socket, port->rx_ring);
+    printf("[Raw Port %d] RX ring ready (%zu KB, %s)\n", port->port_id, port->rx_ring_size / 1024,
+           RAW_RX_TPACKET_NAME);
     return 0;
 }
 
@@ -696,35 +1106,142 @@ int setup_raw_rx_ring(struct raw_socket_port *port)
 // MULTI-QUEUE RX SETUP (PACKET_FANOUT)
 // ==========================================
 
-int setup_multi_queue_rx(struct raw_socket_port *port)
+// RX queue CPU'ları; dönen değer bulunan core sayısı, rx_queue_count ayarlanır
+static int raw_rx_take_cores(struct raw_socket_port *port, int target_queue_count)
 {
-    // Determine queue count based on port type
-    int target_queue_count = (port->port_id == 12) ? PORT_12_RX_QUEUE_COUNT : PORT_13_RX_QUEUE_COUNT;
-
-    printf("\n=== Setting up Multi-Queue RX for Port %u ===\n", port->port_id);
-    printf("  Target queue count: %d\n", target_queue_count);
-
-    // Get unused CPU cores for RX queues
+    // Get unused CPU cores for RX queues (planlayıcı varsa onun ayırdıkları)
+#if LCORE_PLANNER_ENABLED
+    int cores_found = lcore_plan_take_raw_cores(port->port_id, target_queue_count, port->rx_cpu_cores);
+#else
     int cores_found = get_unused_cores(target_queue_count, port->rx_cpu_cores);
+#endif
     if (cores_found < target_queue_count) {
         fprintf(stderr, "[Port %u] Warning: Only %d cores available for %d RX queues\n",
                 port->port_id, cores_found, target_queue_count);
     }
     port->rx_queue_count = cores_found > 0 ? cores_found : target_queue_count;
+    return cores_found;
+}
 
-    // Create sockets and setup PACKET_FANOUT for load distribution
+static void raw_rx_queue_reset(struct raw_socket_port *port, int q, int cores_found)
+{
+    struct raw_rx_queue *queue = &port->rx_queues[q];
+
+    queue->queue_id = q;
+    queue->cpu_core = (q < cores_found) ? port->rx_cpu_cores[q] : 0;
+    queue->running = false;
+    queue->rx_packets = 0;
+    queue->rx_bytes = 0;
+    queue->good_pkts = 0;
+    queue->bad_pkts = 0;
+    queue->bit_errors = 0;
+    queue->lost_pkts = 0;
+    queue->kernel_drops = 0;
+    memset(&queue->dpdk_ext_stats, 0, sizeof(queue->dpdk_ext_stats));
+    memset(queue->source_stats, 0, sizeof(queue->source_stats));
+    queue->xsk = NULL;
+}
+
+// ==========================================
+// VL-ID FANOUT STEERING (PACKET_FANOUT_CBPF)
+// ==========================================
+
+#ifndef PACKET_FANOUT_CBPF
+#define PACKET_FANOUT_CBPF 6
+#endif
+#ifndef PACKET_FANOUT_DATA
+#define PACKET_FANOUT_DATA 22
+#endif
+
+// A = dst MAC[4..5] (VL-ID); SKF_LL_OFF: fanout anında skb->data network
+// header'dadır, MAC header'a göre okunur. Kernel sonucu üye sayısına mod alır.
+static struct sock_filter raw_vl_steer_insns[] = {
+    BPF_STMT(BPF_LD | BPF_H | BPF_ABS, SKF_LL_OFF + 4),
+    BPF_STMT(BPF_RET | BPF_A, 0),
+};
+
+static int raw_fanout_join(int fd, uint16_t group_id, bool vl_steer)
+{
+    int mode = vl_steer ? PACKET_FANOUT_CBPF : PACKET_FANOUT_HASH;
+    int fanout_arg = group_id | (mode << 16);
+    if (setsockopt(fd, SOL_PACKET, PACKET_FANOUT, &fanout_arg, sizeof(fanout_arg)) < 0)
+        return -1;
+
+    if (vl_steer) {
+        struct sock_fprog prog = {
+            .len = sizeof(raw_vl_steer_insns) / sizeof(raw_vl_steer_insns[0]),
+            .filter = raw_vl_steer_insns,
+        };
+        if (setsockopt(fd, SOL_PACKET, PACKET_FANOUT_DATA, &prog, sizeof(prog)) < 0)
+            return -1;
+    }
+    return 0;
+}
+
+// Fanout grubunun tipi sonradan değişmez: CBPF desteği kuyruk soketlerinden
+// önce geçici bir sokette denenir (trafik almayan deneysel ethertype).
+static bool raw_fanout_vl_steer_supported(uint16_t group_id)
+{
+    int fd = socket(AF_PACKET, SOCK_RAW, htons(0x88B5));
+    if (fd < 0)
+        return false;
+    bool ok = raw_fanout_join(fd, group_id ^ 0x8000, true) == 0;
+    if (!ok) {
+        fprintf(stderr, "  PACKET_FANOUT_CBPF unavailable (%s), using PACKET_FANOUT_HASH\n",
+                strerror(errno));
+    }
+    close(fd);
+    return ok;
+}
+
+// Kuyruk başına özel VL-ID tracker'ları (port'un DPDK external VL aralığı)
+static int raw_vl_track_alloc(struct raw_socket_port *port)
+{
+    if (port->port_id == 12) {
+        port->vl_track_base = GLOBAL_SEQ_VL_ID_START_P12;
+        port->vl_track_count = GLOBAL_SEQ_VL_ID_COUNT_P12;
+    } else if (port->port_id == 13) {
+        port->vl_track_base = GLOBAL_SEQ_VL_ID_START_P13;
+        port->vl_track_count = GLOBAL_SEQ_VL_ID_COUNT_P13;
+    } else {
+        return -1;
+    }
+
+    uint32_t gen = __atomic_load_n(&port->vl_track_gen, __ATOMIC_ACQUIRE);
     for (int q = 0; q < port->rx_queue_count; q++) {
         struct raw_rx_queue *queue = &port->rx_queues[q];
+        queue->vl_track = calloc(port->vl_track_count, sizeof(struct raw_vl_track));
+        if (!queue->vl_track) {
+            for (int i = 0; i < q; i++) {
+                free(port->rx_queues[i].vl_track);
+                port->rx_queues[i].vl_track = NULL;
+            }
+            return -1;
+        }
+        raw_vl_track_clear(queue->vl_track, port->vl_track_count);
+        queue->vl_track_gen = gen;
+    }
+    return 0;
+}
 
-        queue->queue_id = q;
-        queue->cpu_core = (q < cores_found) ? port->rx_cpu_cores[q] : 0;
-        queue->running = false;
-        queue->rx_packets = 0;
-        queue->rx_bytes = 0;
-        queue->good_pkts = 0;
-        queue->bad_pkts = 0;
-        queue->bit_errors = 0;
-        queue->lost_pkts = 0;
+int setup_multi_queue_rx(struct raw_socket_port *port)
+{
+    int target_queue_count = raw_port_rx_queue_count(&port->config);
+
+    printf("\n=== Setting up Multi-Queue RX for Port %u ===\n", port->port_id);
+    printf("  Target queue count: %d\n", target_queue_count);
+
+    int cores_found = raw_rx_take_cores(port, target_queue_count);
+
+    // Use port_id in group ID to ensure each port has unique fanout group
+    uint16_t fanout_group_id = (RAW_SOCKET_FANOUT_GROUP_ID + port->port_id) & 0xFFFF;
+    bool vl_steer = RAW_SOCKET_FANOUT_VL_STEER && raw_fanout_vl_steer_supported(fanout_group_id);
+    printf("  Fanout mode: %s\n", vl_steer ? "CBPF (VL-ID steering)" : "HASH");
+
+    // Create sockets and setup PACKET_FANOUT for load distribution
+    for (int q = 0; q < port->rx_queue_count; q++) {
+        struct raw_rx_queue *queue = &port->rx_queues[q];
+        raw_rx_queue_reset(port, q, cores_found);
 
         // Create raw socket
         queue->socket_fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_ALL));
@@ -734,32 +1251,17 @@ int setup_multi_queue_rx(struct raw_socket_port *port)
             return -1;
         }
 
-        // Set TPACKET_V2
-        int version = TPACKET_V2;
-        if (setsockopt(queue->socket_fd, SOL_PACKET, PACKET_VERSION,
-                       &version, sizeof(version)) < 0) {
-            fprintf(stderr, "[Port %u Q%d] Failed to set TPACKET_V2: %s\n",
-                    port->port_id, q, strerror(errno));
-            close(queue->socket_fd);
-            return -1;
-        }
-
-        // Setup RX ring buffer
-        struct tpacket_req req = {0};
-        req.tp_block_size = RAW_SOCKET_RING_BLOCK_SIZE;
-        req.tp_block_nr = RAW_SOCKET_RING_BLOCK_NR;
-        req.tp_frame_size = RAW_SOCKET_RING_FRAME_SIZE;
-        req.tp_frame_nr = RAW_SOCKET_RING_FRAME_NR;
-
-        if (setsockopt(queue->socket_fd, SOL_PACKET, PACKET_RX_RING,
-                       &req, sizeof(req)) < 0) {
-            fprintf(stderr, "[Port %u Q%d] Failed to setup RX ring: %s\n",
-                    port->port_id, q, strerror(errno));
+        // Setup RX ring buffer (TPACKET_V3 block ring veya V2 frame ring)
+        char tag[32];
+        snprintf(tag, sizeof(tag), "[Port %u Q%d]", port->port_id, q);
+        if (raw_rx_ring_configure(queue->socket_fd, tag, &queue->ring_size) < 0) {
             close(queue->socket_fd);
             return -1;
         }
+#if RAW_SOCKET_TIMESTAMPING
+        raw_lat_enable_rx_socket(queue->socket_fd, port->lat_hw);
+#endif
 
-        queue->ring_size = req.tp_block_size * req.tp_block_nr;
         queue->ring = mmap(NULL, queue->ring_size,
                            PROT_READ | PROT_WRITE, MAP_SHARED,
                            queue->socket_fd, 0);
@@ -785,12 +1287,8 @@ int setup_multi_queue_rx(struct raw_socket_port *port)
         }
 
         // Setup PACKET_FANOUT for load distribution across queues
-        // PACKET_FANOUT_HASH distributes based on packet hash (src/dst IP+port)
-        // Use port_id in group ID to ensure each port has unique fanout group
-        uint16_t fanout_group_id = (RAW_SOCKET_FANOUT_GROUP_ID + port->port_id) & 0xFFFF;
-        int fanout_arg = fanout_group_id | (PACKET_FANOUT_HASH << 16);
-        if (setsockopt(queue->socket_fd, SOL_PACKET, PACKET_FANOUT,
-                       &fanout_arg, sizeof(fanout_arg)) < 0) {
+        // CBPF: VL-ID -> kuyruk (sabit), HASH: packet hash (src/dst IP+port)
+        if (raw_fanout_join(queue->socket_fd, fanout_group_id, vl_steer) < 0) {
             fprintf(stderr, "[Port %u Q%d] Failed to set PACKET_FANOUT: %s\n",
                     port->port_id, q, strerror(errno));
             // Continue without fanout - will still work but may have contention
@@ -802,30 +1300,164 @@ int setup_multi_queue_rx(struct raw_socket_port *port)
         mreq.mr_type = PACKET_MR_PROMISC;
         setsockopt(queue->socket_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq));
 
-        queue->ring_offset = 0;
-        printf("  Queue %d: socket=%d, ring=%zu KB, CPU core=%u\n",
-               q, queue->socket_fd, queue->ring_size / 1024, queue->cpu_core);
+        raw_tune_busy_poll(queue->socket_fd, tag);
+        raw_rx_io_init(&queue->io, queue->socket_fd, queue->ring);
+        printf("  Queue %d: socket=%d, ring=%zu KB (%s), CPU core=%u\n",
+               q, queue->socket_fd, queue->ring_size / 1024, RAW_RX_TPACKET_NAME, queue->cpu_core);
     }
 
+    // Her VL-ID tek kuyrukta: kuyruklar kendi tracker'larını tutar
+    port->vl_steered = vl_steer && raw_vl_track_alloc(port) == 0;
+
     port->use_multi_queue_rx = true;
     printf("=== Multi-Queue RX Setup Complete ===\n");
     return 0;
 }
 
+// ==========================================
+// AF_XDP SETUP
+// ==========================================
+// NIC RX queue q -> XSK q -> RX worker q. PACKET_FANOUT yerine NIC RSS
+// dağıtır. Q0 soketi TX için de kullanılır (UMEM'in TX yarısı).
+// veth varsayılan 1 RX queue ile gelir: bind edilemeyen queue'larda durulur.
+
+static int setup_xdp_queues(struct raw_socket_port *port)
+{
+    int target_queue_count = raw_port_rx_queue_count(&port->config);
+
+    printf("\n=== Setting up AF_XDP for Port %u ===\n", port->port_id);
+
+    if (xsk_prog_attach(&port->xdp_prog, port->if_index, (uint32_t)target_queue_count,
+                        port->config.xdp_generic) < 0)
+        return -1;
+
+    int cores_found = raw_rx_take_cores(port, target_queue_count);
+    int opened = 0;
+
+    for (int q = 0; q < port->rx_queue_count; q++) {
+        struct raw_rx_queue *queue = &port->rx_queues[q];
+        raw_rx_queue_reset(port, q, cores_found);
+
+        queue->xsk = calloc(1, sizeof(*queue->xsk));
+        if (!queue->xsk || xsk_port_open(queue->xsk, &port->xdp_prog, port->if_index, (uint32_t)q) < 0) {
+            free(queue->xsk);
+            queue->xsk = NULL;
+            break;
+        }
+
+        queue->socket_fd = queue->xsk->fd;
+        queue->ring = NULL;
+        queue->ring_size = 0;
+        pkt_io_init_xsk(&queue->io, queue->xsk);
+        opened++;
+
+        char tag[32];
+        snprintf(tag, sizeof(tag), "[Port %u XSK%d]", port->port_id, q);
+        raw_tune_busy_poll(queue->socket_fd, tag);
+
+        printf("  Queue %d: xsk=%d, %s, UMEM=%zu KB, CPU core=%u\n",
+               q, queue->socket_fd, queue->xsk->zero_copy ? "zero-copy" : "copy",
+               queue->xsk->umem_size / 1024, queue->cpu_core);
+    }
+
+    if (opened == 0) {
+        xsk_prog_detach(&port->xdp_prog);
+        return -1;
+    }
+    if (opened < port->rx_queue_count) {
+        printf("  Only %d of %d NIC queues usable for AF_XDP\n", opened, port->rx_queue_count);
+        port->rx_queue_count = opened;
+    }
+
+    port->tx_lanes[0].xsk = port->rx_queues[0].xsk;
+    pkt_io_init_xsk(&port->tx_lanes[0].io, port->tx_lanes[0].xsk);
+    port->use_xdp = true;
+    port->use_multi_queue_rx = true;
+    printf("=== AF_XDP Setup Complete (%s XDP, need_wakeup) ===\n",
+           port->xdp_prog.generic ? "generic" : "native");
+    return 0;
+}
+
+static const char *raw_port_backend_name(const struct raw_socket_port *port)
+{
+    if (!port->use_xdp)
+        return "AF_PACKET " RAW_RX_TPACKET_NAME;
+    if (port->tx_lanes[0].xsk && port->tx_lanes[0].xsk->zero_copy)
+        return "AF_XDP zero-copy";
+    return port->xdp_prog.generic ? "AF_XDP copy/generic" : "AF_XDP copy/native";
+}
+
+// AF_XDP soketlerini kapat, programı arayüzden kaldır
+static void teardown_xdp_queues(struct raw_socket_port *port)
+{
+    if (!port->use_xdp)
+        return;
+
+    for (int q = 0; q < port->rx_queue_count; q++) {
+        struct raw_rx_queue *queue = &port->rx_queues[q];
+        if (queue->xsk) {
+            xsk_port_close(queue->xsk);
+            free(queue->xsk);
+            queue->xsk = NULL;
+            memset(&queue->io, 0, sizeof(queue->io));
+            queue->socket_fd = -1;
+        }
+    }
+    port->tx_lanes[0].xsk = NULL;
+    memset(&port->tx_lanes[0].io, 0, sizeof(port->tx_lanes[0].io));
+    xsk_prog_detach(&port->xdp_prog);
+    port->use_xdp = false;
+}
+
+// ==========================================
+// BUSY-POLL / IRQ AFFINITY
+// ==========================================
+// Soket başına busy-poll kurulum sırasında uygulanır; burada global
+// net.core.busy_poll ve NIC IRQ/RPS/XPS maskeleri pinli RX/TX core'lara
+// hizalanır. Pinsiz thread'ler (legacy RX, tek TX lane) hizalamaya girmez.
+
+static void raw_port_tune_affinity(struct raw_socket_port *port)
+{
+    uint16_t rx_cpus[RAW_SOCKET_RX_QUEUE_COUNT];
+    uint16_t tx_cpus[RAW_SOCKET_TX_LANE_MAX];
+    int n_rx = 0, n_tx = 0;
+
+    raw_tune_busy_poll_sysctl();
+
+    if (port->use_multi_queue_rx) {
+        for (int q = 0; q < port->rx_queue_count; q++) {
+            if (port->rx_queues[q].cpu_core > 0)
+                rx_cpus[n_rx++] = port->rx_queues[q].cpu_core;
+        }
+    }
+    for (int l = 0; l < port->tx_lane_count; l++) {
+        if (port->tx_lanes[l].cpu_core > 0)
+            tx_cpus[n_tx++] = port->tx_lanes[l].cpu_core;
+    }
+
+    if (n_rx == 0) {
+        printf("[Port %u] RX threads not pinned, IRQ affinity left unchanged\n", port->port_id);
+        return;
+    }
+    raw_tune_irq_affinity(port->config.interface_name, rx_cpus, n_rx, tx_cpus, n_tx);
+}
+
 // ==========================================
 // PORT INITIALIZATION
 // ==========================================
 
 int init_raw_socket_port(int raw_index, const struct raw_socket_port_config *config)
 {
-    struct raw_socket_port *port = &raw_ports[raw_index];
+    struct raw_socket_port *port = raw_ports[raw_index];
 
     memset(port, 0, sizeof(*port));
     port->raw_index = raw_index;
     port->port_id = config->port_id;
     port->config = *config;
-    port->tx_socket = -1;
     port->rx_socket = -1;
+    port->xdp_prog.prog_fd = -1;
+    port->xdp_prog.map_fd = -1;
+    port->xdp_prog.link_fd = -1;
 
     printf("\n=== Initializing Raw Socket Port %u (index %d) ===\n", config->port_id, raw_index);
     printf("  Interface: %s (%s)\n", config->interface_name, config->is_1g_port ? "1G" : "100M");
@@ -867,6 +1499,11 @@ int init_raw_socket_port(int raw_index, const struct raw_socket_port_config *con
            port->mac_addr[0], port->mac_addr[1], port->mac_addr[2],
            port->mac_addr[3], port->mac_addr[4], port->mac_addr[5]);
 
+#if RAW_SOCKET_TIMESTAMPING
+    // Soketler açılmadan önce: TX/RX soket ayarları HW/SW seçimine bağlı
+    port->lat_hw = raw_lat_enable_nic(config->interface_name);
+#endif
+
     // Initialize TX targets
     port->tx_target_count = config->tx_target_count;
     for (int t = 0; t < config->tx_target_count; t++) {
@@ -874,6 +1511,12 @@ int init_raw_socket_port(int raw_index, const struct raw_socket_port_config *con
         target->config = config->tx_targets[t];
         target->current_vl_offset = 0;
 
+#if RAW_SOCKET_TIMESTAMPING
+        char lat_label[RAW_LAT_LABEL_LEN];
+        snprintf(lat_label, sizeof(lat_label), "P%u->P%u", config->port_id, target->config.dest_port);
+        raw_lat_register_flow(lat_label, target->config.vl_id_start, target->config.vl_id_count);
+#endif
+
         // Initialize rate limiter with smooth pacing (timestamp-based like DPDK)
         init_raw_rate_limiter_smooth(&target->limiter, target->config.rate_mbps,
                                       t, config->tx_target_count);
@@ -886,12 +1529,20 @@ int init_raw_socket_port(int raw_index, const struct raw_socket_port_config *con
             return -1;
         }
 
+        // VL-ID başına hazır header (frame'ler ring içinde kurulur)
+        target->hdr_templates = calloc(target->config.vl_id_count, sizeof(struct raw_tx_hdr_template));
+        if (!target->hdr_templates) {
+            fprintf(stderr, "[Port %u] Failed to allocate TX header templates for target %d\n",
+                    config->port_id, t);
+            return -1;
+        }
         for (uint16_t i = 0; i < target->config.vl_id_count; i++) {
-            pthread_spin_init(&target->vl_sequences[i].tx_lock, PTHREAD_PROCESS_PRIVATE);
-            pthread_spin_init(&target->vl_sequences[i].rx_lock, PTHREAD_PROCESS_PRIVATE);
+            raw_tx_hdr_template_init(&target->hdr_templates[i],
+                                     (uint16_t)(target->config.vl_id_start + i));
         }
 
-        pthread_spin_init(&target->stats.lock, PTHREAD_PROCESS_PRIVATE);
+        memset(&target->stats, 0, sizeof(target->stats));
+        memset(&target->stats_base, 0, sizeof(target->stats_base));
     }
 
     // Initialize RX sources
@@ -908,62 +1559,103 @@ int init_raw_socket_port(int raw_index, const struct raw_socket_port_config *con
             return -1;
         }
 
-        for (uint16_t i = 0; i < source->config.vl_id_count; i++) {
-            pthread_spin_init(&source->vl_sequences[i].tx_lock, PTHREAD_PROCESS_PRIVATE);
-            pthread_spin_init(&source->vl_sequences[i].rx_lock, PTHREAD_PROCESS_PRIVATE);
-        }
-
-        pthread_spin_init(&source->stats.lock, PTHREAD_PROCESS_PRIVATE);
+        memset(&source->stats, 0, sizeof(source->stats));
+        memset(&source->stats_base, 0, sizeof(source->stats_base));
     }
 
     // Initialize DPDK External RX stats (separate from raw socket sources)
     memset(&port->dpdk_ext_rx_stats, 0, sizeof(port->dpdk_ext_rx_stats));
-    pthread_spin_init(&port->dpdk_ext_rx_stats.lock, PTHREAD_PROCESS_PRIVATE);
-
-    // Setup TX ring
-    if (setup_raw_tx_ring(port) < 0) return -1;
-
-    // Setup RX - multi-queue for Port 12 and Port 13
-    // Port 12: Multi-queue RX for high throughput DPDK external packets
-    // Port 13: Multi-queue RX for better packet distribution
-    printf("[Port %u] Setting up multi-queue RX (PACKET_FANOUT)\n", port->port_id);
-    if (setup_multi_queue_rx(port) < 0) {
-        fprintf(stderr, "[Port %u] Failed to setup multi-queue RX, falling back to single queue\n",
-                port->port_id);
-        // Fallback to single queue
-        if (setup_raw_rx_ring(port) < 0) {
-            munmap(port->tx_ring, port->tx_ring_size);
-            close(port->tx_socket);
-            return -1;
+    memset(&port->dpdk_ext_rx_base, 0, sizeof(port->dpdk_ext_rx_base));
+
+    // AF_XDP istenmişse önce o; olmazsa AF_PACKET
+    if (config->backend == RAW_BACKEND_AF_XDP && setup_xdp_queues(port) < 0) {
+        fprintf(stderr, "[Port %u] AF_XDP setup failed, falling back to AF_PACKET\n", port->port_id);
+    }
+    raw_tx_lanes_init(port);
+
+    if (!port->use_xdp) {
+        // Setup TX ring
+        if (setup_raw_tx_ring(port) < 0) return -1;
+
+        // Setup RX - multi-queue for Port 12 and Port 13
+        // Port 12: Multi-queue RX for high throughput DPDK external packets
+        // Port 13: Multi-queue RX for better packet distribution
+        printf("[Port %u] Setting up multi-queue RX (PACKET_FANOUT)\n", port->port_id);
+        if (setup_multi_queue_rx(port) < 0) {
+            fprintf(stderr, "[Port %u] Failed to setup multi-queue RX, falling back to single queue\n",
+                    port->port_id);
+            // Fallback to single queue
+            if (setup_raw_rx_ring(port) < 0) {
+                raw_tx_lanes_close(port);
+                return -1;
+            }
         }
     }
+    raw_tx_take_cores(port);
+    raw_port_tune_affinity(port);
 
     // Initialize PRBS cache
     if (init_raw_prbs_cache(port) < 0) {
-        munmap(port->tx_ring, port->tx_ring_size);
+        raw_tx_lanes_close(port);
         if (port->use_multi_queue_rx) {
-            stop_multi_queue_rx_workers(port);  // Cleanup multi-queue
+            stop_multi_queue_rx_workers(port);  // Cleanup multi-queue (+ AF_XDP)
         } else {
             munmap(port->rx_ring, port->rx_ring_size);
             close(port->rx_socket);
         }
-        close(port->tx_socket);
         return -1;
     }
 
-    printf("[Port %u] Initialization complete%s\n", port->port_id,
-           port->use_multi_queue_rx ? " (multi-queue RX)" : "");
+    printf("[Port %u] Initialization complete (%s)%s, %d TX lane(s)\n", port->port_id,
+           raw_port_backend_name(port), port->use_multi_queue_rx ? " (multi-queue RX)" : "",
+           port->tx_lane_count);
     return 0;
 }
 
+// Arayüzün bağlı olduğu NUMA node (bilinmiyorsa SOCKET_ID_ANY)
+static int raw_iface_numa_node(const char *ifname)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "/sys/class/net/%s/device/numa_node", ifname);
+
+    int node = -1;
+    FILE *f = fopen(path, "r");
+    if (f) {
+        if (fscanf(f, "%d", &node) != 1)
+            node = -1;
+        fclose(f);
+    }
+    return node >= 0 ? node : SOCKET_ID_ANY;
+}
+
 int init_raw_socket_ports(void)
 {
     printf("\n=== Initializing Raw Socket Ports (Multi-Target) ===\n");
 
+    // Port tablosu config'teki port sayısı kadar, her port NIC'inin node'unda
+    raw_ports = calloc(raw_port_config_count, sizeof(*raw_ports));
+    if (!raw_ports)
+        return -1;
+    for (int i = 0; i < raw_port_config_count; i++) {
+        int socket_id = raw_iface_numa_node(raw_port_configs[i].interface_name);
+        raw_ports[i] = rte_zmalloc_socket("raw_port", sizeof(struct raw_socket_port),
+                                          RTE_CACHE_LINE_SIZE, socket_id);
+        if (!raw_ports[i]) {
+            fprintf(stderr, "Cannot allocate raw socket port %u on socket %d\n",
+                    raw_port_configs[i].port_id, socket_id);
+            for (int j = 0; j < i; j++)
+                rte_free(raw_ports[j]);
+            free(raw_ports);
+            raw_ports = NULL;
+            return -1;
+        }
+    }
+    raw_port_count = raw_port_config_count;
+
     // Initialize global sequence tracking (sets min_seq to UINT64_MAX)
     reset_global_sequence_tracking();
 
-    for (int i = 0; i < MAX_RAW_SOCKET_PORTS; i++) {
+    for (int i = 0; i < raw_port_count; i++) {
         if (init_raw_socket_port(i, &raw_port_configs[i]) < 0) {
             fprintf(stderr, "Failed to initialize raw socket port %u\n",
                     raw_port_configs[i].port_id);
@@ -979,150 +1671,203 @@ int init_raw_socket_ports(void)
 // TX WORKER (Multi-Target with Smooth Pacing)
 // ==========================================
 
+static inline uint32_t raw_tx_kick_threshold(uint32_t in_flight)
+{
+    uint32_t t = in_flight / 4;
+    if (t < RAW_TX_KICK_MIN)
+        t = RAW_TX_KICK_MIN;
+    if (t > RAW_TX_KICK_MAX)
+        t = RAW_TX_KICK_MAX;
+    return t;
+}
+
+// Boş TX frame'i bekle. Beklerken teslim edilmemiş frame'ler kernel'e
+// verilir (AF_XDP'de kick completion'ları da toplar).
+// @return Ayrılan frame sayısı, 0: durduruldu
+static uint16_t raw_tx_alloc_wait(struct raw_socket_port *port, struct raw_tx_lane *lane,
+                                  struct pkt_io_buf *bufs, uint16_t n, uint32_t *batch_count)
+{
+    int wait_count = 0;
+    for (;;) {
+        uint16_t got = pkt_io_tx_alloc(&lane->io, bufs, n);
+        if (got > 0)
+            return got;
+        if (port->stop_flag || (g_stop_flag && *g_stop_flag))
+            return 0;
+        if (*batch_count > 0 || lane->xsk) {
+            pkt_io_tx_flush(&lane->io);
+            *batch_count = 0;
+        }
+        if (++wait_count > 100) {
+            pkt_io_wait(&lane->io, POLLOUT, 1);
+            wait_count = 0;
+        }
+    }
+}
+
+// Lane'in target'ları: t = lane_id, lane_id + lane_count, ...
+#define RAW_TX_LANE_FOREACH_TARGET(port, lane, t) \
+    for (int t = (lane)->lane_id; t < (port)->tx_target_count; t += (port)->tx_lane_count)
+
 void *raw_tx_worker(void *arg)
 {
-    struct raw_socket_port *port = (struct raw_socket_port *)arg;
-    uint8_t packet_buffer[RAW_PKT_TOTAL_SIZE];  // Max boyut
+    struct raw_tx_lane *lane = (struct raw_tx_lane *)arg;
+    struct raw_socket_port *port = lane->port;
     bool first_tx[MAX_RAW_TARGETS] = {false};
+    int lane_targets = 0;
+
+    RAW_TX_LANE_FOREACH_TARGET(port, lane, t) {
+        lane_targets++;
+    }
 
 #if IMIX_ENABLED
-    // IMIX: Worker offset (her target için farklı pattern başlangıcı)
-    uint8_t imix_offset = (uint8_t)(port->port_id % IMIX_PATTERN_SIZE);
+    // IMIX: Worker offset (her lane için farklı pattern başlangıcı)
+    uint8_t imix_offset = (uint8_t)((port->port_id + lane->lane_id) % IMIX_PATTERN_SIZE);
     uint64_t imix_counter = 0;
-    printf("[Port %u TX Worker] Started with %u targets (IMIX MODE + SMOOTH PACING)\n",
-           port->port_id, port->tx_target_count);
-    printf("[Port %u TX] IMIX pattern: 96, 196, 396, 796, 1196x3, 1514x3 (avg=%d bytes)\n",
-           port->port_id, RAW_IMIX_AVG_PACKET_SIZE);
+    printf("[Port %u TX L%u] Started with %d targets (IMIX MODE + SMOOTH PACING)\n",
+           port->port_id, lane->lane_id, lane_targets);
+    printf("[Port %u TX L%u] IMIX pattern: 96, 196, 396, 796, 1196x3, 1514x3 (avg=%d bytes)\n",
+           port->port_id, lane->lane_id, RAW_IMIX_AVG_PACKET_SIZE);
 #else
-    printf("[Port %u TX Worker] Started with %u targets (SMOOTH PACING)\n",
-           port->port_id, port->tx_target_count);
+    printf("[Port %u TX L%u] Started with %d targets (SMOOTH PACING)\n",
+           port->port_id, lane->lane_id, lane_targets);
 #endif
 
-    port->tx_running = true;
-
     // Print target info
-    for (int t = 0; t < port->tx_target_count; t++) {
+    RAW_TX_LANE_FOREACH_TARGET(port, lane, t) {
         struct raw_tx_target_state *target = &port->tx_targets[t];
-        printf("[Port %u TX] Target %d: rate=%u Mbps, delay=%.2f us, dest_port=%u\n",
-               port->port_id, t, target->config.rate_mbps,
+        printf("[Port %u TX L%u] Target %d: rate=%u Mbps, delay=%.2f us, dest_port=%u\n",
+               port->port_id, lane->lane_id, t, target->config.rate_mbps,
                (double)target->limiter.delay_ns / 1000.0,
                target->config.dest_port);
+
+        char pacing_label[TX_PACING_LABEL_LEN];
+        snprintf(pacing_label, sizeof(pacing_label), "RawTX P%u T%d->P%u",
+                 port->port_id, t, target->config.dest_port);
+        target->pacing = tx_pacing_register(pacing_label, 1000000000ULL);
     }
 
+    struct pkt_io_port *io = &lane->io;
     uint32_t batch_count = 0;
-    const uint32_t BATCH_SIZE = 64;  // Batch for kernel efficiency
+    uint64_t kick_deadline_ns = 0;  // Bekleyen frame'lerin en geç kick zamanı (0 = yok)
     const uint32_t MAX_CATCHUP_PER_TARGET = 32;  // Max packets per target per iteration (catch-up limit)
 
     while (!port->stop_flag && (g_stop_flag == NULL || !*g_stop_flag)) {
         bool any_sent = false;
 
         // Smooth pacing: Check each target's timing
-        for (int t = 0; t < port->tx_target_count; t++) {
+        RAW_TX_LANE_FOREACH_TARGET(port, lane, t) {
             struct raw_tx_target_state *target = &port->tx_targets[t];
+            struct pkt_io_buf bufs[PKT_IO_BURST];
+            uint16_t allocated = 0;
+            uint16_t used = 0;
             uint32_t sent_this_target = 0;
 
             // Send all packets that are due (catch-up), limited to MAX_CATCHUP_PER_TARGET
-            while (raw_check_smooth_pacing(&target->limiter) &&
-                   sent_this_target < MAX_CATCHUP_PER_TARGET) {
+            while (sent_this_target < MAX_CATCHUP_PER_TARGET &&
+                   raw_check_smooth_pacing(&target->limiter)) {
+                // Slot alındı: elde frame yoksa doldurulanları gönder, yenilerini ayır
+                if (used == allocated) {
+                    batch_count += pkt_io_tx_burst(io, bufs, used);
+                    used = 0;
+                    uint16_t want = MAX_CATCHUP_PER_TARGET - sent_this_target;
+                    allocated = raw_tx_alloc_wait(port, lane, bufs,
+                                                  want < RAW_TX_ALLOC_BURST ? want : RAW_TX_ALLOC_BURST,
+                                                  &batch_count);
+                    if (allocated == 0)
+                        goto exit_tx;
+                }
+
                 // Get current VL-ID
                 uint16_t vl_id = target->config.vl_id_start + target->current_vl_offset;
                 uint16_t vl_index = target->current_vl_offset;
 
-                // Get next sequence (thread-safe)
-                pthread_spin_lock(&target->vl_sequences[vl_index].tx_lock);
+                // Get next sequence (tek yazar: bu lane'in thread'i)
                 uint64_t seq = target->vl_sequences[vl_index].tx_sequence++;
-                pthread_spin_unlock(&target->vl_sequences[vl_index].tx_lock);
 
 #if IMIX_ENABLED
                 // IMIX: Paket boyutunu pattern'den al
                 uint16_t pkt_size = get_raw_imix_packet_size(imix_counter, imix_offset);
                 uint16_t prbs_len = calc_raw_prbs_size(pkt_size);
                 imix_counter++;
-
-                // IMIX: PRBS offset hesabı HEP MAX boyut ile yapılır
-                uint64_t prbs_offset = (seq * (uint64_t)RAW_MAX_PRBS_BYTES) % RAW_PRBS_CACHE_SIZE;
-                uint8_t *prbs_data = port->prbs_cache_ext + prbs_offset;
-
-                // Build packet (dinamik boyut)
-                build_raw_packet_dynamic(packet_buffer, port->mac_addr, vl_id, seq,
-                                          prbs_data, prbs_len, pkt_size);
 #else
-                // Get PRBS data
-                uint64_t prbs_offset = (seq * (uint64_t)RAW_PKT_PRBS_BYTES) % RAW_PRBS_CACHE_SIZE;
-                uint8_t *prbs_data = port->prbs_cache_ext + prbs_offset;
-
-                // Build packet
-                build_raw_packet(packet_buffer, port->mac_addr, vl_id, seq, prbs_data);
                 uint16_t pkt_size = RAW_PKT_TOTAL_SIZE;
+                uint16_t prbs_len = RAW_PKT_PRBS_BYTES;
 #endif
 
-                // Get TX frame from ring
-                struct tpacket2_hdr *hdr = (struct tpacket2_hdr *)(
-                    (uint8_t *)port->tx_ring +
-                    (port->tx_ring_offset * RAW_SOCKET_RING_FRAME_SIZE));
-
-                // Wait for frame to be available
-                int wait_count = 0;
-                while (hdr->tp_status != TP_STATUS_AVAILABLE) {
-                    if (port->stop_flag || (g_stop_flag && *g_stop_flag)) {
-                        goto exit_tx;
-                    }
-                    // Flush pending packets if waiting
-                    if (batch_count > 0) {
-                        send(port->tx_socket, NULL, 0, 0);
-                        batch_count = 0;
-                    }
-                    if (++wait_count > 100) {
-                        struct pollfd pfd = {port->tx_socket, POLLOUT, 0};
-                        poll(&pfd, 1, 1);
-                        wait_count = 0;
-                    }
+                // Frame doğrudan ring/UMEM'de kurulur (dinamik boyut)
+                struct pkt_io_buf *b = &bufs[used++];
+                raw_tx_build_frame(b->data, &target->hdr_templates[vl_index], pkt_size, seq,
+                                   port->prbs_cache_ext, prbs_len);
+                b->len = pkt_size;
+
+#if RAW_SOCKET_TIMESTAMPING
+                // Ring: kernel TX zamanı errqueue'dan gelir; XSK: TX zamanı yok, kurulum anı
+                if (lane->xsk) {
+                    if (raw_lat_sampled(seq))
+                        raw_lat_tx_sample(vl_id, seq, raw_lat_now_ns());
+                } else {
+                    raw_lat_tx_frame(&lane->lat, vl_id, seq);
                 }
+#endif
 
-                // Copy packet to ring buffer (dinamik boyut)
-                uint8_t *frame_data = (uint8_t *)hdr + TPACKET2_HDRLEN - sizeof(struct sockaddr_ll);
-                memcpy(frame_data, packet_buffer, pkt_size);
-                hdr->tp_len = pkt_size;
-                hdr->tp_status = TP_STATUS_SEND_REQUEST;
+                // Pacing telemetry: ring'e yazım anı = departure
+                if (target->limiter.resync_slots) {
+                    tx_pacing_record_resync(target->pacing, target->limiter.resync_slots);
+                    target->limiter.resync_slots = 0;
+                }
+                tx_pacing_record_departure(target->pacing, target->limiter.last_slot_ns,
+                                           get_time_ns());
 
                 // Update stats
-                pthread_spin_lock(&target->stats.lock);
-                target->stats.tx_packets++;
-                target->stats.tx_bytes += pkt_size;
-                pthread_spin_unlock(&target->stats.lock);
+                raw_stat_add(&target->stats.tx_packets, 1);
+                raw_stat_add(&target->stats.tx_bytes, pkt_size);
 
                 if (!first_tx[t]) {
-                    printf("[Port %u TX] Target %d (->P%u): First packet VL-ID=%u Seq=%lu\n",
-                           port->port_id, t, target->config.dest_port, vl_id, seq);
+                    printf("[Port %u TX L%u] Target %d (->P%u): First packet VL-ID=%u Seq=%lu\n",
+                           port->port_id, lane->lane_id, t, target->config.dest_port, vl_id, seq);
                     first_tx[t] = true;
                 }
 
-                // Advance ring offset
-                port->tx_ring_offset = (port->tx_ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
-
                 // Round-robin through VL-IDs
                 target->current_vl_offset = (target->current_vl_offset + 1) % target->config.vl_id_count;
                 any_sent = true;
-                batch_count++;
                 sent_this_target++;
+            }
 
-                // Flush batch periodically
-                if (batch_count >= BATCH_SIZE) {
-                    if (send(port->tx_socket, NULL, 0, 0) < 0) {
-                        pthread_spin_lock(&target->stats.lock);
-                        target->stats.tx_errors++;
-                        pthread_spin_unlock(&target->stats.lock);
-                    }
-                    batch_count = 0;
+            // Target'ın burst'ünü gönderime ver, kullanılmayan frame'leri geri bırak
+            batch_count += pkt_io_tx_burst(io, bufs, used);
+            pkt_io_tx_free(io, bufs + used, allocated - used);
+
+            // Flush batch: eşik ring doluluğuna göre
+            if (batch_count >= RAW_TX_KICK_MIN &&
+                batch_count >= raw_tx_kick_threshold(pkt_io_tx_in_flight(io))) {
+                if (pkt_io_tx_flush(io) < 0) {
+                    raw_stat_add(&target->stats.tx_errors, 1);
                 }
+                batch_count = 0;
             }
         }
 
-        // Flush any remaining packets
+        // Eşik altı kalan frame'ler: döngü boşta kaldıysa (sıradaki slot henüz
+        // gelmedi) veya en eski bekleyen frame RAW_TX_KICK_MAX_WAIT_NS'yi
+        // aştıysa kick; aksi halde sonraki pass'lerin frame'leriyle birikir
         if (batch_count > 0) {
-            send(port->tx_socket, NULL, 0, 0);
-            batch_count = 0;
+            uint64_t now_ns = get_time_ns();
+            if (kick_deadline_ns == 0)
+                kick_deadline_ns = now_ns + RAW_TX_KICK_MAX_WAIT_NS;
+            if (!any_sent || now_ns >= kick_deadline_ns) {
+                pkt_io_tx_flush(io);
+                batch_count = 0;
+            }
         }
+        if (batch_count == 0)
+            kick_deadline_ns = 0;
+
+#if RAW_SOCKET_TIMESTAMPING
+        if (!lane->xsk)
+            raw_lat_tx_poll(lane->socket_fd, &lane->lat);
+#endif
 
         if (!any_sent) {
             struct timespec ts = {0, 100};  // 100ns sleep (was 1µs)
@@ -1133,10 +1878,9 @@ void *raw_tx_worker(void *arg)
 exit_tx:
     // Flush remaining
     if (batch_count > 0) {
-        send(port->tx_socket, NULL, 0, 0);
+        pkt_io_tx_flush(io);
     }
-    printf("[Port %u TX Worker] Stopped\n", port->port_id);
-    port->tx_running = false;
+    printf("[Port %u TX L%u] Stopped\n", port->port_id, lane->lane_id);
     return NULL;
 }
 
@@ -1158,9 +1902,9 @@ void *raw_rx_worker(void *arg)
     struct raw_socket_port *partner = NULL;
     if (port->rx_source_count > 0) {
         uint16_t partner_port_id = port->rx_sources[0].config.source_port;
-        for (int i = 0; i < MAX_RAW_SOCKET_PORTS; i++) {
-            if (raw_ports[i].port_id == partner_port_id) {
-                partner = &raw_ports[i];
+        for (int i = 0; i < raw_port_count; i++) {
+            if (raw_ports[i]->port_id == partner_port_id) {
+                partner = raw_ports[i];
                 break;
             }
         }
@@ -1168,18 +1912,8 @@ void *raw_rx_worker(void *arg)
 
     // Pre-cache PRBS pointers for DPDK external TX ports
 #if DPDK_EXT_TX_ENABLED
-    // Port 12 receives from Port 2,3,4,5 (VL-ID 4291-4418)
-    // Port 13 receives from Port 0,6 (VL-ID 4099-4130)
-    uint8_t *dpdk_prbs_caches_port12[4] = {
-        get_prbs_cache_ext_for_port(2),
-        get_prbs_cache_ext_for_port(3),
-        get_prbs_cache_ext_for_port(4),
-        get_prbs_cache_ext_for_port(5)
-    };
-    uint8_t *dpdk_prbs_caches_port13[2] = {
-        get_prbs_cache_ext_for_port(0),
-        get_prbs_cache_ext_for_port(6)
-    };
+    struct raw_ext_rx_caches ext_caches;
+    raw_ext_rx_caches_init(&ext_caches);
 
     // Sequence tracking - separate for Port 12 and Port 13
     // Port 12: VL-ID 4291-4418 (128 entries)
@@ -1212,14 +1946,14 @@ void *raw_rx_worker(void *arg)
     uint64_t local_dpdk_lost = 0;
     const uint32_t STATS_FLUSH_INTERVAL = 1024;  // Flush every 1024 packets
     uint32_t empty_polls = 0;
-    const uint32_t BUSY_POLL_COUNT = 64;  // Spin this many times before blocking poll
+    const uint32_t BUSY_POLL_COUNT = RAW_RX_BUSY_POLL_COUNT;  // Spin this many times before blocking poll
+
+    struct pkt_io_buf bufs[PKT_IO_BURST];
 
     while (!port->stop_flag && (g_stop_flag == NULL || !*g_stop_flag)) {
-        struct tpacket2_hdr *hdr = (struct tpacket2_hdr *)(
-            (uint8_t *)port->rx_ring +
-            (port->rx_ring_offset * RAW_SOCKET_RING_FRAME_SIZE));
+        uint16_t nb_rx = pkt_io_rx_burst(&port->rx_io, bufs, PKT_IO_BURST);
 
-        if (!(hdr->tp_status & TP_STATUS_USER)) {
+        if (nb_rx == 0) {
             empty_polls++;
             // Busy poll for a while before blocking
             if (empty_polls < BUSY_POLL_COUNT) {
@@ -1228,14 +1962,9 @@ void *raw_rx_worker(void *arg)
             }
             // Flush local stats before blocking poll
             if (local_dpdk_rx_pkts > 0) {
-                pthread_spin_lock(&port->dpdk_ext_rx_stats.lock);
-                port->dpdk_ext_rx_stats.rx_packets += local_dpdk_rx_pkts;
-                port->dpdk_ext_rx_stats.rx_bytes += local_dpdk_rx_bytes;
-                port->dpdk_ext_rx_stats.good_pkts += local_dpdk_good;
-                port->dpdk_ext_rx_stats.bad_pkts += local_dpdk_bad;
-                port->dpdk_ext_rx_stats.bit_errors += local_dpdk_bit_errors;
-                port->dpdk_ext_rx_stats.lost_pkts += local_dpdk_lost;
-                pthread_spin_unlock(&port->dpdk_ext_rx_stats.lock);
+                raw_stats_flush_rx(&port->dpdk_ext_rx_stats, local_dpdk_rx_pkts,
+                                   local_dpdk_rx_bytes, local_dpdk_good, local_dpdk_bad,
+                                   local_dpdk_bit_errors, local_dpdk_lost);
                 local_dpdk_rx_pkts = 0;
                 local_dpdk_rx_bytes = 0;
                 local_dpdk_good = 0;
@@ -1243,285 +1972,172 @@ void *raw_rx_worker(void *arg)
                 local_dpdk_bit_errors = 0;
                 local_dpdk_lost = 0;
             }
-            struct pollfd pfd = {port->rx_socket, POLLIN, 0};
-            poll(&pfd, 1, 1);  // 1ms blocking poll
+            pkt_io_wait(&port->rx_io, POLLIN, 1);  // 1ms blocking poll
             empty_polls = 0;
             continue;
         }
         empty_polls = 0;  // Reset on successful packet
 
-        uint8_t *pkt_data = (uint8_t *)hdr + hdr->tp_mac;
-        uint32_t pkt_len = hdr->tp_len;
+        for (uint16_t i = 0; i < nb_rx; i++) {
+            uint8_t *pkt_data = bufs[i].data;
+            uint32_t pkt_len = bufs[i].len;
 
-        // Validate minimum packet size
-        if (pkt_len < RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE +
-                      RAW_PKT_UDP_HDR_SIZE + RAW_PKT_SEQ_BYTES) {
-            hdr->tp_status = TP_STATUS_KERNEL;
-            port->rx_ring_offset = (port->rx_ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
-            continue;
-        }
+            // Validate minimum packet size
+            if (pkt_len < RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE +
+                          RAW_PKT_UDP_HDR_SIZE + RAW_PKT_SEQ_BYTES) {
+                continue;
+            }
 
-        // Check EtherType (must be IPv4 - VLAN is stripped by switch)
-        uint16_t ethertype = (pkt_data[12] << 8) | pkt_data[13];
-        if (ethertype != 0x0800) {
-            hdr->tp_status = TP_STATUS_KERNEL;
-            port->rx_ring_offset = (port->rx_ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
-            continue;
-        }
+            // Check EtherType (must be IPv4 - VLAN is stripped by switch)
+            uint16_t ethertype = (pkt_data[12] << 8) | pkt_data[13];
+            if (ethertype != 0x0800) {
+                continue;
+            }
 
-        // Extract VL-ID from DST MAC
-        uint16_t vl_id = ((uint16_t)pkt_data[4] << 8) | pkt_data[5];
+            // Extract VL-ID from DST MAC
+            uint16_t vl_id = ((uint16_t)pkt_data[4] << 8) | pkt_data[5];
 
-        // ==========================================
-        // DPDK EXTERNAL TX PACKET HANDLING
-        // Switch strips VLAN header, so packets arrive as IPv4 (0x0800)
-        // Port 12: VL-ID 4291-4418 from Port 2,3,4,5
-        // Port 13: VL-ID 4099-4130 from Port 0,6
-        // ==========================================
+            // DPDK external TX paketi (VLAN switch'te soyulmuş)
 #if DPDK_EXT_TX_ENABLED
-        int dpdk_src_port = dpdk_ext_tx_get_source_port(vl_id);
-        if (dpdk_src_port >= 0) {
-            // This is a DPDK external packet (VLAN stripped by switch)
-            // Offsets for non-VLAN packet: ETH(14) + IP(20) + UDP(8) = 42
-            uint8_t *payload = pkt_data + 14 + 20 + 8;
-            uint64_t seq;
-            memcpy(&seq, payload, sizeof(seq));
-
-            // Update local stats (no spinlock per packet!)
-            local_dpdk_rx_pkts++;
-            local_dpdk_rx_bytes += pkt_len;
-
-            // Sequence tracking for lost packet detection (port-specific)
-            if (port->port_id == 12) {
-                // Port 12 receives from Port 2,3,4,5
-                uint16_t vl_idx = vl_id - DPDK_EXT_VL_ID_START_P12;
-                if (vl_idx < DPDK_EXT_VL_ID_COUNT_P12) {
-                    if (!dpdk_ext_seq_initialized_p12[vl_idx]) {
-                        dpdk_ext_expected_seq_p12[vl_idx] = seq + 1;
-                        dpdk_ext_seq_initialized_p12[vl_idx] = true;
-                    } else {
-                        uint64_t expected = dpdk_ext_expected_seq_p12[vl_idx];
-                        if (seq > expected) {
-                            local_dpdk_lost += (seq - expected);
+            int dpdk_src_port = dpdk_ext_tx_get_source_port(vl_id);
+            if (dpdk_src_port >= 0) {
+                uint64_t seq;
+                int64_t bit_err = raw_ext_rx_frame(&ext_caches, port->port_id, &port->rx_io, &bufs[i],
+                                                   vl_id, dpdk_src_port, &seq);
+
+                // Update local stats (no spinlock per packet!)
+                local_dpdk_rx_pkts++;
+                local_dpdk_rx_bytes += pkt_len;
+
+                // Sequence tracking for lost packet detection (port-specific)
+                if (port->port_id == 12) {
+                    // Port 12 receives from Port 2,3,4,5
+                    uint16_t vl_idx = vl_id - DPDK_EXT_VL_ID_START_P12;
+                    if (vl_idx < DPDK_EXT_VL_ID_COUNT_P12) {
+                        if (!dpdk_ext_seq_initialized_p12[vl_idx]) {
+                            dpdk_ext_expected_seq_p12[vl_idx] = seq + 1;
+                            dpdk_ext_seq_initialized_p12[vl_idx] = true;
+                        } else {
+                            uint64_t expected = dpdk_ext_expected_seq_p12[vl_idx];
+                            if (seq > expected) {
+                                local_dpdk_lost += (seq - expected);
+                            }
+                            dpdk_ext_expected_seq_p12[vl_idx] = seq + 1;
                         }
-                        dpdk_ext_expected_seq_p12[vl_idx] = seq + 1;
                     }
-                }
-            } else if (port->port_id == 13) {
-                // Port 13 receives from Port 0,6
-                uint16_t vl_idx = vl_id - DPDK_EXT_VL_ID_START_P13;
-                if (vl_idx < DPDK_EXT_VL_ID_COUNT_P13) {
-                    if (!dpdk_ext_seq_initialized_p13[vl_idx]) {
-                        dpdk_ext_expected_seq_p13[vl_idx] = seq + 1;
-                        dpdk_ext_seq_initialized_p13[vl_idx] = true;
-                    } else {
-                        uint64_t expected = dpdk_ext_expected_seq_p13[vl_idx];
-                        if (seq > expected) {
-                            local_dpdk_lost += (seq - expected);
+                } else if (port->port_id == 13) {
+                    // Port 13 receives from Port 0,6
+                    uint16_t vl_idx = vl_id - DPDK_EXT_VL_ID_START_P13;
+                    if (vl_idx < DPDK_EXT_VL_ID_COUNT_P13) {
+                        if (!dpdk_ext_seq_initialized_p13[vl_idx]) {
+                            dpdk_ext_expected_seq_p13[vl_idx] = seq + 1;
+                            dpdk_ext_seq_initialized_p13[vl_idx] = true;
+                        } else {
+                            uint64_t expected = dpdk_ext_expected_seq_p13[vl_idx];
+                            if (seq > expected) {
+                                local_dpdk_lost += (seq - expected);
+                            }
+                            dpdk_ext_expected_seq_p13[vl_idx] = seq + 1;
                         }
-                        dpdk_ext_expected_seq_p13[vl_idx] = seq + 1;
                     }
                 }
-            }
 
-            // PRBS verification using pre-cached DPDK port's cache
-            // Port 12: dpdk_src_port 2,3,4,5 → index 0,1,2,3
-            // Port 13: dpdk_src_port 0,6 → index 0,1
-            int cache_idx = -1;
-            uint8_t *dpdk_prbs_cache = NULL;
-            if (port->port_id == 12) {
-                cache_idx = dpdk_src_port - 2;
-                dpdk_prbs_cache = (cache_idx >= 0 && cache_idx < 4) ? dpdk_prbs_caches_port12[cache_idx] : NULL;
-            } else if (port->port_id == 13) {
-                if (dpdk_src_port == 0) cache_idx = 0;
-                else if (dpdk_src_port == 6) cache_idx = 1;
-                dpdk_prbs_cache = (cache_idx >= 0 && cache_idx < 2) ? dpdk_prbs_caches_port13[cache_idx] : NULL;
-            }
-            if (dpdk_prbs_cache) {
-                uint8_t *recv_prbs = payload + 8;
-                // DPDK TX uses NUM_PRBS_BYTES for both offset calculation and data
-                // Must use NUM_PRBS_BYTES for offset calc to match TX side!
-                uint16_t cmp_bytes = pkt_len - 14 - 20 - 8 - 8; // ETH+IP+UDP+SEQ
-                if (cmp_bytes > NUM_PRBS_BYTES) cmp_bytes = NUM_PRBS_BYTES;
-
-                // CRITICAL: Use NUM_PRBS_BYTES for offset, same as TX side
-                uint64_t prbs_offset = (seq * (uint64_t)NUM_PRBS_BYTES) % PRBS_CACHE_SIZE;
-                uint8_t *expected_prbs = dpdk_prbs_cache + prbs_offset;
-
-                if (memcmp(recv_prbs, expected_prbs, cmp_bytes) == 0) {
+                if (bit_err == 0) {
                     local_dpdk_good++;
-                } else {
-                    static int debug_count = 0;
-                    if (debug_count < 5) {
-                        debug_count++;
-                        // Get IP header info
-                        uint8_t ip_ver_ihl = pkt_data[14];
-                        uint8_t ip_ihl = (ip_ver_ihl & 0x0F) * 4;  // IP header length in bytes
-
-                        printf("[DPDK-EXT RX DEBUG] PRBS Error #%d: VL-ID=%u, src_port=%d, seq=%lu, pkt_len=%u, cmp_bytes=%u\n",
-                               debug_count, vl_id, dpdk_src_port, seq, pkt_len, cmp_bytes);
-                        printf("  IP: ver_ihl=0x%02x (IHL=%u bytes), EtherType=0x%02x%02x\n",
-                               ip_ver_ihl, ip_ihl, pkt_data[12], pkt_data[13]);
-                        printf("  prbs_offset=%lu, NUM_PRBS_BYTES=%u, PRBS_CACHE_SIZE=%lu\n",
-                               prbs_offset, NUM_PRBS_BYTES, (unsigned long)PRBS_CACHE_SIZE);
-                        printf("  dpdk_prbs_cache=%p, expected_prbs=%p, recv_prbs=%p\n",
-                               (void*)dpdk_prbs_cache, (void*)expected_prbs, (void*)recv_prbs);
-                        printf("  recv[0..7]: %02x %02x %02x %02x %02x %02x %02x %02x\n",
-                               recv_prbs[0], recv_prbs[1], recv_prbs[2], recv_prbs[3],
-                               recv_prbs[4], recv_prbs[5], recv_prbs[6], recv_prbs[7]);
-                        printf("  exp[0..7]:  %02x %02x %02x %02x %02x %02x %02x %02x\n",
-                               expected_prbs[0], expected_prbs[1], expected_prbs[2], expected_prbs[3],
-                               expected_prbs[4], expected_prbs[5], expected_prbs[6], expected_prbs[7]);
-                    }
+                } else if (bit_err > 0) {
                     local_dpdk_bad++;
-                    for (int b = 0; b < cmp_bytes; b++) {
-                        local_dpdk_bit_errors += __builtin_popcount(recv_prbs[b] ^ expected_prbs[b]);
-                    }
+                    local_dpdk_bit_errors += (uint64_t)bit_err;
                 }
-            }
 
-            // Periodic stats flush
-            if (local_dpdk_rx_pkts >= STATS_FLUSH_INTERVAL) {
-                pthread_spin_lock(&port->dpdk_ext_rx_stats.lock);
-                port->dpdk_ext_rx_stats.rx_packets += local_dpdk_rx_pkts;
-                port->dpdk_ext_rx_stats.rx_bytes += local_dpdk_rx_bytes;
-                port->dpdk_ext_rx_stats.good_pkts += local_dpdk_good;
-                port->dpdk_ext_rx_stats.bad_pkts += local_dpdk_bad;
-                port->dpdk_ext_rx_stats.bit_errors += local_dpdk_bit_errors;
-                port->dpdk_ext_rx_stats.lost_pkts += local_dpdk_lost;
-                pthread_spin_unlock(&port->dpdk_ext_rx_stats.lock);
-                local_dpdk_rx_pkts = 0;
-                local_dpdk_rx_bytes = 0;
-                local_dpdk_good = 0;
-                local_dpdk_bad = 0;
-                local_dpdk_bit_errors = 0;
-                local_dpdk_lost = 0;
-            }
+                // Periodic stats flush
+                if (local_dpdk_rx_pkts >= STATS_FLUSH_INTERVAL) {
+                    raw_stats_flush_rx(&port->dpdk_ext_rx_stats, local_dpdk_rx_pkts,
+                                       local_dpdk_rx_bytes, local_dpdk_good, local_dpdk_bad,
+                                       local_dpdk_bit_errors, local_dpdk_lost);
+                    local_dpdk_rx_pkts = 0;
+                    local_dpdk_rx_bytes = 0;
+                    local_dpdk_good = 0;
+                    local_dpdk_bad = 0;
+                    local_dpdk_bit_errors = 0;
+                    local_dpdk_lost = 0;
+                }
 
-            hdr->tp_status = TP_STATUS_KERNEL;
-            port->rx_ring_offset = (port->rx_ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
-            continue;
-        }
+                continue;
+            }
 #endif
 
-        // ==========================================
-        // RAW SOCKET PACKET HANDLING (from Port 13)
-        // ==========================================
-        // Find which source this packet belongs to
-        int source_idx = -1;
-        for (int s = 0; s < port->rx_source_count; s++) {
-            struct raw_rx_source_state *source = &port->rx_sources[s];
-            if (vl_id >= source->config.vl_id_start &&
-                vl_id < source->config.vl_id_start + source->config.vl_id_count) {
-                source_idx = s;
-                break;
+            // ==========================================
+            // RAW SOCKET PACKET HANDLING (from Port 13)
+            // ==========================================
+            // Find which source this packet belongs to
+            int source_idx = -1;
+            for (int s = 0; s < port->rx_source_count; s++) {
+                struct raw_rx_source_state *source = &port->rx_sources[s];
+                if (vl_id >= source->config.vl_id_start &&
+                    vl_id < source->config.vl_id_start + source->config.vl_id_count) {
+                    source_idx = s;
+                    break;
+                }
             }
-        }
 
-        if (source_idx < 0) {
-            // Not from a known source, skip
-            hdr->tp_status = TP_STATUS_KERNEL;
-            port->rx_ring_offset = (port->rx_ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
-            continue;
-        }
+            if (source_idx < 0) {
+                // Not from a known source, skip
+                continue;
+            }
 
-        struct raw_rx_source_state *source = &port->rx_sources[source_idx];
-        uint16_t vl_index = vl_id - source->config.vl_id_start;
+            struct raw_rx_source_state *source = &port->rx_sources[source_idx];
+            uint16_t vl_index = vl_id - source->config.vl_id_start;
 
-        // Get sequence number from payload
-        uint8_t *payload = pkt_data + RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE + RAW_PKT_UDP_HDR_SIZE;
-        uint64_t seq;
-        memcpy(&seq, payload, sizeof(seq));
+            // Get sequence number from payload
+            uint8_t *payload = pkt_data + RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE + RAW_PKT_UDP_HDR_SIZE;
+            uint64_t seq;
+            memcpy(&seq, payload, sizeof(seq));
 
-        pthread_spin_lock(&source->stats.lock);
-        source->stats.rx_packets++;
-        source->stats.rx_bytes += pkt_len;
-        pthread_spin_unlock(&source->stats.lock);
+            struct raw_target_stats *sst = &source->stats;
+            raw_stat_add(&sst->rx_packets, 1);
+            raw_stat_add(&sst->rx_bytes, pkt_len);
 
-        if (!first_rx[source_idx]) {
-            printf("[Port %u RX] Source %d (<-P%u): First packet VL-ID=%u Seq=%lu\n",
-                   port->port_id, source_idx, source->config.source_port, vl_id, seq);
-            first_rx[source_idx] = true;
-        }
+            if (!first_rx[source_idx]) {
+                printf("[Port %u RX] Source %d (<-P%u): First packet VL-ID=%u Seq=%lu\n",
+                       port->port_id, source_idx, source->config.source_port, vl_id, seq);
+                first_rx[source_idx] = true;
+            }
 
-        // Sequence validation
-        pthread_spin_lock(&source->vl_sequences[vl_index].rx_lock);
+            // Sequence validation
+            if (!source->vl_sequences[vl_index].rx_initialized) {
+                source->vl_sequences[vl_index].rx_expected_seq = seq + 1;
+                source->vl_sequences[vl_index].rx_initialized = true;
+            } else {
+                uint64_t expected = source->vl_sequences[vl_index].rx_expected_seq;
 
-        if (!source->vl_sequences[vl_index].rx_initialized) {
-            source->vl_sequences[vl_index].rx_expected_seq = seq + 1;
-            source->vl_sequences[vl_index].rx_initialized = true;
-        } else {
-            uint64_t expected = source->vl_sequences[vl_index].rx_expected_seq;
-
-            if (seq != expected) {
-                if (seq > expected) {
-                    uint64_t gap = seq - expected;
-                    pthread_spin_lock(&source->stats.lock);
-                    source->stats.lost_pkts += gap;
-                    pthread_spin_unlock(&source->stats.lock);
-                } else {
-                    pthread_spin_lock(&source->stats.lock);
-                    if (seq == expected - 1) {
-                        source->stats.duplicate_pkts++;
+                if (seq != expected) {
+                    if (seq > expected) {
+                        raw_stat_add(&sst->lost_pkts, seq - expected);
+                    } else if (seq == expected - 1) {
+                        raw_stat_add(&sst->duplicate_pkts, 1);
                     } else {
-                        source->stats.out_of_order_pkts++;
+                        raw_stat_add(&sst->out_of_order_pkts, 1);
                     }
-                    pthread_spin_unlock(&source->stats.lock);
                 }
-            }
 
-            source->vl_sequences[vl_index].rx_expected_seq = seq + 1;
-        }
-
-        pthread_spin_unlock(&source->vl_sequences[vl_index].rx_lock);
-
-        // PRBS verification
-        if (partner && partner->prbs_initialized) {
-            uint8_t *recv_prbs = payload + RAW_PKT_SEQ_BYTES;
-
-#if IMIX_ENABLED
-            // IMIX: PRBS offset hesabı HEP MAX boyut ile yapılır
-            // PRBS boyutu paket boyutundan hesaplanır
-            uint16_t prbs_len = pkt_len - RAW_PKT_ETH_HDR_SIZE - RAW_PKT_IP_HDR_SIZE -
-                                RAW_PKT_UDP_HDR_SIZE - RAW_PKT_SEQ_BYTES;
-            if (prbs_len > RAW_MAX_PRBS_BYTES) prbs_len = RAW_MAX_PRBS_BYTES;
-
-            uint64_t prbs_offset = (seq * (uint64_t)RAW_MAX_PRBS_BYTES) % RAW_PRBS_CACHE_SIZE;
-            uint8_t *expected_prbs = partner->prbs_cache_ext + prbs_offset;
-
-            if (memcmp(recv_prbs, expected_prbs, prbs_len) == 0) {
-                pthread_spin_lock(&source->stats.lock);
-                source->stats.good_pkts++;
-                pthread_spin_unlock(&source->stats.lock);
-            } else {
-                pthread_spin_lock(&source->stats.lock);
-                source->stats.bad_pkts++;
-                for (uint16_t i = 0; i < prbs_len; i++) {
-                    source->stats.bit_errors += __builtin_popcount(recv_prbs[i] ^ expected_prbs[i]);
-                }
-                pthread_spin_unlock(&source->stats.lock);
+                source->vl_sequences[vl_index].rx_expected_seq = seq + 1;
             }
-#else
-            uint64_t prbs_offset = (seq * (uint64_t)RAW_PKT_PRBS_BYTES) % RAW_PRBS_CACHE_SIZE;
-            uint8_t *expected_prbs = partner->prbs_cache_ext + prbs_offset;
 
-            if (memcmp(recv_prbs, expected_prbs, RAW_PKT_PRBS_BYTES) == 0) {
-                pthread_spin_lock(&source->stats.lock);
-                source->stats.good_pkts++;
-                pthread_spin_unlock(&source->stats.lock);
-            } else {
-                pthread_spin_lock(&source->stats.lock);
-                source->stats.bad_pkts++;
-                for (int i = 0; i < RAW_PKT_PRBS_BYTES; i++) {
-                    source->stats.bit_errors += __builtin_popcount(recv_prbs[i] ^ expected_prbs[i]);
+            // PRBS verification (IMIX: boyut paketten, offset hep RAW_PKT_PRBS_BYTES ile)
+            if (partner && partner->prbs_initialized) {
+                uint64_t bit_err = pkt_payload_verify(payload + RAW_PKT_SEQ_BYTES,
+                                                      pkt_len - RAW_PKT_HDR_SIZE - RAW_PKT_SEQ_BYTES, seq,
+                                                      partner->prbs_cache_ext, RAW_PKT_PRBS_BYTES);
+                if (bit_err == 0) {
+                    raw_stat_add(&sst->good_pkts, 1);
+                } else {
+                    raw_stat_add(&sst->bad_pkts, 1);
+                    raw_stat_add(&sst->bit_errors, bit_err);
                 }
-                pthread_spin_unlock(&source->stats.lock);
             }
-#endif
         }
 
-        hdr->tp_status = TP_STATUS_KERNEL;
-        port->rx_ring_offset = (port->rx_ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
+        pkt_io_rx_free(&port->rx_io, bufs, nb_rx);
     }
 
     printf("[Port %u RX Worker] Stopped\n", port->port_id);
@@ -1534,12 +2150,6 @@ void *raw_rx_worker(void *arg)
 // ==========================================
 
 // Worker argument structure (passed to each queue worker thread)
-struct multi_queue_worker_arg {
-    struct raw_socket_port *port;
-    struct raw_rx_queue *queue;
-};
-
-static struct multi_queue_worker_arg mq_worker_args[MAX_RAW_SOCKET_PORTS][RAW_SOCKET_RX_QUEUE_COUNT];
 
 // Helper function to set CPU affinity
 static int set_thread_cpu_affinity(pthread_t thread, int cpu_core)
@@ -1559,9 +2169,8 @@ static int set_thread_cpu_affinity(pthread_t thread, int cpu_core)
 
 void *multi_queue_rx_worker(void *arg)
 {
-    struct multi_queue_worker_arg *warg = (struct multi_queue_worker_arg *)arg;
-    struct raw_socket_port *port = warg->port;
-    struct raw_rx_queue *queue = warg->queue;
+    struct raw_rx_queue *queue = (struct raw_rx_queue *)arg;
+    struct raw_socket_port *port = queue->port;
 
     printf("[Port %u Q%d RX Worker] Started on CPU core %u\n",
            port->port_id, queue->queue_id, queue->cpu_core);
@@ -1570,18 +2179,8 @@ void *multi_queue_rx_worker(void *arg)
 
     // Pre-cache PRBS data pointers for DPDK external packet verification
 #if DPDK_EXT_TX_ENABLED
-    // Port 12 receives from Port 2,3,4,5
-    uint8_t *dpdk_prbs_caches_p12[4] = {
-        get_prbs_cache_ext_for_port(2),
-        get_prbs_cache_ext_for_port(3),
-        get_prbs_cache_ext_for_port(4),
-        get_prbs_cache_ext_for_port(5)
-    };
-    // Port 13 receives from Port 0,6
-    uint8_t *dpdk_prbs_caches_p13[2] = {
-        get_prbs_cache_ext_for_port(0),
-        get_prbs_cache_ext_for_port(6)
-    };
+    struct raw_ext_rx_caches ext_caches;
+    raw_ext_rx_caches_init(&ext_caches);
     // Note: Using global sequence tracking (g_vl_seq) instead of per-queue
 #endif
 
@@ -1594,7 +2193,7 @@ void *multi_queue_rx_worker(void *arg)
     // Note: local_lost removed - using global sequence tracking instead
     const uint32_t STATS_FLUSH_INTERVAL = 1024;
     uint32_t empty_polls = 0;
-    const uint32_t BUSY_POLL_COUNT = 64;
+    const uint32_t BUSY_POLL_COUNT = RAW_RX_BUSY_POLL_COUNT;
 
     // VL-ID tracking (local, thread-safe)
     uint16_t local_vl_min = 0xFFFF;
@@ -1604,13 +2203,16 @@ void *multi_queue_rx_worker(void *arg)
     queue->vl_id_min = 0xFFFF;
     queue->vl_id_max = 0;
     queue->unique_vl_ids = 0;
+    // Tracker'sız kuyruk: başlangıçta sıfırdan başladı, mevcut nesli uygulanmış say
+    if (!queue->vl_track)
+        queue->vl_track_gen = __atomic_load_n(&port->vl_track_gen, __ATOMIC_ACQUIRE);
+
+    struct pkt_io_buf bufs[PKT_IO_BURST];
 
     while (!port->stop_flag && (g_stop_flag == NULL || !*g_stop_flag)) {
-        struct tpacket2_hdr *hdr = (struct tpacket2_hdr *)(
-            (uint8_t *)queue->ring +
-            (queue->ring_offset * RAW_SOCKET_RING_FRAME_SIZE));
+        uint16_t nb_rx = pkt_io_rx_burst(&queue->io, bufs, PKT_IO_BURST);
 
-        if (!(hdr->tp_status & TP_STATUS_USER)) {
+        if (nb_rx == 0) {
             empty_polls++;
             if (empty_polls < BUSY_POLL_COUNT) {
                 _mm_pause();
@@ -1618,14 +2220,9 @@ void *multi_queue_rx_worker(void *arg)
             }
             // Flush local stats before blocking
             if (local_rx_pkts > 0) {
-                pthread_spin_lock(&port->dpdk_ext_rx_stats.lock);
-                port->dpdk_ext_rx_stats.rx_packets += local_rx_pkts;
-                port->dpdk_ext_rx_stats.rx_bytes += local_rx_bytes;
-                port->dpdk_ext_rx_stats.good_pkts += local_good;
-                port->dpdk_ext_rx_stats.bad_pkts += local_bad;
-                port->dpdk_ext_rx_stats.bit_errors += local_bit_errors;
                 // Note: lost_pkts is calculated globally via get_global_sequence_lost()
-                pthread_spin_unlock(&port->dpdk_ext_rx_stats.lock);
+                raw_stats_flush_rx(&queue->dpdk_ext_stats, local_rx_pkts, local_rx_bytes,
+                                   local_good, local_bad, local_bit_errors, 0);
 
                 // Also update per-queue stats (no lock needed, thread-local)
                 queue->rx_packets += local_rx_pkts;
@@ -1636,12 +2233,7 @@ void *multi_queue_rx_worker(void *arg)
                 // Note: lost_pkts per queue is not used with global tracking
 
                 // Get kernel drop statistics
-                struct tpacket_stats kstats;
-                socklen_t kstats_len = sizeof(kstats);
-                if (getsockopt(queue->socket_fd, SOL_PACKET, PACKET_STATISTICS,
-                               &kstats, &kstats_len) == 0) {
-                    queue->kernel_drops = kstats.tp_drops;
-                }
+                raw_rx_collect_kernel_drops(queue);
 
                 // Update VL-ID tracking
                 if (local_vl_min < queue->vl_id_min) queue->vl_id_min = local_vl_min;
@@ -1653,271 +2245,223 @@ void *multi_queue_rx_worker(void *arg)
                 local_bad = 0;
                 local_bit_errors = 0;
             }
-            struct pollfd pfd = {queue->socket_fd, POLLIN, 0};
-            poll(&pfd, 1, 1);
+            if (raw_vl_track_sync(port, queue)) {
+                memset(vl_id_seen, 0, sizeof(vl_id_seen));
+                local_vl_min = 0xFFFF;
+                local_vl_max = 0;
+            }
+            // net.core.busy_poll > 0 ise poll() uyumadan önce NAPI'yi burada busy-poll eder
+            pkt_io_wait(&queue->io, POLLIN, 1);
             empty_polls = 0;
             continue;
         }
         empty_polls = 0;
 
-        uint8_t *pkt_data = (uint8_t *)hdr + hdr->tp_mac;
-        uint32_t pkt_len = hdr->tp_len;
+        for (uint16_t i = 0; i < nb_rx; i++) {
+            uint8_t *pkt_data = bufs[i].data;
+            uint32_t pkt_len = bufs[i].len;
 
-        // Validate minimum packet size
-        if (pkt_len < RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE +
-                      RAW_PKT_UDP_HDR_SIZE + RAW_PKT_SEQ_BYTES) {
-            hdr->tp_status = TP_STATUS_KERNEL;
-            queue->ring_offset = (queue->ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
-            continue;
-        }
+            // Validate minimum packet size
+            if (pkt_len < RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE +
+                          RAW_PKT_UDP_HDR_SIZE + RAW_PKT_SEQ_BYTES) {
+                continue;
+            }
 
-        // Check EtherType
-        uint16_t ethertype = (pkt_data[12] << 8) | pkt_data[13];
-        if (ethertype != 0x0800) {
-            hdr->tp_status = TP_STATUS_KERNEL;
-            queue->ring_offset = (queue->ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
-            continue;
-        }
+            // Check EtherType
+            uint16_t ethertype = (pkt_data[12] << 8) | pkt_data[13];
+            if (ethertype != 0x0800) {
+                continue;
+            }
 
-        // Extract VL-ID from DST MAC
-        uint16_t vl_id = ((uint16_t)pkt_data[4] << 8) | pkt_data[5];
+            // Extract VL-ID from DST MAC
+            uint16_t vl_id = ((uint16_t)pkt_data[4] << 8) | pkt_data[5];
 
 #if DPDK_EXT_TX_ENABLED
-        int dpdk_src_port = dpdk_ext_tx_get_source_port(vl_id);
-        if (dpdk_src_port >= 0) {
-            uint8_t *payload = pkt_data + 14 + 20 + 8;
-            uint64_t seq;
-            memcpy(&seq, payload, sizeof(seq));
-
-            local_rx_pkts++;
-            local_rx_bytes += pkt_len;
-
-            // VL-ID tracking
-            if (vl_id < local_vl_min) local_vl_min = vl_id;
-            if (vl_id > local_vl_max) local_vl_max = vl_id;
-
-            // Global sequence tracking (shared across all queues, port-specific)
-            struct global_vl_seq_state *vs = NULL;
-            uint16_t vl_idx = 0;
-
-            if (port->port_id == 12) {
-                vl_idx = vl_id - GLOBAL_SEQ_VL_ID_START_P12;
-                if (vl_idx < GLOBAL_SEQ_VL_ID_COUNT_P12) {
-                    vs = &g_vl_seq_p12[vl_idx];
-                }
-            } else if (port->port_id == 13) {
-                vl_idx = vl_id - GLOBAL_SEQ_VL_ID_START_P13;
-                if (vl_idx < GLOBAL_SEQ_VL_ID_COUNT_P13) {
-                    vs = &g_vl_seq_p13[vl_idx];
+            int dpdk_src_port = dpdk_ext_tx_get_source_port(vl_id);
+            if (dpdk_src_port >= 0) {
+                uint64_t seq;
+                int64_t bit_err = raw_ext_rx_frame(&ext_caches, port->port_id, &queue->io, &bufs[i],
+                                                   vl_id, dpdk_src_port, &seq);
+
+                local_rx_pkts++;
+                local_rx_bytes += pkt_len;
+
+                // VL-ID tracking
+                if (vl_id < local_vl_min) local_vl_min = vl_id;
+                if (vl_id > local_vl_max) local_vl_max = vl_id;
+
+                // Global sequence tracking (shared across all queues, port-specific)
+                struct global_vl_seq_state *vs = NULL;
+                uint16_t vl_idx = 0;
+
+                if (queue->vl_track) {
+                    // VL-ID steering: bu VL-ID sadece bu kuyruğa gelir, CAS gerekmez
+                    uint16_t ti = vl_id - port->vl_track_base;
+                    if (ti < port->vl_track_count &&
+                        raw_vl_track_update(&queue->vl_track[ti], seq)) {
+                        queue->unique_vl_ids++;
+                    }
+                } else if (port->port_id == 12) {
+                    vl_idx = vl_id - GLOBAL_SEQ_VL_ID_START_P12;
+                    if (vl_idx < GLOBAL_SEQ_VL_ID_COUNT_P12) {
+                        vs = &g_vl_seq_p12[vl_idx];
+                    }
+                } else if (port->port_id == 13) {
+                    vl_idx = vl_id - GLOBAL_SEQ_VL_ID_START_P13;
+                    if (vl_idx < GLOBAL_SEQ_VL_ID_COUNT_P13) {
+                        vs = &g_vl_seq_p13[vl_idx];
+                    }
                 }
-            }
 
-            if (vs != NULL) {
-                // Track unique VL-IDs (per-queue, for debugging)
-                uint8_t byte_idx = vl_idx / 8;
-                uint8_t bit_mask = 1 << (vl_idx % 8);
-                if (!(vl_id_seen[byte_idx] & bit_mask)) {
-                    vl_id_seen[byte_idx] |= bit_mask;
-                    queue->unique_vl_ids++;
-                }
+                if (vs != NULL) {
+                    // Track unique VL-IDs (per-queue, for debugging)
+                    uint8_t byte_idx = vl_idx / 8;
+                    uint8_t bit_mask = 1 << (vl_idx % 8);
+                    if (!(vl_id_seen[byte_idx] & bit_mask)) {
+                        vl_id_seen[byte_idx] |= bit_mask;
+                        queue->unique_vl_ids++;
+                    }
 
-                // Increment RX count
-                atomic_fetch_add(&vs->rx_count, 1);
+                    // Increment RX count
+                    atomic_fetch_add(&vs->rx_count, 1);
 
-                // Update min_seq (first seen sequence)
-                if (!atomic_load(&vs->initialized)) {
-                    // First packet for this VL-ID - set min_seq
-                    uint64_t expected = UINT64_MAX;
-                    if (atomic_compare_exchange_strong(&vs->min_seq, &expected, seq)) {
-                        atomic_store(&vs->initialized, true);
+                    // Update min_seq (first seen sequence)
+                    if (!atomic_load(&vs->initialized)) {
+                        // First packet for this VL-ID - set min_seq
+                        uint64_t expected = UINT64_MAX;
+                        if (atomic_compare_exchange_strong(&vs->min_seq, &expected, seq)) {
+                            atomic_store(&vs->initialized, true);
+                        }
                     }
-                }
 
-                // Update max_seq if this sequence is higher
-                uint64_t old_max = atomic_load(&vs->max_seq);
-                while (seq > old_max) {
-                    if (atomic_compare_exchange_weak(&vs->max_seq, &old_max, seq)) {
-                        break;
+                    // Update max_seq if this sequence is higher
+                    uint64_t old_max = atomic_load(&vs->max_seq);
+                    while (seq > old_max) {
+                        if (atomic_compare_exchange_weak(&vs->max_seq, &old_max, seq)) {
+                            break;
+                        }
                     }
-                }
 
-                // Also update min if this is smaller (for late arrivals)
-                uint64_t old_min = atomic_load(&vs->min_seq);
-                while (seq < old_min) {
-                    if (atomic_compare_exchange_weak(&vs->min_seq, &old_min, seq)) {
-                        break;
+                    // Also update min if this is smaller (for late arrivals)
+                    uint64_t old_min = atomic_load(&vs->min_seq);
+                    while (seq < old_min) {
+                        if (atomic_compare_exchange_weak(&vs->min_seq, &old_min, seq)) {
+                            break;
+                        }
                     }
                 }
-            }
-
-            // PRBS verification (port-specific cache selection)
-            uint8_t *dpdk_prbs_cache = NULL;
-            if (port->port_id == 12) {
-                // Port 12 receives from Port 2,3,4,5
-                int cache_idx = dpdk_src_port - 2;
-                if (cache_idx >= 0 && cache_idx < 4) {
-                    dpdk_prbs_cache = dpdk_prbs_caches_p12[cache_idx];
-                }
-            } else if (port->port_id == 13) {
-                // Port 13 receives from Port 0,6
-                int cache_idx = (dpdk_src_port == 0) ? 0 : ((dpdk_src_port == 6) ? 1 : -1);
-                if (cache_idx >= 0 && cache_idx < 2) {
-                    dpdk_prbs_cache = dpdk_prbs_caches_p13[cache_idx];
-                }
-            }
-            if (dpdk_prbs_cache) {
-                uint8_t *recv_prbs = payload + 8;
-                uint16_t cmp_bytes = pkt_len - 14 - 20 - 8 - 8;
-                if (cmp_bytes > NUM_PRBS_BYTES) cmp_bytes = NUM_PRBS_BYTES;
 
-                uint64_t prbs_offset = (seq * (uint64_t)NUM_PRBS_BYTES) % PRBS_CACHE_SIZE;
-                uint8_t *expected_prbs = dpdk_prbs_cache + prbs_offset;
-
-                if (memcmp(recv_prbs, expected_prbs, cmp_bytes) == 0) {
-                    local_good++;
-                } else {
+                if (bit_err > 0) {
                     local_bad++;
-                    // Count bit errors
-                    for (int b = 0; b < cmp_bytes; b++) {
-                        uint8_t diff = recv_prbs[b] ^ expected_prbs[b];
-                        local_bit_errors += __builtin_popcount(diff);
-                    }
+                    local_bit_errors += (uint64_t)bit_err;
+                } else {
+                    local_good++;  // -1: no cache, assume good
                 }
-            } else {
-                local_good++;  // No cache, assume good
-            }
 
-            // Periodic stats flush
-            if (local_rx_pkts >= STATS_FLUSH_INTERVAL) {
-                pthread_spin_lock(&port->dpdk_ext_rx_stats.lock);
-                port->dpdk_ext_rx_stats.rx_packets += local_rx_pkts;
-                port->dpdk_ext_rx_stats.rx_bytes += local_rx_bytes;
-                port->dpdk_ext_rx_stats.good_pkts += local_good;
-                port->dpdk_ext_rx_stats.bad_pkts += local_bad;
-                port->dpdk_ext_rx_stats.bit_errors += local_bit_errors;
-                pthread_spin_unlock(&port->dpdk_ext_rx_stats.lock);
+                // Periodic stats flush
+                if (local_rx_pkts >= STATS_FLUSH_INTERVAL) {
+                    raw_stats_flush_rx(&queue->dpdk_ext_stats, local_rx_pkts, local_rx_bytes,
+                                       local_good, local_bad, local_bit_errors, 0);
+
+                    queue->rx_packets += local_rx_pkts;
+                    queue->rx_bytes += local_rx_bytes;
+                    queue->good_pkts += local_good;
+                    queue->bad_pkts += local_bad;
+                    queue->bit_errors += local_bit_errors;
+
+                    // Yük altında worker hiç idle olmaz, drop'lar burada da toplanır
+                    raw_rx_collect_kernel_drops(queue);
+                    if (raw_vl_track_sync(port, queue)) {
+                        memset(vl_id_seen, 0, sizeof(vl_id_seen));
+                        local_vl_min = 0xFFFF;
+                        local_vl_max = 0;
+                    }
 
-                queue->rx_packets += local_rx_pkts;
-                queue->rx_bytes += local_rx_bytes;
-                queue->good_pkts += local_good;
-                queue->bad_pkts += local_bad;
-                queue->bit_errors += local_bit_errors;
+                    local_rx_pkts = 0;
+                    local_rx_bytes = 0;
+                    local_good = 0;
+                    local_bad = 0;
+                    local_bit_errors = 0;
+                }
 
-                local_rx_pkts = 0;
-                local_rx_bytes = 0;
-                local_good = 0;
-                local_bad = 0;
-                local_bit_errors = 0;
+                // Packet handled, continue to next
+                continue;
             }
-
-            // Packet handled, continue to next
-            hdr->tp_status = TP_STATUS_KERNEL;
-            queue->ring_offset = (queue->ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
-            continue;
-        }
 #endif
 
-        // ==========================================
-        // RAW SOCKET SOURCE PACKET HANDLING (from Port 13)
-        // ==========================================
-        int source_idx = -1;
-        for (int s = 0; s < port->rx_source_count; s++) {
-            struct raw_rx_source_state *source = &port->rx_sources[s];
-            if (vl_id >= source->config.vl_id_start &&
-                vl_id < source->config.vl_id_start + source->config.vl_id_count) {
-                source_idx = s;
-                break;
+            // ==========================================
+            // RAW SOCKET SOURCE PACKET HANDLING (from Port 13)
+            // ==========================================
+            int source_idx = -1;
+            for (int s = 0; s < port->rx_source_count; s++) {
+                struct raw_rx_source_state *source = &port->rx_sources[s];
+                if (vl_id >= source->config.vl_id_start &&
+                    vl_id < source->config.vl_id_start + source->config.vl_id_count) {
+                    source_idx = s;
+                    break;
+                }
             }
-        }
 
-        if (source_idx >= 0) {
-            struct raw_rx_source_state *source = &port->rx_sources[source_idx];
-            uint16_t vl_index = vl_id - source->config.vl_id_start;
+            if (source_idx >= 0) {
+                struct raw_rx_source_state *source = &port->rx_sources[source_idx];
+                uint16_t vl_index = vl_id - source->config.vl_id_start;
 
-            // Get sequence number from payload
-            uint8_t *payload = pkt_data + RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE + RAW_PKT_UDP_HDR_SIZE;
-            uint64_t seq;
-            memcpy(&seq, payload, sizeof(seq));
+                // Get sequence number from payload
+                uint8_t *payload = pkt_data + RAW_PKT_ETH_HDR_SIZE + RAW_PKT_IP_HDR_SIZE + RAW_PKT_UDP_HDR_SIZE;
+                uint64_t seq;
+                memcpy(&seq, payload, sizeof(seq));
 
-            pthread_spin_lock(&source->stats.lock);
-            source->stats.rx_packets++;
-            source->stats.rx_bytes += pkt_len;
-            pthread_spin_unlock(&source->stats.lock);
+                struct raw_target_stats *sst = &queue->source_stats[source_idx];
+                raw_stat_add(&sst->rx_packets, 1);
+                raw_stat_add(&sst->rx_bytes, pkt_len);
 
-            // Sequence validation
-            pthread_spin_lock(&source->vl_sequences[vl_index].rx_lock);
+                // Sequence validation (VL-ID hep bu kuyruğa hash'lenir, kilit gerekmez)
 
-            if (!source->vl_sequences[vl_index].rx_initialized) {
-                source->vl_sequences[vl_index].rx_expected_seq = seq + 1;
-                source->vl_sequences[vl_index].rx_initialized = true;
-            } else {
-                uint64_t expected = source->vl_sequences[vl_index].rx_expected_seq;
-                if (seq > expected) {
-                    uint64_t gap = seq - expected;
-                    pthread_spin_lock(&source->stats.lock);
-                    source->stats.lost_pkts += gap;
-                    pthread_spin_unlock(&source->stats.lock);
+                if (!source->vl_sequences[vl_index].rx_initialized) {
+                    source->vl_sequences[vl_index].rx_expected_seq = seq + 1;
+                    source->vl_sequences[vl_index].rx_initialized = true;
+                } else {
+                    uint64_t expected = source->vl_sequences[vl_index].rx_expected_seq;
+                    if (seq > expected) {
+                        raw_stat_add(&sst->lost_pkts, seq - expected);
+                    }
+                    source->vl_sequences[vl_index].rx_expected_seq = seq + 1;
                 }
-                source->vl_sequences[vl_index].rx_expected_seq = seq + 1;
-            }
-
-            pthread_spin_unlock(&source->vl_sequences[vl_index].rx_lock);
 
-            // PRBS verification - find partner port
-            struct raw_socket_port *partner = NULL;
-            uint16_t partner_port_id = source->config.source_port;
-            for (int i = 0; i < MAX_RAW_SOCKET_PORTS; i++) {
-                if (raw_ports[i].port_id == partner_port_id) {
-                    partner = &raw_ports[i];
-                    break;
+                // PRBS verification - find partner port
+                struct raw_socket_port *partner = NULL;
+                uint16_t partner_port_id = source->config.source_port;
+                for (int i = 0; i < raw_port_count; i++) {
+                    if (raw_ports[i]->port_id == partner_port_id) {
+                        partner = raw_ports[i];
+                        break;
+                    }
                 }
-            }
-
-            if (partner && partner->prbs_initialized && partner->prbs_cache_ext) {
-                uint8_t *recv_prbs = payload + RAW_PKT_SEQ_BYTES;
-#if IMIX_ENABLED
-                // IMIX: PRBS offset hesabı HEP MAX boyut ile yapılır
-                uint64_t prbs_offset = (seq * (uint64_t)RAW_MAX_PRBS_BYTES) % RAW_PRBS_CACHE_SIZE;
-#else
-                uint64_t prbs_offset = (seq * (uint64_t)RAW_PKT_PRBS_BYTES) % RAW_PRBS_CACHE_SIZE;
-#endif
-                uint8_t *expected_prbs = partner->prbs_cache_ext + prbs_offset;
 
-                uint16_t cmp_bytes = pkt_len - RAW_PKT_ETH_HDR_SIZE - RAW_PKT_IP_HDR_SIZE -
-                                     RAW_PKT_UDP_HDR_SIZE - RAW_PKT_SEQ_BYTES;
-                if (cmp_bytes > RAW_MAX_PRBS_BYTES) cmp_bytes = RAW_MAX_PRBS_BYTES;
-
-                pthread_spin_lock(&source->stats.lock);
-                if (memcmp(recv_prbs, expected_prbs, cmp_bytes) == 0) {
-                    source->stats.good_pkts++;
-                } else {
-                    source->stats.bad_pkts++;
-                    for (int b = 0; b < cmp_bytes; b++) {
-                        uint8_t diff = recv_prbs[b] ^ expected_prbs[b];
-                        source->stats.bit_errors += __builtin_popcount(diff);
+                if (partner && partner->prbs_initialized && partner->prbs_cache_ext) {
+                    // IMIX: boyut paketten, offset hep RAW_PKT_PRBS_BYTES ile
+                    uint64_t bit_err = pkt_payload_verify(payload + RAW_PKT_SEQ_BYTES,
+                                                          pkt_len - RAW_PKT_HDR_SIZE - RAW_PKT_SEQ_BYTES, seq,
+                                                          partner->prbs_cache_ext, RAW_PKT_PRBS_BYTES);
+                    if (bit_err == 0) {
+                        raw_stat_add(&sst->good_pkts, 1);
+                    } else {
+                        raw_stat_add(&sst->bad_pkts, 1);
+                        raw_stat_add(&sst->bit_errors, bit_err);
                     }
+                } else {
+                    raw_stat_add(&sst->good_pkts, 1);
                 }
-                pthread_spin_unlock(&source->stats.lock);
-            } else {
-                pthread_spin_lock(&source->stats.lock);
-                source->stats.good_pkts++;
-                pthread_spin_unlock(&source->stats.lock);
             }
         }
 
-        hdr->tp_status = TP_STATUS_KERNEL;
-        queue->ring_offset = (queue->ring_offset + 1) % RAW_SOCKET_RING_FRAME_NR;
+        pkt_io_rx_free(&queue->io, bufs, nb_rx);
     }
 
     // Final stats flush
     if (local_rx_pkts > 0) {
-        pthread_spin_lock(&port->dpdk_ext_rx_stats.lock);
-        port->dpdk_ext_rx_stats.rx_packets += local_rx_pkts;
-        port->dpdk_ext_rx_stats.rx_bytes += local_rx_bytes;
-        port->dpdk_ext_rx_stats.good_pkts += local_good;
-        port->dpdk_ext_rx_stats.bad_pkts += local_bad;
-        port->dpdk_ext_rx_stats.bit_errors += local_bit_errors;
-        pthread_spin_unlock(&port->dpdk_ext_rx_stats.lock);
+        raw_stats_flush_rx(&queue->dpdk_ext_stats, local_rx_pkts, local_rx_bytes,
+                           local_good, local_bad, local_bit_errors, 0);
 
         queue->rx_packets += local_rx_pkts;
         queue->rx_bytes += local_rx_bytes;
@@ -1925,6 +2469,7 @@ void *multi_queue_rx_worker(void *arg)
         queue->bad_pkts += local_bad;
         queue->bit_errors += local_bit_errors;
     }
+    raw_rx_collect_kernel_drops(queue);
 
     printf("[Port %u Q%d RX Worker] Stopped (pkts=%lu, good=%lu, bad=%lu)\n",
            port->port_id, queue->queue_id, queue->rx_packets,
@@ -1945,13 +2490,9 @@ int start_multi_queue_rx_workers(struct raw_socket_port *port, volatile bool *st
     for (int q = 0; q < port->rx_queue_count; q++) {
         struct raw_rx_queue *queue = &port->rx_queues[q];
         queue->stop_flag = &port->stop_flag;
+        queue->port = port;
 
-        // Setup worker argument
-        mq_worker_args[port->raw_index][q].port = port;
-        mq_worker_args[port->raw_index][q].queue = queue;
-
-        if (pthread_create(&queue->thread, NULL, multi_queue_rx_worker,
-                           &mq_worker_args[port->raw_index][q]) != 0) {
+        if (pthread_create(&queue->thread, NULL, multi_queue_rx_worker, queue) != 0) {
             fprintf(stderr, "[Port %u Q%d] Failed to create RX thread: %s\n",
                     port->port_id, q, strerror(errno));
             return -1;
@@ -1985,6 +2526,11 @@ void stop_multi_queue_rx_workers(struct raw_socket_port *port)
         if (queue->running) {
             pthread_join(queue->thread, NULL);
         }
+    }
+    teardown_xdp_queues(port);
+
+    for (int q = 0; q < port->rx_queue_count; q++) {
+        struct raw_rx_queue *queue = &port->rx_queues[q];
         // Cleanup
         if (queue->ring && queue->ring != MAP_FAILED) {
             munmap(queue->ring, queue->ring_size);
@@ -2011,21 +2557,21 @@ int start_raw_socket_workers(volatile bool *stop_flag)
     g_stop_flag = stop_flag;
 
     // Start RX workers
-    for (int i = 0; i < MAX_RAW_SOCKET_PORTS; i++) {
-        raw_ports[i].stop_flag = false;
+    for (int i = 0; i < raw_port_count; i++) {
+        raw_ports[i]->stop_flag = false;
 
         // Port 12 (index 0): Use multi-queue RX for high throughput DPDK external packets
         // Port 13 (index 1): Use legacy single-thread RX (lower throughput)
-        if (raw_ports[i].use_multi_queue_rx) {
+        if (raw_ports[i]->use_multi_queue_rx) {
             // Multi-queue RX for Port 12 and Port 13
-            if (start_multi_queue_rx_workers(&raw_ports[i], stop_flag) != 0) {
-                fprintf(stderr, "[Port %u] Failed to start multi-queue RX workers\n", raw_ports[i].port_id);
+            if (start_multi_queue_rx_workers(raw_ports[i], stop_flag) != 0) {
+                fprintf(stderr, "[Port %u] Failed to start multi-queue RX workers\n", raw_ports[i]->port_id);
                 return -1;
             }
         } else {
             // Legacy single-thread RX (fallback)
-            if (pthread_create(&raw_ports[i].rx_thread, NULL, raw_rx_worker, &raw_ports[i]) != 0) {
-                fprintf(stderr, "[Port %u] Failed to create RX thread\n", raw_ports[i].port_id);
+            if (pthread_create(&raw_ports[i]->rx_thread, NULL, raw_rx_worker, raw_ports[i]) != 0) {
+                fprintf(stderr, "[Port %u] Failed to create RX thread\n", raw_ports[i]->port_id);
                 return -1;
             }
         }
@@ -2033,11 +2579,20 @@ int start_raw_socket_workers(volatile bool *stop_flag)
 
     usleep(100000);  // 100ms
 
-    // Start TX workers
-    for (int i = 0; i < MAX_RAW_SOCKET_PORTS; i++) {
-        if (pthread_create(&raw_ports[i].tx_thread, NULL, raw_tx_worker, &raw_ports[i]) != 0) {
-            fprintf(stderr, "[Port %u] Failed to create TX thread\n", raw_ports[i].port_id);
-            return -1;
+    // Start TX workers (lane başına bir thread)
+    for (int i = 0; i < raw_port_count; i++) {
+        for (int l = 0; l < raw_ports[i]->tx_lane_count; l++) {
+            struct raw_tx_lane *lane = &raw_ports[i]->tx_lanes[l];
+            if (pthread_create(&lane->thread, NULL, raw_tx_worker, lane) != 0) {
+                fprintf(stderr, "[Port %u L%d] Failed to create TX thread\n",
+                        raw_ports[i]->port_id, l);
+                return -1;
+            }
+            lane->running = true;   // join edilecek thread var
+            if (lane->cpu_core > 0 && set_thread_cpu_affinity(lane->thread, lane->cpu_core) == 0) {
+                printf("  [Port %u] TX lane %d pinned to CPU core %u\n",
+                       raw_ports[i]->port_id, l, lane->cpu_core);
+            }
         }
     }
 
@@ -2050,23 +2605,26 @@ void stop_raw_socket_workers(void)
     printf("\n=== Stopping Raw Socket Workers ===\n");
 
     // Signal all ports to stop
-    for (int i = 0; i < MAX_RAW_SOCKET_PORTS; i++) {
-        raw_ports[i].stop_flag = true;
+    for (int i = 0; i < raw_port_count; i++) {
+        raw_ports[i]->stop_flag = true;
     }
 
     // Wait for all workers to finish
-    for (int i = 0; i < MAX_RAW_SOCKET_PORTS; i++) {
-        // Stop TX thread
-        if (raw_ports[i].tx_running) {
-            pthread_join(raw_ports[i].tx_thread, NULL);
+    for (int i = 0; i < raw_port_count; i++) {
+        // Stop TX lane threads
+        for (int l = 0; l < raw_ports[i]->tx_lane_count; l++) {
+            if (raw_ports[i]->tx_lanes[l].running) {
+                pthread_join(raw_ports[i]->tx_lanes[l].thread, NULL);
+                raw_ports[i]->tx_lanes[l].running = false;
+            }
         }
 
         // Stop RX - multi-queue or legacy
-        if (raw_ports[i].use_multi_queue_rx) {
-            stop_multi_queue_rx_workers(&raw_ports[i]);
+        if (raw_ports[i]->use_multi_queue_rx) {
+            stop_multi_queue_rx_workers(raw_ports[i]);
         } else {
-            if (raw_ports[i].rx_running) {
-                pthread_join(raw_ports[i].rx_thread, NULL);
+            if (raw_ports[i]->rx_running) {
+                pthread_join(raw_ports[i]->rx_thread, NULL);
             }
         }
     }
@@ -2078,12 +2636,180 @@ void stop_raw_socket_workers(void)
 // STATISTICS
 // ==========================================
 
-static uint64_t prev_tx_bytes[MAX_RAW_SOCKET_PORTS][MAX_RAW_TARGETS] = {{0}};
-static uint64_t prev_rx_bytes[MAX_RAW_SOCKET_PORTS][MAX_RAW_TARGETS] = {{0}};
 static uint64_t prev_dpdk_ext_rx_bytes_p12 = 0;  // Port 12 DPDK RX tracking
 static uint64_t prev_dpdk_ext_rx_bytes_p13 = 0;  // Port 13 DPDK RX tracking
 static uint64_t last_stats_time_ns = 0;
 
+// Tek yazarlı bloğu okuyucu tarafında topla
+static void raw_stats_accumulate(struct raw_target_stats *sum, const struct raw_target_stats *blk)
+{
+    sum->tx_packets += raw_stat_read(&blk->tx_packets);
+    sum->tx_bytes += raw_stat_read(&blk->tx_bytes);
+    sum->tx_errors += raw_stat_read(&blk->tx_errors);
+    sum->rx_packets += raw_stat_read(&blk->rx_packets);
+    sum->rx_bytes += raw_stat_read(&blk->rx_bytes);
+    sum->good_pkts += raw_stat_read(&blk->good_pkts);
+    sum->bad_pkts += raw_stat_read(&blk->bad_pkts);
+    sum->bit_errors += raw_stat_read(&blk->bit_errors);
+    sum->lost_pkts += raw_stat_read(&blk->lost_pkts);
+    sum->out_of_order_pkts += raw_stat_read(&blk->out_of_order_pkts);
+    sum->duplicate_pkts += raw_stat_read(&blk->duplicate_pkts);
+}
+
+static void raw_stats_subtract(struct raw_target_stats *sum, const struct raw_target_stats *base)
+{
+    sum->tx_packets -= base->tx_packets;
+    sum->tx_bytes -= base->tx_bytes;
+    sum->tx_errors -= base->tx_errors;
+    sum->rx_packets -= base->rx_packets;
+    sum->rx_bytes -= base->rx_bytes;
+    sum->good_pkts -= base->good_pkts;
+    sum->bad_pkts -= base->bad_pkts;
+    sum->bit_errors -= base->bit_errors;
+    sum->lost_pkts -= base->lost_pkts;
+    sum->out_of_order_pkts -= base->out_of_order_pkts;
+    sum->duplicate_pkts -= base->duplicate_pkts;
+}
+
+// Target toplamı (reset tabanı hariç)
+static void raw_target_stats_collect(struct raw_tx_target_state *target,
+                                     struct raw_target_stats *out, bool raw)
+{
+    memset(out, 0, sizeof(*out));
+    raw_stats_accumulate(out, &target->stats);
+    if (!raw)
+        raw_stats_subtract(out, &target->stats_base);
+}
+
+// Kaynak toplamı: legacy RX thread'i + tüm RX kuyrukları
+static void raw_source_stats_collect(struct raw_socket_port *port, int s,
+                                     struct raw_target_stats *out, bool raw)
+{
+    memset(out, 0, sizeof(*out));
+    raw_stats_accumulate(out, &port->rx_sources[s].stats);
+    for (int q = 0; q < port->rx_queue_count; q++)
+        raw_stats_accumulate(out, &port->rx_queues[q].source_stats[s]);
+    if (!raw)
+        raw_stats_subtract(out, &port->rx_sources[s].stats_base);
+}
+
+// DPDK external RX toplamı: legacy RX thread'i + tüm RX kuyrukları
+static void raw_dpdk_ext_stats_collect(struct raw_socket_port *port,
+                                       struct raw_target_stats *out, bool raw)
+{
+    memset(out, 0, sizeof(*out));
+    raw_stats_accumulate(out, &port->dpdk_ext_rx_stats);
+    for (int q = 0; q < port->rx_queue_count; q++)
+        raw_stats_accumulate(out, &port->rx_queues[q].dpdk_ext_stats);
+    if (!raw)
+        raw_stats_subtract(out, &port->dpdk_ext_rx_base);
+}
+
+// TX hedefinin karşı porttaki RX kaynağı (source_port + VL-ID başlangıcı eşleşir)
+static void raw_target_rx_collect(struct raw_socket_port *port,
+                                  struct raw_tx_target_state *target,
+                                  struct raw_target_stats *out)
+{
+    memset(out, 0, sizeof(*out));
+    for (int dp = 0; dp < raw_port_count; dp++) {
+        if (raw_ports[dp]->port_id != target->config.dest_port)
+            continue;
+        for (int s = 0; s < raw_ports[dp]->rx_source_count; s++) {
+            if (raw_ports[dp]->rx_sources[s].config.source_port == port->port_id &&
+                raw_ports[dp]->rx_sources[s].config.vl_id_start == target->config.vl_id_start) {
+                raw_source_stats_collect(raw_ports[dp], s, out, false);
+                return;
+            }
+        }
+        return;
+    }
+}
+
+// Port toplamı (backend throughput): TX target'ları + RX kaynakları + DPDK external RX
+static void raw_port_totals_collect(struct raw_socket_port *port, struct raw_target_stats *out)
+{
+    struct raw_target_stats blk;
+
+    memset(out, 0, sizeof(*out));
+    for (int t = 0; t < port->tx_target_count; t++) {
+        raw_target_stats_collect(&port->tx_targets[t], &blk, false);
+        out->tx_packets += blk.tx_packets;
+        out->tx_bytes += blk.tx_bytes;
+    }
+    for (int s = 0; s < port->rx_source_count; s++) {
+        raw_source_stats_collect(port, s, &blk, false);
+        out->rx_packets += blk.rx_packets;
+        out->rx_bytes += blk.rx_bytes;
+    }
+    raw_dpdk_ext_stats_collect(port, &blk, false);
+    out->rx_packets += blk.rx_packets;
+    out->rx_bytes += blk.rx_bytes;
+}
+
+// Port başına backend'in interval ve ortalama pps/Mbps'i. PACKET_MMAP ile
+// AF_XDP karşılaştırması: aynı trafikle iki backend ayrı çalıştırılır
+// (RAW_SOCKET_PORT_x_BACKEND, veth'te generic XDP), "avg" satırları kıyaslanır
+static void raw_print_backend_throughput(uint64_t now_ns, double elapsed_sec)
+{
+    printf("  Backend throughput (interval | avg since start/reset):\n");
+    for (int p = 0; p < raw_port_count; p++) {
+        struct raw_socket_port *port = raw_ports[p];
+        struct raw_target_stats cur;
+        raw_port_totals_collect(port, &cur);
+
+        if (port->backend_start_ns == 0) {
+            port->backend_start_ns = now_ns;
+            memset(&port->backend_prev, 0, sizeof(port->backend_prev));
+        }
+        double avg_sec = (double)(now_ns - port->backend_start_ns) / 1000000000.0;
+        if (avg_sec < 0.1)
+            avg_sec = elapsed_sec;
+
+        const struct raw_target_stats *prev = &port->backend_prev;
+        printf("    P%-3u %-22s TX %9.0f pps %8.2f Mbps  RX %9.0f pps %8.2f Mbps"
+               " | TX %9.0f pps %8.2f Mbps  RX %9.0f pps %8.2f Mbps\n",
+               port->port_id, raw_port_backend_name(port),
+               (double)(cur.tx_packets - prev->tx_packets) / elapsed_sec,
+               (double)(cur.tx_bytes - prev->tx_bytes) * 8.0 / (elapsed_sec * 1000000.0),
+               (double)(cur.rx_packets - prev->rx_packets) / elapsed_sec,
+               (double)(cur.rx_bytes - prev->rx_bytes) * 8.0 / (elapsed_sec * 1000000.0),
+               (double)cur.tx_packets / avg_sec,
+               (double)cur.tx_bytes * 8.0 / (avg_sec * 1000000.0),
+               (double)cur.rx_packets / avg_sec,
+               (double)cur.rx_bytes * 8.0 / (avg_sec * 1000000.0));
+        port->backend_prev = cur;
+    }
+}
+
+int raw_socket_stats_snapshot(struct stats_raw_snapshot *out, int max)
+{
+    int n = 0;
+
+    for (int p = 0; p < raw_port_count && n < max; p++) {
+        struct raw_socket_port *port = raw_ports[p];
+        for (int t = 0; t < port->tx_target_count && n < max; t++) {
+            struct raw_tx_target_state *target = &port->tx_targets[t];
+            struct raw_target_stats tx, rx;
+            raw_target_stats_collect(target, &tx, false);
+            raw_target_rx_collect(port, target, &rx);
+
+            struct stats_raw_snapshot *r = &out[n++];
+            memset(r, 0, sizeof(*r));
+            r->src_port = port->port_id;
+            r->dst_port = target->config.dest_port;
+            r->rate_mbps = target->config.rate_mbps;
+            r->tx_pkts = tx.tx_packets;
+            r->tx_bytes = tx.tx_bytes;
+            r->rx_pkts = rx.rx_packets;
+            r->good_pkts = rx.good_pkts;
+            r->bad_pkts = rx.bad_pkts;
+            r->lost_pkts = rx.lost_pkts;
+            r->bit_errors = rx.bit_errors;
+        }
+    }
+    return n;
+}
+
 void print_raw_socket_stats(void)
 {
     uint64_t now_ns = get_time_ns();
@@ -2101,42 +2827,25 @@ void print_raw_socket_stats(void)
     printf("║    Source    ║    Target    ║      Rate      ║       TX Pkts       ║    TX Mbps     ║       RX Pkts       ║        Good         ║         Bad         ║        Lost         ║     Bit Errors      ║           BER           ║\n");
     printf("╠══════════════╬══════════════╬════════════════╬═════════════════════╬════════════════╬═════════════════════╬═════════════════════╬═════════════════════╬═════════════════════╬═════════════════════╬═════════════════════════╣\n");
 
-    for (int p = 0; p < MAX_RAW_SOCKET_PORTS; p++) {
-        struct raw_socket_port *port = &raw_ports[p];
+    for (int p = 0; p < raw_port_count; p++) {
+        struct raw_socket_port *port = raw_ports[p];
 
         // Print TX targets
         for (int t = 0; t < port->tx_target_count; t++) {
             struct raw_tx_target_state *target = &port->tx_targets[t];
 
-            pthread_spin_lock(&target->stats.lock);
+            struct raw_target_stats tx;
+            raw_target_stats_collect(target, &tx, false);
 
-            uint64_t tx_bytes_delta = target->stats.tx_bytes - prev_tx_bytes[p][t];
+            uint64_t tx_bytes_delta = tx.tx_bytes - target->prev_tx_bytes;
             double tx_mbps = (tx_bytes_delta * 8.0) / (elapsed_sec * 1000000.0);
-            prev_tx_bytes[p][t] = target->stats.tx_bytes;
+            target->prev_tx_bytes = tx.tx_bytes;
 
             // Find corresponding RX stats from the destination port
-            uint64_t rx_pkts = 0, good = 0, bad = 0, lost = 0, bit_err = 0;
-
-            // Look for RX source in the destination port
-            for (int dp = 0; dp < MAX_RAW_SOCKET_PORTS; dp++) {
-                if (raw_ports[dp].port_id == target->config.dest_port) {
-                    for (int s = 0; s < raw_ports[dp].rx_source_count; s++) {
-                        if (raw_ports[dp].rx_sources[s].config.source_port == port->port_id &&
-                            raw_ports[dp].rx_sources[s].config.vl_id_start == target->config.vl_id_start) {
-                            struct raw_rx_source_state *src = &raw_ports[dp].rx_sources[s];
-                            pthread_spin_lock(&src->stats.lock);
-                            rx_pkts = src->stats.rx_packets;
-                            good = src->stats.good_pkts;
-                            bad = src->stats.bad_pkts;
-                            lost = src->stats.lost_pkts;
-                            bit_err = src->stats.bit_errors;
-                            pthread_spin_unlock(&src->stats.lock);
-                            break;
-                        }
-                    }
-                    break;
-                }
-            }
+            struct raw_target_stats rx;
+            raw_target_rx_collect(port, target, &rx);
+            uint64_t rx_pkts = rx.rx_packets, good = rx.good_pkts, bad = rx.bad_pkts;
+            uint64_t lost = rx.lost_pkts, bit_err = rx.bit_errors;
 
             // Calculate BER for this target
             double target_ber = 0.0;
@@ -2147,26 +2856,26 @@ void print_raw_socket_stats(void)
 
             printf("║     P%-3u     ║     P%-3u     ║    %3u Mbps    ║ %19lu ║ %14.2f ║ %19lu ║ %19lu ║ %19lu ║ %19lu ║ %19lu ║ %23.2e ║\n",
                    port->port_id, target->config.dest_port, target->config.rate_mbps,
-                   target->stats.tx_packets, tx_mbps,
+                   tx.tx_packets, tx_mbps,
                    rx_pkts, good, bad, lost, bit_err, target_ber);
-
-            pthread_spin_unlock(&target->stats.lock);
         }
     }
 
     printf("╚══════════════╩══════════════╩════════════════╩═════════════════════╩════════════════╩═════════════════════╩═════════════════════╩═════════════════════╩═════════════════════╩═════════════════════╩═════════════════════════╝\n");
 
+    raw_print_backend_throughput(now_ns, elapsed_sec);
+
     // Show DPDK External RX stats for Port 12
 #if DPDK_EXT_TX_ENABLED
-    struct raw_socket_port *port12 = &raw_ports[0]; // Port 12 is index 0
-    if (port12->port_id == 12) {
-        pthread_spin_lock(&port12->dpdk_ext_rx_stats.lock);
-        uint64_t dpdk_rx = port12->dpdk_ext_rx_stats.rx_packets;
-        uint64_t dpdk_rx_bytes = port12->dpdk_ext_rx_stats.rx_bytes;
-        uint64_t dpdk_good = port12->dpdk_ext_rx_stats.good_pkts;
-        uint64_t dpdk_bad = port12->dpdk_ext_rx_stats.bad_pkts;
-        uint64_t dpdk_bit_err = port12->dpdk_ext_rx_stats.bit_errors;
-        pthread_spin_unlock(&port12->dpdk_ext_rx_stats.lock);
+    struct raw_socket_port *port12 = raw_port_by_id(12);
+    if (port12) {
+        struct raw_target_stats ext;
+        raw_dpdk_ext_stats_collect(port12, &ext, false);
+        uint64_t dpdk_rx = ext.rx_packets;
+        uint64_t dpdk_rx_bytes = ext.rx_bytes;
+        uint64_t dpdk_good = ext.good_pkts;
+        uint64_t dpdk_bad = ext.bad_pkts;
+        uint64_t dpdk_bit_err = ext.bit_errors;
 
         // Get lost count from global sequence tracking
         uint64_t dpdk_lost = get_global_sequence_lost();
@@ -2193,7 +2902,8 @@ void print_raw_socket_stats(void)
 
         // Show per-queue statistics if multi-queue is enabled
         if (port12->use_multi_queue_rx && port12->rx_queue_count > 0) {
-            printf("  Multi-Queue RX Stats (Lost is tracked globally across all queues):\n");
+            printf("  Multi-Queue RX Stats [%s] (Lost is tracked globally across all queues):\n",
+                   raw_port_backend_name(port12));
             for (int q = 0; q < port12->rx_queue_count; q++) {
                 struct raw_rx_queue *rq = &port12->rx_queues[q];
                 printf("    Q%d (CPU %2u): RX=%9lu Good=%9lu KDrop=%8lu VL-ID=[%u-%u] (%u unique)\n",
@@ -2208,15 +2918,15 @@ void print_raw_socket_stats(void)
     }
 
     // Port 13 DPDK External RX Stats (from Port 0,6)
-    struct raw_socket_port *port13 = &raw_ports[1]; // Port 13 is index 1
-    if (port13->port_id == 13) {
-        pthread_spin_lock(&port13->dpdk_ext_rx_stats.lock);
-        uint64_t dpdk_rx_p13 = port13->dpdk_ext_rx_stats.rx_packets;
-        uint64_t dpdk_rx_bytes_p13 = port13->dpdk_ext_rx_stats.rx_bytes;
-        uint64_t dpdk_good_p13 = port13->dpdk_ext_rx_stats.good_pkts;
-        uint64_t dpdk_bad_p13 = port13->dpdk_ext_rx_stats.bad_pkts;
-        uint64_t dpdk_bit_err_p13 = port13->dpdk_ext_rx_stats.bit_errors;
-        pthread_spin_unlock(&port13->dpdk_ext_rx_stats.lock);
+    struct raw_socket_port *port13 = raw_port_by_id(13);
+    if (port13) {
+        struct raw_target_stats ext_p13;
+        raw_dpdk_ext_stats_collect(port13, &ext_p13, false);
+        uint64_t dpdk_rx_p13 = ext_p13.rx_packets;
+        uint64_t dpdk_rx_bytes_p13 = ext_p13.rx_bytes;
+        uint64_t dpdk_good_p13 = ext_p13.good_pkts;
+        uint64_t dpdk_bad_p13 = ext_p13.bad_pkts;
+        uint64_t dpdk_bit_err_p13 = ext_p13.bit_errors;
         // Get lost from global sequence tracking (not from stats struct)
         uint64_t dpdk_lost_p13 = get_global_sequence_lost_p13();
 
@@ -2242,7 +2952,7 @@ void print_raw_socket_stats(void)
 
         // Show per-queue statistics if multi-queue is enabled for Port 13
         if (port13->use_multi_queue_rx && port13->rx_queue_count > 0) {
-            printf("  Multi-Queue RX Stats:\n");
+            printf("  Multi-Queue RX Stats [%s]:\n", raw_port_backend_name(port13));
             for (int q = 0; q < port13->rx_queue_count; q++) {
                 struct raw_rx_queue *rq = &port13->rx_queues[q];
                 printf("    Q%d (CPU %2u): RX=%9lu Good=%9lu KDrop=%8lu VL-ID=[%u-%u] (%u unique)\n",
@@ -2258,30 +2968,24 @@ void print_raw_socket_stats(void)
 
 void reset_raw_socket_stats(void)
 {
-    for (int p = 0; p < MAX_RAW_SOCKET_PORTS; p++) {
-        struct raw_socket_port *port = &raw_ports[p];
+    for (int p = 0; p < raw_port_count; p++) {
+        struct raw_socket_port *port = raw_ports[p];
 
+        // Worker blokları yazılmaz: o anki toplamlar taban olarak alınır
         for (int t = 0; t < port->tx_target_count; t++) {
-            pthread_spin_lock(&port->tx_targets[t].stats.lock);
-            memset(&port->tx_targets[t].stats, 0, sizeof(struct raw_target_stats));
-            pthread_spin_init(&port->tx_targets[t].stats.lock, PTHREAD_PROCESS_PRIVATE);
-            pthread_spin_unlock(&port->tx_targets[t].stats.lock);
-            prev_tx_bytes[p][t] = 0;
+            raw_target_stats_collect(&port->tx_targets[t], &port->tx_targets[t].stats_base, true);
+            port->tx_targets[t].prev_tx_bytes = 0;
         }
 
         for (int s = 0; s < port->rx_source_count; s++) {
-            pthread_spin_lock(&port->rx_sources[s].stats.lock);
-            memset(&port->rx_sources[s].stats, 0, sizeof(struct raw_target_stats));
-            pthread_spin_init(&port->rx_sources[s].stats.lock, PTHREAD_PROCESS_PRIVATE);
-            pthread_spin_unlock(&port->rx_sources[s].stats.lock);
-            prev_rx_bytes[p][s] = 0;
+            raw_source_stats_collect(port, s, &port->rx_sources[s].stats_base, true);
         }
 
         // Reset DPDK external RX stats
-        pthread_spin_lock(&port->dpdk_ext_rx_stats.lock);
-        memset(&port->dpdk_ext_rx_stats, 0, sizeof(struct raw_target_stats));
-        pthread_spin_init(&port->dpdk_ext_rx_stats.lock, PTHREAD_PROCESS_PRIVATE);
-        pthread_spin_unlock(&port->dpdk_ext_rx_stats.lock);
+        raw_dpdk_ext_stats_collect(port, &port->dpdk_ext_rx_base, true);
+
+        // Backend ortalaması sonraki baskıda yeniden başlar
+        port->backend_start_ns = 0;
     }
     prev_dpdk_ext_rx_bytes_p12 = 0;
     prev_dpdk_ext_rx_bytes_p13 = 0;
@@ -2300,17 +3004,15 @@ void cleanup_raw_socket_ports(void)
 {
     printf("\n=== Cleaning up Raw Socket Ports ===\n");
 
-    for (int i = 0; i < MAX_RAW_SOCKET_PORTS; i++) {
-        struct raw_socket_port *port = &raw_ports[i];
+    for (int i = 0; i < raw_port_count; i++) {
+        struct raw_socket_port *port = raw_ports[i];
 
         port->stop_flag = true;
 
-        if (port->tx_ring && port->tx_ring != MAP_FAILED) {
-            munmap(port->tx_ring, port->tx_ring_size);
-        }
-        if (port->tx_socket >= 0) close(port->tx_socket);
+        raw_tx_lanes_close(port);
 
         // Cleanup RX - multi-queue or legacy
+        teardown_xdp_queues(port);
         if (port->use_multi_queue_rx) {
             // Multi-queue cleanup (rings and sockets already closed by stop_multi_queue_rx_workers)
             for (int q = 0; q < port->rx_queue_count; q++) {
@@ -2323,7 +3025,10 @@ void cleanup_raw_socket_ports(void)
                     close(queue->socket_fd);
                     queue->socket_fd = -1;
                 }
+                free(queue->vl_track);
+                queue->vl_track = NULL;
             }
+            port->vl_steered = false;
         } else {
             // Legacy single-queue cleanup
             if (port->rx_ring && port->rx_ring != MAP_FAILED) {
@@ -2336,32 +3041,25 @@ void cleanup_raw_socket_ports(void)
         if (port->prbs_cache_ext) free(port->prbs_cache_ext);
 
         for (int t = 0; t < port->tx_target_count; t++) {
-            if (port->tx_targets[t].vl_sequences) {
-                for (uint16_t v = 0; v < port->tx_targets[t].config.vl_id_count; v++) {
-                    pthread_spin_destroy(&port->tx_targets[t].vl_sequences[v].tx_lock);
-                    pthread_spin_destroy(&port->tx_targets[t].vl_sequences[v].rx_lock);
-                }
-                free(port->tx_targets[t].vl_sequences);
-            }
-            pthread_spin_destroy(&port->tx_targets[t].stats.lock);
+            free(port->tx_targets[t].vl_sequences);
+            free(port->tx_targets[t].hdr_templates);
         }
 
         for (int s = 0; s < port->rx_source_count; s++) {
-            if (port->rx_sources[s].vl_sequences) {
-                for (uint16_t v = 0; v < port->rx_sources[s].config.vl_id_count; v++) {
-                    pthread_spin_destroy(&port->rx_sources[s].vl_sequences[v].tx_lock);
-                    pthread_spin_destroy(&port->rx_sources[s].vl_sequences[v].rx_lock);
-                }
-                free(port->rx_sources[s].vl_sequences);
-            }
-            pthread_spin_destroy(&port->rx_sources[s].stats.lock);
+            free(port->rx_sources[s].vl_sequences);
         }
 
-        // Cleanup DPDK external RX stats
-        pthread_spin_destroy(&port->dpdk_ext_rx_stats.lock);
-
         printf("[Raw Port %d] Cleanup complete\n", port->port_id);
     }
 
+    for (int i = 0; i < raw_port_count; i++)
+        rte_free(raw_ports[i]);
+    free(raw_ports);
+    raw_ports = NULL;
+    raw_port_count = 0;
+
+    // IRQ/RPS/XPS ve busy_poll sysctl eski haline
+    raw_tune_restore();
+
     printf("=== Raw Socket Ports Cleanup Complete ===\n");
 }
\ No newline at end of file
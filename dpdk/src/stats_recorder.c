@@ -0,0 +1,436 @@
+#include "stats_recorder.h"
+#include "tx_rx_manager.h"      // port_vl_trackers, port_vlans, VL_RANGE_SIZE_PER_QUEUE
+#include "latency_monitor.h"    // latency_monitor_vlans (VLAN gecikme interval'i)
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stddef.h>
+#include <sys/mman.h>
+#include <rte_common.h>
+
+#if STATS_RECORDER_ENABLED
+
+// Kolon değerinin kaynağı (stats_rec_column ile aynı sırada)
+enum rec_src {
+    REC_SRC_FIXED,      // Zaman / generation / faz: append içinde doğrudan yazılır
+    REC_SRC_PORT,       // &s->ports[slot] + field
+    REC_SRC_RAW,        // &s->raw[slot] + field
+    REC_SRC_VL,         // port_vl_trackers[port]->vl_trackers[index].pkt_count farkı
+    REC_SRC_MON,        // &latency_monitor_vlans[slot].point + field
+};
+
+struct rec_col_src {
+    uint8_t  src;
+    uint16_t slot;
+    uint32_t field;     // offsetof
+    uint64_t prev;      // REC_SRC_VL: önceki kümülatif değer
+};
+
+// Sabit kolonlar: ilk eklenen 8 byte'lık üç kolon kaydın başına düşer
+#define REC_OFF_T_NS        0
+#define REC_OFF_GENERATION  8
+#define REC_OFF_INTERVAL    16
+
+static struct {
+    int fd;
+    uint8_t *map;
+    size_t map_size;
+    uint64_t capacity;              // Haritadaki kayıt kapasitesi
+    uint64_t nb_records;            // Başlıktaki nb_records'un kopyası (map'siz de geçerli)
+    uint32_t header_size;
+    uint32_t record_size;
+    uint32_t off_warmup;            // u32 warmup_complete
+    uint32_t off_test_time;         // u32 test_time
+
+    struct stats_rec_column *cols;  // Başlıktaki şemanın kopyası
+    struct rec_col_src *srcs;
+    uint32_t nb_cols;
+    uint32_t cap_cols;
+} rec = { .fd = -1 };
+
+// ==========================================
+// SCHEMA
+// ==========================================
+
+static struct stats_rec_column *col_add(uint8_t type, uint8_t kind, uint8_t scope,
+                                        uint16_t port, uint16_t index,
+                                        struct rec_col_src src, const char *fmt, ...)
+    __attribute__((format(printf, 7, 8)));
+
+static struct stats_rec_column *col_add(uint8_t type, uint8_t kind, uint8_t scope,
+                                        uint16_t port, uint16_t index,
+                                        struct rec_col_src src, const char *fmt, ...)
+{
+    if (rec.nb_cols == rec.cap_cols) {
+        uint32_t cap = rec.cap_cols ? rec.cap_cols * 2 : 256;
+        struct stats_rec_column *c = realloc(rec.cols, cap * sizeof(*c));
+        struct rec_col_src *s = realloc(rec.srcs, cap * sizeof(*s));
+        if (c) rec.cols = c;
+        if (s) rec.srcs = s;
+        if (!c || !s)
+            return NULL;
+        rec.cap_cols = cap;
+    }
+
+    struct stats_rec_column *c = &rec.cols[rec.nb_cols];
+    memset(c, 0, sizeof(*c));
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(c->name, sizeof(c->name), fmt, ap);
+    va_end(ap);
+    c->type = type;
+    c->kind = kind;
+    c->scope = scope;
+    c->port = port;
+    c->index = index;
+    rec.srcs[rec.nb_cols] = src;
+    rec.nb_cols++;
+    return c;
+}
+
+#define PORT_COL(kind_, type_, name_, field_) \
+    ok &= col_add(type_, kind_, STATS_REC_SCOPE_PORT, p->port_id, 0, \
+                  (struct rec_col_src){ REC_SRC_PORT, slot, offsetof(struct stats_port_snapshot, field_), 0 }, \
+                  "port%u." name_, p->port_id) != NULL
+
+#define QUEUE_COL(q_, name_, field_) \
+    ok &= col_add(STATS_REC_U64, STATS_REC_COUNTER, STATS_REC_SCOPE_QUEUE, p->port_id, q_, \
+                  (struct rec_col_src){ REC_SRC_PORT, slot, \
+                                        offsetof(struct stats_port_snapshot, field_) + (q_) * sizeof(uint64_t), 0 }, \
+                  "port%u.q%u." name_, p->port_id, q_) != NULL
+
+#define RAW_COL(kind_, type_, name_, field_) \
+    ok &= col_add(type_, kind_, STATS_REC_SCOPE_RAW, r->src_port, r->dst_port, \
+                  (struct rec_col_src){ REC_SRC_RAW, slot, offsetof(struct stats_raw_snapshot, field_), 0 }, \
+                  "raw%u_%u." name_, r->src_port, r->dst_port) != NULL
+
+#define MON_COL(kind_, type_, name_, field_) \
+    ok &= col_add(type_, kind_, STATS_REC_SCOPE_VL, mv->tx_port, mv->vl_id, \
+                  (struct rec_col_src){ REC_SRC_MON, slot, offsetof(struct latency_monitor_point, field_), 0 }, \
+                  "port%u.vlan%u." name_, mv->tx_port, mv->vlan_id) != NULL
+
+#define FIXED_COL(type_, kind_, name_) \
+    col_add(type_, kind_, STATS_REC_SCOPE_GLOBAL, 0, 0, \
+            (struct rec_col_src){ REC_SRC_FIXED, 0, 0, 0 }, name_)
+
+static bool schema_build(const struct stats_snapshot *first)
+{
+    bool ok = true;
+
+    ok &= FIXED_COL(STATS_REC_U64, STATS_REC_COUNTER, "t_ns") != NULL;
+    ok &= FIXED_COL(STATS_REC_U64, STATS_REC_COUNTER, "generation") != NULL;
+    ok &= FIXED_COL(STATS_REC_F64, STATS_REC_DELTA, "interval_sec") != NULL;
+    uint32_t warmup_col = rec.nb_cols;
+    ok &= FIXED_COL(STATS_REC_U32, STATS_REC_COUNTER, "warmup_complete") != NULL;
+    ok &= FIXED_COL(STATS_REC_U32, STATS_REC_COUNTER, "test_time") != NULL;
+
+    for (uint16_t slot = 0; slot < first->nb_ports; slot++) {
+        const struct stats_port_snapshot *p = &first->ports[slot];
+
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "tx_packets", tx_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "tx_bytes", tx_bytes);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "rx_packets", rx_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "rx_bytes", rx_bytes);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "rx_missed", rx_missed);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "rx_errors", rx_errors);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "tx_errors", tx_errors);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "rx_nombuf", rx_nombuf);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "good", good_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "bad", bad_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "lost", lost_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "bit_errors", bit_errors);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "out_of_order", out_of_order_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "duplicate", duplicate_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "short", short_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "external", external_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "ext_tx_packets", ext_tx_pkts);
+        PORT_COL(STATS_REC_COUNTER, STATS_REC_U64, "ext_tx_bytes", ext_tx_bytes);
+        PORT_COL(STATS_REC_GAUGE, STATS_REC_F64, "tx_gbps", tx_gbps);
+        PORT_COL(STATS_REC_GAUGE, STATS_REC_F64, "rx_gbps", rx_gbps);
+        PORT_COL(STATS_REC_GAUGE, STATS_REC_F64, "ber", ber);
+
+        // Sadece yapılandırılmış kuyruklar (q_* sayaç dizisi sınırına kadar)
+        struct rte_eth_dev_info dev_info;
+        uint16_t nb_rxq = 0, nb_txq = 0;
+        if (rte_eth_dev_info_get(p->port_id, &dev_info) == 0) {
+            nb_rxq = RTE_MIN(dev_info.nb_rx_queues, (uint16_t)STATS_SERVICE_MAX_QUEUES);
+            nb_txq = RTE_MIN(dev_info.nb_tx_queues, (uint16_t)STATS_SERVICE_MAX_QUEUES);
+        }
+        for (uint16_t q = 0; q < nb_rxq; q++) {
+            QUEUE_COL(q, "rx_packets", q_rx_pkts);
+            QUEUE_COL(q, "rx_bytes", q_rx_bytes);
+            QUEUE_COL(q, "rx_errors", q_rx_errors);
+        }
+        for (uint16_t q = 0; q < nb_txq; q++) {
+            QUEUE_COL(q, "tx_packets", q_tx_pkts);
+            QUEUE_COL(q, "tx_bytes", q_tx_bytes);
+        }
+    }
+
+    for (uint16_t slot = 0; slot < first->nb_raw; slot++) {
+        const struct stats_raw_snapshot *r = &first->raw[slot];
+
+        RAW_COL(STATS_REC_COUNTER, STATS_REC_U64, "tx_packets", tx_pkts);
+        RAW_COL(STATS_REC_COUNTER, STATS_REC_U64, "tx_bytes", tx_bytes);
+        RAW_COL(STATS_REC_GAUGE, STATS_REC_F64, "tx_mbps", tx_mbps);
+        RAW_COL(STATS_REC_COUNTER, STATS_REC_U64, "rx_packets", rx_pkts);
+        RAW_COL(STATS_REC_COUNTER, STATS_REC_U64, "good", good_pkts);
+        RAW_COL(STATS_REC_COUNTER, STATS_REC_U64, "bad", bad_pkts);
+        RAW_COL(STATS_REC_COUNTER, STATS_REC_U64, "lost", lost_pkts);
+        RAW_COL(STATS_REC_COUNTER, STATS_REC_U64, "bit_errors", bit_errors);
+    }
+
+    // VL başına interval paket sayısı
+#if STATS_RECORDER_PER_VL
+    for (uint16_t slot = 0; slot < first->nb_ports; slot++) {
+        uint16_t port_id = first->ports[slot].port_id;
+        if (port_id >= port_vlans_count || !port_vl_trackers || !port_vl_trackers[port_id])
+            continue;
+
+        const struct port_vlan_config *vc = &port_vlans[port_id];
+        for (uint16_t v = 0; v < vc->rx_vlan_count && v < MAX_RX_VLANS_PER_PORT; v++) {
+            for (uint16_t k = 0; k < VL_RANGE_SIZE_PER_QUEUE; k++) {
+                uint16_t vl = vc->rx_vl_ids[v] + k;
+                if (vl > MAX_VL_ID)
+                    break;
+                uint64_t cur = port_vl_trackers[port_id]->vl_trackers[vl].pkt_count;
+                ok &= col_add(STATS_REC_U32, STATS_REC_DELTA, STATS_REC_SCOPE_VL, port_id, vl,
+                              (struct rec_col_src){ REC_SRC_VL, port_id, 0, cur },
+                              "port%u.vl%u.rx_pkts", port_id, vl) != NULL;
+            }
+        }
+    }
+#endif
+
+    // Gecikme monitörü: VLAN başına son interval (scope VL: port = TX port, index = probe VL-ID)
+#if LATENCY_MONITOR_ENABLED
+    for (uint16_t slot = 0; slot < latency_monitor_nb_vlans; slot++) {
+        const struct latency_monitor_vlan *mv = &latency_monitor_vlans[slot];
+
+        MON_COL(STATS_REC_GAUGE, STATS_REC_U32, "lat_p50_ns", p50_ns);
+        MON_COL(STATS_REC_GAUGE, STATS_REC_U32, "lat_p99_ns", p99_ns);
+        MON_COL(STATS_REC_GAUGE, STATS_REC_U32, "lat_max_ns", max_ns);
+        MON_COL(STATS_REC_COUNTER, STATS_REC_U64, "lat_samples", samples_total);
+        MON_COL(STATS_REC_COUNTER, STATS_REC_U64, "lat_lost", lost_total);
+        MON_COL(STATS_REC_FLAGS, STATS_REC_U32, "lat_flags", flags);
+        MON_COL(STATS_REC_COUNTER, STATS_REC_U32, "lat_alarms", alarms);
+    }
+#endif
+
+    if (!ok)
+        return false;
+
+    // Ofsetler: önce 8 byte'lık kolonlar (eklenme sırasıyla), sonra 4 byte'lıklar
+    uint32_t nb_wide = 0;
+    for (uint32_t i = 0; i < rec.nb_cols; i++)
+        nb_wide += rec.cols[i].type != STATS_REC_U32;
+    uint32_t off8 = 0, off4 = nb_wide * 8;
+    for (uint32_t i = 0; i < rec.nb_cols; i++) {
+        if (rec.cols[i].type == STATS_REC_U32) {
+            rec.cols[i].offset = off4;
+            off4 += 4;
+        } else {
+            rec.cols[i].offset = off8;
+            off8 += 8;
+        }
+    }
+    rec.off_warmup = rec.cols[warmup_col].offset;
+    rec.off_test_time = rec.cols[warmup_col + 1].offset;
+    rec.record_size = RTE_ALIGN_CEIL(off4, 8);
+    return true;
+}
+
+// ==========================================
+// FILE
+// ==========================================
+
+static int map_grow(uint64_t capacity)
+{
+    size_t size = (size_t)rec.header_size + (size_t)capacity * rec.record_size;
+
+    // Önce dosyayı büyütüp yeni boyutu map'le, eskisini ancak sonra bırak:
+    // hata durumunda eski mapping (ve içindeki kayıtlar) geçerli kalır.
+    // Seyrek büyütme: diskte sadece yazılan sayfalar yer kaplar
+    if (ftruncate(rec.fd, (off_t)size) < 0) {
+        printf("Stats recorder: ftruncate(%zu) failed: %s\n", size, strerror(errno));
+        return -1;
+    }
+    void *m = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, rec.fd, 0);
+    if (m == MAP_FAILED) {
+        printf("Stats recorder: mmap(%zu) failed: %s\n", size, strerror(errno));
+        return -1;
+    }
+    if (rec.map)
+        munmap(rec.map, rec.map_size);
+    rec.map = m;
+    rec.map_size = size;
+    rec.capacity = capacity;
+    return 0;
+}
+
+static void recorder_release(void)
+{
+    if (rec.map)
+        munmap(rec.map, rec.map_size);
+    if (rec.fd >= 0)
+        close(rec.fd);
+    free(rec.cols);
+    free(rec.srcs);
+    rec.map = NULL;
+    rec.map_size = 0;
+    rec.fd = -1;
+    rec.cols = NULL;
+    rec.srcs = NULL;
+    rec.nb_cols = rec.cap_cols = 0;
+}
+
+int stats_recorder_open(const struct stats_snapshot *first)
+{
+    if (rec.fd >= 0)
+        return 0;
+
+    if (!schema_build(first)) {
+        printf("Stats recorder: cannot allocate schema\n");
+        recorder_release();
+        return -1;
+    }
+
+    rec.fd = open(STATS_RECORDER_PATH, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (rec.fd < 0) {
+        printf("Stats recorder: cannot open %s: %s\n", STATS_RECORDER_PATH, strerror(errno));
+        recorder_release();
+        return -1;
+    }
+
+    size_t hdr = sizeof(struct stats_rec_file_header) + (size_t)rec.nb_cols * sizeof(struct stats_rec_column);
+    rec.header_size = RTE_ALIGN_CEIL((uint32_t)hdr, STATS_REC_HEADER_ALIGN);
+    if (map_grow(STATS_RECORDER_GROW_RECORDS) < 0) {
+        recorder_release();
+        unlink(STATS_RECORDER_PATH);
+        return -1;
+    }
+
+    struct stats_rec_file_header *h = (struct stats_rec_file_header *)rec.map;
+    memcpy(h->magic, STATS_REC_MAGIC, sizeof(h->magic));
+    h->version = STATS_REC_VERSION;
+    h->header_size = rec.header_size;
+    h->record_size = rec.record_size;
+    h->nb_columns = rec.nb_cols;
+    h->interval_ms = STATS_SERVICE_INTERVAL_MS;
+    h->start_ns = first->t_ns;
+    h->nb_records = 0;
+    rec.nb_records = 0;
+    memcpy(h + 1, rec.cols, (size_t)rec.nb_cols * sizeof(struct stats_rec_column));
+
+    printf("Stats recorder: %s (%u columns, %u bytes/record)\n",
+           STATS_RECORDER_PATH, rec.nb_cols, rec.record_size);
+    return 0;
+}
+
+void stats_recorder_append(const struct stats_snapshot *s)
+{
+    if (rec.fd < 0)
+        return;
+
+    uint64_t n = rec.nb_records;
+    if (n == rec.capacity) {
+        if (map_grow(rec.capacity + STATS_RECORDER_GROW_RECORDS) < 0) {
+            printf("Stats recorder: stopped at %lu records\n", n);
+            stats_recorder_close();
+            return;
+        }
+    }
+    struct stats_rec_file_header *h = (struct stats_rec_file_header *)rec.map;
+
+    uint8_t *r = rec.map + rec.header_size + n * rec.record_size;
+    *(uint64_t *)(r + REC_OFF_T_NS) = s->t_ns;
+    *(uint64_t *)(r + REC_OFF_GENERATION) = s->generation;
+    *(double *)(r + REC_OFF_INTERVAL) = s->interval_sec;
+    *(uint32_t *)(r + rec.off_warmup) = s->warmup_complete ? 1 : 0;
+    *(uint32_t *)(r + rec.off_test_time) = s->test_time;
+
+    for (uint32_t i = 0; i < rec.nb_cols; i++) {
+        const struct stats_rec_column *c = &rec.cols[i];
+        struct rec_col_src *src = &rec.srcs[i];
+
+        switch (src->src) {
+        case REC_SRC_FIXED:
+            break;
+        case REC_SRC_PORT:
+            // Port listesi görüntüler arasında değişmez; yine de sınırı koru
+            if (src->slot < s->nb_ports)
+                memcpy(r + c->offset, (const uint8_t *)&s->ports[src->slot] + src->field, 8);
+            else
+                memset(r + c->offset, 0, 8);
+            break;
+        case REC_SRC_RAW:
+            if (src->slot < s->nb_raw)
+                memcpy(r + c->offset, (const uint8_t *)&s->raw[src->slot] + src->field, 8);
+            else
+                memset(r + c->offset, 0, 8);
+            break;
+        case REC_SRC_VL: {
+            // slot = port_id, index = VL-ID; sayaç reset'te (warm-up) geriye gider
+            uint64_t cur = port_vl_trackers[src->slot]->vl_trackers[c->index].pkt_count;
+            uint64_t d = cur >= src->prev ? cur - src->prev : cur;
+            src->prev = cur;
+            *(uint32_t *)(r + c->offset) = d > UINT32_MAX ? UINT32_MAX : (uint32_t)d;
+            break;
+        }
+        case REC_SRC_MON:
+#if LATENCY_MONITOR_ENABLED
+            // Aynı thread tick'te yazar: kopya tutarlı
+            memcpy(r + c->offset, (const uint8_t *)&latency_monitor_vlans[src->slot].point + src->field,
+                   c->type == STATS_REC_U32 ? 4 : 8);
+#endif
+            break;
+        }
+    }
+
+    // Kayıt tamamlandıktan sonra görünür yap (okuyucu nb_records'a kadar okur)
+    __atomic_store_n(&h->nb_records, n + 1, __ATOMIC_RELEASE);
+    rec.nb_records = n + 1;
+}
+
+void stats_recorder_close(void)
+{
+    if (rec.fd < 0)
+        return;
+
+    uint64_t n = rec.nb_records;
+    size_t used = (size_t)rec.header_size + (size_t)n * rec.record_size;
+
+    if (rec.map) {
+        msync(rec.map, used, MS_SYNC);
+        munmap(rec.map, rec.map_size);
+        rec.map = NULL;
+    }
+    if (ftruncate(rec.fd, (off_t)used) < 0)
+        printf("Stats recorder: final ftruncate failed: %s\n", strerror(errno));
+
+    printf("Stats recorder: %lu records, %zu bytes -> %s\n", n, used, STATS_RECORDER_PATH);
+    recorder_release();
+}
+
+#else /* !STATS_RECORDER_ENABLED */
+
+int stats_recorder_open(const struct stats_snapshot *first)
+{
+    (void)first;
+    return -1;
+}
+
+void stats_recorder_append(const struct stats_snapshot *s)
+{
+    (void)s;
+}
+
+void stats_recorder_close(void)
+{
+}
+
+#endif /* STATS_RECORDER_ENABLED */
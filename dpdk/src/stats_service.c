@@ -0,0 +1,636 @@
+#define _GNU_SOURCE  // accept4, pthread_setname_np
+#include "stats_service.h"
+#include "tx_rx_manager.h"      // rx_stats_per_port
+#include "dpdk_external_tx.h"   // dpdk_ext_tx_get_stats()
+#include "raw_socket_port.h"    // raw_socket_stats_snapshot()
+#include "stats_recorder.h"     // Binary kayıt (servis thread'inde)
+#include "latency_monitor.h"    // Gecikme interval'i (servis thread'inde)
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <rte_atomic.h>
+#include <rte_telemetry.h>
+
+// ==========================================
+// STATE
+// ==========================================
+
+static struct {
+    const struct ports_config *ports_config;
+
+    // Çift tampon: bufs[active] yayında, diğeri yazarın
+    struct stats_snapshot bufs[2];
+    _Atomic uint32_t active;
+    _Atomic uint64_t generation;
+
+    pthread_mutex_t build_lock;     // Thread ve stats_service_refresh() aynı anda yazmasın
+    uint64_t prev_mono_ns;          // Önceki görüntünün CLOCK_MONOTONIC zamanı
+
+    // Ana döngünün bildirdiği faz
+    _Atomic bool     warmup_complete;
+    _Atomic uint32_t loop_count;
+    _Atomic uint32_t test_time;
+
+    pthread_t thread;
+    bool running;
+    volatile bool stop;
+    int listen_fd;
+} svc = {
+    .build_lock = PTHREAD_MUTEX_INITIALIZER,
+    .listen_fd = -1,
+};
+
+// Endpoint cevabı (sadece servis thread'i kullanır)
+static char render_buf[STATS_SERVICE_RENDER_SIZE];
+
+static uint64_t clock_ns(clockid_t clk)
+{
+    struct timespec ts;
+    clock_gettime(clk, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Sayaç geriye gittiyse (reset) bu interval için hız yok
+static inline double rate_bps(uint64_t cur, uint64_t prev, double sec)
+{
+    if (cur < prev || sec <= 0.0)
+        return 0.0;
+    return (double)(cur - prev) * 8.0 / sec;
+}
+
+// ==========================================
+// SNAPSHOT BUILD / PUBLISH
+// ==========================================
+
+static void snapshot_port(struct stats_port_snapshot *p, uint16_t port_id)
+{
+    memset(p, 0, sizeof(*p));
+    p->port_id = port_id;
+
+    // Port başına tek okuma: tablo, uyarılar ve endpoint aynı değerleri görür
+    struct rte_eth_stats st;
+    if (rte_eth_stats_get(port_id, &st) == 0) {
+        p->hw_valid = true;
+        p->tx_pkts = st.opackets;
+        p->tx_bytes = st.obytes;
+        p->rx_pkts = st.ipackets;
+        p->rx_bytes = st.ibytes;
+        p->rx_missed = st.imissed;
+        p->rx_errors = st.ierrors;
+        p->tx_errors = st.oerrors;
+        p->rx_nombuf = st.rx_nombuf;
+        for (int q = 0; q < STATS_SERVICE_MAX_QUEUES; q++) {
+            p->q_rx_pkts[q] = st.q_ipackets[q];
+            p->q_rx_bytes[q] = st.q_ibytes[q];
+            p->q_tx_pkts[q] = st.q_opackets[q];
+            p->q_tx_bytes[q] = st.q_obytes[q];
+            p->q_rx_errors[q] = st.q_errors[q];
+        }
+    }
+
+    if (rx_stats_per_port && rx_stats_per_port[port_id]) {
+        struct rx_stats *rs = rx_stats_per_port[port_id];
+        p->good_pkts = rte_atomic64_read(&rs->good_pkts);
+        p->bad_pkts = rte_atomic64_read(&rs->bad_pkts);
+        p->lost_pkts = rte_atomic64_read(&rs->lost_pkts);
+        p->bit_errors = rte_atomic64_read(&rs->bit_errors);
+        p->out_of_order_pkts = rte_atomic64_read(&rs->out_of_order_pkts);
+        p->duplicate_pkts = rte_atomic64_read(&rs->duplicate_pkts);
+        p->short_pkts = rte_atomic64_read(&rs->short_pkts);
+        p->external_pkts = rte_atomic64_read(&rs->external_pkts);
+    }
+
+    // Bit Error Rate (BER)
+    if (p->rx_bytes > 0)
+        p->ber = (double)p->bit_errors / ((double)p->rx_bytes * 8.0);
+
+#if DPDK_EXT_TX_ENABLED
+    dpdk_ext_tx_get_stats(port_id, &p->ext_tx_pkts, &p->ext_tx_bytes);
+#endif
+}
+
+static void snapshot_build_and_publish(void)
+{
+    pthread_mutex_lock(&svc.build_lock);
+
+    // Önceki yayının generation store'u bu build'in tampon yazımlarından önce
+    // görünsün (okuyucu tarafındaki acquire fence ile eşleşir)
+    atomic_thread_fence(memory_order_release);
+
+    uint32_t cur = atomic_load_explicit(&svc.active, memory_order_relaxed);
+    const struct stats_snapshot *prev = &svc.bufs[cur];
+    struct stats_snapshot *s = &svc.bufs[cur ^ 1];
+    uint64_t prev_gen = atomic_load_explicit(&svc.generation, memory_order_relaxed);
+
+    uint64_t mono = clock_ns(CLOCK_MONOTONIC);
+    double sec = svc.prev_mono_ns ? (double)(mono - svc.prev_mono_ns) / 1e9 : 0.0;
+    svc.prev_mono_ns = mono;
+
+    s->t_ns = clock_ns(CLOCK_REALTIME);
+    s->interval_sec = sec;
+    s->warmup_complete = atomic_load_explicit(&svc.warmup_complete, memory_order_relaxed);
+    s->loop_count = atomic_load_explicit(&svc.loop_count, memory_order_relaxed);
+    s->test_time = atomic_load_explicit(&svc.test_time, memory_order_relaxed);
+
+    const struct ports_config *pc = svc.ports_config;
+    s->nb_ports = 0;
+    for (uint16_t i = 0; i < pc->nb_ports && s->nb_ports < RTE_MAX_ETHPORTS; i++) {
+        struct stats_port_snapshot *p = &s->ports[s->nb_ports++];
+        snapshot_port(p, pc->ports[i].port_id);
+
+        // Hız: önceki görüntüde aynı sıradaki port (port listesi sabit)
+        if (prev_gen > 0 && i < prev->nb_ports && prev->ports[i].hw_valid && p->hw_valid) {
+            p->tx_gbps = rate_bps(p->tx_bytes, prev->ports[i].tx_bytes, sec) / 1e9;
+            p->rx_gbps = rate_bps(p->rx_bytes, prev->ports[i].rx_bytes, sec) / 1e9;
+        }
+    }
+
+    s->nb_raw = (uint16_t)raw_socket_stats_snapshot(s->raw, STATS_SERVICE_MAX_RAW);
+    for (uint16_t r = 0; r < s->nb_raw; r++) {
+        if (prev_gen > 0 && r < prev->nb_raw &&
+            prev->raw[r].src_port == s->raw[r].src_port &&
+            prev->raw[r].dst_port == s->raw[r].dst_port)
+            s->raw[r].tx_mbps = rate_bps(s->raw[r].tx_bytes, prev->raw[r].tx_bytes, sec) / 1e6;
+    }
+
+    s->generation = prev_gen + 1;
+
+    // Yayın: önce aktif indeks, sonra generation (okuyucu generation ile doğrular)
+    atomic_store_explicit(&svc.active, cur ^ 1, memory_order_release);
+    atomic_store_explicit(&svc.generation, prev_gen + 1, memory_order_release);
+
+#if LATENCY_MONITOR_ENABLED
+    // Interval dolduysa VLAN sonuçları (kayıt bunları aynı build'de yazar)
+    latency_monitor_tick(s->warmup_complete);
+#endif
+
+    // Yayınlanan tampona bir sonraki build'e kadar yazılmaz
+    stats_recorder_append(s);
+
+    pthread_mutex_unlock(&svc.build_lock);
+}
+
+int stats_service_read(struct stats_snapshot *out)
+{
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint64_t gen = atomic_load_explicit(&svc.generation, memory_order_acquire);
+        if (gen == 0)
+            return -1;
+
+        uint32_t idx = atomic_load_explicit(&svc.active, memory_order_acquire);
+        memcpy(out, &svc.bufs[idx], sizeof(*out));
+        atomic_thread_fence(memory_order_acquire);
+
+        // Kopya sırasında hiç yayın olmadıysa tutarlı. Tek yayın bile yetmez:
+        // sonraki build hemen kopyaladığımız tampona yazmaya başlar.
+        if (atomic_load_explicit(&svc.generation, memory_order_relaxed) == gen)
+            return 0;
+    }
+    return -1;
+}
+
+void stats_service_set_phase(bool warmup_complete, uint32_t loop_count, uint32_t test_time)
+{
+    atomic_store_explicit(&svc.warmup_complete, warmup_complete, memory_order_relaxed);
+    atomic_store_explicit(&svc.loop_count, loop_count, memory_order_relaxed);
+    atomic_store_explicit(&svc.test_time, test_time, memory_order_relaxed);
+}
+
+void stats_service_refresh(void)
+{
+    if (svc.ports_config)
+        snapshot_build_and_publish();
+}
+
+// ==========================================
+// RENDER
+// ==========================================
+
+// snprintf'i taşmaya karşı biriktir
+struct out_buf {
+    char *buf;
+    size_t len;
+    size_t pos;
+};
+
+static void out_printf(struct out_buf *o, const char *fmt, ...)
+    __attribute__((format(printf, 2, 3)));
+
+static void out_printf(struct out_buf *o, const char *fmt, ...)
+{
+    if (o->pos + 1 >= o->len)
+        return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(o->buf + o->pos, o->len - o->pos, fmt, ap);
+    va_end(ap);
+    if (n < 0)
+        return;
+    o->pos += (size_t)n;
+    if (o->pos >= o->len)
+        o->pos = o->len - 1;
+}
+
+size_t stats_render_json(const struct stats_snapshot *s, char *buf, size_t len)
+{
+    struct out_buf o = { buf, len, 0 };
+    if (len == 0)
+        return 0;
+    buf[0] = '\0';
+
+    out_printf(&o, "{\"generation\":%lu,\"t_ns\":%lu,\"interval_sec\":%.3f,"
+               "\"phase\":\"%s\",\"loop_count\":%u,\"test_time\":%u,\"ports\":[",
+               s->generation, s->t_ns, s->interval_sec,
+               s->warmup_complete ? "test" : "warmup", s->loop_count, s->test_time);
+
+    for (uint16_t i = 0; i < s->nb_ports; i++) {
+        const struct stats_port_snapshot *p = &s->ports[i];
+        out_printf(&o, "%s{\"port\":%u,\"hw_valid\":%s,"
+                   "\"tx_packets\":%lu,\"tx_bytes\":%lu,\"tx_gbps\":%.3f,"
+                   "\"rx_packets\":%lu,\"rx_bytes\":%lu,\"rx_gbps\":%.3f,"
+                   "\"rx_missed\":%lu,\"rx_errors\":%lu,\"tx_errors\":%lu,\"rx_nombuf\":%lu,"
+                   "\"good\":%lu,\"bad\":%lu,\"lost\":%lu,\"bit_errors\":%lu,"
+                   "\"out_of_order\":%lu,\"duplicate\":%lu,\"short\":%lu,\"external\":%lu,"
+                   "\"ber\":%.3e,\"ext_tx_packets\":%lu,\"ext_tx_bytes\":%lu}",
+                   i ? "," : "", p->port_id, p->hw_valid ? "true" : "false",
+                   p->tx_pkts, p->tx_bytes, p->tx_gbps,
+                   p->rx_pkts, p->rx_bytes, p->rx_gbps,
+                   p->rx_missed, p->rx_errors, p->tx_errors, p->rx_nombuf,
+                   p->good_pkts, p->bad_pkts, p->lost_pkts, p->bit_errors,
+                   p->out_of_order_pkts, p->duplicate_pkts, p->short_pkts, p->external_pkts,
+                   p->ber, p->ext_tx_pkts, p->ext_tx_bytes);
+    }
+
+    out_printf(&o, "],\"raw_targets\":[");
+    for (uint16_t r = 0; r < s->nb_raw; r++) {
+        const struct stats_raw_snapshot *t = &s->raw[r];
+        out_printf(&o, "%s{\"src\":%u,\"dst\":%u,\"rate_mbps\":%u,"
+                   "\"tx_packets\":%lu,\"tx_bytes\":%lu,\"tx_mbps\":%.2f,"
+                   "\"rx_packets\":%lu,\"good\":%lu,\"bad\":%lu,\"lost\":%lu,\"bit_errors\":%lu}",
+                   r ? "," : "", t->src_port, t->dst_port, t->rate_mbps,
+                   t->tx_pkts, t->tx_bytes, t->tx_mbps,
+                   t->rx_pkts, t->good_pkts, t->bad_pkts, t->lost_pkts, t->bit_errors);
+    }
+    out_printf(&o, "]}\n");
+    return o.pos;
+}
+
+// Prometheus: metrik başına HELP/TYPE + port etiketli satırlar
+#define PROM_PORT_METRIC(o, s, name, type, help, field, fmt)                      \
+    do {                                                                          \
+        out_printf(o, "# HELP dpdk_app_port_" name " " help "\n"                  \
+                      "# TYPE dpdk_app_port_" name " " type "\n");                \
+        for (uint16_t _i = 0; _i < (s)->nb_ports; _i++)                           \
+            if ((s)->ports[_i].hw_valid)                                          \
+                out_printf(o, "dpdk_app_port_" name "{port=\"%u\"} " fmt "\n",    \
+                           (s)->ports[_i].port_id, (s)->ports[_i].field);         \
+    } while (0)
+
+#define PROM_RAW_METRIC(o, s, name, type, help, field, fmt)                       \
+    do {                                                                          \
+        out_printf(o, "# HELP dpdk_app_raw_" name " " help "\n"                   \
+                      "# TYPE dpdk_app_raw_" name " " type "\n");                 \
+        for (uint16_t _r = 0; _r < (s)->nb_raw; _r++)                             \
+            out_printf(o, "dpdk_app_raw_" name "{src=\"%u\",dst=\"%u\"} " fmt "\n", \
+                       (s)->raw[_r].src_port, (s)->raw[_r].dst_port,              \
+                       (s)->raw[_r].field);                                       \
+    } while (0)
+
+size_t stats_render_prometheus(const struct stats_snapshot *s, char *buf, size_t len)
+{
+    struct out_buf o = { buf, len, 0 };
+    if (len == 0)
+        return 0;
+    buf[0] = '\0';
+
+    out_printf(&o, "# HELP dpdk_app_warmup_complete 1 after the warm-up reset\n"
+                   "# TYPE dpdk_app_warmup_complete gauge\n"
+                   "dpdk_app_warmup_complete %u\n"
+                   "# HELP dpdk_app_test_seconds Seconds since the warm-up reset\n"
+                   "# TYPE dpdk_app_test_seconds gauge\n"
+                   "dpdk_app_test_seconds %u\n",
+               s->warmup_complete ? 1u : 0u, s->test_time);
+
+    PROM_PORT_METRIC(&o, s, "tx_packets_total", "counter", "HW transmitted packets", tx_pkts, "%lu");
+    PROM_PORT_METRIC(&o, s, "tx_bytes_total", "counter", "HW transmitted bytes", tx_bytes, "%lu");
+    PROM_PORT_METRIC(&o, s, "rx_packets_total", "counter", "HW received packets", rx_pkts, "%lu");
+    PROM_PORT_METRIC(&o, s, "rx_bytes_total", "counter", "HW received bytes", rx_bytes, "%lu");
+    PROM_PORT_METRIC(&o, s, "rx_missed_total", "counter", "HW RX drops (imissed)", rx_missed, "%lu");
+    PROM_PORT_METRIC(&o, s, "rx_errors_total", "counter", "HW RX errors", rx_errors, "%lu");
+    PROM_PORT_METRIC(&o, s, "tx_errors_total", "counter", "HW TX errors", tx_errors, "%lu");
+    PROM_PORT_METRIC(&o, s, "rx_nombuf_total", "counter", "RX mbuf allocation failures", rx_nombuf, "%lu");
+    PROM_PORT_METRIC(&o, s, "tx_gbps", "gauge", "TX rate over the last interval", tx_gbps, "%.6f");
+    PROM_PORT_METRIC(&o, s, "rx_gbps", "gauge", "RX rate over the last interval", rx_gbps, "%.6f");
+    PROM_PORT_METRIC(&o, s, "prbs_good_total", "counter", "PRBS verified packets", good_pkts, "%lu");
+    PROM_PORT_METRIC(&o, s, "prbs_bad_total", "counter", "PRBS failed packets", bad_pkts, "%lu");
+    PROM_PORT_METRIC(&o, s, "prbs_lost_total", "counter", "Sequence gaps", lost_pkts, "%lu");
+    PROM_PORT_METRIC(&o, s, "prbs_bit_errors_total", "counter", "PRBS bit errors", bit_errors, "%lu");
+    PROM_PORT_METRIC(&o, s, "ber", "gauge", "Bit error rate", ber, "%.6e");
+    PROM_PORT_METRIC(&o, s, "ext_tx_packets_total", "counter", "External TX packets", ext_tx_pkts, "%lu");
+    PROM_PORT_METRIC(&o, s, "ext_tx_bytes_total", "counter", "External TX bytes", ext_tx_bytes, "%lu");
+
+    if (s->nb_raw > 0) {
+        PROM_RAW_METRIC(&o, s, "tx_packets_total", "counter", "Raw socket target TX packets", tx_pkts, "%lu");
+        PROM_RAW_METRIC(&o, s, "tx_bytes_total", "counter", "Raw socket target TX bytes", tx_bytes, "%lu");
+        PROM_RAW_METRIC(&o, s, "tx_mbps", "gauge", "Raw socket target TX rate", tx_mbps, "%.3f");
+        PROM_RAW_METRIC(&o, s, "rx_packets_total", "counter", "Raw socket target RX packets", rx_pkts, "%lu");
+        PROM_RAW_METRIC(&o, s, "good_total", "counter", "Raw socket PRBS verified packets", good_pkts, "%lu");
+        PROM_RAW_METRIC(&o, s, "bad_total", "counter", "Raw socket PRBS failed packets", bad_pkts, "%lu");
+        PROM_RAW_METRIC(&o, s, "lost_total", "counter", "Raw socket sequence gaps", lost_pkts, "%lu");
+        PROM_RAW_METRIC(&o, s, "bit_errors_total", "counter", "Raw socket bit errors", bit_errors, "%lu");
+    }
+    return o.pos;
+}
+
+#if STATS_SERVICE_ENDPOINT_ENABLED
+
+// ==========================================
+// UNIX SOCKET ENDPOINT
+// ==========================================
+
+static int endpoint_open(void)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        printf("Stats service: socket() failed: %s\n", strerror(errno));
+        return -1;
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", STATS_SERVICE_SOCK_PATH);
+    unlink(STATS_SERVICE_SOCK_PATH);    // Önceki çalışmadan kalan
+
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 4) < 0) {
+        printf("Stats service: cannot listen on %s: %s\n", STATS_SERVICE_SOCK_PATH, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Tek istek: komut satırını oku, görüntüyü yaz, kapat
+static void endpoint_serve(int fd)
+{
+    // İstemci yavaşsa servis thread'i takılmasın
+    struct timeval tv = { .tv_sec = 0, .tv_usec = 200000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    char cmd[32];
+    ssize_t n = recv(fd, cmd, sizeof(cmd) - 1, 0);
+    cmd[n > 0 ? n : 0] = '\0';
+
+    static struct stats_snapshot snap;
+    size_t len;
+    if (stats_service_read(&snap) != 0) {
+        len = (size_t)snprintf(render_buf, sizeof(render_buf), "no snapshot yet\n");
+    } else if (strncmp(cmd, "prom", 4) == 0 || strncmp(cmd, "metrics", 7) == 0) {
+        len = stats_render_prometheus(&snap, render_buf, sizeof(render_buf));
+    } else {
+        len = stats_render_json(&snap, render_buf, sizeof(render_buf));
+    }
+
+    size_t off = 0;
+    while (off < len) {
+        ssize_t w = send(fd, render_buf + off, len - off, MSG_NOSIGNAL);
+        if (w <= 0)
+            break;
+        off += (size_t)w;
+    }
+    close(fd);
+}
+
+// ==========================================
+// RTE_TELEMETRY
+// ==========================================
+
+static int telemetry_stats(const char *cmd, const char *params, struct rte_tel_data *d)
+{
+    static struct stats_snapshot snap;
+    static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    RTE_SET_USED(cmd);
+    RTE_SET_USED(params);
+
+    pthread_mutex_lock(&lock);
+    if (stats_service_read(&snap) != 0) {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+
+    uint64_t tx_pkts = 0, rx_pkts = 0, good = 0, bad = 0, lost = 0, bit_err = 0, missed = 0;
+    double tx_gbps = 0.0, rx_gbps = 0.0;
+    for (uint16_t i = 0; i < snap.nb_ports; i++) {
+        const struct stats_port_snapshot *p = &snap.ports[i];
+        tx_pkts += p->tx_pkts;
+        rx_pkts += p->rx_pkts;
+        tx_gbps += p->tx_gbps;
+        rx_gbps += p->rx_gbps;
+        good += p->good_pkts;
+        bad += p->bad_pkts;
+        lost += p->lost_pkts;
+        bit_err += p->bit_errors;
+        missed += p->rx_missed;
+    }
+
+    rte_tel_data_start_dict(d);
+    rte_tel_data_add_dict_uint(d, "generation", snap.generation);
+    rte_tel_data_add_dict_string(d, "phase", snap.warmup_complete ? "test" : "warmup");
+    rte_tel_data_add_dict_uint(d, "test_time", snap.test_time);
+    rte_tel_data_add_dict_uint(d, "ports", snap.nb_ports);
+    rte_tel_data_add_dict_uint(d, "tx_packets", tx_pkts);
+    rte_tel_data_add_dict_uint(d, "rx_packets", rx_pkts);
+    rte_tel_data_add_dict_uint(d, "tx_mbps", (uint64_t)(tx_gbps * 1000.0));
+    rte_tel_data_add_dict_uint(d, "rx_mbps", (uint64_t)(rx_gbps * 1000.0));
+    rte_tel_data_add_dict_uint(d, "good", good);
+    rte_tel_data_add_dict_uint(d, "bad", bad);
+    rte_tel_data_add_dict_uint(d, "lost", lost);
+    rte_tel_data_add_dict_uint(d, "bit_errors", bit_err);
+    rte_tel_data_add_dict_uint(d, "rx_missed", missed);
+    rte_tel_data_add_dict_uint(d, "raw_targets", snap.nb_raw);
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+static int telemetry_port(const char *cmd, const char *params, struct rte_tel_data *d)
+{
+    static struct stats_snapshot snap;
+    static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    RTE_SET_USED(cmd);
+
+    if (params == NULL || *params == '\0')
+        return -1;
+    char *end;
+    unsigned long port_id = strtoul(params, &end, 10);
+    if (*end != '\0')
+        return -1;
+
+    pthread_mutex_lock(&lock);
+    if (stats_service_read(&snap) != 0) {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+
+    const struct stats_port_snapshot *p = NULL;
+    for (uint16_t i = 0; i < snap.nb_ports && !p; i++)
+        if (snap.ports[i].port_id == port_id)
+            p = &snap.ports[i];
+    if (!p) {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+
+    rte_tel_data_start_dict(d);
+    rte_tel_data_add_dict_uint(d, "generation", snap.generation);
+    rte_tel_data_add_dict_uint(d, "tx_packets", p->tx_pkts);
+    rte_tel_data_add_dict_uint(d, "tx_bytes", p->tx_bytes);
+    rte_tel_data_add_dict_uint(d, "tx_mbps", (uint64_t)(p->tx_gbps * 1000.0));
+    rte_tel_data_add_dict_uint(d, "rx_packets", p->rx_pkts);
+    rte_tel_data_add_dict_uint(d, "rx_bytes", p->rx_bytes);
+    rte_tel_data_add_dict_uint(d, "rx_mbps", (uint64_t)(p->rx_gbps * 1000.0));
+    rte_tel_data_add_dict_uint(d, "rx_missed", p->rx_missed);
+    rte_tel_data_add_dict_uint(d, "rx_errors", p->rx_errors);
+    rte_tel_data_add_dict_uint(d, "tx_errors", p->tx_errors);
+    rte_tel_data_add_dict_uint(d, "rx_nombuf", p->rx_nombuf);
+    rte_tel_data_add_dict_uint(d, "good", p->good_pkts);
+    rte_tel_data_add_dict_uint(d, "bad", p->bad_pkts);
+    rte_tel_data_add_dict_uint(d, "lost", p->lost_pkts);
+    rte_tel_data_add_dict_uint(d, "bit_errors", p->bit_errors);
+    rte_tel_data_add_dict_uint(d, "out_of_order", p->out_of_order_pkts);
+    rte_tel_data_add_dict_uint(d, "duplicate", p->duplicate_pkts);
+    rte_tel_data_add_dict_uint(d, "short", p->short_pkts);
+    rte_tel_data_add_dict_uint(d, "external", p->external_pkts);
+    rte_tel_data_add_dict_uint(d, "ext_tx_packets", p->ext_tx_pkts);
+    rte_tel_data_add_dict_uint(d, "ext_tx_bytes", p->ext_tx_bytes);
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+static void telemetry_register(void)
+{
+    // Kayıt geri alınamaz: servis yeniden başlatılırsa tekrar kaydetme
+    static bool registered;
+    if (registered)
+        return;
+    registered = true;
+
+    rte_telemetry_register_cmd("/dpdk_app/stats", telemetry_stats,
+                               "Totals across DPDK ports from the latest snapshot. No parameters");
+    rte_telemetry_register_cmd("/dpdk_app/port", telemetry_port,
+                               "Counters of one DPDK port from the latest snapshot. Parameters: int port_id");
+}
+
+#endif /* STATS_SERVICE_ENDPOINT_ENABLED */
+
+// ==========================================
+// SERVICE THREAD
+// ==========================================
+
+static void *stats_service_thread(void *arg)
+{
+    RTE_SET_USED(arg);
+    uint64_t next_ns = clock_ns(CLOCK_MONOTONIC) + STATS_SERVICE_INTERVAL_MS * 1000000ULL;
+
+    while (!svc.stop) {
+        uint64_t now = clock_ns(CLOCK_MONOTONIC);
+        if (now >= next_ns) {
+            snapshot_build_and_publish();
+            next_ns += STATS_SERVICE_INTERVAL_MS * 1000000ULL;
+            if (next_ns <= now)     // Uzun gecikme: kaçırılan tick'leri biriktirme
+                next_ns = now + STATS_SERVICE_INTERVAL_MS * 1000000ULL;
+            continue;
+        }
+
+        // Sonraki tick'e kadar bekle; stop'u görmek için en fazla 100 ms
+        int timeout_ms = (int)RTE_MIN((next_ns - now) / 1000000ULL + 1, 100ULL);
+#if STATS_SERVICE_ENDPOINT_ENABLED
+        if (svc.listen_fd >= 0) {
+            struct pollfd pfd = { .fd = svc.listen_fd, .events = POLLIN };
+            if (poll(&pfd, 1, timeout_ms) > 0 && (pfd.revents & POLLIN)) {
+                int cfd = accept4(svc.listen_fd, NULL, NULL, SOCK_CLOEXEC);
+                if (cfd >= 0)
+                    endpoint_serve(cfd);
+            }
+            continue;
+        }
+#endif
+        usleep((useconds_t)timeout_ms * 1000);
+    }
+    return NULL;
+}
+
+int stats_service_start(const struct ports_config *ports_config)
+{
+    if (svc.running)
+        return 0;
+
+    svc.ports_config = ports_config;
+    svc.prev_mono_ns = 0;
+    svc.stop = false;
+    atomic_store(&svc.generation, 0);
+
+    // İlk görüntü: ana döngünün ilk okuması boş kalmasın; kayıt şeması da bundan kurulur
+    snapshot_build_and_publish();
+    const struct stats_snapshot *first = &svc.bufs[atomic_load(&svc.active)];
+    if (stats_recorder_open(first) == 0)
+        stats_recorder_append(first);
+
+#if STATS_SERVICE_ENDPOINT_ENABLED
+    svc.listen_fd = endpoint_open();
+    telemetry_register();
+#endif
+
+    int ret = pthread_create(&svc.thread, NULL, stats_service_thread, NULL);
+    if (ret != 0) {
+        printf("Stats service: pthread_create failed: %s\n", strerror(ret));
+#if STATS_SERVICE_ENDPOINT_ENABLED
+        if (svc.listen_fd >= 0) {
+            close(svc.listen_fd);
+            svc.listen_fd = -1;
+            unlink(STATS_SERVICE_SOCK_PATH);
+        }
+#endif
+        stats_recorder_close();
+        return -1;
+    }
+    pthread_setname_np(svc.thread, "stats_svc");
+    svc.running = true;
+
+    printf("Stats service: %u ms snapshots", STATS_SERVICE_INTERVAL_MS);
+#if STATS_SERVICE_ENDPOINT_ENABLED
+    if (svc.listen_fd >= 0)
+        printf(", endpoint %s (json | prom), telemetry /dpdk_app/stats /dpdk_app/port", STATS_SERVICE_SOCK_PATH);
+#endif
+    printf("\n");
+    return 0;
+}
+
+void stats_service_stop(void)
+{
+    if (!svc.running)
+        return;
+
+    svc.stop = true;
+    pthread_join(svc.thread, NULL);
+    svc.running = false;
+    stats_recorder_close();
+
+#if STATS_SERVICE_ENDPOINT_ENABLED
+    if (svc.listen_fd >= 0) {
+        close(svc.listen_fd);
+        svc.listen_fd = -1;
+        unlink(STATS_SERVICE_SOCK_PATH);
+    }
+#endif
+}
@@ -0,0 +1,273 @@
+#include "traffic_shape.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <rte_malloc.h>
+
+static const struct tx_shape_port_config shape_port_configs[] = TX_SHAPE_CONFIG_INIT;
+static const struct tx_shape_config shape_default = TX_SHAPE_DEFAULT;
+
+#define SHAPE_PORT_CONFIG_COUNT (sizeof(shape_port_configs) / sizeof(shape_port_configs[0]))
+
+// ONOFF en kötü durumda paket başına 2 girdi üretir
+#define SHAPE_MAX_ENTRIES (TX_SHAPE_TABLE_SIZE * 2)
+
+const struct tx_shape_config *tx_shape_lookup(uint16_t port_id, uint16_t queue_id)
+{
+    const struct tx_shape_port_config *end = shape_port_configs + SHAPE_PORT_CONFIG_COUNT;
+
+    for (const struct tx_shape_port_config *pc = shape_port_configs; pc < end; pc++) {
+        if (pc->port_id == port_id &&
+            (pc->queue_id == TX_SHAPE_ALL_QUEUES || pc->queue_id == queue_id)) {
+            return &pc->shape;
+        }
+    }
+    return &shape_default;
+}
+
+const char *tx_shape_name(enum tx_shape_type type)
+{
+    switch (type) {
+    case TX_SHAPE_CONSTANT:     return "CONSTANT";
+    case TX_SHAPE_POISSON:      return "POISSON";
+    case TX_SHAPE_ONOFF:        return "ONOFF";
+    case TX_SHAPE_RAMP_LINEAR:  return "RAMP_LINEAR";
+    case TX_SHAPE_RAMP_STEP:    return "RAMP_STEP";
+    case TX_SHAPE_TOKEN_BUCKET: return "TOKEN_BUCKET";
+    }
+    return "UNKNOWN";
+}
+
+// ==========================================
+// PRNG (xorshift64*) - tekrarlanabilir tablolar için
+// ==========================================
+
+static inline uint64_t shape_rand_next(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// (0, 1] aralığında uniform
+static inline double shape_rand_uniform(uint64_t *state)
+{
+    return (double)((shape_rand_next(state) >> 11) + 1) * (1.0 / 9007199254740992.0);
+}
+
+// Ortalaması mean olan üstel dağılım
+static inline double shape_rand_exp(uint64_t *state, double mean)
+{
+    return -log(shape_rand_uniform(state)) * mean;
+}
+
+// ==========================================
+// TABLE GENERATORS (double gap, sonra normalize edilir)
+// ==========================================
+
+static uint32_t gen_poisson(double *gaps, uint32_t *reps, double mean, uint64_t *rng)
+{
+    for (uint32_t i = 0; i < TX_SHAPE_TABLE_SIZE; i++) {
+        gaps[i] = shape_rand_exp(rng, mean);
+        reps[i] = 1;
+    }
+    return TX_SHAPE_TABLE_SIZE;
+}
+
+static uint32_t gen_onoff(double *gaps, uint32_t *reps, double mean,
+                          const struct tx_shape_config *cfg, uint64_t *rng)
+{
+    uint32_t on_pct = cfg->on_pct;
+    if (on_pct == 0 || on_pct > 100)
+        on_pct = 100;
+    double burst_len = cfg->burst_len > 0 ? (double)cfg->burst_len : 1.0;
+
+    // ON: peak rate = ortalama * 100 / on_pct
+    double on_gap = mean * (double)on_pct / 100.0;
+    // OFF: ON/OFF süre oranı on_pct olacak şekilde ortalama sessizlik
+    double off_mean = burst_len * on_gap * (double)(100 - on_pct) / (double)on_pct;
+
+    uint32_t count = 0;
+    uint32_t pkts = 0;
+    while (pkts < TX_SHAPE_TABLE_SIZE && count + 2 <= SHAPE_MAX_ENTRIES) {
+        uint32_t n = (uint32_t)(shape_rand_exp(rng, burst_len) + 0.5);
+        if (n < 1)
+            n = 1;
+
+        // Burst içi: n-1 adet on_gap
+        if (n > 1) {
+            gaps[count] = on_gap;
+            reps[count] = n - 1;
+            count++;
+        }
+        // Burst'ün son paketinden sonra OFF periyodu
+        gaps[count] = on_gap + shape_rand_exp(rng, off_mean);
+        reps[count] = 1;
+        count++;
+
+        pkts += n;
+    }
+    return count;
+}
+
+static uint32_t gen_ramp(double *gaps, uint32_t *reps, double mean, uint64_t tsc_hz,
+                         const struct tx_shape_config *cfg, bool linear)
+{
+    uint32_t steps = linear ? TX_SHAPE_RAMP_LINEAR_STEPS : cfg->ramp_steps;
+    if (steps < 2)
+        steps = 2;
+    if (steps > TX_SHAPE_TABLE_SIZE)
+        steps = TX_SHAPE_TABLE_SIZE;
+
+    uint32_t period_ms = cfg->ramp_period_ms > 0 ? cfg->ramp_period_ms : 1000;
+    double step_cycles = (double)period_ms * (double)tsc_hz / 1000.0 / (double)steps;
+    double start = cfg->start_pct > 0 ? (double)cfg->start_pct : 1.0;
+    double end = cfg->end_pct > 0 ? (double)cfg->end_pct : 1.0;
+
+    // Bağıl rate'ler ortalamaya göre ölçeklenir (periyot ortalaması = hedef rate)
+    double rel_sum = 0.0;
+    for (uint32_t i = 0; i < steps; i++) {
+        double frac = linear ? ((double)i + 0.5) / (double)steps
+                             : (double)i / (double)(steps - 1);
+        gaps[i] = start + (end - start) * frac;   // geçici: bağıl rate
+        rel_sum += gaps[i];
+    }
+    double rel_avg = rel_sum / (double)steps;
+
+    for (uint32_t i = 0; i < steps; i++) {
+        double step_pkts = (step_cycles / mean) * (gaps[i] / rel_avg);
+        uint32_t n = (uint32_t)(step_pkts + 0.5);
+        if (n < 1)
+            n = 1;
+        reps[i] = n;
+        gaps[i] = step_cycles / (double)n;
+    }
+    return steps;
+}
+
+// ==========================================
+// BUILD / NORMALIZE
+// ==========================================
+
+struct tx_shape_table *tx_shape_build(const struct tx_shape_config *cfg,
+                                      uint64_t mean_gap, uint64_t tsc_hz,
+                                      uint64_t seed, int socket_id)
+{
+    double *gaps = calloc(SHAPE_MAX_ENTRIES, sizeof(double));
+    uint32_t *reps = calloc(SHAPE_MAX_ENTRIES, sizeof(uint32_t));
+    if (!gaps || !reps) {
+        free(gaps);
+        free(reps);
+        return NULL;
+    }
+
+    uint64_t rng = seed ? seed : 0x9E3779B97F4A7C15ULL;
+    double mean = (double)(mean_gap > 0 ? mean_gap : 1);
+    uint32_t count;
+
+    switch (cfg->type) {
+    case TX_SHAPE_POISSON:
+        count = gen_poisson(gaps, reps, mean, &rng);
+        break;
+    case TX_SHAPE_ONOFF:
+        count = gen_onoff(gaps, reps, mean, cfg, &rng);
+        break;
+    case TX_SHAPE_RAMP_LINEAR:
+        count = gen_ramp(gaps, reps, mean, tsc_hz, cfg, true);
+        break;
+    case TX_SHAPE_RAMP_STEP:
+        count = gen_ramp(gaps, reps, mean, tsc_hz, cfg, false);
+        break;
+    case TX_SHAPE_CONSTANT:
+    case TX_SHAPE_TOKEN_BUCKET:   // Pacing rate_limiter'da, tablo sadece referans
+    default:
+        gaps[0] = mean;
+        reps[0] = 1;
+        count = 1;
+        break;
+    }
+
+    size_t size = sizeof(struct tx_shape_table) + (size_t)count * sizeof(struct tx_shape_entry);
+    struct tx_shape_table *table = rte_zmalloc_socket("tx_shape", size, 0, socket_id);
+    if (!table) {
+        free(gaps);
+        free(reps);
+        return NULL;
+    }
+
+    table->config = *cfg;
+    table->mean_gap = mean_gap;
+    table->count = count;
+
+    // Normalize: ortalama gap == mean_gap. Tamsayıya yuvarlama hatası girdiler
+    // arasında taşınır, toplam sapma tek girdinin repeat değerini geçmez.
+    double raw_total = 0.0;
+    uint64_t pkts = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        raw_total += gaps[i] * (double)reps[i];
+        pkts += reps[i];
+    }
+    double scale = ((double)pkts * mean) / raw_total;
+
+    double target_cum = 0.0;
+    uint64_t int_cum = 0;
+    uint64_t max_gap = mean_gap;
+    for (uint32_t i = 0; i < count; i++) {
+        target_cum += gaps[i] * scale * (double)reps[i];
+        double remaining = target_cum - (double)int_cum;
+        uint64_t g = remaining > 0.0 ? (uint64_t)(remaining / (double)reps[i] + 0.5) : 0;
+
+        table->entries[i].gap = g;
+        table->entries[i].repeat = reps[i];
+        int_cum += g * reps[i];
+        if (g > max_gap)
+            max_gap = g;
+    }
+
+    table->resync_gap = max_gap;
+    table->total_cycles = int_cum;
+    table->total_pkts = pkts;
+
+    free(gaps);
+    free(reps);
+    return table;
+}
+
+void tx_shape_free(struct tx_shape_table *table)
+{
+    rte_free(table);
+}
+
+void tx_shape_print(const struct tx_shape_table *table, uint64_t tsc_hz)
+{
+    const struct tx_shape_config *cfg = &table->config;
+    double target_pps = (double)tsc_hz / (double)table->mean_gap;
+    double achieved_pps = table->total_cycles > 0
+                              ? (double)table->total_pkts * (double)tsc_hz / (double)table->total_cycles
+                              : 0.0;
+
+    printf("  -> Shape: %s", tx_shape_name(cfg->type));
+    switch (cfg->type) {
+    case TX_SHAPE_ONOFF:
+        printf(" (burst=%u pkt, on=%u%%)", cfg->burst_len, cfg->on_pct);
+        break;
+    case TX_SHAPE_RAMP_LINEAR:
+    case TX_SHAPE_RAMP_STEP:
+        printf(" (%u%% -> %u%% / %u ms, %u steps)", cfg->start_pct, cfg->end_pct,
+               cfg->ramp_period_ms, cfg->type == TX_SHAPE_RAMP_STEP ? cfg->ramp_steps
+                                                                     : TX_SHAPE_RAMP_LINEAR_STEPS);
+        break;
+    case TX_SHAPE_TOKEN_BUCKET:
+        printf(" (depth=%u bytes)", cfg->bucket_depth);
+        break;
+    default:
+        break;
+    }
+    printf(", %u entries, mean %.0f pps (target %.0f), max gap %.1f us\n",
+           table->count, achieved_pps, target_pps,
+           (double)table->resync_gap * 1000000.0 / (double)tsc_hz);
+}
@@ -0,0 +1,186 @@
+#include "tx_pacing_stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ==========================================
+// REGISTRY
+// ==========================================
+
+static struct tx_pacing_stats pacing_blocks[TX_PACING_MAX_BLOCKS];
+static uint32_t pacing_block_count = 0;
+
+// Okuyucu-özel: önceki interval'in kümülatif değerleri
+struct tx_pacing_snapshot {
+    uint64_t packets;
+    uint64_t gap_sum_ns;
+    uint64_t sched_sum_ns;
+    uint64_t late_sends;
+    uint64_t skipped_slots;
+    uint64_t resync_slots;
+    uint64_t tx_drops;
+    uint64_t hist[TX_PACING_HIST_BUCKETS];
+};
+
+static struct tx_pacing_snapshot pacing_prev[TX_PACING_MAX_BLOCKS];
+
+// Tablo dolunca her worker'a heap'te kendi bloğu verilir (tek yazar kuralı
+// korunur, paylaşılan blok yok); raporda tablodakilerden sonra yazılır
+struct tx_pacing_overflow {
+    struct tx_pacing_stats stats;
+    struct tx_pacing_snapshot prev;
+    struct tx_pacing_overflow *next;
+};
+
+static struct tx_pacing_overflow *pacing_overflow_head = NULL;
+
+struct tx_pacing_stats *tx_pacing_register(const char *label, uint64_t tick_hz)
+{
+    uint32_t idx = __atomic_fetch_add(&pacing_block_count, 1, __ATOMIC_RELAXED);
+    struct tx_pacing_overflow *o = NULL;
+    struct tx_pacing_stats *s;
+
+    if (idx >= TX_PACING_MAX_BLOCKS) {
+        o = aligned_alloc(_Alignof(struct tx_pacing_overflow), sizeof(*o));
+        if (!o) {
+            // Son çare: çağıran thread'e özel, raporlanmayan blok
+            static __thread struct tx_pacing_stats pacing_private_block;
+            printf("Warning: TX pacing table full, '%s' is not reported\n", label);
+            s = &pacing_private_block;
+        } else {
+            printf("Warning: TX pacing table full, '%s' uses a heap block\n", label);
+            memset(o, 0, sizeof(*o));
+            s = &o->stats;
+        }
+    } else {
+        s = &pacing_blocks[idx];
+    }
+
+    memset(s, 0, sizeof(*s));
+    snprintf(s->label, sizeof(s->label), "%s", label);
+    s->tick_hz = tick_hz ? tick_hz : 1;
+    s->ns_mult = (uint64_t)(((unsigned __int128)1000000000ULL << 32) / s->tick_hz);
+    s->late_ticks = (uint64_t)(((unsigned __int128)TX_PACING_LATE_NS * s->tick_hz) / 1000000000ULL);
+    __atomic_store_n(&s->ready, 1, __ATOMIC_RELEASE);
+
+    if (o) {
+        o->next = __atomic_load_n(&pacing_overflow_head, __ATOMIC_RELAXED);
+        while (!__atomic_compare_exchange_n(&pacing_overflow_head, &o->next, o, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+            ;
+    }
+
+    return s;
+}
+
+// ==========================================
+// REPORTING
+// ==========================================
+
+static void format_bucket(char *buf, size_t len, int b)
+{
+    if (b < 0) {
+        snprintf(buf, len, "-");
+        return;
+    }
+    if (b >= TX_PACING_HIST_BUCKETS - 1) {
+        snprintf(buf, len, ">=1ms");
+        return;
+    }
+
+    uint64_t upper_ns = 1ULL << (TX_PACING_HIST_BASE_SHIFT + b);
+    if (upper_ns < 1000)
+        snprintf(buf, len, "<%luns", upper_ns);
+    else
+        snprintf(buf, len, "<%.1fus", (double)upper_ns / 1000.0);
+}
+
+// Histogramdan yüzdelik dilimin bucket'ını bul (üst sınır raporlanır)
+static int hist_percentile(const uint64_t *hist, uint64_t total, double pct)
+{
+    if (total == 0)
+        return -1;
+
+    uint64_t target = (uint64_t)((double)total * pct);
+    if (target == 0)
+        target = 1;
+
+    uint64_t acc = 0;
+    for (int b = 0; b < TX_PACING_HIST_BUCKETS; b++) {
+        acc += hist[b];
+        if (acc >= target)
+            return b;
+    }
+    return TX_PACING_HIST_BUCKETS - 1;
+}
+
+#if TX_PACING_STATS_ENABLED
+static void print_block(struct tx_pacing_stats *s, struct tx_pacing_snapshot *prev)
+{
+    if (!__atomic_load_n(&s->ready, __ATOMIC_ACQUIRE))
+        return;
+
+    struct tx_pacing_snapshot cur;
+    cur.packets = __atomic_load_n(&s->packets, __ATOMIC_RELAXED);
+    cur.gap_sum_ns = __atomic_load_n(&s->gap_sum_ns, __ATOMIC_RELAXED);
+    cur.sched_sum_ns = __atomic_load_n(&s->sched_sum_ns, __ATOMIC_RELAXED);
+    cur.late_sends = __atomic_load_n(&s->late_sends, __ATOMIC_RELAXED);
+    cur.skipped_slots = __atomic_load_n(&s->skipped_slots, __ATOMIC_RELAXED);
+    cur.resync_slots = __atomic_load_n(&s->resync_slots, __ATOMIC_RELAXED);
+    cur.tx_drops = __atomic_load_n(&s->tx_drops, __ATOMIC_RELAXED);
+
+    uint64_t hist[TX_PACING_HIST_BUCKETS];
+    uint64_t hist_total = 0;
+    int max_bucket = -1;
+    for (int b = 0; b < TX_PACING_HIST_BUCKETS; b++) {
+        cur.hist[b] = __atomic_load_n(&s->hist[b], __ATOMIC_RELAXED);
+        hist[b] = cur.hist[b] - prev->hist[b];
+        hist_total += hist[b];
+        if (hist[b] > 0)
+            max_bucket = b;
+    }
+
+    uint64_t pkts = cur.packets - prev->packets;
+    uint64_t gap_sum = cur.gap_sum_ns - prev->gap_sum_ns;
+    uint64_t sched_sum = cur.sched_sum_ns - prev->sched_sum_ns;
+    uint64_t late = cur.late_sends - prev->late_sends;
+    uint64_t skipped = cur.skipped_slots - prev->skipped_slots;
+    uint64_t resync = cur.resync_slots - prev->resync_slots;
+    uint64_t drops = cur.tx_drops - prev->tx_drops;
+    *prev = cur;
+
+    double gap_us = pkts ? (double)gap_sum / (double)pkts / 1000.0 : 0.0;
+    double sched_us = pkts ? (double)sched_sum / (double)pkts / 1000.0 : 0.0;
+
+    char p50[16], p99[16], pmax[16];
+    format_bucket(p50, sizeof(p50), hist_percentile(hist, hist_total, 0.50));
+    format_bucket(p99, sizeof(p99), hist_percentile(hist, hist_total, 0.99));
+    format_bucket(pmax, sizeof(pmax), max_bucket);
+
+    printf("%-18s %10lu %9.2f %9.2f %9s %9s %9s %9lu %9lu %9lu %9lu\n",
+           s->label, pkts, gap_us, sched_us, p50, p99, pmax,
+           late, skipped, resync, drops);
+}
+#endif
+
+void tx_pacing_print_stats(void)
+{
+#if TX_PACING_STATS_ENABLED
+    uint32_t count = __atomic_load_n(&pacing_block_count, __ATOMIC_RELAXED);
+    if (count > TX_PACING_MAX_BLOCKS)
+        count = TX_PACING_MAX_BLOCKS;
+    struct tx_pacing_overflow *overflow = __atomic_load_n(&pacing_overflow_head, __ATOMIC_ACQUIRE);
+    if (count == 0 && overflow == NULL)
+        return;
+
+    printf("\n=== TX PACING (inter-departure gap vs schedule, last interval) ===\n");
+    printf("%-18s %10s %9s %9s %9s %9s %9s %9s %9s %9s %9s\n",
+           "Worker", "Pkts", "Gap(us)", "Sched(us)", "Dev p50", "Dev p99",
+           "Dev max", "Late", "Skipped", "Resync", "Drops");
+
+    for (uint32_t i = 0; i < count; i++)
+        print_block(&pacing_blocks[i], &pacing_prev[i]);
+    for (struct tx_pacing_overflow *o = overflow; o; o = o->next)
+        print_block(&o->stats, &o->prev);
+#endif
+}
@@ -1,11 +1,20 @@
 #include "tx_rx_manager.h"
 #include "raw_socket_port.h"  // For external packet PRBS verification
+#include "pkt_io.h"           // Burst packet I/O (DPDK backend) + seq/PRBS payload engine
 #include "dpdk_external_tx.h" // For integrated external TX
+#include "tx_pacing_stats.h"   // Inter-departure time telemetry
+#include "traffic_shape.h"     // Pluggable gap tables (Poisson, on/off, ramp, ...)
+#include "raw_latency.h"       // DPDK <-> raw one-way latency samples
+#include "nic_clock.h"         // NIC HW timestamp sources for the latency test
+#include "latency_load.h"      // Latency-under-load sweep (load scaling + probes)
+#include "latency_probe.h"     // Prebuilt probe mbufs + rte_flow probe RX queue
+#include "latency_monitor.h"   // Continuous per-VLAN latency monitor (probes)
 #include <rte_lcore.h>
 #include <rte_launch.h>
 #include <rte_cycles.h>
 #include <rte_ip.h>
 #include <rte_udp.h>
+#include <rte_malloc.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -14,13 +23,17 @@
 // ==========================================
 
 // Global VLAN configuration for all ports
-struct port_vlan_config port_vlans[MAX_PORTS_CONFIG] = PORT_VLAN_CONFIG_INIT;
+struct port_vlan_config port_vlans[] = PORT_VLAN_CONFIG_INIT;
+const uint16_t port_vlans_count = RTE_DIM(port_vlans);
+
+// Per-port tablo boyutu (init_port_tables)
+uint16_t port_table_size = 0;
 
 // Global RX statistics per port
-struct rx_stats rx_stats_per_port[MAX_PORTS];
+struct rx_stats **rx_stats_per_port = NULL;
 
 // Global VL-ID sequence trackers per port (for RX validation)
-struct port_vl_tracker port_vl_trackers[MAX_PORTS];
+struct port_vl_tracker **port_vl_trackers = NULL;
 
 // Per-port, per-VL-ID TX sequence counter
 struct tx_vl_sequence
@@ -29,7 +42,7 @@ struct tx_vl_sequence
     rte_spinlock_t locks[MAX_VL_ID + 1]; // Lock per VL-ID
 };
 
-static struct tx_vl_sequence tx_vl_sequences[MAX_PORTS];
+static struct tx_vl_sequence **tx_vl_sequences = NULL;
 
 // ==========================================
 // VL ID RANGE DEFINITIONS (Port-Aware)
@@ -47,12 +60,16 @@ static struct tx_vl_sequence tx_vl_sequences[MAX_PORTS];
  */
 static void init_tx_vl_sequences(void)
 {
-    for (int port = 0; port < MAX_PORTS; port++)
+    for (int port = 0; port < port_table_size; port++)
     {
+        struct tx_vl_sequence *seq = tx_vl_sequences[port];
+        if (!seq)
+            continue;
+
         for (int vl = 0; vl <= MAX_VL_ID; vl++)
         {
-            tx_vl_sequences[port].sequence[vl] = 0;
-            rte_spinlock_init(&tx_vl_sequences[port].locks[vl]);
+            seq->sequence[vl] = 0;
+            rte_spinlock_init(&seq->locks[vl]);
         }
     }
     printf("TX VL-ID sequence counters initialized\n");
@@ -63,12 +80,13 @@ static void init_tx_vl_sequences(void)
  */
 static inline uint64_t get_next_tx_sequence(uint16_t port_id, uint16_t vl_id)
 {
-    if (vl_id > MAX_VL_ID || port_id >= MAX_PORTS)
+    if (vl_id > MAX_VL_ID || port_id >= port_table_size || !tx_vl_sequences[port_id])
         return 0;
 
-    rte_spinlock_lock(&tx_vl_sequences[port_id].locks[vl_id]);
-    uint64_t seq = tx_vl_sequences[port_id].sequence[vl_id]++;
-    rte_spinlock_unlock(&tx_vl_sequences[port_id].locks[vl_id]);
+    struct tx_vl_sequence *tx_seq = tx_vl_sequences[port_id];
+    rte_spinlock_lock(&tx_seq->locks[vl_id]);
+    uint64_t seq = tx_seq->sequence[vl_id]++;
+    rte_spinlock_unlock(&tx_seq->locks[vl_id]);
 
     return seq;
 }
@@ -92,7 +110,7 @@ static inline uint16_t extract_vl_id_from_packet(uint8_t *pkt_data, uint16_t l2_
  */
 static inline uint16_t get_tx_vl_id_range_start(uint16_t port_id, uint16_t queue_index)
 {
-    if (port_id >= MAX_PORTS_CONFIG)
+    if (port_id >= port_vlans_count)
     {
         printf("Warning: Invalid port_id %u for TX VL ID range start\n", port_id);
         return 3; // Fallback
@@ -121,7 +139,7 @@ static inline uint16_t get_tx_vl_id_range_end(uint16_t port_id, uint16_t queue_i
  */
 static inline uint16_t get_rx_vl_id_range_start(uint16_t port_id, uint16_t queue_index)
 {
-    if (port_id >= MAX_PORTS_CONFIG)
+    if (port_id >= port_vlans_count)
     {
         printf("Warning: Invalid port_id %u for RX VL ID range start\n", port_id);
         return 3; // Fallback
@@ -271,15 +289,15 @@ static inline bool consume_tokens(struct rate_limiter *limiter, uint64_t bytes)
  * - Stagger support via initial token offset
  */
 static void init_ext_rate_limiter_with_stagger(struct rate_limiter *limiter,
-                                                uint32_t rate_mbps,
+                                                uint32_t rate_kbps,
                                                 uint16_t port_id,
                                                 uint16_t queue_id)
 {
     limiter->tsc_hz = rte_get_tsc_hz();
 
-    // bytes/sec - use explicit calculation for Mbps
-    // rate_mbps * 1e6 bits/sec / 8 = bytes/sec
-    limiter->tokens_per_sec = (uint64_t)rate_mbps * 125000ULL;  // 1e6/8 = 125000
+    // bytes/sec - use explicit calculation for kbps
+    // rate_kbps * 1e3 bits/sec / 8 = bytes/sec
+    limiter->tokens_per_sec = (uint64_t)rate_kbps * 125ULL;  // 1e3/8 = 125
 
     // Burst window: ~0.5ms worth of tokens for ULTRA SMOOTH rate limiting
     // 1ms was still causing some loss, 0.5ms = even smaller bursts
@@ -302,15 +320,15 @@ static void init_ext_rate_limiter_with_stagger(struct rate_limiter *limiter,
     limiter->tokens = (limiter->max_tokens * stagger_slot) / 16;
     limiter->last_update = rte_get_tsc_cycles();
 
-    printf("  [ExtRateLimiter] rate=%u Mbps, tokens/s=%lu (%.2f MB/s), bucket=%lu (~0.5ms), stagger=%u/16\n",
-           rate_mbps, limiter->tokens_per_sec, limiter->tokens_per_sec / (1024.0 * 1024.0),
+    printf("  [ExtRateLimiter] rate=%.2f Mbps, tokens/s=%lu (%.2f MB/s), bucket=%lu (~0.5ms), stagger=%u/16\n",
+           rate_kbps / 1000.0, limiter->tokens_per_sec, limiter->tokens_per_sec / (1024.0 * 1024.0),
            limiter->max_tokens, stagger_slot);
 }
 
 // Wrapper for backward compatibility
-static void init_ext_rate_limiter(struct rate_limiter *limiter, uint32_t rate_mbps)
+static void init_ext_rate_limiter(struct rate_limiter *limiter, uint32_t rate_kbps)
 {
-    init_ext_rate_limiter_with_stagger(limiter, rate_mbps, 0, 0);
+    init_ext_rate_limiter_with_stagger(limiter, rate_kbps, 0, 0);
 }
 
 // ==========================================
@@ -320,33 +338,98 @@ static void init_ext_rate_limiter(struct rate_limiter *limiter, uint32_t rate_mb
 void init_vlan_config(void)
 {
     printf("\n=== VLAN Configuration Initialized ===\n");
-    printf("Loaded VLAN configuration for %d ports\n", MAX_PORTS_CONFIG);
+    printf("Loaded VLAN configuration for %u ports\n", port_vlans_count);
+}
+
+int init_port_tables(const struct ports_config *ports_config)
+{
+    uint16_t size = ports_config->port_table_size;
+    if (size == 0)
+        return 0;
+
+    // Pointer tabloları küçük; girdiler portun worker node'unda
+    rx_stats_per_port = rte_zmalloc("rx_stats_tbl", size * sizeof(*rx_stats_per_port), 0);
+    port_vl_trackers = rte_zmalloc("vl_tracker_tbl", size * sizeof(*port_vl_trackers), 0);
+    tx_vl_sequences = rte_zmalloc("tx_vl_seq_tbl", size * sizeof(*tx_vl_sequences), 0);
+    if (!rx_stats_per_port || !port_vl_trackers || !tx_vl_sequences)
+        goto fail;
+    port_table_size = size;
+
+    size_t total = 0;
+    for (uint16_t i = 0; i < ports_config->nb_ports; i++)
+    {
+        uint16_t port_id = ports_config->ports[i].port_id;
+        int socket_id = ports_config->ports[i].worker_numa_node;
+
+        rx_stats_per_port[port_id] = rte_zmalloc_socket("rx_stats", sizeof(struct rx_stats),
+                                                        RTE_CACHE_LINE_SIZE, socket_id);
+        port_vl_trackers[port_id] = rte_zmalloc_socket("vl_trackers", sizeof(struct port_vl_tracker),
+                                                       RTE_CACHE_LINE_SIZE, socket_id);
+        tx_vl_sequences[port_id] = rte_zmalloc_socket("tx_vl_seq", sizeof(struct tx_vl_sequence),
+                                                      RTE_CACHE_LINE_SIZE, socket_id);
+        if (!rx_stats_per_port[port_id] || !port_vl_trackers[port_id] || !tx_vl_sequences[port_id])
+        {
+            printf("Error: Cannot allocate per-port tables for port %u on socket %d\n",
+                   port_id, socket_id);
+            goto fail;
+        }
+        total += sizeof(struct rx_stats) + sizeof(struct port_vl_tracker) + sizeof(struct tx_vl_sequence);
+    }
+
+    printf("Per-port tables: %u slots, %u ports, %.1f KB\n",
+           size, ports_config->nb_ports, total / 1024.0);
+    return 0;
+
+fail:
+    cleanup_port_tables();
+    return -1;
+}
+
+void cleanup_port_tables(void)
+{
+    for (uint16_t i = 0; i < port_table_size; i++)
+    {
+        rte_free(rx_stats_per_port[i]);
+        rte_free(port_vl_trackers[i]);
+        rte_free(tx_vl_sequences[i]);
+    }
+    rte_free(rx_stats_per_port);
+    rte_free(port_vl_trackers);
+    rte_free(tx_vl_sequences);
+    rx_stats_per_port = NULL;
+    port_vl_trackers = NULL;
+    tx_vl_sequences = NULL;
+    port_table_size = 0;
 }
 
 void init_rx_stats(void)
 {
-    for (int i = 0; i < MAX_PORTS; i++)
+    for (int i = 0; i < port_table_size; i++)
     {
+        struct rx_stats *st = rx_stats_per_port[i];
+        if (!st)
+            continue;
+
         // Initialize atomic counters
-        rte_atomic64_init(&rx_stats_per_port[i].total_rx_pkts);
-        rte_atomic64_init(&rx_stats_per_port[i].good_pkts);
-        rte_atomic64_init(&rx_stats_per_port[i].bad_pkts);
-        rte_atomic64_init(&rx_stats_per_port[i].bit_errors);
-        rte_atomic64_init(&rx_stats_per_port[i].out_of_order_pkts);
-        rte_atomic64_init(&rx_stats_per_port[i].lost_pkts);
-        rte_atomic64_init(&rx_stats_per_port[i].duplicate_pkts);
-        rte_atomic64_init(&rx_stats_per_port[i].short_pkts);
-        rte_atomic64_init(&rx_stats_per_port[i].external_pkts);
+        rte_atomic64_init(&st->total_rx_pkts);
+        rte_atomic64_init(&st->good_pkts);
+        rte_atomic64_init(&st->bad_pkts);
+        rte_atomic64_init(&st->bit_errors);
+        rte_atomic64_init(&st->out_of_order_pkts);
+        rte_atomic64_init(&st->lost_pkts);
+        rte_atomic64_init(&st->duplicate_pkts);
+        rte_atomic64_init(&st->short_pkts);
+        rte_atomic64_init(&st->external_pkts);
         // Raw socket RX counters (non-VLAN packets from raw socket ports)
-        rte_atomic64_init(&rx_stats_per_port[i].raw_socket_rx_pkts);
-        rte_atomic64_init(&rx_stats_per_port[i].raw_socket_rx_bytes);
+        rte_atomic64_init(&st->raw_socket_rx_pkts);
+        rte_atomic64_init(&st->raw_socket_rx_bytes);
 
         // Initialize VL-ID sequence trackers (lock-free, watermark-based)
         for (int vl = 0; vl <= MAX_VL_ID; vl++)
         {
-            port_vl_trackers[i].vl_trackers[vl].max_seq = 0;
-            port_vl_trackers[i].vl_trackers[vl].pkt_count = 0;
-            port_vl_trackers[i].vl_trackers[vl].initialized = 0;  // 0=false, 1=true
+            port_vl_trackers[i]->vl_trackers[vl].max_seq = 0;
+            port_vl_trackers[i]->vl_trackers[vl].pkt_count = 0;
+            port_vl_trackers[i]->vl_trackers[vl].initialized = 0;  // 0=false, 1=true
         }
     }
     printf("RX statistics and VL-ID sequence trackers initialized for all ports\n");
@@ -357,7 +440,7 @@ void init_rx_stats(void)
 
 uint16_t get_tx_vlan_for_queue(uint16_t port_id, uint16_t queue_id)
 {
-    if (port_id >= MAX_PORTS_CONFIG)
+    if (port_id >= port_vlans_count)
     {
         printf("Error: Invalid port_id %u for TX VLAN lookup\n", port_id);
         return 100;
@@ -375,7 +458,7 @@ uint16_t get_tx_vlan_for_queue(uint16_t port_id, uint16_t queue_id)
 
 uint16_t get_rx_vlan_for_queue(uint16_t port_id, uint16_t queue_id)
 {
-    if (port_id >= MAX_PORTS_CONFIG)
+    if (port_id >= port_vlans_count)
     {
         printf("Error: Invalid port_id %u for RX VLAN lookup\n", port_id);
         return 100;
@@ -393,7 +476,7 @@ uint16_t get_rx_vlan_for_queue(uint16_t port_id, uint16_t queue_id)
 
 uint16_t get_tx_vl_id_for_queue(uint16_t port_id, uint16_t queue_id)
 {
-    if (port_id >= MAX_PORTS_CONFIG)
+    if (port_id >= port_vlans_count)
     {
         printf("Error: Invalid port_id %u for TX VL ID lookup\n", port_id);
         return 0;
@@ -411,7 +494,7 @@ uint16_t get_tx_vl_id_for_queue(uint16_t port_id, uint16_t queue_id)
 
 uint16_t get_rx_vl_id_for_queue(uint16_t port_id, uint16_t queue_id)
 {
-    if (port_id >= MAX_PORTS_CONFIG)
+    if (port_id >= port_vlans_count)
     {
         printf("Error: Invalid port_id %u for RX VL ID lookup\n", port_id);
         return 0;
@@ -433,7 +516,7 @@ void print_vlan_config(void)
     printf("Her port icin tx_vl_ids ve rx_vl_ids config'den okunur.\n");
     printf("Her queue icin %u VL-ID aralik boyutu vardir.\n\n", VL_RANGE_SIZE_PER_QUEUE);
 
-    for (uint16_t port = 0; port < MAX_PORTS_CONFIG; port++)
+    for (uint16_t port = 0; port < port_vlans_count; port++)
     {
         if (port_vlans[port].tx_vlan_count == 0 && port_vlans[port].rx_vlan_count == 0)
         {
@@ -616,6 +699,9 @@ int init_port_txrx(uint16_t port_id, struct txrx_config *config)
 
     port_conf.txmode.mq_mode = RTE_ETH_MQ_TX_NONE;
 
+    // Latency testi için NIC RX timestamp (destekleniyorsa)
+    nic_clock_port_conf(port_id, &dev_info, &port_conf);
+
     ret = rte_eth_dev_configure(
         port_id,
         config->nb_rx_queues,
@@ -663,6 +749,11 @@ int init_port_txrx(uint16_t port_id, struct txrx_config *config)
         return ret;
     }
 
+    nic_clock_port_start(port_id);
+
+    // Probe kuyruğu (en sondaki) RSS dağılımına girmez, sadece flow kuralıyla dolar
+    const uint16_t nb_rss_queues = config->nb_rx_queues - LATENCY_PROBE_RX_QUEUES;
+
     if (config->nb_rx_queues > 1)
     {
         struct rte_eth_rss_reta_entry64 reta_conf[16];
@@ -672,7 +763,7 @@ int init_port_txrx(uint16_t port_id, struct txrx_config *config)
         if (reta_size > 0)
         {
             printf("Port %u: Configuring RETA (size: %u) for %u queues\n",
-                   port_id, reta_size, config->nb_rx_queues);
+                   port_id, reta_size, nb_rss_queues);
 
             for (uint16_t i = 0; i < reta_size; i++)
             {
@@ -684,7 +775,7 @@ int init_port_txrx(uint16_t port_id, struct txrx_config *config)
                     reta_conf[idx].mask = ~0ULL;
                 }
 
-                reta_conf[idx].reta[shift] = i % config->nb_rx_queues;
+                reta_conf[idx].reta[shift] = i % nb_rss_queues;
             }
 
             ret = rte_eth_dev_rss_reta_update(port_id, reta_conf, reta_size);
@@ -768,15 +859,22 @@ void print_port_stats(struct ports_config *ports_config)
 #define TX_WAIT_FOR_RX_FLUSH_MS 5000   // RX sayaclarinin guncellenmesi icin bekleme suresi (ms)
 
 // Per-port TX packet counter (thread-safe)
-static rte_atomic64_t tx_packet_count_per_port[MAX_PORTS];
+static rte_atomic64_t *tx_packet_count_per_port = NULL;
 
 // Flag to ensure only one worker triggers the shutdown sequence
 static volatile int tx_shutdown_triggered = 0;
 
 // Initialize TX test counters
-static void init_tx_test_counters(void)
+static int init_tx_test_counters(void)
 {
-    for (int i = 0; i < MAX_PORTS; i++)
+    if (!tx_packet_count_per_port)
+    {
+        tx_packet_count_per_port = rte_zmalloc("tx_test_cnt",
+                                               RTE_MAX(port_table_size, 1) * sizeof(rte_atomic64_t), 0);
+        if (!tx_packet_count_per_port)
+            return -1;
+    }
+    for (int i = 0; i < port_table_size; i++)
     {
         rte_atomic64_init(&tx_packet_count_per_port[i]);
     }
@@ -785,12 +883,162 @@ static void init_tx_test_counters(void)
            TX_SKIP_EVERY_N_PACKETS, TX_MAX_PACKETS_PER_PORT);
     printf("TX Test Mode: Will wait %d ms for RX counters to flush before stopping\n",
            TX_WAIT_FOR_RX_FLUSH_MS);
+    return 0;
+}
+
+#if DPDK_EXT_TX_ENABLED
+// ==========================================
+// EXTERNAL TX CLASS (inline, tx_worker içinde)
+// ==========================================
+// Ext hedefi ana trafikle aynı queue'dan, ayrı zamanlama (ext_limiter rate'i,
+// byte bazlı gap) ve ayrı sequence alanı ile gönderilir. Ana sınıfın slot
+// beklemesi sırasında yoklanır; ext slot'u geldiyse araya tek paket girer.
+// No-catch-up kuralı burada da geçerli.
+
+#define TX_EXT_STATS_FLUSH 1024
+
+struct tx_ext_class {
+    uint64_t next_send_time;        // UINT64_MAX = henüz armed değil
+    uint64_t cycles_per_byte_q16;   // Q16 fixed-point
+    uint64_t avg_gap;               // Atlanan slot / resync sayımı için
+    uint64_t max_gap;               // No-catch-up eşiği (en uzun paket)
+    uint64_t stagger;
+    const uint8_t *prbs_cache;
+    struct tx_pacing_stats *pacing;
+    uint16_t vl_offset;
+#if IMIX_ENABLED
+    uint8_t imix_offset;
+    uint64_t imix_counter;
+#endif
+    uint64_t local_pkts;            // Henüz flush edilmemiş sayaçlar
+    uint64_t local_bytes;
+};
+
+static bool tx_ext_class_init(struct tx_ext_class *ext, struct tx_worker_params *params,
+                              uint64_t tsc_hz)
+{
+    memset(ext, 0, sizeof(*ext));
+    ext->next_send_time = UINT64_MAX;
+
+    if (!params->ext_tx_enabled)
+        return true;
+
+    ext->prbs_cache = get_prbs_cache_ext_for_port(params->port_id);
+    if (ext->prbs_cache == NULL || params->ext_vl_id_count == 0 ||
+        params->ext_limiter.tokens_per_sec == 0) {
+        printf("Error: External TX class unusable on port %u queue %u\n",
+               params->port_id, params->queue_id);
+        return false;
+    }
+
+#if IMIX_ENABLED
+    const uint64_t avg_size = IMIX_AVG_PACKET_SIZE;
+    const uint64_t max_size = IMIX_MAX_PACKET_SIZE;
+    ext->imix_offset = (uint8_t)((params->port_id * 4 + params->ext_target_idx) % IMIX_PATTERN_SIZE);
+#else
+    const uint64_t avg_size = PACKET_SIZE_VLAN;
+    const uint64_t max_size = PACKET_SIZE_VLAN;
+#endif
+    ext->cycles_per_byte_q16 = (tsc_hz << 16) / params->ext_limiter.tokens_per_sec;
+    ext->avg_gap = (avg_size * ext->cycles_per_byte_q16) >> 16;
+    ext->max_gap = (max_size * ext->cycles_per_byte_q16) >> 16;
+    if (ext->avg_gap == 0)
+        ext->avg_gap = 1;
+
+    // Stagger: port başına 50ms (dedicated worker ile aynı) + hedef başına 5ms
+    ext->stagger = params->ext_port_idx * (tsc_hz / 20) + params->ext_target_idx * (tsc_hz / 200);
+
+    char label[TX_PACING_LABEL_LEN];
+    snprintf(label, sizeof(label), "ExtTX P%u Q%u", params->port_id, params->queue_id);
+    ext->pacing = tx_pacing_register(label, tsc_hz);
+
+    printf("  -> Ext class: VLAN %u, VL-ID [%u..%u), %.2f Mbps, %.1f us/paket (avg)\n",
+           params->ext_vlan_id, params->ext_vl_id_start,
+           params->ext_vl_id_start + params->ext_vl_id_count,
+           params->ext_limiter.tokens_per_sec * 8 / 1000000.0,
+           (double)ext->avg_gap * 1000000.0 / (double)tsc_hz);
+    return true;
 }
 
+static void tx_ext_class_flush(struct tx_worker_params *params, struct tx_ext_class *ext)
+{
+    if (ext->local_pkts == 0)
+        return;
+    dpdk_ext_tx_account(params->ext_port_idx, params->ext_target_idx,
+                        ext->local_pkts, ext->local_bytes);
+    ext->local_pkts = 0;
+    ext->local_bytes = 0;
+}
+
+/**
+ * Send one external packet if its slot is due. Called from the main pacing
+ * wait loops and once per main iteration.
+ */
+static inline void tx_ext_class_poll(struct tx_worker_params *params, struct tx_ext_class *ext,
+                                     struct pkt_io_port *io, uint64_t now)
+{
+    if (likely(!params->ext_tx_enabled))
+        return;
+
+    if (now < ext->next_send_time) {
+        // Raw socket RX hazır olana kadar bekle, sonra stagger ile başla
+        if (unlikely(ext->next_send_time == UINT64_MAX) && dpdk_ext_tx_inline_armed())
+            ext->next_send_time = now + ext->stagger;
+        return;
+    }
+
+    if (ext->next_send_time + ext->max_gap < now) {
+        tx_pacing_record_resync(ext->pacing, (now - ext->next_send_time) / ext->avg_gap);
+        ext->next_send_time = now;
+    }
+    const uint64_t slot_time = ext->next_send_time;
+
+    struct pkt_io_buf b;
+    if (unlikely(pkt_io_tx_alloc(io, &b, 1) == 0)) {
+        ext->next_send_time += ext->avg_gap;
+        tx_pacing_record_skip(ext->pacing);
+        return;
+    }
+
+#if IMIX_ENABLED
+    const uint16_t pkt_size = get_imix_packet_size(ext->imix_counter, ext->imix_offset);
+    ext->imix_counter++;
+#else
+    const uint16_t pkt_size = PACKET_SIZE_VLAN;
+#endif
+    ext->next_send_time += (pkt_size * ext->cycles_per_byte_q16) >> 16;
+
+    uint16_t vl = params->ext_vl_id_start + ext->vl_offset;
+    if (++ext->vl_offset >= params->ext_vl_id_count)
+        ext->vl_offset = 0;
+
+    uint64_t seq = dpdk_ext_tx_next_sequence(params->ext_port_idx, vl);
+    b.len = dpdk_ext_tx_build_frame(b.data, params->port_id, params->ext_vlan_id, vl, seq,
+                                    pkt_size, ext->prbs_cache);
+
+    const uint64_t depart_time = rte_get_tsc_cycles();
+    if (unlikely(pkt_io_tx_burst(io, &b, 1) == 0)) {
+        tx_pacing_record_drop(ext->pacing);
+        return;
+    }
+    tx_pacing_record_departure(ext->pacing, slot_time, depart_time);
+#if RAW_SOCKET_TIMESTAMPING
+    if (raw_lat_sampled(seq))
+        raw_lat_tx_sample(vl, seq, raw_lat_now_ns());
+#endif
+
+    ext->local_pkts++;
+    ext->local_bytes += pkt_size;
+    if (ext->local_pkts >= TX_EXT_STATS_FLUSH)
+        tx_ext_class_flush(params, ext);
+}
+#endif /* DPDK_EXT_TX_ENABLED */
+
 int tx_worker(void *arg)
 {
     struct tx_worker_params *params = (struct tx_worker_params *)arg;
-    struct rte_mbuf *pkt;  // Tek paket modu (burst yerine)
+    struct pkt_io_buf buf[1];  // Tek paket modu (burst yerine)
+    struct rte_mbuf *pkt;
     bool first_pkt_sent = false;
 
 #if VLAN_ENABLED
@@ -799,7 +1047,7 @@ int tx_worker(void *arg)
     const uint16_t l2_len = sizeof(struct rte_ether_hdr);
 #endif
 
-    if (params->port_id >= MAX_PRBS_CACHE_PORTS)
+    if (params->port_id >= port_prbs_cache_count)
     {
         printf("Error: Invalid port_id %u in TX worker\n", params->port_id);
         return -1;
@@ -816,6 +1064,13 @@ int tx_worker(void *arg)
     const uint16_t vl_end = get_tx_vl_id_range_end(params->port_id, params->queue_id);
     const uint16_t vl_range_size = get_vl_id_range_size(); // Her zaman 128
 
+    // Probe yolu kullanılıyorsa aralığın son VL-ID'si probe'lara ayrılmış
+#if LATENCY_TEST_ENABLED
+    const uint16_t vl_wrap = latency_probe_tx_vl_wrap(vl_range_size);
+#else
+    const uint16_t vl_wrap = vl_range_size;
+#endif
+
 #if IMIX_ENABLED
     // IMIX: Worker-specific offset for pattern rotation (hybrid shuffle)
     const uint8_t imix_offset = (uint8_t)((params->port_id * 4 + params->queue_id) % IMIX_PATTERN_SIZE);
@@ -845,6 +1100,44 @@ int tx_worker(void *arg)
     uint64_t stagger_offset = stagger_slot * (tsc_hz / 200);  // 5ms per slot
     uint64_t next_send_time = rte_get_tsc_cycles() + stagger_offset;
 
+    // ==========================================
+    // TRAFFIC SHAPE: gap tablosu (worker'ın NUMA node'unda)
+    // ==========================================
+    const struct tx_shape_config *shape_cfg = tx_shape_lookup(params->port_id, params->queue_id);
+    struct tx_shape_table *shape = tx_shape_build(shape_cfg, delay_cycles, tsc_hz,
+                                                  ((uint64_t)params->port_id << 16) | params->queue_id,
+                                                  (int)rte_socket_id());
+    if (shape == NULL)
+    {
+        printf("Error: Cannot build traffic shape table for port %u queue %u\n",
+               params->port_id, params->queue_id);
+        return -1;
+    }
+    struct tx_shape_cursor shape_cur;
+    tx_shape_cursor_init(&shape_cur, shape);
+    const bool shape_token_bucket = (shape_cfg->type == TX_SHAPE_TOKEN_BUCKET);
+
+    char pacing_label[TX_PACING_LABEL_LEN];
+    snprintf(pacing_label, sizeof(pacing_label), "TX P%u Q%u", params->port_id, params->queue_id);
+    struct tx_pacing_stats *pacing = tx_pacing_register(pacing_label, tsc_hz);
+
+    // Normal trafik ve inline ext sınıfı aynı queue'dan (NIC almazsa mbuf pkt_io'da bırakılır)
+    struct pkt_io_port io;
+    pkt_io_init_dpdk(&io, params->port_id, params->queue_id, params->mbuf_pool);
+
+#if DPDK_EXT_TX_ENABLED
+    // İkinci trafik sınıfı: bu queue'ya atanmış external TX hedefi
+    struct tx_ext_class ext;
+    if (!tx_ext_class_init(&ext, params, tsc_hz))
+    {
+        tx_shape_free(shape);
+        return -1;
+    }
+#define TX_EXT_POLL(now) tx_ext_class_poll(params, &ext, &io, (now))
+#else
+#define TX_EXT_POLL(now) do { } while (0)
+#endif
+
     printf("TX Worker started: Port %u, Queue %u, Lcore %u, VLAN %u, VL_RANGE [%u..%u)\n",
            params->port_id, params->queue_id, params->lcore_id, params->vlan_id, vl_start, vl_end);
 #if IMIX_ENABLED
@@ -856,6 +1149,7 @@ int tx_worker(void *arg)
 #endif
     printf("  -> Pacing: %.1f us/paket (%.0f paket/s), stagger=%ums\n",
            inter_packet_us, (double)packets_per_sec, (unsigned)(stagger_offset * 1000 / tsc_hz));
+    tx_shape_print(shape, tsc_hz);
     printf("  VL-ID Based Sequence: Each VL-ID has independent sequence counter\n");
     printf("  Strategy: Round-robin through ALL VL-IDs in range (%u VL-IDs)\n", vl_range_size);
 
@@ -870,6 +1164,25 @@ int tx_worker(void *arg)
     // Local packet counter for this worker
     uint64_t local_pkt_counter = 0;
 
+    if (shape_token_bucket)
+    {
+        // Bucket derinliği en az bir MAX paket olmalı, yoksa hiç gönderilemez
+        params->limiter.max_tokens = shape_cfg->bucket_depth;
+        if (params->limiter.max_tokens < IMIX_MAX_PACKET_SIZE)
+            params->limiter.max_tokens = IMIX_MAX_PACKET_SIZE;
+#if LATENCY_LOAD_TEST_ENABLED
+        // Düşük yük seviyesinde paket maliyeti ölçeklenir, bucket yine sığdırmalı
+        if (params->limiter.max_tokens < IMIX_MAX_PACKET_SIZE * 100ULL / LATENCY_LOAD_MIN_PCT)
+            params->limiter.max_tokens = IMIX_MAX_PACKET_SIZE * 100ULL / LATENCY_LOAD_MIN_PCT;
+#endif
+
+        // Stagger süresince token biriktirme (soft start korunur)
+        while (rte_get_tsc_cycles() < next_send_time && !(*params->stop_flag))
+            rte_pause();
+        params->limiter.tokens = 0;
+        params->limiter.last_update = rte_get_tsc_cycles();
+    }
+
     while (!(*params->stop_flag))
     {
 #if TX_TEST_MODE_ENABLED
@@ -894,35 +1207,75 @@ int tx_worker(void *arg)
         }
 #endif
 
-        // ==========================================
-        // SMOOTH PACING: Her paket tam zamanında gönderilir
-        // Burst YOK - trafik 1 saniyeye eşit yayılır
-        // ==========================================
-        uint64_t now = rte_get_tsc_cycles();
+#if IMIX_ENABLED
+        // IMIX: Paket boyutunu pattern'den al (token bucket byte bazlı çalışır)
+        uint16_t pkt_size = get_imix_packet_size(imix_counter, imix_offset);
+#else
+        const uint16_t pkt_size = PACKET_SIZE;
+#endif
+        uint64_t slot_time;
 
-        // Zamanı gelene kadar bekle (busy-wait for precision)
-        while (now < next_send_time) {
-            rte_pause();
-            now = rte_get_tsc_cycles();
+        if (unlikely(shape_token_bucket))
+        {
+            // TOKEN BUCKET: greedy gönderim, geride kalınca bucket_depth
+            // byte'a kadar catch-up burst'ü yapılır
+#if LATENCY_LOAD_TEST_ENABLED
+            const uint64_t pkt_cost = latency_load_scale(params->port_id, pkt_size);
+#else
+            const uint64_t pkt_cost = pkt_size;
+#endif
+            while (!consume_tokens(&params->limiter, pkt_cost))
+            {
+                if (*params->stop_flag)
+                    goto tx_exit;
+                TX_EXT_POLL(rte_get_tsc_cycles());
+                rte_pause();
+            }
+            slot_time = rte_get_tsc_cycles();
         }
+        else
+        {
+            // ==========================================
+            // SMOOTH PACING: Her paket tablodaki gap ile zamanlanır
+            // CONSTANT shape'te trafik 1 saniyeye eşit yayılır
+            // ==========================================
+            uint64_t now = rte_get_tsc_cycles();
+
+            // Zamanı gelene kadar bekle (busy-wait for precision)
+            // Beklerken zamanı gelen ext paketi araya girer
+            while (now < next_send_time) {
+                TX_EXT_POLL(now);
+                rte_pause();
+                now = rte_get_tsc_cycles();
+            }
+            TX_EXT_POLL(now);
 
-        // Geride kalırsak CATCH-UP YAPMA (burst önleme)
-        if (next_send_time + delay_cycles < now) {
-            next_send_time = now;
+            // Geride kalırsak CATCH-UP YAPMA (burst önleme)
+            // Eşik: tablodaki en büyük gap (CONSTANT'ta delay_cycles)
+            if (next_send_time + shape->resync_gap < now) {
+                tx_pacing_record_resync(pacing, (now - next_send_time) / delay_cycles);
+                next_send_time = now;
+            }
+            slot_time = next_send_time;
+#if LATENCY_LOAD_TEST_ENABLED
+            next_send_time += latency_load_scale(params->port_id, tx_shape_next_gap(&shape_cur));
+#else
+            next_send_time += tx_shape_next_gap(&shape_cur);
+#endif
         }
-        next_send_time += delay_cycles;
 
         // Tek paket tahsisi
-        pkt = rte_pktmbuf_alloc(params->mbuf_pool);
-        if (unlikely(pkt == NULL)) {
+        if (unlikely(pkt_io_tx_alloc(&io, buf, 1) == 0)) {
+            tx_pacing_record_skip(pacing);
             continue;  // Timing korundu, sadece bu slot'u atla
         }
+        pkt = (struct rte_mbuf *)buf[0].handle;
 
 #if TX_TEST_MODE_ENABLED
         uint64_t port_count = rte_atomic64_read(&tx_packet_count_per_port[params->port_id]);
         if (port_count >= TX_MAX_PACKETS_PER_PORT)
         {
-            rte_pktmbuf_free(pkt);
+            pkt_io_tx_free(&io, buf, 1);
             continue;
         }
         uint64_t pkt_num = rte_atomic64_add_return(&tx_packet_count_per_port[params->port_id], 1);
@@ -935,9 +1288,9 @@ int tx_worker(void *arg)
         {
             printf("TX Worker Port %u: SKIPPING packet #%lu (VL %u, seq %lu)\n",
                    params->port_id, pkt_num, curr_vl, seq);
-            rte_pktmbuf_free(pkt);
+            pkt_io_tx_free(&io, buf, 1);
             current_vl_offset++;
-            if (current_vl_offset >= vl_range_size)
+            if (current_vl_offset >= vl_wrap)
                 current_vl_offset = 0;
             continue;
         }
@@ -960,8 +1313,6 @@ int tx_worker(void *arg)
                                 (uint32_t)(curr_vl & 0xFF));
 
 #if IMIX_ENABLED
-        // IMIX: Paket boyutunu pattern'den al
-        uint16_t pkt_size = get_imix_packet_size(imix_counter, imix_offset);
         uint16_t prbs_len = calc_prbs_size(pkt_size);
         imix_counter++;
 
@@ -973,8 +1324,10 @@ int tx_worker(void *arg)
         fill_payload_with_prbs31(pkt, params->port_id, seq, l2_len);
 #endif
 
-        // Tek paket gönder
-        uint16_t nb_tx = rte_eth_tx_burst(params->port_id, params->queue_id, &pkt, 1);
+        // Tek paket gönder (build_* mbuf uzunluğunu yazdı)
+        buf[0].len = pkt->pkt_len;
+        const uint64_t depart_time = rte_get_tsc_cycles();
+        uint16_t nb_tx = pkt_io_tx_burst(&io, buf, 1);
 
         if (unlikely(!first_pkt_sent && nb_tx > 0))
         {
@@ -985,14 +1338,35 @@ int tx_worker(void *arg)
 
         if (unlikely(nb_tx == 0))
         {
-            rte_pktmbuf_free(pkt);
+            tx_pacing_record_drop(pacing);
+        }
+        else
+        {
+            tx_pacing_record_departure(pacing, slot_time, depart_time);
         }
 
+#if LATENCY_LOAD_TEST_ENABLED
+        // Probe aynı queue'dan, arka plan trafiğinin arasına girer
+        if (params->queue_id == 0 && unlikely(latency_load_probe_due(params->port_id, depart_time)))
+            latency_load_send_probe(params, depart_time);
+#endif
+#if LATENCY_MONITOR_ENABLED
+        if (params->queue_id == 0 && unlikely(latency_monitor_probe_due(params->port_id, depart_time)))
+            latency_monitor_send_probe(params, depart_time);
+#endif
+
         current_vl_offset++;
-        if (current_vl_offset >= vl_range_size)
+        if (current_vl_offset >= vl_wrap)
             current_vl_offset = 0;
     }
 
+tx_exit:
+    tx_shape_free(shape);
+#if DPDK_EXT_TX_ENABLED
+    tx_ext_class_flush(params, &ext);
+#endif
+#undef TX_EXT_POLL
+
 #if TX_TEST_MODE_ENABLED
     printf("TX Worker stopped: Port %u, Queue %u (sent %lu packets locally, port total: %lu)\n",
            params->port_id, params->queue_id, local_pkt_counter,
@@ -1014,7 +1388,7 @@ int tx_worker(void *arg)
  */
 static inline bool is_valid_tx_vl_id_for_source_port(uint16_t vl_id, uint16_t src_port_id)
 {
-    if (src_port_id >= MAX_PORTS_CONFIG)
+    if (src_port_id >= port_vlans_count)
         return false;
 
     // Check all TX queues for source port
@@ -1035,9 +1409,9 @@ static inline bool is_valid_tx_vl_id_for_source_port(uint16_t vl_id, uint16_t sr
  */
 static inline struct raw_socket_port* find_raw_socket_port_by_vl_id(uint16_t vl_id)
 {
-    for (int p = 0; p < MAX_RAW_SOCKET_PORTS; p++)
+    for (int p = 0; p < raw_port_count; p++)
     {
-        struct raw_socket_port *port = &raw_ports[p];
+        struct raw_socket_port *port = raw_ports[p];
         if (!port->prbs_initialized)
             continue;
 
@@ -1058,7 +1432,7 @@ static inline struct raw_socket_port* find_raw_socket_port_by_vl_id(uint16_t vl_
 int rx_worker(void *arg)
 {
     struct rx_worker_params *params = (struct rx_worker_params *)arg;
-    struct rte_mbuf *pkts[BURST_SIZE];
+    struct pkt_io_buf bufs[BURST_SIZE];
     bool first_packet_received = false;
 
     // L2 header lengths for dynamic detection
@@ -1069,7 +1443,7 @@ int rx_worker(void *arg)
     const uint32_t min_len_vlan = l2_len_vlan + 20 + 8 + SEQ_BYTES + NUM_PRBS_BYTES;      // 1509
     const uint32_t min_len_novlan = l2_len_novlan + 20 + 8 + SEQ_BYTES + NUM_PRBS_BYTES;  // 1505
 
-    if (params->src_port_id >= MAX_PRBS_CACHE_PORTS)
+    if (params->src_port_id >= port_prbs_cache_count)
     {
         printf("Error: Invalid src_port_id %u\n", params->src_port_id);
         return -1;
@@ -1104,16 +1478,28 @@ int rx_worker(void *arg)
     bool first_raw_rx = false;  // Track first raw socket packet
 
     // Get VL-ID tracker for this port
-    struct port_vl_tracker *vl_tracker = &port_vl_trackers[params->port_id];
+    struct port_vl_tracker *vl_tracker = port_vl_trackers[params->port_id];
 
     const uint16_t INNER_LOOPS = 8;
 
+    struct pkt_io_port io;
+    pkt_io_init_dpdk(&io, params->port_id, params->queue_id, NULL);
+
+#if LATENCY_TEST_ENABLED
+    // Probe kuyruğunu queue 0 worker'ı boşaltır (flow kuralı varsa)
+    const bool poll_probe_queue = params->queue_id == 0 && latency_probe_flow_active(params->port_id);
+#endif
+
     while (!(*params->stop_flag))
     {
+#if LATENCY_TEST_ENABLED
+        if (poll_probe_queue)
+            latency_probe_rx_poll(params->port_id, params->src_port_id);
+#endif
+
         for (int iter = 0; iter < INNER_LOOPS; iter++)
         {
-            uint16_t nb_rx = rte_eth_rx_burst(params->port_id, params->queue_id,
-                                              pkts, BURST_SIZE);
+            uint16_t nb_rx = pkt_io_rx_burst(&io, bufs, BURST_SIZE);
 
             if (unlikely(nb_rx == 0))
                 continue;
@@ -1129,15 +1515,16 @@ int rx_worker(void *arg)
             // Aggressive prefetch
             for (uint16_t i = 0; i + 7 < nb_rx; i++)
             {
-                rte_prefetch0(rte_pktmbuf_mtod(pkts[i + 4], void *));
-                rte_prefetch0(rte_pktmbuf_mtod(pkts[i + 7], void *));
+                rte_prefetch0(bufs[i + 4].data);
+                rte_prefetch0(bufs[i + 7].data);
             }
 
             // Process packets
             for (uint16_t i = 0; i < nb_rx; i++)
             {
-                struct rte_mbuf *m = pkts[i];
-                uint8_t *pkt = rte_pktmbuf_mtod(m, uint8_t *);
+                // mbuf: uzunluk, NIC timestamp ve probe hook'ları için
+                struct rte_mbuf *m = (struct rte_mbuf *)bufs[i].handle;
+                uint8_t *pkt = bufs[i].data;
 
                 // ==========================================
                 // DYNAMIC PACKET TYPE DETECTION
@@ -1189,53 +1576,26 @@ int rx_worker(void *arg)
                     {
                         // Get sequence number from payload
                         uint64_t raw_seq = *(uint64_t *)(pkt + raw_payload_off);
+#if RAW_SOCKET_TIMESTAMPING
+                        // raw -> DPDK: RX zamanı worker'ın paketi gördüğü an (host saati)
+                        if (raw_lat_sampled(raw_seq))
+                            raw_lat_rx_sample(raw_vl_id, raw_seq, raw_lat_now_ns());
+#endif
 
-#if IMIX_ENABLED
-                        // IMIX: PRBS offset hesabı HEP MAX_PRBS_BYTES ile yapılır
-                        // PRBS boyutu paket boyutundan hesaplanır
-                        uint16_t raw_prbs_len = m->pkt_len - l2_len_novlan - 20 - 8 - RAW_PKT_SEQ_BYTES;
-                        if (raw_prbs_len > MAX_PRBS_BYTES) raw_prbs_len = MAX_PRBS_BYTES;
-
-                        uint64_t prbs_offset = (raw_seq * (uint64_t)MAX_PRBS_BYTES) % 268435456ULL;
-                        uint8_t *expected_prbs = raw_port->prbs_cache_ext + prbs_offset;
-                        uint8_t *recv_prbs = pkt + raw_payload_off + RAW_PKT_SEQ_BYTES;
-
-                        // Compare PRBS data (dinamik boyut)
-                        if (memcmp(recv_prbs, expected_prbs, raw_prbs_len) == 0)
-                        {
-                            local_good++;
-                        }
-                        else
-                        {
-                            local_bad++;
-                            // Count bit errors
-                            for (uint32_t b = 0; b < raw_prbs_len; b++)
-                            {
-                                local_bits += __builtin_popcount(recv_prbs[b] ^ expected_prbs[b]);
-                            }
-                        }
-#else
-                        // Calculate PRBS offset (same formula as raw_socket_port.c)
-                        // RAW_PRBS_CACHE_SIZE = 268435456 (256MB)
-                        uint64_t prbs_offset = (raw_seq * (uint64_t)RAW_PKT_PRBS_BYTES) % 268435456ULL;
-                        uint8_t *expected_prbs = raw_port->prbs_cache_ext + prbs_offset;
-                        uint8_t *recv_prbs = pkt + raw_payload_off + RAW_PKT_SEQ_BYTES;
-
-                        // Compare PRBS data
-                        if (memcmp(recv_prbs, expected_prbs, RAW_PKT_PRBS_BYTES) == 0)
+                        // Üretici raw port: stride RAW_PKT_PRBS_BYTES, boyut paketten (IMIX)
+                        uint64_t bit_err = pkt_payload_verify(pkt + raw_payload_off + RAW_PKT_SEQ_BYTES,
+                                                              m->pkt_len - raw_payload_off - RAW_PKT_SEQ_BYTES,
+                                                              raw_seq, raw_port->prbs_cache_ext,
+                                                              RAW_PKT_PRBS_BYTES);
+                        if (bit_err == 0)
                         {
                             local_good++;
                         }
                         else
                         {
                             local_bad++;
-                            // Count bit errors
-                            for (uint32_t b = 0; b < RAW_PKT_PRBS_BYTES; b++)
-                            {
-                                local_bits += __builtin_popcount(recv_prbs[b] ^ expected_prbs[b]);
-                            }
+                            local_bits += bit_err;
                         }
-#endif
 
                         // Sequence tracking for raw socket packets
                         if (raw_vl_id <= MAX_VL_ID)
@@ -1306,6 +1666,27 @@ int rx_worker(void *arg)
                 //  Extract VL-ID from DST MAC (last 2 bytes)
                 uint16_t vl_id = extract_vl_id_from_packet(pkt, l2_len_vlan);
 
+#if LATENCY_LOAD_TEST_ENABLED
+                // Latency-under-load probe'u: PRBS/sequence kontrolüne girmez
+                if (unlikely(latency_load_is_probe(params->src_port_id, vl_id)))
+                {
+                    latency_load_rx_probe(params->port_id, params->src_port_id, m, payload_off);
+                    continue;
+                }
+#endif
+#if LATENCY_MONITOR_ENABLED
+                // Monitor probe'u: PRBS/sequence kontrolüne girmez
+                {
+                    int probe_vlan = latency_monitor_probe_vlan(params->src_port_id, vl_id);
+                    if (unlikely(probe_vlan >= 0))
+                    {
+                        latency_monitor_rx_probe(params->port_id, params->src_port_id,
+                                                 (uint16_t)probe_vlan, m, payload_off);
+                        continue;
+                    }
+                }
+#endif
+
                 // ==========================================
                 // VL-ID RANGE CHECK - External packet detection
                 // If VL-ID doesn't match what the source port (paired DPDK port)
@@ -1322,56 +1703,20 @@ int rx_worker(void *arg)
                         // Get sequence number from payload
                         uint64_t ext_seq = *(uint64_t *)(pkt + payload_off);
 
-#if IMIX_ENABLED
-                        // IMIX: PRBS offset hesabı HEP MAX_PRBS_BYTES ile yapılır
-                        // PRBS boyutu paket boyutundan hesaplanır
-                        uint16_t ext_prbs_len = m->pkt_len - l2_len_vlan - 20 - 8 - SEQ_BYTES;
-                        if (ext_prbs_len > MAX_PRBS_BYTES) ext_prbs_len = MAX_PRBS_BYTES;
-
-                        uint64_t prbs_offset = (ext_seq * (uint64_t)MAX_PRBS_BYTES) % 268435456ULL;
-                        uint8_t *expected_prbs = raw_port->prbs_cache_ext + prbs_offset;
-                        uint8_t *recv_prbs = pkt + payload_off + SEQ_BYTES;
-
-                        // Compare PRBS data (dinamik boyut)
-                        if (memcmp(recv_prbs, expected_prbs, ext_prbs_len) == 0)
-                        {
-                            local_good++;
-                        }
-                        else
-                        {
-                            local_bad++;
-                            // Count bit errors
-                            for (uint32_t i = 0; i < ext_prbs_len; i++)
-                            {
-                                local_bits += __builtin_popcount(recv_prbs[i] ^ expected_prbs[i]);
-                            }
-                        }
-#else
-                        // Calculate PRBS offset (same formula as raw_socket_port.c)
-                        // RAW_PRBS_CACHE_SIZE = 268435456 (256MB)
-                        uint64_t prbs_offset = (ext_seq * (uint64_t)RAW_PKT_PRBS_BYTES) % 268435456ULL;
-                        uint8_t *expected_prbs = raw_port->prbs_cache_ext + prbs_offset;
-                        uint8_t *recv_prbs = pkt + payload_off + SEQ_BYTES;
-
-                        // Compare PRBS data (use smaller size for comparison)
-                        // RAW_PKT_PRBS_BYTES = 1459, NUM_PRBS_BYTES may differ
-                        uint32_t cmp_len = RAW_PKT_PRBS_BYTES;
-                        if (cmp_len > NUM_PRBS_BYTES) cmp_len = NUM_PRBS_BYTES;
-
-                        if (memcmp(recv_prbs, expected_prbs, cmp_len) == 0)
+                        // Üretici raw port: stride RAW_PKT_PRBS_BYTES, boyut paketten (IMIX)
+                        uint64_t bit_err = pkt_payload_verify(pkt + payload_off + SEQ_BYTES,
+                                                              m->pkt_len - payload_off - SEQ_BYTES,
+                                                              ext_seq, raw_port->prbs_cache_ext,
+                                                              RAW_PKT_PRBS_BYTES);
+                        if (bit_err == 0)
                         {
                             local_good++;
                         }
                         else
                         {
                             local_bad++;
-                            // Count bit errors
-                            for (uint32_t i = 0; i < cmp_len; i++)
-                            {
-                                local_bits += __builtin_popcount(recv_prbs[i] ^ expected_prbs[i]);
-                            }
+                            local_bits += bit_err;
                         }
-#endif
 
                         // ==========================================
                         // SEQUENCE TRACKING FOR EXTERNAL PACKETS
@@ -1488,24 +1833,11 @@ int rx_worker(void *arg)
                 // ==========================================
                 uint8_t *recv = pkt + payload_off + SEQ_BYTES;
 
-#if IMIX_ENABLED
-                // IMIX: PRBS offset hesabı HEP MAX_PRBS_BYTES ile yapılır
-                // PRBS boyutu paket boyutundan hesaplanır
-                uint16_t prbs_len = m->pkt_len - l2_len_vlan - 20 - 8 - SEQ_BYTES;
-                if (prbs_len > MAX_PRBS_BYTES) prbs_len = MAX_PRBS_BYTES;
-
-                uint64_t off = (seq * (uint64_t)MAX_PRBS_BYTES) % (uint64_t)PRBS_CACHE_SIZE;
-                uint8_t *exp = prbs_cache_ext + off;
-
-                int diff = memcmp(recv, exp, prbs_len);
-#else
-                uint64_t off = (seq * (uint64_t)NUM_PRBS_BYTES) % (uint64_t)PRBS_CACHE_SIZE;
-                uint8_t *exp = prbs_cache_ext + off;
-
-                int diff = memcmp(recv, exp, NUM_PRBS_BYTES);
-#endif
+                // IMIX: boyut paketten, offset hep MAX_PRBS_BYTES ile
+                uint64_t berr = pkt_payload_verify(recv, m->pkt_len - l2_len_vlan - 20 - 8 - SEQ_BYTES,
+                                                   seq, prbs_cache_ext, MAX_PRBS_BYTES);
 
-                if (likely(diff == 0))
+                if (likely(berr == 0))
                 {
                     local_good++;
                     if (unlikely(!first_good))
@@ -1524,61 +1856,27 @@ int rx_worker(void *arg)
                                params->port_id, params->queue_id, vl_id, seq);
                         first_bad = true;
                     }
-
-                    // Bit error counting
-                    uint64_t berr = 0;
-                    const uint64_t *r64 = (const uint64_t *)recv;
-                    const uint64_t *e64 = (const uint64_t *)exp;
-#if IMIX_ENABLED
-                    const uint16_t nq = prbs_len / 8;
-#else
-                    const uint16_t nq = NUM_PRBS_BYTES / 8;
-#endif
-
-                    for (uint16_t k = 0; k < nq; k++)
-                    {
-                        berr += __builtin_popcountll(r64[k] ^ e64[k]);
-                    }
-
-#if IMIX_ENABLED
-                    uint16_t rem = prbs_len & 7;
-#else
-                    uint16_t rem = NUM_PRBS_BYTES & 7;
-#endif
-                    if (rem)
-                    {
-                        const uint8_t *r8 = (const uint8_t *)(r64 + nq);
-                        const uint8_t *e8 = (const uint8_t *)(e64 + nq);
-                        for (uint16_t k = 0; k < rem; k++)
-                        {
-                            berr += __builtin_popcount(r8[k] ^ e8[k]);
-                        }
-                    }
-
                     local_bits += berr;
                 }
             }
 
             // Batch free
-            for (uint16_t i = 0; i < nb_rx; i++)
-            {
-                rte_pktmbuf_free(pkts[i]);
-            }
+            pkt_io_rx_free(&io, bufs, nb_rx);
 
             if (unlikely(local_rx >= FLUSH))
             {
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].total_rx_pkts, local_rx);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].good_pkts, local_good);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].bad_pkts, local_bad);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].bit_errors, local_bits);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].lost_pkts, local_lost);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].out_of_order_pkts, local_ooo);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].duplicate_pkts, local_dup);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].short_pkts, local_short);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].external_pkts, local_external);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->total_rx_pkts, local_rx);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->good_pkts, local_good);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->bad_pkts, local_bad);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->bit_errors, local_bits);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->lost_pkts, local_lost);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->out_of_order_pkts, local_ooo);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->duplicate_pkts, local_dup);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->short_pkts, local_short);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->external_pkts, local_external);
                 // Raw socket RX counters
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].raw_socket_rx_pkts, local_raw_rx);
-                rte_atomic64_add(&rx_stats_per_port[params->port_id].raw_socket_rx_bytes, local_raw_bytes);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->raw_socket_rx_pkts, local_raw_rx);
+                rte_atomic64_add(&rx_stats_per_port[params->port_id]->raw_socket_rx_bytes, local_raw_bytes);
                 local_rx = local_good = local_bad = local_bits = 0;
                 local_lost = local_ooo = local_dup = local_short = local_external = 0;
                 local_raw_rx = local_raw_bytes = 0;
@@ -1589,18 +1887,18 @@ int rx_worker(void *arg)
     // Final flush
     if (local_rx || local_raw_rx || local_external)
     {
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].total_rx_pkts, local_rx);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].good_pkts, local_good);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].bad_pkts, local_bad);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].bit_errors, local_bits);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].lost_pkts, local_lost);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].out_of_order_pkts, local_ooo);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].duplicate_pkts, local_dup);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].short_pkts, local_short);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].external_pkts, local_external);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->total_rx_pkts, local_rx);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->good_pkts, local_good);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->bad_pkts, local_bad);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->bit_errors, local_bits);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->lost_pkts, local_lost);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->out_of_order_pkts, local_ooo);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->duplicate_pkts, local_dup);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->short_pkts, local_short);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->external_pkts, local_external);
         // Raw socket RX counters
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].raw_socket_rx_pkts, local_raw_rx);
-        rte_atomic64_add(&rx_stats_per_port[params->port_id].raw_socket_rx_bytes, local_raw_bytes);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->raw_socket_rx_pkts, local_raw_rx);
+        rte_atomic64_add(&rx_stats_per_port[params->port_id]->raw_socket_rx_bytes, local_raw_bytes);
     }
 
     // ==========================================
@@ -1633,7 +1931,7 @@ int rx_worker(void *arg)
 
         if (total_lost > 0)
         {
-            rte_atomic64_add(&rx_stats_per_port[params->port_id].lost_pkts, total_lost);
+            rte_atomic64_add(&rx_stats_per_port[params->port_id]->lost_pkts, total_lost);
             printf("RX Worker Port %u Q%u: Calculated %lu lost packets (watermark-based)\n",
                    params->port_id, params->queue_id, total_lost);
         }
@@ -1669,11 +1967,26 @@ int start_txrx_workers(struct ports_config *ports_config, volatile bool *stop_fl
 
 #if TX_TEST_MODE_ENABLED
     // Initialize TX test mode counters
-    init_tx_test_counters();
+    if (init_tx_test_counters() < 0)
+    {
+        printf("Error: Cannot allocate TX test counters\n");
+        return -1;
+    }
 #endif
 
-    static struct tx_worker_params tx_params[MAX_PORTS * NUM_TX_CORES];
-    static struct rx_worker_params rx_params[MAX_PORTS * NUM_RX_CORES];
+    // Worker parametreleri worker'lar çalıştığı sürece yaşar (serbest bırakılmaz)
+    uint16_t nb_worker_ports = RTE_MAX(ports_config->nb_ports, 1);
+    struct tx_worker_params *tx_params = rte_zmalloc("tx_params",
+        nb_worker_ports * NUM_TX_CORES * sizeof(*tx_params), RTE_CACHE_LINE_SIZE);
+    struct rx_worker_params *rx_params = rte_zmalloc("rx_params",
+        nb_worker_ports * NUM_RX_CORES * sizeof(*rx_params), RTE_CACHE_LINE_SIZE);
+    if (!tx_params || !rx_params)
+    {
+        printf("Error: Cannot allocate worker parameters\n");
+        rte_free(tx_params);
+        rte_free(rx_params);
+        return -1;
+    }
 
     uint16_t tx_param_idx = 0;
     uint16_t rx_param_idx = 0;
@@ -1774,7 +2087,7 @@ int start_txrx_workers(struct ports_config *ports_config, volatile bool *stop_fl
 
             char pool_name[32];
             snprintf(pool_name, sizeof(pool_name), "mbuf_pool_%u_%u",
-                     port->numa_node, port_id);
+                     port->worker_numa_node, port_id);
             tx_params[tx_param_idx].mbuf_pool = rte_mempool_lookup(pool_name);
             if (tx_params[tx_param_idx].mbuf_pool == NULL)
             {
@@ -1805,6 +2118,27 @@ int start_txrx_workers(struct ports_config *ports_config, volatile bool *stop_fl
                    get_tx_vl_id_range_start(port_id, q), get_tx_vl_id_range_end(port_id, q),
                    port_target_gbps, IS_FAST_PORT(port_id) ? "FAST" : "SLOW");
 
+#if DPDK_EXT_TX_ENABLED
+            // Inline external TX: bu queue'ya atanmış ext hedefi (varsa)
+            uint16_t ext_port_idx = 0, ext_target_idx = 0;
+            const struct dpdk_ext_tx_target *ext_target =
+                dpdk_ext_tx_inline_target(port_id, q, &ext_port_idx, &ext_target_idx);
+            tx_params[tx_param_idx].ext_tx_enabled = (ext_target != NULL);
+            if (ext_target != NULL)
+            {
+                tx_params[tx_param_idx].ext_vlan_id = ext_target->vlan_id;
+                tx_params[tx_param_idx].ext_vl_id_start = ext_target->vl_id_start;
+                tx_params[tx_param_idx].ext_vl_id_count = ext_target->vl_id_count;
+                tx_params[tx_param_idx].ext_port_idx = ext_port_idx;
+                tx_params[tx_param_idx].ext_target_idx = ext_target_idx;
+                init_ext_rate_limiter_with_stagger(&tx_params[tx_param_idx].ext_limiter,
+                                                   ext_target->rate_kbps, port_id, q);
+                printf("    + Ext class: VLAN %u, VL RANGE [%u..%u) -> external (switch)\n",
+                       ext_target->vlan_id, ext_target->vl_id_start,
+                       ext_target->vl_id_start + ext_target->vl_id_count);
+            }
+#endif
+
             int ret = rte_eal_remote_launch(tx_worker,
                                             &tx_params[tx_param_idx],
                                             lcore_id);
@@ -1845,7 +2179,15 @@ struct latency_test_state g_latency_test;
  */
 void reset_latency_test(void)
 {
+    // Port tablosu korunur, içeriği sıfırlanır
+    struct port_latency_test *ports = g_latency_test.ports;
+    uint16_t nb_ports = g_latency_test.nb_ports;
+
     memset(&g_latency_test, 0, sizeof(g_latency_test));
+    if (ports)
+        memset(ports, 0, nb_ports * sizeof(*ports));
+    g_latency_test.ports = ports;
+    g_latency_test.nb_ports = nb_ports;
     g_latency_test.tsc_hz = rte_get_tsc_hz();
     printf("Latency test state reset. TSC frequency: %lu Hz\n", g_latency_test.tsc_hz);
 }
@@ -1854,12 +2196,12 @@ void reset_latency_test(void)
  * Build latency test packet
  * Format: [ETH][VLAN][IP][UDP][SEQ 8B][TX_TIMESTAMP 8B][PRBS]
  */
-static int build_latency_test_packet(struct rte_mbuf *mbuf,
-                                      uint16_t port_id,
-                                      uint16_t vlan_id,
-                                      uint16_t vl_id,
-                                      uint64_t sequence,
-                                      uint64_t tx_timestamp)
+int build_latency_test_packet(struct rte_mbuf *mbuf,
+                              uint16_t port_id,
+                              uint16_t vlan_id,
+                              uint16_t vl_id,
+                              uint64_t sequence,
+                              uint64_t tx_timestamp)
 {
     uint8_t *pkt = rte_pktmbuf_mtod(mbuf, uint8_t *);
 
@@ -1986,7 +2328,7 @@ static int latency_tx_worker(void *arg)
     printf("Latency TX Worker started: Port %u\n", port_id);
 
     // Get port VLAN config
-    if (port_id >= MAX_PORTS_CONFIG) {
+    if (port_id >= port_vlans_count) {
         printf("Error: Invalid port_id %u\n", port_id);
         return -1;
     }
@@ -2044,25 +2386,24 @@ static int latency_tx_worker(void *arg)
     // Send multiple packets per VLAN using first VL-ID
     for (uint16_t v = 0; v < vlan_count; v++) {
         uint16_t vlan_id = vlan_cfg->tx_vlans[v];
-        uint16_t vl_id = vlan_cfg->tx_vl_ids[v];  // First VL-ID for this VLAN
+        uint16_t vl_id = latency_probe_vl_id(port_id, v);  // Reserved probe VL-ID of this VLAN
 
         struct latency_result *result = &g_latency_test.ports[port_id].results[v];
         result->tx_count = 0;
 
         // Send multiple packets per VLAN
         for (uint16_t p = 0; p < PACKETS_PER_VLAN; p++) {
-            struct rte_mbuf *mbuf = rte_pktmbuf_alloc(params->mbuf_pool);
+            // Get TX timestamp using TSC
+            uint64_t tx_timestamp = rte_rdtsc();
+
+            // Prebuilt probe: only sequence number = p and timestamp are written
+            struct rte_mbuf *mbuf = latency_probe_take(port_id, 0, v, p, tx_timestamp);
             if (!mbuf) {
-                printf("  Error: Failed to allocate mbuf for Port %u VLAN %u pkt %u\n",
+                printf("  Error: No free probe mbuf for Port %u VLAN %u pkt %u\n",
                        port_id, vlan_id, p);
                 continue;
             }
-
-            // Get TX timestamp using TSC
-            uint64_t tx_timestamp = rte_rdtsc();
-
-            // Build packet with sequence number = p
-            build_latency_test_packet(mbuf, port_id, vlan_id, vl_id, p, tx_timestamp);
+            nic_clock_tx_mark(port_id, mbuf);
 
             // Send packet using ONLY queue 0 for latency test (eliminates multi-queue effects)
             uint16_t nb_tx = rte_eth_tx_burst(port_id, 0, &mbuf, 1);
@@ -2070,8 +2411,13 @@ static int latency_tx_worker(void *arg)
             if (nb_tx == 0) {
                 rte_pktmbuf_free(mbuf);
             } else {
+                // Descriptor NIC'e verildi: payload'daki TSC'den daha geç ama
+                // PMD hazırlama süresini içermeyen zaman; NIC TX zamanı varsa o
+                uint64_t sent_tsc = rte_rdtsc();
                 result->tx_count++;
-                result->tx_timestamp = tx_timestamp;  // Last TX timestamp
+                result->tx_payload_tsc = tx_timestamp;
+                result->tx_hw = nic_clock_tx_tsc(port_id, &sent_tsc);
+                result->tx_timestamp = sent_tsc;  // Last TX timestamp
             }
 
             // Small delay between packets in same VLAN
@@ -2100,7 +2446,16 @@ static int latency_rx_worker(void *arg)
     uint16_t port_id = params->port_id;
     uint16_t src_port_id = params->src_port_id;
 
-    printf("Latency RX Worker started: Port %u (SINGLE QUEUE mode, queue 0 only)\n", port_id);
+    const uint16_t rx_queue = latency_probe_rx_queue(port_id);
+
+    printf("Latency RX Worker started: Port %u (SINGLE QUEUE mode, queue %u only%s)\n",
+           port_id, rx_queue, latency_probe_flow_active(port_id) ? ", rte_flow" : "");
+
+    if (src_port_id >= g_latency_test.nb_ports) {
+        printf("Error: Latency source port %u not discovered\n", src_port_id);
+        g_latency_test.ports[port_id].rx_complete = true;
+        return -1;
+    }
 
 #if VLAN_ENABLED
     const uint16_t l2_len = sizeof(struct rte_ether_hdr) + sizeof(struct vlan_hdr);
@@ -2117,7 +2472,7 @@ static int latency_rx_worker(void *arg)
 
     uint32_t loop_count = 0;
 
-    // FAST POLLING LOOP - use ONLY queue 0 for latency test
+    // FAST POLLING LOOP - use ONLY the probe queue for latency test
     while (1) {
         // Check timeout every 1000 loops (reduces rdtsc overhead)
         if (++loop_count >= 1000) {
@@ -2127,8 +2482,8 @@ static int latency_rx_worker(void *arg)
             }
         }
 
-        // Poll ONLY queue 0 for latency test
-        uint16_t nb_rx = rte_eth_rx_burst(port_id, 0, pkts, BURST_SIZE);
+        // Poll ONLY the probe queue (dedicated flow queue, or queue 0)
+        uint16_t nb_rx = rte_eth_rx_burst(port_id, rx_queue, pkts, BURST_SIZE);
         if (nb_rx == 0) {
             continue;
         }
@@ -2143,8 +2498,9 @@ static int latency_rx_worker(void *arg)
                 continue;
             }
 
-            // Get RX timestamp immediately
-            uint64_t rx_timestamp = rte_rdtsc();
+            // Get RX timestamp immediately (NIC timestamp if the PMD provides one)
+            bool rx_hw;
+            uint64_t rx_timestamp = nic_clock_rx_tsc(port_id, m, rte_rdtsc(), &rx_hw);
 
             // Extract TX timestamp from payload
             uint8_t *payload = pkt + payload_offset;
@@ -2173,6 +2529,7 @@ static int latency_rx_worker(void *arg)
 
                     result->received = true;
                     result->prbs_ok = true;
+                    result->rx_hw = rx_hw;
                     result->rx_timestamp = rx_timestamp;
                     result->latency_cycles = rx_timestamp - tx_timestamp;
 
@@ -2198,11 +2555,49 @@ static int latency_rx_worker(void *arg)
     return 0;
 }
 
+/**
+ * Tek örnekli sonuçlarda gecikmeyi payload TSC'si yerine gerçek gönderim
+ * zamanından (NIC TX veya tx_burst sonrası TSC) yeniden hesapla.
+ * RX worker paketi TX worker sonucu yazmadan görebildiği için payload'la
+ * ölçer; düzeltme testin sonunda, tüm worker'lar bittikten sonra yapılır.
+ * Çok örnekli sonuçlar (paket başına gönderim zamanı tutulmuyor) payload
+ * ölçümünde kalır; print_latency_results bunların sayısını ayrıca yazar.
+ */
+static void rebase_latency_on_send_time(void)
+{
+    for (uint16_t p = 0; p < g_latency_test.nb_ports; p++) {
+        struct port_latency_test *port_test = &g_latency_test.ports[p];
+
+        for (uint16_t t = 0; t < port_test->test_count; t++) {
+            struct latency_result *result = &port_test->results[t];
+
+            if (result->rx_count != 1 || result->tx_count != 1 ||
+                result->rx_timestamp <= result->tx_timestamp)
+                continue;
+
+            result->latency_cycles = result->rx_timestamp - result->tx_timestamp;
+            double latency_us = (double)result->latency_cycles * 1000000.0 / g_latency_test.tsc_hz;
+            result->min_latency_us = latency_us;
+            result->max_latency_us = latency_us;
+            result->sum_latency_us = latency_us;
+            result->latency_us = latency_us;
+        }
+    }
+}
+
 /**
  * Print latency test results - per-VLAN with minimum latency (eliminates first-packet overhead)
  */
 void print_latency_results(void)
 {
+    uint16_t clock_ports[RTE_MAX_ETHPORTS];
+    uint16_t nb_clock_ports = 0;
+    for (uint16_t p = 0; p < g_latency_test.nb_ports && nb_clock_ports < RTE_MAX_ETHPORTS; p++) {
+        if (g_latency_test.ports[p].test_count > 0)
+            clock_ports[nb_clock_ports++] = p;
+    }
+    nic_clock_print(clock_ports, nb_clock_ports);
+
     printf("\n");
     printf("╔══════════════════════════════════════════════════════════════════════════════════════════╗\n");
     printf("║                    LATENCY TEST SONUCLARI (Minimum Latency)                              ║\n");
@@ -2212,9 +2607,10 @@ void print_latency_results(void)
 
     uint32_t total_tx = 0;
     uint32_t total_rx = 0;
+    uint32_t payload_only = 0;  // Gönderim zamanına taşınmamış (çok örnekli) sonuçlar
     double total_min_latency = 0.0;
 
-    for (uint16_t p = 0; p < MAX_PORTS; p++) {
+    for (uint16_t p = 0; p < g_latency_test.nb_ports; p++) {
         struct port_latency_test *port_test = &g_latency_test.ports[p];
 
         for (uint16_t t = 0; t < port_test->test_count; t++) {
@@ -2225,6 +2621,8 @@ void print_latency_results(void)
 
             if (result->received && result->rx_count > 0) {
                 total_rx++;
+                if (result->rx_count != 1 || result->tx_count != 1)
+                    payload_only++;
                 double avg_latency = result->sum_latency_us / result->rx_count;
                 total_min_latency += result->min_latency_us;
 
@@ -2251,6 +2649,9 @@ void print_latency_results(void)
     }
 
     printf("╚══════════════════════════════════════════════════════════════════════════════════════════╝\n");
+    if (payload_only > 0)
+        printf("  Not: %u cok ornekli sonuc gonderim zamanina tasinmadi (payload TSC, tx_burst oncesi)\n",
+               payload_only);
     printf("\n");
 }
 
@@ -2267,8 +2668,27 @@ int start_latency_test(struct ports_config *ports_config, volatile bool *stop_fl
     printf("╚══════════════════════════════════════════════════════════════════╝\n");
     printf("\n");
 
+    // Port tablosu (port_id ile indekslenir) ilk testte ayrılır
+    if (!g_latency_test.ports && ports_config->port_table_size > 0) {
+        g_latency_test.ports = rte_zmalloc("latency_ports",
+            ports_config->port_table_size * sizeof(struct port_latency_test), RTE_CACHE_LINE_SIZE);
+        if (!g_latency_test.ports) {
+            printf("Error: Cannot allocate latency test port table\n");
+            return -1;
+        }
+        g_latency_test.nb_ports = ports_config->port_table_size;
+    }
+
     // Reset test state
     reset_latency_test();
+
+    // NIC saatlerini ve TSC'yi yeniden kalibre et (port start'tan beri sürüklenme)
+    nic_clock_calibrate_tsc();
+    for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
+        if (ports_config->ports[i].is_valid)
+            nic_clock_calibrate(ports_config->ports[i].port_id);
+    }
+
     g_latency_test.test_running = true;
     g_latency_test.test_start_time = rte_rdtsc();
 
@@ -2281,6 +2701,13 @@ int start_latency_test(struct ports_config *ports_config, volatile bool *stop_fl
         if (!ports_config->ports[i].is_valid) continue;
         uint16_t port_id = ports_config->ports[i].port_id;
 
+        // Probe'lar flow kuralıyla kendi kuyruğunda, RSS'e dokunma
+        if (latency_probe_flow_active(port_id)) {
+            printf("  Port %u: probes on RX queue %u (rte_flow), RETA unchanged\n",
+                   port_id, LATENCY_PROBE_RX_QUEUE);
+            continue;
+        }
+
         struct rte_eth_dev_info dev_info;
         int ret = rte_eth_dev_info_get(port_id, &dev_info);
         if (ret != 0) {
@@ -2322,7 +2749,7 @@ int start_latency_test(struct ports_config *ports_config, volatile bool *stop_fl
         struct port *port = &ports_config->ports[i];
         uint16_t port_id = port->port_id;
 
-        if (port_id >= MAX_PORTS_CONFIG) continue;
+        if (port_id >= port_vlans_count) continue;
 
         struct port_vlan_config *vlan_cfg = &port_vlans[port_id];
         uint16_t vlan_count = vlan_cfg->tx_vlan_count;
@@ -2336,7 +2763,7 @@ int start_latency_test(struct ports_config *ports_config, volatile bool *stop_fl
             result->tx_port = port_id;
             result->rx_port = get_latency_paired_port(port_id);
             result->vlan_id = vlan_cfg->tx_vlans[v];
-            result->vl_id = vlan_cfg->tx_vl_ids[v];
+            result->vl_id = latency_probe_vl_id(port_id, v);
             result->received = false;
             result->prbs_ok = false;
         }
@@ -2346,8 +2773,18 @@ int start_latency_test(struct ports_config *ports_config, volatile bool *stop_fl
     printf("\n");
 
     // Worker parameters storage
-    static struct tx_worker_params tx_params[MAX_PORTS];
-    static struct rx_worker_params rx_params[MAX_PORTS];
+    uint16_t nb_worker_ports = RTE_MAX(ports_config->nb_ports, 1);
+    struct tx_worker_params *tx_params = rte_zmalloc("lat_tx_params",
+        nb_worker_ports * sizeof(*tx_params), RTE_CACHE_LINE_SIZE);
+    struct rx_worker_params *rx_params = rte_zmalloc("lat_rx_params",
+        nb_worker_ports * sizeof(*rx_params), RTE_CACHE_LINE_SIZE);
+    if (!tx_params || !rx_params)
+    {
+        printf("Error: Cannot allocate latency worker parameters\n");
+        rte_free(tx_params);
+        rte_free(rx_params);
+        return -1;
+    }
 
     // Start RX workers first
     printf("=== Starting Latency RX Workers ===\n");
@@ -2385,7 +2822,7 @@ int start_latency_test(struct ports_config *ports_config, volatile bool *stop_fl
 
         // Get mbuf pool
         char pool_name[32];
-        snprintf(pool_name, sizeof(pool_name), "mbuf_pool_%u_%u", port->numa_node, port_id);
+        snprintf(pool_name, sizeof(pool_name), "mbuf_pool_%u_%u", port->worker_numa_node, port_id);
         struct rte_mempool *mbuf_pool = rte_mempool_lookup(pool_name);
         if (!mbuf_pool) {
             printf("Error: Cannot find mbuf pool for port %u\n", port_id);
@@ -2438,6 +2875,8 @@ int start_latency_test(struct ports_config *ports_config, volatile bool *stop_fl
     g_latency_test.test_running = false;
     g_latency_test.test_complete = true;
 
+    rebase_latency_on_send_time();
+
     // ==========================================
     // Restore RSS RETA to distribute across all queues
     // ==========================================
@@ -2445,6 +2884,7 @@ int start_latency_test(struct ports_config *ports_config, volatile bool *stop_fl
     for (uint16_t i = 0; i < ports_config->nb_ports; i++) {
         if (!ports_config->ports[i].is_valid) continue;
         uint16_t port_id = ports_config->ports[i].port_id;
+        if (latency_probe_flow_active(port_id)) continue;
 
         struct rte_eth_dev_info dev_info;
         int ret = rte_eth_dev_info_get(port_id, &dev_info);
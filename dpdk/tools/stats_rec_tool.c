@@ -0,0 +1,359 @@
+// Stats recording okuyucu (DPDK gerektirmez)
+//
+//   stats_rec_tool info FILE
+//   stats_rec_tool csv  FILE [--from SEC] [--to SEC] [--every N] [--cols PAT[,PAT...]]
+//   stats_rec_tool json FILE [aynı seçenekler]
+//
+//   --from/--to : İlk kayda göre saniye aralığı (t_ns kolonundan)
+//   --every N   : N kaydı tek satıra indir. COUNTER: pencere sonu, GAUGE: ortalama,
+//                 DELTA: toplam, FLAGS: bit OR (kolon türü dosyadaki şemadan okunur)
+//   --cols      : Adında PAT geçen kolonlar (örn. "port2.,raw" veya ".lost")
+//
+// Derleme: make stats_rec_tool  (ya da gcc -O2 -Iinclude tools/stats_rec_tool.c)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "stats_recorder_format.h"
+
+struct rec_file {
+    const uint8_t *map;
+    size_t size;
+    const struct stats_rec_file_header *hdr;
+    const struct stats_rec_column *cols;
+    uint64_t nb_records;
+};
+
+struct options {
+    double from_sec;
+    double to_sec;
+    uint32_t every;
+    char *cols;
+};
+
+static int rec_open(const char *path, struct rec_file *f)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(struct stats_rec_file_header)) {
+        fprintf(stderr, "%s: not a stats recording\n", path);
+        close(fd);
+        return -1;
+    }
+    void *m = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (m == MAP_FAILED) {
+        perror("mmap");
+        return -1;
+    }
+
+    f->map = m;
+    f->size = (size_t)st.st_size;
+    f->hdr = m;
+    f->cols = (const struct stats_rec_column *)(f->hdr + 1);
+
+    const struct stats_rec_file_header *h = f->hdr;
+    if (memcmp(h->magic, STATS_REC_MAGIC, sizeof(h->magic)) != 0 || h->version != STATS_REC_VERSION ||
+        h->record_size == 0 || h->nb_columns == 0 ||
+        sizeof(*h) + (size_t)h->nb_columns * sizeof(struct stats_rec_column) > h->header_size ||
+        h->header_size > f->size) {
+        fprintf(stderr, "%s: bad header (magic/version/size)\n", path);
+        munmap(m, f->size);
+        return -1;
+    }
+
+    // Şema: bilinen tip ve kayıt sınırı içinde kalan ofset; t_ns (kolon 0) 8 byte olmalı
+    for (uint32_t i = 0; i < h->nb_columns; i++) {
+        const struct stats_rec_column *c = &f->cols[i];
+        uint32_t width = c->type == STATS_REC_U32 ? 4 : 8;
+        if (c->type > STATS_REC_U32 || c->kind > STATS_REC_DELTA ||
+            (uint64_t)c->offset + width > h->record_size ||
+            (i == 0 && c->type != STATS_REC_U64)) {
+            fprintf(stderr, "%s: bad column %u (type %u, offset %u, record size %u)\n",
+                    path, i, c->type, c->offset, h->record_size);
+            munmap(m, f->size);
+            return -1;
+        }
+    }
+
+    // Kayıt hâlâ yazılıyor ya da yarıda kalmış olabilir: dosyadaki tam kayıtlarla sınırla
+    uint64_t fit = (f->size - h->header_size) / h->record_size;
+    f->nb_records = h->nb_records < fit ? h->nb_records : fit;
+    return 0;
+}
+
+static inline const uint8_t *rec_at(const struct rec_file *f, uint64_t i)
+{
+    return f->map + f->hdr->header_size + i * f->hdr->record_size;
+}
+
+static double col_value(const struct stats_rec_column *c, const uint8_t *r)
+{
+    uint64_t u64;
+    uint32_t u32;
+    double d;
+
+    switch (c->type) {
+    case STATS_REC_F64:
+        memcpy(&d, r + c->offset, sizeof(d));
+        return d;
+    case STATS_REC_U32:
+        memcpy(&u32, r + c->offset, sizeof(u32));
+        return u32;
+    default:
+        memcpy(&u64, r + c->offset, sizeof(u64));
+        return (double)u64;
+    }
+}
+
+static uint64_t col_u64(const struct stats_rec_column *c, const uint8_t *r)
+{
+    uint64_t u64 = 0;
+    uint32_t u32;
+    if (c->type == STATS_REC_U32) {
+        memcpy(&u32, r + c->offset, sizeof(u32));
+        return u32;
+    }
+    memcpy(&u64, r + c->offset, sizeof(u64));
+    return u64;
+}
+
+static const char *type_name(uint8_t t)
+{
+    return t == STATS_REC_F64 ? "f64" : t == STATS_REC_U32 ? "u32" : "u64";
+}
+
+static const char *kind_name(uint8_t k)
+{
+    return k == STATS_REC_GAUGE ? "gauge" : k == STATS_REC_DELTA ? "delta" :
+           k == STATS_REC_FLAGS ? "flags" : "counter";
+}
+
+// ==========================================
+// info
+// ==========================================
+
+static int cmd_info(const struct rec_file *f)
+{
+    const struct stats_rec_file_header *h = f->hdr;
+    printf("version      : %u\n", h->version);
+    printf("interval     : %u ms\n", h->interval_ms);
+    printf("start        : %" PRIu64 " ns (realtime)\n", h->start_ns);
+    printf("records      : %" PRIu64 " (header says %" PRIu64 ")\n", f->nb_records, h->nb_records);
+    printf("record size  : %u bytes\n", h->record_size);
+    printf("columns      : %u\n", h->nb_columns);
+
+    if (f->nb_records > 0) {
+        const struct stats_rec_column *t = &f->cols[0];
+        double span = (double)(col_u64(t, rec_at(f, f->nb_records - 1)) - col_u64(t, rec_at(f, 0))) / 1e9;
+        printf("span         : %.0f s\n", span);
+    }
+
+    printf("\n%-48s %-5s %-8s %6s\n", "name", "type", "kind", "offset");
+    for (uint32_t i = 0; i < h->nb_columns; i++) {
+        const struct stats_rec_column *c = &f->cols[i];
+        printf("%-48.*s %-5s %-8s %6u\n", STATS_REC_NAME_LEN, c->name,
+               type_name(c->type), kind_name(c->kind), c->offset);
+    }
+    return 0;
+}
+
+// ==========================================
+// csv / json
+// ==========================================
+
+static bool col_selected(const struct stats_rec_column *c, const char *patterns)
+{
+    if (!patterns || !*patterns)
+        return true;
+
+    char name[STATS_REC_NAME_LEN + 1];
+    memcpy(name, c->name, STATS_REC_NAME_LEN);
+    name[STATS_REC_NAME_LEN] = '\0';
+
+    const char *p = patterns;
+    while (*p) {
+        const char *end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        char pat[STATS_REC_NAME_LEN + 1];
+        if (len > STATS_REC_NAME_LEN)
+            len = STATS_REC_NAME_LEN;
+        memcpy(pat, p, len);
+        pat[len] = '\0';
+        if (len > 0 && strstr(name, pat))
+            return true;
+        if (!end)
+            break;
+        p = end + 1;
+    }
+    return false;
+}
+
+static void print_value(const struct stats_rec_column *c, double v)
+{
+    if (c->type == STATS_REC_F64 || c->kind == STATS_REC_GAUGE)
+        printf("%.6g", v);
+    else
+        printf("%.0f", v);
+}
+
+// Pencereyi tek satır olarak bas
+static void emit_row(const struct rec_file *f, const uint32_t *sel, uint32_t nb_sel,
+                     const double *acc, uint32_t in_window, uint64_t t, double t_sec,
+                     bool json, bool first_row)
+{
+    if (json) {
+        printf("%s\n  {\"t_ns\":%" PRIu64 ",\"t_sec\":%.3f", first_row ? "" : ",", t, t_sec);
+    } else {
+        printf("%" PRIu64 ",%.3f", t, t_sec);
+    }
+    for (uint32_t k = 0; k < nb_sel; k++) {
+        const struct stats_rec_column *c = &f->cols[sel[k]];
+        double v = c->kind == STATS_REC_GAUGE ? acc[k] / in_window : acc[k];
+        if (json)
+            printf(",\"%.*s\":", STATS_REC_NAME_LEN, c->name);
+        else
+            printf(",");
+        print_value(c, v);
+    }
+    printf(json ? "}" : "\n");
+}
+
+static int cmd_export(const struct rec_file *f, const struct options *o, bool json)
+{
+    const struct stats_rec_file_header *h = f->hdr;
+    uint32_t *sel = calloc(h->nb_columns, sizeof(*sel));
+    double *acc = calloc(h->nb_columns, sizeof(*acc));
+    if (!sel || !acc) {
+        free(sel);
+        free(acc);
+        return 1;
+    }
+
+    // t_ns (kolon 0) her satırda ayrıca basılır
+    uint32_t nb_sel = 0;
+    for (uint32_t i = 1; i < h->nb_columns; i++)
+        if (col_selected(&f->cols[i], o->cols))
+            sel[nb_sel++] = i;
+
+    const struct stats_rec_column *t_col = &f->cols[0];
+    uint64_t t0 = f->nb_records ? col_u64(t_col, rec_at(f, 0)) : 0;
+
+    if (json) {
+        printf("[");
+    } else {
+        printf("t_ns,t_sec");
+        for (uint32_t k = 0; k < nb_sel; k++)
+            printf(",%.*s", STATS_REC_NAME_LEN, f->cols[sel[k]].name);
+        printf("\n");
+    }
+
+    uint32_t in_window = 0;
+    bool first_row = true;
+    uint64_t last_t = 0;
+    double last_sec = 0.0;
+    for (uint64_t i = 0; i < f->nb_records; i++) {
+        const uint8_t *r = rec_at(f, i);
+        uint64_t t = col_u64(t_col, r);
+        double t_sec = (double)(t - t0) / 1e9;
+        if (t_sec < o->from_sec)
+            continue;
+        if (o->to_sec >= 0 && t_sec > o->to_sec)
+            break;
+
+        for (uint32_t k = 0; k < nb_sel; k++) {
+            const struct stats_rec_column *c = &f->cols[sel[k]];
+            double v = col_value(c, r);
+            if (c->kind == STATS_REC_COUNTER)
+                acc[k] = v;
+            else if (c->kind == STATS_REC_FLAGS)
+                acc[k] = in_window ? (double)((uint64_t)acc[k] | (uint64_t)v) : v;
+            else
+                acc[k] = in_window ? acc[k] + v : v;
+        }
+        last_t = t;
+        last_sec = t_sec;
+        if (++in_window < o->every)
+            continue;
+
+        emit_row(f, sel, nb_sel, acc, in_window, t, t_sec, json, first_row);
+        first_row = false;
+        in_window = 0;
+    }
+
+    // Yarım kalan son pencere
+    if (in_window > 0) {
+        emit_row(f, sel, nb_sel, acc, in_window, last_t, last_sec, json, first_row);
+        first_row = false;
+    }
+
+    if (json)
+        printf("%s]\n", first_row ? "" : "\n");
+
+    free(sel);
+    free(acc);
+    return 0;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s info FILE\n"
+            "       %s csv|json FILE [--from SEC] [--to SEC] [--every N] [--cols PAT[,PAT...]]\n",
+            prog, prog);
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    const char *cmd = argv[1];
+    struct options o = { .from_sec = 0.0, .to_sec = -1.0, .every = 1, .cols = NULL };
+    for (int i = 3; i < argc; i++) {
+        if (strcmp(argv[i], "--from") == 0 && i + 1 < argc) {
+            o.from_sec = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--to") == 0 && i + 1 < argc) {
+            o.to_sec = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--every") == 0 && i + 1 < argc) {
+            int n = atoi(argv[++i]);
+            o.every = n > 0 ? (uint32_t)n : 1;
+        } else if (strcmp(argv[i], "--cols") == 0 && i + 1 < argc) {
+            o.cols = argv[++i];
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    struct rec_file f;
+    if (rec_open(argv[2], &f) < 0)
+        return 1;
+
+    int ret;
+    if (strcmp(cmd, "info") == 0) {
+        ret = cmd_info(&f);
+    } else if (strcmp(cmd, "csv") == 0) {
+        ret = cmd_export(&f, &o, false);
+    } else if (strcmp(cmd, "json") == 0) {
+        ret = cmd_export(&f, &o, true);
+    } else {
+        usage(argv[0]);
+        ret = 2;
+    }
+
+    munmap((void *)f.map, f.size);
+    return ret;
+}
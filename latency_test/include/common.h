@@ -186,6 +186,27 @@ static inline void precise_delay_us_busy(uint32_t microseconds) {
     }
 }
 
+// ============================================
+// TIMESTAMP TIERS
+// ============================================
+// Bir ölçümün iki ucu (TX, RX) her zaman aynı tier'dan gelir; farklı
+// tier'ların saatleri karşılaştırılamaz. Sayı büyüdükçe hata büyür.
+typedef enum {
+    TS_TIER_HW = 0,     // NIC PHC (SOF_TIMESTAMPING_*_HARDWARE)
+    TS_TIER_SW,         // Kernel software (SOF_TIMESTAMPING_*_SOFTWARE)
+    TS_TIER_USER,       // User-space CLOCK_MONOTONIC (sendto/recvmsg dönüşü)
+    TS_TIER_COUNT
+} ts_tier_t;
+
+static inline const char *ts_tier_name(int tier) {
+    switch (tier) {
+        case TS_TIER_HW:   return "hw";
+        case TS_TIER_SW:   return "sw";
+        case TS_TIER_USER: return "user";
+        default:           return "?";
+    }
+}
+
 // ============================================
 // LATENCY RESULT STRUCTURE
 // ============================================
@@ -205,6 +226,9 @@ struct latency_result {
     bool     valid;             // Valid result?
     bool     passed;            // Latency threshold check: true = PASS, false = FAIL
     char     error_msg[64];     // Error message (if any)
+
+    uint8_t  ts_tier;           // Ölçümü üreten timestamp tier'ı (ts_tier_t)
+    uint32_t ts_err_ns;         // Tier'ın kalibre edilmiş hata sınırı, 0 = bilinmiyor
 };
 
 // ============================================
@@ -219,6 +243,8 @@ struct test_config {
     bool     use_busy_wait;     // Use busy-wait delay
     uint64_t max_latency_ns;    // Maximum acceptable latency (ns), 0 = no check
     int      retry_count;       // Retry count on failure
+    bool     sequential;        // Legacy stop-and-wait (pair by pair, one probe in flight)
+    int      ts_tier;           // En iyi izin verilen tier (TS_TIER_HW = sınırsız)
 };
 
 // ============================================
@@ -24,6 +24,38 @@
 #define MIN_PACKET_SIZE             64      // Minimum Ethernet frame
 #define MAX_PACKET_SIZE             1518    // Maximum Ethernet frame (no jumbo)
 
+// ============================================
+// ASYNC ENGINE CONFIGURATION
+// ============================================
+// Tüm port çiftleri tek epoll döngüsünde eşzamanlı test edilir.
+// Interface başına tek soket; aynı interface'ten art arda gönderimler
+// arasında delay_us kadar beklenir.
+#define ENGINE_MAX_INFLIGHT         16      // TX interface başına cevap bekleyen probe
+#define ENGINE_TX_TS_TIMEOUT_MS     100     // TX timestamp bekleme süresi (ms)
+#define ENGINE_TSKEY_RING           256     // OPT_ID -> probe eşleme halkası (>= MAX_INFLIGHT)
+#define ENGINE_EPOLL_EVENTS         16
+
+// ============================================
+// MONITOR (SOAK) CONFIGURATION
+// ============================================
+// -M: sürekli düşük hızlı probe; VLAN başına interval histogramı,
+// interval sonunda p50/p99/max binary dosyaya + drift/step alarmı
+#define MONITOR_DEFAULT_INTERVAL_S  10      // Rapor interval'i (s)
+#define MONITOR_DEFAULT_ROUND_MS    1000    // Probe round periyodu (ms)
+#define MONITOR_DEFAULT_DRIFT_PCT   20      // p50 baseline'dan bu kadar yukarı -> drift
+#define MONITOR_DEFAULT_STEP_PCT    50      // p99 önceki interval'den bu kadar yukarı -> step
+#define MONITOR_DEFAULT_OUT         "latency_monitor.bin"
+#define MONITOR_BASELINE_INTERVALS  6       // Baseline = ilk N dolu interval'in p50 medyanı
+#define MONITOR_DRIFT_HOLD          3       // Drift alarmı için ardışık interval
+#define MONITOR_STEP_MIN_NS         1000    // Step alarmı için minimum mutlak artış
+
+// ============================================
+// TIMESTAMP CALIBRATION
+// ============================================
+// --calibrate: her tier loopback üzerinde ayrı ayrı ölçülür; en iyi
+// tier'a göre sabit offset ve tier içi jitter (stddev) çıkarılır.
+#define TS_CALIB_PACKETS            64      // VLAN başına minimum probe
+
 // ============================================
 // PORT CONFIGURATION
 // ============================================
@@ -3,6 +3,12 @@
  * @brief HW Timestamp Latency Test - Hardware Timestamping API
  *
  * SO_TIMESTAMPING ile NIC'lerden PTP hardware timestamp alma
+ *
+ * Timestamp tier'ları (common.h ts_tier_t): soket açılırken interface'in
+ * desteklediği en iyi tier seçilir (HW -> kernel SW -> user-space).
+ * PTP'siz NIC ve veth üzerinde de ölçüm yapılabilir; her sonuç hangi
+ * tier'dan geldiğini taşır. Bir ölçümün TX ve RX soketleri aynı tier'a
+ * indirilir (hw_sockets_align_tier).
  */
 
 #ifndef HW_TIMESTAMP_H
@@ -20,7 +26,9 @@
 // ============================================
 typedef enum {
     SOCK_TYPE_TX,       // TX için (timestamp geri almak için)
-    SOCK_TYPE_RX        // RX için (gelen paketlerin timestamp'i)
+    SOCK_TYPE_RX,       // RX için (gelen paketlerin timestamp'i)
+    SOCK_TYPE_TXRX      // Interface başına tek soket (async engine): TX + RX,
+                        // TX timestamp'leri OPT_ID ile eşleştirilir
 } socket_type_t;
 
 // ============================================
@@ -31,7 +39,9 @@ struct hw_socket {
     int             if_index;       // Interface index
     char            if_name[32];    // Interface name
     socket_type_t   type;           // TX veya RX
-    bool            hw_ts_enabled;  // HW timestamp aktif mi?
+    bool            hw_ts_enabled;  // HW timestamp aktif mi? (tier == TS_TIER_HW)
+    ts_tier_t       tier;           // Aktif timestamp tier'ı
+    ts_tier_t       best_tier;      // Interface'in destekleyebildiği en iyi tier
 };
 
 // ============================================
@@ -56,6 +66,27 @@ bool check_hw_timestamp_support(const char *if_name);
  */
 int create_hw_timestamp_socket(const char *if_name, socket_type_t type, struct hw_socket *sock);
 
+/**
+ * Socket'in timestamp tier'ını ayarla (SO_TIMESTAMPING yeniden yazılır)
+ * İstenen tier interface'in en iyisinden iyiyse best_tier kullanılır;
+ * setsockopt başarısızsa bir alt tier denenir.
+ *
+ * @param sock      Socket bilgileri
+ * @param tier      İstenen tier
+ * @return          Aktif olan tier
+ */
+ts_tier_t hw_socket_set_tier(struct hw_socket *sock, ts_tier_t tier);
+
+/**
+ * Soketleri ortak (en kötü) tier'a indir
+ *
+ * @param socks     Açık soketler
+ * @param count     Soket sayısı
+ * @param cap       İzin verilen en iyi tier (TS_TIER_HW = sınırsız)
+ * @return          Ortak tier
+ */
+ts_tier_t hw_sockets_align_tier(struct hw_socket **socks, int count, ts_tier_t cap);
+
 /**
  * Socket'i kapat
  *
@@ -69,7 +100,7 @@ void close_hw_timestamp_socket(struct hw_socket *sock);
  * @param sock          TX socket
  * @param packet        Paket verisi
  * @param packet_len    Paket uzunluğu
- * @param tx_timestamp  Çıktı: TX HW timestamp (nanoseconds)
+ * @param tx_timestamp  Çıktı: TX timestamp (nanoseconds, soketin tier'ında)
  * @return              0 = başarılı, <0 = hata kodu
  */
 int send_packet_get_tx_timestamp(struct hw_socket *sock,
@@ -83,7 +114,7 @@ int send_packet_get_tx_timestamp(struct hw_socket *sock,
  * @param sock          RX socket
  * @param packet        Çıktı: paket verisi buffer
  * @param packet_len    Buffer boyutu / Çıktı: alınan paket uzunluğu
- * @param rx_timestamp  Çıktı: RX HW timestamp (nanoseconds)
+ * @param rx_timestamp  Çıktı: RX timestamp (nanoseconds, soketin tier'ında)
  * @param timeout_ms    Timeout (milisaniye), 0 = non-blocking
  * @return              0 = başarılı, -1 = timeout, <-1 = hata kodu
  */
@@ -93,6 +124,30 @@ int recv_packet_get_rx_timestamp(struct hw_socket *sock,
                                   uint64_t *rx_timestamp,
                                   int timeout_ms);
 
+/**
+ * Paketi gönder, TX timestamp'ini bekleme (async engine)
+ * HW/SW tier'da timestamp daha sonra recv_tx_timestamp_async() ile alınır;
+ * USER tier'da gönderim anı hemen döner (error queue'ya mesaj gelmez).
+ *
+ * @param sock          SOCK_TYPE_TXRX socket
+ * @param packet        Paket verisi
+ * @param packet_len    Paket uzunluğu
+ * @param tx_timestamp  Çıktı: USER tier'da gönderim zamanı, diğerlerinde 0
+ * @return              0 = başarılı, -1 = socket buffer dolu (EAGAIN), <-1 = hata kodu
+ */
+int send_packet_async(struct hw_socket *sock, const uint8_t *packet, size_t packet_len,
+                      uint64_t *tx_timestamp);
+
+/**
+ * Error queue'dan bir TX timestamp oku (non-blocking)
+ *
+ * @param sock          SOCK_TYPE_TXRX socket
+ * @param tskey         Çıktı: OPT_ID anahtarı (soketteki gönderim sırası, 0'dan başlar)
+ * @param tx_timestamp  Çıktı: TX timestamp (nanoseconds), 0 = bu tier'da timestamp yok
+ * @return              0 = başarılı, -1 = kuyruk boş, <-1 = hata kodu
+ */
+int recv_tx_timestamp_async(struct hw_socket *sock, uint32_t *tskey, uint64_t *tx_timestamp);
+
 /**
  * Interface'in HW timestamp yeteneklerini yazdır (debug için)
  *
@@ -0,0 +1,51 @@
+/**
+ * @file latency_engine.h
+ * @brief HW Timestamp Latency Test - Asynchronous Multi-Pair Engine
+ *
+ * Stop-and-wait yerine tüm port çiftleri tek epoll döngüsünde:
+ * - Interface başına tek TX/RX soketi (SOCK_TYPE_TXRX)
+ * - seq_num ile eşleşen, aynı anda birden çok uçuştaki probe
+ * - TX timestamp'leri SOF_TIMESTAMPING_OPT_ID ile error queue'dan async
+ * - Sonuçlar run_latency_test() ile aynı latency_result düzeninde
+ */
+
+#ifndef LATENCY_ENGINE_H
+#define LATENCY_ENGINE_H
+
+#include "common.h"
+#include "config.h"
+
+/**
+ * Run all port pairs (honoring port_filter) concurrently
+ *
+ * Results are laid out exactly like run_latency_test(): pairs in
+ * g_port_pairs order, vlan_count entries each.
+ *
+ * @param config        Test configuration
+ * @param results       Results array (at least MAX_RESULTS elements)
+ * @param result_count  Output: valid result count
+ * @param rerun         NULL = test every VLAN; otherwise only results[i] with
+ *                      rerun[i] == true are re-measured, the rest are kept
+ * @return              0 = success, <0 = error
+ */
+int run_latency_engine(const struct test_config *config,
+                       struct latency_result *results,
+                       int *result_count,
+                       const bool *rerun);
+
+/**
+ * Per-probe sample callback (monitor mode)
+ *
+ * @param ctx         Hook context
+ * @param result_idx  Result index (same layout as results[])
+ * @param received    false = probe lost (RX timeout) or timestamp missing
+ * @param latency_ns  RX - TX HW timestamp (valid only when received)
+ */
+typedef void (*latency_sample_fn)(void *ctx, int result_idx, bool received, uint64_t latency_ns);
+
+/**
+ * Install (or clear with NULL) the per-probe sample hook
+ */
+void latency_engine_set_sample_hook(latency_sample_fn fn, void *ctx);
+
+#endif // LATENCY_ENGINE_H
@@ -78,6 +78,28 @@ int run_latency_test_with_retry(const struct test_config *config,
                                 int *result_count,
                                 int *attempt_out);
 
+/**
+ * Reset a result before a (re)run
+ */
+void latency_result_init(struct latency_result *result,
+                         uint16_t tx_port, uint16_t rx_port,
+                         uint16_t vlan_id, uint16_t vl_id);
+
+/**
+ * Account one matched packet (latency only if both timestamps are present)
+ *
+ * @param pkt       Packet index within the VLAN (for logging)
+ * @param tx_ts     TX HW timestamp, 0 = missing
+ * @param rx_ts     RX HW timestamp, 0 = missing
+ */
+void latency_result_add(struct latency_result *result, int pkt,
+                        uint64_t tx_ts, uint64_t rx_ts);
+
+/**
+ * Set valid/passed/error_msg from the accumulated counters
+ */
+void latency_result_finalize(struct latency_result *result, const struct test_config *config);
+
 /**
  * Count FAIL results
  *
@@ -0,0 +1,90 @@
+/**
+ * @file monitor.h
+ * @brief HW Timestamp Latency Test - Long-Duration Monitoring
+ *
+ * Soak testleri için sürekli, düşük hızlı probe modu:
+ * - Her round_ms'de async engine ile VLAN başına packet_count probe
+ * - VLAN başına interval histogramı (log-linear, %12.5 çözünürlük)
+ * - Interval sonunda p50/p99/max binary time-series dosyasına
+ * - Drift alarmı: p50, baseline'ın (ilk interval'lerin medyanı) drift_pct
+ *   üzerinde MONITOR_DRIFT_HOLD interval boyunca kalırsa
+ * - Step alarmı: p99 önceki interval'e göre step_pct'den fazla sıçrarsa
+ *
+ * Bellek çalışma süresinden bağımsızdır: VLAN başına tek histogram ve
+ * sabit boyutlu baseline penceresi.
+ *
+ * Dosya formatı (little-endian, packed):
+ *   struct monitor_file_header
+ *   struct monitor_file_vlan   x vlan_count
+ *   struct monitor_record      x (interval sayısı * vlan_count)
+ */
+
+#ifndef MONITOR_H
+#define MONITOR_H
+
+#include "common.h"
+#include "config.h"
+
+// ============================================
+// FILE FORMAT
+// ============================================
+#define MONITOR_FILE_MAGIC      0x534D544CU     // "LTMS"
+#define MONITOR_FILE_VERSION    1
+
+// Record flags
+#define MONITOR_FLAG_DRIFT      0x0001  // p50 baseline'dan kaydı (alarm aktif)
+#define MONITOR_FLAG_STEP       0x0002  // p99 önceki interval'e göre sıçradı
+#define MONITOR_FLAG_LOSS       0x0004  // Interval'de kayıp probe var
+#define MONITOR_FLAG_NO_DATA    0x0008  // Hiç örnek yok (p50/p99/max = 0)
+#define MONITOR_FLAG_BASELINE   0x0010  // Baseline hâlâ toplanıyor
+
+struct monitor_file_header {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t vlan_count;
+    uint32_t interval_ms;
+    uint32_t round_ms;
+    uint64_t start_realtime_ns;     // CLOCK_REALTIME
+} __attribute__((packed));
+
+struct monitor_file_vlan {
+    uint16_t tx_port;
+    uint16_t rx_port;
+    uint16_t vlan_id;
+    uint16_t vl_id;
+} __attribute__((packed));
+
+struct monitor_record {
+    uint64_t t_ns;                  // Interval sonu (CLOCK_REALTIME)
+    uint16_t vlan_idx;              // monitor_file_vlan tablosundaki sıra
+    uint16_t flags;                 // MONITOR_FLAG_*
+    uint32_t samples;
+    uint32_t lost;
+    uint32_t p50_ns;
+    uint32_t p99_ns;
+    uint32_t max_ns;
+} __attribute__((packed));
+
+// ============================================
+// API
+// ============================================
+
+struct monitor_config {
+    int         duration_s;         // 0 = Ctrl+C'ye kadar
+    int         interval_s;         // Rapor interval'i
+    int         round_ms;           // Probe round periyodu
+    int         drift_pct;          // Drift eşiği (%)
+    int         step_pct;           // Step eşiği (%)
+    const char *out_path;           // Binary time-series dosyası
+};
+
+/**
+ * Run continuous monitoring until duration expires or Ctrl+C
+ *
+ * @param config   Test configuration (packet_count = probes per VLAN per round)
+ * @param mon      Monitor configuration
+ * @return         Number of alarms raised, <0 = error
+ */
+int run_latency_monitor(const struct test_config *config, const struct monitor_config *mon);
+
+#endif // MONITOR_H
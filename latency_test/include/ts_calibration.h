@@ -0,0 +1,52 @@
+/**
+ * @file ts_calibration.h
+ * @brief HW Timestamp Latency Test - Timestamp Tier Calibration
+ *
+ * Aynı loopback üzerinde her tier (HW, kernel SW, user-space) ayrı bir
+ * async engine turuyla ölçülür:
+ * - offset: tier'ın en iyi (referans) tier'a göre sabit farkı (VLAN
+ *   bazında ortalamalar farkının ortalaması)
+ * - jitter: tier içi sapma (VLAN ortalamasına göre havuzlanmış stddev)
+ *
+ * Sonuçların hata sınırı = |offset| + jitter; referans tier'ın kendi
+ * mutlak offset'i loopback'ten çıkarılamaz, onun sınırı sadece jitter'dır.
+ */
+
+#ifndef TS_CALIBRATION_H
+#define TS_CALIBRATION_H
+
+#include "common.h"
+
+struct ts_tier_calib {
+    bool     valid;             // Tier bu interface'lerde kurulabildi ve ölçüldü
+    uint32_t samples;
+    double   mean_ns;           // Tüm örneklerin ortalaması
+    double   offset_ns;         // Referans tier'a göre sabit fark
+    double   jitter_ns;         // Tier içi stddev
+};
+
+/**
+ * Tüm tier'ları kalibre et (sonuç modül içinde saklanır)
+ *
+ * @param config    Test configuration (packet_count en az TS_CALIB_PACKETS'e çekilir)
+ * @return          Geçerli tier sayısı, <0 = hata
+ */
+int run_ts_calibration(const struct test_config *config);
+
+/**
+ * Tier'ın kalibrasyonu
+ * @return NULL = kalibre edilmedi / tier kurulamadı
+ */
+const struct ts_tier_calib *ts_calibration_get(ts_tier_t tier);
+
+/**
+ * Tier'ın hata sınırı (ns), 0 = bilinmiyor
+ */
+uint32_t ts_calibration_error_ns(ts_tier_t tier);
+
+/**
+ * Kalibrasyon tablosunu yazdır
+ */
+void print_ts_calibration(void);
+
+#endif // TS_CALIBRATION_H
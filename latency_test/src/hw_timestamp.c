@@ -21,6 +21,7 @@
 #include <linux/net_tstamp.h>
 #include <linux/sockios.h>
 #include <linux/ethtool.h>
+#include <linux/errqueue.h>
 #include <poll.h>
 
 #include "hw_timestamp.h"
@@ -55,32 +56,28 @@ static int get_interface_index(const char *if_name) {
 }
 
 /**
- * cmsg içinden timestamp çıkar
+ * cmsg içinden soketin tier'ına ait timestamp'i çıkar
+ * (HW ve SW saatleri farklı tabanlarda, diğer tier'a düşülmez)
  */
-static bool extract_timestamp_from_cmsg(struct msghdr *msg, uint64_t *timestamp) {
+static bool extract_timestamp_from_cmsg(struct msghdr *msg, ts_tier_t tier, uint64_t *timestamp) {
     struct cmsghdr *cmsg;
 
+    // ts[0] = software timestamp
+    // ts[1] = deprecated
+    // ts[2] = hardware timestamp (raw)
+    int idx = (tier == TS_TIER_HW) ? 2 : (tier == TS_TIER_SW) ? 0 : -1;
+    if (idx < 0) {
+        return false;
+    }
+
     for (cmsg = CMSG_FIRSTHDR(msg); cmsg != NULL; cmsg = CMSG_NXTHDR(msg, cmsg)) {
         if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
             struct timespec *ts = (struct timespec *)CMSG_DATA(cmsg);
 
-            // ts[0] = software timestamp
-            // ts[1] = deprecated
-            // ts[2] = hardware timestamp (raw)
-
-            // Hardware timestamp öncelikli
-            if (ts[2].tv_sec != 0 || ts[2].tv_nsec != 0) {
-                *timestamp = timespec_to_ns(&ts[2]);
-                LOG_TRACE("Extracted HW timestamp: %lu.%09lu (raw)",
-                         ts[2].tv_sec, ts[2].tv_nsec);
-                return true;
-            }
-
-            // Software timestamp fallback
-            if (ts[0].tv_sec != 0 || ts[0].tv_nsec != 0) {
-                *timestamp = timespec_to_ns(&ts[0]);
-                LOG_WARN("Using SW timestamp (HW not available): %lu.%09lu",
-                        ts[0].tv_sec, ts[0].tv_nsec);
+            if (ts[idx].tv_sec != 0 || ts[idx].tv_nsec != 0) {
+                *timestamp = timespec_to_ns(&ts[idx]);
+                LOG_TRACE("Extracted %s timestamp: %lu.%09lu",
+                         ts_tier_name(tier), ts[idx].tv_sec, ts[idx].tv_nsec);
                 return true;
             }
         }
@@ -89,6 +86,59 @@ static bool extract_timestamp_from_cmsg(struct msghdr *msg, uint64_t *timestamp)
     return false;
 }
 
+/**
+ * ETHTOOL_GET_TS_INFO so_timestamping bayrakları (sessiz)
+ * @return Bayraklar, -1 = sorgulanamadı
+ */
+static int query_ts_caps(const char *if_name) {
+    int sock = socket(AF_INET, SOCK_DGRAM, 0);
+    if (sock < 0) {
+        return -1;
+    }
+
+    struct ethtool_ts_info ts_info;
+    memset(&ts_info, 0, sizeof(ts_info));
+    ts_info.cmd = ETHTOOL_GET_TS_INFO;
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, if_name, IFNAMSIZ - 1);
+    ifr.ifr_data = (void *)&ts_info;
+
+    int ret = ioctl(sock, SIOCETHTOOL, &ifr);
+    close(sock);
+    return ret < 0 ? -1 : (int)ts_info.so_timestamping;
+}
+
+/**
+ * Tier ve soket tipi için SO_TIMESTAMPING bayrakları
+ */
+static int tier_ts_flags(socket_type_t type, ts_tier_t tier) {
+    bool tx = (type != SOCK_TYPE_RX);
+    bool rx = (type != SOCK_TYPE_TX);
+    int flags = 0;
+
+    if (tier == TS_TIER_HW) {
+        flags = SOF_TIMESTAMPING_RAW_HARDWARE;
+        if (tx) flags |= SOF_TIMESTAMPING_TX_HARDWARE;
+        if (rx) flags |= SOF_TIMESTAMPING_RX_HARDWARE;
+    } else if (tier == TS_TIER_SW) {
+        flags = SOF_TIMESTAMPING_SOFTWARE;
+        if (tx) flags |= SOF_TIMESTAMPING_TX_SOFTWARE;
+        if (rx) flags |= SOF_TIMESTAMPING_RX_SOFTWARE;
+    } else {
+        return 0;
+    }
+
+    if (tx) {
+        flags |= SOF_TIMESTAMPING_OPT_TSONLY;     // Timestamp only, no packet echo
+    }
+    if (type == SOCK_TYPE_TXRX) {
+        flags |= SOF_TIMESTAMPING_OPT_ID;         // Error queue mesajı gönderim sırasını taşır
+    }
+    return flags;
+}
+
 // ============================================
 // PUBLIC FUNCTIONS
 // ============================================
@@ -184,8 +234,10 @@ int create_hw_timestamp_socket(const char *if_name, socket_type_t type, struct h
     strncpy(sock->if_name, if_name, sizeof(sock->if_name) - 1);
     sock->type = type;
 
-    LOG_DEBUG("Creating %s socket for interface %s",
-             type == SOCK_TYPE_TX ? "TX" : "RX", if_name);
+    const char *type_name = (type == SOCK_TYPE_TX) ? "TX" :
+                            (type == SOCK_TYPE_RX) ? "RX" : "TX/RX";
+
+    LOG_DEBUG("Creating %s socket for interface %s", type_name, if_name);
 
     // Get interface index
     sock->if_index = get_interface_index(if_name);
@@ -215,7 +267,7 @@ int create_hw_timestamp_socket(const char *if_name, socket_type_t type, struct h
     }
 
     // Enable promiscuous mode for RX socket (needed for multicast packets)
-    if (type == SOCK_TYPE_RX) {
+    if (type != SOCK_TYPE_TX) {
         struct packet_mreq mreq;
         memset(&mreq, 0, sizeof(mreq));
         mreq.mr_ifindex = sock->if_index;
@@ -229,53 +281,102 @@ int create_hw_timestamp_socket(const char *if_name, socket_type_t type, struct h
         }
     }
 
-    // Enable hardware timestamping
-    int ts_flags = SOF_TIMESTAMPING_RAW_HARDWARE;
+    // Interface'in en iyi tier'ı: HW için TX/RX hardware + raw, SW TX için
+    // sürücünün skb_tx_timestamp() çağırması gerekir (RX software her zaman var)
+    bool need_tx = (type != SOCK_TYPE_RX);
+    bool need_rx = (type != SOCK_TYPE_TX);
+    int caps = query_ts_caps(if_name);
 
-    if (type == SOCK_TYPE_TX) {
-        ts_flags |= SOF_TIMESTAMPING_TX_HARDWARE;
-        ts_flags |= SOF_TIMESTAMPING_OPT_TSONLY;  // Timestamp only, no packet echo
-    } else {
-        ts_flags |= SOF_TIMESTAMPING_RX_HARDWARE;
-    }
+    bool hw_ok = caps >= 0 && (caps & SOF_TIMESTAMPING_RAW_HARDWARE) &&
+                 (!need_tx || (caps & SOF_TIMESTAMPING_TX_HARDWARE)) &&
+                 (!need_rx || (caps & SOF_TIMESTAMPING_RX_HARDWARE));
+    bool sw_ok = caps < 0 || !need_tx || (caps & SOF_TIMESTAMPING_TX_SOFTWARE);
 
-    if (setsockopt(sock->fd, SOL_SOCKET, SO_TIMESTAMPING, &ts_flags, sizeof(ts_flags)) < 0) {
-        LOG_ERROR_ERRNO("Failed to enable SO_TIMESTAMPING on %s", if_name);
-        close(sock->fd);
-        sock->fd = -1;
-        return -4;
-    }
+    sock->best_tier = hw_ok ? TS_TIER_HW : sw_ok ? TS_TIER_SW : TS_TIER_USER;
 
-    // Enable hardware timestamping on the NIC (SIOCSHWTSTAMP)
-    struct ifreq ifr;
-    struct hwtstamp_config hwts_config;
+    if (hw_ok) {
+        // Enable hardware timestamping on the NIC (SIOCSHWTSTAMP)
+        struct ifreq ifr;
+        struct hwtstamp_config hwts_config;
 
-    memset(&ifr, 0, sizeof(ifr));
-    memset(&hwts_config, 0, sizeof(hwts_config));
-    strncpy(ifr.ifr_name, if_name, IFNAMSIZ - 1);
+        memset(&ifr, 0, sizeof(ifr));
+        memset(&hwts_config, 0, sizeof(hwts_config));
+        strncpy(ifr.ifr_name, if_name, IFNAMSIZ - 1);
 
-    hwts_config.tx_type = (type == SOCK_TYPE_TX) ? HWTSTAMP_TX_ON : HWTSTAMP_TX_OFF;
-    hwts_config.rx_filter = (type == SOCK_TYPE_RX) ? HWTSTAMP_FILTER_ALL : HWTSTAMP_FILTER_NONE;
+        // NIC ayarı interface geneli: TXRX soketi iki yönü birden açar
+        hwts_config.tx_type = need_tx ? HWTSTAMP_TX_ON : HWTSTAMP_TX_OFF;
+        hwts_config.rx_filter = need_rx ? HWTSTAMP_FILTER_ALL : HWTSTAMP_FILTER_NONE;
 
-    ifr.ifr_data = (void *)&hwts_config;
+        ifr.ifr_data = (void *)&hwts_config;
 
-    if (ioctl(sock->fd, SIOCSHWTSTAMP, &ifr) < 0) {
-        // Some drivers don't support SIOCSHWTSTAMP, try to continue anyway
-        LOG_WARN("SIOCSHWTSTAMP failed for %s (may still work): %s",
-                if_name, strerror(errno));
-    } else {
-        LOG_DEBUG("SIOCSHWTSTAMP configured for %s: tx_type=%d, rx_filter=%d",
-                 if_name, hwts_config.tx_type, hwts_config.rx_filter);
+        if (ioctl(sock->fd, SIOCSHWTSTAMP, &ifr) < 0) {
+            // Some drivers don't support SIOCSHWTSTAMP, try to continue anyway
+            LOG_WARN("SIOCSHWTSTAMP failed for %s (may still work): %s",
+                    if_name, strerror(errno));
+        } else {
+            LOG_DEBUG("SIOCSHWTSTAMP configured for %s: tx_type=%d, rx_filter=%d",
+                     if_name, hwts_config.tx_type, hwts_config.rx_filter);
+        }
     }
 
-    sock->hw_ts_enabled = true;
+    if (hw_socket_set_tier(sock, sock->best_tier) != TS_TIER_HW) {
+        LOG_INFO("%s: no HW timestamping, using %s timestamps", if_name, ts_tier_name(sock->tier));
+    }
+
+#ifdef PACKET_IGNORE_OUTGOING
+    // TXRX soketi kendi gönderdiği paketlerin kopyasını almasın
+    if (type == SOCK_TYPE_TXRX) {
+        int ignore = 1;
+        if (setsockopt(sock->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &ignore, sizeof(ignore)) < 0) {
+            LOG_DEBUG("PACKET_IGNORE_OUTGOING not supported on %s: %s", if_name, strerror(errno));
+        }
+    }
+#endif
 
-    LOG_INFO("Created %s socket for %s (fd=%d, if_index=%d)",
-            type == SOCK_TYPE_TX ? "TX" : "RX", if_name, sock->fd, sock->if_index);
+    LOG_INFO("Created %s socket for %s (fd=%d, if_index=%d, tier=%s)",
+            type_name, if_name, sock->fd, sock->if_index, ts_tier_name(sock->tier));
 
     return 0;
 }
 
+ts_tier_t hw_socket_set_tier(struct hw_socket *sock, ts_tier_t tier) {
+    for (ts_tier_t t = MAX(tier, sock->best_tier); t < TS_TIER_USER; t++) {
+        int flags = tier_ts_flags(sock->type, t);
+        if (setsockopt(sock->fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) == 0) {
+            sock->tier = t;
+            sock->hw_ts_enabled = (t == TS_TIER_HW);
+            return t;
+        }
+        LOG_DEBUG("SO_TIMESTAMPING (%s) failed on %s: %s",
+                 ts_tier_name(t), sock->if_name, strerror(errno));
+    }
+
+    // USER: kernel timestamp'i kapat, error queue'ya mesaj gelmesin
+    int off = 0;
+    setsockopt(sock->fd, SOL_SOCKET, SO_TIMESTAMPING, &off, sizeof(off));
+    sock->tier = TS_TIER_USER;
+    sock->hw_ts_enabled = false;
+    return TS_TIER_USER;
+}
+
+ts_tier_t hw_sockets_align_tier(struct hw_socket **socks, int count, ts_tier_t cap) {
+    ts_tier_t tier = cap;
+
+    // Bir soket istenen tier'ı kuramazsa alt tier'a düşer: sabitlenene kadar tekrar
+    for (bool changed = true; changed; ) {
+        changed = false;
+        for (int i = 0; i < count; i++) {
+            tier = MAX(tier, socks[i]->tier);
+        }
+        for (int i = 0; i < count; i++) {
+            if (socks[i]->tier != tier && hw_socket_set_tier(socks[i], tier) != tier) {
+                changed = true;
+            }
+        }
+    }
+    return tier;
+}
+
 void close_hw_timestamp_socket(struct hw_socket *sock) {
     if (sock && sock->fd >= 0) {
         LOG_DEBUG("Closing socket for %s (fd=%d)", sock->if_name, sock->fd);
@@ -301,6 +402,7 @@ int send_packet_get_tx_timestamp(struct hw_socket *sock,
     sll.sll_halen = ETH_ALEN;
     memcpy(sll.sll_addr, packet, ETH_ALEN);  // Destination MAC
 
+    uint64_t user_ts = get_time_ns();
     ssize_t sent = sendto(sock->fd, packet, packet_len, 0,
                           (struct sockaddr *)&sll, sizeof(sll));
 
@@ -313,6 +415,11 @@ int send_packet_get_tx_timestamp(struct hw_socket *sock,
         LOG_WARN("Partial send on %s: %zd/%zu bytes", sock->if_name, sent, packet_len);
     }
 
+    if (sock->tier == TS_TIER_USER) {
+        *tx_timestamp = user_ts;
+        return 0;
+    }
+
     LOG_TRACE("Sent %zd bytes, waiting for TX timestamp...", sent);
 
     // Wait for TX timestamp from error queue
@@ -363,7 +470,7 @@ int send_packet_get_tx_timestamp(struct hw_socket *sock,
     }
 
     // Extract timestamp from control message
-    if (!extract_timestamp_from_cmsg(&msg, tx_timestamp)) {
+    if (!extract_timestamp_from_cmsg(&msg, sock->tier, tx_timestamp)) {
         LOG_WARN("No timestamp in TX error queue message on %s", sock->if_name);
         return -6;
     }
@@ -417,9 +524,13 @@ int recv_packet_get_rx_timestamp(struct hw_socket *sock,
     msg.msg_control = ctrl_buf;
     msg.msg_controllen = sizeof(ctrl_buf);
 
-    ssize_t recv_len = recvmsg(sock->fd, &msg, 0);
+    // POLLERR (yalnızca error queue dolu) da poll'u uyandırır; bloklama
+    ssize_t recv_len = recvmsg(sock->fd, &msg, MSG_DONTWAIT);
 
     if (recv_len < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return -1;  // Normal kuyrukta paket yok
+        }
         LOG_ERROR_ERRNO("recvmsg() failed on %s", sock->if_name);
         return -3;
     }
@@ -430,7 +541,9 @@ int recv_packet_get_rx_timestamp(struct hw_socket *sock,
     hex_dump("RX Packet", packet, MIN(recv_len, 64));
 
     // Extract timestamp
-    if (!extract_timestamp_from_cmsg(&msg, rx_timestamp)) {
+    if (sock->tier == TS_TIER_USER) {
+        *rx_timestamp = get_time_ns();
+    } else if (!extract_timestamp_from_cmsg(&msg, sock->tier, rx_timestamp)) {
         LOG_WARN("No RX timestamp in message on %s", sock->if_name);
         // Packet received even without timestamp, continue
     } else {
@@ -439,3 +552,84 @@ int recv_packet_get_rx_timestamp(struct hw_socket *sock,
 
     return 0;
 }
+
+int send_packet_async(struct hw_socket *sock, const uint8_t *packet, size_t packet_len,
+                      uint64_t *tx_timestamp) {
+    LOG_TRACE("Sending packet on %s (%zu bytes, async)", sock->if_name, packet_len);
+    hex_dump("TX Packet", packet, MIN(packet_len, 64));
+
+    struct sockaddr_ll sll;
+    memset(&sll, 0, sizeof(sll));
+    sll.sll_family = AF_PACKET;
+    sll.sll_ifindex = sock->if_index;
+    sll.sll_halen = ETH_ALEN;
+    memcpy(sll.sll_addr, packet, ETH_ALEN);  // Destination MAC
+
+    *tx_timestamp = (sock->tier == TS_TIER_USER) ? get_time_ns() : 0;
+    ssize_t sent = sendto(sock->fd, packet, packet_len, MSG_DONTWAIT,
+                          (struct sockaddr *)&sll, sizeof(sll));
+
+    if (sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) {
+            return -1;
+        }
+        LOG_ERROR_ERRNO("sendto() failed on %s", sock->if_name);
+        return -2;
+    }
+
+    if ((size_t)sent != packet_len) {
+        LOG_WARN("Partial send on %s: %zd/%zu bytes", sock->if_name, sent, packet_len);
+    }
+
+    return 0;
+}
+
+int recv_tx_timestamp_async(struct hw_socket *sock, uint32_t *tskey, uint64_t *tx_timestamp) {
+    *tx_timestamp = 0;
+
+    uint8_t ctrl_buf[1024];
+    struct iovec iov;
+    uint8_t dummy_buf[1];
+    iov.iov_base = dummy_buf;
+    iov.iov_len = sizeof(dummy_buf);
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = ctrl_buf;
+    msg.msg_controllen = sizeof(ctrl_buf);
+
+    ssize_t recv_len = recvmsg(sock->fd, &msg, MSG_ERRQUEUE | MSG_DONTWAIT);
+
+    if (recv_len < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return -1;
+        }
+        LOG_ERROR_ERRNO("recvmsg(MSG_ERRQUEUE) failed on %s", sock->if_name);
+        return -2;
+    }
+
+    // OPT_ID anahtarı AF_PACKET'te SOL_PACKET/PACKET_TX_TIMESTAMP cmsg'sinde
+    bool have_key = false;
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_PACKET && cmsg->cmsg_type == PACKET_TX_TIMESTAMP) {
+            const struct sock_extended_err *ee = (const struct sock_extended_err *)CMSG_DATA(cmsg);
+            if (ee->ee_errno == ENOMSG && ee->ee_origin == SO_EE_ORIGIN_TIMESTAMPING) {
+                *tskey = ee->ee_data;
+                have_key = true;
+            }
+        }
+    }
+
+    if (!have_key) {
+        LOG_WARN("TX error queue message without OPT_ID on %s", sock->if_name);
+        return -3;
+    }
+
+    if (!extract_timestamp_from_cmsg(&msg, sock->tier, tx_timestamp)) {
+        LOG_WARN("No timestamp in TX error queue message on %s (key=%u)", sock->if_name, *tskey);
+    }
+
+    return 0;
+}
@@ -0,0 +1,643 @@
+/**
+ * @file latency_engine.c
+ * @brief HW Timestamp Latency Test - Asynchronous Multi-Pair Engine
+ *
+ * Tek epoll döngüsü:
+ * - Her interface'in TX kuyruğundan delay_us aralıkla probe gönder
+ *   (interface başına en fazla ENGINE_MAX_INFLIGHT cevap bekleyen)
+ * - EPOLLERR: error queue'dan TX timestamp, OPT_ID -> probe
+ * - EPOLLIN : gelen paket, VL-ID + seq_num -> probe
+ * - timerfd : bir sonraki gönderim / timeout anı
+ * Probe hem RX hem TX timestamp'ini aldığında (veya RX timeout'unda)
+ * kapanır; VLAN'ın tüm probe'ları kapanınca sonuç finalize edilir.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+
+#include "latency_engine.h"
+#include "latency_test.h"
+#include "hw_timestamp.h"
+#include "packet.h"
+#include "common.h"
+#include "config.h"
+
+// Interrupt flag (defined in main.c)
+extern volatile int g_interrupted;
+
+#define ENGINE_MAX_IFACES   (NUM_PORT_PAIRS * 2)
+#define ENGINE_TIMER_TAG    UINT32_MAX
+
+// Monitor modu için probe başına örnek
+static latency_sample_fn g_sample_hook = NULL;
+static void *g_sample_ctx = NULL;
+
+void latency_engine_set_sample_hook(latency_sample_fn fn, void *ctx) {
+    g_sample_hook = fn;
+    g_sample_ctx = ctx;
+}
+
+// ============================================
+// ENGINE STATE
+// ============================================
+
+struct engine_probe {
+    int      result_idx;
+    int      pkt;               // VLAN içindeki paket no (seq_num alt 32 bit)
+    int      tx_if;
+    uint64_t sent_ns;           // CLOCK_MONOTONIC, 0 = henüz gönderilmedi
+    uint32_t tskey;             // OPT_ID
+    uint64_t tx_ts;
+    uint64_t rx_ts;
+    bool     tx_done;           // TX timestamp geldi veya beklemekten vazgeçildi
+    bool     rx_done;
+    bool     finished;
+};
+
+struct engine_iface {
+    const char       *name;
+    struct hw_socket  sock;
+    bool              open;
+
+    uint32_t          next_tskey;                      // Kernel'in sıradaki gönderime vereceği OPT_ID
+    int               tskey_probe[ENGINE_TSKEY_RING];  // OPT_ID % ring -> probe, -1 = boş
+
+    int              *tx_queue;                        // Bu interface'ten gönderilecek probe'lar (sıralı)
+    int               tx_queue_len;
+    int               tx_queue_pos;                    // Sıradaki gönderim
+    int               tx_queue_done;                   // Bundan öncekilerin hepsi kapandı
+    int               inflight;
+    uint64_t          next_send_ns;
+};
+
+struct engine {
+    const struct test_config *config;
+    struct latency_result    *results;
+
+    struct engine_iface ifaces[ENGINE_MAX_IFACES];
+    int                 iface_count;
+
+    struct engine_probe *probes;
+    int                  probe_count;
+    int                  remaining;                    // Kapanmamış probe
+
+    int      first_probe[MAX_RESULTS];                 // -1 = bu turda ölçülmüyor
+    int      open_probes[MAX_RESULTS];
+    int      result_tx_if[MAX_RESULTS];
+    int      result_rx_if[MAX_RESULTS];
+    int16_t *vl_result;                                // VL-ID -> sonuç indeksi, -1 = yok
+
+    int      epfd;
+    int      tfd;
+};
+
+static int engine_iface_index(struct engine *e, const char *name) {
+    for (int i = 0; i < e->iface_count; i++) {
+        if (strcmp(e->ifaces[i].name, name) == 0) {
+            return i;
+        }
+    }
+
+    int i = e->iface_count++;
+    struct engine_iface *ifc = &e->ifaces[i];
+    memset(ifc, 0, sizeof(*ifc));
+    ifc->name = name;
+    ifc->sock.fd = -1;
+    for (int k = 0; k < ENGINE_TSKEY_RING; k++) {
+        ifc->tskey_probe[k] = -1;
+    }
+    return i;
+}
+
+static void engine_fail_result(struct engine *e, int r, const char *msg) {
+    struct latency_result *res = &e->results[r];
+    snprintf(res->error_msg, sizeof(res->error_msg), "%s", msg);
+    res->passed = false;
+    e->first_probe[r] = -1;
+}
+
+// ============================================
+// PROBE LIFECYCLE
+// ============================================
+
+static void engine_probe_finish(struct engine *e, struct engine_probe *p) {
+    struct latency_result *res = &e->results[p->result_idx];
+
+    p->finished = true;
+    e->remaining--;
+    e->ifaces[p->tx_if].inflight--;
+
+    if (p->rx_done) {
+        latency_result_add(res, p->pkt, p->tx_ts, p->rx_ts);
+    } else if (!g_interrupted) {
+        LOG_DEBUG("VLAN %u Pkt[%d] No response received (timeout)", res->vlan_id, p->pkt);
+    }
+
+    if (g_sample_hook != NULL && !g_interrupted) {
+        bool ok = p->rx_done && p->tx_ts > 0 && p->rx_ts > 0;
+        g_sample_hook(g_sample_ctx, p->result_idx, ok, ok ? p->rx_ts - p->tx_ts : 0);
+    }
+
+    if (--e->open_probes[p->result_idx] == 0) {
+        latency_result_finalize(res, e->config);
+    }
+}
+
+/**
+ * Timeout kontrolü; probe açık kalırsa bir sonraki ilgili anı next_deadline'a yaz
+ */
+static void engine_probe_check(struct engine *e, struct engine_probe *p,
+                               uint64_t now, uint64_t *next_deadline) {
+    if (p->finished || p->sent_ns == 0) {
+        return;
+    }
+
+    uint64_t rx_deadline = p->sent_ns + (uint64_t)e->config->timeout_ms * 1000000ULL;
+    uint64_t tx_deadline = p->sent_ns + (uint64_t)ENGINE_TX_TS_TIMEOUT_MS * 1000000ULL;
+
+    if (!p->tx_done && now >= tx_deadline) {
+        LOG_WARN("Timeout waiting for TX timestamp on %s (VLAN %u Pkt[%d])",
+                e->ifaces[p->tx_if].name, e->results[p->result_idx].vlan_id, p->pkt);
+        p->tx_done = true;
+    }
+
+    // RX gelmediyse TX timestamp'ini beklemeye gerek yok
+    if ((p->rx_done && p->tx_done) || (!p->rx_done && now >= rx_deadline)) {
+        engine_probe_finish(e, p);
+        return;
+    }
+
+    uint64_t deadline = p->rx_done ? tx_deadline : rx_deadline;
+    if (deadline < *next_deadline) {
+        *next_deadline = deadline;
+    }
+}
+
+// ============================================
+// EVENT HANDLERS
+// ============================================
+
+static void engine_send_due(struct engine *e, struct engine_iface *ifc, uint64_t now) {
+    uint8_t pkt_buf[2048];
+
+    while (ifc->tx_queue_pos < ifc->tx_queue_len &&
+           ifc->inflight < ENGINE_MAX_INFLIGHT &&
+           now >= ifc->next_send_ns) {
+        int pi = ifc->tx_queue[ifc->tx_queue_pos];
+        struct engine_probe *p = &e->probes[pi];
+        struct latency_result *res = &e->results[p->result_idx];
+
+        // OPT_ID halkasında bu slot'u tutan probe hâlâ TX timestamp bekliyorsa dur
+        int slot = (int)(ifc->next_tskey % ENGINE_TSKEY_RING);
+        int holder = ifc->tskey_probe[slot];
+        if (holder >= 0 && !e->probes[holder].finished) {
+            break;
+        }
+
+        uint64_t seq_num = (uint64_t)res->vlan_id << 32 | (uint64_t)p->pkt;
+        int pkt_len = build_test_packet(pkt_buf, e->config->packet_size,
+                                        res->vlan_id, res->vl_id, seq_num);
+        if (pkt_len < 0) {
+            LOG_ERROR("Failed to build packet %d for VLAN %u", p->pkt, res->vlan_id);
+            p->sent_ns = now;
+            p->tx_done = true;
+            ifc->inflight++;
+            ifc->tx_queue_pos++;
+            engine_probe_finish(e, p);
+            continue;
+        }
+
+        uint64_t user_ts;
+        int ret = send_packet_async(&ifc->sock, pkt_buf, (size_t)pkt_len, &user_ts);
+        if (ret == -1) {
+            break;  // Socket buffer dolu, sonraki turda
+        }
+
+        res->tx_count++;
+        p->sent_ns = now;
+        ifc->inflight++;
+        ifc->tx_queue_pos++;
+        ifc->next_send_ns = now + (uint64_t)e->config->delay_us * 1000ULL;
+
+        if (ret < 0) {
+            LOG_WARN("TX[%d]: Failed to send (VLAN %u, ret=%d)", p->pkt, res->vlan_id, ret);
+            p->tx_done = true;
+            engine_probe_finish(e, p);
+            continue;
+        }
+
+        if (ifc->sock.tier == TS_TIER_USER) {
+            // Error queue'ya mesaj gelmez, OPT_ID sayacı da ilerlemez
+            p->tx_ts = user_ts;
+            p->tx_done = true;
+            continue;
+        }
+
+        p->tskey = ifc->next_tskey++;
+        ifc->tskey_probe[slot] = pi;
+        LOG_TRACE("TX[%d]: VLAN %u seq=%lu key=%u on %s",
+                 p->pkt, res->vlan_id, seq_num, p->tskey, ifc->name);
+    }
+}
+
+static void engine_drain_errqueue(struct engine *e, struct engine_iface *ifc) {
+    uint32_t tskey;
+    uint64_t tx_ts;
+    int ret;
+
+    while ((ret = recv_tx_timestamp_async(&ifc->sock, &tskey, &tx_ts)) != -1) {
+        if (ret < -1) {
+            if (ret == -2) {
+                return;
+            }
+            continue;
+        }
+
+        int pi = ifc->tskey_probe[tskey % ENGINE_TSKEY_RING];
+        if (pi < 0) {
+            continue;
+        }
+        struct engine_probe *p = &e->probes[pi];
+        if (p->tskey != tskey || p->finished || p->tx_done) {
+            continue;
+        }
+
+        p->tx_ts = tx_ts;
+        p->tx_done = true;
+        LOG_TRACE("TX ts: key=%u ts=%lu ns on %s", tskey, tx_ts, ifc->name);
+
+        if (p->rx_done) {
+            engine_probe_finish(e, p);
+        }
+    }
+}
+
+static void engine_drain_rx(struct engine *e, int if_idx) {
+    struct engine_iface *ifc = &e->ifaces[if_idx];
+    uint8_t rx_buf[2048];
+
+    for (;;) {
+        size_t rx_len = sizeof(rx_buf);
+        uint64_t rx_ts = 0;
+
+        int ret = recv_packet_get_rx_timestamp(&ifc->sock, rx_buf, &rx_len, &rx_ts, 0);
+        if (ret < 0) {
+            return;  // Kuyruk boş (-1) veya hata
+        }
+
+        uint16_t vl_id = extract_vl_id(rx_buf, rx_len);
+        int r = e->vl_result[vl_id];
+        if (r < 0 || e->first_probe[r] < 0 || e->result_rx_if[r] != if_idx) {
+            continue;
+        }
+
+        struct latency_result *res = &e->results[r];
+        if (!is_our_test_packet(rx_buf, rx_len, res->vlan_id, res->vl_id)) {
+            LOG_TRACE("Received non-matching packet (len=%zu), skipping", rx_len);
+            continue;
+        }
+
+        uint64_t rx_seq = extract_seq_num(rx_buf, rx_len);
+        uint32_t pkt = (uint32_t)rx_seq;
+        if ((rx_seq >> 32) != res->vlan_id || pkt >= (uint32_t)e->config->packet_count) {
+            LOG_TRACE("Sequence mismatch on VLAN %u: got=%lu", res->vlan_id, rx_seq);
+            continue;
+        }
+
+        struct engine_probe *p = &e->probes[e->first_probe[r] + (int)pkt];
+        if (p->sent_ns == 0 || p->rx_done || p->finished) {
+            continue;  // Geç gelen veya tekrar eden paket
+        }
+
+        p->rx_ts = rx_ts;
+        p->rx_done = true;
+
+        if (p->tx_done) {
+            engine_probe_finish(e, p);
+        }
+    }
+}
+
+// ============================================
+// SETUP / TEARDOWN
+// ============================================
+
+static int engine_setup(struct engine *e, int *result_count, const bool *rerun) {
+    const struct test_config *config = e->config;
+
+    e->vl_result = malloc(65536 * sizeof(int16_t));
+    if (e->vl_result == NULL) {
+        LOG_ERROR("Failed to allocate VL-ID table");
+        return -1;
+    }
+    memset(e->vl_result, 0xff, 65536 * sizeof(int16_t));
+
+    // Sonuç düzeni run_latency_test() ile aynı
+    int count = 0;
+    int active = 0;
+    for (int p = 0; p < NUM_PORT_PAIRS; p++) {
+        const struct port_pair *pair = &g_port_pairs[p];
+
+        if (config->port_filter >= 0 && pair->tx_port != config->port_filter) {
+            LOG_DEBUG("Skipping port pair %d (filter=%d)", pair->tx_port, config->port_filter);
+            continue;
+        }
+
+        int tx_if = engine_iface_index(e, pair->tx_iface);
+        int rx_if = engine_iface_index(e, pair->rx_iface);
+
+        for (int v = 0; v < pair->vlan_count; v++, count++) {
+            e->first_probe[count] = -1;
+            e->result_tx_if[count] = tx_if;
+            e->result_rx_if[count] = rx_if;
+            e->vl_result[pair->vl_ids[v]] = (int16_t)count;
+
+            if (rerun != NULL && !rerun[count]) {
+                continue;
+            }
+            latency_result_init(&e->results[count], pair->tx_port, pair->rx_port,
+                                pair->vlans[v], pair->vl_ids[v]);
+            e->first_probe[count] = 0;  // Yer tutucu, aşağıda atanır
+            active++;
+        }
+    }
+    *result_count = count;
+
+    if (active == 0) {
+        return 0;
+    }
+
+    // Interface başına tek soket (TX ve RX aynı NIC ayarını paylaşır)
+    for (int i = 0; i < e->iface_count; i++) {
+        bool needed = false;
+        for (int r = 0; r < count; r++) {
+            if (e->first_probe[r] >= 0 && (e->result_tx_if[r] == i || e->result_rx_if[r] == i)) {
+                needed = true;
+                break;
+            }
+        }
+        if (!needed) {
+            continue;
+        }
+
+        int ret = create_hw_timestamp_socket(e->ifaces[i].name, SOCK_TYPE_TXRX, &e->ifaces[i].sock);
+        if (ret < 0) {
+            LOG_ERROR("Failed to create socket for %s: %d", e->ifaces[i].name, ret);
+            e->ifaces[i].sock.fd = -1;
+            continue;
+        }
+        e->ifaces[i].open = true;
+    }
+
+    // Soketler paylaşıldığı için (bir interface bir çiftin TX'i, diğerinin RX'i)
+    // tüm turda tek tier: en kötü interface'inki
+    struct hw_socket *open_socks[ENGINE_MAX_IFACES];
+    int open_count = 0;
+    for (int i = 0; i < e->iface_count; i++) {
+        if (e->ifaces[i].open) {
+            open_socks[open_count++] = &e->ifaces[i].sock;
+        }
+    }
+    ts_tier_t tier = hw_sockets_align_tier(open_socks, open_count, (ts_tier_t)config->ts_tier);
+    if (open_count > 0) {
+        LOG_INFO("Async engine timestamp tier: %s", ts_tier_name(tier));
+    }
+
+    for (int r = 0; r < count; r++) {
+        if (e->first_probe[r] < 0) {
+            continue;
+        }
+        e->results[r].ts_tier = (uint8_t)tier;
+        if (!e->ifaces[e->result_tx_if[r]].open) {
+            engine_fail_result(e, r, "TX socket error");
+        } else if (!e->ifaces[e->result_rx_if[r]].open) {
+            engine_fail_result(e, r, "RX socket error");
+        }
+    }
+
+    // Probe'lar VLAN sırasıyla; her interface kendi TX kuyruğunu bu sırayla gönderir
+    int total = 0;
+    for (int r = 0; r < count; r++) {
+        if (e->first_probe[r] >= 0) {
+            total += config->packet_count;
+        }
+    }
+
+    e->probes = calloc((size_t)(total > 0 ? total : 1), sizeof(struct engine_probe));
+    if (e->probes == NULL) {
+        LOG_ERROR("Failed to allocate %d probes", total);
+        return -1;
+    }
+
+    for (int i = 0; i < e->iface_count; i++) {
+        e->ifaces[i].tx_queue = calloc((size_t)(total > 0 ? total : 1), sizeof(int));
+        if (e->ifaces[i].tx_queue == NULL) {
+            LOG_ERROR("Failed to allocate TX queue for %s", e->ifaces[i].name);
+            return -1;
+        }
+    }
+
+    for (int r = 0; r < count; r++) {
+        if (e->first_probe[r] < 0) {
+            continue;
+        }
+        e->first_probe[r] = e->probe_count;
+        e->open_probes[r] = config->packet_count;
+
+        struct engine_iface *ifc = &e->ifaces[e->result_tx_if[r]];
+        for (int k = 0; k < config->packet_count; k++) {
+            int pi = e->probe_count++;
+            e->probes[pi].result_idx = r;
+            e->probes[pi].pkt = k;
+            e->probes[pi].tx_if = e->result_tx_if[r];
+            ifc->tx_queue[ifc->tx_queue_len++] = pi;
+        }
+    }
+    e->remaining = e->probe_count;
+
+    // epoll: interface soketleri + timerfd
+    e->epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (e->epfd < 0) {
+        LOG_ERROR_ERRNO("epoll_create1() failed");
+        return -1;
+    }
+
+    for (int i = 0; i < e->iface_count; i++) {
+        if (!e->ifaces[i].open) {
+            continue;
+        }
+        struct epoll_event ev = { .events = EPOLLIN | EPOLLERR, .data.u32 = (uint32_t)i };
+        if (epoll_ctl(e->epfd, EPOLL_CTL_ADD, e->ifaces[i].sock.fd, &ev) < 0) {
+            LOG_ERROR_ERRNO("epoll_ctl(%s) failed", e->ifaces[i].name);
+            return -1;
+        }
+    }
+
+    if (!config->use_busy_wait) {
+        e->tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (e->tfd < 0) {
+            LOG_ERROR_ERRNO("timerfd_create() failed");
+            return -1;
+        }
+        struct epoll_event ev = { .events = EPOLLIN, .data.u32 = ENGINE_TIMER_TAG };
+        if (epoll_ctl(e->epfd, EPOLL_CTL_ADD, e->tfd, &ev) < 0) {
+            LOG_ERROR_ERRNO("epoll_ctl(timerfd) failed");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void engine_teardown(struct engine *e) {
+    for (int i = 0; i < e->iface_count; i++) {
+        if (e->ifaces[i].open) {
+            close_hw_timestamp_socket(&e->ifaces[i].sock);
+        }
+        free(e->ifaces[i].tx_queue);
+    }
+    if (e->tfd >= 0) {
+        close(e->tfd);
+    }
+    if (e->epfd >= 0) {
+        close(e->epfd);
+    }
+    free(e->probes);
+    free(e->vl_result);
+}
+
+static void engine_arm_timer(struct engine *e, uint64_t deadline_ns) {
+    struct itimerspec its;
+    memset(&its, 0, sizeof(its));
+    its.it_value.tv_sec = (time_t)(deadline_ns / 1000000000ULL);
+    its.it_value.tv_nsec = (long)(deadline_ns % 1000000000ULL);
+    if (its.it_value.tv_sec == 0 && its.it_value.tv_nsec == 0) {
+        its.it_value.tv_nsec = 1;  // 0 timer'ı durdurur
+    }
+    timerfd_settime(e->tfd, TFD_TIMER_ABSTIME, &its, NULL);
+}
+
+// ============================================
+// MAIN LOOP
+// ============================================
+
+int run_latency_engine(const struct test_config *config,
+                       struct latency_result *results,
+                       int *result_count,
+                       const bool *rerun) {
+    struct engine *e = calloc(1, sizeof(*e));
+    if (e == NULL) {
+        LOG_ERROR("Failed to allocate latency engine");
+        return -1;
+    }
+    e->config = config;
+    e->results = results;
+    e->epfd = -1;
+    e->tfd = -1;
+
+    int ret = engine_setup(e, result_count, rerun);
+    if (ret < 0 || e->probe_count == 0) {
+        engine_teardown(e);
+        free(e);
+        return ret;
+    }
+
+    LOG_INFO("Async engine: %d probes on %d interfaces (max %d in flight per interface)",
+            e->probe_count, e->iface_count, ENGINE_MAX_INFLIGHT);
+
+    // Soketlerin tamamen hazır olması için (ilk paket kaybını önler)
+    usleep(10000);  // 10ms
+
+    uint64_t start_ns = get_time_ns();
+    struct epoll_event events[ENGINE_EPOLL_EVENTS];
+
+    while (e->remaining > 0 && !g_interrupted) {
+        uint64_t now = get_time_ns();
+        uint64_t next_deadline = UINT64_MAX;
+
+        for (int i = 0; i < e->iface_count; i++) {
+            struct engine_iface *ifc = &e->ifaces[i];
+            if (!ifc->open) {
+                continue;
+            }
+
+            engine_send_due(e, ifc, now);
+
+            // Uçuştaki probe'lar: tx_queue_done..tx_queue_pos
+            for (int q = ifc->tx_queue_done; q < ifc->tx_queue_pos; q++) {
+                engine_probe_check(e, &e->probes[ifc->tx_queue[q]], now, &next_deadline);
+            }
+            while (ifc->tx_queue_done < ifc->tx_queue_pos &&
+                   e->probes[ifc->tx_queue[ifc->tx_queue_done]].finished) {
+                ifc->tx_queue_done++;
+            }
+
+            if (ifc->tx_queue_pos < ifc->tx_queue_len && ifc->inflight < ENGINE_MAX_INFLIGHT &&
+                ifc->next_send_ns < next_deadline) {
+                next_deadline = ifc->next_send_ns;
+            }
+        }
+
+        if (e->remaining == 0) {
+            break;
+        }
+
+        int timeout = 0;
+        if (!config->use_busy_wait) {
+            if (next_deadline == UINT64_MAX) {
+                timeout = 1;  // Sadece OPT_ID halkası bekleniyor
+            } else {
+                engine_arm_timer(e, next_deadline > now ? next_deadline : now + 1);
+                timeout = -1;
+            }
+        }
+
+        int n = epoll_wait(e->epfd, events, ENGINE_EPOLL_EVENTS, timeout);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR_ERRNO("epoll_wait() failed");
+            break;
+        }
+
+        for (int k = 0; k < n; k++) {
+            uint32_t tag = events[k].data.u32;
+            if (tag == ENGINE_TIMER_TAG) {
+                uint64_t expirations;
+                ssize_t rd __attribute__((unused)) = read(e->tfd, &expirations, sizeof(expirations));
+                continue;
+            }
+            if (events[k].events & EPOLLERR) {
+                engine_drain_errqueue(e, &e->ifaces[tag]);
+            }
+            if (events[k].events & EPOLLIN) {
+                engine_drain_rx(e, (int)tag);
+            }
+        }
+    }
+
+    // Kesinti: açık kalan probe'ları kapat, sonuçlar tutarlı olsun
+    for (int pi = 0; pi < e->probe_count; pi++) {
+        struct engine_probe *p = &e->probes[pi];
+        if (p->finished) {
+            continue;
+        }
+        if (p->sent_ns == 0) {
+            e->ifaces[p->tx_if].inflight++;  // finish() dengesi
+        }
+        p->rx_done = p->rx_done && p->tx_done;
+        engine_probe_finish(e, p);
+    }
+
+    LOG_INFO("Async engine finished in %.2f ms", (double)(get_time_ns() - start_ns) / 1e6);
+
+    engine_teardown(e);
+    free(e);
+    return 0;
+}
@@ -2,7 +2,8 @@
  * @file latency_test.c
  * @brief HW Timestamp Latency Test - Test Logic Implementation
  *
- * Ana test mantığı:
+ * Ana test mantığı (varsayılan: latency_engine.c, tüm çiftler eşzamanlı;
+ * aşağıdaki akış --sequential modudur):
  * - Her port çifti için soket aç (bir kez)
  * - Her VLAN için paket gönder/al
  * - VLAN testleri arasında 32µs bekle
@@ -17,6 +18,8 @@
 #include <errno.h>
 
 #include "latency_test.h"
+#include "latency_engine.h"
+#include "ts_calibration.h"
 #include "hw_timestamp.h"
 #include "packet.h"
 #include "common.h"
@@ -65,6 +68,72 @@ int check_all_interfaces(void) {
     return 0;
 }
 
+// ============================================
+// RESULT ACCUMULATION (sequential + async engine)
+// ============================================
+
+void latency_result_init(struct latency_result *result,
+                         uint16_t tx_port, uint16_t rx_port,
+                         uint16_t vlan_id, uint16_t vl_id) {
+    memset(result, 0, sizeof(*result));
+    result->tx_port = tx_port;
+    result->rx_port = rx_port;
+    result->vlan_id = vlan_id;
+    result->vl_id = vl_id;
+    result->min_latency_ns = UINT64_MAX;
+    result->valid = false;
+}
+
+void latency_result_add(struct latency_result *result, int pkt,
+                        uint64_t tx_ts, uint64_t rx_ts) {
+    result->rx_count++;
+
+    // Calculate latency
+    if (rx_ts > 0 && tx_ts > 0) {
+        uint64_t latency = rx_ts - tx_ts;
+
+        result->total_latency_ns += latency;
+        if (latency < result->min_latency_ns) {
+            result->min_latency_ns = latency;
+        }
+        if (latency > result->max_latency_ns) {
+            result->max_latency_ns = latency;
+        }
+
+        LOG_DEBUG("Pkt[%d] Latency: %lu ns (%.2f us)", pkt, latency, ns_to_us(latency));
+    } else {
+        LOG_WARN("Pkt[%d] Missing timestamp: tx_ts=%lu, rx_ts=%lu", pkt, tx_ts, rx_ts);
+    }
+}
+
+void latency_result_finalize(struct latency_result *result, const struct test_config *config) {
+    result->ts_err_ns = ts_calibration_error_ns((ts_tier_t)result->ts_tier);
+
+    if (result->rx_count > 0) {
+        result->valid = true;
+        if (result->min_latency_ns == UINT64_MAX) {
+            result->min_latency_ns = 0;
+        }
+
+        // Check against threshold (use max latency for pass/fail decision)
+        if (config->max_latency_ns > 0) {
+            result->passed = (result->max_latency_ns <= config->max_latency_ns);
+        } else {
+            result->passed = true;  // No threshold = always pass if packets received
+        }
+    } else {
+        snprintf(result->error_msg, sizeof(result->error_msg), "No packets received");
+        result->passed = false;  // No packets = FAIL
+    }
+
+    LOG_INFO("VLAN %u: TX=%u, RX=%u, Min=%.2f us, Avg=%.2f us, Max=%.2f us, %s",
+            result->vlan_id, result->tx_count, result->rx_count,
+            ns_to_us(result->min_latency_ns),
+            result->rx_count > 0 ? ns_to_us(result->total_latency_ns / result->rx_count) : 0.0,
+            ns_to_us(result->max_latency_ns),
+            result->passed ? "PASS" : "FAIL");
+}
+
 // ============================================
 // SINGLE VLAN TEST (with pre-opened sockets)
 // ============================================
@@ -80,13 +149,8 @@ static int run_single_vlan_test(
     struct latency_result *result)
 {
     // Initialize result
-    memset(result, 0, sizeof(*result));
-    result->tx_port = tx_port;
-    result->rx_port = rx_port;
-    result->vlan_id = vlan_id;
-    result->vl_id = vl_id;
-    result->min_latency_ns = UINT64_MAX;
-    result->valid = false;
+    latency_result_init(result, tx_port, rx_port, vlan_id, vl_id);
+    result->ts_tier = (uint8_t)tx_sock->tier;
 
     LOG_DEBUG("Testing VLAN %u (VL-ID %u): Port %d -> Port %d",
              vlan_id, vl_id, tx_port, rx_port);
@@ -169,24 +233,7 @@ static int run_single_vlan_test(
 
             // Packet matched!
             received = true;
-            result->rx_count++;
-
-            // Calculate latency
-            if (rx_ts > 0 && tx_ts > 0) {
-                uint64_t latency = rx_ts - tx_ts;
-
-                result->total_latency_ns += latency;
-                if (latency < result->min_latency_ns) {
-                    result->min_latency_ns = latency;
-                }
-                if (latency > result->max_latency_ns) {
-                    result->max_latency_ns = latency;
-                }
-
-                LOG_DEBUG("Pkt[%d] Latency: %lu ns (%.2f us)", pkt, latency, ns_to_us(latency));
-            } else {
-                LOG_WARN("Pkt[%d] Missing timestamp: tx_ts=%lu, rx_ts=%lu", pkt, tx_ts, rx_ts);
-            }
+            latency_result_add(result, pkt, tx_ts, rx_ts);
         }
 
         if (!received && !g_interrupted) {
@@ -194,31 +241,7 @@ static int run_single_vlan_test(
         }
     }
 
-    // Finalize result
-    if (result->rx_count > 0) {
-        result->valid = true;
-        if (result->min_latency_ns == UINT64_MAX) {
-            result->min_latency_ns = 0;
-        }
-
-        // Check against threshold (use max latency for pass/fail decision)
-        if (config->max_latency_ns > 0) {
-            result->passed = (result->max_latency_ns <= config->max_latency_ns);
-        } else {
-            result->passed = true;  // No threshold = always pass if packets received
-        }
-    } else {
-        snprintf(result->error_msg, sizeof(result->error_msg), "No packets received");
-        result->passed = false;  // No packets = FAIL
-    }
-
-    LOG_INFO("VLAN %u: TX=%u, RX=%u, Min=%.2f us, Avg=%.2f us, Max=%.2f us, %s",
-            vlan_id, result->tx_count, result->rx_count,
-            ns_to_us(result->min_latency_ns),
-            result->rx_count > 0 ? ns_to_us(result->total_latency_ns / result->rx_count) : 0.0,
-            ns_to_us(result->max_latency_ns),
-            result->passed ? "PASS" : "FAIL");
-
+    latency_result_finalize(result, config);
     return 0;
 }
 
@@ -267,6 +290,11 @@ int run_port_pair_test(const struct port_pair *pair,
         return -2;
     }
 
+    // TX ve RX aynı saat tabanında olmalı
+    struct hw_socket *socks[2] = { &tx_sock, &rx_sock };
+    ts_tier_t tier = hw_sockets_align_tier(socks, 2, (ts_tier_t)config->ts_tier);
+    LOG_DEBUG("Port %d -> Port %d timestamp tier: %s", pair->tx_port, pair->rx_port, ts_tier_name(tier));
+
     // Small delay to let sockets fully initialize before first packet
     // This prevents the first VLAN test from failing
     // 10ms seems to be needed for reliable first packet reception
@@ -318,9 +346,16 @@ int run_latency_test(const struct test_config *config,
     } else {
         LOG_INFO("  Port filter: all");
     }
+    LOG_INFO("  Mode: %s", config->sequential ? "sequential" : "async (all pairs)");
 
     *result_count = 0;
 
+    if (!config->sequential) {
+        int ret = run_latency_engine(config, results, result_count, NULL);
+        LOG_INFO("Latency test completed. Total results: %d", *result_count);
+        return ret;
+    }
+
     for (int p = 0; p < NUM_PORT_PAIRS && !g_interrupted; p++) {
         const struct port_pair *pair = &g_port_pairs[p];
 
@@ -367,6 +402,9 @@ int run_vlan_test(const struct port_pair *pair,
         return -2;
     }
 
+    struct hw_socket *socks[2] = { &tx_sock, &rx_sock };
+    hw_sockets_align_tier(socks, 2, (ts_tier_t)config->ts_tier);
+
     ret = run_single_vlan_test(
         &tx_sock, &rx_sock,
         pair->tx_port, pair->rx_port,
@@ -412,12 +450,22 @@ int run_latency_test_with_retry(const struct test_config *config,
             printf("\n");
         }
 
-        // Clear results for new attempt
-        memset(results, 0, MAX_RESULTS * sizeof(struct latency_result));
-        *result_count = 0;
+        int ret;
+        if (attempt > 1 && !config->sequential) {
+            // Async engine: sadece FAIL olan VLAN'ları tekrar ölç, PASS'ler korunur
+            bool rerun[MAX_RESULTS];
+            for (int i = 0; i < MAX_RESULTS; i++) {
+                rerun[i] = i < *result_count && !results[i].passed;
+            }
+            ret = run_latency_engine(config, results, result_count, rerun);
+        } else {
+            // Clear results for new attempt
+            memset(results, 0, MAX_RESULTS * sizeof(struct latency_result));
+            *result_count = 0;
 
-        // Run the test
-        int ret = run_latency_test(config, results, result_count);
+            // Run the test
+            ret = run_latency_test(config, results, result_count);
+        }
 
         if (ret < 0) {
             LOG_ERROR("Test failed with error: %d", ret);
@@ -16,9 +16,19 @@
  *   -v, --verbose       Verbose output (repeat for more detail)
  *   -c, --csv           CSV format output
  *   -b, --busy-wait     Use busy-wait for precise timing
+ *   -Q, --sequential    Legacy stop-and-wait, one pair at a time
+ *   -M, --monitor <sec> Long-duration monitoring (0 = until Ctrl+C)
+ *       --interval <s>  Monitor report interval
+ *       --round <ms>    Monitor probe round period
+ *       --drift <pct>   Monitor p50 drift alarm threshold
+ *       --step <pct>    Monitor p99 step alarm threshold
+ *       --monitor-out <file>  Monitor binary time-series output
+ *       --ts-tier <t>   Best timestamp tier to use: hw, sw, user
+ *       --calibrate     Calibrate timestamp tiers on the loopback first
  *   -C, --check         Only check interfaces
  *   -I, --info          Show interface HW timestamp info
- *   -S, --shm           Write results to shared memory (for DPDK)
+ *   -S, --shm           Stream results to shared memory (for DPDK / monitors)
+ *   -W, --watch         Follow the shared-memory results of a running test
  *   -h, --help          Help
  */
 
@@ -33,6 +43,9 @@
 #include "config.h"
 #include "hw_timestamp.h"
 #include "latency_test.h"
+#include "monitor.h"
+#include "latency_engine.h"
+#include "ts_calibration.h"
 #include "latency_results_shm.h"
 
 // ============================================
@@ -71,6 +84,105 @@ static void cleanup(void) {
     LOG_DEBUG("Cleanup completed");
 }
 
+// ============================================
+// SHARED MEMORY STREAMING
+// ============================================
+
+static void shm_result_from(struct shm_latency_result *out, const struct latency_result *r) {
+    memset(out, 0, sizeof(*out));
+    out->tx_port = r->tx_port;
+    out->rx_port = r->rx_port;
+    out->vlan_id = r->vlan_id;
+    out->vl_id = r->vl_id;
+    out->tx_count = r->tx_count;
+    out->rx_count = r->rx_count;
+    out->min_latency_ns = r->min_latency_ns;
+    out->max_latency_ns = r->max_latency_ns;
+    out->total_latency_ns = r->total_latency_ns;
+    out->valid = r->valid;
+    out->passed = r->passed;
+    snprintf(out->error_msg, sizeof(out->error_msg), "%s", r->error_msg);
+    out->ts_tier = r->ts_tier;
+    out->ts_err_ns = r->ts_err_ns;
+}
+
+// Engine sample hook: probe olayı + VLAN satırının canlı hali
+static void shm_sample(void *ctx, int result_idx, bool received, uint64_t latency_ns) {
+    (void)ctx;
+    struct shm_latency_result row;
+
+    latency_shm_push_probe(g_shm, result_idx, received, latency_ns);
+    shm_result_from(&row, &g_results[result_idx]);
+    latency_shm_write_result(g_shm, &row, result_idx);
+}
+
+/**
+ * Reader: çalışan testin ring'ini takip et, bitince VLAN tablosunu yazdır
+ */
+static int run_shm_watch(void) {
+    const struct latency_shm_header *shm = NULL;
+
+    while (!g_interrupted && (shm = latency_shm_open_reader()) == NULL) {
+        LOG_INFO("Waiting for '%s'...", LATENCY_SHM_NAME);
+        sleep(1);
+    }
+    if (shm == NULL) {
+        return 1;
+    }
+
+    struct latency_shm_cursor cur;
+    struct shm_latency_probe ev[64];
+    struct shm_latency_result row;
+    latency_shm_cursor_init(shm, &cur);
+
+    printf("Following %s (writer pid %d, generation %u)\n",
+           LATENCY_SHM_NAME, shm->writer_pid, cur.generation);
+
+    while (!g_interrupted) {
+        enum latency_shm_state state = latency_shm_get_state(shm);
+        int n = latency_shm_poll_probes(shm, &cur, ev, 64);
+
+        for (int i = 0; i < n; i++) {
+            uint16_t vlan = 0;
+            if (latency_shm_read_result(shm, ev[i].result_idx, &row) == 0) {
+                vlan = row.vlan_id;
+            }
+            if (ev[i].flags & LATENCY_SHM_PROBE_RECEIVED) {
+                printf("probe %lu VLAN %u %.3f us\n", ev[i].index, vlan, ns_to_us(ev[i].latency_ns));
+            } else {
+                printf("probe %lu VLAN %u LOST\n", ev[i].index, vlan);
+            }
+        }
+
+        if (n == 0) {
+            if (state == LATENCY_SHM_COMPLETE || state == LATENCY_SHM_ABORTED) {
+                break;
+            }
+            usleep(10000);
+        }
+    }
+
+    enum latency_shm_state state = latency_shm_get_state(shm);
+    uint32_t count = __atomic_load_n(&shm->result_count, __ATOMIC_ACQUIRE);
+
+    printf("\nState: %s, %u results, %lu probes missed\n",
+           state == LATENCY_SHM_COMPLETE ? "complete" :
+           state == LATENCY_SHM_ABORTED ? "aborted" : "running", count, cur.lost);
+    for (uint32_t i = 0; i < count; i++) {
+        if (latency_shm_read_result(shm, (int)i, &row) != 0) {
+            continue;
+        }
+        double avg_us = row.rx_count ? ns_to_us(row.total_latency_ns) / row.rx_count : 0.0;
+        printf("P%u->P%u VLAN %u: %u/%u avg %.3f us max %.3f us %s\n",
+               row.tx_port, row.rx_port, row.vlan_id, row.rx_count, row.tx_count,
+               avg_us, ns_to_us(row.max_latency_ns),
+               !row.valid ? "INVALID" : row.passed ? "PASS" : "FAIL");
+    }
+
+    latency_shm_close_reader(shm);
+    return state == LATENCY_SHM_COMPLETE ? 0 : 1;
+}
+
 // ============================================
 // SIGNAL HANDLER
 // ============================================
@@ -100,9 +212,19 @@ static void print_usage(const char *prog) {
     printf("  -v, --verbose       Verbose output (repeat: -vv, -vvv)\n");
     printf("  -c, --csv           CSV format output\n");
     printf("  -b, --busy-wait     Use busy-wait for precise timing\n");
+    printf("  -Q, --sequential    Legacy stop-and-wait, one pair at a time\n");
+    printf("  -M, --monitor <sec> Long-duration monitoring, 0 = until Ctrl+C\n");
+    printf("      --interval <s>  Monitor report interval (default: %d)\n", MONITOR_DEFAULT_INTERVAL_S);
+    printf("      --round <ms>    Monitor probe round period (default: %d)\n", MONITOR_DEFAULT_ROUND_MS);
+    printf("      --drift <pct>   p50 drift alarm over baseline (default: %d)\n", MONITOR_DEFAULT_DRIFT_PCT);
+    printf("      --step <pct>    p99 step alarm between intervals (default: %d)\n", MONITOR_DEFAULT_STEP_PCT);
+    printf("      --monitor-out <file>  Binary time-series (default: %s)\n", MONITOR_DEFAULT_OUT);
+    printf("      --ts-tier <t>   Best timestamp tier: hw, sw, user (default: hw)\n");
+    printf("      --calibrate     Calibrate timestamp tiers (offset/jitter) first\n");
     printf("  -C, --check         Only check interfaces\n");
     printf("  -I, --info          Show interface HW timestamp info\n");
-    printf("  -S, --shm           Write results to shared memory (for DPDK)\n");
+    printf("  -S, --shm           Stream results to shared memory (for DPDK / monitors)\n");
+    printf("  -W, --watch         Follow the shared-memory results of a running test\n");
     printf("  -h, --help          This help message\n");
     printf("\n");
     printf("Examples:\n");
@@ -112,6 +234,7 @@ static void print_usage(const char *prog) {
     printf("  %s -p 2 -n 5          Test only Port 2, 5 packets\n", prog);
     printf("  %s -c > results.csv   Save as CSV\n", prog);
     printf("  %s -I                 Show interface info\n", prog);
+    printf("  %s -M 86400 -n 4      24h soak, 4 probes per VLAN per round\n", prog);
     printf("\n");
     printf("Port Mapping:\n");
     printf("  TX Port -> RX Port | Interfaces           | VLANs\n");
@@ -155,6 +278,8 @@ int main(int argc, char *argv[]) {
         .timeout_ms = DEFAULT_TIMEOUT_MS,
         .port_filter = -1,
         .use_busy_wait = false,
+        .sequential = false,
+        .ts_tier = TS_TIER_HW,
         .max_latency_ns = DEFAULT_MAX_LATENCY_NS,
         .retry_count = DEFAULT_RETRY_COUNT
     };
@@ -162,6 +287,29 @@ int main(int argc, char *argv[]) {
     bool csv_output = false;
     bool check_only = false;
     bool show_info = false;
+    bool watch = false;
+    bool monitor = false;
+    bool calibrate = false;
+
+    struct monitor_config mon = {
+        .duration_s = 0,
+        .interval_s = MONITOR_DEFAULT_INTERVAL_S,
+        .round_ms = MONITOR_DEFAULT_ROUND_MS,
+        .drift_pct = MONITOR_DEFAULT_DRIFT_PCT,
+        .step_pct = MONITOR_DEFAULT_STEP_PCT,
+        .out_path = MONITOR_DEFAULT_OUT
+    };
+
+    // Long-only option codes
+    enum {
+        OPT_INTERVAL = 1000,
+        OPT_ROUND,
+        OPT_DRIFT,
+        OPT_STEP,
+        OPT_MONITOR_OUT,
+        OPT_TS_TIER,
+        OPT_CALIBRATE
+    };
 
     // Long options
     static struct option long_options[] = {
@@ -173,16 +321,26 @@ int main(int argc, char *argv[]) {
         {"verbose",   no_argument,       0, 'v'},
         {"csv",       no_argument,       0, 'c'},
         {"busy-wait", no_argument,       0, 'b'},
+        {"sequential", no_argument,      0, 'Q'},
+        {"monitor",   required_argument, 0, 'M'},
+        {"interval",  required_argument, 0, OPT_INTERVAL},
+        {"round",     required_argument, 0, OPT_ROUND},
+        {"drift",     required_argument, 0, OPT_DRIFT},
+        {"step",      required_argument, 0, OPT_STEP},
+        {"monitor-out", required_argument, 0, OPT_MONITOR_OUT},
+        {"ts-tier",   required_argument, 0, OPT_TS_TIER},
+        {"calibrate", no_argument,       0, OPT_CALIBRATE},
         {"check",     no_argument,       0, 'C'},
         {"info",      no_argument,       0, 'I'},
         {"shm",       no_argument,       0, 'S'},
+        {"watch",     no_argument,       0, 'W'},
         {"help",      no_argument,       0, 'h'},
         {0, 0, 0, 0}
     };
 
     // Parse arguments
     int opt;
-    while ((opt = getopt_long(argc, argv, "n:s:d:T:p:vcbCISh", long_options, NULL)) != -1) {
+    while ((opt = getopt_long(argc, argv, "n:s:d:T:p:vcbQM:CISWh", long_options, NULL)) != -1) {
         switch (opt) {
             case 'n':
                 config.packet_count = atoi(optarg);
@@ -243,6 +401,72 @@ int main(int argc, char *argv[]) {
                 config.use_busy_wait = true;
                 break;
 
+            case 'Q':
+                config.sequential = true;
+                break;
+
+            case 'M':
+                monitor = true;
+                mon.duration_s = atoi(optarg);
+                if (mon.duration_s < 0) {
+                    fprintf(stderr, "Error: Monitor duration cannot be negative\n");
+                    return 1;
+                }
+                break;
+
+            case OPT_INTERVAL:
+                mon.interval_s = atoi(optarg);
+                if (mon.interval_s < 1) {
+                    fprintf(stderr, "Error: Monitor interval must be at least 1s\n");
+                    return 1;
+                }
+                break;
+
+            case OPT_ROUND:
+                mon.round_ms = atoi(optarg);
+                if (mon.round_ms < 10) {
+                    fprintf(stderr, "Error: Monitor round must be at least 10ms\n");
+                    return 1;
+                }
+                break;
+
+            case OPT_DRIFT:
+                mon.drift_pct = atoi(optarg);
+                if (mon.drift_pct < 1) {
+                    fprintf(stderr, "Error: Drift threshold must be at least 1%%\n");
+                    return 1;
+                }
+                break;
+
+            case OPT_STEP:
+                mon.step_pct = atoi(optarg);
+                if (mon.step_pct < 1) {
+                    fprintf(stderr, "Error: Step threshold must be at least 1%%\n");
+                    return 1;
+                }
+                break;
+
+            case OPT_MONITOR_OUT:
+                mon.out_path = optarg;
+                break;
+
+            case OPT_TS_TIER:
+                config.ts_tier = -1;
+                for (int t = TS_TIER_HW; t < TS_TIER_COUNT; t++) {
+                    if (strcmp(optarg, ts_tier_name(t)) == 0) {
+                        config.ts_tier = t;
+                    }
+                }
+                if (config.ts_tier < 0) {
+                    fprintf(stderr, "Error: Timestamp tier must be hw, sw or user\n");
+                    return 1;
+                }
+                break;
+
+            case OPT_CALIBRATE:
+                calibrate = true;
+                break;
+
             case 'C':
                 check_only = true;
                 break;
@@ -255,6 +479,10 @@ int main(int argc, char *argv[]) {
                 g_use_shm = true;
                 break;
 
+            case 'W':
+                watch = true;
+                break;
+
             case 'h':
                 print_usage(argv[0]);
                 return 0;
@@ -265,6 +493,13 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    // Shared-memory reader (root gerekmez)
+    if (watch) {
+        signal(SIGINT, signal_handler);
+        signal(SIGTERM, signal_handler);
+        return run_shm_watch();
+    }
+
     // Check root
     if (geteuid() != 0) {
         fprintf(stderr, "Error: This program requires root privileges.\n");
@@ -316,10 +551,40 @@ int main(int argc, char *argv[]) {
         printf("Retry count: %d\n", config.retry_count);
         printf("Port filter: %s\n", config.port_filter < 0 ? "all" : "specified");
         printf("Wait mode: %s\n", config.use_busy_wait ? "busy-wait" : "sleep");
+        printf("Test mode: %s\n", monitor ? "monitor" : config.sequential ? "sequential" : "async");
+        printf("Timestamp tier: best available, up to %s\n", ts_tier_name(config.ts_tier));
         printf("Debug level: %d\n", g_debug_level);
         printf("\n");
     }
 
+    // Timestamp tier calibration (loopback, async engine)
+    if (calibrate) {
+        LOG_INFO("Calibrating timestamp tiers...");
+        if (run_ts_calibration(&config) <= 0) {
+            LOG_WARN("Timestamp calibration produced no valid tier, errors unknown");
+        }
+        if (!csv_output) {
+            print_ts_calibration();
+        }
+        if (g_interrupted) {
+            return 1;
+        }
+    }
+
+    // Long-duration monitoring (always uses the async engine, no shm export)
+    if (monitor) {
+        if (config.timeout_ms >= mon.round_ms) {
+            config.timeout_ms = mon.round_ms / 2;
+            LOG_INFO("Monitor: RX timeout clamped to %d ms (round %d ms)", config.timeout_ms, mon.round_ms);
+        }
+        int alarms = run_latency_monitor(&config, &mon);
+        if (alarms < 0) {
+            LOG_ERROR("Monitor failed: %d", alarms);
+            return 1;
+        }
+        return alarms > 0 ? 1 : 0;
+    }
+
     // Allocate results (use global pointer for cleanup)
     g_results = calloc(MAX_RESULTS, sizeof(struct latency_result));
     if (!g_results) {
@@ -339,6 +604,11 @@ int main(int argc, char *argv[]) {
         g_shm->packet_count = config.packet_count;
         g_shm->packet_size = config.packet_size;
         g_shm->max_latency_ns = config.max_latency_ns;
+
+        // Async engine probe'ları test sürerken akıtır (sequential modda sadece nihai sonuç)
+        latency_engine_set_sample_hook(shm_sample, NULL);
+        latency_shm_set_state(g_shm, LATENCY_SHM_RUNNING);
+        LOG_INFO("Streaming results to shared memory '%s'", LATENCY_SHM_NAME);
     }
 
     int result_count = 0;
@@ -369,25 +639,12 @@ int main(int argc, char *argv[]) {
     if (g_use_shm && g_shm && result_count > 0) {
         LOG_INFO("Writing results to shared memory...");
 
-        // Copy results to shared memory
-        // Note: struct latency_result and struct shm_latency_result have the same layout
+        latency_engine_set_sample_hook(NULL, NULL);
+
+        // Nihai (finalize edilmiş) satırlar
         for (int i = 0; i < result_count; i++) {
             struct shm_latency_result shm_result;
-            const struct latency_result *r = &g_results[i];
-
-            shm_result.tx_port = r->tx_port;
-            shm_result.rx_port = r->rx_port;
-            shm_result.vlan_id = r->vlan_id;
-            shm_result.vl_id = r->vl_id;
-            shm_result.tx_count = r->tx_count;
-            shm_result.rx_count = r->rx_count;
-            shm_result.min_latency_ns = r->min_latency_ns;
-            shm_result.max_latency_ns = r->max_latency_ns;
-            shm_result.total_latency_ns = r->total_latency_ns;
-            shm_result.valid = r->valid;
-            shm_result.passed = r->passed;
-            strncpy(shm_result.error_msg, r->error_msg, sizeof(shm_result.error_msg) - 1);
-
+            shm_result_from(&shm_result, &g_results[i]);
             latency_shm_write_result(g_shm, &shm_result, i);
         }
 
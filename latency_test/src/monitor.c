@@ -0,0 +1,372 @@
+/**
+ * @file monitor.c
+ * @brief HW Timestamp Latency Test - Long-Duration Monitoring
+ *
+ * Round döngüsü:
+ * - run_latency_engine() ile tüm VLAN'lara probe (sample hook -> histogram)
+ * - Interval dolunca VLAN başına kayıt + alarm kontrolü, histogram sıfırla
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+
+#include "monitor.h"
+#include "latency_engine.h"
+#include "latency_test.h"
+#include "common.h"
+#include "config.h"
+
+// Interrupt flag (defined in main.c)
+extern volatile int g_interrupted;
+
+// ============================================
+// LOG-LINEAR HISTOGRAM
+// ============================================
+// [0, 8) ns birebir; üstünde her 2'nin kuvveti 8 alt bucket'a bölünür.
+// 64 bit aralığın tamamı 496 bucket'a sığar.
+
+#define MON_SUB_BITS    3
+#define MON_SUB         (1 << MON_SUB_BITS)
+#define MON_BUCKETS     ((64 - MON_SUB_BITS + 1) * MON_SUB)
+
+static inline int mon_bucket(uint64_t v) {
+    if (v < MON_SUB) {
+        return (int)v;
+    }
+    int e = 63 - __builtin_clzll(v);
+    int sub = (int)((v >> (e - MON_SUB_BITS)) & (MON_SUB - 1));
+    return (e - MON_SUB_BITS + 1) * MON_SUB + sub;
+}
+
+/** Bucket'ın üst sınırı (ns) */
+static inline uint64_t mon_bucket_upper(int b) {
+    if (b < MON_SUB) {
+        return (uint64_t)b;
+    }
+    int e = b / MON_SUB + MON_SUB_BITS - 1;
+    int sub = b % MON_SUB;
+    return ((uint64_t)(MON_SUB + sub + 1) << (e - MON_SUB_BITS)) - 1;
+}
+
+// ============================================
+// PER-VLAN STATE
+// ============================================
+
+struct monitor_vlan {
+    uint32_t hist[MON_BUCKETS];
+    uint32_t samples;
+    uint32_t lost;
+    uint64_t max_ns;
+
+    // Baseline: ilk MONITOR_BASELINE_INTERVALS dolu interval'in p50'si
+    uint32_t base_p50[MONITOR_BASELINE_INTERVALS];
+    int      base_count;
+    uint32_t baseline_ns;           // 0 = henüz yok
+
+    uint32_t prev_p99;
+    int      drift_run;             // Eşik üstü ardışık interval
+    bool     drift_alarm;
+};
+
+struct monitor_state {
+    const struct monitor_config *mon;
+    struct monitor_vlan vlans[MAX_RESULTS];
+    int      vlan_count;
+    FILE    *out;
+    int      alarms;
+};
+
+static uint64_t realtime_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void monitor_sample(void *ctx, int result_idx, bool received, uint64_t latency_ns) {
+    struct monitor_state *st = ctx;
+    if (result_idx < 0 || result_idx >= st->vlan_count) {
+        return;
+    }
+
+    struct monitor_vlan *v = &st->vlans[result_idx];
+    if (!received) {
+        v->lost++;
+        return;
+    }
+
+    v->hist[mon_bucket(latency_ns)]++;
+    v->samples++;
+    if (latency_ns > v->max_ns) {
+        v->max_ns = latency_ns;
+    }
+}
+
+static uint32_t hist_percentile(const struct monitor_vlan *v, double q) {
+    uint64_t target = (uint64_t)((double)v->samples * q);
+    if (target >= v->samples) {
+        target = v->samples - 1;
+    }
+
+    uint64_t seen = 0;
+    for (int b = 0; b < MON_BUCKETS; b++) {
+        seen += v->hist[b];
+        if (seen > target) {
+            uint64_t upper = mon_bucket_upper(b);
+            return (uint32_t)MIN(MIN(upper, v->max_ns), (uint64_t)UINT32_MAX);
+        }
+    }
+    return (uint32_t)MIN(v->max_ns, (uint64_t)UINT32_MAX);
+}
+
+static int cmp_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// ============================================
+// INTERVAL CLOSE
+// ============================================
+
+static void monitor_close_interval(struct monitor_state *st, const struct latency_result *results) {
+    const struct monitor_config *mon = st->mon;
+    uint64_t t_ns = realtime_ns();
+
+    for (int i = 0; i < st->vlan_count; i++) {
+        struct monitor_vlan *v = &st->vlans[i];
+        const struct latency_result *r = &results[i];
+        struct monitor_record rec;
+
+        memset(&rec, 0, sizeof(rec));
+        rec.t_ns = t_ns;
+        rec.vlan_idx = (uint16_t)i;
+        rec.samples = v->samples;
+        rec.lost = v->lost;
+
+        if (v->lost > 0) {
+            rec.flags |= MONITOR_FLAG_LOSS;
+        }
+
+        if (v->samples == 0) {
+            rec.flags |= MONITOR_FLAG_NO_DATA;
+        } else {
+            rec.p50_ns = hist_percentile(v, 0.50);
+            rec.p99_ns = hist_percentile(v, 0.99);
+            rec.max_ns = (uint32_t)MIN(v->max_ns, (uint64_t)UINT32_MAX);
+
+            if (v->baseline_ns == 0) {
+                rec.flags |= MONITOR_FLAG_BASELINE;
+                v->base_p50[v->base_count++] = rec.p50_ns;
+                if (v->base_count == MONITOR_BASELINE_INTERVALS) {
+                    uint32_t sorted[MONITOR_BASELINE_INTERVALS];
+                    memcpy(sorted, v->base_p50, sizeof(sorted));
+                    qsort(sorted, MONITOR_BASELINE_INTERVALS, sizeof(sorted[0]), cmp_u32);
+                    v->baseline_ns = MAX(sorted[MONITOR_BASELINE_INTERVALS / 2], 1U);
+                    LOG_INFO("VLAN %u: baseline p50 = %.2f us", r->vlan_id, ns_to_us(v->baseline_ns));
+                }
+            } else {
+                uint64_t limit = (uint64_t)v->baseline_ns * (100 + mon->drift_pct) / 100;
+                if (rec.p50_ns > limit) {
+                    v->drift_run++;
+                } else {
+                    v->drift_run = 0;
+                    if (v->drift_alarm) {
+                        LOG_INFO("VLAN %u: drift cleared (p50 %.2f us)", r->vlan_id, ns_to_us(rec.p50_ns));
+                    }
+                    v->drift_alarm = false;
+                }
+
+                if (v->drift_run >= MONITOR_DRIFT_HOLD) {
+                    rec.flags |= MONITOR_FLAG_DRIFT;
+                    if (!v->drift_alarm) {
+                        LOG_WARN("ALARM VLAN %u (P%u->P%u): p50 drift %.2f us -> %.2f us (+%.0f%%)",
+                                r->vlan_id, r->tx_port, r->rx_port,
+                                ns_to_us(v->baseline_ns), ns_to_us(rec.p50_ns),
+                                ((double)rec.p50_ns / v->baseline_ns - 1.0) * 100.0);
+                        st->alarms++;
+                    }
+                    v->drift_alarm = true;
+                }
+            }
+
+            if (v->prev_p99 > 0 &&
+                rec.p99_ns > (uint64_t)v->prev_p99 * (100 + mon->step_pct) / 100 &&
+                rec.p99_ns - v->prev_p99 >= MONITOR_STEP_MIN_NS) {
+                rec.flags |= MONITOR_FLAG_STEP;
+                LOG_WARN("ALARM VLAN %u (P%u->P%u): p99 step %.2f us -> %.2f us",
+                        r->vlan_id, r->tx_port, r->rx_port,
+                        ns_to_us(v->prev_p99), ns_to_us(rec.p99_ns));
+                st->alarms++;
+            }
+            v->prev_p99 = rec.p99_ns;
+        }
+
+        if (st->out != NULL && fwrite(&rec, sizeof(rec), 1, st->out) != 1) {
+            LOG_ERROR_ERRNO("Failed to write monitor record");
+            fclose(st->out);
+            st->out = NULL;
+        }
+
+        LOG_DEBUG("VLAN %u: n=%u lost=%u p50=%.2f p99=%.2f max=%.2f us flags=0x%x",
+                 r->vlan_id, rec.samples, rec.lost, ns_to_us(rec.p50_ns),
+                 ns_to_us(rec.p99_ns), ns_to_us(rec.max_ns), rec.flags);
+
+        // Sonraki interval
+        memset(v->hist, 0, sizeof(v->hist));
+        v->samples = 0;
+        v->lost = 0;
+        v->max_ns = 0;
+    }
+
+    if (st->out != NULL) {
+        fflush(st->out);
+    }
+}
+
+/**
+ * VLAN slotlarını engine'in sonuç düzeniyle (g_port_pairs sırası, port
+ * filtresi) kur: ilk round'un örnekleri de sayılsın diye döngüden önce
+ */
+static void monitor_init_vlans(struct monitor_state *st, const struct test_config *config,
+                               struct latency_result *results) {
+    int count = 0;
+    for (int p = 0; p < NUM_PORT_PAIRS; p++) {
+        const struct port_pair *pair = &g_port_pairs[p];
+        if (config->port_filter >= 0 && pair->tx_port != config->port_filter) {
+            continue;
+        }
+        for (int v = 0; v < pair->vlan_count && count < MAX_RESULTS; v++, count++) {
+            latency_result_init(&results[count], pair->tx_port, pair->rx_port,
+                                pair->vlans[v], pair->vl_ids[v]);
+        }
+    }
+    st->vlan_count = count;
+}
+
+// ============================================
+// MAIN LOOP
+// ============================================
+
+static int monitor_write_header(struct monitor_state *st, const struct latency_result *results) {
+    struct monitor_file_header hdr = {
+        .magic = MONITOR_FILE_MAGIC,
+        .version = MONITOR_FILE_VERSION,
+        .vlan_count = (uint16_t)st->vlan_count,
+        .interval_ms = (uint32_t)st->mon->interval_s * 1000U,
+        .round_ms = (uint32_t)st->mon->round_ms,
+        .start_realtime_ns = realtime_ns()
+    };
+
+    if (fwrite(&hdr, sizeof(hdr), 1, st->out) != 1) {
+        return -1;
+    }
+    for (int i = 0; i < st->vlan_count; i++) {
+        struct monitor_file_vlan fv = {
+            .tx_port = results[i].tx_port,
+            .rx_port = results[i].rx_port,
+            .vlan_id = results[i].vlan_id,
+            .vl_id = results[i].vl_id
+        };
+        if (fwrite(&fv, sizeof(fv), 1, st->out) != 1) {
+            return -1;
+        }
+    }
+    fflush(st->out);
+    return 0;
+}
+
+int run_latency_monitor(const struct test_config *config, const struct monitor_config *mon) {
+    struct monitor_state *st = calloc(1, sizeof(*st));
+    struct latency_result *results = calloc(MAX_RESULTS, sizeof(struct latency_result));
+    if (st == NULL || results == NULL) {
+        LOG_ERROR("Failed to allocate monitor state");
+        free(st);
+        free(results);
+        return -1;
+    }
+    st->mon = mon;
+
+    st->out = fopen(mon->out_path, "wb");
+    if (st->out == NULL) {
+        LOG_ERROR_ERRNO("Cannot open monitor output '%s'", mon->out_path);
+        free(st);
+        free(results);
+        return -1;
+    }
+
+    LOG_WARN("Monitor mode: round %d ms, interval %d s, duration %s, drift %d%%, step %d%% -> %s",
+            mon->round_ms, mon->interval_s, mon->duration_s > 0 ? "limited" : "until Ctrl+C",
+            mon->drift_pct, mon->step_pct, mon->out_path);
+
+    monitor_init_vlans(st, config, results);
+    if (monitor_write_header(st, results) < 0) {
+        LOG_ERROR_ERRNO("Failed to write monitor header");
+        fclose(st->out);
+        free(st);
+        free(results);
+        return -1;
+    }
+
+    latency_engine_set_sample_hook(monitor_sample, st);
+
+    uint64_t start_ns = get_time_ns();
+    uint64_t end_ns = mon->duration_s > 0 ? start_ns + (uint64_t)mon->duration_s * 1000000000ULL : UINT64_MAX;
+    uint64_t interval_ns = (uint64_t)mon->interval_s * 1000000000ULL;
+    uint64_t round_ns = (uint64_t)mon->round_ms * 1000000ULL;
+    uint64_t interval_end = start_ns + interval_ns;
+    uint64_t next_round = start_ns;
+    int intervals = 0;
+    int ret = 0;
+
+    while (!g_interrupted && get_time_ns() < end_ns) {
+        int result_count = 0;
+        if (run_latency_engine(config, results, &result_count, NULL) < 0) {
+            LOG_ERROR("Monitor round failed");
+            ret = -1;
+            break;
+        }
+
+        if (result_count != st->vlan_count) {
+            LOG_ERROR("Monitor round returned %d results, expected %d", result_count, st->vlan_count);
+            ret = -1;
+            break;
+        }
+
+        uint64_t now = get_time_ns();
+        if (now >= interval_end && !g_interrupted) {
+            monitor_close_interval(st, results);
+            intervals++;
+            interval_end += interval_ns;
+            if (interval_end <= now) {
+                interval_end = now + interval_ns;  // Uzun round'lar interval'i atlattıysa
+            }
+        }
+
+        next_round += round_ns;
+        now = get_time_ns();
+        if (next_round > now) {
+            usleep((useconds_t)((next_round - now) / 1000));
+        } else {
+            next_round = now;  // Round süresi periyottan uzun: geride kalma
+        }
+    }
+
+    latency_engine_set_sample_hook(NULL, NULL);
+
+    if (st->out != NULL) {
+        fclose(st->out);
+    }
+
+    LOG_WARN("Monitor finished: %d intervals, %d alarms", intervals, st->alarms);
+
+    if (ret == 0) {
+        ret = st->alarms;
+    }
+    free(st);
+    free(results);
+    return ret;
+}
@@ -44,6 +44,35 @@
 // HELPER FUNCTIONS
 // ============================================
 
+/**
+ * Sonuçların timestamp tier etiketi ve en büyük kalibre hata sınırı
+ * Tier'lar karışıksa "MIXED" (satırlar birbiriyle karşılaştırılamaz)
+ */
+static const char *results_ts_label(const struct latency_result *results, int result_count,
+                                    uint32_t *max_err_ns) {
+    static const char *labels[TS_TIER_COUNT] = {"HARDWARE NIC", "KERNEL SOFTWARE", "USER SPACE"};
+    int tier = -1;
+    bool mixed = false;
+
+    *max_err_ns = 0;
+    for (int i = 0; i < result_count; i++) {
+        if (results[i].tx_count == 0) {
+            continue;
+        }
+        if (tier < 0) {
+            tier = results[i].ts_tier;
+        } else if (tier != results[i].ts_tier) {
+            mixed = true;
+        }
+        *max_err_ns = MAX(*max_err_ns, results[i].ts_err_ns);
+    }
+
+    if (mixed) {
+        return "MIXED";
+    }
+    return (tier >= 0 && tier < TS_TIER_COUNT) ? labels[tier] : labels[TS_TIER_HW];
+}
+
 static void print_horizontal_line(const char *left, const char *mid, const char *right, const char *fill) {
     printf("%s", left);
     for (int i = 0; i < COL_PORT; i++) printf("%s", fill);
@@ -106,6 +135,9 @@ void print_results_table(const struct latency_result *results, int result_count,
         }
     }
 
+    uint32_t max_err_ns;
+    const char *ts_label = results_ts_label(results, result_count, &max_err_ns);
+
     // Print table
     fflush(stdout);
     printf("\n");
@@ -114,7 +146,9 @@ void print_results_table(const struct latency_result *results, int result_count,
     print_horizontal_line(TBL_TL, TBL_TH, TBL_TR, TBL_H);
 
     // Title
-    print_title_line("LATENCY TEST RESULTS (Timestamp: HARDWARE NIC)");
+    char title[128];
+    snprintf(title, sizeof(title), "LATENCY TEST RESULTS (Timestamp: %s)", ts_label);
+    print_title_line(title);
 
     // Header separator
     print_horizontal_line(TBL_TV, TBL_X, TBL_TVR, TBL_H);
@@ -184,6 +218,10 @@ void print_results_table(const struct latency_result *results, int result_count,
                 "SUMMARY: PASS %d/%d | Packets/VLAN: %d",
                 passed_count, result_count, packet_count);
     }
+    if (successful > 0 && max_err_ns > 0) {
+        size_t len = strlen(summary);
+        snprintf(summary + len, sizeof(summary) - len, " | Err: +/-%.2f us", ns_to_us(max_err_ns));
+    }
     print_title_line(summary);
 
     // Bottom border
@@ -233,6 +271,9 @@ void print_results_table_with_attempt(const struct latency_result *results,
         }
     }
 
+    uint32_t max_err_ns;
+    const char *ts_label = results_ts_label(results, result_count, &max_err_ns);
+
     // Print table
     printf("\n");
 
@@ -243,10 +284,10 @@ void print_results_table_with_attempt(const struct latency_result *results,
     char title[128];
     if (attempt > 1) {
         snprintf(title, sizeof(title),
-                "LATENCY TEST RESULTS (HW Timestamp) - Attempt %d", attempt);
+                "LATENCY TEST RESULTS (Timestamp: %s) - Attempt %d", ts_label, attempt);
     } else {
         snprintf(title, sizeof(title),
-                "LATENCY TEST RESULTS (Timestamp: HARDWARE NIC)");
+                "LATENCY TEST RESULTS (Timestamp: %s)", ts_label);
     }
     print_title_line(title);
 
@@ -318,6 +359,10 @@ void print_results_table_with_attempt(const struct latency_result *results,
                 "SUMMARY: PASS %d/%d | Packets/VLAN: %d | Attempt: %d",
                 passed_count, result_count, packet_count, attempt);
     }
+    if (successful > 0 && max_err_ns > 0) {
+        size_t len = strlen(summary);
+        snprintf(summary + len, sizeof(summary) - len, " | Err: +/-%.2f us", ns_to_us(max_err_ns));
+    }
     print_title_line(summary);
 
     // Bottom border
@@ -373,7 +418,7 @@ void print_brief_summary(const struct latency_result *results, int result_count)
 // ============================================
 
 void print_results_csv(const struct latency_result *results, int result_count) {
-    printf("tx_port,rx_port,vlan,vl_id,min_us,avg_us,max_us,rx_count,tx_count,passed\n");
+    printf("tx_port,rx_port,vlan,vl_id,min_us,avg_us,max_us,rx_count,tx_count,passed,ts_tier,ts_err_us\n");
 
     for (int i = 0; i < result_count; i++) {
         const struct latency_result *r = &results[i];
@@ -382,10 +427,11 @@ void print_results_csv(const struct latency_result *results, int result_count) {
         double avg_us = r->rx_count > 0 ? ns_to_us(r->total_latency_ns / r->rx_count) : 0;
         double max_us = r->rx_count > 0 ? ns_to_us(r->max_latency_ns) : 0;
 
-        printf("%u,%u,%u,%u,%.2f,%.2f,%.2f,%u,%u,%s\n",
+        printf("%u,%u,%u,%u,%.2f,%.2f,%.2f,%u,%u,%s,%s,%.3f\n",
                r->tx_port, r->rx_port, r->vlan_id, r->vl_id,
                min_us, avg_us, max_us,
                r->rx_count, r->tx_count,
-               r->passed ? "PASS" : "FAIL");
+               r->passed ? "PASS" : "FAIL",
+               ts_tier_name(r->ts_tier), ns_to_us(r->ts_err_ns));
     }
 }
@@ -0,0 +1,171 @@
+/**
+ * @file ts_calibration.c
+ * @brief HW Timestamp Latency Test - Timestamp Tier Calibration
+ *
+ * Her tier için bir async engine turu; probe örnekleri sample hook ile
+ * VLAN başına toplanır (n, toplam, kareler toplamı).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "ts_calibration.h"
+#include "latency_engine.h"
+#include "latency_test.h"
+#include "common.h"
+#include "config.h"
+
+// Interrupt flag (defined in main.c)
+extern volatile int g_interrupted;
+
+struct calib_acc {
+    uint32_t n[MAX_RESULTS];
+    double   sum[MAX_RESULTS];
+    double   sumsq[MAX_RESULTS];
+};
+
+static struct ts_tier_calib g_calib[TS_TIER_COUNT];
+static bool g_calibrated = false;
+
+static void calib_sample(void *ctx, int result_idx, bool received, uint64_t latency_ns) {
+    struct calib_acc *acc = ctx;
+    if (!received || result_idx < 0 || result_idx >= MAX_RESULTS) {
+        return;
+    }
+    double v = (double)latency_ns;
+    acc->n[result_idx]++;
+    acc->sum[result_idx] += v;
+    acc->sumsq[result_idx] += v * v;
+}
+
+int run_ts_calibration(const struct test_config *config) {
+    struct calib_acc *acc = calloc(TS_TIER_COUNT, sizeof(struct calib_acc));
+    struct latency_result *results = calloc(MAX_RESULTS, sizeof(struct latency_result));
+    if (acc == NULL || results == NULL) {
+        LOG_ERROR("Failed to allocate calibration buffers");
+        free(acc);
+        free(results);
+        return -1;
+    }
+
+    struct test_config cfg = *config;
+    cfg.packet_count = MAX(config->packet_count, TS_CALIB_PACKETS);
+    cfg.max_latency_ns = 0;
+
+    memset(g_calib, 0, sizeof(g_calib));
+    g_calibrated = false;
+
+    int result_count = 0;
+    for (int t = TS_TIER_HW; t < TS_TIER_COUNT && !g_interrupted; t++) {
+        cfg.ts_tier = t;
+        latency_engine_set_sample_hook(calib_sample, &acc[t]);
+        int ret = run_latency_engine(&cfg, results, &result_count, NULL);
+        latency_engine_set_sample_hook(NULL, NULL);
+        if (ret < 0) {
+            LOG_ERROR("Calibration run for tier %s failed", ts_tier_name(t));
+            continue;
+        }
+
+        // Engine daha kötü bir tier'a düştüyse bu tier bu interface'lerde yok
+        bool downgraded = false;
+        for (int r = 0; r < result_count; r++) {
+            if (results[r].tx_count > 0 && results[r].ts_tier != t) {
+                downgraded = true;
+                break;
+            }
+        }
+        if (downgraded) {
+            LOG_INFO("Calibration: tier %s not available", ts_tier_name(t));
+            memset(&acc[t], 0, sizeof(acc[t]));
+            continue;
+        }
+
+        struct ts_tier_calib *c = &g_calib[t];
+        double sum = 0.0, ss_within = 0.0;
+        int vlans = 0;
+        for (int r = 0; r < result_count; r++) {
+            uint32_t n = acc[t].n[r];
+            if (n == 0) {
+                continue;
+            }
+            double mean = acc[t].sum[r] / n;
+            ss_within += acc[t].sumsq[r] - n * mean * mean;
+            sum += acc[t].sum[r];
+            c->samples += n;
+            vlans++;
+        }
+        if (c->samples > (uint32_t)vlans) {
+            c->valid = true;
+            c->mean_ns = sum / c->samples;
+            c->jitter_ns = sqrt(MAX(ss_within, 0.0) / (c->samples - vlans));
+        }
+    }
+
+    // Offset: referans (en iyi geçerli) tier'a göre VLAN ortalamaları farkı
+    int ref = -1;
+    for (int t = TS_TIER_HW; t < TS_TIER_COUNT; t++) {
+        if (g_calib[t].valid) {
+            ref = t;
+            break;
+        }
+    }
+
+    int valid = 0;
+    for (int t = TS_TIER_HW; t < TS_TIER_COUNT && ref >= 0; t++) {
+        if (!g_calib[t].valid) {
+            continue;
+        }
+        valid++;
+
+        double diff = 0.0;
+        int vlans = 0;
+        for (int r = 0; r < result_count; r++) {
+            if (acc[t].n[r] == 0 || acc[ref].n[r] == 0) {
+                continue;
+            }
+            diff += acc[t].sum[r] / acc[t].n[r] - acc[ref].sum[r] / acc[ref].n[r];
+            vlans++;
+        }
+        g_calib[t].offset_ns = vlans > 0 ? diff / vlans : 0.0;
+    }
+    g_calibrated = (valid > 0);
+
+    free(acc);
+    free(results);
+    return valid;
+}
+
+const struct ts_tier_calib *ts_calibration_get(ts_tier_t tier) {
+    if (!g_calibrated || tier >= TS_TIER_COUNT || !g_calib[tier].valid) {
+        return NULL;
+    }
+    return &g_calib[tier];
+}
+
+uint32_t ts_calibration_error_ns(ts_tier_t tier) {
+    const struct ts_tier_calib *c = ts_calibration_get(tier);
+    if (c == NULL) {
+        return 0;
+    }
+    double err = fabs(c->offset_ns) + c->jitter_ns;
+    return (uint32_t)MIN(ceil(err), (double)UINT32_MAX);
+}
+
+void print_ts_calibration(void) {
+    printf("\nTimestamp Tier Calibration (loopback):\n");
+    printf("  Tier | Samples | Mean (us) | Offset (us) | Jitter (us) | Error (us)\n");
+    for (int t = TS_TIER_HW; t < TS_TIER_COUNT; t++) {
+        const struct ts_tier_calib *c = ts_calibration_get((ts_tier_t)t);
+        if (c == NULL) {
+            printf("  %-4s | %7s | %9s | %11s | %11s | %10s\n",
+                   ts_tier_name(t), "-", "-", "-", "-", "n/a");
+            continue;
+        }
+        printf("  %-4s | %7u | %9.3f | %+11.3f | %11.3f | %10.3f\n",
+               ts_tier_name(t), c->samples, c->mean_ns / 1000.0, c->offset_ns / 1000.0,
+               c->jitter_ns / 1000.0, ns_to_us(ts_calibration_error_ns((ts_tier_t)t)));
+    }
+    printf("  Offset: relative to the best tier; Error = |offset| + jitter\n\n");
+}
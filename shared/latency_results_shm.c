@@ -0,0 +1,317 @@
+/**
+ * @file latency_results_shm.c
+ * @brief Shared-memory latency result channel - seqlock writer/reader
+ */
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "latency_results_shm.h"
+
+#define RING_MASK   (LATENCY_SHM_RING_SIZE - 1)
+
+_Static_assert((LATENCY_SHM_RING_SIZE & RING_MASK) == 0, "LATENCY_SHM_RING_SIZE must be a power of two");
+
+// Writer kilidi: segment fd'si üzerinde flock(LOCK_EX), writer kapanana kadar
+// açık kalır (process ölürse kernel bırakır)
+static int writer_lock_fd = -1;
+
+static uint64_t shm_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// ============================================
+// SEQLOCK
+// ============================================
+
+static inline void seq_write_begin(uint32_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void seq_write_end(uint32_t *seq) {
+    __atomic_store_n(seq, *seq + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * Önceki writer yazarken öldüyse seq tek kalır; tek seq üzerinden
+ * begin/end paritesi ters döner (yazım sırasında çift). Sayacı ileri
+ * doğru bir sonraki çift değere çek: reader'ın elindeki eski değer de
+ * artık eşleşmez.
+ */
+static inline void seq_normalize(uint32_t *seq) {
+    __atomic_store_n(seq, (*seq + 1) & ~1u, __ATOMIC_RELEASE);
+}
+
+/**
+ * Seqlock altında kopyala
+ * @return true = tutarlı kopya
+ */
+static bool seq_read(const uint32_t *seq, void *dst, const void *src, size_t len) {
+    for (int spin = 0; spin < LATENCY_SHM_READ_SPINS; spin++) {
+        uint32_t s0 = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+        if (s0 & 1) {
+            continue;   // Writer yazıyor
+        }
+        memcpy(dst, src, len);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(seq, __ATOMIC_RELAXED) == s0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================
+// WRITER
+// ============================================
+
+struct latency_shm_header *latency_shm_create(void) {
+    size_t size = sizeof(struct latency_shm_header);
+
+    int fd = shm_open(LATENCY_SHM_NAME, O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "[ERROR] shm_open(%s): %s\n", LATENCY_SHM_NAME, strerror(errno));
+        return NULL;
+    }
+
+    // Canlı bir writer yayın yaparken segmenti kırpıp sıfırlamak reader'ların
+    // seqlock'unu bozar: kilit alınamazsa hiçbir şeye dokunmadan çık
+    if (flock(fd, LOCK_EX | LOCK_NB) < 0) {
+        int32_t pid = 0;
+        if (errno == EWOULDBLOCK &&
+            pread(fd, &pid, sizeof(pid), offsetof(struct latency_shm_header, writer_pid)) == sizeof(pid)) {
+            fprintf(stderr, "[ERROR] %s is in use by another writer (pid %d)\n",
+                    LATENCY_SHM_NAME, pid);
+        } else {
+            fprintf(stderr, "[ERROR] flock(%s): %s\n", LATENCY_SHM_NAME, strerror(errno));
+        }
+        close(fd);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (st.st_size != (off_t)size && ftruncate(fd, (off_t)size) < 0)) {
+        fprintf(stderr, "[ERROR] Cannot size %s: %s\n", LATENCY_SHM_NAME, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    bool reuse = (st.st_size == (off_t)size);
+
+    struct latency_shm_header *shm = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (shm == MAP_FAILED) {
+        fprintf(stderr, "[ERROR] mmap(%s): %s\n", LATENCY_SHM_NAME, strerror(errno));
+        close(fd);
+        return NULL;
+    }
+    writer_lock_fd = fd;
+
+    // Aynı layout'la bırakılmış segment: mapping'i tutan reader'lar için
+    // generation'ı ilerlet; aksi halde sıfırdan kur
+    uint32_t generation = 0;
+    if (reuse && shm->magic == LATENCY_SHM_MAGIC && shm->version == LATENCY_SHM_VERSION) {
+        generation = shm->generation;
+    } else {
+        memset(shm, 0, size);
+    }
+
+    __atomic_store_n(&shm->state, LATENCY_SHM_IDLE, __ATOMIC_RELEASE);
+
+    shm->total_size = (uint32_t)size;
+    shm->ring_size = LATENCY_SHM_RING_SIZE;
+    shm->max_results = LATENCY_SHM_MAX_RESULTS;
+    shm->writer_pid = (int32_t)getpid();
+    shm->result_count = 0;
+    shm->packet_count = 0;
+    shm->packet_size = 0;
+    shm->max_latency_ns = 0;
+
+    // Sonuçları ve ring'i temizle; seq'ler önce çifte çekilir (yarım kalmış yazım)
+    for (int i = 0; i < LATENCY_SHM_MAX_RESULTS; i++) {
+        struct latency_shm_result_slot *slot = &shm->results[i];
+        seq_normalize(&slot->seq);
+        seq_write_begin(&slot->seq);
+        memset(&slot->r, 0, sizeof(slot->r));
+        seq_write_end(&slot->seq);
+    }
+    for (int i = 0; i < LATENCY_SHM_RING_SIZE; i++) {
+        struct latency_shm_probe_slot *slot = &shm->ring[i];
+        seq_normalize(&slot->seq);
+        seq_write_begin(&slot->seq);
+        memset(&slot->p, 0, sizeof(slot->p));
+        seq_write_end(&slot->seq);
+    }
+    __atomic_store_n(&shm->probe_head, 0, __ATOMIC_RELEASE);
+
+    // Temizlik bittikten sonra: reader'lar cursor'larını yeni oturuma göre alır
+    __atomic_store_n(&shm->generation, generation + 1, __ATOMIC_RELEASE);
+
+    // Magic en son: yarım kurulmuş segmenti reader kabul etmesin
+    shm->version = LATENCY_SHM_VERSION;
+    __atomic_store_n(&shm->magic, LATENCY_SHM_MAGIC, __ATOMIC_RELEASE);
+    __atomic_store_n(&shm->update_ns, shm_now_ns(), __ATOMIC_RELEASE);
+
+    return shm;
+}
+
+void latency_shm_set_state(struct latency_shm_header *shm, enum latency_shm_state state) {
+    __atomic_store_n(&shm->state, (uint32_t)state, __ATOMIC_RELEASE);
+    __atomic_store_n(&shm->update_ns, shm_now_ns(), __ATOMIC_RELEASE);
+}
+
+void latency_shm_write_result(struct latency_shm_header *shm,
+                              const struct shm_latency_result *result, int index) {
+    if (index < 0 || index >= LATENCY_SHM_MAX_RESULTS) {
+        return;
+    }
+
+    struct latency_shm_result_slot *slot = &shm->results[index];
+    seq_write_begin(&slot->seq);
+    memcpy(&slot->r, result, sizeof(slot->r));
+    seq_write_end(&slot->seq);
+
+    if ((uint32_t)index >= shm->result_count) {
+        __atomic_store_n(&shm->result_count, (uint32_t)index + 1, __ATOMIC_RELEASE);
+    }
+}
+
+void latency_shm_push_probe(struct latency_shm_header *shm, int result_idx,
+                            bool received, uint64_t latency_ns) {
+    uint64_t idx = shm->probe_head;     // Tek writer: relaxed okuma yeterli
+    uint64_t now = shm_now_ns();
+    struct latency_shm_probe_slot *slot = &shm->ring[idx & RING_MASK];
+
+    seq_write_begin(&slot->seq);
+    slot->p.index = idx;
+    slot->p.t_ns = now;
+    slot->p.latency_ns = received ? latency_ns : 0;
+    slot->p.result_idx = (uint16_t)result_idx;
+    slot->p.flags = received ? LATENCY_SHM_PROBE_RECEIVED : 0;
+    slot->p.reserved = 0;
+    seq_write_end(&slot->seq);
+
+    __atomic_store_n(&shm->probe_head, idx + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&shm->update_ns, now, __ATOMIC_RELAXED);
+}
+
+void latency_shm_finalize(struct latency_shm_header *shm, int result_count) {
+    __atomic_store_n(&shm->result_count, (uint32_t)result_count, __ATOMIC_RELEASE);
+    latency_shm_set_state(shm, LATENCY_SHM_COMPLETE);
+}
+
+void latency_shm_close_writer(struct latency_shm_header *shm) {
+    if (shm == NULL) {
+        return;
+    }
+    if (latency_shm_get_state(shm) != LATENCY_SHM_COMPLETE) {
+        latency_shm_set_state(shm, LATENCY_SHM_ABORTED);
+    }
+    munmap(shm, sizeof(*shm));
+    if (writer_lock_fd >= 0) {
+        close(writer_lock_fd);  // Kilidi bırak
+        writer_lock_fd = -1;
+    }
+}
+
+// ============================================
+// READER
+// ============================================
+
+const struct latency_shm_header *latency_shm_open_reader(void) {
+    size_t size = sizeof(struct latency_shm_header);
+
+    int fd = shm_open(LATENCY_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size != (off_t)size) {
+        close(fd);
+        return NULL;
+    }
+
+    const struct latency_shm_header *shm = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED) {
+        return NULL;
+    }
+
+    if (__atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) != LATENCY_SHM_MAGIC ||
+        shm->version != LATENCY_SHM_VERSION ||
+        shm->total_size != size) {
+        munmap((void *)shm, size);
+        return NULL;
+    }
+
+    return shm;
+}
+
+void latency_shm_close_reader(const struct latency_shm_header *shm) {
+    if (shm != NULL) {
+        munmap((void *)shm, sizeof(*shm));
+    }
+}
+
+int latency_shm_read_result(const struct latency_shm_header *shm, int index,
+                            struct shm_latency_result *out) {
+    if (index < 0 || index >= LATENCY_SHM_MAX_RESULTS) {
+        return -1;
+    }
+
+    const struct latency_shm_result_slot *slot = &shm->results[index];
+    return seq_read(&slot->seq, out, &slot->r, sizeof(*out)) ? 0 : -1;
+}
+
+void latency_shm_cursor_init(const struct latency_shm_header *shm, struct latency_shm_cursor *cur) {
+    cur->generation = __atomic_load_n(&shm->generation, __ATOMIC_ACQUIRE);
+    cur->next = 0;
+    cur->lost = 0;
+}
+
+int latency_shm_poll_probes(const struct latency_shm_header *shm, struct latency_shm_cursor *cur,
+                            struct shm_latency_probe *out, int max) {
+    uint32_t gen = __atomic_load_n(&shm->generation, __ATOMIC_ACQUIRE);
+    if (gen != cur->generation) {
+        cur->generation = gen;
+        cur->next = 0;
+    }
+
+    uint64_t head = __atomic_load_n(&shm->probe_head, __ATOMIC_ACQUIRE);
+    if (head < cur->next) {
+        cur->next = 0;  // Writer yeniden başladı, generation henüz görünmedi
+        return 0;
+    }
+    if (head - cur->next > LATENCY_SHM_RING_SIZE) {
+        cur->lost += head - cur->next - LATENCY_SHM_RING_SIZE;
+        cur->next = head - LATENCY_SHM_RING_SIZE;
+    }
+
+    int n = 0;
+    while (n < max && cur->next < head) {
+        const struct latency_shm_probe_slot *slot = &shm->ring[cur->next & RING_MASK];
+        if (!seq_read(&slot->seq, &out[n], &slot->p, sizeof(out[n])) ||
+            out[n].index != cur->next) {
+            cur->lost++;        // Okurken ezildi
+        } else {
+            n++;
+        }
+        cur->next++;
+    }
+
+    // Okuma sırasında writer yeniden başladıysa okunanlar eski oturuma ait
+    if (__atomic_load_n(&shm->generation, __ATOMIC_ACQUIRE) != gen) {
+        return 0;
+    }
+    return n;
+}
@@ -0,0 +1,198 @@
+/**
+ * @file latency_results_shm.h
+ * @brief Shared-memory latency result channel (latency_test -> dpdk_app / monitors)
+ *
+ * Tek writer (latency_test), çok reader. POSIX shm segmenti iki bölümden oluşur:
+ *
+ *   results[] : VLAN başına son sonuç (test sürerken canlı güncellenir)
+ *   ring[]    : probe başına olay halkası (monotonik index, taşınca en eskiler ezilir)
+ *
+ * Her slot kendi seqlock sayacını taşır: writer yazmadan önce tek, yazdıktan
+ * sonra çift yapar; reader kopyalar ve sayaç değişmediyse kabul eder. Reader
+ * hiçbir zaman writer'ı bekletmez, writer kilit almaz.
+ *
+ * Yeniden başlatma: writer segmenti unlink etmez. Yeni writer aynı segmenti
+ * açar; önceki writer yazarken öldüyse tek kalmış seq'leri çifte çeker,
+ * results[] ve ring[] slotlarını seqlock altında temizler, probe_head'i
+ * sıfırlar ve en son generation'ı artırır; mapping'i tutan reader'lar
+ * generation değişimini görüp cursor'larını baştan alır. Layout değişirse
+ * LATENCY_SHM_VERSION artırılır, eski reader'lar açılışta reddeder.
+ *
+ * Header C++'tan da (extern "C") kullanılabilir.
+ */
+
+#ifndef LATENCY_RESULTS_SHM_H
+#define LATENCY_RESULTS_SHM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ============================================
+// LAYOUT
+// ============================================
+#define LATENCY_SHM_NAME            "/latency_results"
+#define LATENCY_SHM_MAGIC           0x4C415453U     // "LATS"
+#define LATENCY_SHM_VERSION         3
+#define LATENCY_SHM_MAX_RESULTS     64
+#define LATENCY_SHM_RING_SIZE       4096            // 2'nin kuvveti
+#define LATENCY_SHM_READ_SPINS      1024            // Seqlock okuma deneme sınırı
+
+enum latency_shm_state {
+    LATENCY_SHM_IDLE     = 0,   // Writer bağlı, test başlamadı
+    LATENCY_SHM_RUNNING  = 1,   // Probe'lar akıyor, results[] kısmi
+    LATENCY_SHM_COMPLETE = 2,   // results[] nihai
+    LATENCY_SHM_ABORTED  = 3    // Writer tamamlamadan çıktı
+};
+
+// Probe flags
+#define LATENCY_SHM_PROBE_RECEIVED  0x0001
+
+/** VLAN sonucu (latency_test struct latency_result ile aynı alanlar) */
+struct shm_latency_result {
+    uint16_t tx_port;
+    uint16_t rx_port;
+    uint16_t vlan_id;
+    uint16_t vl_id;
+    uint32_t tx_count;
+    uint32_t rx_count;
+    uint64_t min_latency_ns;
+    uint64_t max_latency_ns;
+    uint64_t total_latency_ns;
+    bool     valid;
+    bool     passed;
+    char     error_msg[64];
+    uint8_t  ts_tier;           // 0 = HW, 1 = kernel SW, 2 = user-space
+    uint32_t ts_err_ns;         // Kalibre edilmiş hata sınırı, 0 = bilinmiyor
+};
+
+/** Probe olayı */
+struct shm_latency_probe {
+    uint64_t index;             // Ring'deki monotonik sıra
+    uint64_t t_ns;              // Kayıt zamanı (CLOCK_REALTIME)
+    uint64_t latency_ns;        // RECEIVED değilse 0
+    uint16_t result_idx;        // results[] indeksi
+    uint16_t flags;             // LATENCY_SHM_PROBE_*
+    uint32_t reserved;
+};
+
+struct latency_shm_result_slot {
+    uint32_t seq;
+    uint32_t reserved;
+    struct shm_latency_result r;
+};
+
+struct latency_shm_probe_slot {
+    uint32_t seq;
+    uint32_t reserved;
+    struct shm_latency_probe p;
+};
+
+struct latency_shm_header {
+    // Sabit kimlik (writer create'te yazar)
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved0;
+    uint32_t total_size;
+    uint32_t ring_size;
+    uint32_t max_results;
+
+    // Writer oturumu
+    uint32_t generation;        // Her writer açılışında +1
+    int32_t  writer_pid;
+    uint32_t state;             // enum latency_shm_state
+    uint32_t result_count;      // results[]'te anlamlı satır sayısı
+
+    // Test konfigürasyonu (RUNNING'e geçmeden yazılır)
+    int32_t  packet_count;
+    int32_t  packet_size;
+    uint64_t max_latency_ns;
+
+    // Writer ilerlemesi
+    uint64_t probe_head __attribute__((aligned(64)));   // Sonraki probe index'i
+    uint64_t update_ns;                                 // Son yazım (heartbeat)
+
+    struct latency_shm_result_slot results[LATENCY_SHM_MAX_RESULTS] __attribute__((aligned(64)));
+    struct latency_shm_probe_slot  ring[LATENCY_SHM_RING_SIZE] __attribute__((aligned(64)));
+};
+
+/** Reader cursor (reader-özel, shm'de değil) */
+struct latency_shm_cursor {
+    uint32_t generation;
+    uint64_t next;              // Okunacak sonraki probe index'i
+    uint64_t lost;              // Ezilen (okunamadan üzerine yazılan) probe sayısı
+};
+
+// ============================================
+// WRITER API (tek writer)
+// ============================================
+
+/**
+ * Segmenti oluştur veya yeniden aç: seq'leri çifte çek, results[]/ring[]
+ * slotlarını ve probe_head'i sıfırla, sonra generation'ı artır.
+ * Segment üzerinde özel flock alınır; başka bir writer açıksa segmente
+ * dokunulmaz ve NULL döner (kilit latency_shm_close_writer'da bırakılır)
+ * @return Mapping, NULL = hata veya segment başka writer'da
+ */
+struct latency_shm_header *latency_shm_create(void);
+
+/** Durum geçişi (IDLE -> RUNNING -> COMPLETE) */
+void latency_shm_set_state(struct latency_shm_header *shm, enum latency_shm_state state);
+
+/** VLAN sonucunu yaz (index < LATENCY_SHM_MAX_RESULTS) */
+void latency_shm_write_result(struct latency_shm_header *shm,
+                              const struct shm_latency_result *result, int index);
+
+/** Probe olayını ring'e ekle */
+void latency_shm_push_probe(struct latency_shm_header *shm, int result_idx,
+                            bool received, uint64_t latency_ns);
+
+/** result_count'u yaz ve COMPLETE'e geç */
+void latency_shm_finalize(struct latency_shm_header *shm, int result_count);
+
+/** Mapping'i kapat; COMPLETE değilse ABORTED işaretler. Segment silinmez. */
+void latency_shm_close_writer(struct latency_shm_header *shm);
+
+// ============================================
+// READER API (çok reader, salt okunur mapping)
+// ============================================
+
+/**
+ * Segmenti salt okunur aç, magic/version/boyut kontrolü yap
+ * @return Mapping, NULL = yok veya uyumsuz
+ */
+const struct latency_shm_header *latency_shm_open_reader(void);
+
+void latency_shm_close_reader(const struct latency_shm_header *shm);
+
+/**
+ * VLAN sonucunun tutarlı kopyasını al
+ * @return 0 = başarılı, -1 = index geçersiz / writer sürekli yazıyor
+ */
+int latency_shm_read_result(const struct latency_shm_header *shm, int index,
+                            struct shm_latency_result *out);
+
+/** Cursor'ı mevcut generation'ın başına al */
+void latency_shm_cursor_init(const struct latency_shm_header *shm, struct latency_shm_cursor *cur);
+
+/**
+ * Yeni probe olaylarını oku (en fazla max adet)
+ * Generation değişmişse cursor baştan başlar; ring taşmışsa atlanan
+ * olaylar cur->lost'a eklenir.
+ * @return Okunan olay sayısı
+ */
+int latency_shm_poll_probes(const struct latency_shm_header *shm, struct latency_shm_cursor *cur,
+                            struct shm_latency_probe *out, int max);
+
+static inline enum latency_shm_state latency_shm_get_state(const struct latency_shm_header *shm) {
+    return (enum latency_shm_state)__atomic_load_n(&shm->state, __ATOMIC_ACQUIRE);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_RESULTS_SHM_H
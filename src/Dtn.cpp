@@ -418,6 +418,17 @@ bool Dtn::configureSequence()
     {
         std::cerr << "DTN: Failed to fetch DPDK log (file may not exist)" << std::endl;
     }
+
+    // Binary per-second stats (dpdk/tools/stats_rec_tool ile csv/json'a çevrilir)
+    std::string local_dpdk_rec = LogPaths::DTN() + "/dpdk_app_stats.rec";
+    if (g_ssh_deployer_server.fetchFile("/tmp/dpdk_app_stats.rec", local_dpdk_rec))
+    {
+        std::cout << "DTN: DPDK stats recording saved to: " << local_dpdk_rec << std::endl;
+    }
+    else
+    {
+        std::cerr << "DTN: Failed to fetch DPDK stats recording (file may not exist)" << std::endl;
+    }
     //  // Monitor PSU measurements
     //  for (int i = 0; i < 1000; i++)
     //  {